@@ -85,6 +85,7 @@ vpxenc.SRCS                 += vpx_ports/mem_ops_aligned.h
 vpxenc.SRCS                 += vpx_ports/msvc.h
 vpxenc.SRCS                 += vpx_ports/vpx_timer.h
 vpxenc.SRCS                 += vpxstats.c vpxstats.h
+vpxenc.SRCS                 += vpxchunk.c vpxchunk.h
 ifeq ($(CONFIG_LIBYUV),yes)
   vpxenc.SRCS                 += $(LIBYUV_SRCS)
 endif
@@ -111,6 +112,17 @@ ifneq ($(CONFIG_SHARED),yes)
 EXAMPLES-$(CONFIG_VP9_ENCODER)    += resize_util.c
 endif
 
+ifeq ($(CONFIG_INTERNAL_STATS),yes)
+ifneq ($(CONFIG_SHARED),yes)
+EXAMPLES-$(CONFIG_ENCODERS)       += y4m_compare.c
+y4m_compare.SRCS                  += tools_common.c tools_common.h
+y4m_compare.SRCS                  += y4minput.c y4minput.h
+y4m_compare.SRCS                  += vpx_ports/msvc.h
+y4m_compare.GUID                   = 437A8A3A-D44A-4573-99E5-537E65E8C3F3
+y4m_compare.DESCRIPTION            = Quality metrics between two y4m files
+endif
+endif
+
 EXAMPLES-$(CONFIG_ENCODERS)          += vpx_temporal_svc_encoder.c
 vpx_temporal_svc_encoder.SRCS        += ivfenc.c ivfenc.h
 vpx_temporal_svc_encoder.SRCS        += tools_common.c tools_common.h
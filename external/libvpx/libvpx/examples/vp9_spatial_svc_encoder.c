@@ -74,6 +74,9 @@ static const arg_def_t rc_end_usage_arg =
     ARG_DEF(NULL, "rc-end-usage", 1, "0 - 3: VBR, CBR, CQ, Q");
 static const arg_def_t speed_arg =
     ARG_DEF("sp", "speed", 1, "speed configuration");
+static const arg_def_t reuse_lower_layer_arg =
+    ARG_DEF(NULL, "reuse-lower-layer", 0,
+            "Seed upper layer motion search from the lower layer");
 
 #if CONFIG_VP9_HIGHBITDEPTH
 static const struct arg_enum_list bitdepth_enum[] = {
@@ -103,7 +106,7 @@ static const arg_def_t *svc_args[] = {
 #if CONFIG_VP9_HIGHBITDEPTH
   &bitdepth_arg,
 #endif
-  &speed_arg,
+  &speed_arg,         &reuse_lower_layer_arg,
   &rc_end_usage_arg,  NULL
 };
 
@@ -131,6 +134,7 @@ typedef struct {
   stats_io_t rc_stats;
   int passes;
   int pass;
+  int reuse_lower_layer;
 } AppInput;
 
 static const char *exec_name;
@@ -217,6 +221,8 @@ static void parse_command_line(int argc, const char **argv_,
       svc_ctx->speed = arg_parse_uint(&arg);
     } else if (arg_match(&arg, &threads_arg, argi)) {
       svc_ctx->threads = arg_parse_uint(&arg);
+    } else if (arg_match(&arg, &reuse_lower_layer_arg, argi)) {
+      app_input->reuse_lower_layer = 1;
     } else if (arg_match(&arg, &temporal_layering_mode_arg, argi)) {
       svc_ctx->temporal_layering_mode =
           enc_cfg->temporal_layering_mode = arg_parse_int(&arg);
@@ -624,6 +630,8 @@ int main(int argc, const char **argv) {
     vpx_codec_control(&codec, VP8E_SET_CPUUSED, svc_ctx.speed);
   if (svc_ctx.threads)
     vpx_codec_control(&codec, VP9E_SET_TILE_COLUMNS, (svc_ctx.threads >> 1));
+  if (app_input.reuse_lower_layer)
+    vpx_codec_control(&codec, VP9E_SET_SVC_REUSE_LOWER_LAYER, 1);
 
   
   while (!end_of_stream) {
@@ -0,0 +1,224 @@
+/*
+ *  Copyright (c) 2016 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "./vpx_dsp_rtcd.h"
+#include "../tools_common.h"
+#include "../y4minput.h"
+#include "../vpx/internal/vpx_psnr.h"
+#include "../vpx_dsp/quality_metrics.h"
+#include "../vpx_mem/vpx_mem.h"
+#include "../vpx_ports/mem.h"
+
+static const char *exec_name = NULL;
+
+static void usage() {
+  printf("Usage:\n");
+  printf("%s [--threads=<n>] [--metrics=<list>] [--per-frame] ", exec_name);
+  printf("<reference_y4m> <distorted_y4m>\n");
+  printf("  <list> is a comma separated subset of "
+         "psnr,ssim,fastssim,psnrhvs,blockiness\n");
+}
+
+void usage_exit(void) {
+  usage();
+  exit(EXIT_FAILURE);
+}
+
+static int parse_metrics(const char *list) {
+  static const struct {
+    const char *name;
+    int flag;
+  } names[] = {
+    {"psnr", VPX_METRIC_PSNR},
+    {"ssim", VPX_METRIC_SSIM},
+    {"fastssim", VPX_METRIC_FASTSSIM},
+    {"psnrhvs", VPX_METRIC_PSNRHVS},
+    {"blockiness", VPX_METRIC_BLOCKINESS},
+  };
+  int flags = 0;
+
+  while (*list) {
+    const size_t len = strcspn(list, ",");
+    size_t i;
+    for (i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+      if (strlen(names[i].name) == len && !strncmp(names[i].name, list, len))
+        break;
+    }
+    if (i == sizeof(names) / sizeof(names[0]))
+      die("Unknown metric: %.*s", (int)len, list);
+    flags |= names[i].flag;
+    list += len;
+    if (*list == ',')
+      ++list;
+  }
+  return flags;
+}
+
+static void image_to_yv12(const vpx_image_t *img, YV12_BUFFER_CONFIG *yv12) {
+  memset(yv12, 0, sizeof(*yv12));
+  yv12->y_buffer = img->planes[VPX_PLANE_Y];
+  yv12->u_buffer = img->planes[VPX_PLANE_U];
+  yv12->v_buffer = img->planes[VPX_PLANE_V];
+  yv12->y_crop_width = img->d_w;
+  yv12->y_crop_height = img->d_h;
+  yv12->uv_crop_width = (img->d_w + img->x_chroma_shift) >>
+                        img->x_chroma_shift;
+  yv12->uv_crop_height = (img->d_h + img->y_chroma_shift) >>
+                         img->y_chroma_shift;
+  yv12->y_stride = img->stride[VPX_PLANE_Y];
+  yv12->uv_stride = img->stride[VPX_PLANE_U];
+  if (img->fmt & VPX_IMG_FMT_HIGHBITDEPTH) {
+    yv12->y_buffer = CONVERT_TO_BYTEPTR(yv12->y_buffer);
+    yv12->u_buffer = CONVERT_TO_BYTEPTR(yv12->u_buffer);
+    yv12->v_buffer = CONVERT_TO_BYTEPTR(yv12->v_buffer);
+    yv12->y_stride >>= 1;
+    yv12->uv_stride >>= 1;
+    yv12->flags = YV12_FLAG_HIGHBITDEPTH;
+  }
+}
+
+static void open_y4m(const char *name, FILE **file, y4m_input *y4m) {
+  *file = fopen(name, "rb");
+  if (!*file)
+    die("Failed to open %s", name);
+  if (y4m_input_open(y4m, *file, NULL, 0, 0) < 0)
+    die("Failed to parse y4m header of %s", name);
+}
+
+int main(int argc, char *argv[]) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  VPxWorker *workers = NULL;
+  FILE *ref_file, *dist_file;
+  y4m_input ref_y4m, dist_y4m;
+  vpx_image_t ref_img, dist_img;
+  QualityMetrics sum;
+  uint64_t total_sse = 0, total_samples = 0;
+  int flags = VPX_METRIC_ALL;
+  int num_workers = 1;
+  int per_frame = 0;
+  int frames = 0;
+  int i, j;
+
+  exec_name = argv[0];
+
+  for (i = 1; i < argc && !strncmp(argv[i], "--", 2); ++i) {
+    if (!strncmp(argv[i], "--threads=", 10))
+      num_workers = atoi(argv[i] + 10);
+    else if (!strncmp(argv[i], "--metrics=", 10))
+      flags = parse_metrics(argv[i] + 10);
+    else if (!strcmp(argv[i], "--per-frame"))
+      per_frame = 1;
+    else
+      usage_exit();
+  }
+  if (argc - i != 2 || num_workers < 1)
+    usage_exit();
+
+  open_y4m(argv[i], &ref_file, &ref_y4m);
+  open_y4m(argv[i + 1], &dist_file, &dist_y4m);
+  if (ref_y4m.pic_w != dist_y4m.pic_w || ref_y4m.pic_h != dist_y4m.pic_h ||
+      ref_y4m.vpx_fmt != dist_y4m.vpx_fmt ||
+      ref_y4m.bit_depth != dist_y4m.bit_depth)
+    die("Inputs differ in size, chroma format or bit depth");
+  if (ref_y4m.bit_depth > 8 && !CONFIG_VP9_HIGHBITDEPTH)
+    die("High bit depth input requires --enable-vp9-highbitdepth");
+
+  vpx_dsp_rtcd();
+
+  if (num_workers > 1) {
+    workers = (VPxWorker *)vpx_calloc(num_workers, sizeof(*workers));
+    if (!workers)
+      die("Failed to allocate workers");
+    for (j = 0; j < num_workers; ++j) {
+      winterface->init(&workers[j]);
+      if (j < num_workers - 1 && !winterface->reset(&workers[j]))
+        die("Failed to create worker thread");
+    }
+  }
+
+  memset(&sum, 0, sizeof(sum));
+  memset(&ref_img, 0, sizeof(ref_img));
+  memset(&dist_img, 0, sizeof(dist_img));
+  while (y4m_input_fetch_frame(&ref_y4m, ref_file, &ref_img) > 0 &&
+         y4m_input_fetch_frame(&dist_y4m, dist_file, &dist_img) > 0) {
+    YV12_BUFFER_CONFIG ref, dist;
+    QualityMetrics m;
+
+    image_to_yv12(&ref_img, &ref);
+    image_to_yv12(&dist_img, &dist);
+    if (vpx_calc_quality_metrics(&ref, &dist, flags, ref_y4m.bit_depth,
+                                 workers, num_workers, &m))
+      die("Failed to compute metrics for frame %d", frames);
+
+    if (per_frame) {
+      printf("%5d", frames);
+      if (flags & VPX_METRIC_PSNR)
+        printf("  PSNR %7.3f", m.psnr[0]);
+      if (flags & VPX_METRIC_SSIM)
+        printf("  SSIM %7.5f", m.ssim[0]);
+      if (flags & VPX_METRIC_FASTSSIM)
+        printf("  FastSSIM %7.3f", m.fastssim[0]);
+      if (flags & VPX_METRIC_PSNRHVS)
+        printf("  PSNR-HVS %7.3f", m.psnrhvs[0]);
+      if (flags & VPX_METRIC_BLOCKINESS)
+        printf("  Blockiness %7.3f", m.blockiness);
+      printf("\n");
+    }
+
+    total_sse += m.sse[0];
+    total_samples += m.samples[0];
+    for (j = 0; j < 4; ++j) {
+      sum.psnr[j] += m.psnr[j];
+      sum.ssim[j] += m.ssim[j];
+      sum.fastssim[j] += m.fastssim[j];
+      sum.psnrhvs[j] += m.psnrhvs[j];
+    }
+    sum.blockiness += m.blockiness;
+    ++frames;
+  }
+
+  if (frames > 0) {
+    const double peak = (double)((1 << ref_y4m.bit_depth) - 1);
+    printf("Frames:      %d\n", frames);
+    if (flags & VPX_METRIC_PSNR) {
+      printf("PSNR:        %7.3f (Y %7.3f U %7.3f V %7.3f)  Global %7.3f\n",
+             sum.psnr[0] / frames, sum.psnr[1] / frames, sum.psnr[2] / frames,
+             sum.psnr[3] / frames,
+             vpx_sse_to_psnr((double)total_samples, peak,
+                             (double)total_sse));
+    }
+    if (flags & VPX_METRIC_SSIM) {
+      printf("SSIM:        %7.5f (Y %7.5f U %7.5f V %7.5f)\n",
+             sum.ssim[0] / frames, sum.ssim[1] / frames, sum.ssim[2] / frames,
+             sum.ssim[3] / frames);
+    }
+    if ((flags & VPX_METRIC_FASTSSIM) && ref_y4m.bit_depth == 8)
+      printf("FastSSIM:    %7.3f\n", sum.fastssim[0] / frames);
+    if ((flags & VPX_METRIC_PSNRHVS) && ref_y4m.bit_depth == 8)
+      printf("PSNR-HVS:    %7.3f\n", sum.psnrhvs[0] / frames);
+    if ((flags & VPX_METRIC_BLOCKINESS) && ref_y4m.bit_depth == 8)
+      printf("Blockiness:  %7.3f\n", sum.blockiness / frames);
+  }
+
+  if (workers) {
+    for (j = 0; j < num_workers; ++j)
+      winterface->end(&workers[j]);
+    vpx_free(workers);
+  }
+  y4m_input_close(&ref_y4m);
+  y4m_input_close(&dist_y4m);
+  fclose(ref_file);
+  fclose(dist_file);
+  return frames > 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -752,6 +752,7 @@ class DatarateOnePassCbrSvc : public ::libvpx_test::EncoderTest,
     InitializeConfig();
     SetMode(GET_PARAM(1));
     speed_setting_ = GET_PARAM(2);
+    reuse_lower_layer_ = 0;
     ResetModel();
   }
   virtual void ResetModel() {
@@ -784,6 +785,7 @@ class DatarateOnePassCbrSvc : public ::libvpx_test::EncoderTest,
       encoder->Control(VP9E_SET_TILE_COLUMNS, 0);
       encoder->Control(VP8E_SET_MAX_INTRA_BITRATE_PCT, 300);
       encoder->Control(VP9E_SET_TILE_COLUMNS, (cfg_.g_threads >> 1));
+      encoder->Control(VP9E_SET_SVC_REUSE_LOWER_LAYER, reuse_lower_layer_);
     }
     const vpx_rational_t tb = video->timebase();
     timebase_ = static_cast<double>(tb.num) / tb.den;
@@ -843,6 +845,7 @@ class DatarateOnePassCbrSvc : public ::libvpx_test::EncoderTest,
   size_t bits_in_last_frame_;
   vpx_svc_extra_cfg_t svc_params_;
   int speed_setting_;
+  unsigned int reuse_lower_layer_;
   double mismatch_psnr_;
   int mismatch_nframes_;
 };
@@ -967,6 +970,49 @@ TEST_P(DatarateOnePassCbrSvc, OnePassCbrSvc4threads) {
   EXPECT_EQ(GetMismatchFrames(), (unsigned int) 0);
 }
 
+// Check basic rate targeting for 1 pass CBR SVC with the upper spatial layers
+// seeded from the lower layer motion: 3 spatial layers and 3 temporal layers.
+// Run CIF clip with 2 threads so the two downscaled layer sources are scaled
+// in parallel.
+TEST_P(DatarateOnePassCbrSvc, OnePassCbrSvcReuseLowerLayer) {
+  cfg_.rc_buf_initial_sz = 500;
+  cfg_.rc_buf_optimal_sz = 500;
+  cfg_.rc_buf_sz = 1000;
+  cfg_.rc_min_quantizer = 0;
+  cfg_.rc_max_quantizer = 63;
+  cfg_.rc_end_usage = VPX_CBR;
+  cfg_.g_lag_in_frames = 0;
+  cfg_.ss_number_layers = 3;
+  cfg_.ts_number_layers = 3;
+  cfg_.ts_rate_decimator[0] = 4;
+  cfg_.ts_rate_decimator[1] = 2;
+  cfg_.ts_rate_decimator[2] = 1;
+  cfg_.g_error_resilient = 1;
+  cfg_.g_threads = 2;
+  cfg_.temporal_layering_mode = 3;
+  svc_params_.scaling_factor_num[0] = 72;
+  svc_params_.scaling_factor_den[0] = 288;
+  svc_params_.scaling_factor_num[1] = 144;
+  svc_params_.scaling_factor_den[1] = 288;
+  svc_params_.scaling_factor_num[2] = 288;
+  svc_params_.scaling_factor_den[2] = 288;
+  cfg_.rc_dropframe_thresh = 0;
+  reuse_lower_layer_ = 1;
+  ::libvpx_test::I420VideoSource video("hantro_collage_w352h288.yuv", 352, 288,
+                                       30, 1, 0, 200);
+  cfg_.rc_target_bitrate = 800;
+  ResetModel();
+  assign_layer_bitrates(&cfg_, &svc_params_, cfg_.ss_number_layers,
+      cfg_.ts_number_layers, cfg_.temporal_layering_mode,
+      cfg_.rc_target_bitrate);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  ASSERT_GE(cfg_.rc_target_bitrate, effective_datarate_ * 0.85)
+          << " The datarate for the file exceeds the target by too much!";
+  ASSERT_LE(cfg_.rc_target_bitrate, file_datarate_ * 1.15)
+      << " The datarate for the file is lower than the target by too much!";
+  EXPECT_EQ(GetMismatchFrames(), (unsigned int) 0);
+}
+
 VP8_INSTANTIATE_TEST_CASE(DatarateTestLarge, ALL_TEST_MODES);
 VP9_INSTANTIATE_TEST_CASE(DatarateTestVP9Large,
                           ::testing::Values(::libvpx_test::kOnePassGood,
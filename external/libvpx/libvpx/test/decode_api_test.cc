@@ -14,6 +14,7 @@
 #include "test/ivf_video_source.h"
 #include "vpx/vp8dx.h"
 #include "vpx/vpx_decoder.h"
+#include "vpx_ports/vpx_timer.h"
 
 namespace {
 
@@ -146,6 +147,61 @@ TEST(DecodeAPI, Vp9InvalidDecode) {
   TestVp9Controls(&dec);
   EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
 }
+TEST(DecodeAPI, Vp9StageTiming) {
+  libvpx_test::IVFVideoSource video("vp90-2-09-subpixel-00.ivf");
+  video.Init();
+  video.Begin();
+  ASSERT_TRUE(!HasFailure());
+
+  vpx_codec_ctx_t dec;
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_dec_init(&dec, &vpx_codec_vp9_dx_algo, NULL, 0));
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_control(&dec, VP9_SET_STAGE_TIMING, 1));
+
+  vpx_stage_timing_t prev;
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_control(&dec, VP9_GET_STAGE_TIMING, &prev));
+  EXPECT_EQ(0u, prev.total_ns);
+
+  vpx_usec_timer timer;
+  vpx_usec_timer_start(&timer);
+  for (int frame = 0; frame < 10 && video.cxdata() != NULL;
+       ++frame, video.Next()) {
+    const uint32_t frame_size = static_cast<uint32_t>(video.frame_size());
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_decode(&dec, video.cxdata(), frame_size, NULL, 0));
+
+    // The counters accumulate across calls until timing is re-enabled.
+    vpx_stage_timing_t timing;
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_control(&dec, VP9_GET_STAGE_TIMING, &timing));
+    EXPECT_GT(timing.total_ns, prev.total_ns) << "frame " << frame;
+    uint64_t staged = 0;
+    for (int i = 0; i < VPX_STAGE_COUNT; ++i) {
+      EXPECT_GE(timing.ns[i], prev.ns[i]) << "frame " << frame;
+      staged += timing.ns[i];
+    }
+    EXPECT_LE(staged, timing.total_ns) << "frame " << frame;
+    prev = timing;
+  }
+  vpx_usec_timer_mark(&timer);
+
+  EXPECT_GT(prev.ns[VPX_STAGE_HEADER], 0u);
+  EXPECT_GT(prev.ns[VPX_STAGE_ENTROPY], 0u);
+  EXPECT_GT(prev.ns[VPX_STAGE_PREDICTION], 0u);
+  EXPECT_GT(prev.ns[VPX_STAGE_TRANSFORM], 0u);
+
+  // All of the timed work happened inside the wall clock interval, so a
+  // total in any unit finer than nanoseconds would overshoot it.
+  const uint64_t elapsed_ns =
+      (static_cast<uint64_t>(vpx_usec_timer_elapsed(&timer)) + 1) * 1000;
+  EXPECT_LE(prev.total_ns, elapsed_ns);
+
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_control(&dec, VP9_SET_STAGE_TIMING, 1));
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_control(&dec, VP9_GET_STAGE_TIMING, &prev));
+  EXPECT_EQ(0u, prev.total_ns);
+
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
+}
 #endif  // CONFIG_VP9_DECODER
 
 }  // namespace
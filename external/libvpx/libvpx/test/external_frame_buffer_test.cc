@@ -335,6 +335,29 @@ class ExternalFrameBufferTest : public ::testing::Test {
     return VPX_CODEC_OK;
   }
 
+  // Decodes one frame and takes a reference on the frame it outputs, so the
+  // frame buffer stays valid while further frames are decoded. |img| is set
+  // to the held image and |handle| to the value passed to ReleaseFrame().
+  vpx_codec_err_t DecodeAndHoldOneFrame(vpx_image_t *img, int *handle) {
+    const vpx_codec_err_t res =
+        decoder_->DecodeFrame(video_->cxdata(), video_->frame_size());
+    if (res != VPX_CODEC_OK)
+      return res;
+    video_->Next();
+
+    libvpx_test::DxDataIterator dec_iter = decoder_->GetDxData();
+    const vpx_image_t *const out = dec_iter.Next();
+    if (out == NULL)
+      return VPX_CODEC_ERROR;
+    *img = *out;
+    return vpx_codec_control(decoder_->GetDecoder(), VP9D_HOLD_FRAME, handle);
+  }
+
+  vpx_codec_err_t ReleaseFrame(int handle) {
+    return vpx_codec_control(decoder_->GetDecoder(), VP9D_RELEASE_FRAME,
+                             handle);
+  }
+
  private:
   void CheckDecodedFrames() {
     libvpx_test::DxDataIterator dec_iter = decoder_->GetDxData();
@@ -472,6 +495,35 @@ TEST_F(ExternalFrameBufferTest, NullReleaseFunction) {
             SetFrameBufferFunctions(num_buffers, get_vp9_frame_buffer, NULL));
 }
 
+TEST_F(ExternalFrameBufferTest, HoldFrame) {
+  // One extra buffer for the frame held by the application.
+  const int num_buffers =
+      VP9_MAXIMUM_REF_BUFFERS + VPX_MAXIMUM_WORK_BUFFERS + 1;
+  ASSERT_EQ(VPX_CODEC_OK,
+            SetFrameBufferFunctions(
+                num_buffers, get_vp9_frame_buffer, release_vp9_frame_buffer));
+
+  vpx_image_t img;
+  int handle = -1;
+  ASSERT_EQ(VPX_CODEC_OK, DecodeAndHoldOneFrame(&img, &handle));
+  ASSERT_TRUE(img.fb_priv != NULL);
+  const ExternalFrameBuffer *const ext_fb =
+      reinterpret_cast<ExternalFrameBuffer*>(img.fb_priv);
+  libvpx_test::MD5 expected_md5;
+  expected_md5.Add(&img);
+
+  // The held frame must be neither reused nor returned to the application
+  // while later frames are decoded.
+  ASSERT_EQ(VPX_CODEC_OK, DecodeRemainingFrames());
+  EXPECT_EQ(1, ext_fb->in_use);
+  libvpx_test::MD5 actual_md5;
+  actual_md5.Add(&img);
+  EXPECT_STREQ(expected_md5.Get(), actual_md5.Get());
+
+  ASSERT_EQ(VPX_CODEC_OK, ReleaseFrame(handle));
+  EXPECT_EQ(VPX_CODEC_INVALID_PARAM, ReleaseFrame(-1));
+}
+
 TEST_F(ExternalFrameBufferTest, SetAfterDecode) {
   const int num_buffers = VP9_MAXIMUM_REF_BUFFERS + VPX_MAXIMUM_WORK_BUFFERS;
   ASSERT_EQ(VPX_CODEC_OK, DecodeOneFrame());
@@ -0,0 +1,214 @@
+/*
+ *  Copyright (c) 2016 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "./vpx_config.h"
+#include "./vpx_dsp_rtcd.h"
+#include "test/acm_random.h"
+#include "test/clear_system_state.h"
+#include "test/register_state_check.h"
+#include "vpx_dsp/quality_metrics.h"
+#include "vpx_dsp/ssim.h"
+#include "vpx_mem/vpx_mem.h"
+#include "vpx_ports/mem.h"
+#include "vpx_scale/yv12config.h"
+#include "vpx_util/vpx_thread.h"
+
+using libvpx_test::ACMRandom;
+
+namespace {
+
+typedef void (*SsimParmsRowFunc)(const uint8_t *s, int sp, const uint8_t *r,
+                                 int rp, int count, uint32_t *sum_s,
+                                 uint32_t *sum_r, uint32_t *sum_sq_s,
+                                 uint32_t *sum_sq_r, uint32_t *sum_sxr);
+
+const int kMaxStrips = 75;
+const int kRowStride = 4 * kMaxStrips + 8;
+
+class SsimParmsRowTest : public ::testing::TestWithParam<SsimParmsRowFunc> {
+ public:
+  virtual void TearDown() { libvpx_test::ClearSystemState(); }
+};
+
+TEST_P(SsimParmsRowTest, MatchesC) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  DECLARE_ALIGNED(16, uint8_t, src[8 * kRowStride]);
+  DECLARE_ALIGNED(16, uint8_t, ref[8 * kRowStride]);
+  uint32_t ref_sums[5][kMaxStrips], test_sums[5][kMaxStrips];
+
+  for (int iter = 0; iter < 200; ++iter) {
+    const int count = 1 + rnd(kMaxStrips);
+    for (int i = 0; i < 8 * kRowStride; ++i) {
+      // Every third pass saturates the inputs to catch overflow in the
+      // 16-bit partial sums.
+      src[i] = (iter % 3 == 0) ? 255 : rnd.Rand8();
+      ref[i] = (iter % 3 == 0) ? 255 - (i & 1) : rnd.Rand8();
+    }
+    memset(test_sums, 0xa5, sizeof(test_sums));
+
+    vpx_ssim_parms_4x8_row_c(src, kRowStride, ref, kRowStride, count,
+                             ref_sums[0], ref_sums[1], ref_sums[2],
+                             ref_sums[3], ref_sums[4]);
+    ASM_REGISTER_STATE_CHECK(GetParam()(src, kRowStride, ref, kRowStride,
+                                        count, test_sums[0], test_sums[1],
+                                        test_sums[2], test_sums[3],
+                                        test_sums[4]));
+
+    for (int j = 0; j < 5; ++j) {
+      for (int k = 0; k < count; ++k) {
+        ASSERT_EQ(ref_sums[j][k], test_sums[j][k])
+            << "sum " << j << " strip " << k << " count " << count;
+      }
+    }
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(C, SsimParmsRowTest,
+                        ::testing::Values(&vpx_ssim_parms_4x8_row_c));
+
+#if HAVE_SSE2
+INSTANTIATE_TEST_CASE_P(SSE2, SsimParmsRowTest,
+                        ::testing::Values(&vpx_ssim_parms_4x8_row_sse2));
+#endif
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(AVX2, SsimParmsRowTest,
+                        ::testing::Values(&vpx_ssim_parms_4x8_row_avx2));
+#endif
+
+#if HAVE_NEON
+INSTANTIATE_TEST_CASE_P(NEON, SsimParmsRowTest,
+                        ::testing::Values(&vpx_ssim_parms_4x8_row_neon));
+#endif
+
+class QualityMetricsTest : public ::testing::Test {
+ protected:
+  // Odd dimensions exercise the partial bands and the C edge paths.
+  static const int kWidth = 357;
+  static const int kHeight = 243;
+
+  virtual void SetUp() {
+    memset(&source_, 0, sizeof(source_));
+    memset(&dest_, 0, sizeof(dest_));
+    ASSERT_EQ(0, vpx_alloc_frame_buffer(&source_, kWidth, kHeight, 1, 1,
+#if CONFIG_VP9_HIGHBITDEPTH
+                                        0,
+#endif
+                                        32, 16));
+    ASSERT_EQ(0, vpx_alloc_frame_buffer(&dest_, kWidth, kHeight, 1, 1,
+#if CONFIG_VP9_HIGHBITDEPTH
+                                        0,
+#endif
+                                        32, 16));
+    ACMRandom rnd(ACMRandom::DeterministicSeed());
+    FillPlane(&rnd, source_.y_buffer, dest_.y_buffer, source_.y_stride,
+              source_.y_width, source_.y_height);
+    FillPlane(&rnd, source_.u_buffer, dest_.u_buffer, source_.uv_stride,
+              source_.uv_width, source_.uv_height);
+    FillPlane(&rnd, source_.v_buffer, dest_.v_buffer, source_.uv_stride,
+              source_.uv_width, source_.uv_height);
+  }
+
+  virtual void TearDown() {
+    vpx_free_frame_buffer(&source_);
+    vpx_free_frame_buffer(&dest_);
+    libvpx_test::ClearSystemState();
+  }
+
+  // A smooth gradient with a little noise, plus a distorted copy, so every
+  // metric lands in a meaningful range.
+  static void FillPlane(ACMRandom *rnd, uint8_t *src, uint8_t *dst,
+                        int stride, int width, int height) {
+    for (int y = 0; y < height; ++y) {
+      for (int x = 0; x < width; ++x) {
+        const int v = ((x * 3 + y * 2) & 255) + rnd->Rand8() % 8;
+        const int d = v + rnd->Rand8() % 17 - 8;
+        src[y * stride + x] = v > 255 ? 255 : v;
+        dst[y * stride + x] = d < 0 ? 0 : d > 255 ? 255 : d;
+      }
+    }
+  }
+
+  YV12_BUFFER_CONFIG source_;
+  YV12_BUFFER_CONFIG dest_;
+};
+
+TEST_F(QualityMetricsTest, MatchesSeparateMetrics) {
+  QualityMetrics m;
+  double ssim[3], fastssim[3], psnrhvs[3];
+  uint64_t sse = 0;
+
+  ASSERT_EQ(0, vpx_calc_quality_metrics(&source_, &dest_, VPX_METRIC_ALL, 8,
+                                        NULL, 0, &m));
+
+  for (int y = 0; y < kHeight; ++y) {
+    for (int x = 0; x < kWidth; ++x) {
+      const int diff = source_.y_buffer[y * source_.y_stride + x] -
+                       dest_.y_buffer[y * dest_.y_stride + x];
+      sse += diff * diff;
+    }
+  }
+  EXPECT_EQ(sse, m.sse[1]);
+  EXPECT_EQ(static_cast<uint32_t>(kWidth * kHeight), m.samples[1]);
+
+  vpx_calc_ssimg(&source_, &dest_, &ssim[0], &ssim[1], &ssim[2]);
+  const double fastssim_all = vpx_calc_fastssim(&source_, &dest_,
+                                                &fastssim[0], &fastssim[1],
+                                                &fastssim[2]);
+  const double psnrhvs_all = vpx_psnrhvs(&source_, &dest_, &psnrhvs[0],
+                                         &psnrhvs[1], &psnrhvs[2]);
+  for (int p = 0; p < 3; ++p) {
+    EXPECT_NEAR(ssim[p], m.ssim[1 + p], 1e-9);
+    EXPECT_DOUBLE_EQ(fastssim[p], m.fastssim[1 + p]);
+    EXPECT_NEAR(psnrhvs[p], m.psnrhvs[1 + p], 1e-3 * psnrhvs[p]);
+  }
+  EXPECT_DOUBLE_EQ(fastssim_all, m.fastssim[0]);
+  EXPECT_NEAR(psnrhvs_all, m.psnrhvs[0], 1e-2);
+  EXPECT_DOUBLE_EQ(vpx_get_blockiness(source_.y_buffer, source_.y_stride,
+                                      dest_.y_buffer, dest_.y_stride,
+                                      kWidth, kHeight),
+                   m.blockiness);
+}
+
+TEST_F(QualityMetricsTest, ThreadedMatchesSerial) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  const int kNumWorkers = 3;
+  VPxWorker workers[kNumWorkers];
+  QualityMetrics serial, threaded;
+
+  for (int i = 0; i < kNumWorkers; ++i) {
+    winterface->init(&workers[i]);
+    ASSERT_NE(0, winterface->reset(&workers[i]));
+  }
+
+  ASSERT_EQ(0, vpx_calc_quality_metrics(&source_, &dest_, VPX_METRIC_ALL, 8,
+                                        NULL, 0, &serial));
+  ASSERT_EQ(0, vpx_calc_quality_metrics(&source_, &dest_, VPX_METRIC_ALL, 8,
+                                        workers, kNumWorkers, &threaded));
+  for (int i = 0; i < kNumWorkers; ++i)
+    winterface->end(&workers[i]);
+
+  // Bands are reduced in a fixed order, so the result must not depend on
+  // the number of threads.
+  for (int p = 0; p < 4; ++p) {
+    EXPECT_EQ(serial.sse[p], threaded.sse[p]);
+    EXPECT_EQ(serial.psnr[p], threaded.psnr[p]);
+    EXPECT_EQ(serial.ssim[p], threaded.ssim[p]);
+    EXPECT_EQ(serial.fastssim[p], threaded.fastssim[p]);
+    EXPECT_EQ(serial.psnrhvs[p], threaded.psnrhvs[p]);
+  }
+  EXPECT_EQ(serial.blockiness, threaded.blockiness);
+}
+
+}  // namespace
@@ -14,6 +14,7 @@
 
 #include "third_party/googletest/src/include/gtest/gtest.h"
 
+#include "./vpx_config.h"
 #include "./vpx_dsp_rtcd.h"
 #include "test/acm_random.h"
 #include "test/clear_system_state.h"
@@ -381,4 +382,183 @@ INTRA_PRED_TEST(MSA, TestIntraPred32, vpx_dc_predictor_32x32_msa,
                 NULL, vpx_tm_predictor_32x32_msa)
 #endif  // HAVE_MSA
 
+#if CONFIG_VP9_HIGHBITDEPTH
+namespace {
+
+typedef void (*VpxHighbdPredFunc)(uint16_t *dst, ptrdiff_t y_stride,
+                                  const uint16_t *above, const uint16_t *left,
+                                  int bd);
+
+void TestHighbdIntraPred(const char name[], VpxHighbdPredFunc const *pred_funcs,
+                         const char *const pred_func_names[], int num_funcs,
+                         const char *const signatures[], int block_size,
+                         int num_pixels_per_test) {
+  libvpx_test::ACMRandom rnd(libvpx_test::ACMRandom::DeterministicSeed());
+  const int kBPS = 32;
+  const int kTotalPixels = 32 * kBPS;
+  const int kBitDepth = 10;
+  const int kMask = (1 << kBitDepth) - 1;
+  DECLARE_ALIGNED(16, uint16_t, src[kTotalPixels]);
+  DECLARE_ALIGNED(16, uint16_t, ref_src[kTotalPixels]);
+  DECLARE_ALIGNED(16, uint16_t, left[kBPS]);
+  DECLARE_ALIGNED(16, uint16_t, above_mem[2 * kBPS + 16]);
+  uint16_t *const above = above_mem + 16;
+  for (int i = 0; i < kTotalPixels; ++i) ref_src[i] = rnd.Rand16() & kMask;
+  for (int i = 0; i < kBPS; ++i) left[i] = rnd.Rand16() & kMask;
+  for (int i = -1; i < kBPS; ++i) above[i] = rnd.Rand16() & kMask;
+  const int kNumTests = static_cast<int>(2.e10 / num_pixels_per_test);
+
+  ASSERT_LE(block_size, kBPS);
+  for (int i = block_size; i < 2 * kBPS; ++i) above[i] = above[block_size - 1];
+
+  for (int k = 0; k < num_funcs; ++k) {
+    if (pred_funcs[k] == NULL) continue;
+    memcpy(src, ref_src, sizeof(src));
+    vpx_usec_timer timer;
+    vpx_usec_timer_start(&timer);
+    for (int num_tests = 0; num_tests < kNumTests; ++num_tests) {
+      pred_funcs[k](src, kBPS, above, left, kBitDepth);
+    }
+    libvpx_test::ClearSystemState();
+    vpx_usec_timer_mark(&timer);
+    const int elapsed_time =
+        static_cast<int>(vpx_usec_timer_elapsed(&timer) / 1000);
+    libvpx_test::MD5 md5;
+    md5.Add(reinterpret_cast<const uint8_t *>(src), sizeof(src));
+    printf("Mode %s[%12s]: %5d ms     MD5: %s\n", name, pred_func_names[k],
+           elapsed_time, md5.Get());
+    EXPECT_STREQ(signatures[k], md5.Get());
+  }
+}
+
+void TestHighbdIntraPred16(VpxHighbdPredFunc const *pred_funcs) {
+  static const int kNumVp9IntraFuncs = 13;
+  static const char *const kSignatures[kNumVp9IntraFuncs] = {
+    "1ea385324508938136f0d6f9c955a3ba",
+    "86d064389af1545bf2c602277bd8b830",
+    "87c89fa931d18f50347017a122d1127f",
+    "79102ce74c0c0d3ce5cb707ab07a2a61",
+    "ac5972000ff5417800d5eed30d024a5f",
+    "ca6808f8b1b9eccd264f276857d67881",
+    "7c72a13843703fca6f3cdfcc9668b987",
+    "45898933696da2f03dc1f5ead64c830e",
+    "6b93d86e1d1d27bed2cae3e5be26a065",
+    "eb35663e99cd8f563effd31e51cd1d0c",
+    "19faccbcaa98a660754f99f8c94bcfc1",
+    "952f0a5c8ffacfc7af24dd7153e5a665",
+    "6ab6fc73c9d1a403eb0d19742f194df1",
+  };
+  TestHighbdIntraPred("Intra16", pred_funcs, kVp9IntraPredNames,
+                      kNumVp9IntraFuncs, kSignatures, 16,
+                      16 * 16 * kNumVp9IntraFuncs);
+}
+
+void TestHighbdIntraPred32(VpxHighbdPredFunc const *pred_funcs) {
+  static const int kNumVp9IntraFuncs = 13;
+  static const char *const kSignatures[kNumVp9IntraFuncs] = {
+    "6917f600ca27131b31496767237a1c59",
+    "8978a657b8526d6ef48750761ff85f1c",
+    "80dd44c586b19ff339d536421874b6d1",
+    "6cd1b84e01bb7cd74e30c89f41099dcd",
+    "46e580eee9f61abb252e9dec5c3fd771",
+    "03837ac55ede95caeb656bbe1d2260d6",
+    "f9a45473947dba45c96b416b2bffac6c",
+    "9d76598298b06955e1371dd808c7a7f0",
+    "b1dabd62b23912be6d007b3b6800802f",
+    "356d3bdaa9a4822dfe7a35ea10def829",
+    "7614d455c0a340b72dbe74c503a06c54",
+    "aa649070f8ba89cad58968fcde905d7c",
+    "296f5fe0fcd09bf9f7c442cf301a3a6a",
+  };
+  TestHighbdIntraPred("Intra32", pred_funcs, kVp9IntraPredNames,
+                      kNumVp9IntraFuncs, kSignatures, 32,
+                      32 * 32 * kNumVp9IntraFuncs);
+}
+
+}  // namespace
+
+#define HIGHBD_INTRA_PRED_TEST(arch, test_func, dc, dc_left, dc_top, dc_128, \
+                               v, h, d45, d135, d117, d153, d207, d63, tm)  \
+  TEST(arch, test_func) {                                                   \
+    static const VpxHighbdPredFunc vpx_intra_pred[] = {                     \
+        dc,   dc_left, dc_top, dc_128, v,   h, d45,                         \
+        d135, d117,    d153,   d207,   d63, tm};                            \
+    test_func(vpx_intra_pred);                                              \
+  }
+
+// -----------------------------------------------------------------------------
+// High bitdepth 16x16
+
+HIGHBD_INTRA_PRED_TEST(C, TestHighbdIntraPred16,
+                       vpx_highbd_dc_predictor_16x16_c,
+                       vpx_highbd_dc_left_predictor_16x16_c,
+                       vpx_highbd_dc_top_predictor_16x16_c,
+                       vpx_highbd_dc_128_predictor_16x16_c,
+                       vpx_highbd_v_predictor_16x16_c,
+                       vpx_highbd_h_predictor_16x16_c,
+                       vpx_highbd_d45_predictor_16x16_c,
+                       vpx_highbd_d135_predictor_16x16_c,
+                       vpx_highbd_d117_predictor_16x16_c,
+                       vpx_highbd_d153_predictor_16x16_c,
+                       vpx_highbd_d207_predictor_16x16_c,
+                       vpx_highbd_d63_predictor_16x16_c,
+                       vpx_highbd_tm_predictor_16x16_c)
+
+#if HAVE_SSE2 && CONFIG_USE_X86INC && ARCH_X86_64
+HIGHBD_INTRA_PRED_TEST(SSE2, TestHighbdIntraPred16,
+                       vpx_highbd_dc_predictor_16x16_sse2, NULL, NULL, NULL,
+                       vpx_highbd_v_predictor_16x16_sse2, NULL, NULL, NULL,
+                       NULL, NULL, NULL, NULL,
+                       vpx_highbd_tm_predictor_16x16_sse2)
+#endif  // HAVE_SSE2 && CONFIG_USE_X86INC && ARCH_X86_64
+
+#if HAVE_AVX2
+HIGHBD_INTRA_PRED_TEST(AVX2, TestHighbdIntraPred16,
+                       vpx_highbd_dc_predictor_16x16_avx2,
+                       vpx_highbd_dc_left_predictor_16x16_avx2,
+                       vpx_highbd_dc_top_predictor_16x16_avx2,
+                       vpx_highbd_dc_128_predictor_16x16_avx2,
+                       vpx_highbd_v_predictor_16x16_avx2,
+                       vpx_highbd_h_predictor_16x16_avx2, NULL, NULL, NULL,
+                       NULL, NULL, NULL, vpx_highbd_tm_predictor_16x16_avx2)
+#endif  // HAVE_AVX2
+
+// -----------------------------------------------------------------------------
+// High bitdepth 32x32
+
+HIGHBD_INTRA_PRED_TEST(C, TestHighbdIntraPred32,
+                       vpx_highbd_dc_predictor_32x32_c,
+                       vpx_highbd_dc_left_predictor_32x32_c,
+                       vpx_highbd_dc_top_predictor_32x32_c,
+                       vpx_highbd_dc_128_predictor_32x32_c,
+                       vpx_highbd_v_predictor_32x32_c,
+                       vpx_highbd_h_predictor_32x32_c,
+                       vpx_highbd_d45_predictor_32x32_c,
+                       vpx_highbd_d135_predictor_32x32_c,
+                       vpx_highbd_d117_predictor_32x32_c,
+                       vpx_highbd_d153_predictor_32x32_c,
+                       vpx_highbd_d207_predictor_32x32_c,
+                       vpx_highbd_d63_predictor_32x32_c,
+                       vpx_highbd_tm_predictor_32x32_c)
+
+#if HAVE_SSE2 && CONFIG_USE_X86INC && ARCH_X86_64
+HIGHBD_INTRA_PRED_TEST(SSE2, TestHighbdIntraPred32,
+                       vpx_highbd_dc_predictor_32x32_sse2, NULL, NULL, NULL,
+                       vpx_highbd_v_predictor_32x32_sse2, NULL, NULL, NULL,
+                       NULL, NULL, NULL, NULL,
+                       vpx_highbd_tm_predictor_32x32_sse2)
+#endif  // HAVE_SSE2 && CONFIG_USE_X86INC && ARCH_X86_64
+
+#if HAVE_AVX2
+HIGHBD_INTRA_PRED_TEST(AVX2, TestHighbdIntraPred32,
+                       vpx_highbd_dc_predictor_32x32_avx2,
+                       vpx_highbd_dc_left_predictor_32x32_avx2,
+                       vpx_highbd_dc_top_predictor_32x32_avx2,
+                       vpx_highbd_dc_128_predictor_32x32_avx2,
+                       vpx_highbd_v_predictor_32x32_avx2,
+                       vpx_highbd_h_predictor_32x32_avx2, NULL, NULL, NULL,
+                       NULL, NULL, NULL, vpx_highbd_tm_predictor_32x32_avx2)
+#endif  // HAVE_AVX2
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+
 #include "test/test_libvpx.cc"
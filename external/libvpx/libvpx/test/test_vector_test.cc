@@ -134,7 +134,6 @@ TEST_P(TestVectorTest, MD5Match) {
 }
 
 // Test VP8 decode in serial mode with single thread.
-// NOTE: VP8 only support serial mode.
 #if CONFIG_VP8_DECODER
 VP8_INSTANTIATE_TEST_CASE(
     TestVectorTest,
@@ -144,6 +143,21 @@ VP8_INSTANTIATE_TEST_CASE(
         ::testing::ValuesIn(libvpx_test::kVP8TestVectors,
                             libvpx_test::kVP8TestVectors +
                                 libvpx_test::kNumVP8TestVectors)));
+
+#if CONFIG_MULTITHREAD
+// Test VP8 decode in frame parallel mode with different number of threads.
+INSTANTIATE_TEST_CASE_P(
+    VP8MultiThreadedFrameParallel, TestVectorTest,
+    ::testing::Combine(
+        ::testing::Values(
+            static_cast<const libvpx_test::CodecFactory *>(&libvpx_test::kVP8)),
+        ::testing::Combine(
+            ::testing::Values(1),        // Frame Parallel mode.
+            ::testing::Range(2, 9),      // With 2 ~ 8 threads.
+            ::testing::ValuesIn(libvpx_test::kVP8TestVectors,
+                                libvpx_test::kVP8TestVectors +
+                                    libvpx_test::kNumVP8TestVectors))));
+#endif  // CONFIG_MULTITHREAD
 #endif  // CONFIG_VP8_DECODER
 
 // Test VP9 decode in serial mode with single thread.
@@ -298,4 +298,126 @@ INSTANTIATE_TEST_CASE_P(SSE2_TO_C_12, VP9IntraPredTest,
 #endif  // CONFIG_USE_X86INC
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 #endif  // HAVE_SSE2
+
+#if HAVE_AVX2 && CONFIG_VP9_HIGHBITDEPTH
+INSTANTIATE_TEST_CASE_P(AVX2_TO_C_8, VP9IntraPredTest,
+                        ::testing::Values(
+                            make_tuple(&vpx_highbd_dc_predictor_16x16_avx2,
+                                       &vpx_highbd_dc_predictor_16x16_c, 16, 8),
+                            make_tuple(&vpx_highbd_dc_predictor_32x32_avx2,
+                                       &vpx_highbd_dc_predictor_32x32_c, 32, 8),
+                            make_tuple(&vpx_highbd_dc_top_predictor_16x16_avx2,
+                                       &vpx_highbd_dc_top_predictor_16x16_c, 16,
+                                       8),
+                            make_tuple(&vpx_highbd_dc_top_predictor_32x32_avx2,
+                                       &vpx_highbd_dc_top_predictor_32x32_c, 32,
+                                       8),
+                            make_tuple(&vpx_highbd_dc_left_predictor_16x16_avx2,
+                                       &vpx_highbd_dc_left_predictor_16x16_c,
+                                       16, 8),
+                            make_tuple(&vpx_highbd_dc_left_predictor_32x32_avx2,
+                                       &vpx_highbd_dc_left_predictor_32x32_c,
+                                       32, 8),
+                            make_tuple(&vpx_highbd_dc_128_predictor_16x16_avx2,
+                                       &vpx_highbd_dc_128_predictor_16x16_c, 16,
+                                       8),
+                            make_tuple(&vpx_highbd_dc_128_predictor_32x32_avx2,
+                                       &vpx_highbd_dc_128_predictor_32x32_c, 32,
+                                       8),
+                            make_tuple(&vpx_highbd_v_predictor_16x16_avx2,
+                                       &vpx_highbd_v_predictor_16x16_c, 16, 8),
+                            make_tuple(&vpx_highbd_v_predictor_32x32_avx2,
+                                       &vpx_highbd_v_predictor_32x32_c, 32, 8),
+                            make_tuple(&vpx_highbd_h_predictor_16x16_avx2,
+                                       &vpx_highbd_h_predictor_16x16_c, 16, 8),
+                            make_tuple(&vpx_highbd_h_predictor_32x32_avx2,
+                                       &vpx_highbd_h_predictor_32x32_c, 32, 8),
+                            make_tuple(&vpx_highbd_tm_predictor_16x16_avx2,
+                                       &vpx_highbd_tm_predictor_16x16_c, 16, 8),
+                            make_tuple(&vpx_highbd_tm_predictor_32x32_avx2,
+                                       &vpx_highbd_tm_predictor_32x32_c, 32,
+                                       8)));
+
+INSTANTIATE_TEST_CASE_P(AVX2_TO_C_10, VP9IntraPredTest,
+                        ::testing::Values(
+                            make_tuple(&vpx_highbd_dc_predictor_16x16_avx2,
+                                       &vpx_highbd_dc_predictor_16x16_c, 16,
+                                       10),
+                            make_tuple(&vpx_highbd_dc_predictor_32x32_avx2,
+                                       &vpx_highbd_dc_predictor_32x32_c, 32,
+                                       10),
+                            make_tuple(&vpx_highbd_dc_top_predictor_16x16_avx2,
+                                       &vpx_highbd_dc_top_predictor_16x16_c, 16,
+                                       10),
+                            make_tuple(&vpx_highbd_dc_top_predictor_32x32_avx2,
+                                       &vpx_highbd_dc_top_predictor_32x32_c, 32,
+                                       10),
+                            make_tuple(&vpx_highbd_dc_left_predictor_16x16_avx2,
+                                       &vpx_highbd_dc_left_predictor_16x16_c,
+                                       16, 10),
+                            make_tuple(&vpx_highbd_dc_left_predictor_32x32_avx2,
+                                       &vpx_highbd_dc_left_predictor_32x32_c,
+                                       32, 10),
+                            make_tuple(&vpx_highbd_dc_128_predictor_16x16_avx2,
+                                       &vpx_highbd_dc_128_predictor_16x16_c, 16,
+                                       10),
+                            make_tuple(&vpx_highbd_dc_128_predictor_32x32_avx2,
+                                       &vpx_highbd_dc_128_predictor_32x32_c, 32,
+                                       10),
+                            make_tuple(&vpx_highbd_v_predictor_16x16_avx2,
+                                       &vpx_highbd_v_predictor_16x16_c, 16, 10),
+                            make_tuple(&vpx_highbd_v_predictor_32x32_avx2,
+                                       &vpx_highbd_v_predictor_32x32_c, 32, 10),
+                            make_tuple(&vpx_highbd_h_predictor_16x16_avx2,
+                                       &vpx_highbd_h_predictor_16x16_c, 16, 10),
+                            make_tuple(&vpx_highbd_h_predictor_32x32_avx2,
+                                       &vpx_highbd_h_predictor_32x32_c, 32, 10),
+                            make_tuple(&vpx_highbd_tm_predictor_16x16_avx2,
+                                       &vpx_highbd_tm_predictor_16x16_c, 16,
+                                       10),
+                            make_tuple(&vpx_highbd_tm_predictor_32x32_avx2,
+                                       &vpx_highbd_tm_predictor_32x32_c, 32,
+                                       10)));
+
+INSTANTIATE_TEST_CASE_P(AVX2_TO_C_12, VP9IntraPredTest,
+                        ::testing::Values(
+                            make_tuple(&vpx_highbd_dc_predictor_16x16_avx2,
+                                       &vpx_highbd_dc_predictor_16x16_c, 16,
+                                       12),
+                            make_tuple(&vpx_highbd_dc_predictor_32x32_avx2,
+                                       &vpx_highbd_dc_predictor_32x32_c, 32,
+                                       12),
+                            make_tuple(&vpx_highbd_dc_top_predictor_16x16_avx2,
+                                       &vpx_highbd_dc_top_predictor_16x16_c, 16,
+                                       12),
+                            make_tuple(&vpx_highbd_dc_top_predictor_32x32_avx2,
+                                       &vpx_highbd_dc_top_predictor_32x32_c, 32,
+                                       12),
+                            make_tuple(&vpx_highbd_dc_left_predictor_16x16_avx2,
+                                       &vpx_highbd_dc_left_predictor_16x16_c,
+                                       16, 12),
+                            make_tuple(&vpx_highbd_dc_left_predictor_32x32_avx2,
+                                       &vpx_highbd_dc_left_predictor_32x32_c,
+                                       32, 12),
+                            make_tuple(&vpx_highbd_dc_128_predictor_16x16_avx2,
+                                       &vpx_highbd_dc_128_predictor_16x16_c, 16,
+                                       12),
+                            make_tuple(&vpx_highbd_dc_128_predictor_32x32_avx2,
+                                       &vpx_highbd_dc_128_predictor_32x32_c, 32,
+                                       12),
+                            make_tuple(&vpx_highbd_v_predictor_16x16_avx2,
+                                       &vpx_highbd_v_predictor_16x16_c, 16, 12),
+                            make_tuple(&vpx_highbd_v_predictor_32x32_avx2,
+                                       &vpx_highbd_v_predictor_32x32_c, 32, 12),
+                            make_tuple(&vpx_highbd_h_predictor_16x16_avx2,
+                                       &vpx_highbd_h_predictor_16x16_c, 16, 12),
+                            make_tuple(&vpx_highbd_h_predictor_32x32_avx2,
+                                       &vpx_highbd_h_predictor_32x32_c, 32, 12),
+                            make_tuple(&vpx_highbd_tm_predictor_16x16_avx2,
+                                       &vpx_highbd_tm_predictor_16x16_c, 16,
+                                       12),
+                            make_tuple(&vpx_highbd_tm_predictor_32x32_avx2,
+                                       &vpx_highbd_tm_predictor_32x32_c, 32,
+                                       12)));
+#endif  // HAVE_AVX2 && CONFIG_VP9_HIGHBITDEPTH
 }  // namespace
@@ -0,0 +1,162 @@
+/*
+ *  Copyright (c) 2015 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <cstring>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "./vpx_config.h"
+#include "./vp9_rtcd.h"
+#include "test/acm_random.h"
+#include "test/clear_system_state.h"
+#include "test/register_state_check.h"
+#include "test/util.h"
+#include "vpx/vpx_integer.h"
+#include "vpx_ports/mem.h"
+
+using libvpx_test::ACMRandom;
+
+namespace {
+
+const int kNumIterations = 1000;
+
+typedef void (*TemporalFilterApplyFunc)(uint8_t *frame1, unsigned int stride,
+                                        uint8_t *frame2,
+                                        unsigned int block_width,
+                                        unsigned int block_height,
+                                        int strength, int filter_weight,
+                                        unsigned int *accumulator,
+                                        uint16_t *count);
+
+// Params: reference function, function under test, bit depth.
+typedef std::tr1::tuple<TemporalFilterApplyFunc, TemporalFilterApplyFunc,
+                        int> TemporalFilterParam;
+
+class TemporalFilterTest
+    : public ::testing::TestWithParam<TemporalFilterParam> {
+ public:
+  virtual ~TemporalFilterTest() {}
+  virtual void SetUp() {
+    ref_func_ = GET_PARAM(0);
+    tst_func_ = GET_PARAM(1);
+    bit_depth_ = GET_PARAM(2);
+  }
+
+  virtual void TearDown() { libvpx_test::ClearSystemState(); }
+
+ protected:
+  void RunCheck(bool extreme);
+
+  TemporalFilterApplyFunc ref_func_;
+  TemporalFilterApplyFunc tst_func_;
+  int bit_depth_;
+};
+
+void TemporalFilterTest::RunCheck(bool extreme) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  const int stride = 32;
+  const int mask = (1 << bit_depth_) - 1;
+  DECLARE_ALIGNED(16, uint16_t, src16[16 * 32]);
+  DECLARE_ALIGNED(16, uint16_t, pred16[16 * 16]);
+  DECLARE_ALIGNED(16, uint8_t, src8[16 * 32]);
+  DECLARE_ALIGNED(16, uint8_t, pred8[16 * 16]);
+  DECLARE_ALIGNED(16, unsigned int, ref_acc[16 * 16]);
+  DECLARE_ALIGNED(16, unsigned int, tst_acc[16 * 16]);
+  DECLARE_ALIGNED(16, uint16_t, ref_count[16 * 16]);
+  DECLARE_ALIGNED(16, uint16_t, tst_count[16 * 16]);
+  uint8_t *src;
+  uint8_t *pred;
+
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (bit_depth_ > 8) {
+    src = CONVERT_TO_BYTEPTR(src16);
+    pred = CONVERT_TO_BYTEPTR(pred16);
+  } else {
+    src = src8;
+    pred = pred8;
+  }
+#else
+  src = src8;
+  pred = pred8;
+#endif
+
+  for (int iter = 0; iter < kNumIterations; ++iter) {
+    // Block sizes 16x16, 8x8 and 16x8 cover luma and 4:2:0 / 4:2:2 chroma.
+    const unsigned int width = (iter % 3) == 1 ? 8 : 16;
+    const unsigned int height = (iter % 3) == 0 ? 16 : 8;
+    const int filter_weight = rnd(3);
+    const int strength = rnd(7) + 2 * (bit_depth_ - 8);
+
+    for (int i = 0; i < 16 * 32; ++i) {
+      const int v = extreme ? (rnd(2) ? mask : 0) : (rnd.Rand16() & mask);
+      src16[i] = v;
+      src8[i] = v;
+    }
+    for (int i = 0; i < 16 * 16; ++i) {
+      const int v = extreme ? (rnd(2) ? mask : 0) : (rnd.Rand16() & mask);
+      pred16[i] = v;
+      pred8[i] = v;
+      ref_acc[i] = tst_acc[i] = rnd.Rand16();
+      ref_count[i] = tst_count[i] = rnd.Rand8();
+    }
+
+    ref_func_(src, stride, pred, width, height, strength, filter_weight,
+              ref_acc, ref_count);
+    ASM_REGISTER_STATE_CHECK(tst_func_(src, stride, pred, width, height,
+                                       strength, filter_weight,
+                                       tst_acc, tst_count));
+
+    for (int i = 0; i < 16 * 16; ++i) {
+      ASSERT_EQ(ref_acc[i], tst_acc[i])
+          << "accumulator mismatch at " << i << " iteration " << iter;
+      ASSERT_EQ(ref_count[i], tst_count[i])
+          << "count mismatch at " << i << " iteration " << iter;
+    }
+  }
+}
+
+TEST_P(TemporalFilterTest, OperationCheck) {
+  RunCheck(false);
+}
+
+TEST_P(TemporalFilterTest, ExtremeValues) {
+  RunCheck(true);
+}
+
+using std::tr1::make_tuple;
+
+#if HAVE_SSE2
+INSTANTIATE_TEST_CASE_P(
+    SSE2, TemporalFilterTest,
+    ::testing::Values(
+        make_tuple(&vp9_temporal_filter_apply_c,
+                   &vp9_temporal_filter_apply_sse2, 8)));
+
+#if CONFIG_VP9_HIGHBITDEPTH
+INSTANTIATE_TEST_CASE_P(
+    SSE2_HBD, TemporalFilterTest,
+    ::testing::Values(
+        make_tuple(&vp9_highbd_temporal_filter_apply_c,
+                   &vp9_highbd_temporal_filter_apply_sse2, 8),
+        make_tuple(&vp9_highbd_temporal_filter_apply_c,
+                   &vp9_highbd_temporal_filter_apply_sse2, 10),
+        make_tuple(&vp9_highbd_temporal_filter_apply_c,
+                   &vp9_highbd_temporal_filter_apply_sse2, 12)));
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+#endif  // HAVE_SSE2
+
+#if HAVE_MSA
+INSTANTIATE_TEST_CASE_P(
+    MSA, TemporalFilterTest,
+    ::testing::Values(
+        make_tuple(&vp9_temporal_filter_apply_c,
+                   &vp9_temporal_filter_apply_msa, 8)));
+#endif  // HAVE_MSA
+}  // namespace
@@ -392,6 +392,58 @@ vpxenc_vp9_webm_lag10_frames20() {
   fi
 }
 
+# Wrapper function for running a --chunk-threads encode, which can't be
+# combined with --test-decode. $1 is the output file and $2 the number of
+# frames it must decode to. All remaining parameters, starting with the input
+# file, are passed through to vpxenc.
+vpxenc_vp9_chunks() {
+  local readonly encoder="$(vpx_tool_path vpxenc)"
+  local readonly decoder="$(vpx_tool_path vpxdec)"
+  local readonly output="$1"
+  local readonly expected="$2"
+  shift 2
+
+  eval "${VPX_TEST_PREFIX}" "${encoder}" "$@" \
+    --codec=vp9 \
+    --passes=2 \
+    --kf-max-dist=4 \
+    --chunk-threads=2 \
+    --ivf \
+    --output="${output}" ${devnull}
+
+  if [ ! -e "${output}" ]; then
+    elog "Output file does not exist."
+    return 1
+  fi
+
+  local readonly num_frames=$(${VPX_TEST_PREFIX} "${decoder}" "${output}" \
+    --summary --noblit 2>&1 \
+    | awk '/^[0-9]+ decoded frames/ { print $1 }')
+  if [ "$num_frames" -ne "$expected" ]; then
+    elog "Output frames ($num_frames) != expected ($expected)"
+    return 1
+  fi
+}
+
+vpxenc_vp9_ivf_2pass_chunks() {
+  if [ "$(vpxenc_can_encode_vp9)" = "yes" ] && \
+     [ "$(vp9_decode_available)" = "yes" ] && \
+     [ -n "$(vpx_tool_path vpxdec)" ]; then
+    vpxenc_vp9_chunks "${VPX_TEST_OUTPUT_DIR}/vp9_chunks.ivf" "${TEST_FRAMES}" \
+      $(yuv_input_hantro_collage) --limit="${TEST_FRAMES}"
+  fi
+}
+
+vpxenc_vp9_ivf_2pass_chunks_y4m_skip() {
+  if [ "$(vpxenc_can_encode_vp9)" = "yes" ] && \
+     [ "$(vp9_decode_available)" = "yes" ] && \
+     [ -n "$(vpx_tool_path vpxdec)" ]; then
+    vpxenc_vp9_chunks "${VPX_TEST_OUTPUT_DIR}/vp9_chunks_y4m.ivf" \
+      "$((TEST_FRAMES - 2))" $(y4m_input_non_square_par) \
+      --limit="${TEST_FRAMES}" --skip=2
+  fi
+}
+
 # TODO(fgalligan): Test that DisplayWidth is different than video width.
 vpxenc_vp9_webm_non_square_par() {
   if [ "$(vpxenc_can_encode_vp9)" = "yes" ] && \
@@ -424,6 +476,8 @@ vpxenc_tests="vpxenc_vp8_ivf
               vpxenc_vp9_ivf_lossless
               vpxenc_vp9_ivf_minq0_maxq0
               vpxenc_vp9_webm_lag10_frames20
+              vpxenc_vp9_ivf_2pass_chunks
+              vpxenc_vp9_ivf_2pass_chunks_y4m_skip
               vpxenc_vp9_webm_non_square_par"
 
 run_tests vpxenc_verify_environment "${vpxenc_tests}"
@@ -611,7 +611,10 @@ Segment::Segment(IMkvReader* pReader, long long elem_start,
       m_clusters(NULL),
       m_clusterCount(0),
       m_clusterPreloadCount(0),
-      m_clusterSize(0) {}
+      m_clusterSize(0),
+      m_resident(NULL),
+      m_residentSize(0),
+      m_residentPos(0) {}
 
 Segment::~Segment() {
   const long count = m_clusterCount + m_clusterPreloadCount;
@@ -627,6 +630,7 @@ Segment::~Segment() {
   }
 
   delete[] m_clusters;
+  delete[] m_resident;
 
   delete m_pTracks;
   delete m_pInfo;
@@ -2135,9 +2139,49 @@ const Cluster* Segment::FindOrPreloadCluster(long long requested_pos) {
   assert(m_clusterPreloadCount > 0);
   assert(m_clusters[idx] == pCluster);
 
+  TouchCluster(pCluster);
   return pCluster;
 }
 
+void Segment::SetMaxResidentClusters(long count) {
+  delete[] m_resident;
+  m_resident = NULL;
+  m_residentPos = 0;
+
+  if (count <= 0) {
+    m_residentSize = 0;
+    return;
+  }
+
+  // The caller may still hold block entries of the previous cluster
+  // while it steps to the next one.
+  m_residentSize = (count < 2) ? 2 : count;
+  m_resident = new const Cluster*[m_residentSize];
+
+  for (long i = 0; i < m_residentSize; ++i)
+    m_resident[i] = NULL;
+}
+
+long Segment::GetMaxResidentClusters() const { return m_residentSize; }
+
+void Segment::TouchCluster(const Cluster* pCluster) {
+  if (m_resident == NULL || pCluster == NULL || pCluster->EOS())
+    return;
+
+  for (long i = 0; i < m_residentSize; ++i) {
+    if (m_resident[i] == pCluster)
+      return;
+  }
+
+  const Cluster* const pOldest = m_resident[m_residentPos];
+
+  if (pOldest)
+    pOldest->Unload();
+
+  m_resident[m_residentPos] = pCluster;
+  m_residentPos = (m_residentPos + 1) % m_residentSize;
+}
+
 CuePoint::CuePoint(long idx, long long pos)
     : m_element_start(0),
       m_element_size(0),
@@ -2397,6 +2441,12 @@ const Cluster* Segment::GetLast() const {
 unsigned long Segment::GetCount() const { return m_clusterCount; }
 
 const Cluster* Segment::GetNext(const Cluster* pCurr) {
+  const Cluster* const pNext = DoGetNext(pCurr);
+  TouchCluster(pNext);
+  return pNext;
+}
+
+const Cluster* Segment::DoGetNext(const Cluster* pCurr) {
   assert(pCurr);
   assert(pCurr != &m_eos);
   assert(m_clusters);
@@ -6367,6 +6417,31 @@ Cluster::~Cluster() {
   delete[] m_entries;
 }
 
+void Cluster::Unload() const {
+  // A cluster of unknown size may still be extended by the segment.
+  if (m_pSegment == NULL || m_element_size < 0 || m_entries_count < 0)
+    return;
+
+  BlockEntry** i = m_entries;
+  BlockEntry** const j = m_entries + m_entries_count;
+
+  while (i != j) {
+    BlockEntry* p = *i++;
+    assert(p);
+
+    delete p;
+  }
+
+  delete[] m_entries;
+
+  m_entries = NULL;
+  m_entries_size = 0;
+  m_entries_count = -1;  // means "has not been parsed yet"
+  m_pos = m_element_start;
+  m_element_size = -1;
+  m_timecode = -1;
+}
+
 bool Cluster::EOS() const { return (m_pSegment == NULL); }
 
 long Cluster::GetIndex() const { return m_index; }
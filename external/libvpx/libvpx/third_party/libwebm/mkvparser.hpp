@@ -887,6 +887,9 @@ class Cluster {
   long Parse(long long& pos, long& size) const;
   long GetEntry(long index, const mkvparser::BlockEntry*&) const;
 
+  // Releases the parsed block entries; they are re-parsed on demand.
+  void Unload() const;
+
  protected:
   Cluster(Segment*, long index, long long element_start);
   // long long element_size);
@@ -977,6 +980,12 @@ class Segment {
 
   const Cluster* FindOrPreloadCluster(long long pos);
 
+  // Streaming mode: at most |count| clusters returned by GetNext() or
+  // FindOrPreloadCluster() keep their block entries resident; older ones
+  // are unloaded.  0 (the default) keeps every parsed cluster.
+  void SetMaxResidentClusters(long count);
+  long GetMaxResidentClusters() const;
+
   long ParseCues(long long cues_off,  // offset relative to start of segment
                  long long& parse_pos, long& parse_len);
 
@@ -994,10 +1003,15 @@ class Segment {
   long m_clusterCount;  // number of entries for which m_index >= 0
   long m_clusterPreloadCount;  // number of entries for which m_index < 0
   long m_clusterSize;  // array size
+  const Cluster** m_resident;
+  long m_residentSize;
+  long m_residentPos;
 
   long DoLoadCluster(long long&, long&);
   long DoLoadClusterUnknownSize(long long&, long&);
   long DoParseNext(const Cluster*&, long long&, long&);
+  const Cluster* DoGetNext(const Cluster*);
+  void TouchCluster(const Cluster*);
 
   void AppendCluster(Cluster*);
   void PreloadCluster(Cluster*, ptrdiff_t);
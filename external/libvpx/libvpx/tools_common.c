@@ -278,6 +278,38 @@ double sse_to_psnr(double samples, double peak, double sse) {
   }
 }
 
+void accumulate_stage_timing(vpx_stage_timing_t *sum,
+                             const vpx_stage_timing_t *timing) {
+  int i;
+  for (i = 0; i < VPX_STAGE_COUNT; ++i)
+    sum->ns[i] += timing->ns[i];
+  sum->total_ns += timing->total_ns;
+}
+
+void print_stage_timing(FILE *file, const vpx_stage_timing_t *timing) {
+  static const char *const kStageNames[VPX_STAGE_COUNT] = {
+    "header", "entropy", "prediction", "transform", "loop filter",
+    "postproc", "motion search", "mode decision", "temporal filter"
+  };
+  const double total = timing->total_ns ? (double)timing->total_ns : 1.0;
+  uint64_t staged = 0;
+  int i;
+
+  fprintf(file, "Stage timing (ns):\n");
+  for (i = 0; i < VPX_STAGE_COUNT; ++i) {
+    if (!timing->ns[i])
+      continue;
+    staged += timing->ns[i];
+    fprintf(file, "  %-16s %14"PRIu64" %6.2f%%\n", kStageNames[i],
+            timing->ns[i], 100.0 * timing->ns[i] / total);
+  }
+  if (timing->total_ns > staged)
+    fprintf(file, "  %-16s %14"PRIu64" %6.2f%%\n", "other",
+            timing->total_ns - staged,
+            100.0 * (timing->total_ns - staged) / total);
+  fprintf(file, "  %-16s %14"PRIu64"\n", "total", timing->total_ns);
+}
+
 #if CONFIG_VP9_HIGHBITDEPTH
 static void highbd_img_upshift(vpx_image_t *dst, vpx_image_t *src,
                                int input_shift) {
@@ -18,13 +18,8 @@
 #include "entropymode.h"
 #include "systemdependent.h"
 
-void vp8_de_alloc_frame_buffers(VP8_COMMON *oci)
+static void de_alloc_context_buffers(VP8_COMMON *oci)
 {
-    int i;
-    for (i = 0; i < NUM_YV12_BUFFERS; i++)
-        vp8_yv12_de_alloc_frame_buffer(&oci->yv12_fb[i]);
-
-    vp8_yv12_de_alloc_frame_buffer(&oci->temp_scale_frame);
 #if CONFIG_POSTPROC
     vp8_yv12_de_alloc_frame_buffer(&oci->post_proc_buffer);
     if (oci->post_proc_buffer_int_used)
@@ -45,41 +40,26 @@ void vp8_de_alloc_frame_buffers(VP8_COMMON *oci)
     oci->mip = NULL;
 }
 
-int vp8_alloc_frame_buffers(VP8_COMMON *oci, int width, int height)
+void vp8_de_alloc_frame_buffers(VP8_COMMON *oci)
 {
     int i;
+    for (i = 0; i < NUM_YV12_BUFFERS; i++)
+        vp8_yv12_de_alloc_frame_buffer(&oci->yv12_fb[i]);
 
-    vp8_de_alloc_frame_buffers(oci);
+    vp8_yv12_de_alloc_frame_buffer(&oci->temp_scale_frame);
+    de_alloc_context_buffers(oci);
+}
+
+int vp8_alloc_context_buffers(VP8_COMMON *oci, int width, int height)
+{
+    de_alloc_context_buffers(oci);
 
-    
     if ((width & 0xf) != 0)
         width += 16 - (width & 0xf);
 
     if ((height & 0xf) != 0)
         height += 16 - (height & 0xf);
 
-
-    for (i = 0; i < NUM_YV12_BUFFERS; i++)
-    {
-        oci->fb_idx_ref_cnt[i] = 0;
-        oci->yv12_fb[i].flags = 0;
-        if (vp8_yv12_alloc_frame_buffer(&oci->yv12_fb[i], width, height, VP8BORDERINPIXELS) < 0)
-            goto allocation_fail;
-    }
-
-    oci->new_fb_idx = 0;
-    oci->lst_fb_idx = 1;
-    oci->gld_fb_idx = 2;
-    oci->alt_fb_idx = 3;
-
-    oci->fb_idx_ref_cnt[0] = 1;
-    oci->fb_idx_ref_cnt[1] = 1;
-    oci->fb_idx_ref_cnt[2] = 1;
-    oci->fb_idx_ref_cnt[3] = 1;
-
-    if (vp8_yv12_alloc_frame_buffer(&oci->temp_scale_frame,   width, 16, VP8BORDERINPIXELS) < 0)
-        goto allocation_fail;
-
     oci->mb_rows = height >> 4;
     oci->mb_cols = width >> 4;
     oci->MBs = oci->mb_rows * oci->mb_cols;
@@ -113,6 +93,51 @@ int vp8_alloc_frame_buffers(VP8_COMMON *oci, int width, int height)
 
     return 0;
 
+allocation_fail:
+    de_alloc_context_buffers(oci);
+    return 1;
+}
+
+int vp8_alloc_frame_buffers(VP8_COMMON *oci, int width, int height)
+{
+    int i;
+
+    vp8_de_alloc_frame_buffers(oci);
+
+    
+    if ((width & 0xf) != 0)
+        width += 16 - (width & 0xf);
+
+    if ((height & 0xf) != 0)
+        height += 16 - (height & 0xf);
+
+
+    for (i = 0; i < NUM_YV12_BUFFERS; i++)
+    {
+        oci->fb_idx_ref_cnt[i] = 0;
+        oci->yv12_fb[i].flags = 0;
+        if (vp8_yv12_alloc_frame_buffer(&oci->yv12_fb[i], width, height, VP8BORDERINPIXELS) < 0)
+            goto allocation_fail;
+    }
+
+    oci->new_fb_idx = 0;
+    oci->lst_fb_idx = 1;
+    oci->gld_fb_idx = 2;
+    oci->alt_fb_idx = 3;
+
+    oci->fb_idx_ref_cnt[0] = 1;
+    oci->fb_idx_ref_cnt[1] = 1;
+    oci->fb_idx_ref_cnt[2] = 1;
+    oci->fb_idx_ref_cnt[3] = 1;
+
+    if (vp8_yv12_alloc_frame_buffer(&oci->temp_scale_frame,   width, 16, VP8BORDERINPIXELS) < 0)
+        goto allocation_fail;
+
+    if (vp8_alloc_context_buffers(oci, width, height))
+        goto allocation_fail;
+
+    return 0;
+
 allocation_fail:
     vp8_de_alloc_frame_buffers(oci);
     return 1;
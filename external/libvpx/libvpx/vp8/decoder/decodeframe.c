@@ -36,6 +36,7 @@
 #include "dboolhuff.h"
 
 #include <assert.h>
+#include <limits.h>
 #include <stdio.h>
 
 void vp8cx_init_de_quantizer(VP8D_COMP *pbi)
@@ -487,6 +488,48 @@ static void yv12_extend_frame_left_right_c(YV12_BUFFER_CONFIG *ybf,
     }
 }
 
+#if CONFIG_MULTITHREAD
+static void wait_for_ref_rows(VP8D_COMP *pbi, const MODE_INFO *mi, int mb_row,
+                              int *rows_ready)
+{
+    const int ref = mi->mbmi.ref_frame;
+    volatile const int *rows_done = pbi->ref_rows_done[ref];
+    int max_mv_row = mi->mbmi.mv.as_mv.row;
+    int need;
+
+    if (mi->mbmi.mode == SPLITMV)
+    {
+        int i;
+        for (i = 0; i < 16; i++)
+            max_mv_row = MAX(max_mv_row, mi->bmi[i].mv.as_mv.row);
+    }
+
+    need = mb_row * 16 + (max_mv_row >> 3) + 24;
+    if (need > pbi->common.mb_rows * 16)
+        need = INT_MAX;
+
+    if (need > rows_ready[ref])
+    {
+        while (*rows_done < need)
+        {
+            x86_pause_hint();
+            thread_sleep(0);
+        }
+        rows_ready[ref] = *rows_done;
+    }
+}
+
+static void set_rows_done(VP8D_COMP *pbi, YV12_BUFFER_CONFIG *ybf, int rows)
+{
+    if (pbi->frame_rows_done)
+    {
+        if (*pbi->frame_rows_done == 0)
+            yv12_extend_frame_top_c(ybf);
+        *pbi->frame_rows_done = rows;
+    }
+}
+#endif
+
 static void decode_mb_rows(VP8D_COMP *pbi)
 {
     VP8_COMMON *const pc = & pbi->common;
@@ -512,6 +555,9 @@ static void decode_mb_rows(VP8D_COMP *pbi)
     unsigned char *eb_dst[3];
     int i;
     int ref_fb_corrupted[MAX_REF_FRAMES];
+#if CONFIG_MULTITHREAD
+    int ref_rows_ready[MAX_REF_FRAMES] = {0};
+#endif
 
     ref_fb_corrupted[INTRA_FRAME] = 0;
 
@@ -611,6 +657,11 @@ static void decode_mb_rows(VP8D_COMP *pbi)
 
             if (xd->mode_info_context->mbmi.ref_frame >= LAST_FRAME) {
               const MV_REFERENCE_FRAME ref = xd->mode_info_context->mbmi.ref_frame;
+#if CONFIG_MULTITHREAD
+              if (pbi->ref_rows_done[ref])
+                  wait_for_ref_rows(pbi, xd->mode_info_context, mb_row,
+                                    ref_rows_ready);
+#endif
               xd->pre.y_buffer = ref_buffer[ref][0] + recon_yoffset;
               xd->pre.u_buffer = ref_buffer[ref][1] + recon_uvoffset;
               xd->pre.v_buffer = ref_buffer[ref][2] + recon_uvoffset;
@@ -676,6 +727,9 @@ static void decode_mb_rows(VP8D_COMP *pbi)
                     eb_dst[0] += recon_y_stride  * 16;
                     eb_dst[1] += recon_uv_stride *  8;
                     eb_dst[2] += recon_uv_stride *  8;
+#if CONFIG_MULTITHREAD
+                    set_rows_done(pbi, yv12_fb_new, (mb_row - 1) * 16);
+#endif
                 }
 
                 lf_dst[0] += recon_y_stride  * 16;
@@ -697,6 +751,9 @@ static void decode_mb_rows(VP8D_COMP *pbi)
                 eb_dst[0] += recon_y_stride  * 16;
                 eb_dst[1] += recon_uv_stride *  8;
                 eb_dst[2] += recon_uv_stride *  8;
+#if CONFIG_MULTITHREAD
+                set_rows_done(pbi, yv12_fb_new, mb_row * 16);
+#endif
             }
         }
     }
@@ -938,7 +995,7 @@ static void init_frame(VP8D_COMP *pbi)
 
 }
 
-int vp8_decode_frame(VP8D_COMP *pbi)
+int vp8_decode_frame_header(VP8D_COMP *pbi)
 {
     vp8_reader *const bc = &pbi->mbc[8];
     VP8_COMMON *const pc = &pbi->common;
@@ -949,11 +1006,11 @@ int vp8_decode_frame(VP8D_COMP *pbi)
 
     int i, j, k, l;
     const int *const mb_feature_data_bits = vp8_mb_feature_data_bits;
-    int corrupt_tokens = 0;
-    int prev_independent_partitions = pbi->independent_partitions;
 
     YV12_BUFFER_CONFIG *yv12_fb_new = pbi->dec_fb_ref[INTRA_FRAME];
 
+    pbi->prev_independent_partitions = pbi->independent_partitions;
+
     
     xd->corrupted = 0;
     yv12_fb_new->corrupted = 0;
@@ -1285,6 +1342,18 @@ int vp8_decode_frame(VP8D_COMP *pbi)
     memset(pc->above_context, 0, sizeof(ENTROPY_CONTEXT_PLANES) * pc->mb_cols);
     pbi->frame_corrupt_residual = 0;
 
+    return 0;
+}
+
+int vp8_decode_frame_rows(VP8D_COMP *pbi)
+{
+    vp8_reader *const bc = &pbi->mbc[8];
+    VP8_COMMON *const pc = &pbi->common;
+    MACROBLOCKD *const xd  = &pbi->mb;
+    int corrupt_tokens = 0;
+
+    YV12_BUFFER_CONFIG *yv12_fb_new = pbi->dec_fb_ref[INTRA_FRAME];
+
 #if CONFIG_MULTITHREAD
     if (pbi->b_multithreaded_rd && pc->multi_token_partition != ONE_PARTITION)
     {
@@ -1322,7 +1391,7 @@ int vp8_decode_frame(VP8D_COMP *pbi)
     if (pc->refresh_entropy_probs == 0)
     {
         memcpy(&pc->fc, &pc->lfc, sizeof(pc->fc));
-        pbi->independent_partitions = prev_independent_partitions;
+        pbi->independent_partitions = pbi->prev_independent_partitions;
     }
 
 #ifdef PACKET_TESTING
@@ -1337,3 +1406,11 @@ int vp8_decode_frame(VP8D_COMP *pbi)
 
     return 0;
 }
+
+int vp8_decode_frame(VP8D_COMP *pbi)
+{
+    if (vp8_decode_frame_header(pbi))
+        return -1;
+
+    return vp8_decode_frame_rows(pbi);
+}
@@ -189,7 +189,8 @@ static void ref_cnt_fb (int *buf, int *idx, int new_idx)
     buf[new_idx]++;
 }
 
-static int swap_frame_buffers (VP8_COMMON *cm)
+static int swap_frame_buffers (VP8_COMMON *cm, YV12_BUFFER_CONFIG *yv12_fb,
+                               int *fb_idx_ref_cnt)
 {
     int err = 0;
 
@@ -204,7 +205,7 @@ static int swap_frame_buffers (VP8_COMMON *cm)
         else
             err = -1;
 
-        ref_cnt_fb (cm->fb_idx_ref_cnt, &cm->alt_fb_idx, new_fb);
+        ref_cnt_fb (fb_idx_ref_cnt, &cm->alt_fb_idx, new_fb);
     }
 
     if (cm->copy_buffer_to_gf)
@@ -218,25 +219,25 @@ static int swap_frame_buffers (VP8_COMMON *cm)
         else
             err = -1;
 
-        ref_cnt_fb (cm->fb_idx_ref_cnt, &cm->gld_fb_idx, new_fb);
+        ref_cnt_fb (fb_idx_ref_cnt, &cm->gld_fb_idx, new_fb);
     }
 
     if (cm->refresh_golden_frame)
-        ref_cnt_fb (cm->fb_idx_ref_cnt, &cm->gld_fb_idx, cm->new_fb_idx);
+        ref_cnt_fb (fb_idx_ref_cnt, &cm->gld_fb_idx, cm->new_fb_idx);
 
     if (cm->refresh_alt_ref_frame)
-        ref_cnt_fb (cm->fb_idx_ref_cnt, &cm->alt_fb_idx, cm->new_fb_idx);
+        ref_cnt_fb (fb_idx_ref_cnt, &cm->alt_fb_idx, cm->new_fb_idx);
 
     if (cm->refresh_last_frame)
     {
-        ref_cnt_fb (cm->fb_idx_ref_cnt, &cm->lst_fb_idx, cm->new_fb_idx);
+        ref_cnt_fb (fb_idx_ref_cnt, &cm->lst_fb_idx, cm->new_fb_idx);
 
-        cm->frame_to_show = &cm->yv12_fb[cm->lst_fb_idx];
+        cm->frame_to_show = &yv12_fb[cm->lst_fb_idx];
     }
     else
-        cm->frame_to_show = &cm->yv12_fb[cm->new_fb_idx];
+        cm->frame_to_show = &yv12_fb[cm->new_fb_idx];
 
-    cm->fb_idx_ref_cnt[cm->new_fb_idx]--;
+    fb_idx_ref_cnt[cm->new_fb_idx]--;
 
     return err;
 }
@@ -313,7 +314,7 @@ int vp8dx_receive_compressed_data(VP8D_COMP *pbi, size_t size,
         goto decode_exit;
     }
 
-    if (swap_frame_buffers (cm))
+    if (swap_frame_buffers (cm, cm->yv12_fb, cm->fb_idx_ref_cnt))
     {
         pbi->common.error.error_code = VPX_CODEC_ERROR;
         goto decode_exit;
@@ -396,6 +397,299 @@ int vp8dx_get_raw_frame(VP8D_COMP *pbi, YV12_BUFFER_CONFIG *sd, int64_t *time_st
 }
 
 
+#if CONFIG_MULTITHREAD
+static int get_free_pool_fb(struct frame_buffers *fb, VP8_COMMON *cm,
+                            int width, int height)
+{
+    int i;
+    for (i = 0; i < fb->num_fb; i++)
+        if (fb->fb_idx_ref_cnt[i] == 0)
+            break;
+
+    assert(i < fb->num_fb);
+
+    if (fb->yv12_fb[i].y_width != width || fb->yv12_fb[i].y_height != height)
+    {
+        if (vp8_yv12_alloc_frame_buffer(&fb->yv12_fb[i], width, height,
+                                        VP8BORDERINPIXELS) < 0)
+            vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
+                               "Failed to allocate frame buffer");
+    }
+
+    fb->fb_idx_ref_cnt[i] = 1;
+    fb->fb_rows_done[i] = 0;
+    return i;
+}
+
+static void release_pool_fb(struct frame_buffers *fb, int *idx)
+{
+    if (*idx >= 0 && fb->fb_idx_ref_cnt[*idx] > 0)
+        fb->fb_idx_ref_cnt[*idx]--;
+
+    *idx = -1;
+}
+
+static void sync_frame(struct frame_buffers *fb, VP8D_COMP *pbi)
+{
+    int i;
+
+    if (!pbi->frame_pending)
+        return;
+
+    sem_wait(&pbi->h_event_end_frame);
+    pbi->frame_pending = 0;
+
+    if (pbi->common.error.error_code != VPX_CODEC_OK &&
+        fb->frame_error.error_code == VPX_CODEC_OK)
+    {
+        fb->frame_error.error_code = pbi->common.error.error_code;
+        fb->frame_error.has_detail = pbi->common.error.has_detail;
+        memcpy(fb->frame_error.detail, pbi->common.error.detail,
+               sizeof(fb->frame_error.detail));
+    }
+
+    for (i = LAST_FRAME; i < MAX_REF_FRAMES; i++)
+        release_pool_fb(fb, &pbi->hold_fb_idx[i]);
+}
+
+void vp8dx_sync_frames(struct frame_buffers *fb)
+{
+    int i;
+
+    for (i = 0; i < fb->num_frame_threads; i++)
+        if (fb->pbi[i])
+            sync_frame(fb, fb->pbi[i]);
+}
+
+static VP8D_COMP *pop_oldest_frame(struct frame_buffers *fb)
+{
+    VP8D_COMP *pbi = fb->pbi[fb->next_output];
+
+    sync_frame(fb, pbi);
+
+    fb->next_output = (fb->next_output + 1) % fb->num_frame_threads;
+    fb->frames_in_flight--;
+    return pbi;
+}
+
+static void copy_frame_context(VP8D_COMP *dst, const VP8D_COMP *src)
+{
+    VP8_COMMON *const dc = &dst->common;
+    const VP8_COMMON *const sc = &src->common;
+    MACROBLOCKD *const dxd = &dst->mb;
+    const MACROBLOCKD *const sxd = &src->mb;
+    const int q_update = dc->y1dc_delta_q != sc->y1dc_delta_q ||
+                         dc->y2dc_delta_q != sc->y2dc_delta_q ||
+                         dc->y2ac_delta_q != sc->y2ac_delta_q ||
+                         dc->uvdc_delta_q != sc->uvdc_delta_q ||
+                         dc->uvac_delta_q != sc->uvac_delta_q;
+
+    if (sc->refresh_entropy_probs)
+        memcpy(&dc->fc, &sc->fc, sizeof(dc->fc));
+    else
+        memcpy(&dc->fc, &sc->lfc, sizeof(dc->fc));
+
+    dc->Width = sc->Width;
+    dc->Height = sc->Height;
+    dc->horiz_scale = sc->horiz_scale;
+    dc->vert_scale = sc->vert_scale;
+    dc->clamp_type = sc->clamp_type;
+    dc->current_video_frame = sc->current_video_frame;
+    memcpy(dc->ref_frame_sign_bias, sc->ref_frame_sign_bias,
+           sizeof(dc->ref_frame_sign_bias));
+
+    dc->y1dc_delta_q = sc->y1dc_delta_q;
+    dc->y2dc_delta_q = sc->y2dc_delta_q;
+    dc->y2ac_delta_q = sc->y2ac_delta_q;
+    dc->uvdc_delta_q = sc->uvdc_delta_q;
+    dc->uvac_delta_q = sc->uvac_delta_q;
+
+    if (q_update)
+        vp8cx_init_de_quantizer(dst);
+
+    dxd->mb_segement_abs_delta = sxd->mb_segement_abs_delta;
+    memcpy(dxd->segment_feature_data, sxd->segment_feature_data,
+           sizeof(dxd->segment_feature_data));
+    memcpy(dxd->mb_segment_tree_probs, sxd->mb_segment_tree_probs,
+           sizeof(dxd->mb_segment_tree_probs));
+    memcpy(dxd->ref_lf_deltas, sxd->ref_lf_deltas, sizeof(dxd->ref_lf_deltas));
+    memcpy(dxd->mode_lf_deltas, sxd->mode_lf_deltas,
+           sizeof(dxd->mode_lf_deltas));
+
+    if (dc->mb_rows == sc->mb_rows && dc->mb_cols == sc->mb_cols)
+    {
+        int i;
+        for (i = 0; i < dc->mode_info_stride * dc->mb_rows; i++)
+            dc->mi[i].mbmi.segment_id = sc->mi[i].mbmi.segment_id;
+    }
+}
+
+int vp8dx_submit_frame(struct frame_buffers *fb, size_t size,
+                       const uint8_t *source, int64_t time_stamp,
+                       int width, int height, void *user_priv)
+{
+    VP8D_COMP *pbi;
+    VP8_COMMON *cm;
+    int retcode;
+    int i;
+    int aligned_width, aligned_height;
+
+    if (fb->frames_in_flight == fb->num_frame_threads)
+    {
+        pbi = pop_oldest_frame(fb);
+        release_pool_fb(fb, &pbi->hold_fb_idx[INTRA_FRAME]);
+    }
+
+    pbi = fb->pbi[fb->next_submit];
+    cm = &pbi->common;
+    cm->error.error_code = VPX_CODEC_OK;
+
+    if (setjmp(cm->error.jmp))
+    {
+        cm->error.setjmp = 0;
+        for (i = 0; i < MAX_REF_FRAMES; i++)
+            release_pool_fb(fb, &pbi->hold_fb_idx[i]);
+        vp8_clear_system_state();
+        return -1;
+    }
+
+    cm->error.setjmp = 1;
+
+    /* Round after the setjmp, so that no argument is modified while the
+     * jump buffer is live. */
+    aligned_width = (width + 15) & ~15;
+    aligned_height = (height + 15) & ~15;
+
+    if (!cm->mip || cm->mb_cols != aligned_width >> 4 ||
+        cm->mb_rows != aligned_height >> 4)
+    {
+        if (vp8_alloc_context_buffers(cm, aligned_width, aligned_height))
+            vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
+                               "Failed to allocate frame buffers");
+
+        cm->new_fb_idx = get_free_pool_fb(fb, cm, aligned_width,
+                                          aligned_height);
+        pbi->hold_fb_idx[INTRA_FRAME] = cm->new_fb_idx;
+        pbi->mb.pre = fb->yv12_fb[cm->new_fb_idx];
+        pbi->mb.dst = fb->yv12_fb[cm->new_fb_idx];
+        vp8_build_block_doffsets(&pbi->mb);
+    }
+    else
+    {
+        cm->new_fb_idx = get_free_pool_fb(fb, cm, aligned_width,
+                                          aligned_height);
+        pbi->hold_fb_idx[INTRA_FRAME] = cm->new_fb_idx;
+    }
+
+    if (fb->last_submit && fb->last_submit != pbi)
+        copy_frame_context(pbi, fb->last_submit);
+    pbi->decoded_key_frame = fb->decoded_key_frame;
+    pbi->user_priv = user_priv;
+
+    if (pbi->frame_data_sz < size)
+    {
+        vpx_free(pbi->frame_data);
+        pbi->frame_data_sz = 0;
+        CHECK_MEM_ERROR(pbi->frame_data, vpx_malloc(size));
+        pbi->frame_data_sz = size;
+    }
+    memcpy(pbi->frame_data, source, size);
+
+    pbi->fragments.enabled = 0;
+    pbi->fragments.count = 1;
+    pbi->fragments.ptrs[0] = pbi->frame_data;
+    pbi->fragments.sizes[0] = (unsigned int)size;
+
+    cm->lst_fb_idx = fb->lst_fb_idx;
+    cm->gld_fb_idx = fb->gld_fb_idx;
+    cm->alt_fb_idx = fb->alt_fb_idx;
+    pbi->hold_fb_idx[LAST_FRAME] = cm->lst_fb_idx;
+    pbi->hold_fb_idx[GOLDEN_FRAME] = cm->gld_fb_idx;
+    pbi->hold_fb_idx[ALTREF_FRAME] = cm->alt_fb_idx;
+
+    pbi->frame_rows_done = &fb->fb_rows_done[cm->new_fb_idx];
+    pbi->ref_rows_done[INTRA_FRAME] = NULL;
+    for (i = 0; i < MAX_REF_FRAMES; i++)
+    {
+        pbi->dec_fb_ref[i] = &fb->yv12_fb[pbi->hold_fb_idx[i]];
+        if (i != INTRA_FRAME)
+        {
+            fb->fb_idx_ref_cnt[pbi->hold_fb_idx[i]]++;
+            pbi->ref_rows_done[i] = &fb->fb_rows_done[pbi->hold_fb_idx[i]];
+        }
+    }
+
+    retcode = vp8_decode_frame_header(pbi);
+
+    if (retcode < 0 ||
+        swap_frame_buffers(cm, fb->yv12_fb, fb->fb_idx_ref_cnt))
+    {
+        cm->error.setjmp = 0;
+        cm->error.error_code = VPX_CODEC_ERROR;
+        for (i = 0; i < MAX_REF_FRAMES; i++)
+            release_pool_fb(fb, &pbi->hold_fb_idx[i]);
+        vp8_clear_system_state();
+        return -1;
+    }
+
+    fb->fb_idx_ref_cnt[cm->new_fb_idx]++;
+    fb->lst_fb_idx = cm->lst_fb_idx;
+    fb->gld_fb_idx = cm->gld_fb_idx;
+    fb->alt_fb_idx = cm->alt_fb_idx;
+
+    if (cm->frame_type == KEY_FRAME)
+        fb->decoded_key_frame = 1;
+
+    vp8_clear_system_state();
+
+    if (cm->show_frame)
+    {
+        cm->current_video_frame++;
+        cm->show_frame_mi = cm->mi;
+    }
+
+    pbi->ready_for_new_data = 0;
+    pbi->last_time_stamp = time_stamp;
+    cm->error.setjmp = 0;
+
+    pbi->frame_pending = 1;
+    sem_post(&pbi->h_event_start_frame);
+
+    fb->last_submit = pbi;
+    fb->next_submit = (fb->next_submit + 1) % fb->num_frame_threads;
+    fb->frames_in_flight++;
+
+    return 0;
+}
+
+int vp8dx_get_next_frame(struct frame_buffers *fb, YV12_BUFFER_CONFIG *sd,
+                         int64_t *time_stamp, vp8_ppflags_t *flags,
+                         void **user_priv)
+{
+    while (fb->frames_in_flight > 0 &&
+           (fb->flushing || fb->frames_in_flight == fb->num_frame_threads))
+    {
+        VP8D_COMP *pbi = pop_oldest_frame(fb);
+        int64_t time_end_stamp;
+
+        if (pbi->common.error.error_code == VPX_CODEC_OK &&
+            !vp8dx_get_raw_frame(pbi, sd, time_stamp, &time_end_stamp, flags))
+        {
+            release_pool_fb(fb, &fb->last_output_idx);
+            fb->last_output_idx = pbi->hold_fb_idx[INTRA_FRAME];
+            pbi->hold_fb_idx[INTRA_FRAME] = -1;
+            *user_priv = pbi->user_priv;
+            return 0;
+        }
+
+        release_pool_fb(fb, &pbi->hold_fb_idx[INTRA_FRAME]);
+    }
+
+    return -1;
+}
+#endif
+
+
 /* This function as written isn't decoder specific, but the encoder has
  * much faster ways of computing this, so it's ok for it to live in a
  * decode specific file.
@@ -434,6 +728,53 @@ int vp8_create_decoder_instances(struct frame_buffers *fb, VP8D_CONFIG *oxcf)
     }
     else
     {
+#if CONFIG_MULTITHREAD
+        int i, j;
+
+        fb->num_frame_threads = oxcf->max_threads;
+        if (fb->num_frame_threads < 1)
+            fb->num_frame_threads = 1;
+        if (fb->num_frame_threads > MAX_FB_MT_DEC)
+            fb->num_frame_threads = MAX_FB_MT_DEC;
+
+        fb->num_fb = fb->num_frame_threads + NUM_YV12_BUFFERS;
+        fb->next_submit = 0;
+        fb->next_output = 0;
+        fb->frames_in_flight = 0;
+        fb->flushing = 0;
+        fb->decoded_key_frame = 0;
+        fb->last_submit = NULL;
+        fb->last_output_idx = -1;
+        fb->frame_error.error_code = VPX_CODEC_OK;
+
+        memset(fb->yv12_fb, 0, sizeof(fb->yv12_fb));
+        memset(fb->fb_idx_ref_cnt, 0, sizeof(fb->fb_idx_ref_cnt));
+        fb->lst_fb_idx = 0;
+        fb->gld_fb_idx = 0;
+        fb->alt_fb_idx = 0;
+        fb->fb_idx_ref_cnt[0] = 3;
+
+        for (i = 0; i < fb->num_frame_threads; i++)
+        {
+            VP8D_COMP *pbi = create_decompressor(oxcf);
+
+            fb->pbi[i] = pbi;
+            if (!pbi)
+                break;
+
+            for (j = 0; j < MAX_REF_FRAMES; j++)
+                pbi->hold_fb_idx[j] = -1;
+
+            if (vp8_decoder_create_frame_thread(pbi))
+                break;
+        }
+
+        if (i < fb->num_frame_threads)
+        {
+            vp8_remove_decoder_instances(fb);
+            return VPX_CODEC_ERROR;
+        }
+#endif
     }
 
     return VPX_CODEC_OK;
@@ -456,6 +797,26 @@ int vp8_remove_decoder_instances(struct frame_buffers *fb)
     }
     else
     {
+#if CONFIG_MULTITHREAD
+        int i;
+
+        for (i = 0; i < fb->num_frame_threads; i++)
+        {
+            VP8D_COMP *pbi = fb->pbi[i];
+
+            if (!pbi)
+                continue;
+
+            sync_frame(fb, pbi);
+            vp8_decoder_remove_frame_thread(pbi);
+            vpx_free(pbi->frame_data);
+            remove_decompressor(pbi);
+            fb->pbi[i] = NULL;
+        }
+
+        for (i = 0; i < MAX_FB_POOL; i++)
+            vp8_yv12_de_alloc_frame_buffer(&fb->yv12_fb[i]);
+#endif
     }
 
     return VPX_CODEC_OK;
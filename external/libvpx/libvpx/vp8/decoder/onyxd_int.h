@@ -48,6 +48,7 @@ typedef struct
 } FRAGMENT_DATA;
 
 #define MAX_FB_MT_DEC 32
+#define MAX_FB_POOL (MAX_FB_MT_DEC + NUM_YV12_BUFFERS)
 
 struct frame_buffers
 {
@@ -58,6 +59,23 @@ struct frame_buffers
     
     struct VP8D_COMP *pbi[MAX_FB_MT_DEC];
 
+    int     num_frame_threads;
+    int     next_submit;
+    int     next_output;
+    int     frames_in_flight;
+    int     flushing;
+    int     decoded_key_frame;
+    struct VP8D_COMP *last_submit;
+
+    YV12_BUFFER_CONFIG yv12_fb[MAX_FB_POOL];
+    int     fb_idx_ref_cnt[MAX_FB_POOL];
+    volatile int fb_rows_done[MAX_FB_POOL];
+    int     num_fb;
+    int     lst_fb_idx, gld_fb_idx, alt_fb_idx;
+    int     last_output_idx;
+
+    /* first error raised by a frame thread, reported by the next decode */
+    struct vpx_internal_error_info frame_error;
 };
 
 typedef struct VP8D_COMP
@@ -101,6 +119,17 @@ typedef struct VP8D_COMP
     pthread_t           *h_decoding_thread;
     sem_t               *h_event_start_decoding;
     sem_t                h_event_end_decoding;
+
+    pthread_t            h_frame_thread;
+    sem_t                h_event_start_frame;
+    sem_t                h_event_end_frame;
+    volatile int         b_frame_thread_running;
+    int                  frame_pending;
+    int                  hold_fb_idx[MAX_REF_FRAMES];
+    volatile int        *frame_rows_done;
+    volatile int        *ref_rows_done[MAX_REF_FRAMES];
+    unsigned char       *frame_data;
+    size_t               frame_data_sz;
     
 #endif
 
@@ -121,17 +150,31 @@ typedef struct VP8D_COMP
     int ec_active;
     int decoded_key_frame;
     int independent_partitions;
+    int prev_independent_partitions;
     int frame_corrupt_residual;
 
     vpx_decrypt_cb decrypt_cb;
     void *decrypt_state;
+    void *user_priv;
 } VP8D_COMP;
 
 int vp8_decode_frame(VP8D_COMP *cpi);
+int vp8_decode_frame_header(VP8D_COMP *pbi);
+int vp8_decode_frame_rows(VP8D_COMP *pbi);
 
 int vp8_create_decoder_instances(struct frame_buffers *fb, VP8D_CONFIG *oxcf);
 int vp8_remove_decoder_instances(struct frame_buffers *fb);
 
+#if CONFIG_MULTITHREAD
+int vp8dx_submit_frame(struct frame_buffers *fb, size_t size,
+                       const uint8_t *source, int64_t time_stamp,
+                       int width, int height, void *user_priv);
+int vp8dx_get_next_frame(struct frame_buffers *fb, YV12_BUFFER_CONFIG *sd,
+                         int64_t *time_stamp, vp8_ppflags_t *flags,
+                         void **user_priv);
+void vp8dx_sync_frames(struct frame_buffers *fb);
+#endif
+
 #if CONFIG_DEBUG
 #define CHECK_MEM_ERROR(lval,expr) do {\
         lval = (expr); \
@@ -25,10 +25,13 @@
 #include "vp8/common/reconintra4x4.h"
 #include "vp8/common/reconinter.h"
 #include "vp8/common/setupintrarecon.h"
+#include "vp8/common/systemdependent.h"
 #if CONFIG_ERROR_CONCEALMENT
 #include "error_concealment.h"
 #endif
 
+#include <limits.h>
+
 #define CALLOC_ARRAY(p, n) CHECK_MEM_ERROR((p), vpx_calloc(sizeof(*(p)), (n)))
 #define CALLOC_ARRAY_ALIGNED(p, n, algn) do {                      \
   CHECK_MEM_ERROR((p), vpx_memalign((algn), sizeof(*(p)) * (n)));  \
@@ -620,6 +623,70 @@ static THREAD_FUNCTION thread_decoding_proc(void *p_data)
 }
 
 
+static THREAD_FUNCTION thread_frame_proc(void *p_data)
+{
+    VP8D_COMP *pbi = (VP8D_COMP *)p_data;
+
+    while (1)
+    {
+        if (sem_wait(&pbi->h_event_start_frame) == 0)
+        {
+            if (pbi->b_frame_thread_running == 0)
+                break;
+
+            if (setjmp(pbi->common.error.jmp))
+            {
+                pbi->common.error.error_code = VPX_CODEC_ERROR;
+                pbi->dec_fb_ref[INTRA_FRAME]->corrupted = 1;
+            }
+            else
+            {
+                pbi->common.error.setjmp = 1;
+                vp8_decode_frame_rows(pbi);
+            }
+
+            pbi->common.error.setjmp = 0;
+            vp8_clear_system_state();
+
+            *pbi->frame_rows_done = INT_MAX;
+            sem_post(&pbi->h_event_end_frame);
+        }
+    }
+
+    return 0;
+}
+
+int vp8_decoder_create_frame_thread(VP8D_COMP *pbi)
+{
+    sem_init(&pbi->h_event_start_frame, 0, 0);
+    sem_init(&pbi->h_event_end_frame, 0, 0);
+
+    pbi->b_frame_thread_running = 1;
+    if (pthread_create(&pbi->h_frame_thread, 0, thread_frame_proc, pbi))
+    {
+        pbi->b_frame_thread_running = 0;
+        sem_destroy(&pbi->h_event_start_frame);
+        sem_destroy(&pbi->h_event_end_frame);
+        return -1;
+    }
+
+    return 0;
+}
+
+void vp8_decoder_remove_frame_thread(VP8D_COMP *pbi)
+{
+    if (pbi->b_frame_thread_running)
+    {
+        pbi->b_frame_thread_running = 0;
+
+        sem_post(&pbi->h_event_start_frame);
+        pthread_join(pbi->h_frame_thread, NULL);
+
+        sem_destroy(&pbi->h_event_start_frame);
+        sem_destroy(&pbi->h_event_end_frame);
+    }
+}
+
 void vp8_decoder_create_threads(VP8D_COMP *pbi)
 {
     int core_count = 0;
@@ -123,8 +123,9 @@ static vpx_codec_err_t vp8_init(vpx_codec_ctx_t *ctx,
     priv->yv12_frame_buffers.use_frame_threads =
         (ctx->priv->init_flags & VPX_CODEC_USE_FRAME_THREADING);
 
-    
+#if !CONFIG_MULTITHREAD
     priv->yv12_frame_buffers.use_frame_threads = 0;
+#endif
 
     if (priv->yv12_frame_buffers.use_frame_threads &&
         ((ctx->priv->init_flags & VPX_CODEC_USE_ERROR_CONCEALMENT) ||
@@ -230,6 +231,18 @@ update_error_state(vpx_codec_alg_priv_t                 *ctx,
     return res;
 }
 
+#if CONFIG_MULTITHREAD
+static vpx_codec_err_t
+take_frame_thread_error(vpx_codec_alg_priv_t *ctx)
+{
+    struct frame_buffers *const fb = &ctx->yv12_frame_buffers;
+    vpx_codec_err_t res = update_error_state(ctx, &fb->frame_error);
+
+    fb->frame_error.error_code = VPX_CODEC_OK;
+    return res;
+}
+#endif
+
 static void yuvconfig2image(vpx_image_t               *img,
                             const YV12_BUFFER_CONFIG  *yv12,
                             void                      *user_priv)
@@ -310,6 +323,18 @@ static vpx_codec_err_t vp8_decode(vpx_codec_alg_priv_t  *ctx,
     unsigned int resolution_change = 0;
     unsigned int w, h;
 
+    ctx->yv12_frame_buffers.flushing = (data == NULL && data_sz == 0);
+
+#if CONFIG_MULTITHREAD
+    if (ctx->yv12_frame_buffers.use_frame_threads &&
+        ctx->yv12_frame_buffers.flushing)
+    {
+        vp8dx_sync_frames(&ctx->yv12_frame_buffers);
+        if ((res = take_frame_thread_error(ctx)))
+            return res;
+    }
+#endif
+
     if (!ctx->fragments.enabled && (data == NULL && data_sz == 0))
     {
         return 0;
@@ -362,10 +387,43 @@ static vpx_codec_err_t vp8_decode(vpx_codec_alg_priv_t  *ctx,
     }
 
     if (ctx->decoder_init) {
-      ctx->yv12_frame_buffers.pbi[0]->decrypt_cb = ctx->decrypt_cb;
-      ctx->yv12_frame_buffers.pbi[0]->decrypt_state = ctx->decrypt_state;
+      int i;
+      const int num_pbi = ctx->yv12_frame_buffers.use_frame_threads ?
+          ctx->yv12_frame_buffers.num_frame_threads : 1;
+
+      for (i = 0; i < num_pbi && ctx->yv12_frame_buffers.pbi[i]; i++) {
+        ctx->yv12_frame_buffers.pbi[i]->decrypt_cb = ctx->decrypt_cb;
+        ctx->yv12_frame_buffers.pbi[i]->decrypt_state = ctx->decrypt_state;
+      }
     }
 
+#if CONFIG_MULTITHREAD
+    if (!res && ctx->yv12_frame_buffers.use_frame_threads)
+    {
+        struct frame_buffers *const fb = &ctx->yv12_frame_buffers;
+
+        if (ctx->si.w <= 0 || ctx->si.h <= 0)
+        {
+            ctx->si.w = 0;
+            ctx->si.h = 0;
+            res = VPX_CODEC_CORRUPT_FRAME;
+        }
+        else if (vp8dx_submit_frame(fb, data_sz, data, deadline,
+                                    ctx->si.w, ctx->si.h, user_priv))
+        {
+            res = update_error_state(ctx,
+                                     &fb->pbi[fb->next_submit]->common.error);
+        }
+        else
+        {
+            res = take_frame_thread_error(ctx);
+        }
+
+        ctx->fragments.count = 0;
+        return res;
+    }
+#endif
+
     if (!res)
     {
         VP8D_COMP *pbi = ctx->yv12_frame_buffers.pbi[0];
@@ -485,6 +543,36 @@ static vpx_image_t *vp8_get_frame(vpx_codec_alg_priv_t  *ctx,
 {
     vpx_image_t *img = NULL;
 
+#if CONFIG_MULTITHREAD
+    if (ctx->yv12_frame_buffers.use_frame_threads)
+    {
+        YV12_BUFFER_CONFIG sd;
+        int64_t time_stamp = 0;
+        vp8_ppflags_t flags = {0};
+        void *user_priv = NULL;
+
+        if (!ctx->yv12_frame_buffers.pbi[0])
+            return NULL;
+
+        if (ctx->base.init_flags & VPX_CODEC_USE_POSTPROC)
+        {
+            flags.post_proc_flag =
+                ctx->postproc_cfg.post_proc_flag & ~VP8_MFQE;
+            flags.deblocking_level = ctx->postproc_cfg.deblocking_level;
+            flags.noise_level = ctx->postproc_cfg.noise_level;
+        }
+
+        if (0 == vp8dx_get_next_frame(&ctx->yv12_frame_buffers, &sd,
+                                      &time_stamp, &flags, &user_priv))
+        {
+            yuvconfig2image(&ctx->img, &sd, user_priv);
+            img = &ctx->img;
+        }
+
+        return img;
+    }
+#endif
+
     if (!(*iter) && ctx->yv12_frame_buffers.pbi[0])
     {
         YV12_BUFFER_CONFIG sd;
@@ -714,7 +802,7 @@ static vpx_codec_err_t vp8_get_frame_corrupted(vpx_codec_alg_priv_t *ctx,
     int *corrupted = va_arg(args, int *);
     VP8D_COMP *pbi = (VP8D_COMP *)ctx->yv12_frame_buffers.pbi[0];
 
-    if (corrupted && pbi)
+    if (corrupted && pbi && !ctx->yv12_frame_buffers.use_frame_threads)
     {
         const YV12_BUFFER_CONFIG *const frame = pbi->common.frame_to_show;
         if (frame == NULL) return VPX_CODEC_ERROR;
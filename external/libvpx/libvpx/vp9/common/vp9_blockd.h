@@ -190,6 +190,8 @@ typedef struct macroblockd {
   int lossless;
   int corrupted;
 
+  uint64_t *stage_ticks;
+
   struct vpx_internal_error_info *error_info;
 } MACROBLOCKD;
 
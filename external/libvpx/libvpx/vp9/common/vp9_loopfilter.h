@@ -122,6 +122,8 @@ typedef struct LoopFilterWorkerData {
   int start;
   int stop;
   int y_only;
+
+  uint64_t *stage_ticks;
 } LFWorkerData;
 
 void vp9_loop_filter_data_reset(
@@ -709,8 +709,10 @@ int vp9_post_proc_frame(struct VP9Common *cm,
                                q + (ppflags->deblocking_level - 5) * 10, 1, 0);
   } else if (flags & VP9D_DEBLOCK) {
     vp9_deblock(cm->frame_to_show, ppbuf, q);
-  } else {
+  } else if (flags & VP9D_MFQE) {
     vp8_yv12_copy_frame(cm->frame_to_show, ppbuf);
+  } else {
+    vpx_yv12_copy_frame(cm->frame_to_show, ppbuf);
   }
 
   cm->postproc_state.last_base_qindex = cm->base_qindex;
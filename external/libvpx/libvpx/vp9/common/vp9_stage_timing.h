@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2016 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VP9_COMMON_VP9_STAGE_TIMING_H_
+#define VP9_COMMON_VP9_STAGE_TIMING_H_
+
+#include "./vpx_config.h"
+#include "vpx/vp8.h"
+#include "vpx/vpx_integer.h"
+#include "vpx_ports/mem.h"
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static INLINE uint64_t vp9_stage_timer_now(void) {
+#if defined(_WIN32)
+  LARGE_INTEGER t, freq;
+  QueryPerformanceCounter(&t);
+  QueryPerformanceFrequency(&freq);
+  return (uint64_t)(t.QuadPart / freq.QuadPart) * 1000000000 +
+         (uint64_t)(t.QuadPart % freq.QuadPart) * 1000000000 / freq.QuadPart;
+#elif CONFIG_OS_SUPPORT && defined(CLOCK_MONOTONIC)
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#else
+  return 0;
+#endif
+}
+
+static INLINE uint64_t vp9_stage_timer_start(const uint64_t *stage_ticks) {
+  return stage_ticks ? vp9_stage_timer_now() : 0;
+}
+
+static INLINE uint64_t vp9_stage_timer_end(uint64_t *stage_ticks,
+                                           vpx_codec_stage_t stage,
+                                           uint64_t start) {
+  if (stage_ticks) {
+    const uint64_t now = vp9_stage_timer_now();
+    stage_ticks[stage] += now - start;
+    return now;
+  }
+  return 0;
+}
+
+static INLINE void vp9_stage_ticks_add(uint64_t *dst, uint64_t *src) {
+  int i;
+  for (i = 0; i < VPX_STAGE_COUNT; ++i) {
+    dst[i] += src[i];
+    src[i] = 0;
+  }
+}
+
+#ifdef __cplusplus
+}  
+#endif
+
+#endif  
@@ -370,6 +370,7 @@ static void predict_and_reconstruct_intra_block(MACROBLOCKD *const xd,
                                                 TX_SIZE tx_size) {
   struct macroblockd_plane *const pd = &xd->plane[plane];
   PREDICTION_MODE mode = (plane == 0) ? mbmi->mode : mbmi->uv_mode;
+  uint64_t t = vp9_stage_timer_start(xd->stage_ticks);
   uint8_t *dst;
   dst = &pd->dst.buf[4 * row * pd->dst.stride + 4 * col];
 
@@ -380,6 +381,7 @@ static void predict_and_reconstruct_intra_block(MACROBLOCKD *const xd,
   vp9_predict_intra_block(xd, pd->n4_wl, tx_size, mode,
                           dst, pd->dst.stride, dst, pd->dst.stride,
                           col, row, plane);
+  t = vp9_stage_timer_end(xd->stage_ticks, VPX_STAGE_PREDICTION, t);
 
   if (!mbmi->skip) {
     const TX_TYPE tx_type = (plane || xd->lossless) ?
@@ -388,8 +390,10 @@ static void predict_and_reconstruct_intra_block(MACROBLOCKD *const xd,
         &vp9_default_scan_orders[tx_size] : &vp9_scan_orders[tx_size][tx_type];
     const int eob = vp9_decode_block_tokens(xd, plane, sc, col, row, tx_size,
                                             r, mbmi->segment_id);
+    t = vp9_stage_timer_end(xd->stage_ticks, VPX_STAGE_ENTROPY, t);
     inverse_transform_block_intra(xd, plane, tx_type, tx_size,
                                   dst, pd->dst.stride, eob);
+    vp9_stage_timer_end(xd->stage_ticks, VPX_STAGE_TRANSFORM, t);
   }
 }
 
@@ -398,12 +402,15 @@ static int reconstruct_inter_block(MACROBLOCKD *const xd, vpx_reader *r,
                                    int row, int col, TX_SIZE tx_size) {
   struct macroblockd_plane *const pd = &xd->plane[plane];
   const scan_order *sc = &vp9_default_scan_orders[tx_size];
+  uint64_t t = vp9_stage_timer_start(xd->stage_ticks);
   const int eob = vp9_decode_block_tokens(xd, plane, sc, col, row, tx_size, r,
                                           mbmi->segment_id);
+  t = vp9_stage_timer_end(xd->stage_ticks, VPX_STAGE_ENTROPY, t);
 
   inverse_transform_block_inter(xd, plane, tx_size,
                             &pd->dst.buf[4 * row * pd->dst.stride + 4 * col],
                             pd->dst.stride, eob);
+  vp9_stage_timer_end(xd->stage_ticks, VPX_STAGE_TRANSFORM, t);
   return eob;
 }
 
@@ -821,6 +828,7 @@ static void decode_block(VP9Decoder *const pbi, MACROBLOCKD *const xd,
   const int bh = 1 << (bhl - 1);
   const int x_mis = MIN(bw, cm->mi_cols - mi_col);
   const int y_mis = MIN(bh, cm->mi_rows - mi_row);
+  uint64_t t;
 
   MB_MODE_INFO *mbmi = set_offsets(cm, xd, bsize, mi_row, mi_col,
                                    bw, bh, x_mis, y_mis, bwl, bhl);
@@ -833,7 +841,9 @@ static void decode_block(VP9Decoder *const pbi, MACROBLOCKD *const xd,
                          VPX_CODEC_CORRUPT_FRAME, "Invalid block size.");
   }
 
+  t = vp9_stage_timer_start(xd->stage_ticks);
   vpx_read_mode_info(pbi, xd, mi_row, mi_col, r, x_mis, y_mis);
+  vp9_stage_timer_end(xd->stage_ticks, VPX_STAGE_ENTROPY, t);
 
   if (mbmi->skip) {
     dec_reset_skip_context(xd);
@@ -862,7 +872,9 @@ static void decode_block(VP9Decoder *const pbi, MACROBLOCKD *const xd,
     }
   } else {
     
+    t = vp9_stage_timer_start(xd->stage_ticks);
     dec_build_inter_predictors_sb(pbi, xd, mi_row, mi_col);
+    vp9_stage_timer_end(xd->stage_ticks, VPX_STAGE_PREDICTION, t);
 
     
     if (!mbmi->skip) {
@@ -1455,6 +1467,7 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi,
     winterface->sync(&pbi->lf_worker);
     vp9_loop_filter_data_reset(lf_data, get_frame_new_buffer(cm), cm,
                                pbi->mb.plane);
+    lf_data->stage_ticks = pbi->mb.stage_ticks;
   }
 
   assert(tile_rows <= 4);
@@ -1709,6 +1722,8 @@ static const uint8_t *decode_tiles_mt(VP9Decoder *pbi,
       tile_data->xd.corrupted = 0;
       tile_data->xd.counts = cm->frame_parallel_decoding_mode ?
                              0 : &tile_data->counts;
+      tile_data->xd.stage_ticks = pbi->mb.stage_ticks ?
+                                  tile_data->stage_ticks : NULL;
       vp9_zero(tile_data->dqcoeff);
       vp9_tile_init(tile, cm, 0, buf->col);
       vp9_tile_init(&tile_data->xd.tile, cm, 0, buf->col);
@@ -1756,6 +1771,12 @@ static const uint8_t *decode_tiles_mt(VP9Decoder *pbi,
     }
   }
 
+  if (pbi->mb.stage_ticks) {
+    for (n = 0; n < num_workers; ++n)
+      vp9_stage_ticks_add(pbi->mb.stage_ticks,
+                          pbi->tile_worker_data[n].stage_ticks);
+  }
+
   return bit_reader_end;
 }
 
@@ -2146,14 +2167,19 @@ void vp9_decode_frame(VP9Decoder *pbi,
   struct vpx_read_bit_buffer rb;
   int context_updated = 0;
   uint8_t clear_data[MAX_VP9_HEADER_SIZE];
+  uint64_t *const stage_ticks =
+      pbi->stage_timing_enabled ? pbi->stage_timing.ns : NULL;
+  uint64_t t = vp9_stage_timer_start(stage_ticks);
   const size_t first_partition_size = read_uncompressed_header(pbi,
       init_read_bit_buffer(pbi, &rb, data, data_end, clear_data));
   const int tile_rows = 1 << cm->log2_tile_rows;
   const int tile_cols = 1 << cm->log2_tile_cols;
   YV12_BUFFER_CONFIG *const new_fb = get_frame_new_buffer(cm);
   xd->cur_buf = new_fb;
+  xd->stage_ticks = stage_ticks;
 
   if (!first_partition_size) {
+    vp9_stage_timer_end(stage_ticks, VPX_STAGE_HEADER, t);
     
     *p_data_end = data + (cm->profile <= PROFILE_2 ? 1 : 2);
     return;
@@ -2189,6 +2215,7 @@ void vp9_decode_frame(VP9Decoder *pbi,
   if (cm->lf.filter_level && !cm->skip_loop_filter) {
     vp9_loop_filter_frame_init(cm, cm->lf.filter_level);
   }
+  vp9_stage_timer_end(stage_ticks, VPX_STAGE_HEADER, t);
 
   
   
@@ -2215,9 +2242,11 @@ void vp9_decode_frame(VP9Decoder *pbi,
       if (!cm->skip_loop_filter) {
         
         
+        t = vp9_stage_timer_start(stage_ticks);
         vp9_loop_filter_frame_mt(new_fb, cm, pbi->mb.plane,
                                  cm->lf.filter_level, 0, 0, pbi->tile_workers,
                                  pbi->num_tile_workers, &pbi->lf_row_sync);
+        vp9_stage_timer_end(stage_ticks, VPX_STAGE_LOOP_FILTER, t);
       }
     } else {
       vpx_internal_error(&cm->error, VPX_CODEC_CORRUPT_FRAME,
@@ -2229,12 +2258,14 @@ void vp9_decode_frame(VP9Decoder *pbi,
 
   if (!xd->corrupted) {
     if (!cm->error_resilient_mode && !cm->frame_parallel_decoding_mode) {
+      t = vp9_stage_timer_start(stage_ticks);
       vp9_adapt_coef_probs(cm);
 
       if (!frame_is_intra_only(cm)) {
         vp9_adapt_mode_probs(cm);
         vp9_adapt_mv_probs(cm, cm->allow_high_precision_mv);
       }
+      vp9_stage_timer_end(stage_ticks, VPX_STAGE_ENTROPY, t);
     } else {
       debug_check_frame_counts(cm);
     }
@@ -281,6 +281,8 @@ int vp9_receive_compressed_data(VP9Decoder *pbi,
   BufferPool *volatile const pool = cm->buffer_pool;
   RefCntBuffer *volatile const frame_bufs = cm->buffer_pool->frame_bufs;
   const uint8_t *source = *psource;
+  volatile const uint64_t start =
+      pbi->stage_timing_enabled ? vp9_stage_timer_now() : 0;
   int retcode = 0;
   cm->error.error_code = VPX_CODEC_OK;
 
@@ -412,6 +414,9 @@ int vp9_receive_compressed_data(VP9Decoder *pbi,
     }
   }
 
+  if (pbi->stage_timing_enabled)
+    pbi->stage_timing.total_ns += vp9_stage_timer_now() - start;
+
   cm->error.setjmp = 0;
   return retcode;
 }
@@ -437,7 +442,14 @@ int vp9_get_raw_frame(VP9Decoder *pbi, YV12_BUFFER_CONFIG *sd,
 
 #if CONFIG_VP9_POSTPROC
   if (!cm->show_existing_frame) {
+    const uint64_t start =
+        pbi->stage_timing_enabled ? vp9_stage_timer_now() : 0;
     ret = vp9_post_proc_frame(cm, sd, flags);
+    if (pbi->stage_timing_enabled) {
+      const uint64_t ns = vp9_stage_timer_now() - start;
+      pbi->stage_timing.ns[VPX_STAGE_POSTPROC] += ns;
+      pbi->stage_timing.total_ns += ns;
+    }
   } else {
     *sd = *cm->frame_to_show;
     ret = 0;
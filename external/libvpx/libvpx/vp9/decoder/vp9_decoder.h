@@ -21,6 +21,7 @@
 #include "vp9/common/vp9_thread_common.h"
 #include "vp9/common/vp9_onyxc_int.h"
 #include "vp9/common/vp9_ppflags.h"
+#include "vp9/common/vp9_stage_timing.h"
 #include "vp9/decoder/vp9_dthread.h"
 
 #define LOG_TAG "VP9_DECODE"
@@ -44,6 +45,7 @@ typedef struct TileWorkerData {
   struct VP9Decoder *pbi;
   vpx_reader bit_reader;
   FRAME_COUNTS counts;
+  uint64_t stage_ticks[VPX_STAGE_COUNT];
   DECLARE_ALIGNED(16, MACROBLOCKD, xd);
   
   DECLARE_ALIGNED(16, tran_low_t, dqcoeff[32 * 32]);
@@ -84,6 +86,9 @@ typedef struct VP9Decoder {
   int inv_tile_order;
   int need_resync;  
   int hold_ref_buf;  
+
+  int stage_timing_enabled;
+  vpx_stage_timing_t stage_timing;
 } VP9Decoder;
 
 int vp9_receive_compressed_data(struct VP9Decoder *pbi,
@@ -0,0 +1,267 @@
+/*
+ *  Copyright (c) 2016 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <arm_neon.h>
+#include <string.h>
+
+#include "./vpx_config.h"
+#include "./vp9_rtcd.h"
+
+#include "vpx/vpx_integer.h"
+#include "vp9/common/vp9_reconinter.h"
+#include "vp9/encoder/vp9_context_tree.h"
+#include "vp9/encoder/vp9_denoiser.h"
+
+static INLINE int sum_diff_16x1(const int8x16_t acc_diff) {
+  const int16x8_t fe_dc_ba_98_76_54_32_10 = vpaddlq_s8(acc_diff);
+  const int32x4_t fedc_ba98_7654_3210 = vpaddlq_s16(fe_dc_ba_98_76_54_32_10);
+  const int64x2_t fedcba98_76543210 = vpaddlq_s32(fedc_ba98_7654_3210);
+  return (int)(vgetq_lane_s64(fedcba98_76543210, 0) +
+               vgetq_lane_s64(fedcba98_76543210, 1));
+}
+
+static INLINE int8x16_t denoiser_16x1_neon(const uint8_t *sig,
+                                           const uint8_t *mc_running_avg_y,
+                                           uint8_t *running_avg_y,
+                                           const uint8x16_t k_4,
+                                           const uint8x16_t l3,
+                                           int8x16_t acc_diff) {
+  const uint8x16_t k_0 = vdupq_n_u8(0);
+  const uint8x16_t k_8 = vdupq_n_u8(8);
+  const uint8x16_t k_16 = vdupq_n_u8(16);
+  const uint8x16_t l32 = vdupq_n_u8(2);
+  const uint8x16_t l21 = vdupq_n_u8(1);
+  const uint8x16_t v_sig = vld1q_u8(sig);
+  const uint8x16_t v_mc_running_avg_y = vld1q_u8(mc_running_avg_y);
+  const uint8x16_t pdiff = vqsubq_u8(v_mc_running_avg_y, v_sig);
+  const uint8x16_t ndiff = vqsubq_u8(v_sig, v_mc_running_avg_y);
+  const uint8x16_t diff_sign = vceqq_u8(pdiff, k_0);
+  const uint8x16_t clamped_absdiff = vminq_u8(vorrq_u8(pdiff, ndiff), k_16);
+  const uint8x16_t mask2 = vcltq_u8(clamped_absdiff, k_16);
+  const uint8x16_t mask1 = vcltq_u8(clamped_absdiff, k_8);
+  const uint8x16_t mask0 = vcltq_u8(clamped_absdiff, k_4);
+  const uint8x16_t adj2 = vaddq_u8(vandq_u8(mask2, l32), vandq_u8(mask1, l21));
+  const uint8x16_t adj0 = vandq_u8(mask0, clamped_absdiff);
+  const uint8x16_t adj = vorrq_u8(vbicq_u8(vsubq_u8(l3, adj2), mask0), adj0);
+  const uint8x16_t padj = vbicq_u8(adj, diff_sign);
+  const uint8x16_t nadj = vandq_u8(diff_sign, adj);
+  const uint8x16_t v_running_avg_y =
+      vqsubq_u8(vqaddq_u8(v_sig, padj), nadj);
+
+  vst1q_u8(running_avg_y, v_running_avg_y);
+
+  acc_diff = vqaddq_s8(acc_diff, vreinterpretq_s8_u8(padj));
+  return vqsubq_s8(acc_diff, vreinterpretq_s8_u8(nadj));
+}
+
+static INLINE int8x16_t denoiser_adj_16x1_neon(const uint8_t *sig,
+                                               const uint8_t *mc_running_avg_y,
+                                               uint8_t *running_avg_y,
+                                               const uint8x16_t k_delta,
+                                               int8x16_t acc_diff) {
+  const uint8x16_t k_0 = vdupq_n_u8(0);
+  const uint8x16_t v_sig = vld1q_u8(sig);
+  const uint8x16_t v_mc_running_avg_y = vld1q_u8(mc_running_avg_y);
+  const uint8x16_t pdiff = vqsubq_u8(v_mc_running_avg_y, v_sig);
+  const uint8x16_t ndiff = vqsubq_u8(v_sig, v_mc_running_avg_y);
+  const uint8x16_t diff_sign = vceqq_u8(pdiff, k_0);
+  const uint8x16_t adj = vminq_u8(vorrq_u8(pdiff, ndiff), k_delta);
+  const uint8x16_t padj = vbicq_u8(adj, diff_sign);
+  const uint8x16_t nadj = vandq_u8(diff_sign, adj);
+  const uint8x16_t v_running_avg_y =
+      vqaddq_u8(vqsubq_u8(vld1q_u8(running_avg_y), padj), nadj);
+
+  vst1q_u8(running_avg_y, v_running_avg_y);
+
+  acc_diff = vqsubq_s8(acc_diff, vreinterpretq_s8_u8(padj));
+  return vqaddq_s8(acc_diff, vreinterpretq_s8_u8(nadj));
+}
+
+static void gather_rows(uint8_t *dst, const uint8_t *src, int stride,
+                        int width, int rows) {
+  int i;
+  for (i = 0; i < rows; ++i)
+    memcpy(dst + i * width, src + i * stride, width);
+}
+
+static void scatter_rows(uint8_t *dst, int stride, const uint8_t *src,
+                         int width, int rows) {
+  int i;
+  for (i = 0; i < rows; ++i)
+    memcpy(dst + i * stride, src + i * width, width);
+}
+
+static int denoiser_NxM_neon_small(
+    const uint8_t *sig, int sig_stride, const uint8_t *mc_running_avg_y,
+    int mc_avg_y_stride, uint8_t *running_avg_y, int avg_y_stride,
+    int increase_denoising, BLOCK_SIZE bs, int motion_magnitude, int width) {
+  const int shift_inc  = (increase_denoising &&
+                          motion_magnitude <= MOTION_MAGNITUDE_THRESHOLD) ?
+                         1 : 0;
+  const uint8x16_t k_4 = vdupq_n_u8(4 + shift_inc);
+  const uint8x16_t l3 = vdupq_n_u8(
+      (motion_magnitude <= MOTION_MAGNITUDE_THRESHOLD) ? 7 + shift_inc : 6);
+  const int rows_per_vec = 16 / width;
+  const int num_vecs = (4 << b_height_log2_lookup[bs]) / rows_per_vec;
+  uint8_t sig_buffer[8][16], mc_running_buffer[8][16], running_buffer[8][16];
+  int8x16_t acc_diff = vdupq_n_s8(0);
+  int sum_diff_thresh, sum_diff, r;
+
+  for (r = 0; r < num_vecs; ++r) {
+    gather_rows(sig_buffer[r], sig, sig_stride, width, rows_per_vec);
+    gather_rows(mc_running_buffer[r], mc_running_avg_y, mc_avg_y_stride,
+                width, rows_per_vec);
+    acc_diff = denoiser_16x1_neon(sig_buffer[r], mc_running_buffer[r],
+                                  running_buffer[r], k_4, l3, acc_diff);
+    scatter_rows(running_avg_y, avg_y_stride, running_buffer[r], width,
+                 rows_per_vec);
+    sig += sig_stride * rows_per_vec;
+    mc_running_avg_y += mc_avg_y_stride * rows_per_vec;
+    running_avg_y += avg_y_stride * rows_per_vec;
+  }
+
+  sum_diff = sum_diff_16x1(acc_diff);
+  sum_diff_thresh = total_adj_strong_thresh(bs, increase_denoising);
+  if (abs(sum_diff) > sum_diff_thresh) {
+    const int delta = ((abs(sum_diff) - sum_diff_thresh) >>
+                       num_pels_log2_lookup[bs]) + 1;
+
+    if (delta < 4) {
+      const uint8x16_t k_delta = vdupq_n_u8(delta);
+      running_avg_y -= avg_y_stride * (4 << b_height_log2_lookup[bs]);
+      for (r = 0; r < num_vecs; ++r) {
+        acc_diff = denoiser_adj_16x1_neon(sig_buffer[r], mc_running_buffer[r],
+                                          running_buffer[r], k_delta,
+                                          acc_diff);
+        scatter_rows(running_avg_y, avg_y_stride, running_buffer[r], width,
+                     rows_per_vec);
+        running_avg_y += avg_y_stride * rows_per_vec;
+      }
+      sum_diff = sum_diff_16x1(acc_diff);
+      if (abs(sum_diff) > sum_diff_thresh) {
+        return COPY_BLOCK;
+      }
+    } else {
+      return COPY_BLOCK;
+    }
+  }
+  return FILTER_BLOCK;
+}
+
+static int denoiser_NxM_neon_big(const uint8_t *sig, int sig_stride,
+                                 const uint8_t *mc_running_avg_y,
+                                 int mc_avg_y_stride,
+                                 uint8_t *running_avg_y, int avg_y_stride,
+                                 int increase_denoising, BLOCK_SIZE bs,
+                                 int motion_magnitude) {
+  const int width = 4 << b_width_log2_lookup[bs];
+  const int height = 4 << b_height_log2_lookup[bs];
+  const int shift_inc  = (increase_denoising &&
+                          motion_magnitude <= MOTION_MAGNITUDE_THRESHOLD) ?
+                         1 : 0;
+  const uint8x16_t k_4 = vdupq_n_u8(4 + shift_inc);
+  const uint8x16_t l3 = vdupq_n_u8(
+      (motion_magnitude <= MOTION_MAGNITUDE_THRESHOLD) ? 7 + shift_inc : 6);
+  int8x16_t acc_diff[4][4];
+  int sum_diff_thresh, r, c, sum_diff = 0;
+
+  for (c = 0; c < 4; ++c) {
+    for (r = 0; r < 4; ++r) {
+      acc_diff[c][r] = vdupq_n_s8(0);
+    }
+  }
+
+  for (r = 0; r < height; ++r) {
+    for (c = 0; c < width; c += 16) {
+      acc_diff[c >> 4][r >> 4] = denoiser_16x1_neon(
+          sig + c, mc_running_avg_y + c, running_avg_y + c, k_4, l3,
+          acc_diff[c >> 4][r >> 4]);
+    }
+
+    if ((r + 1) % 16 == 0 || (bs == BLOCK_16X8 && r == 7)) {
+      for (c = 0; c < width; c += 16) {
+        sum_diff += sum_diff_16x1(acc_diff[c >> 4][r >> 4]);
+      }
+    }
+
+    sig += sig_stride;
+    mc_running_avg_y += mc_avg_y_stride;
+    running_avg_y += avg_y_stride;
+  }
+
+  sum_diff_thresh = total_adj_strong_thresh(bs, increase_denoising);
+  if (abs(sum_diff) > sum_diff_thresh) {
+    const int delta = ((abs(sum_diff) - sum_diff_thresh) >>
+                       num_pels_log2_lookup[bs]) + 1;
+
+    if (delta < 4) {
+      const uint8x16_t k_delta = vdupq_n_u8(delta);
+      sig -= sig_stride * height;
+      mc_running_avg_y -= mc_avg_y_stride * height;
+      running_avg_y -= avg_y_stride * height;
+      sum_diff = 0;
+      for (r = 0; r < height; ++r) {
+        for (c = 0; c < width; c += 16) {
+          acc_diff[c >> 4][r >> 4] = denoiser_adj_16x1_neon(
+              sig + c, mc_running_avg_y + c, running_avg_y + c, k_delta,
+              acc_diff[c >> 4][r >> 4]);
+        }
+
+        if ((r + 1) % 16 == 0 || (bs == BLOCK_16X8 && r == 7)) {
+          for (c = 0; c < width; c += 16) {
+            sum_diff += sum_diff_16x1(acc_diff[c >> 4][r >> 4]);
+          }
+        }
+
+        sig += sig_stride;
+        mc_running_avg_y += mc_avg_y_stride;
+        running_avg_y += avg_y_stride;
+      }
+      if (abs(sum_diff) > sum_diff_thresh) {
+        return COPY_BLOCK;
+      }
+    } else {
+      return COPY_BLOCK;
+    }
+  }
+  return FILTER_BLOCK;
+}
+
+int vp9_denoiser_filter_neon(const uint8_t *sig, int sig_stride,
+                             const uint8_t *mc_avg,
+                             int mc_avg_stride,
+                             uint8_t *avg, int avg_stride,
+                             int increase_denoising,
+                             BLOCK_SIZE bs,
+                             int motion_magnitude) {
+  if (bs == BLOCK_4X4 || bs == BLOCK_4X8) {
+    return denoiser_NxM_neon_small(sig, sig_stride,
+                                   mc_avg, mc_avg_stride,
+                                   avg, avg_stride,
+                                   increase_denoising,
+                                   bs, motion_magnitude, 4);
+  } else if (bs == BLOCK_8X4 || bs == BLOCK_8X8 || bs == BLOCK_8X16) {
+    return denoiser_NxM_neon_small(sig, sig_stride,
+                                   mc_avg, mc_avg_stride,
+                                   avg, avg_stride,
+                                   increase_denoising,
+                                   bs, motion_magnitude, 8);
+  } else if (bs == BLOCK_16X8 || bs == BLOCK_16X16 || bs == BLOCK_16X32 ||
+             bs == BLOCK_32X16 || bs == BLOCK_32X32 || bs == BLOCK_32X64 ||
+             bs == BLOCK_64X32 || bs == BLOCK_64X64) {
+    return denoiser_NxM_neon_big(sig, sig_stride,
+                                 mc_avg, mc_avg_stride,
+                                 avg, avg_stride,
+                                 increase_denoising,
+                                 bs, motion_magnitude);
+  } else {
+    return COPY_BLOCK;
+  }
+}
@@ -694,6 +694,9 @@ static int choose_partitioning(VP9_COMP *cpi,
     unsigned int y_sad, y_sad_g;
     const BLOCK_SIZE bsize = BLOCK_32X32
         + (mi_col + 4 < cm->mi_cols) * 2 + (mi_row + 4 < cm->mi_rows);
+    unsigned int sad_thresh = cpi->vbp_threshold_sad;
+    BLOCK_SIZE lower_bsize = BLOCK_INVALID;
+    MV lower_mv;
 
     assert(yv12 != NULL);
 
@@ -723,7 +726,32 @@ static int choose_partitioning(VP9_COMP *cpi,
     mbmi->mv[0].as_int = 0;
     mbmi->interp_filter = BILINEAR;
 
-    y_sad = vp9_int_pro_motion_estimation(cpi, x, bsize, mi_row, mi_col);
+    if (vp9_svc_lower_layer_motion(cpi, mi_row, mi_col, BLOCK_64X64,
+                                   &lower_mv, &lower_bsize)) {
+      const struct buf_2d *const pre = &xd->plane[0].pre[0];
+      unsigned int zero_sad;
+
+      lower_mv.row >>= 3;
+      lower_mv.col >>= 3;
+      clamp_mv(&lower_mv, x->mv_col_min, x->mv_col_max,
+               x->mv_row_min, x->mv_row_max);
+      y_sad = cpi->fn_ptr[bsize].sdf(s, sp, pre->buf + lower_mv.row *
+                                     pre->stride + lower_mv.col, pre->stride);
+      zero_sad = cpi->fn_ptr[bsize].sdf(s, sp, pre->buf, pre->stride);
+      if (zero_sad <= y_sad) {
+        y_sad = zero_sad;
+      } else {
+        mbmi->mv[0].as_mv.row = lower_mv.row * 8;
+        mbmi->mv[0].as_mv.col = lower_mv.col * 8;
+      }
+      if (num_8x8_blocks_wide_lookup[lower_bsize] * cm->width >=
+              MI_BLOCK_SIZE * cpi->svc.lower_layer_width &&
+          num_8x8_blocks_high_lookup[lower_bsize] * cm->height >=
+              MI_BLOCK_SIZE * cpi->svc.lower_layer_height)
+        sad_thresh <<= 1;
+    } else {
+      y_sad = vp9_int_pro_motion_estimation(cpi, x, bsize, mi_row, mi_col);
+    }
     if (y_sad_g < y_sad) {
       vp9_setup_pre_planes(xd, 0, yv12_g, mi_row, mi_col,
                            &cm->frame_refs[GOLDEN_FRAME - 1].sf);
@@ -756,7 +784,7 @@ static int choose_partitioning(VP9_COMP *cpi,
     
     
     if (segment_id == CR_SEGMENT_ID_BASE &&
-        y_sad < cpi->vbp_threshold_sad) {
+        y_sad < sad_thresh) {
       const int block_width = num_8x8_blocks_wide_lookup[BLOCK_64X64];
       const int block_height = num_8x8_blocks_high_lookup[BLOCK_64X64];
       if (mi_col + block_width / 2 < cm->mi_cols &&
@@ -1159,6 +1187,7 @@ static void rd_pick_sb_modes(VP9_COMP *cpi,
   struct macroblockd_plane *const pd = xd->plane;
   const AQ_MODE aq_mode = cpi->oxcf.aq_mode;
   int i, orig_rdmult;
+  uint64_t t;
 
   vpx_clear_system_state();
 
@@ -1226,6 +1255,7 @@ static void rd_pick_sb_modes(VP9_COMP *cpi,
 
   
   
+  t = vp9_stage_timer_start(xd->stage_ticks);
   if (frame_is_intra_only(cm)) {
     vp9_rd_pick_intra_mode_sb(cpi, x, rd_cost, bsize, ctx, best_rd);
   } else {
@@ -1241,6 +1271,7 @@ static void rd_pick_sb_modes(VP9_COMP *cpi,
                                     rd_cost, bsize, ctx, best_rd);
     }
   }
+  vp9_stage_timer_end(xd->stage_ticks, VPX_STAGE_MODE_DECISION, t);
 
 
   
@@ -2886,6 +2917,7 @@ static void nonrd_pick_sb_modes(VP9_COMP *cpi,
   TileInfo *const tile_info = &tile_data->tile_info;
   MACROBLOCKD *const xd = &x->e_mbd;
   MB_MODE_INFO *mbmi;
+  uint64_t t;
   set_offsets(cpi, tile_info, x, mi_row, mi_col, bsize);
   mbmi = &xd->mi[0]->mbmi;
   mbmi->sb_type = bsize;
@@ -2894,6 +2926,7 @@ static void nonrd_pick_sb_modes(VP9_COMP *cpi,
     if (cyclic_refresh_segment_id_boosted(mbmi->segment_id))
       x->rdmult = vp9_cyclic_refresh_get_rdmult(cpi->cyclic_refresh);
 
+  t = vp9_stage_timer_start(xd->stage_ticks);
   if (cm->frame_type == KEY_FRAME)
     hybrid_intra_mode_search(cpi, x, rd_cost, bsize, ctx);
   else if (segfeature_active(&cm->seg, mbmi->segment_id, SEG_LVL_SKIP))
@@ -2904,6 +2937,7 @@ static void nonrd_pick_sb_modes(VP9_COMP *cpi,
   else
     vp9_pick_inter_mode_sub8x8(cpi, x, mi_row, mi_col,
                                rd_cost, bsize, ctx);
+  vp9_stage_timer_end(xd->stage_ticks, VPX_STAGE_MODE_DECISION, t);
 
   duplicate_mode_info_in_sb(cm, xd, mi_row, mi_col, bsize);
 
@@ -4102,6 +4136,7 @@ static void encode_superblock(VP9_COMP *cpi, ThreadData *td,
   const int mis = cm->mi_stride;
   const int mi_width = num_8x8_blocks_wide_lookup[bsize];
   const int mi_height = num_8x8_blocks_high_lookup[bsize];
+  uint64_t start;
 
   x->skip_recode = !x->select_tx_size && mbmi->sb_type >= BLOCK_8X8 &&
                    cpi->oxcf.aq_mode != COMPLEXITY_AQ &&
@@ -4120,6 +4155,7 @@ static void encode_superblock(VP9_COMP *cpi, ThreadData *td,
   if (x->skip_encode)
     return;
 
+  start = vp9_stage_timer_start(xd->stage_ticks);
   if (!is_inter_block(mbmi)) {
     int plane;
     mbmi->skip = 1;
@@ -4127,7 +4163,9 @@ static void encode_superblock(VP9_COMP *cpi, ThreadData *td,
       vp9_encode_intra_block_plane(x, MAX(bsize, BLOCK_8X8), plane);
     if (output_enabled)
       sum_intra_stats(td->counts, mi);
+    start = vp9_stage_timer_end(xd->stage_ticks, VPX_STAGE_TRANSFORM, start);
     vp9_tokenize_sb(cpi, td, t, !output_enabled, MAX(bsize, BLOCK_8X8));
+    vp9_stage_timer_end(xd->stage_ticks, VPX_STAGE_ENTROPY, start);
   } else {
     int ref;
     const int is_compound = has_second_ref(mbmi);
@@ -4143,9 +4181,12 @@ static void encode_superblock(VP9_COMP *cpi, ThreadData *td,
       vp9_build_inter_predictors_sby(xd, mi_row, mi_col, MAX(bsize, BLOCK_8X8));
 
     vp9_build_inter_predictors_sbuv(xd, mi_row, mi_col, MAX(bsize, BLOCK_8X8));
+    start = vp9_stage_timer_end(xd->stage_ticks, VPX_STAGE_PREDICTION, start);
 
     vp9_encode_sb(x, MAX(bsize, BLOCK_8X8));
+    start = vp9_stage_timer_end(xd->stage_ticks, VPX_STAGE_TRANSFORM, start);
     vp9_tokenize_sb(cpi, td, t, !output_enabled, MAX(bsize, BLOCK_8X8));
+    vp9_stage_timer_end(xd->stage_ticks, VPX_STAGE_ENTROPY, start);
   }
 
   if (output_enabled) {
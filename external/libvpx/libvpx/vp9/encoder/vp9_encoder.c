@@ -18,6 +18,7 @@
 #include "./vpx_scale_rtcd.h"
 #include "vpx/internal/vpx_psnr.h"
 #include "vpx_dsp/vpx_filter.h"
+#include "vpx_dsp/quality_metrics.h"
 #if CONFIG_INTERNAL_STATS
 #include "vpx_dsp/ssim.h"
 #endif
@@ -47,6 +48,7 @@
 #include "vp9/encoder/vp9_firstpass.h"
 #include "vp9/encoder/vp9_mbgraph.h"
 #include "vp9/encoder/vp9_picklpf.h"
+#include "vp9/encoder/vp9_pyramid_me.h"
 #include "vp9/encoder/vp9_ratectrl.h"
 #include "vp9/encoder/vp9_rd.h"
 #include "vp9/encoder/vp9_resize.h"
@@ -381,6 +383,9 @@ static void dealloc_compressor_data(VP9_COMP *cpi) {
   vpx_free_frame_buffer(&cpi->scaled_source);
   vpx_free_frame_buffer(&cpi->scaled_last_source);
   vpx_free_frame_buffer(&cpi->alt_ref_buffer);
+  vpx_free(cpi->arnr_filter_data.mv_buf);
+  cpi->arnr_filter_data.mv_buf = NULL;
+  cpi->arnr_filter_data.mv_buf_size = 0;
   vp9_lookahead_destroy(cpi->lookahead);
 
   vpx_free(cpi->tile_tok[0][0]);
@@ -408,6 +413,8 @@ static void dealloc_compressor_data(VP9_COMP *cpi) {
 
   vpx_free_frame_buffer(&cpi->svc.empty_frame.img);
   memset(&cpi->svc.empty_frame, 0, sizeof(cpi->svc.empty_frame));
+
+  vp9_svc_free_layer_buffers(&cpi->svc);
 }
 
 static void save_coding_context(VP9_COMP *cpi) {
@@ -1983,8 +1990,9 @@ void vp9_remove_compressor(VP9_COMP *cpi) {
           SNPRINT2(results, "\t%7.3f", cpi->ssimg.worst);
         }
 
-        fprintf(f, "%s\t    Time\n", headings);
-        fprintf(f, "%s\t%8.0f\n", results, total_encode_time);
+        fprintf(f, "%s\t    Time\t    ARNR\n", headings);
+        fprintf(f, "%s\t%8.0f\t%8.0f\n", results, total_encode_time,
+                cpi->time_temporal_filter / 1000.000);
       }
 
       fclose(f);
@@ -1995,6 +2003,7 @@ void vp9_remove_compressor(VP9_COMP *cpi) {
 #if 0
     {
       printf("\n_pick_loop_filter_level:%d\n", cpi->time_pick_lpf / 1000);
+      printf("\n_temporal_filter:%d\n", cpi->time_temporal_filter / 1000);
       printf("\n_frames recive_data encod_mb_row compress_frame  Total\n");
       printf("%6d %10ld %10ld %10ld %10ld\n", cpi->common.current_video_frame,
              cpi->time_receive_data / 1000, cpi->time_encode_sb_row / 1000,
@@ -2327,20 +2336,35 @@ static void calc_highbd_psnr(const YV12_BUFFER_CONFIG *a,
 #endif  
 
 static void generate_psnr_packet(VP9_COMP *cpi) {
+  VP9_COMMON *const cm = &cpi->common;
   struct vpx_codec_cx_pkt pkt;
   int i;
-  PSNR_STATS psnr;
 #if CONFIG_VP9_HIGHBITDEPTH
-  calc_highbd_psnr(cpi->Source, cpi->common.frame_to_show, &psnr,
-                   cpi->td.mb.e_mbd.bd, cpi->oxcf.input_bit_depth);
-#else
-  calc_psnr(cpi->Source, cpi->common.frame_to_show, &psnr);
+  // The metrics engine does not know about inputs that were upshifted to
+  // the coding bit depth; use the shifting path for those.
+  if ((unsigned int)cm->bit_depth != cpi->oxcf.input_bit_depth) {
+    PSNR_STATS psnr;
+    calc_highbd_psnr(cpi->Source, cm->frame_to_show, &psnr,
+                     cpi->td.mb.e_mbd.bd, cpi->oxcf.input_bit_depth);
+    for (i = 0; i < 4; ++i) {
+      pkt.data.psnr.samples[i] = psnr.samples[i];
+      pkt.data.psnr.sse[i] = psnr.sse[i];
+      pkt.data.psnr.psnr[i] = psnr.psnr[i];
+    }
+  } else
 #endif
-
-  for (i = 0; i < 4; ++i) {
-    pkt.data.psnr.samples[i] = psnr.samples[i];
-    pkt.data.psnr.sse[i] = psnr.sse[i];
-    pkt.data.psnr.psnr[i] = psnr.psnr[i];
+  {
+    QualityMetrics metrics;
+    if (vpx_calc_quality_metrics(cpi->Source, cm->frame_to_show,
+                                 VPX_METRIC_PSNR, cm->bit_depth,
+                                 cpi->workers, cpi->num_workers, &metrics))
+      vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
+                         "Failed to compute PSNR");
+    for (i = 0; i < 4; ++i) {
+      pkt.data.psnr.samples[i] = metrics.samples[i];
+      pkt.data.psnr.sse[i] = metrics.sse[i];
+      pkt.data.psnr.psnr[i] = metrics.psnr[i];
+    }
   }
   pkt.kind = VPX_CODEC_PSNR_PKT;
   if (cpi->use_svc)
@@ -3174,9 +3198,12 @@ static void encode_without_recode_loop(VP9_COMP *cpi,
 
   set_frame_size(cpi);
 
-  cpi->Source = vp9_scale_if_required(cm,
-                                      cpi->un_scaled_source,
-                                      &cpi->scaled_source);
+  if (is_one_pass_cbr_svc(cpi) && cpi->oxcf.svc_reuse_lower_layer)
+    cpi->Source = vp9_svc_get_scaled_source(cpi);
+  else
+    cpi->Source = vp9_scale_if_required(cm,
+                                        cpi->un_scaled_source,
+                                        &cpi->scaled_source);
   if (cpi->unscaled_last_source != NULL)
     cpi->Last_Source = vp9_scale_if_required(cm,
                                              cpi->unscaled_last_source,
@@ -3256,6 +3283,9 @@ static void encode_without_recode_loop(VP9_COMP *cpi,
       (cpi->oxcf.pass == 0 && cpi->oxcf.rc_mode == VPX_CBR))
     vp9_cyclic_refresh_check_golden_update(cpi);
 
+  if (is_one_pass_cbr_svc(cpi) && cpi->oxcf.svc_reuse_lower_layer)
+    vp9_svc_save_layer_motion(cpi);
+
   
   
   
@@ -3565,26 +3595,33 @@ static void set_ext_overrides(VP9_COMP *cpi) {
   }
 }
 
+void vp9_scale_and_extend_source(const VP9_COMMON *cm,
+                                 const YV12_BUFFER_CONFIG *unscaled,
+                                 YV12_BUFFER_CONFIG *scaled) {
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (unscaled->y_width == (scaled->y_width << 1) &&
+      unscaled->y_height == (scaled->y_height << 1))
+    scale_and_extend_frame(unscaled, scaled, (int)cm->bit_depth);
+  else
+    scale_and_extend_frame_nonnormative(unscaled, scaled, (int)cm->bit_depth);
+#else
+  (void)cm;
+  
+  
+  if (unscaled->y_width == (scaled->y_width << 1) &&
+      unscaled->y_height == (scaled->y_height << 1))
+    scale_and_extend_frame(unscaled, scaled);
+  else
+    scale_and_extend_frame_nonnormative(unscaled, scaled);
+#endif  
+}
+
 YV12_BUFFER_CONFIG *vp9_scale_if_required(VP9_COMMON *cm,
                                           YV12_BUFFER_CONFIG *unscaled,
                                           YV12_BUFFER_CONFIG *scaled) {
   if (cm->mi_cols * MI_SIZE != unscaled->y_width ||
       cm->mi_rows * MI_SIZE != unscaled->y_height) {
-#if CONFIG_VP9_HIGHBITDEPTH
-    if (unscaled->y_width == (scaled->y_width << 1) &&
-        unscaled->y_height == (scaled->y_height << 1))
-      scale_and_extend_frame(unscaled, scaled, (int)cm->bit_depth);
-    else
-      scale_and_extend_frame_nonnormative(unscaled, scaled, (int)cm->bit_depth);
-#else
-    
-    
-    if (unscaled->y_width == (scaled->y_width << 1) &&
-        unscaled->y_height == (scaled->y_height << 1))
-      scale_and_extend_frame(unscaled, scaled);
-    else
-      scale_and_extend_frame_nonnormative(unscaled, scaled);
-#endif  
+    vp9_scale_and_extend_source(cm, unscaled, scaled);
     return scaled;
   } else {
     return unscaled;
@@ -3641,6 +3678,7 @@ static void encode_frame_to_data_rate(VP9_COMP *cpi,
   const VP9EncoderConfig *const oxcf = &cpi->oxcf;
   struct segmentation *const seg = &cm->seg;
   TX_SIZE t;
+  uint64_t start;
 
   set_ext_overrides(cpi);
   vpx_clear_system_state();
@@ -3784,10 +3822,14 @@ static void encode_frame_to_data_rate(VP9_COMP *cpi,
   cm->frame_to_show = get_frame_new_buffer(cm);
 
   
+  start = vp9_stage_timer_start(cpi->td.mb.e_mbd.stage_ticks);
   loopfilter_frame(cpi, cm);
+  start = vp9_stage_timer_end(cpi->td.mb.e_mbd.stage_ticks,
+                              VPX_STAGE_LOOP_FILTER, start);
 
   
   vp9_pack_bitstream(cpi, dest, size);
+  vp9_stage_timer_end(cpi->td.mb.e_mbd.stage_ticks, VPX_STAGE_ENTROPY, start);
 
   if (cm->seg.update_map)
     update_reference_segmentation_map(cpi);
@@ -4089,10 +4131,6 @@ static void check_src_altref(VP9_COMP *cpi,
 }
 
 #if CONFIG_INTERNAL_STATS
-extern double vp9_get_blockiness(const uint8_t *img1, int img1_pitch,
-                                 const uint8_t *img2, int img2_pitch,
-                                 int width, int height);
-
 static void adjust_image_stat(double y, double u, double v, double all,
                               ImageStat *s) {
   s->stat[Y] += y;
@@ -4114,9 +4152,14 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
   YV12_BUFFER_CONFIG *force_src_buffer = NULL;
   struct lookahead_entry *last_source = NULL;
   struct lookahead_entry *source = NULL;
+  uint64_t *const stage_ticks =
+      cpi->stage_timing_enabled ? cpi->td.stage_ticks : NULL;
+  const uint64_t stage_start = vp9_stage_timer_start(stage_ticks);
   int arf_src_index;
   int i;
 
+  cpi->td.mb.e_mbd.stage_ticks = stage_ticks;
+
   if (is_two_pass_svc(cpi)) {
 #if CONFIG_SPATIAL_SVC
     vp9_svc_start_frame(cpi);
@@ -4181,7 +4224,9 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
 
       if (oxcf->arnr_max_frames > 0) {
         
+        const uint64_t t = vp9_stage_timer_start(stage_ticks);
         vp9_temporal_filter(cpi, arf_src_index);
+        vp9_stage_timer_end(stage_ticks, VPX_STAGE_TEMPORAL_FILTER, t);
         vpx_extend_frame_borders(&cpi->alt_ref_buffer);
         force_src_buffer = &cpi->alt_ref_buffer;
       }
@@ -4233,6 +4278,11 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
 
     cpi->unscaled_last_source = last_source != NULL ? &last_source->img : NULL;
 
+    cpi->pyramid_mvs = NULL;
+    if (cpi->sf.lookahead_pyramid_me && last_source != NULL &&
+        !force_src_buffer && !cpi->use_svc)
+      cpi->pyramid_mvs = vp9_pyramid_me_get_mvs(source, last_source);
+
     *time_stamp = source->ts_start;
     *time_end = source->ts_end;
     *frame_flags = (source->flags & VPX_EFLAG_FORCE_KF) ? FRAMEFLAGS_KEY : 0;
@@ -4355,6 +4405,13 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
   vpx_usec_timer_mark(&cmptimer);
   cpi->time_compress_data += vpx_usec_timer_elapsed(&cmptimer);
 
+  if (stage_ticks) {
+    stage_ticks[VPX_STAGE_MODE_DECISION] -=
+        stage_ticks[VPX_STAGE_MOTION_SEARCH];
+    vp9_stage_ticks_add(cpi->stage_timing.ns, stage_ticks);
+    cpi->stage_timing.total_ns += vp9_stage_timer_now() - stage_start;
+  }
+
   if (cpi->b_calculate_psnr && oxcf->pass != 1 && cm->show_frame)
     generate_psnr_packet(cpi);
 
@@ -4365,6 +4422,18 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
     cpi->bytes += (int)(*size);
 
     if (cm->show_frame) {
+      QualityMetrics metrics;
+      int metric_flags = VPX_METRIC_FASTSSIM | VPX_METRIC_PSNRHVS;
+      if (cpi->b_calculate_psnr)
+        metric_flags |= VPX_METRIC_SSIM;
+      if (cpi->b_calculate_blockiness)
+        metric_flags |= VPX_METRIC_BLOCKINESS;
+      if (vpx_calc_quality_metrics(cpi->Source, cm->frame_to_show,
+                                   metric_flags, cm->bit_depth, cpi->workers,
+                                   cpi->num_workers, &metrics))
+        vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
+                           "Failed to compute quality metrics");
+
       cpi->count++;
 
       if (cpi->b_calculate_psnr) {
@@ -4387,7 +4456,7 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
 
         {
           PSNR_STATS psnr2;
-          double frame_ssim2 = 0, weight = 0;
+          double frame_ssim2 = 0, weight = 1;
 #if CONFIG_VP9_POSTPROC
           if (vpx_alloc_frame_buffer(&cm->post_proc_buffer,
                                      recon->y_crop_width, recon->y_crop_height,
@@ -4418,17 +4487,7 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
           adjust_image_stat(psnr2.psnr[1], psnr2.psnr[2], psnr2.psnr[3],
                             psnr2.psnr[0], &cpi->psnrp);
 
-#if CONFIG_VP9_HIGHBITDEPTH
-          if (cm->use_highbitdepth) {
-            frame_ssim2 = vpx_highbd_calc_ssim(orig, recon, &weight,
-                                               (int)cm->bit_depth);
-          } else {
-            frame_ssim2 = vpx_calc_ssim(orig, recon, &weight);
-          }
-#else
-          frame_ssim2 = vpx_calc_ssim(orig, recon, &weight);
-#endif  
-
+          frame_ssim2 = metrics.ssim[0];
           cpi->worst_ssim= MIN(cpi->worst_ssim, frame_ssim2);
           cpi->summed_quality += frame_ssim2 * weight;
           cpi->summed_weights += weight;
@@ -4462,10 +4521,7 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
         if (!cm->use_highbitdepth)
 #endif
         {
-          double frame_blockiness = vp9_get_blockiness(
-              cpi->Source->y_buffer, cpi->Source->y_stride,
-              cm->frame_to_show->y_buffer, cm->frame_to_show->y_stride,
-              cpi->Source->y_width, cpi->Source->y_height);
+          const double frame_blockiness = metrics.blockiness;
           cpi->worst_blockiness = MAX(cpi->worst_blockiness, frame_blockiness);
           cpi->total_blockiness += frame_blockiness;
         }
@@ -4511,19 +4567,17 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
       if (!cm->use_highbitdepth)
 #endif
       {
-        double y, u, v, frame_all;
-        frame_all = vpx_calc_fastssim(cpi->Source, cm->frame_to_show, &y, &u,
-                                      &v);
-        adjust_image_stat(y, u, v, frame_all, &cpi->fastssim);
-        
+        adjust_image_stat(metrics.fastssim[1], metrics.fastssim[2],
+                          metrics.fastssim[3], metrics.fastssim[0],
+                          &cpi->fastssim);
       }
 #if CONFIG_VP9_HIGHBITDEPTH
       if (!cm->use_highbitdepth)
 #endif
       {
-        double y, u, v, frame_all;
-        frame_all = vpx_psnrhvs(cpi->Source, cm->frame_to_show, &y, &u, &v);
-        adjust_image_stat(y, u, v, frame_all, &cpi->psnrhvs);
+        adjust_image_stat(metrics.psnrhvs[1], metrics.psnrhvs[2],
+                          metrics.psnrhvs[3], metrics.psnrhvs[0],
+                          &cpi->psnrhvs);
       }
     }
   }
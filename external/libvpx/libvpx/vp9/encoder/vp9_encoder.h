@@ -27,6 +27,7 @@
 #include "vp9/common/vp9_entropymode.h"
 #include "vp9/common/vp9_thread_common.h"
 #include "vp9/common/vp9_onyxc_int.h"
+#include "vp9/common/vp9_stage_timing.h"
 
 #include "vp9/encoder/vp9_aq_cyclicrefresh.h"
 #include "vp9/encoder/vp9_context_tree.h"
@@ -40,6 +41,7 @@
 #include "vp9/encoder/vp9_rd.h"
 #include "vp9/encoder/vp9_speed_features.h"
 #include "vp9/encoder/vp9_svc_layercontext.h"
+#include "vp9/encoder/vp9_temporal_filter.h"
 #include "vp9/encoder/vp9_tokenize.h"
 
 #if CONFIG_VP9_TEMPORAL_DENOISING
@@ -231,6 +233,7 @@ typedef struct VP9EncoderConfig {
 #endif
   vpx_color_space_t color_space;
   VP9E_TEMPORAL_LAYERING_MODE temporal_layering_mode;
+  int svc_reuse_lower_layer;
 } VP9EncoderConfig;
 
 static INLINE int is_lossless_requested(const VP9EncoderConfig *cfg) {
@@ -257,6 +260,8 @@ typedef struct ThreadData {
   PICK_MODE_CONTEXT *leaf_tree;
   PC_TREE *pc_tree;
   PC_TREE *pc_root;
+
+  uint64_t stage_ticks[VPX_STAGE_COUNT];
 } ThreadData;
 
 struct EncWorkerData;
@@ -296,6 +301,7 @@ typedef struct VP9_COMP {
   YV12_BUFFER_CONFIG scaled_source;
   YV12_BUFFER_CONFIG *unscaled_last_source;
   YV12_BUFFER_CONFIG scaled_last_source;
+  const MV *pyramid_mvs;
 
   TileDataEnc *tile_data;
   int allocated_tiles;  
@@ -383,6 +389,7 @@ typedef struct VP9_COMP {
   uint64_t time_compress_data;
   uint64_t time_pick_lpf;
   uint64_t time_encode_sb_row;
+  uint64_t time_temporal_filter;
 
 #if CONFIG_FP_MB_STATS
   int use_fp_mb_stats;
@@ -391,6 +398,7 @@ typedef struct VP9_COMP {
   TWO_PASS twopass;
 
   YV12_BUFFER_CONFIG alt_ref_buffer;
+  ARNRFilterData arnr_filter_data;
 
 
 #if CONFIG_INTERNAL_STATS
@@ -491,6 +499,9 @@ typedef struct VP9_COMP {
   VPxWorker *workers;
   struct EncWorkerData *tile_thr_data;
   VP9LfSync lf_row_sync;
+
+  int stage_timing_enabled;
+  vpx_stage_timing_t stage_timing;
 } VP9_COMP;
 
 void vp9_initialize_enc(void);
@@ -606,6 +617,10 @@ YV12_BUFFER_CONFIG *vp9_scale_if_required(VP9_COMMON *cm,
                                           YV12_BUFFER_CONFIG *unscaled,
                                           YV12_BUFFER_CONFIG *scaled);
 
+void vp9_scale_and_extend_source(const VP9_COMMON *cm,
+                                 const YV12_BUFFER_CONFIG *unscaled,
+                                 YV12_BUFFER_CONFIG *scaled);
+
 void vp9_apply_encoding_flags(VP9_COMP *cpi, vpx_enc_frame_flags_t flags);
 
 static INLINE int is_two_pass_svc(const struct VP9_COMP *const cpi) {
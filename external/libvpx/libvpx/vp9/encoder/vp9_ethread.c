@@ -41,7 +41,7 @@ static int enc_worker_hook(EncWorkerData *const thread_data, void *unused) {
   (void) unused;
 
   for (t = thread_data->start; t < tile_rows * tile_cols;
-      t += cpi->num_workers) {
+      t += thread_data->num_workers) {
     int tile_row = t / tile_cols;
     int tile_col = t % tile_cols;
 
@@ -51,16 +51,53 @@ static int enc_worker_hook(EncWorkerData *const thread_data, void *unused) {
   return 0;
 }
 
-static int get_max_tile_cols(VP9_COMP *cpi) {
-  const int aligned_width = ALIGN_POWER_OF_TWO(cpi->oxcf.width, MI_SIZE_LOG2);
-  int mi_cols = aligned_width >> MI_SIZE_LOG2;
-  int min_log2_tile_cols, max_log2_tile_cols;
-  int log2_tile_cols;
+static void create_enc_workers(VP9_COMP *cpi) {
+  VP9_COMMON *const cm = &cpi->common;
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  const int allocated_workers = cpi->oxcf.max_threads;
+  int i;
+
+  if (cpi->num_workers != 0)
+    return;
+
+  CHECK_MEM_ERROR(cm, cpi->workers,
+                  vpx_malloc(allocated_workers * sizeof(*cpi->workers)));
+
+  CHECK_MEM_ERROR(cm, cpi->tile_thr_data,
+                  vpx_calloc(allocated_workers,
+                  sizeof(*cpi->tile_thr_data)));
+
+  for (i = 0; i < allocated_workers; i++) {
+    VPxWorker *const worker = &cpi->workers[i];
+    EncWorkerData *thread_data = &cpi->tile_thr_data[i];
+
+    ++cpi->num_workers;
+    winterface->init(worker);
+
+    if (i < allocated_workers - 1) {
+      thread_data->cpi = cpi;
+
+      CHECK_MEM_ERROR(cm, thread_data->td,
+                      vpx_memalign(32, sizeof(*thread_data->td)));
+      vp9_zero(*thread_data->td);
+
+      thread_data->td->leaf_tree = NULL;
+      thread_data->td->pc_tree = NULL;
+      vp9_setup_pc_tree(cm, thread_data->td);
+
+      CHECK_MEM_ERROR(cm, thread_data->td->counts,
+                      vpx_calloc(1, sizeof(*thread_data->td->counts)));
 
-  vp9_get_tile_n_bits(mi_cols, &min_log2_tile_cols, &max_log2_tile_cols);
-  log2_tile_cols = clamp(cpi->oxcf.tile_columns,
-                   min_log2_tile_cols, max_log2_tile_cols);
-  return (1 << log2_tile_cols);
+      if (!winterface->reset(worker))
+        vpx_internal_error(&cm->error, VPX_CODEC_ERROR,
+                           "Tile encoder thread creation failed");
+    } else {
+      thread_data->cpi = cpi;
+      thread_data->td = &cpi->td;
+    }
+
+    winterface->sync(worker);
+  }
 }
 
 void vp9_encode_tiles_mt(VP9_COMP *cpi) {
@@ -72,61 +109,7 @@ void vp9_encode_tiles_mt(VP9_COMP *cpi) {
 
   vp9_init_tile_data(cpi);
 
-  
-  if (cpi->num_workers == 0) {
-    int allocated_workers = num_workers;
-
-    
-    
-    if (cpi->use_svc) {
-      int max_tile_cols = get_max_tile_cols(cpi);
-      allocated_workers = MIN(cpi->oxcf.max_threads, max_tile_cols);
-    }
-
-    CHECK_MEM_ERROR(cm, cpi->workers,
-                    vpx_malloc(allocated_workers * sizeof(*cpi->workers)));
-
-    CHECK_MEM_ERROR(cm, cpi->tile_thr_data,
-                    vpx_calloc(allocated_workers,
-                    sizeof(*cpi->tile_thr_data)));
-
-    for (i = 0; i < allocated_workers; i++) {
-      VPxWorker *const worker = &cpi->workers[i];
-      EncWorkerData *thread_data = &cpi->tile_thr_data[i];
-
-      ++cpi->num_workers;
-      winterface->init(worker);
-
-      if (i < allocated_workers - 1) {
-        thread_data->cpi = cpi;
-
-        
-        CHECK_MEM_ERROR(cm, thread_data->td,
-                        vpx_memalign(32, sizeof(*thread_data->td)));
-        vp9_zero(*thread_data->td);
-
-        
-        thread_data->td->leaf_tree = NULL;
-        thread_data->td->pc_tree = NULL;
-        vp9_setup_pc_tree(cm, thread_data->td);
-
-        
-        CHECK_MEM_ERROR(cm, thread_data->td->counts,
-                        vpx_calloc(1, sizeof(*thread_data->td->counts)));
-
-        
-        if (!winterface->reset(worker))
-          vpx_internal_error(&cm->error, VPX_CODEC_ERROR,
-                             "Tile encoder thread creation failed");
-      } else {
-        
-        thread_data->cpi = cpi;
-        thread_data->td = &cpi->td;
-      }
-
-      winterface->sync(worker);
-    }
-  }
+  create_enc_workers(cpi);
 
   for (i = 0; i < num_workers; i++) {
     VPxWorker *const worker = &cpi->workers[i];
@@ -141,6 +124,8 @@ void vp9_encode_tiles_mt(VP9_COMP *cpi) {
     if (thread_data->td != &cpi->td) {
       thread_data->td->mb = cpi->td.mb;
       thread_data->td->rd_counts = cpi->td.rd_counts;
+      thread_data->td->mb.e_mbd.stage_ticks =
+          cpi->td.mb.e_mbd.stage_ticks ? thread_data->td->stage_ticks : NULL;
     }
     if (thread_data->td->counts != &cpi->common.counts) {
       memcpy(thread_data->td->counts, &cpi->common.counts,
@@ -172,6 +157,7 @@ void vp9_encode_tiles_mt(VP9_COMP *cpi) {
 
     
     thread_data->start = i;
+    thread_data->num_workers = num_workers;
 
     if (i == cpi->num_workers - 1)
       winterface->execute(worker);
@@ -193,6 +179,116 @@ void vp9_encode_tiles_mt(VP9_COMP *cpi) {
     if (i < cpi->num_workers - 1) {
       vp9_accumulate_frame_counts(cm, thread_data->td->counts, 0);
       accumulate_rd_opt(&cpi->td, thread_data->td);
+      if (cpi->td.mb.e_mbd.stage_ticks)
+        vp9_stage_ticks_add(cpi->td.stage_ticks, thread_data->td->stage_ticks);
     }
   }
 }
+
+static int temporal_filter_worker_hook(EncWorkerData *const thread_data,
+                                       void *unused) {
+  VP9_COMP *const cpi = thread_data->cpi;
+  const ARNRFilterData *const arnr_filter_data = &cpi->arnr_filter_data;
+  const YV12_BUFFER_CONFIG *const f =
+      arnr_filter_data->frames[arnr_filter_data->alt_ref_index];
+  const int mb_rows = (f->y_crop_height + 15) >> 4;
+  int mb_row;
+
+  (void) unused;
+
+  for (mb_row = thread_data->start; mb_row < mb_rows;
+       mb_row += thread_data->num_workers)
+    vp9_temporal_filter_iterate_row_c(cpi, thread_data->td, mb_row);
+
+  return 0;
+}
+
+void vp9_temporal_filter_row_mt(VP9_COMP *cpi) {
+  const ARNRFilterData *const arnr_filter_data = &cpi->arnr_filter_data;
+  const YV12_BUFFER_CONFIG *const f =
+      arnr_filter_data->frames[arnr_filter_data->alt_ref_index];
+  const int mb_rows = (f->y_crop_height + 15) >> 4;
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  int num_workers;
+  int i;
+
+  create_enc_workers(cpi);
+  num_workers = MIN(cpi->num_workers, mb_rows);
+
+  for (i = 0; i < num_workers; i++) {
+    VPxWorker *const worker = &cpi->workers[i];
+    EncWorkerData *const thread_data = &cpi->tile_thr_data[i];
+
+    worker->hook = (VPxWorkerHook)temporal_filter_worker_hook;
+    worker->data1 = thread_data;
+    worker->data2 = NULL;
+
+    if (thread_data->td != &cpi->td)
+      thread_data->td->mb = cpi->td.mb;
+
+    thread_data->start = i;
+    thread_data->num_workers = num_workers;
+  }
+
+  for (i = 0; i < num_workers; i++) {
+    VPxWorker *const worker = &cpi->workers[i];
+
+    if (i == cpi->num_workers - 1)
+      winterface->execute(worker);
+    else
+      winterface->launch(worker);
+  }
+
+  for (i = 0; i < num_workers; i++) {
+    VPxWorker *const worker = &cpi->workers[i];
+    winterface->sync(worker);
+  }
+}
+
+static int scale_layer_worker_hook(EncWorkerData *const thread_data,
+                                   void *unused) {
+  VP9_COMP *const cpi = thread_data->cpi;
+  int i;
+
+  (void) unused;
+
+  for (i = thread_data->start; i < cpi->svc.num_scaled_layers;
+       i += thread_data->num_workers)
+    vp9_svc_scale_layer_source(cpi, i);
+
+  return 0;
+}
+
+void vp9_svc_scale_layer_sources_mt(VP9_COMP *cpi) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  int num_workers;
+  int i;
+
+  create_enc_workers(cpi);
+  num_workers = MIN(cpi->num_workers, cpi->svc.num_scaled_layers);
+
+  for (i = 0; i < num_workers; i++) {
+    VPxWorker *const worker = &cpi->workers[i];
+    EncWorkerData *const thread_data = &cpi->tile_thr_data[i];
+
+    worker->hook = (VPxWorkerHook)scale_layer_worker_hook;
+    worker->data1 = thread_data;
+    worker->data2 = NULL;
+    thread_data->start = i;
+    thread_data->num_workers = num_workers;
+  }
+
+  for (i = 0; i < num_workers; i++) {
+    VPxWorker *const worker = &cpi->workers[i];
+
+    if (i == cpi->num_workers - 1)
+      winterface->execute(worker);
+    else
+      winterface->launch(worker);
+  }
+
+  for (i = 0; i < num_workers; i++) {
+    VPxWorker *const worker = &cpi->workers[i];
+    winterface->sync(worker);
+  }
+}
@@ -18,8 +18,13 @@ typedef struct EncWorkerData {
   struct VP9_COMP *cpi;
   struct ThreadData *td;
   int start;
+  int num_workers;
 } EncWorkerData;
 
 void vp9_encode_tiles_mt(struct VP9_COMP *cpi);
 
+void vp9_temporal_filter_row_mt(struct VP9_COMP *cpi);
+
+void vp9_svc_scale_layer_sources_mt(struct VP9_COMP *cpi);
+
 #endif  
@@ -55,6 +55,7 @@
 #define MIN_DECAY_FACTOR    0.01
 #define MIN_KF_BOOST        300
 #define NEW_MV_MODE_PENALTY 32
+#define PYRAMID_STEP_PARAM  (MAX_MVSEARCH_STEPS - 3)
 #define SVC_FACTOR_PT_LOW   0.45
 #define DARK_THRESH         64
 #define DEFAULT_GRP_WEIGHT  1.0
@@ -378,21 +379,17 @@ static int get_search_range(const VP9_COMP *cpi) {
 }
 
 static void first_pass_motion_search(VP9_COMP *cpi, MACROBLOCK *x,
-                                     const MV *ref_mv, MV *best_mv,
+                                     const MV *ref_mv, const MV *start_mv,
+                                     int step_param, MV *best_mv,
                                      int *best_motion_err) {
   MACROBLOCKD *const xd = &x->e_mbd;
   MV tmp_mv = {0, 0};
-  MV ref_mv_full = {ref_mv->row >> 3, ref_mv->col >> 3};
+  MV ref_mv_full = {start_mv->row >> 3, start_mv->col >> 3};
   int num00, tmp_err, n;
   const BLOCK_SIZE bsize = xd->mi[0]->mbmi.sb_type;
   vp9_variance_fn_ptr_t v_fn_ptr = cpi->fn_ptr[bsize];
   const int new_mv_mode_penalty = NEW_MV_MODE_PENALTY;
-
-  int step_param = 3;
-  int further_steps = (MAX_MVSEARCH_STEPS - 1) - step_param;
-  const int sr = get_search_range(cpi);
-  step_param += sr;
-  further_steps -= sr;
+  const int further_steps = (MAX_MVSEARCH_STEPS - 1) - step_param;
 
   
   v_fn_ptr.vf = get_block_variance_fn(bsize);
@@ -517,6 +514,9 @@ void vp9_first_pass(VP9_COMP *cpi, const struct lookahead_entry *source) {
   YV12_BUFFER_CONFIG *gld_yv12 = get_ref_frame_buffer(cpi, GOLDEN_FRAME);
   YV12_BUFFER_CONFIG *const new_yv12 = get_frame_new_buffer(cm);
   const YV12_BUFFER_CONFIG *first_ref_buf = lst_yv12;
+  const int step_param = 3 + get_search_range(cpi);
+  const MV *const pyramid_mvs =
+      cpi->Source == cpi->un_scaled_source ? cpi->pyramid_mvs : NULL;
 
   LAYER_CONTEXT *const lc = is_two_pass_svc(cpi) ?
         &cpi->svc.layer_context[cpi->svc.spatial_layer_id] : NULL;
@@ -784,15 +784,39 @@ void vp9_first_pass(VP9_COMP *cpi, const struct lookahead_entry *source) {
 
         
         if (raw_motion_error > 25 || lc != NULL) {
-          
-          
-          first_pass_motion_search(cpi, x, &best_ref_mv, &mv, &motion_error);
+          const int use_pyramid_seed = pyramid_mvs != NULL && lc == NULL;
+
+          if (use_pyramid_seed) {
+            const MV *const seed_mv =
+                &pyramid_mvs[mb_row * cm->mb_cols + mb_col];
+
+            first_pass_motion_search(cpi, x, &best_ref_mv, seed_mv,
+                                     PYRAMID_STEP_PARAM, &mv, &motion_error);
+
+            if ((best_ref_mv.row >> 3) != (seed_mv->row >> 3) ||
+                (best_ref_mv.col >> 3) != (seed_mv->col >> 3)) {
+              tmp_err = INT_MAX;
+              first_pass_motion_search(cpi, x, &best_ref_mv, &best_ref_mv,
+                                       PYRAMID_STEP_PARAM, &tmp_mv, &tmp_err);
+
+              if (tmp_err < motion_error) {
+                motion_error = tmp_err;
+                mv = tmp_mv;
+              }
+            }
+          } else {
+            
+            
+            first_pass_motion_search(cpi, x, &best_ref_mv, &best_ref_mv,
+                                     step_param, &mv, &motion_error);
+          }
 
           
           
-          if (!is_zero_mv(&best_ref_mv)) {
+          if (!is_zero_mv(&best_ref_mv) && !use_pyramid_seed) {
             tmp_err = INT_MAX;
-            first_pass_motion_search(cpi, x, &zero_mv, &tmp_mv, &tmp_err);
+            first_pass_motion_search(cpi, x, &zero_mv, &zero_mv, step_param,
+                                     &tmp_mv, &tmp_err);
 
             if (tmp_err < motion_error) {
               motion_error = tmp_err;
@@ -821,8 +845,8 @@ void vp9_first_pass(VP9_COMP *cpi, const struct lookahead_entry *source) {
                 bsize, &x->plane[0].src, &xd->plane[0].pre[0]);
 #endif  
 
-            first_pass_motion_search(cpi, x, &zero_mv, &tmp_mv,
-                                     &gf_motion_error);
+            first_pass_motion_search(cpi, x, &zero_mv, &zero_mv, step_param,
+                                     &tmp_mv, &gf_motion_error);
 
             if (gf_motion_error < motion_error && gf_motion_error < this_error)
               ++second_ref_count;
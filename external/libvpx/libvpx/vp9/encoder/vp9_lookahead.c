@@ -12,6 +12,8 @@
 
 #include "./vpx_config.h"
 
+#include "vpx_mem/vpx_mem.h"
+
 #include "vp9/common/vp9_common.h"
 
 #include "vp9/encoder/vp9_encoder.h"
@@ -31,13 +33,115 @@ static struct lookahead_entry *pop(struct lookahead_ctx *ctx,
 }
 
 
+static void free_pyramid_plane(struct lookahead_plane *plane) {
+  vpx_free(plane->buffer_alloc);
+  memset(plane, 0, sizeof(*plane));
+}
+
+static int alloc_pyramid_plane(struct lookahead_plane *plane,
+                               int width, int height) {
+  const int border = LOOKAHEAD_PYRAMID_BORDER;
+  const int stride = (width + 2 * border + 31) & ~31;
+
+  if (plane->buffer_alloc && plane->width == width &&
+      plane->height == height)
+    return 0;
+
+  free_pyramid_plane(plane);
+  plane->buffer_alloc =
+      (uint8_t *)vpx_memalign(32, (size_t)stride * (height + 2 * border));
+  if (!plane->buffer_alloc)
+    return 1;
+
+  plane->width = width;
+  plane->height = height;
+  plane->stride = stride;
+  plane->buf = plane->buffer_alloc + border * stride + border;
+  return 0;
+}
+
+static void extend_pyramid_plane(struct lookahead_plane *plane) {
+  const int border = LOOKAHEAD_PYRAMID_BORDER;
+  const int stride = plane->stride;
+  const int right = stride - border - plane->width;
+  uint8_t *row = plane->buf;
+  uint8_t *first, *last;
+  int r;
+
+  for (r = 0; r < plane->height; ++r, row += stride) {
+    memset(row - border, row[0], border);
+    memset(row + plane->width, row[plane->width - 1], right);
+  }
+
+  first = plane->buf - border;
+  last = first + (plane->height - 1) * stride;
+  for (r = 1; r <= border; ++r) {
+    memcpy(first - r * stride, first, stride);
+    memcpy(last + r * stride, last, stride);
+  }
+}
+
+static void downscale_pyramid_plane(const uint8_t *src, int src_stride,
+                                    struct lookahead_plane *dst) {
+  uint8_t *d = dst->buf;
+  int r, c;
+
+  for (r = 0; r < dst->height; ++r) {
+    const uint8_t *s0 = src + 2 * r * src_stride;
+    const uint8_t *s1 = s0 + src_stride;
+
+    for (c = 0; c < dst->width; ++c)
+      d[c] = (s0[2 * c] + s0[2 * c + 1] + s1[2 * c] + s1[2 * c + 1] + 2) >> 2;
+    d += dst->stride;
+  }
+  extend_pyramid_plane(dst);
+}
+
+int vp9_lookahead_build_pyramid(struct lookahead_entry *entry) {
+  const uint8_t *src = entry->img.y_buffer;
+  int src_stride = entry->img.y_stride;
+  int width = entry->img.y_crop_width;
+  int height = entry->img.y_crop_height;
+  int i;
+
+  if (entry->pyramid_valid)
+    return 0;
+
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (entry->img.flags & YV12_FLAG_HIGHBITDEPTH)
+    return 1;
+#endif
+
+  for (i = 0; i < LOOKAHEAD_PYRAMID_LEVELS; ++i) {
+    struct lookahead_plane *const plane = &entry->pyramid[i];
+
+    width = (width + 1) >> 1;
+    height = (height + 1) >> 1;
+    if (alloc_pyramid_plane(plane, width, height))
+      return 1;
+
+    downscale_pyramid_plane(src, src_stride, plane);
+    src = plane->buf;
+    src_stride = plane->stride;
+  }
+
+  entry->pyramid_valid = 1;
+  return 0;
+}
+
 void vp9_lookahead_destroy(struct lookahead_ctx *ctx) {
   if (ctx) {
     if (ctx->buf) {
       unsigned int i;
 
-      for (i = 0; i < ctx->max_sz; i++)
+      for (i = 0; i < ctx->max_sz; i++) {
+        int j;
+
         vpx_free_frame_buffer(&ctx->buf[i].img);
+        for (j = 0; j < LOOKAHEAD_PYRAMID_LEVELS; j++)
+          free_pyramid_plane(&ctx->buf[i].pyramid[j]);
+        vpx_free(ctx->buf[i].mvs);
+      }
       free(ctx->buf);
     }
     free(ctx);
@@ -198,6 +302,8 @@ int vp9_lookahead_push(struct lookahead_ctx *ctx, YV12_BUFFER_CONFIG   *src,
   buf->ts_start = ts_start;
   buf->ts_end = ts_end;
   buf->flags = flags;
+  buf->pyramid_valid = 0;
+  buf->mvs_valid = 0;
   return 0;
 }
 
@@ -13,6 +13,7 @@
 
 #include "vpx_scale/yv12config.h"
 #include "vpx/vpx_integer.h"
+#include "vp9/common/vp9_mv.h"
 
 #if CONFIG_SPATIAL_SVC
 #include "vpx/vp8cx.h"
@@ -25,11 +26,29 @@ extern "C" {
 
 #define MAX_LAG_BUFFERS 25
 
+#define LOOKAHEAD_PYRAMID_LEVELS 2
+#define LOOKAHEAD_PYRAMID_BORDER 96
+
+struct lookahead_plane {
+  uint8_t *buffer_alloc;
+  uint8_t *buf;
+  int width;
+  int height;
+  int stride;
+};
+
 struct lookahead_entry {
   YV12_BUFFER_CONFIG  img;
   int64_t             ts_start;
   int64_t             ts_end;
   unsigned int        flags;
+  struct lookahead_plane pyramid[LOOKAHEAD_PYRAMID_LEVELS];
+  int                 pyramid_valid;
+  MV                  *mvs;
+  int                 mvs_size;
+  int                 mvs_valid;
+  const struct lookahead_entry *mvs_ref;
+  int64_t             mvs_ref_ts;
 };
 
 #define MAX_PRE_FRAMES 1
@@ -73,6 +92,9 @@ struct lookahead_entry *vp9_lookahead_peek(struct lookahead_ctx *ctx,
 
 unsigned int vp9_lookahead_depth(struct lookahead_ctx *ctx);
 
+
+int vp9_lookahead_build_pyramid(struct lookahead_entry *entry);
+
 #ifdef __cplusplus
 }  
 #endif
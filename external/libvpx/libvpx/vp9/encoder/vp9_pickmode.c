@@ -128,9 +128,10 @@ static int combined_motion_search(VP9_COMP *cpi, MACROBLOCK *x,
   MACROBLOCKD *xd = &x->e_mbd;
   MB_MODE_INFO *mbmi = &xd->mi[0]->mbmi;
   struct buf_2d backup_yv12[MAX_MB_PLANE] = {{0, 0}};
-  const int step_param = cpi->sf.mv.fullpel_search_step_param;
+  int step_param = cpi->sf.mv.fullpel_search_step_param;
   const int sadpb = x->sadperbit16;
   MV mvp_full;
+  MV lower_mv;
   const int ref = mbmi->ref_frame[0];
   const MV ref_mv = x->mbmi_ext->ref_mvs[ref][0].as_mv;
   int dis;
@@ -141,6 +142,7 @@ static int combined_motion_search(VP9_COMP *cpi, MACROBLOCK *x,
   const int tmp_row_max = x->mv_row_max;
   int rv = 0;
   int cost_list[5];
+  const uint64_t t = vp9_stage_timer_start(xd->stage_ticks);
   const YV12_BUFFER_CONFIG *scaled_ref_frame = vp9_get_scaled_ref_frame(cpi,
                                                                         ref);
   if (scaled_ref_frame) {
@@ -163,6 +165,31 @@ static int combined_motion_search(VP9_COMP *cpi, MACROBLOCK *x,
   mvp_full.col >>= 3;
   mvp_full.row >>= 3;
 
+  if (ref == LAST_FRAME &&
+      vp9_svc_lower_layer_motion(cpi, mi_row, mi_col, bsize, &lower_mv,
+                                 NULL)) {
+    const struct buf_2d *const pre = &xd->plane[0].pre[0];
+    const struct buf_2d *const src = &x->plane[0].src;
+    unsigned int sad, lower_sad;
+
+    lower_mv.row >>= 3;
+    lower_mv.col >>= 3;
+    clamp_mv(&lower_mv, x->mv_col_min, x->mv_col_max,
+             x->mv_row_min, x->mv_row_max);
+    clamp_mv(&mvp_full, x->mv_col_min, x->mv_col_max,
+             x->mv_row_min, x->mv_row_max);
+    sad = cpi->fn_ptr[bsize].sdf(src->buf, src->stride,
+                                 pre->buf + mvp_full.row * pre->stride +
+                                     mvp_full.col, pre->stride);
+    lower_sad = cpi->fn_ptr[bsize].sdf(src->buf, src->stride,
+                                       pre->buf + lower_mv.row * pre->stride +
+                                           lower_mv.col, pre->stride);
+    if (lower_sad <= sad) {
+      mvp_full = lower_mv;
+      step_param = MAX(step_param, MAX_MVSEARCH_STEPS - 3);
+    }
+  }
+
   vp9_full_pixel_search(cpi, x, bsize, &mvp_full, step_param, sadpb,
                         cond_cost_list(cpi, cost_list),
                         &ref_mv, &tmp_mv->as_mv, INT_MAX, 0);
@@ -203,6 +230,7 @@ static int combined_motion_search(VP9_COMP *cpi, MACROBLOCK *x,
     for (i = 0; i < MAX_MB_PLANE; i++)
       xd->plane[i].pre[0] = backup_yv12[i];
   }
+  vp9_stage_timer_end(xd->stage_ticks, VPX_STAGE_MOTION_SEARCH, t);
   return rv;
 }
 
@@ -1254,11 +1282,14 @@ void vp9_pick_inter_mode(VP9_COMP *cpi, MACROBLOCK *x,
       if (ref_frame > LAST_FRAME && !cpi->use_svc) {
         int tmp_sad;
         int dis, cost_list[5];
+        uint64_t t;
 
         if (bsize < BLOCK_16X16)
           continue;
 
+        t = vp9_stage_timer_start(xd->stage_ticks);
         tmp_sad = vp9_int_pro_motion_estimation(cpi, x, bsize, mi_row, mi_col);
+        vp9_stage_timer_end(xd->stage_ticks, VPX_STAGE_MOTION_SEARCH, t);
 
         if (tmp_sad > x->pred_mv_sad[LAST_FRAME])
           continue;
@@ -1272,6 +1303,7 @@ void vp9_pick_inter_mode(VP9_COMP *cpi, MACROBLOCK *x,
         frame_mv[NEWMV][ref_frame].as_mv.row >>= 3;
         frame_mv[NEWMV][ref_frame].as_mv.col >>= 3;
 
+        t = vp9_stage_timer_start(xd->stage_ticks);
         cpi->find_fractional_mv_step(x, &frame_mv[NEWMV][ref_frame].as_mv,
           &x->mbmi_ext->ref_mvs[ref_frame][0].as_mv,
           cpi->common.allow_high_precision_mv,
@@ -1282,6 +1314,7 @@ void vp9_pick_inter_mode(VP9_COMP *cpi, MACROBLOCK *x,
           cond_cost_list(cpi, cost_list),
           x->nmvjointcost, x->mvcost, &dis,
           &x->pred_sse[ref_frame], NULL, 0, 0);
+        vp9_stage_timer_end(xd->stage_ticks, VPX_STAGE_MOTION_SEARCH, t);
       } else if (!combined_motion_search(cpi, x, bsize, mi_row, mi_col,
         &frame_mv[NEWMV][ref_frame], &rate_mv, best_rdc.rdcost)) {
         continue;
@@ -1777,6 +1810,7 @@ void vp9_pick_inter_mode_sub8x8(VP9_COMP *cpi, MACROBLOCK *x,
             const int tmp_row_min = x->mv_row_min;
             const int tmp_row_max = x->mv_row_max;
             int dummy_dist;
+            uint64_t t;
 
             if (i == 0) {
               mvp_full.row = b_mv[NEARESTMV].as_mv.row >> 3;
@@ -1788,11 +1822,13 @@ void vp9_pick_inter_mode_sub8x8(VP9_COMP *cpi, MACROBLOCK *x,
 
             vp9_set_mv_search_range(x, &mbmi_ext->ref_mvs[0]->as_mv);
 
+            t = vp9_stage_timer_start(xd->stage_ticks);
             vp9_full_pixel_search(
                 cpi, x, bsize, &mvp_full, step_param, x->sadperbit4,
                 cond_cost_list(cpi, cost_list),
                 &mbmi_ext->ref_mvs[ref_frame][0].as_mv, &tmp_mv,
                 INT_MAX, 0);
+            vp9_stage_timer_end(xd->stage_ticks, VPX_STAGE_MOTION_SEARCH, t);
 
             x->mv_col_min = tmp_col_min;
             x->mv_col_max = tmp_col_max;
@@ -1813,6 +1849,7 @@ void vp9_pick_inter_mode_sub8x8(VP9_COMP *cpi, MACROBLOCK *x,
             if (RDCOST(x->rdmult, x->rddiv, b_rate, 0) > b_best_rd)
               continue;
 
+            t = vp9_stage_timer_start(xd->stage_ticks);
             cpi->find_fractional_mv_step(x, &tmp_mv,
                                          &mbmi_ext->ref_mvs[ref_frame][0].as_mv,
                                          cpi->common.allow_high_precision_mv,
@@ -1824,6 +1861,7 @@ void vp9_pick_inter_mode_sub8x8(VP9_COMP *cpi, MACROBLOCK *x,
                                          x->nmvjointcost, x->mvcost,
                                          &dummy_dist,
                                          &x->pred_sse[ref_frame], NULL, 0, 0);
+            vp9_stage_timer_end(xd->stage_ticks, VPX_STAGE_MOTION_SEARCH, t);
 
             xd->mi[0]->bmi[i].as_mv[0].as_mv = tmp_mv;
           } else {
@@ -0,0 +1,179 @@
+/*
+ *  Copyright (c) 2016 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <limits.h>
+
+#include "./vpx_dsp_rtcd.h"
+
+#include "vpx_mem/vpx_mem.h"
+
+#include "vp9/common/vp9_common.h"
+#include "vp9/encoder/vp9_pyramid_me.h"
+
+#define COARSE_SEARCH_RANGE 4
+#define COARSE_MAX_MV 30
+
+typedef unsigned int (*pyramid_sad_fn_t)(const uint8_t *src, int src_stride,
+                                         const uint8_t *ref, int ref_stride);
+
+static void refine_mv(const uint8_t *src, int src_stride,
+                      const uint8_t *ref, int ref_stride,
+                      pyramid_sad_fn_t sdf, int range,
+                      MV *best_mv, unsigned int *best_sad) {
+  const MV center = *best_mv;
+  int r, c;
+
+  for (r = -range; r <= range; ++r) {
+    for (c = -range; c <= range; ++c) {
+      const MV mv = { center.row + r, center.col + c };
+      unsigned int sad;
+
+      if (r == 0 && c == 0 && *best_sad != UINT_MAX)
+        continue;
+
+      sad = sdf(src, src_stride, ref + mv.row * ref_stride + mv.col,
+                ref_stride);
+      if (sad < *best_sad) {
+        *best_sad = sad;
+        *best_mv = mv;
+      }
+    }
+  }
+}
+
+static void clamp_coarse_mv(MV *mv) {
+  mv->row = clamp(mv->row, -COARSE_MAX_MV, COARSE_MAX_MV);
+  mv->col = clamp(mv->col, -COARSE_MAX_MV, COARSE_MAX_MV);
+}
+
+static void coarse_search(const struct lookahead_plane *src,
+                          const struct lookahead_plane *ref,
+                          int mb_rows, int mb_cols, MV *mvs) {
+  int mb_row, mb_col;
+
+  for (mb_row = 0; mb_row < mb_rows; ++mb_row) {
+    for (mb_col = 0; mb_col < mb_cols; ++mb_col) {
+      const int offset_row = mb_row * 4 - 2;
+      const int offset_col = mb_col * 4 - 2;
+      const uint8_t *const s =
+          src->buf + offset_row * src->stride + offset_col;
+      const uint8_t *const r =
+          ref->buf + offset_row * ref->stride + offset_col;
+      MV best_mv = { 0, 0 };
+      unsigned int best_sad = UINT_MAX;
+
+      refine_mv(s, src->stride, r, ref->stride, vpx_sad8x8,
+                COARSE_SEARCH_RANGE, &best_mv, &best_sad);
+
+      if (mb_col > 0) {
+        MV mv = mvs[mb_row * mb_cols + mb_col - 1];
+        unsigned int sad = UINT_MAX;
+
+        refine_mv(s, src->stride, r, ref->stride, vpx_sad8x8, 1, &mv, &sad);
+        if (sad < best_sad) {
+          best_sad = sad;
+          best_mv = mv;
+        }
+      }
+
+      if (mb_row > 0) {
+        MV mv = mvs[(mb_row - 1) * mb_cols + mb_col];
+        unsigned int sad = UINT_MAX;
+
+        refine_mv(s, src->stride, r, ref->stride, vpx_sad8x8, 1, &mv, &sad);
+        if (sad < best_sad) {
+          best_sad = sad;
+          best_mv = mv;
+        }
+      }
+
+      clamp_coarse_mv(&best_mv);
+      mvs[mb_row * mb_cols + mb_col] = best_mv;
+    }
+  }
+}
+
+static void refine_level(const uint8_t *src, int src_stride,
+                         const uint8_t *ref, int ref_stride,
+                         pyramid_sad_fn_t sdf, int bsize,
+                         int mb_rows, int mb_cols, MV *mvs) {
+  int mb_row, mb_col;
+
+  for (mb_row = 0; mb_row < mb_rows; ++mb_row) {
+    for (mb_col = 0; mb_col < mb_cols; ++mb_col) {
+      const int offset_row = mb_row * bsize;
+      const int offset_col = mb_col * bsize;
+      MV *const mv = &mvs[mb_row * mb_cols + mb_col];
+      unsigned int best_sad = UINT_MAX;
+
+      mv->row *= 2;
+      mv->col *= 2;
+      refine_mv(src + offset_row * src_stride + offset_col, src_stride,
+                ref + offset_row * ref_stride + offset_col, ref_stride,
+                sdf, 1, mv, &best_sad);
+    }
+  }
+}
+
+int vp9_pyramid_motion_search(struct lookahead_entry *src,
+                              struct lookahead_entry *ref, MV *mvs) {
+  const int mb_rows = (src->img.y_crop_height + 15) >> 4;
+  const int mb_cols = (src->img.y_crop_width + 15) >> 4;
+  int i;
+
+  if (src->img.y_crop_width != ref->img.y_crop_width ||
+      src->img.y_crop_height != ref->img.y_crop_height)
+    return 1;
+
+  if (vp9_lookahead_build_pyramid(src) || vp9_lookahead_build_pyramid(ref))
+    return 1;
+
+  coarse_search(&src->pyramid[1], &ref->pyramid[1], mb_rows, mb_cols, mvs);
+  refine_level(src->pyramid[0].buf, src->pyramid[0].stride,
+               ref->pyramid[0].buf, ref->pyramid[0].stride,
+               vpx_sad8x8, 8, mb_rows, mb_cols, mvs);
+  refine_level(src->img.y_buffer, src->img.y_stride,
+               ref->img.y_buffer, ref->img.y_stride,
+               vpx_sad16x16, 16, mb_rows, mb_cols, mvs);
+
+  for (i = 0; i < mb_rows * mb_cols; ++i) {
+    mvs[i].row *= 8;
+    mvs[i].col *= 8;
+  }
+  return 0;
+}
+
+const MV *vp9_pyramid_me_get_mvs(struct lookahead_entry *cur,
+                                 struct lookahead_entry *prev) {
+  const int mb_rows = (cur->img.y_crop_height + 15) >> 4;
+  const int mb_cols = (cur->img.y_crop_width + 15) >> 4;
+
+  if (cur->mvs_valid && cur->mvs_ref == prev &&
+      cur->mvs_ref_ts == prev->ts_start)
+    return cur->mvs;
+
+  if (cur->mvs_size < mb_rows * mb_cols) {
+    vpx_free(cur->mvs);
+    cur->mvs_size = 0;
+    cur->mvs = (MV *)vpx_malloc(mb_rows * mb_cols * sizeof(*cur->mvs));
+    if (!cur->mvs)
+      return NULL;
+    cur->mvs_size = mb_rows * mb_cols;
+  }
+
+  cur->mvs_valid = 0;
+  if (vp9_pyramid_motion_search(cur, prev, cur->mvs))
+    return NULL;
+
+  cur->mvs_valid = 1;
+  cur->mvs_ref = prev;
+  cur->mvs_ref_ts = prev->ts_start;
+  return cur->mvs;
+}
@@ -0,0 +1,31 @@
+/*
+ *  Copyright (c) 2016 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VP9_ENCODER_VP9_PYRAMID_ME_H_
+#define VP9_ENCODER_VP9_PYRAMID_ME_H_
+
+#include "vp9/common/vp9_mv.h"
+#include "vp9/encoder/vp9_lookahead.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int vp9_pyramid_motion_search(struct lookahead_entry *src,
+                              struct lookahead_entry *ref, MV *mvs);
+
+const MV *vp9_pyramid_me_get_mvs(struct lookahead_entry *cur,
+                                 struct lookahead_entry *prev);
+
+#ifdef __cplusplus
+}  
+#endif
+
+#endif  
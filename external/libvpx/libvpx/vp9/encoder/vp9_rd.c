@@ -496,6 +496,37 @@ void vp9_mv_pred(VP9_COMP *cpi, MACROBLOCK *x,
     }
   }
 
+  if (ref_frame == LAST_FRAME && cpi->pyramid_mvs != NULL &&
+      cpi->Source == cpi->un_scaled_source) {
+    const VP9_COMMON *const cm = &cpi->common;
+    const MACROBLOCKD *const xd = &x->e_mbd;
+    const int mi_row = -xd->mb_to_top_edge >> (3 + MI_SIZE_LOG2);
+    const int mi_col = -xd->mb_to_left_edge >> (3 + MI_SIZE_LOG2);
+    const int mb_row = MIN((mi_row * MI_SIZE +
+                            (num_4x4_blocks_high_lookup[block_size] << 1)) >> 4,
+                           cm->mb_rows - 1);
+    const int mb_col = MIN((mi_col * MI_SIZE +
+                            (num_4x4_blocks_wide_lookup[block_size] << 1)) >> 4,
+                           cm->mb_cols - 1);
+    MV this_mv = cpi->pyramid_mvs[mb_row * cm->mb_cols + mb_col];
+    int fp_row, fp_col;
+
+    clamp_mv_ref(&this_mv, xd);
+    fp_row = this_mv.row >> 3;
+    fp_col = this_mv.col >> 3;
+    if (!(fp_row == 0 && fp_col == 0 && zero_seen)) {
+      ref_y_ptr = &ref_y_buffer[ref_y_stride * fp_row + fp_col];
+      this_sad = cpi->fn_ptr[block_size].sdf(src_y_ptr, x->plane[0].src.stride,
+                                             ref_y_ptr, ref_y_stride);
+      if (this_sad < best_sad) {
+        best_sad = this_sad;
+        best_index = 2;
+        x->pred_mv[ref_frame] = this_mv;
+        max_mv = MAX(max_mv, MAX(abs(this_mv.row), abs(this_mv.col)) >> 3);
+      }
+    }
+  }
+
   
   x->mv_best_ref_index[ref_frame] = best_index;
   x->max_mv_context[ref_frame] = max_mv;
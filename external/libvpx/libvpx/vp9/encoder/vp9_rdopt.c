@@ -1781,6 +1781,7 @@ static int64_t rd_pick_best_sub8x8_mode(VP9_COMP *cpi, MACROBLOCK *x,
           MV mvp_full;
           int max_mv;
           int cost_list[5];
+          uint64_t t;
 
           if (best_rd < label_mv_thresh)
             break;
@@ -1822,6 +1823,7 @@ static int64_t rd_pick_best_sub8x8_mode(VP9_COMP *cpi, MACROBLOCK *x,
 
           vp9_set_mv_search_range(x, &bsi->ref_mv[0]->as_mv);
 
+          t = vp9_stage_timer_start(xd->stage_ticks);
           bestsme = vp9_full_pixel_search(
               cpi, x, bsize, &mvp_full, step_param, sadpb,
               cpi->sf.mv.subpel_search_method != SUBPEL_TREE ? cost_list : NULL,
@@ -1868,6 +1870,7 @@ static int64_t rd_pick_best_sub8x8_mode(VP9_COMP *cpi, MACROBLOCK *x,
             
             seg_mvs[i][mbmi->ref_frame[0]].as_mv = *new_mv;
           }
+          vp9_stage_timer_end(xd->stage_ticks, VPX_STAGE_MOTION_SEARCH, t);
 
           if (cpi->sf.adaptive_motion_search)
             x->pred_mv[mbmi->ref_frame[0]] = *new_mv;
@@ -1888,9 +1891,11 @@ static int64_t rd_pick_best_sub8x8_mode(VP9_COMP *cpi, MACROBLOCK *x,
           mi_buf_shift(x, i);
           if (cpi->sf.comp_inter_joint_search_thresh <= bsize) {
             int rate_mv;
+            const uint64_t t = vp9_stage_timer_start(xd->stage_ticks);
             joint_motion_search(cpi, x, bsize, frame_mv[this_mode],
                                 mi_row, mi_col, seg_mvs[i],
                                 &rate_mv);
+            vp9_stage_timer_end(xd->stage_ticks, VPX_STAGE_MOTION_SEARCH, t);
             seg_mvs[i][mbmi->ref_frame[0]].as_int =
                 frame_mv[this_mode][mbmi->ref_frame[0]].as_int;
             seg_mvs[i][mbmi->ref_frame[1]].as_int =
@@ -2417,8 +2422,10 @@ static int64_t handle_inter_mode(VP9_COMP *cpi, MACROBLOCK *x,
       frame_mv[refs[1]].as_int = single_newmv[refs[1]].as_int;
 
       if (cpi->sf.comp_inter_joint_search_thresh <= bsize) {
+        const uint64_t t = vp9_stage_timer_start(xd->stage_ticks);
         joint_motion_search(cpi, x, bsize, frame_mv,
                             mi_row, mi_col, single_newmv, &rate_mv);
+        vp9_stage_timer_end(xd->stage_ticks, VPX_STAGE_MOTION_SEARCH, t);
       } else {
         rate_mv  = vp9_mv_bit_cost(&frame_mv[refs[0]].as_mv,
                                    &x->mbmi_ext->ref_mvs[refs[0]][0].as_mv,
@@ -2430,8 +2437,10 @@ static int64_t handle_inter_mode(VP9_COMP *cpi, MACROBLOCK *x,
       *rate2 += rate_mv;
     } else {
       int_mv tmp_mv;
+      const uint64_t t = vp9_stage_timer_start(xd->stage_ticks);
       single_motion_search(cpi, x, bsize, mi_row, mi_col,
                            &tmp_mv, &rate_mv);
+      vp9_stage_timer_end(xd->stage_ticks, VPX_STAGE_MOTION_SEARCH, t);
       if (tmp_mv.as_int == INVALID_MV)
         return INT64_MAX;
 
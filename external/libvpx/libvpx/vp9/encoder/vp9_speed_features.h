@@ -418,6 +418,9 @@ typedef struct SPEED_FEATURES {
 
   
   int simple_model_rd_from_var;
+
+  
+  int lookahead_pyramid_me;
 } SPEED_FEATURES;
 
 struct VP9_COMP;
@@ -10,7 +10,10 @@
 
 #include <math.h>
 
+#include "vpx_mem/vpx_mem.h"
+
 #include "vp9/encoder/vp9_encoder.h"
+#include "vp9/encoder/vp9_ethread.h"
 #include "vp9/encoder/vp9_svc_layercontext.h"
 #include "vp9/encoder/vp9_extend.h"
 
@@ -26,6 +29,8 @@ void vp9_init_layer_context(VP9_COMP *const cpi) {
 
   svc->spatial_layer_id = 0;
   svc->temporal_layer_id = 0;
+  svc->lower_layer_id = -1;
+  svc->scaled_layer_source_ready = 0;
 
   if (cpi->oxcf.error_resilient_mode == 0 && cpi->oxcf.pass == 2) {
     if (vpx_realloc_frame_buffer(&cpi->svc.empty_frame.img,
@@ -506,6 +511,169 @@ int vp9_one_pass_cbr_svc_start_layer(VP9_COMP *const cpi) {
   return 0;
 }
 
+static void scale_layer_sources(VP9_COMP *const cpi) {
+  VP9_COMMON *const cm = &cpi->common;
+  SVC *const svc = &cpi->svc;
+  const YV12_BUFFER_CONFIG *const src = cpi->un_scaled_source;
+  int sl;
+
+  svc->num_scaled_layers = 0;
+  for (sl = 0; sl < svc->number_spatial_layers; ++sl) {
+    const LAYER_CONTEXT *const lc =
+        &svc->layer_context[sl * svc->number_temporal_layers +
+                            svc->temporal_layer_id];
+    int width = 0, height = 0;
+
+    get_layer_resolution(cpi->oxcf.width, cpi->oxcf.height,
+                         lc->scaling_factor_num, lc->scaling_factor_den,
+                         &width, &height);
+    if (width == src->y_crop_width && height == src->y_crop_height)
+      continue;
+
+    if (vpx_realloc_frame_buffer(&svc->scaled_layer_source[sl],
+                                 width, height,
+                                 cm->subsampling_x, cm->subsampling_y,
+#if CONFIG_VP9_HIGHBITDEPTH
+                                 cm->use_highbitdepth,
+#endif
+                                 VP9_ENC_BORDER_IN_PIXELS,
+                                 cm->byte_alignment, NULL, NULL, NULL))
+      vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
+                         "Failed to allocate scaled layer source buffer");
+    svc->scaled_layer_list[svc->num_scaled_layers++] = sl;
+  }
+
+  if (cpi->oxcf.max_threads > 1 && svc->num_scaled_layers > 1) {
+    vp9_svc_scale_layer_sources_mt(cpi);
+  } else {
+    int i;
+    for (i = 0; i < svc->num_scaled_layers; ++i)
+      vp9_svc_scale_layer_source(cpi, i);
+  }
+
+  svc->scaled_layer_source_ts = cpi->last_time_stamp_seen;
+  svc->scaled_layer_source_ready = 1;
+}
+
+void vp9_svc_scale_layer_source(VP9_COMP *const cpi, int idx) {
+  SVC *const svc = &cpi->svc;
+  vp9_scale_and_extend_source(
+      &cpi->common, cpi->un_scaled_source,
+      &svc->scaled_layer_source[svc->scaled_layer_list[idx]]);
+}
+
+YV12_BUFFER_CONFIG *vp9_svc_get_scaled_source(VP9_COMP *const cpi) {
+  VP9_COMMON *const cm = &cpi->common;
+  SVC *const svc = &cpi->svc;
+  YV12_BUFFER_CONFIG *const buf =
+      &svc->scaled_layer_source[svc->spatial_layer_id];
+
+  if (cm->mi_cols * MI_SIZE == cpi->un_scaled_source->y_width &&
+      cm->mi_rows * MI_SIZE == cpi->un_scaled_source->y_height)
+    return cpi->un_scaled_source;
+
+  if (!svc->scaled_layer_source_ready ||
+      svc->scaled_layer_source_ts != cpi->last_time_stamp_seen)
+    scale_layer_sources(cpi);
+
+  if (buf->y_crop_width != cm->width || buf->y_crop_height != cm->height)
+    return vp9_scale_if_required(cm, cpi->un_scaled_source,
+                                 &cpi->scaled_source);
+  return buf;
+}
+
+void vp9_svc_save_layer_motion(VP9_COMP *const cpi) {
+  VP9_COMMON *const cm = &cpi->common;
+  SVC *const svc = &cpi->svc;
+  const int mi_size = cm->mi_rows * cm->mi_cols;
+  const int intra_only = frame_is_intra_only(cm);
+  int mi_row, mi_col;
+
+  if (svc->spatial_layer_id >= svc->number_spatial_layers - 1)
+    return;
+
+  if (mi_size > svc->lower_layer_mi_alloc) {
+    vpx_free(svc->lower_layer_mv);
+    vpx_free(svc->lower_layer_bsize);
+    svc->lower_layer_mi_alloc = 0;
+    CHECK_MEM_ERROR(cm, svc->lower_layer_mv,
+                    vpx_malloc(mi_size * sizeof(*svc->lower_layer_mv)));
+    CHECK_MEM_ERROR(cm, svc->lower_layer_bsize,
+                    vpx_malloc(mi_size * sizeof(*svc->lower_layer_bsize)));
+    svc->lower_layer_mi_alloc = mi_size;
+  }
+
+  for (mi_row = 0; mi_row < cm->mi_rows; ++mi_row) {
+    MODE_INFO **mi = cm->mi_grid_visible + mi_row * cm->mi_stride;
+    int_mv *mv = svc->lower_layer_mv + mi_row * cm->mi_cols;
+    uint8_t *bsize = svc->lower_layer_bsize + mi_row * cm->mi_cols;
+    for (mi_col = 0; mi_col < cm->mi_cols; ++mi_col) {
+      const MB_MODE_INFO *const mbmi = &mi[mi_col]->mbmi;
+      bsize[mi_col] = mbmi->sb_type;
+      mv[mi_col].as_int = (!intra_only && mbmi->ref_frame[0] == LAST_FRAME) ?
+                          mbmi->mv[0].as_int : INVALID_MV;
+    }
+  }
+
+  svc->lower_layer_mi_rows = cm->mi_rows;
+  svc->lower_layer_mi_cols = cm->mi_cols;
+  svc->lower_layer_width = cm->width;
+  svc->lower_layer_height = cm->height;
+  svc->lower_layer_id = svc->spatial_layer_id;
+  svc->lower_layer_ts = cpi->last_time_stamp_seen;
+}
+
+int vp9_svc_lower_layer_motion(const VP9_COMP *const cpi,
+                               int mi_row, int mi_col, BLOCK_SIZE bsize,
+                               MV *mv, BLOCK_SIZE *lower_bsize) {
+  const VP9_COMMON *const cm = &cpi->common;
+  const SVC *const svc = &cpi->svc;
+  int row, col, idx;
+  int_mv lower_mv;
+
+  if (!cpi->oxcf.svc_reuse_lower_layer || !is_one_pass_cbr_svc(cpi) ||
+      svc->spatial_layer_id == 0 ||
+      svc->lower_layer_id != svc->spatial_layer_id - 1 ||
+      svc->lower_layer_ts != cpi->last_time_stamp_seen ||
+      frame_is_intra_only(cm))
+    return 0;
+
+  row = (mi_row * MI_SIZE + num_8x8_blocks_high_lookup[bsize] * MI_SIZE / 2) *
+        svc->lower_layer_height / cm->height / MI_SIZE;
+  col = (mi_col * MI_SIZE + num_8x8_blocks_wide_lookup[bsize] * MI_SIZE / 2) *
+        svc->lower_layer_width / cm->width / MI_SIZE;
+  row = MIN(row, svc->lower_layer_mi_rows - 1);
+  col = MIN(col, svc->lower_layer_mi_cols - 1);
+  idx = row * svc->lower_layer_mi_cols + col;
+
+  lower_mv = svc->lower_layer_mv[idx];
+  if (lower_mv.as_int == INVALID_MV)
+    return 0;
+
+  mv->row = (int16_t)clamp(lower_mv.as_mv.row * cm->height /
+                           svc->lower_layer_height, MV_LOW + 1, MV_UPP - 1);
+  mv->col = (int16_t)clamp(lower_mv.as_mv.col * cm->width /
+                           svc->lower_layer_width, MV_LOW + 1, MV_UPP - 1);
+  if (lower_bsize != NULL)
+    *lower_bsize = (BLOCK_SIZE)svc->lower_layer_bsize[idx];
+  return 1;
+}
+
+void vp9_svc_free_layer_buffers(SVC *const svc) {
+  int i;
+
+  for (i = 0; i < VPX_SS_MAX_LAYERS; ++i)
+    vpx_free_frame_buffer(&svc->scaled_layer_source[i]);
+  svc->scaled_layer_source_ready = 0;
+
+  vpx_free(svc->lower_layer_mv);
+  svc->lower_layer_mv = NULL;
+  vpx_free(svc->lower_layer_bsize);
+  svc->lower_layer_bsize = NULL;
+  svc->lower_layer_mi_alloc = 0;
+  svc->lower_layer_id = -1;
+}
+
 #if CONFIG_SPATIAL_SVC
 int vp9_svc_start_frame(VP9_COMP *const cpi) {
   int width = 0, height = 0;
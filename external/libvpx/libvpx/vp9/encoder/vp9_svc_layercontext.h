@@ -13,6 +13,8 @@
 
 #include "vpx/vpx_encoder.h"
 
+#include "vp9/common/vp9_enums.h"
+#include "vp9/common/vp9_mv.h"
 #include "vp9/encoder/vp9_ratectrl.h"
 
 #ifdef __cplusplus
@@ -70,6 +72,22 @@ typedef struct {
   
   
   VP9E_TEMPORAL_LAYERING_MODE temporal_layering_mode;
+
+  YV12_BUFFER_CONFIG scaled_layer_source[VPX_SS_MAX_LAYERS];
+  int scaled_layer_list[VPX_SS_MAX_LAYERS];
+  int num_scaled_layers;
+  int64_t scaled_layer_source_ts;
+  int scaled_layer_source_ready;
+
+  int_mv *lower_layer_mv;
+  uint8_t *lower_layer_bsize;
+  int lower_layer_mi_alloc;
+  int lower_layer_mi_rows;
+  int lower_layer_mi_cols;
+  int lower_layer_width;
+  int lower_layer_height;
+  int lower_layer_id;
+  int64_t lower_layer_ts;
 } SVC;
 
 struct VP9_COMP;
@@ -102,6 +120,18 @@ int vp9_svc_start_frame(struct VP9_COMP *const cpi);
 
 int vp9_one_pass_cbr_svc_start_layer(struct VP9_COMP *const cpi);
 
+YV12_BUFFER_CONFIG *vp9_svc_get_scaled_source(struct VP9_COMP *const cpi);
+
+void vp9_svc_scale_layer_source(struct VP9_COMP *const cpi, int idx);
+
+void vp9_svc_save_layer_motion(struct VP9_COMP *const cpi);
+
+int vp9_svc_lower_layer_motion(const struct VP9_COMP *const cpi,
+                               int mi_row, int mi_col, BLOCK_SIZE bsize,
+                               MV *mv, BLOCK_SIZE *lower_bsize);
+
+void vp9_svc_free_layer_buffers(SVC *const svc);
+
 #ifdef __cplusplus
 }  
 #endif
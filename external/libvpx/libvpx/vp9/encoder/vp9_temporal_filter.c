@@ -19,6 +19,8 @@
 #include "vp9/encoder/vp9_firstpass.h"
 #include "vp9/encoder/vp9_mcomp.h"
 #include "vp9/encoder/vp9_encoder.h"
+#include "vp9/encoder/vp9_ethread.h"
+#include "vp9/encoder/vp9_pyramid_me.h"
 #include "vp9/encoder/vp9_quantize.h"
 #include "vp9/encoder/vp9_ratectrl.h"
 #include "vp9/encoder/vp9_segmentation.h"
@@ -211,10 +213,11 @@ void vp9_highbd_temporal_filter_apply_c(uint8_t *frame1_8,
 #endif  
 
 static int temporal_filter_find_matching_mb_c(VP9_COMP *cpi,
+                                              MACROBLOCK *x,
                                               uint8_t *arf_frame_buf,
                                               uint8_t *frame_ptr_buf,
-                                              int stride) {
-  MACROBLOCK *const x = &cpi->td.mb;
+                                              int stride,
+                                              const MV *seed_mv) {
   MACROBLOCKD *const xd = &x->e_mbd;
   const MV_SPEED_FEATURES *const mv_sf = &cpi->sf.mv;
   int step_param;
@@ -244,6 +247,12 @@ static int temporal_filter_find_matching_mb_c(VP9_COMP *cpi,
   step_param = mv_sf->reduce_first_step_size;
   step_param = MIN(step_param, MAX_MVSEARCH_STEPS - 2);
 
+  if (seed_mv != NULL) {
+    best_ref_mv1_full.col = seed_mv->col >> 3;
+    best_ref_mv1_full.row = seed_mv->row >> 3;
+    step_param = MAX(step_param, MAX_MVSEARCH_STEPS - 3);
+  }
+
   
   vp9_hex_search(x, &best_ref_mv1_full, step_param, sadpb, 1,
                  cond_cost_list(cpi, cost_list),
@@ -267,23 +276,24 @@ static int temporal_filter_find_matching_mb_c(VP9_COMP *cpi,
   return bestsme;
 }
 
-static void temporal_filter_iterate_c(VP9_COMP *cpi,
-                                      YV12_BUFFER_CONFIG **frames,
-                                      int frame_count,
-                                      int alt_ref_index,
-                                      int strength,
-                                      struct scale_factors *scale) {
+void vp9_temporal_filter_iterate_row_c(VP9_COMP *cpi, ThreadData *td,
+                                       int mb_row) {
+  ARNRFilterData *const arnr_filter_data = &cpi->arnr_filter_data;
+  YV12_BUFFER_CONFIG **const frames = arnr_filter_data->frames;
+  const int frame_count = arnr_filter_data->frame_count;
+  const int alt_ref_index = arnr_filter_data->alt_ref_index;
+  const int strength = arnr_filter_data->strength;
+  struct scale_factors *const scale = &arnr_filter_data->sf;
   int byte;
   int frame;
-  int mb_col, mb_row;
+  int mb_col;
   unsigned int filter_weight;
   int mb_cols = (frames[alt_ref_index]->y_crop_width + 15) >> 4;
   int mb_rows = (frames[alt_ref_index]->y_crop_height + 15) >> 4;
-  int mb_y_offset = 0;
-  int mb_uv_offset = 0;
   DECLARE_ALIGNED(16, unsigned int, accumulator[16 * 16 * 3]);
   DECLARE_ALIGNED(16, uint16_t, count[16 * 16 * 3]);
-  MACROBLOCKD *mbd = &cpi->td.mb.e_mbd;
+  MACROBLOCK *const x = &td->mb;
+  MACROBLOCKD *mbd = &x->e_mbd;
   YV12_BUFFER_CONFIG *f = frames[alt_ref_index];
   uint8_t *dst1, *dst2;
 #if CONFIG_VP9_HIGHBITDEPTH
@@ -295,8 +305,11 @@ static void temporal_filter_iterate_c(VP9_COMP *cpi,
 #endif
   const int mb_uv_height = 16 >> mbd->plane[1].subsampling_y;
   const int mb_uv_width  = 16 >> mbd->plane[1].subsampling_x;
-
-  
+  int mb_y_offset = mb_row * 16 * f->y_stride;
+  int mb_uv_offset = mb_row * mb_uv_height * f->uv_stride;
+  MODE_INFO **const input_mi = mbd->mi;
+  MODE_INFO mi = *mbd->mi[0];
+  MODE_INFO *mi_ptr = &mi;
   uint8_t* input_buffer[MAX_MB_PLANE];
   int i;
 #if CONFIG_VP9_HIGHBITDEPTH
@@ -307,113 +320,87 @@ static void temporal_filter_iterate_c(VP9_COMP *cpi,
   }
 #endif
 
+  mbd->mi = &mi_ptr;
   for (i = 0; i < MAX_MB_PLANE; i++)
     input_buffer[i] = mbd->plane[i].pre[0].buf;
 
-  for (mb_row = 0; mb_row < mb_rows; mb_row++) {
-    
-    
-    
-    
-    
-    
-    
-    
-    
-    
-    
-    cpi->td.mb.mv_row_min = -((mb_row * 16) + (17 - 2 * VP9_INTERP_EXTEND));
-    cpi->td.mb.mv_row_max = ((mb_rows - 1 - mb_row) * 16)
-                         + (17 - 2 * VP9_INTERP_EXTEND);
+  x->mv_row_min = -((mb_row * 16) + (17 - 2 * VP9_INTERP_EXTEND));
+  x->mv_row_max = ((mb_rows - 1 - mb_row) * 16)
+                  + (17 - 2 * VP9_INTERP_EXTEND);
 
-    for (mb_col = 0; mb_col < mb_cols; mb_col++) {
-      int i, j, k;
-      int stride;
+  for (mb_col = 0; mb_col < mb_cols; mb_col++) {
+    int i, j, k;
+    int stride;
 
-      memset(accumulator, 0, 16 * 16 * 3 * sizeof(accumulator[0]));
-      memset(count, 0, 16 * 16 * 3 * sizeof(count[0]));
+    memset(accumulator, 0, 16 * 16 * 3 * sizeof(accumulator[0]));
+    memset(count, 0, 16 * 16 * 3 * sizeof(count[0]));
 
-      cpi->td.mb.mv_col_min = -((mb_col * 16) + (17 - 2 * VP9_INTERP_EXTEND));
-      cpi->td.mb.mv_col_max = ((mb_cols - 1 - mb_col) * 16)
-                           + (17 - 2 * VP9_INTERP_EXTEND);
+    x->mv_col_min = -((mb_col * 16) + (17 - 2 * VP9_INTERP_EXTEND));
+    x->mv_col_max = ((mb_cols - 1 - mb_col) * 16)
+                         + (17 - 2 * VP9_INTERP_EXTEND);
 
-      for (frame = 0; frame < frame_count; frame++) {
-        const int thresh_low  = 10000;
-        const int thresh_high = 20000;
+    for (frame = 0; frame < frame_count; frame++) {
+      const int thresh_low  = 10000;
+      const int thresh_high = 20000;
 
-        if (frames[frame] == NULL)
-          continue;
+      if (frames[frame] == NULL)
+        continue;
 
-        mbd->mi[0]->bmi[0].as_mv[0].as_mv.row = 0;
-        mbd->mi[0]->bmi[0].as_mv[0].as_mv.col = 0;
+      mbd->mi[0]->bmi[0].as_mv[0].as_mv.row = 0;
+      mbd->mi[0]->bmi[0].as_mv[0].as_mv.col = 0;
 
-        if (frame == alt_ref_index) {
-          filter_weight = 2;
-        } else {
-          
-          int err = temporal_filter_find_matching_mb_c(cpi,
-              frames[alt_ref_index]->y_buffer + mb_y_offset,
-              frames[frame]->y_buffer + mb_y_offset,
-              frames[frame]->y_stride);
+      if (frame == alt_ref_index) {
+        filter_weight = 2;
+      } else {
+        const MV *const seed_mv = arnr_filter_data->mvs[frame] != NULL ?
+            &arnr_filter_data->mvs[frame][mb_row * mb_cols + mb_col] : NULL;
+        
+        int err = temporal_filter_find_matching_mb_c(cpi, x,
+            frames[alt_ref_index]->y_buffer + mb_y_offset,
+            frames[frame]->y_buffer + mb_y_offset,
+            frames[frame]->y_stride, seed_mv);
 
-          
-          
-          
-          filter_weight = err < thresh_low
-                          ? 2 : err < thresh_high ? 1 : 0;
-        }
+        
+        
+        
+        filter_weight = err < thresh_low
+                        ? 2 : err < thresh_high ? 1 : 0;
+      }
 
-        if (filter_weight != 0) {
-          
-          temporal_filter_predictors_mb_c(mbd,
-              frames[frame]->y_buffer + mb_y_offset,
-              frames[frame]->u_buffer + mb_uv_offset,
-              frames[frame]->v_buffer + mb_uv_offset,
-              frames[frame]->y_stride,
-              mb_uv_width, mb_uv_height,
-              mbd->mi[0]->bmi[0].as_mv[0].as_mv.row,
-              mbd->mi[0]->bmi[0].as_mv[0].as_mv.col,
-              predictor, scale,
-              mb_col * 16, mb_row * 16);
+      if (filter_weight != 0) {
+        
+        temporal_filter_predictors_mb_c(mbd,
+            frames[frame]->y_buffer + mb_y_offset,
+            frames[frame]->u_buffer + mb_uv_offset,
+            frames[frame]->v_buffer + mb_uv_offset,
+            frames[frame]->y_stride,
+            mb_uv_width, mb_uv_height,
+            mbd->mi[0]->bmi[0].as_mv[0].as_mv.row,
+            mbd->mi[0]->bmi[0].as_mv[0].as_mv.col,
+            predictor, scale,
+            mb_col * 16, mb_row * 16);
 
 #if CONFIG_VP9_HIGHBITDEPTH
-          if (mbd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH) {
-            int adj_strength = strength + 2 * (mbd->bd - 8);
-            
-            vp9_highbd_temporal_filter_apply(f->y_buffer + mb_y_offset,
-                                             f->y_stride,
-                                             predictor, 16, 16, adj_strength,
-                                             filter_weight,
-                                             accumulator, count);
-            vp9_highbd_temporal_filter_apply(f->u_buffer + mb_uv_offset,
-                                             f->uv_stride, predictor + 256,
-                                             mb_uv_width, mb_uv_height,
-                                             adj_strength,
-                                             filter_weight, accumulator + 256,
-                                             count + 256);
-            vp9_highbd_temporal_filter_apply(f->v_buffer + mb_uv_offset,
-                                             f->uv_stride, predictor + 512,
-                                             mb_uv_width, mb_uv_height,
-                                             adj_strength, filter_weight,
-                                             accumulator + 512, count + 512);
-          } else {
-            
-            vp9_temporal_filter_apply(f->y_buffer + mb_y_offset, f->y_stride,
-                                      predictor, 16, 16,
-                                      strength, filter_weight,
-                                      accumulator, count);
-            vp9_temporal_filter_apply(f->u_buffer + mb_uv_offset, f->uv_stride,
-                                      predictor + 256,
-                                      mb_uv_width, mb_uv_height, strength,
-                                      filter_weight, accumulator + 256,
-                                      count + 256);
-            vp9_temporal_filter_apply(f->v_buffer + mb_uv_offset, f->uv_stride,
-                                      predictor + 512,
-                                      mb_uv_width, mb_uv_height, strength,
-                                      filter_weight, accumulator + 512,
-                                      count + 512);
-          }
-#else
+        if (mbd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH) {
+          int adj_strength = strength + 2 * (mbd->bd - 8);
+          
+          vp9_highbd_temporal_filter_apply(f->y_buffer + mb_y_offset,
+                                           f->y_stride,
+                                           predictor, 16, 16, adj_strength,
+                                           filter_weight,
+                                           accumulator, count);
+          vp9_highbd_temporal_filter_apply(f->u_buffer + mb_uv_offset,
+                                           f->uv_stride, predictor + 256,
+                                           mb_uv_width, mb_uv_height,
+                                           adj_strength,
+                                           filter_weight, accumulator + 256,
+                                           count + 256);
+          vp9_highbd_temporal_filter_apply(f->v_buffer + mb_uv_offset,
+                                           f->uv_stride, predictor + 512,
+                                           mb_uv_width, mb_uv_height,
+                                           adj_strength, filter_weight,
+                                           accumulator + 512, count + 512);
+        } else {
           
           vp9_temporal_filter_apply(f->y_buffer + mb_y_offset, f->y_stride,
                                     predictor, 16, 16,
@@ -429,108 +416,80 @@ static void temporal_filter_iterate_c(VP9_COMP *cpi,
                                     mb_uv_width, mb_uv_height, strength,
                                     filter_weight, accumulator + 512,
                                     count + 512);
-#endif  
         }
+#else
+        
+        vp9_temporal_filter_apply(f->y_buffer + mb_y_offset, f->y_stride,
+                                  predictor, 16, 16,
+                                  strength, filter_weight,
+                                  accumulator, count);
+        vp9_temporal_filter_apply(f->u_buffer + mb_uv_offset, f->uv_stride,
+                                  predictor + 256,
+                                  mb_uv_width, mb_uv_height, strength,
+                                  filter_weight, accumulator + 256,
+                                  count + 256);
+        vp9_temporal_filter_apply(f->v_buffer + mb_uv_offset, f->uv_stride,
+                                  predictor + 512,
+                                  mb_uv_width, mb_uv_height, strength,
+                                  filter_weight, accumulator + 512,
+                                  count + 512);
+#endif  
       }
+    }
 
 #if CONFIG_VP9_HIGHBITDEPTH
-      if (mbd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH) {
-        uint16_t *dst1_16;
-        uint16_t *dst2_16;
-        
-        dst1 = cpi->alt_ref_buffer.y_buffer;
-        dst1_16 = CONVERT_TO_SHORTPTR(dst1);
-        stride = cpi->alt_ref_buffer.y_stride;
-        byte = mb_y_offset;
-        for (i = 0, k = 0; i < 16; i++) {
-          for (j = 0; j < 16; j++, k++) {
-            unsigned int pval = accumulator[k] + (count[k] >> 1);
-            pval *= fixed_divide[count[k]];
-            pval >>= 19;
-
-            dst1_16[byte] = (uint16_t)pval;
-
-            
-            byte++;
-          }
+    if (mbd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH) {
+      uint16_t *dst1_16;
+      uint16_t *dst2_16;
+      
+      dst1 = cpi->alt_ref_buffer.y_buffer;
+      dst1_16 = CONVERT_TO_SHORTPTR(dst1);
+      stride = cpi->alt_ref_buffer.y_stride;
+      byte = mb_y_offset;
+      for (i = 0, k = 0; i < 16; i++) {
+        for (j = 0; j < 16; j++, k++) {
+          unsigned int pval = accumulator[k] + (count[k] >> 1);
+          pval *= fixed_divide[count[k]];
+          pval >>= 19;
 
-          byte += stride - 16;
+          dst1_16[byte] = (uint16_t)pval;
+
+          
+          byte++;
         }
 
-        dst1 = cpi->alt_ref_buffer.u_buffer;
-        dst2 = cpi->alt_ref_buffer.v_buffer;
-        dst1_16 = CONVERT_TO_SHORTPTR(dst1);
-        dst2_16 = CONVERT_TO_SHORTPTR(dst2);
-        stride = cpi->alt_ref_buffer.uv_stride;
-        byte = mb_uv_offset;
-        for (i = 0, k = 256; i < mb_uv_height; i++) {
-          for (j = 0; j < mb_uv_width; j++, k++) {
-            int m = k + 256;
-
-            
-            unsigned int pval = accumulator[k] + (count[k] >> 1);
-            pval *= fixed_divide[count[k]];
-            pval >>= 19;
-            dst1_16[byte] = (uint16_t)pval;
-
-            
-            pval = accumulator[m] + (count[m] >> 1);
-            pval *= fixed_divide[count[m]];
-            pval >>= 19;
-            dst2_16[byte] = (uint16_t)pval;
-
-            
-            byte++;
-          }
+        byte += stride - 16;
+      }
 
-          byte += stride - mb_uv_width;
-        }
-      } else {
-        
-        dst1 = cpi->alt_ref_buffer.y_buffer;
-        stride = cpi->alt_ref_buffer.y_stride;
-        byte = mb_y_offset;
-        for (i = 0, k = 0; i < 16; i++) {
-          for (j = 0; j < 16; j++, k++) {
-            unsigned int pval = accumulator[k] + (count[k] >> 1);
-            pval *= fixed_divide[count[k]];
-            pval >>= 19;
-
-            dst1[byte] = (uint8_t)pval;
-
-            
-            byte++;
-          }
-          byte += stride - 16;
-        }
+      dst1 = cpi->alt_ref_buffer.u_buffer;
+      dst2 = cpi->alt_ref_buffer.v_buffer;
+      dst1_16 = CONVERT_TO_SHORTPTR(dst1);
+      dst2_16 = CONVERT_TO_SHORTPTR(dst2);
+      stride = cpi->alt_ref_buffer.uv_stride;
+      byte = mb_uv_offset;
+      for (i = 0, k = 256; i < mb_uv_height; i++) {
+        for (j = 0; j < mb_uv_width; j++, k++) {
+          int m = k + 256;
 
-        dst1 = cpi->alt_ref_buffer.u_buffer;
-        dst2 = cpi->alt_ref_buffer.v_buffer;
-        stride = cpi->alt_ref_buffer.uv_stride;
-        byte = mb_uv_offset;
-        for (i = 0, k = 256; i < mb_uv_height; i++) {
-          for (j = 0; j < mb_uv_width; j++, k++) {
-            int m = k + 256;
-
-            
-            unsigned int pval = accumulator[k] + (count[k] >> 1);
-            pval *= fixed_divide[count[k]];
-            pval >>= 19;
-            dst1[byte] = (uint8_t)pval;
-
-            
-            pval = accumulator[m] + (count[m] >> 1);
-            pval *= fixed_divide[count[m]];
-            pval >>= 19;
-            dst2[byte] = (uint8_t)pval;
-
-            
-            byte++;
-          }
-          byte += stride - mb_uv_width;
+          
+          unsigned int pval = accumulator[k] + (count[k] >> 1);
+          pval *= fixed_divide[count[k]];
+          pval >>= 19;
+          dst1_16[byte] = (uint16_t)pval;
+
+          
+          pval = accumulator[m] + (count[m] >> 1);
+          pval *= fixed_divide[count[m]];
+          pval >>= 19;
+          dst2_16[byte] = (uint16_t)pval;
+
+          
+          byte++;
         }
+
+        byte += stride - mb_uv_width;
       }
-#else
+    } else {
       
       dst1 = cpi->alt_ref_buffer.y_buffer;
       stride = cpi->alt_ref_buffer.y_stride;
@@ -574,17 +533,70 @@ static void temporal_filter_iterate_c(VP9_COMP *cpi,
         }
         byte += stride - mb_uv_width;
       }
-#endif  
-      mb_y_offset += 16;
-      mb_uv_offset += mb_uv_width;
     }
-    mb_y_offset += 16 * (f->y_stride - mb_cols);
-    mb_uv_offset += mb_uv_height * f->uv_stride - mb_uv_width * mb_cols;
+#else
+    
+    dst1 = cpi->alt_ref_buffer.y_buffer;
+    stride = cpi->alt_ref_buffer.y_stride;
+    byte = mb_y_offset;
+    for (i = 0, k = 0; i < 16; i++) {
+      for (j = 0; j < 16; j++, k++) {
+        unsigned int pval = accumulator[k] + (count[k] >> 1);
+        pval *= fixed_divide[count[k]];
+        pval >>= 19;
+
+        dst1[byte] = (uint8_t)pval;
+
+        
+        byte++;
+      }
+      byte += stride - 16;
+    }
+
+    dst1 = cpi->alt_ref_buffer.u_buffer;
+    dst2 = cpi->alt_ref_buffer.v_buffer;
+    stride = cpi->alt_ref_buffer.uv_stride;
+    byte = mb_uv_offset;
+    for (i = 0, k = 256; i < mb_uv_height; i++) {
+      for (j = 0; j < mb_uv_width; j++, k++) {
+        int m = k + 256;
+
+        
+        unsigned int pval = accumulator[k] + (count[k] >> 1);
+        pval *= fixed_divide[count[k]];
+        pval >>= 19;
+        dst1[byte] = (uint8_t)pval;
+
+        
+        pval = accumulator[m] + (count[m] >> 1);
+        pval *= fixed_divide[count[m]];
+        pval >>= 19;
+        dst2[byte] = (uint8_t)pval;
+
+        
+        byte++;
+      }
+      byte += stride - mb_uv_width;
+    }
+#endif  
+    mb_y_offset += 16;
+    mb_uv_offset += mb_uv_width;
   }
 
-  
   for (i = 0; i < MAX_MB_PLANE; i++)
     mbd->plane[i].pre[0].buf = input_buffer[i];
+  mbd->mi = input_mi;
+}
+
+static void temporal_filter_iterate_c(VP9_COMP *cpi) {
+  const ARNRFilterData *const arnr_filter_data = &cpi->arnr_filter_data;
+  const YV12_BUFFER_CONFIG *const f =
+      arnr_filter_data->frames[arnr_filter_data->alt_ref_index];
+  const int mb_rows = (f->y_crop_height + 15) >> 4;
+  int mb_row;
+
+  for (mb_row = 0; mb_row < mb_rows; mb_row++)
+    vp9_temporal_filter_iterate_row_c(cpi, &cpi->td, mb_row);
 }
 
 static void adjust_arnr_filter(VP9_COMP *cpi,
@@ -650,6 +662,39 @@ static void adjust_arnr_filter(VP9_COMP *cpi,
   *arnr_strength = strength;
 }
 
+static void setup_pyramid_mvs(VP9_COMP *cpi,
+                              struct lookahead_entry **entries,
+                              int frame_count, int alt_ref_index) {
+  VP9_COMMON *const cm = &cpi->common;
+  ARNRFilterData *const arnr_filter_data = &cpi->arnr_filter_data;
+  struct lookahead_entry *const arf = entries[alt_ref_index];
+  const int mbs = ((arf->img.y_crop_height + 15) >> 4) *
+                  ((arf->img.y_crop_width + 15) >> 4);
+  int frame;
+
+  if (arnr_filter_data->mv_buf_size < mbs * MAX_LAG_BUFFERS) {
+    vpx_free(arnr_filter_data->mv_buf);
+    arnr_filter_data->mv_buf_size = 0;
+    CHECK_MEM_ERROR(cm, arnr_filter_data->mv_buf,
+                    vpx_malloc(mbs * MAX_LAG_BUFFERS *
+                               sizeof(*arnr_filter_data->mv_buf)));
+    arnr_filter_data->mv_buf_size = mbs * MAX_LAG_BUFFERS;
+  }
+
+  for (frame = 0; frame < frame_count; ++frame) {
+    MV *const mvs = arnr_filter_data->mv_buf + frame * mbs;
+
+    if (frame == alt_ref_index)
+      continue;
+
+    if (frame == alt_ref_index - 1)
+      arnr_filter_data->mvs[frame] =
+          vp9_pyramid_me_get_mvs(arf, entries[frame]);
+    else if (!vp9_pyramid_motion_search(arf, entries[frame], mvs))
+      arnr_filter_data->mvs[frame] = mvs;
+  }
+}
+
 void vp9_temporal_filter(VP9_COMP *cpi, int distance) {
   VP9_COMMON *const cm = &cpi->common;
   RATE_CONTROL *const rc = &cpi->rc;
@@ -660,8 +705,16 @@ void vp9_temporal_filter(VP9_COMP *cpi, int distance) {
   int strength;
   int frames_to_blur_backward;
   int frames_to_blur_forward;
-  struct scale_factors sf;
-  YV12_BUFFER_CONFIG *frames[MAX_LAG_BUFFERS] = {NULL};
+  int mb_rows;
+  ARNRFilterData *const arnr_filter_data = &cpi->arnr_filter_data;
+  YV12_BUFFER_CONFIG **const frames = arnr_filter_data->frames;
+  struct lookahead_entry *entries[MAX_LAG_BUFFERS];
+  struct scale_factors *const sf = &arnr_filter_data->sf;
+  struct vpx_usec_timer timer;
+
+  vpx_usec_timer_start(&timer);
+  memset(frames, 0, sizeof(arnr_filter_data->frames));
+  memset(arnr_filter_data->mvs, 0, sizeof(arnr_filter_data->mvs));
 
   
   adjust_arnr_filter(cpi, distance, rc->gfu_boost, &frames_to_blur, &strength);
@@ -675,6 +728,7 @@ void vp9_temporal_filter(VP9_COMP *cpi, int distance) {
     struct lookahead_entry *buf = vp9_lookahead_peek(cpi->lookahead,
                                                      which_buffer);
     frames[frames_to_blur - 1 - frame] = &buf->img;
+    entries[frames_to_blur - 1 - frame] = buf;
   }
 
   if (frames_to_blur > 0) {
@@ -686,7 +740,7 @@ void vp9_temporal_filter(VP9_COMP *cpi, int distance) {
       int frame_used = 0;
 #if CONFIG_VP9_HIGHBITDEPTH
       vp9_setup_scale_factors_for_frame(
-          &sf,
+          sf,
           get_frame_new_buffer(cm)->y_crop_width,
           get_frame_new_buffer(cm)->y_crop_height,
           get_frame_new_buffer(cm)->y_crop_width,
@@ -694,7 +748,7 @@ void vp9_temporal_filter(VP9_COMP *cpi, int distance) {
           cm->use_highbitdepth);
 #else
       vp9_setup_scale_factors_for_frame(
-          &sf,
+          sf,
           get_frame_new_buffer(cm)->y_crop_width,
           get_frame_new_buffer(cm)->y_crop_height,
           get_frame_new_buffer(cm)->y_crop_width,
@@ -727,22 +781,36 @@ void vp9_temporal_filter(VP9_COMP *cpi, int distance) {
     } else {
       
 #if CONFIG_VP9_HIGHBITDEPTH
-      vp9_setup_scale_factors_for_frame(&sf,
+      vp9_setup_scale_factors_for_frame(sf,
                                         frames[0]->y_crop_width,
                                         frames[0]->y_crop_height,
                                         frames[0]->y_crop_width,
                                         frames[0]->y_crop_height,
                                         cm->use_highbitdepth);
 #else
-      vp9_setup_scale_factors_for_frame(&sf,
+      vp9_setup_scale_factors_for_frame(sf,
                                         frames[0]->y_crop_width,
                                         frames[0]->y_crop_height,
                                         frames[0]->y_crop_width,
                                         frames[0]->y_crop_height);
 #endif  
+
+      if (cpi->sf.lookahead_pyramid_me)
+        setup_pyramid_mvs(cpi, entries, frames_to_blur,
+                          frames_to_blur_backward);
     }
   }
 
-  temporal_filter_iterate_c(cpi, frames, frames_to_blur,
-                            frames_to_blur_backward, strength, &sf);
+  arnr_filter_data->frame_count = frames_to_blur;
+  arnr_filter_data->alt_ref_index = frames_to_blur_backward;
+  arnr_filter_data->strength = strength;
+
+  mb_rows = (frames[frames_to_blur_backward]->y_crop_height + 15) >> 4;
+  if (MIN(cpi->oxcf.max_threads, mb_rows) > 1)
+    vp9_temporal_filter_row_mt(cpi);
+  else
+    temporal_filter_iterate_c(cpi);
+
+  vpx_usec_timer_mark(&timer);
+  cpi->time_temporal_filter += vpx_usec_timer_elapsed(&timer);
 }
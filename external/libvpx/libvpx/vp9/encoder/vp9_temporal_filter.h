@@ -11,12 +11,32 @@
 #ifndef VP9_ENCODER_VP9_TEMPORAL_FILTER_H_
 #define VP9_ENCODER_VP9_TEMPORAL_FILTER_H_
 
+#include "vp9/common/vp9_scale.h"
+#include "vp9/encoder/vp9_lookahead.h"
+#include "vpx_scale/yv12config.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+struct VP9_COMP;
+struct ThreadData;
+
+typedef struct ARNRFilterData {
+  YV12_BUFFER_CONFIG *frames[MAX_LAG_BUFFERS];
+  const MV *mvs[MAX_LAG_BUFFERS];
+  MV *mv_buf;
+  int mv_buf_size;
+  int frame_count;
+  int alt_ref_index;
+  int strength;
+  struct scale_factors sf;
+} ARNRFilterData;
+
 void vp9_temporal_filter_init(void);
-void vp9_temporal_filter(VP9_COMP *cpi, int distance);
+void vp9_temporal_filter(struct VP9_COMP *cpi, int distance);
+void vp9_temporal_filter_iterate_row_c(struct VP9_COMP *cpi,
+                                       struct ThreadData *td, int mb_row);
 
 #ifdef __cplusplus
 }  
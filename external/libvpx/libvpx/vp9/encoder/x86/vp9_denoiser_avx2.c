@@ -0,0 +1,217 @@
+/*
+ *  Copyright (c) 2016 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+
+#include "./vpx_config.h"
+#include "./vp9_rtcd.h"
+
+#include "vpx/vpx_integer.h"
+#include "vp9/common/vp9_reconinter.h"
+#include "vp9/encoder/vp9_context_tree.h"
+#include "vp9/encoder/vp9_denoiser.h"
+
+static INLINE int sum_diff_32x1(__m256i acc_diff) {
+  const __m256i k_1 = _mm256_set1_epi16(1);
+  const __m256i acc_diff_lo =
+      _mm256_srai_epi16(_mm256_unpacklo_epi8(acc_diff, acc_diff), 8);
+  const __m256i acc_diff_hi =
+      _mm256_srai_epi16(_mm256_unpackhi_epi8(acc_diff, acc_diff), 8);
+  const __m256i acc_diff_16 = _mm256_add_epi16(acc_diff_lo, acc_diff_hi);
+  const __m256i sum_32 = _mm256_madd_epi16(acc_diff_16, k_1);
+  const __m128i hg_fe_dc_ba =
+      _mm_add_epi32(_mm256_castsi256_si128(sum_32),
+                    _mm256_extracti128_si256(sum_32, 1));
+  const __m128i hgfe_dcba =
+      _mm_add_epi32(hg_fe_dc_ba, _mm_srli_si128(hg_fe_dc_ba, 8));
+  const __m128i hgfedcba =
+      _mm_add_epi32(hgfe_dcba, _mm_srli_si128(hgfe_dcba, 4));
+  return _mm_cvtsi128_si32(hgfedcba);
+}
+
+static INLINE __m256i denoiser_32x1_avx2(const uint8_t *sig,
+                                         const uint8_t *mc_running_avg_y,
+                                         uint8_t *running_avg_y,
+                                         const __m256i k_0,
+                                         const __m256i k_4,
+                                         const __m256i k_8,
+                                         const __m256i k_16,
+                                         const __m256i l3,
+                                         const __m256i l32,
+                                         const __m256i l21,
+                                         __m256i acc_diff) {
+  const __m256i v_sig = _mm256_loadu_si256((const __m256i *)sig);
+  const __m256i v_mc_running_avg_y =
+      _mm256_loadu_si256((const __m256i *)mc_running_avg_y);
+  __m256i v_running_avg_y;
+  const __m256i pdiff = _mm256_subs_epu8(v_mc_running_avg_y, v_sig);
+  const __m256i ndiff = _mm256_subs_epu8(v_sig, v_mc_running_avg_y);
+  const __m256i diff_sign = _mm256_cmpeq_epi8(pdiff, k_0);
+  const __m256i clamped_absdiff =
+      _mm256_min_epu8(_mm256_or_si256(pdiff, ndiff), k_16);
+  const __m256i mask2 = _mm256_cmpgt_epi8(k_16, clamped_absdiff);
+  const __m256i mask1 = _mm256_cmpgt_epi8(k_8, clamped_absdiff);
+  const __m256i mask0 = _mm256_cmpgt_epi8(k_4, clamped_absdiff);
+  __m256i adj2 = _mm256_and_si256(mask2, l32);
+  const __m256i adj1 = _mm256_and_si256(mask1, l21);
+  const __m256i adj0 = _mm256_and_si256(mask0, clamped_absdiff);
+  __m256i adj, padj, nadj;
+
+  adj2 = _mm256_add_epi8(adj2, adj1);
+  adj = _mm256_sub_epi8(l3, adj2);
+  adj = _mm256_andnot_si256(mask0, adj);
+  adj = _mm256_or_si256(adj, adj0);
+
+  padj = _mm256_andnot_si256(diff_sign, adj);
+  nadj = _mm256_and_si256(diff_sign, adj);
+
+  v_running_avg_y = _mm256_adds_epu8(v_sig, padj);
+  v_running_avg_y = _mm256_subs_epu8(v_running_avg_y, nadj);
+  _mm256_storeu_si256((__m256i *)running_avg_y, v_running_avg_y);
+
+  acc_diff = _mm256_adds_epi8(acc_diff, padj);
+  acc_diff = _mm256_subs_epi8(acc_diff, nadj);
+  return acc_diff;
+}
+
+static INLINE __m256i denoiser_adj_32x1_avx2(const uint8_t *sig,
+                                             const uint8_t *mc_running_avg_y,
+                                             uint8_t *running_avg_y,
+                                             const __m256i k_0,
+                                             const __m256i k_delta,
+                                             __m256i acc_diff) {
+  __m256i v_running_avg_y =
+      _mm256_loadu_si256((const __m256i *)running_avg_y);
+  const __m256i v_sig = _mm256_loadu_si256((const __m256i *)sig);
+  const __m256i v_mc_running_avg_y =
+      _mm256_loadu_si256((const __m256i *)mc_running_avg_y);
+  const __m256i pdiff = _mm256_subs_epu8(v_mc_running_avg_y, v_sig);
+  const __m256i ndiff = _mm256_subs_epu8(v_sig, v_mc_running_avg_y);
+  const __m256i diff_sign = _mm256_cmpeq_epi8(pdiff, k_0);
+  const __m256i adj =
+      _mm256_min_epu8(_mm256_or_si256(pdiff, ndiff), k_delta);
+  const __m256i padj = _mm256_andnot_si256(diff_sign, adj);
+  const __m256i nadj = _mm256_and_si256(diff_sign, adj);
+
+  v_running_avg_y = _mm256_subs_epu8(v_running_avg_y, padj);
+  v_running_avg_y = _mm256_adds_epu8(v_running_avg_y, nadj);
+  _mm256_storeu_si256((__m256i *)running_avg_y, v_running_avg_y);
+
+  acc_diff = _mm256_subs_epi8(acc_diff, padj);
+  acc_diff = _mm256_adds_epi8(acc_diff, nadj);
+  return acc_diff;
+}
+
+static int denoiser_NxM_avx2_big(const uint8_t *sig, int sig_stride,
+                                 const uint8_t *mc_running_avg_y,
+                                 int mc_avg_y_stride,
+                                 uint8_t *running_avg_y, int avg_y_stride,
+                                 int increase_denoising, BLOCK_SIZE bs,
+                                 int motion_magnitude) {
+  const int width = 4 << b_width_log2_lookup[bs];
+  const int height = 4 << b_height_log2_lookup[bs];
+  int sum_diff_thresh, r, c, sum_diff = 0;
+  const int shift_inc  = (increase_denoising &&
+                          motion_magnitude <= MOTION_MAGNITUDE_THRESHOLD) ?
+                         1 : 0;
+  __m256i acc_diff[2][4];
+  const __m256i k_0 = _mm256_setzero_si256();
+  const __m256i k_4 = _mm256_set1_epi8(4 + shift_inc);
+  const __m256i k_8 = _mm256_set1_epi8(8);
+  const __m256i k_16 = _mm256_set1_epi8(16);
+  const __m256i l3 = _mm256_set1_epi8(
+      (motion_magnitude <= MOTION_MAGNITUDE_THRESHOLD) ? 7 + shift_inc : 6);
+  const __m256i l32 = _mm256_set1_epi8(2);
+  const __m256i l21 = _mm256_set1_epi8(1);
+
+  for (c = 0; c < 2; ++c) {
+    for (r = 0; r < 4; ++r) {
+      acc_diff[c][r] = _mm256_setzero_si256();
+    }
+  }
+
+  for (r = 0; r < height; ++r) {
+    for (c = 0; c < width; c += 32) {
+      acc_diff[c >> 5][r >> 4] = denoiser_32x1_avx2(
+          sig + c, mc_running_avg_y + c, running_avg_y + c, k_0, k_4,
+          k_8, k_16, l3, l32, l21, acc_diff[c >> 5][r >> 4]);
+    }
+
+    if ((r + 1) % 16 == 0) {
+      for (c = 0; c < width; c += 32) {
+        sum_diff += sum_diff_32x1(acc_diff[c >> 5][r >> 4]);
+      }
+    }
+
+    sig += sig_stride;
+    mc_running_avg_y += mc_avg_y_stride;
+    running_avg_y += avg_y_stride;
+  }
+
+  sum_diff_thresh = total_adj_strong_thresh(bs, increase_denoising);
+  if (abs(sum_diff) > sum_diff_thresh) {
+    const int delta = ((abs(sum_diff) - sum_diff_thresh) >>
+                       num_pels_log2_lookup[bs]) + 1;
+
+    if (delta < 4) {
+      const __m256i k_delta = _mm256_set1_epi8(delta);
+      sig -= sig_stride * height;
+      mc_running_avg_y -= mc_avg_y_stride * height;
+      running_avg_y -= avg_y_stride * height;
+      sum_diff = 0;
+      for (r = 0; r < height; ++r) {
+        for (c = 0; c < width; c += 32) {
+          acc_diff[c >> 5][r >> 4] = denoiser_adj_32x1_avx2(
+              sig + c, mc_running_avg_y + c, running_avg_y + c, k_0,
+              k_delta, acc_diff[c >> 5][r >> 4]);
+        }
+
+        if ((r + 1) % 16 == 0) {
+          for (c = 0; c < width; c += 32) {
+            sum_diff += sum_diff_32x1(acc_diff[c >> 5][r >> 4]);
+          }
+        }
+
+        sig += sig_stride;
+        mc_running_avg_y += mc_avg_y_stride;
+        running_avg_y += avg_y_stride;
+      }
+      if (abs(sum_diff) > sum_diff_thresh) {
+        return COPY_BLOCK;
+      }
+    } else {
+      return COPY_BLOCK;
+    }
+  }
+  return FILTER_BLOCK;
+}
+
+int vp9_denoiser_filter_avx2(const uint8_t *sig, int sig_stride,
+                             const uint8_t *mc_avg,
+                             int mc_avg_stride,
+                             uint8_t *avg, int avg_stride,
+                             int increase_denoising,
+                             BLOCK_SIZE bs,
+                             int motion_magnitude) {
+  if (bs == BLOCK_32X16 || bs == BLOCK_32X32 || bs == BLOCK_32X64 ||
+      bs == BLOCK_64X32 || bs == BLOCK_64X64) {
+    return denoiser_NxM_avx2_big(sig, sig_stride,
+                                 mc_avg, mc_avg_stride,
+                                 avg, avg_stride,
+                                 increase_denoising,
+                                 bs, motion_magnitude);
+  } else {
+    return vp9_denoiser_filter_sse2(sig, sig_stride,
+                                    mc_avg, mc_avg_stride,
+                                    avg, avg_stride,
+                                    increase_denoising,
+                                    bs, motion_magnitude);
+  }
+}
@@ -0,0 +1,81 @@
+/*
+ *  Copyright (c) 2015 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <emmintrin.h>
+
+#include "./vp9_rtcd.h"
+#include "vpx/vpx_integer.h"
+#include "vpx_ports/mem.h"
+
+void vp9_highbd_temporal_filter_apply_sse2(uint8_t *frame1_8,
+                                           unsigned int stride,
+                                           uint8_t *frame2_8,
+                                           unsigned int block_width,
+                                           unsigned int block_height,
+                                           int strength,
+                                           int filter_weight,
+                                           unsigned int *accumulator,
+                                           uint16_t *count) {
+  const uint16_t *frame1 = CONVERT_TO_SHORTPTR(frame1_8);
+  const uint16_t *frame2 = CONVERT_TO_SHORTPTR(frame2_8);
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i sixteen = _mm_set1_epi16(16);
+  const __m128i weight = _mm_set1_epi16(filter_weight);
+  const __m128i rounding =
+      _mm_set1_epi32(strength > 0 ? 1 << (strength - 1) : 0);
+  const __m128i shift = _mm_cvtsi32_si128(strength);
+  unsigned int i, j;
+
+  if (block_width & 7) {
+    vp9_highbd_temporal_filter_apply_c(frame1_8, stride, frame2_8,
+                                       block_width, block_height, strength,
+                                       filter_weight, accumulator, count);
+    return;
+  }
+
+  for (i = 0; i < block_height; i++) {
+    for (j = 0; j < block_width; j += 8) {
+      const __m128i src = _mm_loadu_si128((const __m128i *)(frame1 + j));
+      const __m128i pred = _mm_loadu_si128((const __m128i *)(frame2 + j));
+      const __m128i diff = _mm_sub_epi16(src, pred);
+      const __m128i diff_lo = _mm_unpacklo_epi16(diff, zero);
+      const __m128i diff_hi = _mm_unpackhi_epi16(diff, zero);
+      __m128i mod_lo = _mm_madd_epi16(diff_lo, diff_lo);
+      __m128i mod_hi = _mm_madd_epi16(diff_hi, diff_hi);
+      __m128i modifier, cnt, acc_lo, acc_hi, prod_lo, prod_hi;
+
+      mod_lo = _mm_add_epi32(mod_lo, _mm_add_epi32(mod_lo, mod_lo));
+      mod_hi = _mm_add_epi32(mod_hi, _mm_add_epi32(mod_hi, mod_hi));
+      mod_lo = _mm_srl_epi32(_mm_add_epi32(mod_lo, rounding), shift);
+      mod_hi = _mm_srl_epi32(_mm_add_epi32(mod_hi, rounding), shift);
+
+      modifier = _mm_min_epi16(_mm_packs_epi32(mod_lo, mod_hi), sixteen);
+      modifier = _mm_sub_epi16(sixteen, modifier);
+      modifier = _mm_mullo_epi16(modifier, weight);
+
+      cnt = _mm_loadu_si128((const __m128i *)(count + j));
+      _mm_storeu_si128((__m128i *)(count + j), _mm_add_epi16(cnt, modifier));
+
+      prod_lo = _mm_mullo_epi16(pred, modifier);
+      prod_hi = _mm_mulhi_epu16(pred, modifier);
+      acc_lo = _mm_loadu_si128((const __m128i *)(accumulator + j));
+      acc_hi = _mm_loadu_si128((const __m128i *)(accumulator + j + 4));
+      acc_lo = _mm_add_epi32(acc_lo, _mm_unpacklo_epi16(prod_lo, prod_hi));
+      acc_hi = _mm_add_epi32(acc_hi, _mm_unpackhi_epi16(prod_lo, prod_hi));
+      _mm_storeu_si128((__m128i *)(accumulator + j), acc_lo);
+      _mm_storeu_si128((__m128i *)(accumulator + j + 4), acc_hi);
+    }
+
+    frame1 += stride;
+    frame2 += block_width;
+    accumulator += block_width;
+    count += block_width;
+  }
+}
@@ -45,6 +45,7 @@ struct vp9_extracfg {
   vpx_bit_depth_t             bit_depth;
   vp9e_tune_content           content;
   vpx_color_space_t           color_space;
+  unsigned int                svc_reuse_lower_layer;
 };
 
 static struct vp9_extracfg default_extra_cfg = {
@@ -71,6 +72,7 @@ static struct vp9_extracfg default_extra_cfg = {
   VPX_BITS_8,                 
   VP9E_CONTENT_DEFAULT,       
   VPX_CS_UNKNOWN,             
+  0,                          
 };
 
 struct vpx_codec_alg_priv {
@@ -321,6 +323,7 @@ static vpx_codec_err_t validate_config(vpx_codec_alg_priv_t *ctx,
     ERROR("Codec bit-depth 8 not supported in profile > 1");
   }
   RANGE_CHECK(extra_cfg, color_space, VPX_CS_UNKNOWN, VPX_CS_SRGB);
+  RANGE_CHECK_HI(extra_cfg, svc_reuse_lower_layer, 1);
   return VPX_CODEC_OK;
 }
 
@@ -465,6 +468,7 @@ static vpx_codec_err_t set_encoder_config(
 #endif
 
   oxcf->color_space = extra_cfg->color_space;
+  oxcf->svc_reuse_lower_layer = extra_cfg->svc_reuse_lower_layer;
   oxcf->arnr_max_frames = extra_cfg->arnr_max_frames;
   oxcf->arnr_strength   = extra_cfg->arnr_strength;
   oxcf->min_gf_interval = extra_cfg->min_gf_interval;
@@ -1398,6 +1402,30 @@ static vpx_codec_err_t ctrl_set_color_space(vpx_codec_alg_priv_t *ctx,
   return update_extra_cfg(ctx, &extra_cfg);
 }
 
+static vpx_codec_err_t ctrl_set_svc_reuse_lower_layer(
+    vpx_codec_alg_priv_t *ctx, va_list args) {
+  struct vp9_extracfg extra_cfg = ctx->extra_cfg;
+  extra_cfg.svc_reuse_lower_layer =
+      CAST(VP9E_SET_SVC_REUSE_LOWER_LAYER, args);
+  return update_extra_cfg(ctx, &extra_cfg);
+}
+
+static vpx_codec_err_t ctrl_set_stage_timing(vpx_codec_alg_priv_t *ctx,
+                                             va_list args) {
+  ctx->cpi->stage_timing_enabled = CAST(VP9_SET_STAGE_TIMING, args);
+  vp9_zero(ctx->cpi->stage_timing);
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_get_stage_timing(vpx_codec_alg_priv_t *ctx,
+                                             va_list args) {
+  vpx_stage_timing_t *const arg = va_arg(args, vpx_stage_timing_t *);
+  if (arg == NULL)
+    return VPX_CODEC_INVALID_PARAM;
+  *arg = ctx->cpi->stage_timing;
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   {VP8_COPY_REFERENCE,                ctrl_copy_reference},
   {VP8E_UPD_ENTROPY,                  ctrl_update_entropy},
@@ -1437,6 +1465,8 @@ static vpx_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   {VP9E_SET_NOISE_SENSITIVITY,        ctrl_set_noise_sensitivity},
   {VP9E_SET_MIN_GF_INTERVAL,          ctrl_set_min_gf_interval},
   {VP9E_SET_MAX_GF_INTERVAL,          ctrl_set_max_gf_interval},
+  {VP9_SET_STAGE_TIMING,              ctrl_set_stage_timing},
+  {VP9E_SET_SVC_REUSE_LOWER_LAYER,    ctrl_set_svc_reuse_lower_layer},
 
   
   {VP8E_GET_LAST_QUANTIZER,           ctrl_get_quantizer},
@@ -1444,6 +1474,7 @@ static vpx_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   {VP9_GET_REFERENCE,                 ctrl_get_reference},
   {VP9E_GET_SVC_LAYER_ID,             ctrl_get_svc_layer_id},
   {VP9E_GET_ACTIVEMAP,                ctrl_get_active_map},
+  {VP9_GET_STAGE_TIMING,              ctrl_get_stage_timing},
 
   { -1, NULL},
 };
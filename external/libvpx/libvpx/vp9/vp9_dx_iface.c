@@ -52,8 +52,10 @@ struct vpx_codec_alg_priv {
   int                     flushed;
   int                     invert_tile_order;
   int                     last_show_frame;  
+  int                     last_show_by_ref;
   int                     byte_alignment;
   int                     skip_loop_filter;
+  int                     stage_timing;
 
   
   int                     frame_parallel_decode;  
@@ -440,6 +442,8 @@ static vpx_codec_err_t init_decoder(vpx_codec_alg_priv_t *ctx) {
 
     frame_worker_data->pbi->inv_tile_order = ctx->invert_tile_order;
     frame_worker_data->pbi->frame_parallel_decode = ctx->frame_parallel_decode;
+    frame_worker_data->pbi->stage_timing_enabled =
+        !ctx->frame_parallel_decode && ctx->stage_timing;
     frame_worker_data->pbi->common.frame_parallel_decode =
         ctx->frame_parallel_decode;
     worker->hook = (VPxWorkerHook)frame_worker_hook;
@@ -739,6 +743,7 @@ static vpx_image_t *decoder_get_frame(vpx_codec_alg_priv_t *ctx,
   if (ctx->num_cache_frames > 0) {
     release_last_output_frame(ctx);
     ctx->last_show_frame  = ctx->frame_cache[ctx->frame_cache_read].fb_idx;
+    ctx->last_show_by_ref = 1;
     if (ctx->need_resync)
       return NULL;
     img = &ctx->frame_cache[ctx->frame_cache_read].img;
@@ -775,6 +780,8 @@ static vpx_image_t *decoder_get_frame(vpx_codec_alg_priv_t *ctx,
           RefCntBuffer *const frame_bufs = cm->buffer_pool->frame_bufs;
           release_last_output_frame(ctx);
           ctx->last_show_frame = frame_worker_data->pbi->common.new_fb_idx;
+          ctx->last_show_by_ref =
+              sd.y_buffer == frame_bufs[cm->new_fb_idx].buf.y_buffer;
           if (ctx->need_resync)
             return NULL;
           yuvconfig2image(&ctx->img, &sd, frame_worker_data->user_priv);
@@ -1081,6 +1088,97 @@ static vpx_codec_err_t ctrl_set_skip_loop_filter(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_OK;
 }
 
+static vpx_codec_err_t ctrl_set_stage_timing(vpx_codec_alg_priv_t *ctx,
+                                             va_list args) {
+  ctx->stage_timing = va_arg(args, int);
+
+  if (ctx->frame_parallel_decode) {
+    set_error_detail(ctx, "Not supported in frame parallel decode");
+    return VPX_CODEC_INCAPABLE;
+  }
+
+  if (ctx->frame_workers) {
+    VPxWorker *const worker = ctx->frame_workers;
+    FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+    frame_worker_data->pbi->stage_timing_enabled = ctx->stage_timing;
+    vp9_zero(frame_worker_data->pbi->stage_timing);
+  }
+
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_get_stage_timing(vpx_codec_alg_priv_t *ctx,
+                                             va_list args) {
+  vpx_stage_timing_t *const timing = va_arg(args, vpx_stage_timing_t *);
+
+  if (ctx->frame_parallel_decode) {
+    set_error_detail(ctx, "Not supported in frame parallel decode");
+    return VPX_CODEC_INCAPABLE;
+  }
+
+  if (timing) {
+    if (ctx->frame_workers) {
+      VPxWorker *const worker = ctx->frame_workers;
+      FrameWorkerData *const frame_worker_data =
+          (FrameWorkerData *)worker->data1;
+      *timing = frame_worker_data->pbi->stage_timing;
+    } else {
+      memset(timing, 0, sizeof(*timing));
+    }
+    return VPX_CODEC_OK;
+  }
+
+  return VPX_CODEC_INVALID_PARAM;
+}
+
+static vpx_codec_err_t ctrl_hold_frame(vpx_codec_alg_priv_t *ctx,
+                                       va_list args) {
+  int *const handle = va_arg(args, int *);
+  BufferPool *const pool = ctx->buffer_pool;
+
+  if (handle == NULL)
+    return VPX_CODEC_INVALID_PARAM;
+
+  if (ctx->frame_workers == NULL || ctx->last_show_frame < 0)
+    return VPX_CODEC_ERROR;
+
+  if (!ctx->last_show_by_ref) {
+    set_error_detail(ctx, "Postprocessed frames can not be held");
+    return VPX_CODEC_INCAPABLE;
+  }
+
+  lock_buffer_pool(pool);
+  ++pool->frame_bufs[ctx->last_show_frame].ref_count;
+  unlock_buffer_pool(pool);
+  *handle = ctx->last_show_frame;
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_release_frame(vpx_codec_alg_priv_t *ctx,
+                                          va_list args) {
+  const int handle = va_arg(args, int);
+  BufferPool *const pool = ctx->buffer_pool;
+  RefCntBuffer *frame_bufs;
+  VP9_COMMON *cm;
+
+  if (ctx->frame_workers == NULL || handle < 0 || handle >= FRAME_BUFFERS)
+    return VPX_CODEC_INVALID_PARAM;
+
+  cm = &((FrameWorkerData *)ctx->frame_workers[0].data1)->pbi->common;
+  frame_bufs = pool->frame_bufs;
+  lock_buffer_pool(pool);
+  if (frame_bufs[handle].ref_count <= 0) {
+    unlock_buffer_pool(pool);
+    return VPX_CODEC_INVALID_PARAM;
+  }
+  if (!ctx->frame_parallel_decode && handle == cm->new_fb_idx)
+    --frame_bufs[handle].ref_count;
+  else
+    decrease_ref_count(handle, frame_bufs, pool);
+  unlock_buffer_pool(pool);
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   {VP8_COPY_REFERENCE,            ctrl_copy_reference},
 
@@ -1095,6 +1193,9 @@ static vpx_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   {VPXD_SET_DECRYPTOR,            ctrl_set_decryptor},
   {VP9_SET_BYTE_ALIGNMENT,        ctrl_set_byte_alignment},
   {VP9_SET_SKIP_LOOP_FILTER,      ctrl_set_skip_loop_filter},
+  {VP9_SET_STAGE_TIMING,          ctrl_set_stage_timing},
+  {VP9D_HOLD_FRAME,               ctrl_hold_frame},
+  {VP9D_RELEASE_FRAME,            ctrl_release_frame},
 
   
   {VP8D_GET_LAST_REF_UPDATES,     ctrl_get_last_ref_updates},
@@ -1103,6 +1204,7 @@ static vpx_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   {VP9D_GET_DISPLAY_SIZE,         ctrl_get_display_size},
   {VP9D_GET_BIT_DEPTH,            ctrl_get_bit_depth},
   {VP9D_GET_FRAME_SIZE,           ctrl_get_frame_size},
+  {VP9_GET_STAGE_TIMING,          ctrl_get_stage_timing},
 
   { -1, NULL},
 };
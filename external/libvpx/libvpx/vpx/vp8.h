@@ -28,6 +28,8 @@ enum vp8_com_control_id {
   VP8_SET_DBG_DISPLAY_MV      = 7,    
 
   VP9_GET_REFERENCE           = 128,  
+  VP9_SET_STAGE_TIMING        = 129,
+  VP9_GET_STAGE_TIMING        = 130,
   VP8_COMMON_CTRL_ID_MAX,
   VP8_DECODER_CTRL_ID_START   = 256
 };
@@ -67,6 +69,24 @@ typedef struct vp9_ref_frame {
   vpx_image_t  img; 
 } vp9_ref_frame_t;
 
+typedef enum vpx_codec_stage {
+  VPX_STAGE_HEADER,
+  VPX_STAGE_ENTROPY,
+  VPX_STAGE_PREDICTION,
+  VPX_STAGE_TRANSFORM,
+  VPX_STAGE_LOOP_FILTER,
+  VPX_STAGE_POSTPROC,
+  VPX_STAGE_MOTION_SEARCH,
+  VPX_STAGE_MODE_DECISION,
+  VPX_STAGE_TEMPORAL_FILTER,
+  VPX_STAGE_COUNT
+} vpx_codec_stage_t;
+
+typedef struct vpx_stage_timing {
+  uint64_t ns[VPX_STAGE_COUNT];
+  uint64_t total_ns;
+} vpx_stage_timing_t;
+
 VPX_CTRL_USE_TYPE(VP8_SET_REFERENCE,           vpx_ref_frame_t *)
 VPX_CTRL_USE_TYPE(VP8_COPY_REFERENCE,          vpx_ref_frame_t *)
 VPX_CTRL_USE_TYPE(VP8_SET_POSTPROC,            vp8_postproc_cfg_t *)
@@ -75,6 +95,8 @@ VPX_CTRL_USE_TYPE(VP8_SET_DBG_COLOR_MB_MODES,  int)
 VPX_CTRL_USE_TYPE(VP8_SET_DBG_COLOR_B_MODES,   int)
 VPX_CTRL_USE_TYPE(VP8_SET_DBG_DISPLAY_MV,      int)
 VPX_CTRL_USE_TYPE(VP9_GET_REFERENCE,           vp9_ref_frame_t *)
+VPX_CTRL_USE_TYPE(VP9_SET_STAGE_TIMING,        int)
+VPX_CTRL_USE_TYPE(VP9_GET_STAGE_TIMING,        vpx_stage_timing_t *)
 
 
 #ifdef __cplusplus
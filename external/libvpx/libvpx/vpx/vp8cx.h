@@ -142,6 +142,8 @@ enum vp8e_enc_control_id {
   VP9E_SET_MAX_GF_INTERVAL,
 
   VP9E_GET_ACTIVEMAP,
+
+  VP9E_SET_SVC_REUSE_LOWER_LAYER,
 };
 
 typedef enum vpx_scaling_mode_1d {
@@ -280,6 +282,9 @@ VPX_CTRL_USE_TYPE(VP9E_SET_MAX_GF_INTERVAL,  unsigned int)
 #define VPX_CTRL_VP9E_SET_MAX_GF_INTERVAL
 
 VPX_CTRL_USE_TYPE(VP9E_GET_ACTIVEMAP, vpx_active_map_t *)
+
+VPX_CTRL_USE_TYPE(VP9E_SET_SVC_REUSE_LOWER_LAYER, unsigned int)
+#define VPX_CTRL_VP9E_SET_SVC_REUSE_LOWER_LAYER
 #ifdef __cplusplus
 }  
 #endif
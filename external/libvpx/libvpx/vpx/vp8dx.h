@@ -51,6 +51,10 @@ enum vp8_dec_control_id {
 
   VP9_SET_SKIP_LOOP_FILTER,
 
+  VP9D_HOLD_FRAME,
+
+  VP9D_RELEASE_FRAME,
+
   VP8_DECODER_CTRL_ID_MAX
 };
 
@@ -79,6 +83,8 @@ VPX_CTRL_USE_TYPE(VP9D_GET_DISPLAY_SIZE,        int *)
 VPX_CTRL_USE_TYPE(VP9D_GET_BIT_DEPTH,           unsigned int *)
 VPX_CTRL_USE_TYPE(VP9D_GET_FRAME_SIZE,          int *)
 VPX_CTRL_USE_TYPE(VP9_INVERT_TILE_DECODE_ORDER, int)
+VPX_CTRL_USE_TYPE(VP9D_HOLD_FRAME,              int *)
+VPX_CTRL_USE_TYPE(VP9D_RELEASE_FRAME,           int)
 
 
 #ifdef __cplusplus
@@ -0,0 +1,69 @@
+/*
+ *  Copyright (c) 2016 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <arm_neon.h>
+
+#include "./vpx_config.h"
+#include "./vpx_dsp_rtcd.h"
+
+#include "vpx/vpx_integer.h"
+
+static INLINE void store_strip_sums(uint32_t *dst, uint32x4_t lo,
+                                    uint32x4_t hi) {
+  vst1q_u32(dst, vcombine_u32(vpadd_u32(vget_low_u32(lo), vget_high_u32(lo)),
+                              vpadd_u32(vget_low_u32(hi), vget_high_u32(hi))));
+}
+
+void vpx_ssim_parms_4x8_row_neon(const uint8_t *s, int sp, const uint8_t *r,
+                                 int rp, int count, uint32_t *sum_s,
+                                 uint32_t *sum_r, uint32_t *sum_sq_s,
+                                 uint32_t *sum_sq_r, uint32_t *sum_sxr) {
+  int i, k;
+
+  for (k = 0; k + 4 <= count; k += 4) {
+    uint16x8_t s_lo = vdupq_n_u16(0), s_hi = vdupq_n_u16(0);
+    uint16x8_t r_lo = vdupq_n_u16(0), r_hi = vdupq_n_u16(0);
+    uint32x4_t ss_lo = vdupq_n_u32(0), ss_hi = vdupq_n_u32(0);
+    uint32x4_t rr_lo = vdupq_n_u32(0), rr_hi = vdupq_n_u32(0);
+    uint32x4_t sr_lo = vdupq_n_u32(0), sr_hi = vdupq_n_u32(0);
+
+    for (i = 0; i < 8; ++i) {
+      const uint8x16_t s8 = vld1q_u8(s + i * sp + 4 * k);
+      const uint8x16_t r8 = vld1q_u8(r + i * rp + 4 * k);
+      const uint8x8_t sl = vget_low_u8(s8);
+      const uint8x8_t sh = vget_high_u8(s8);
+      const uint8x8_t rl = vget_low_u8(r8);
+      const uint8x8_t rh = vget_high_u8(r8);
+
+      s_lo = vaddw_u8(s_lo, sl);
+      s_hi = vaddw_u8(s_hi, sh);
+      r_lo = vaddw_u8(r_lo, rl);
+      r_hi = vaddw_u8(r_hi, rh);
+      ss_lo = vpadalq_u16(ss_lo, vmull_u8(sl, sl));
+      ss_hi = vpadalq_u16(ss_hi, vmull_u8(sh, sh));
+      rr_lo = vpadalq_u16(rr_lo, vmull_u8(rl, rl));
+      rr_hi = vpadalq_u16(rr_hi, vmull_u8(rh, rh));
+      sr_lo = vpadalq_u16(sr_lo, vmull_u8(sl, rl));
+      sr_hi = vpadalq_u16(sr_hi, vmull_u8(sh, rh));
+    }
+
+    store_strip_sums(sum_s + k, vpaddlq_u16(s_lo), vpaddlq_u16(s_hi));
+    store_strip_sums(sum_r + k, vpaddlq_u16(r_lo), vpaddlq_u16(r_hi));
+    store_strip_sums(sum_sq_s + k, ss_lo, ss_hi);
+    store_strip_sums(sum_sq_r + k, rr_lo, rr_hi);
+    store_strip_sums(sum_sxr + k, sr_lo, sr_hi);
+  }
+
+  if (k < count) {
+    vpx_ssim_parms_4x8_row_c(s + 4 * k, sp, r + 4 * k, rp, count - k,
+                             sum_s + k, sum_r + k, sum_sq_s + k,
+                             sum_sq_r + k, sum_sxr + k);
+  }
+}
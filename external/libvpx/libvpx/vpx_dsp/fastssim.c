@@ -117,12 +117,12 @@ static void fs_downsample_level(fs_ctx *_ctx, int _l) {
     int j0offs;
     int j1offs;
     j0offs = 2 * j * w2;
-    j1offs = FS_MINI(2 * j + 1, h2) * w2;
+    j1offs = FS_MINI(2 * j + 1, h2 - 1) * w2;
     for (i = 0; i < w; i++) {
       int i0;
       int i1;
       i0 = 2 * i;
-      i1 = FS_MINI(i0 + 1, w2);
+      i1 = FS_MINI(i0 + 1, w2 - 1);
       dst1[j * w + i] = src1[j0offs + i0] + src1[j0offs + i1]
           + src1[j1offs + i0] + src1[j1offs + i1];
       dst2[j * w + i] = src2[j0offs + i0] + src2[j0offs + i1]
@@ -148,12 +148,12 @@ static void fs_downsample_level0(fs_ctx *_ctx, const unsigned char *_src1,
     int j0;
     int j1;
     j0 = 2 * j;
-    j1 = FS_MINI(j0 + 1, _h);
+    j1 = FS_MINI(j0 + 1, _h - 1);
     for (i = 0; i < w; i++) {
       int i0;
       int i1;
       i0 = 2 * i;
-      i1 = FS_MINI(i0 + 1, _w);
+      i1 = FS_MINI(i0 + 1, _w - 1);
       dst1[j * w + i] = _src1[j0 * _s1ystride + i0]
           + _src1[j0 * _s1ystride + i1] + _src1[j1 * _s1ystride + i0]
           + _src1[j1 * _s1ystride + i1];
@@ -417,8 +417,9 @@ static double fs_average(fs_ctx *_ctx, int _l) {
   return pow(ret / (w * h), FS_WEIGHTS[_l]);
 }
 
-static double calc_ssim(const unsigned char *_src, int _systride,
-                 const unsigned char *_dst, int _dystride, int _w, int _h) {
+double vpx_calc_fastssim_plane(const uint8_t *_src, int _systride,
+                               const uint8_t *_dst, int _dystride,
+                               int _w, int _h) {
   fs_ctx ctx;
   double ret;
   int l;
@@ -447,17 +448,20 @@ double vpx_calc_fastssim(const YV12_BUFFER_CONFIG *source,
   double ssimv;
   vpx_clear_system_state();
 
-  *ssim_y = calc_ssim(source->y_buffer, source->y_stride, dest->y_buffer,
-                      dest->y_stride, source->y_crop_width,
-                      source->y_crop_height);
+  *ssim_y = vpx_calc_fastssim_plane(source->y_buffer, source->y_stride,
+                                    dest->y_buffer, dest->y_stride,
+                                    source->y_crop_width,
+                                    source->y_crop_height);
 
-  *ssim_u = calc_ssim(source->u_buffer, source->uv_stride, dest->u_buffer,
-                      dest->uv_stride, source->uv_crop_width,
-                      source->uv_crop_height);
+  *ssim_u = vpx_calc_fastssim_plane(source->u_buffer, source->uv_stride,
+                                    dest->u_buffer, dest->uv_stride,
+                                    source->uv_crop_width,
+                                    source->uv_crop_height);
 
-  *ssim_v = calc_ssim(source->v_buffer, source->uv_stride, dest->v_buffer,
-                      dest->uv_stride, source->uv_crop_width,
-                      source->uv_crop_height);
+  *ssim_v = vpx_calc_fastssim_plane(source->v_buffer, source->uv_stride,
+                                    dest->v_buffer, dest->uv_stride,
+                                    source->uv_crop_width,
+                                    source->uv_crop_height);
   ssimv = (*ssim_y) * .8 + .1 * ((*ssim_u) + (*ssim_v));
 
   return convert_ssim_db(ssimv, 1.0);
@@ -86,10 +86,11 @@ static double convert_score_db(double _score, double _weight) {
   return 10 * (log10(255 * 255) - log10(_weight * _score));
 }
 
-static double calc_psnrhvs(const unsigned char *_src, int _systride,
-                           const unsigned char *_dst, int _dystride,
-                           double _par, int _w, int _h, int _step,
-                           const float _csf[8][8]) {
+static float calc_psnrhvs_rows(const unsigned char *_src, int _systride,
+                               const unsigned char *_dst, int _dystride,
+                               double _par, int _w, int _h, int _step,
+                               const float _csf[8][8], int _y_start,
+                               int _y_end, int *_pixels) {
   float ret;
   int16_t dct_s[8 * 8], dct_d[8 * 8];
   tran_low_t dct_s_coef[8 * 8], dct_d_coef[8 * 8];
@@ -103,7 +104,8 @@ static double calc_psnrhvs(const unsigned char *_src, int _systride,
     for (y = 0; y < 8; y++)
       mask[x][y] = (_csf[x][y] * 0.3885746225901003)
           * (_csf[x][y] * 0.3885746225901003);
-  for (y = 0; y < _h - 7; y += _step) {
+  for (y = (_y_start + _step - 1) / _step * _step; y < _y_end && y < _h - 7;
+       y += _step) {
     for (x = 0; x < _w - 7; x += _step) {
       int i;
       int j;
@@ -181,9 +183,29 @@ static double calc_psnrhvs(const unsigned char *_src, int _systride,
       }
     }
   }
-  ret /= pixels;
+  *_pixels += pixels;
   return ret;
 }
+
+static double calc_psnrhvs(const unsigned char *_src, int _systride,
+                           const unsigned char *_dst, int _dystride,
+                           double _par, int _w, int _h, int _step,
+                           const float _csf[8][8]) {
+  int pixels = 0;
+  const float ret = calc_psnrhvs_rows(_src, _systride, _dst, _dystride, _par,
+                                      _w, _h, _step, _csf, 0, _h, &pixels);
+  return ret / pixels;
+}
+
+double vpx_psnrhvs_rows(const uint8_t *src, int src_stride,
+                        const uint8_t *dst, int dst_stride, int width,
+                        int height, int plane, int row_start, int row_end,
+                        int *pixels) {
+  const float (*const csf)[8] = plane == 0 ? csf_y :
+                                plane == 1 ? csf_cb420 : csf_cr420;
+  return calc_psnrhvs_rows(src, src_stride, dst, dst_stride, 1.0, width,
+                           height, 7, csf, row_start, row_end, pixels);
+}
 double vpx_psnrhvs(const YV12_BUFFER_CONFIG *source,
                    const YV12_BUFFER_CONFIG *dest, double *y_psnrhvs,
                    double *u_psnrhvs, double *v_psnrhvs) {
@@ -0,0 +1,419 @@
+/*
+ *  Copyright (c) 2016 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "./vpx_config.h"
+#include "./vpx_dsp_rtcd.h"
+#include "vpx/internal/vpx_psnr.h"
+#include "vpx_dsp/quality_metrics.h"
+#if CONFIG_INTERNAL_STATS
+#include "vpx_dsp/ssim.h"
+#endif
+#include "vpx_dsp/vpx_dsp_common.h"
+#include "vpx_mem/vpx_mem.h"
+#include "vpx_ports/mem.h"
+#include "vpx_ports/system_state.h"
+
+#define METRICS_BAND_ROWS 64
+
+typedef struct {
+  int plane;
+  int row_start;
+  int row_end;
+  uint64_t sse;
+  double ssim;
+  int ssim_samples;
+  double psnrhvs;
+  int psnrhvs_pixels;
+  double blockiness;
+  double fastssim;
+} MetricsJob;
+
+typedef struct {
+  const uint8_t *src[3];
+  const uint8_t *dst[3];
+  int src_stride[3];
+  int dst_stride[3];
+  int width[3];
+  int height[3];
+  int flags;
+  int highbd;
+  unsigned int bit_depth;
+  MetricsJob *jobs;
+  int num_jobs;
+} MetricsContext;
+
+typedef struct {
+  MetricsContext *ctx;
+  int start;
+  int step;
+} MetricsWorkerData;
+
+static int horizontal_filter(const uint8_t *s) {
+  return (s[1] - s[-2]) * 2 + (s[-1] - s[0]) * 6;
+}
+
+static int vertical_filter(const uint8_t *s, int p) {
+  return (s[p] - s[-2 * p]) * 2 + (s[-p] - s[0]) * 6;
+}
+
+static int variance(int sum, int sum_squared, int size) {
+  return sum_squared / size - (sum / size) * (sum / size);
+}
+
+static int blockiness_vertical(const uint8_t *s, int sp, const uint8_t *r,
+                               int rp, int size) {
+  int s_blockiness = 0;
+  int r_blockiness = 0;
+  int sum_0 = 0;
+  int sum_sq_0 = 0;
+  int sum_1 = 0;
+  int sum_sq_1 = 0;
+  int i;
+  int var_0;
+  int var_1;
+  for (i = 0; i < size; ++i, s += sp, r += rp) {
+    s_blockiness += horizontal_filter(s);
+    r_blockiness += horizontal_filter(r);
+    sum_0 += s[0];
+    sum_sq_0 += s[0]*s[0];
+    sum_1 += s[-1];
+    sum_sq_1 += s[-1]*s[-1];
+  }
+  var_0 = variance(sum_0, sum_sq_0, size);
+  var_1 = variance(sum_1, sum_sq_1, size);
+  r_blockiness = abs(r_blockiness);
+  s_blockiness = abs(s_blockiness);
+
+  if (r_blockiness > s_blockiness)
+    return (r_blockiness - s_blockiness) / (1 + var_0 + var_1);
+  else
+    return 0;
+}
+
+static int blockiness_horizontal(const uint8_t *s, int sp, const uint8_t *r,
+                                 int rp, int size) {
+  int s_blockiness = 0;
+  int r_blockiness = 0;
+  int sum_0 = 0;
+  int sum_sq_0 = 0;
+  int sum_1 = 0;
+  int sum_sq_1 = 0;
+  int i;
+  int var_0;
+  int var_1;
+  for (i = 0; i < size; ++i, ++s, ++r) {
+    s_blockiness += vertical_filter(s, sp);
+    r_blockiness += vertical_filter(r, rp);
+    sum_0 += s[0];
+    sum_sq_0 += s[0] * s[0];
+    sum_1 += s[-sp];
+    sum_sq_1 += s[-sp] * s[-sp];
+  }
+  var_0 = variance(sum_0, sum_sq_0, size);
+  var_1 = variance(sum_1, sum_sq_1, size);
+  r_blockiness = abs(r_blockiness);
+  s_blockiness = abs(s_blockiness);
+
+  if (r_blockiness > s_blockiness)
+    return (r_blockiness - s_blockiness) / (1 + var_0 + var_1);
+  else
+    return 0;
+}
+
+static double blockiness_rows(const uint8_t *img1, int img1_pitch,
+                              const uint8_t *img2, int img2_pitch,
+                              int width, int height, int row_start,
+                              int row_end) {
+  double blockiness = 0;
+  int i, j;
+  for (i = MAX((row_start + 3) & ~3, 4); i < row_end && i < height; i += 4) {
+    const uint8_t *const s = img1 + i * img1_pitch;
+    const uint8_t *const r = img2 + i * img2_pitch;
+    for (j = 4; j < width; j += 4) {
+      blockiness += blockiness_vertical(s + j, img1_pitch, r + j, img2_pitch,
+                                        4);
+      blockiness += blockiness_horizontal(s + j, img1_pitch, r + j,
+                                          img2_pitch, 4);
+    }
+  }
+  return blockiness;
+}
+
+double vpx_get_blockiness(const uint8_t *img1, int img1_pitch,
+                          const uint8_t *img2, int img2_pitch,
+                          int width, int height) {
+  double blockiness;
+  vpx_clear_system_state();
+  blockiness = blockiness_rows(img1, img1_pitch, img2, img2_pitch, width,
+                               height, 0, height);
+  return blockiness / (width * height / 16);
+}
+
+static uint64_t band_sse(const uint8_t *a, int a_stride, const uint8_t *b,
+                         int b_stride, int width, int rows) {
+  const int w16 = width & ~15;
+  const int h16 = rows & ~15;
+  uint64_t total = 0;
+  int x, y;
+
+  for (y = 0; y < h16; y += 16) {
+    for (x = 0; x < w16; x += 16) {
+      unsigned int sse;
+      vpx_mse16x16(a + y * a_stride + x, a_stride, b + y * b_stride + x,
+                   b_stride, &sse);
+      total += sse;
+    }
+  }
+
+  for (y = 0; y < rows; ++y) {
+    for (x = y < h16 ? w16 : 0; x < width; ++x) {
+      const int diff = a[y * a_stride + x] - b[y * b_stride + x];
+      total += diff * diff;
+    }
+  }
+  return total;
+}
+
+#if CONFIG_VP9_HIGHBITDEPTH
+static uint64_t highbd_band_sse(const uint8_t *a8, int a_stride,
+                                const uint8_t *b8, int b_stride, int width,
+                                int rows) {
+  const uint16_t *a = CONVERT_TO_SHORTPTR(a8);
+  const uint16_t *b = CONVERT_TO_SHORTPTR(b8);
+  uint64_t total = 0;
+  int x, y;
+
+  for (y = 0; y < rows; ++y) {
+    for (x = 0; x < width; ++x) {
+      const int64_t diff = a[x] - b[x];
+      total += diff * diff;
+    }
+    a += a_stride;
+    b += b_stride;
+  }
+  return total;
+}
+#endif  
+
+static void run_metrics_job(const MetricsContext *ctx, MetricsJob *job) {
+  const int p = job->plane;
+  const uint8_t *const src = ctx->src[p];
+  const uint8_t *const dst = ctx->dst[p];
+  const int ss = ctx->src_stride[p];
+  const int ds = ctx->dst_stride[p];
+  const int w = ctx->width[p];
+  const int h = ctx->height[p];
+  const int rs = job->row_start;
+  const int re = job->row_end;
+
+#if CONFIG_INTERNAL_STATS
+  if (rs < 0) {
+    job->fastssim = vpx_calc_fastssim_plane(src, ss, dst, ds, w, h);
+    return;
+  }
+#endif
+
+  if (ctx->flags & VPX_METRIC_PSNR) {
+#if CONFIG_VP9_HIGHBITDEPTH
+    if (ctx->highbd)
+      job->sse = highbd_band_sse(src + rs * ss, ss, dst + rs * ds, ds, w,
+                                 re - rs);
+    else
+#endif
+      job->sse = band_sse(src + rs * ss, ss, dst + rs * ds, ds, w, re - rs);
+    vpx_clear_system_state();
+  }
+
+#if CONFIG_INTERNAL_STATS
+  if (ctx->flags & VPX_METRIC_SSIM) {
+#if CONFIG_VP9_HIGHBITDEPTH
+    if (ctx->highbd)
+      job->ssim = vpx_highbd_ssim_rows(src, ss, dst, ds, w, h, rs, re,
+                                       ctx->bit_depth, &job->ssim_samples);
+    else
+#endif
+      job->ssim = vpx_ssim_rows(src, ss, dst, ds, w, h, rs, re,
+                                &job->ssim_samples);
+  }
+
+  if (ctx->flags & VPX_METRIC_PSNRHVS)
+    job->psnrhvs = vpx_psnrhvs_rows(src, ss, dst, ds, w, h, p, rs, re,
+                                    &job->psnrhvs_pixels);
+#endif
+
+  if (p == 0 && (ctx->flags & VPX_METRIC_BLOCKINESS))
+    job->blockiness = blockiness_rows(src, ss, dst, ds, w, h, rs, re);
+}
+
+static int metrics_worker_hook(void *arg1, void *unused) {
+  MetricsWorkerData *const data = (MetricsWorkerData *)arg1;
+  MetricsContext *const ctx = data->ctx;
+  int j;
+  (void)unused;
+
+  vpx_clear_system_state();
+  for (j = data->start; j < ctx->num_jobs; j += data->step)
+    run_metrics_job(ctx, &ctx->jobs[j]);
+  return 1;
+}
+
+int vpx_calc_quality_metrics(const YV12_BUFFER_CONFIG *source,
+                             const YV12_BUFFER_CONFIG *dest, int flags,
+                             unsigned int bit_depth, VPxWorker *workers,
+                             int num_workers, QualityMetrics *metrics) {
+  MetricsContext ctx;
+  double ssim_total[3] = {0, 0, 0}, hvs_total[3] = {0, 0, 0};
+  int ssim_samples[3] = {0, 0, 0}, hvs_pixels[3] = {0, 0, 0};
+  double peak = 255.0;
+  int p, j, row;
+
+  memset(metrics, 0, sizeof(*metrics));
+  memset(&ctx, 0, sizeof(ctx));
+  vpx_clear_system_state();
+
+#if !CONFIG_INTERNAL_STATS
+  flags &= VPX_METRIC_PSNR | VPX_METRIC_BLOCKINESS;
+#endif
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (source->flags & YV12_FLAG_HIGHBITDEPTH) {
+    ctx.highbd = 1;
+    peak = (double)((1 << bit_depth) - 1);
+    flags &= VPX_METRIC_PSNR | VPX_METRIC_SSIM;
+  }
+#endif
+  ctx.flags = flags;
+  ctx.bit_depth = bit_depth;
+
+  ctx.src[0] = source->y_buffer;
+  ctx.src[1] = source->u_buffer;
+  ctx.src[2] = source->v_buffer;
+  ctx.dst[0] = dest->y_buffer;
+  ctx.dst[1] = dest->u_buffer;
+  ctx.dst[2] = dest->v_buffer;
+  ctx.src_stride[0] = source->y_stride;
+  ctx.src_stride[1] = ctx.src_stride[2] = source->uv_stride;
+  ctx.dst_stride[0] = dest->y_stride;
+  ctx.dst_stride[1] = ctx.dst_stride[2] = dest->uv_stride;
+  ctx.width[0] = source->y_crop_width;
+  ctx.width[1] = ctx.width[2] = source->uv_crop_width;
+  ctx.height[0] = source->y_crop_height;
+  ctx.height[1] = ctx.height[2] = source->uv_crop_height;
+
+  for (p = 0; p < 3; ++p)
+    ctx.num_jobs += 1 + (ctx.height[p] + METRICS_BAND_ROWS - 1) /
+                        METRICS_BAND_ROWS;
+  ctx.jobs = (MetricsJob *)vpx_calloc(ctx.num_jobs, sizeof(*ctx.jobs));
+  if (!ctx.jobs)
+    return -1;
+
+  ctx.num_jobs = 0;
+  if (flags & VPX_METRIC_FASTSSIM) {
+    for (p = 0; p < 3; ++p) {
+      ctx.jobs[ctx.num_jobs].plane = p;
+      ctx.jobs[ctx.num_jobs].row_start = -1;
+      ++ctx.num_jobs;
+    }
+  }
+  for (p = 0; p < 3; ++p) {
+    for (row = 0; row < ctx.height[p]; row += METRICS_BAND_ROWS) {
+      ctx.jobs[ctx.num_jobs].plane = p;
+      ctx.jobs[ctx.num_jobs].row_start = row;
+      ctx.jobs[ctx.num_jobs].row_end = MIN(row + METRICS_BAND_ROWS,
+                                           ctx.height[p]);
+      ++ctx.num_jobs;
+    }
+  }
+
+  if (workers != NULL && num_workers > 1) {
+    const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+    MetricsWorkerData *const data =
+        (MetricsWorkerData *)vpx_malloc(num_workers * sizeof(*data));
+    if (!data) {
+      vpx_free(ctx.jobs);
+      return -1;
+    }
+    for (j = 0; j < num_workers; ++j) {
+      VPxWorker *const worker = &workers[j];
+      data[j].ctx = &ctx;
+      data[j].start = j;
+      data[j].step = num_workers;
+      worker->hook = (VPxWorkerHook)metrics_worker_hook;
+      worker->data1 = &data[j];
+      worker->data2 = NULL;
+      if (j == num_workers - 1)
+        winterface->execute(worker);
+      else
+        winterface->launch(worker);
+    }
+    for (j = 0; j < num_workers; ++j)
+      winterface->sync(&workers[j]);
+    vpx_free(data);
+  } else {
+    MetricsWorkerData data;
+    data.ctx = &ctx;
+    data.start = 0;
+    data.step = 1;
+    metrics_worker_hook(&data, NULL);
+  }
+  vpx_clear_system_state();
+
+  for (j = 0; j < ctx.num_jobs; ++j) {
+    const MetricsJob *const job = &ctx.jobs[j];
+    if (job->row_start < 0) {
+      metrics->fastssim[1 + job->plane] = job->fastssim;
+      continue;
+    }
+    metrics->sse[1 + job->plane] += job->sse;
+    ssim_total[job->plane] += job->ssim;
+    ssim_samples[job->plane] += job->ssim_samples;
+    hvs_total[job->plane] += job->psnrhvs;
+    hvs_pixels[job->plane] += job->psnrhvs_pixels;
+    metrics->blockiness += job->blockiness;
+  }
+  vpx_free(ctx.jobs);
+
+  for (p = 0; p < 3; ++p) {
+    const uint32_t samples = ctx.width[p] * ctx.height[p];
+    metrics->samples[1 + p] = samples;
+    metrics->samples[0] += samples;
+    metrics->sse[0] += metrics->sse[1 + p];
+    if (flags & VPX_METRIC_PSNR)
+      metrics->psnr[1 + p] = vpx_sse_to_psnr(samples, peak,
+                                             (double)metrics->sse[1 + p]);
+    if (ssim_samples[p])
+      metrics->ssim[1 + p] = ssim_total[p] / ssim_samples[p];
+    if (hvs_pixels[p])
+      metrics->psnrhvs[1 + p] = hvs_total[p] / hvs_pixels[p];
+  }
+
+  if (flags & VPX_METRIC_PSNR)
+    metrics->psnr[0] = vpx_sse_to_psnr(metrics->samples[0], peak,
+                                       (double)metrics->sse[0]);
+  if (flags & VPX_METRIC_SSIM)
+    metrics->ssim[0] = metrics->ssim[1] * .8 +
+                       .1 * (metrics->ssim[2] + metrics->ssim[3]);
+  if (flags & VPX_METRIC_FASTSSIM) {
+    const double v = metrics->fastssim[1] * .8 +
+                     .1 * (metrics->fastssim[2] + metrics->fastssim[3]);
+    metrics->fastssim[0] = 10 * (log10(1.0) - log10(1.0 - v));
+  }
+  if (flags & VPX_METRIC_PSNRHVS) {
+    const double v = metrics->psnrhvs[1] * .8 +
+                     .1 * (metrics->psnrhvs[2] + metrics->psnrhvs[3]);
+    metrics->psnrhvs[0] = 10 * (log10(255 * 255) - log10(v));
+  }
+  if (flags & VPX_METRIC_BLOCKINESS)
+    metrics->blockiness /= ctx.width[0] * ctx.height[0] / 16;
+  return 0;
+}
@@ -0,0 +1,54 @@
+/*
+ *  Copyright (c) 2016 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VPX_DSP_QUALITY_METRICS_H_
+#define VPX_DSP_QUALITY_METRICS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "./vpx_config.h"
+#include "vpx_scale/yv12config.h"
+#include "vpx_util/vpx_thread.h"
+
+#define VPX_METRIC_PSNR       (1 << 0)
+#define VPX_METRIC_SSIM       (1 << 1)
+#define VPX_METRIC_FASTSSIM   (1 << 2)
+#define VPX_METRIC_PSNRHVS    (1 << 3)
+#define VPX_METRIC_BLOCKINESS (1 << 4)
+#define VPX_METRIC_ALL        0x1f
+
+typedef struct {
+  uint64_t sse[4];
+  uint32_t samples[4];
+  double psnr[4];
+  double ssim[4];
+  double fastssim[4];
+  double psnrhvs[4];
+  double blockiness;
+} QualityMetrics;
+
+double vpx_get_blockiness(const uint8_t *img1, int img1_pitch,
+                          const uint8_t *img2, int img2_pitch,
+                          int width, int height);
+
+// SSIM, FastSSIM and PSNR-HVS are only computed with
+// CONFIG_INTERNAL_STATS; without it those flags are ignored.
+int vpx_calc_quality_metrics(const YV12_BUFFER_CONFIG *source,
+                             const YV12_BUFFER_CONFIG *dest, int flags,
+                             unsigned int bit_depth, VPxWorker *workers,
+                             int num_workers, QualityMetrics *metrics);
+
+#ifdef __cplusplus
+}  
+#endif
+
+#endif  
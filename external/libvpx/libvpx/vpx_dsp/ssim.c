@@ -11,6 +11,7 @@
 #include <math.h>
 #include "./vpx_dsp_rtcd.h"
 #include "vpx_dsp/ssim.h"
+#include "vpx_dsp/vpx_dsp_common.h"
 #include "vpx_ports/mem.h"
 #include "vpx_ports/system_state.h"
 
@@ -45,6 +46,27 @@ void vpx_ssim_parms_8x8_c(const uint8_t *s, int sp, const uint8_t *r, int rp,
   }
 }
 
+void vpx_ssim_parms_4x8_row_c(const uint8_t *s, int sp, const uint8_t *r,
+                              int rp, int count, uint32_t *sum_s,
+                              uint32_t *sum_r, uint32_t *sum_sq_s,
+                              uint32_t *sum_sq_r, uint32_t *sum_sxr) {
+  int i, j, k;
+  for (k = 0; k < count; k++, s += 4, r += 4) {
+    sum_s[k] = sum_r[k] = sum_sq_s[k] = sum_sq_r[k] = sum_sxr[k] = 0;
+    for (i = 0; i < 8; i++) {
+      for (j = 0; j < 4; j++) {
+        const int a = s[i * sp + j];
+        const int b = r[i * rp + j];
+        sum_s[k] += a;
+        sum_r[k] += b;
+        sum_sq_s[k] += a * a;
+        sum_sq_r[k] += b * b;
+        sum_sxr[k] += a * b;
+      }
+    }
+  }
+}
+
 #if CONFIG_VP9_HIGHBITDEPTH
 void vpx_highbd_ssim_parms_8x8_c(const uint16_t *s, int sp,
                                  const uint16_t *r, int rp,
@@ -87,11 +109,25 @@ static double similarity(uint32_t sum_s, uint32_t sum_r,
   return ssim_n * 1.0 / ssim_d;
 }
 
-static double ssim_8x8(const uint8_t *s, int sp, const uint8_t *r, int rp) {
-  uint32_t sum_s = 0, sum_r = 0, sum_sq_s = 0, sum_sq_r = 0, sum_sxr = 0;
-  vpx_ssim_parms_8x8(s, sp, r, rp, &sum_s, &sum_r, &sum_sq_s, &sum_sq_r,
-                     &sum_sxr);
-  return similarity(sum_s, sum_r, sum_sq_s, sum_sq_r, sum_sxr, 64);
+#define SSIM_ROW_WINDOWS 64
+
+static void ssim_8x8_row(const uint8_t *s, int sp, const uint8_t *r, int rp,
+                         int windows, double *total) {
+  uint32_t sum_s[SSIM_ROW_WINDOWS + 1], sum_r[SSIM_ROW_WINDOWS + 1];
+  uint32_t sum_sq_s[SSIM_ROW_WINDOWS + 1], sum_sq_r[SSIM_ROW_WINDOWS + 1];
+  uint32_t sum_sxr[SSIM_ROW_WINDOWS + 1];
+  int j, k;
+  for (j = 0; j < windows; j += SSIM_ROW_WINDOWS) {
+    const int n = MIN(windows - j, SSIM_ROW_WINDOWS);
+    vpx_ssim_parms_4x8_row(s + 4 * j, sp, r + 4 * j, rp, n + 1, sum_s, sum_r,
+                           sum_sq_s, sum_sq_r, sum_sxr);
+    for (k = 0; k < n; k++) {
+      *total += similarity(sum_s[k] + sum_s[k + 1], sum_r[k] + sum_r[k + 1],
+                           sum_sq_s[k] + sum_sq_s[k + 1],
+                           sum_sq_r[k] + sum_sq_r[k + 1],
+                           sum_sxr[k] + sum_sxr[k + 1], 64);
+    }
+  }
 }
 
 #if CONFIG_VP9_HIGHBITDEPTH
@@ -110,47 +146,60 @@ static double highbd_ssim_8x8(const uint16_t *s, int sp, const uint16_t *r,
 }
 #endif  
 
+double vpx_ssim_rows(const uint8_t *img1, int stride_img1,
+                     const uint8_t *img2, int stride_img2, int width,
+                     int height, int row_start, int row_end, int *samples) {
+  const int windows = width >= 8 ? (width - 8) / 4 + 1 : 0;
+  double ssim_total = 0;
+  int i;
+
+  for (i = (row_start + 3) & ~3; i < row_end && i <= height - 8; i += 4) {
+    ssim_8x8_row(img1 + i * stride_img1, stride_img1,
+                 img2 + i * stride_img2, stride_img2, windows, &ssim_total);
+    *samples += windows;
+  }
+  return ssim_total;
+}
+
 static double vpx_ssim2(const uint8_t *img1, const uint8_t *img2,
                         int stride_img1, int stride_img2, int width,
                         int height) {
-  int i, j;
   int samples = 0;
+  const double ssim_total = vpx_ssim_rows(img1, stride_img1, img2,
+                                          stride_img2, width, height, 0,
+                                          height, &samples);
+  return ssim_total / samples;
+}
+
+#if CONFIG_VP9_HIGHBITDEPTH
+double vpx_highbd_ssim_rows(const uint8_t *img1, int stride_img1,
+                            const uint8_t *img2, int stride_img2, int width,
+                            int height, int row_start, int row_end,
+                            unsigned int bd, int *samples) {
   double ssim_total = 0;
+  int i, j;
 
-  
-  for (i = 0; i <= height - 8;
-       i += 4, img1 += stride_img1 * 4, img2 += stride_img2 * 4) {
+  for (i = (row_start + 3) & ~3; i < row_end && i <= height - 8; i += 4) {
+    const uint8_t *const s = img1 + i * stride_img1;
+    const uint8_t *const r = img2 + i * stride_img2;
     for (j = 0; j <= width - 8; j += 4) {
-      double v = ssim_8x8(img1 + j, stride_img1, img2 + j, stride_img2);
-      ssim_total += v;
-      samples++;
+      ssim_total += highbd_ssim_8x8(CONVERT_TO_SHORTPTR(s + j), stride_img1,
+                                    CONVERT_TO_SHORTPTR(r + j), stride_img2,
+                                    bd);
+      ++*samples;
     }
   }
-  ssim_total /= samples;
   return ssim_total;
 }
 
-#if CONFIG_VP9_HIGHBITDEPTH
 static double vpx_highbd_ssim2(const uint8_t *img1, const uint8_t *img2,
                                int stride_img1, int stride_img2, int width,
                                int height, unsigned int bd) {
-  int i, j;
   int samples = 0;
-  double ssim_total = 0;
-
-  
-  for (i = 0; i <= height - 8;
-       i += 4, img1 += stride_img1 * 4, img2 += stride_img2 * 4) {
-    for (j = 0; j <= width - 8; j += 4) {
-      double v = highbd_ssim_8x8(CONVERT_TO_SHORTPTR(img1 + j), stride_img1,
-                                 CONVERT_TO_SHORTPTR(img2 + j), stride_img2,
-                                 bd);
-      ssim_total += v;
-      samples++;
-    }
-  }
-  ssim_total /= samples;
-  return ssim_total;
+  const double ssim_total = vpx_highbd_ssim_rows(img1, stride_img1, img2,
+                                                 stride_img2, width, height,
+                                                 0, height, bd, &samples);
+  return ssim_total / samples;
 }
 #endif  
 
@@ -62,6 +62,10 @@ double vpx_get_ssim_metrics(uint8_t *img1, int img1_pitch, uint8_t *img2,
                       int img2_pitch, int width, int height, Ssimv *sv2,
                       Metrics *m, int do_inconsistency);
 
+double vpx_ssim_rows(const uint8_t *img1, int stride_img1,
+                     const uint8_t *img2, int stride_img2, int width,
+                     int height, int row_start, int row_end, int *samples);
+
 double vpx_calc_ssim(const YV12_BUFFER_CONFIG *source,
                      const YV12_BUFFER_CONFIG *dest,
                      double *weight);
@@ -78,7 +82,21 @@ double vpx_psnrhvs(const YV12_BUFFER_CONFIG *source,
                    const YV12_BUFFER_CONFIG *dest,
                    double *ssim_y, double *ssim_u, double *ssim_v);
 
+double vpx_calc_fastssim_plane(const uint8_t *src, int src_stride,
+                               const uint8_t *dst, int dst_stride,
+                               int width, int height);
+
+double vpx_psnrhvs_rows(const uint8_t *src, int src_stride,
+                        const uint8_t *dst, int dst_stride, int width,
+                        int height, int plane, int row_start, int row_end,
+                        int *pixels);
+
 #if CONFIG_VP9_HIGHBITDEPTH
+double vpx_highbd_ssim_rows(const uint8_t *img1, int stride_img1,
+                            const uint8_t *img2, int stride_img2, int width,
+                            int height, int row_start, int row_end,
+                            unsigned int bd, int *samples);
+
 double vpx_highbd_calc_ssim(const YV12_BUFFER_CONFIG *source,
                             const YV12_BUFFER_CONFIG *dest,
                             double *weight,
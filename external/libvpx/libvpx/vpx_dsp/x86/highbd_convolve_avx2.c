@@ -0,0 +1,217 @@
+/*
+ *  Copyright (c) 2016 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+
+#include "./vpx_dsp_rtcd.h"
+#include "vpx_dsp/vpx_filter.h"
+#include "vpx_dsp/x86/convolve.h"
+#include "vpx_ports/mem.h"
+
+static INLINE __m256i highbd_filter_pair(const int16_t *filter, int k) {
+  return _mm256_set1_epi32((int)((uint16_t)filter[k] |
+                                 ((uint32_t)(uint16_t)filter[k + 1] << 16)));
+}
+
+static INLINE __m256i highbd_load_2x8(const uint16_t *a, const uint16_t *b) {
+  return _mm256_inserti128_si256(
+      _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)a)),
+      _mm_loadu_si128((const __m128i *)b), 1);
+}
+
+static INLINE __m256i highbd_load_2x4(const uint16_t *a, const uint16_t *b) {
+  return _mm256_inserti128_si256(
+      _mm256_castsi128_si256(_mm_loadl_epi64((const __m128i *)a)),
+      _mm_loadl_epi64((const __m128i *)b), 1);
+}
+
+static INLINE __m256i highbd_apply_filter(const __m256i *s, const __m256i *f,
+                                          int taps, __m256i max) {
+  const __m256i rounding = _mm256_set1_epi32(1 << (FILTER_BITS - 1));
+  __m256i lo = _mm256_madd_epi16(_mm256_unpacklo_epi16(s[0], s[1]), f[0]);
+  __m256i hi = _mm256_madd_epi16(_mm256_unpackhi_epi16(s[0], s[1]), f[0]);
+  int k;
+
+  for (k = 1; k < taps / 2; ++k) {
+    lo = _mm256_add_epi32(lo, _mm256_madd_epi16(
+        _mm256_unpacklo_epi16(s[2 * k], s[2 * k + 1]), f[k]));
+    hi = _mm256_add_epi32(hi, _mm256_madd_epi16(
+        _mm256_unpackhi_epi16(s[2 * k], s[2 * k + 1]), f[k]));
+  }
+
+  lo = _mm256_srai_epi32(_mm256_add_epi32(lo, rounding), FILTER_BITS);
+  hi = _mm256_srai_epi32(_mm256_add_epi32(hi, rounding), FILTER_BITS);
+  return _mm256_min_epu16(_mm256_packus_epi32(lo, hi), max);
+}
+
+static INLINE void highbd_filter_block_avx2(const uint16_t *src,
+                                            ptrdiff_t src_stride,
+                                            uint16_t *dst,
+                                            ptrdiff_t dst_stride,
+                                            unsigned int height,
+                                            const int16_t *filter, int bd,
+                                            int w, int vert, int taps,
+                                            int avg) {
+  const __m256i max = _mm256_set1_epi16((1 << bd) - 1);
+  const ptrdiff_t step = vert ? src_stride : 1;
+  __m256i f[4], s[8], res;
+  unsigned int r;
+  int i;
+
+  if (taps == 8) {
+    for (i = 0; i < 4; ++i)
+      f[i] = highbd_filter_pair(filter, 2 * i);
+    if (!vert)
+      src -= 3;
+  } else {
+    f[0] = highbd_filter_pair(filter, 3);
+  }
+
+  if (w == 16) {
+    for (r = 0; r < height; ++r) {
+      for (i = 0; i < taps; ++i)
+        s[i] = _mm256_loadu_si256((const __m256i *)(src + i * step));
+      res = highbd_apply_filter(s, f, taps, max);
+      if (avg)
+        res = _mm256_avg_epu16(res,
+                               _mm256_loadu_si256((const __m256i *)dst));
+      _mm256_storeu_si256((__m256i *)dst, res);
+      src += src_stride;
+      dst += dst_stride;
+    }
+    return;
+  }
+
+  for (r = 0; r < height; r += 2) {
+    const int pair = r + 1 < height;
+    const uint16_t *const src2 = pair ? src + src_stride : src;
+    uint16_t *const dst2 = pair ? dst + dst_stride : dst;
+    __m128i lo, hi;
+
+    for (i = 0; i < taps; ++i) {
+      s[i] = (w == 8) ? highbd_load_2x8(src + i * step, src2 + i * step)
+                      : highbd_load_2x4(src + i * step, src2 + i * step);
+    }
+    res = highbd_apply_filter(s, f, taps, max);
+    if (avg) {
+      res = _mm256_avg_epu16(res, (w == 8) ? highbd_load_2x8(dst, dst2)
+                                           : highbd_load_2x4(dst, dst2));
+    }
+
+    lo = _mm256_castsi256_si128(res);
+    hi = _mm256_extracti128_si256(res, 1);
+    if (w == 8) {
+      _mm_storeu_si128((__m128i *)dst, lo);
+      if (pair)
+        _mm_storeu_si128((__m128i *)dst2, hi);
+    } else {
+      _mm_storel_epi64((__m128i *)dst, lo);
+      if (pair)
+        _mm_storel_epi64((__m128i *)dst2, hi);
+    }
+    src += 2 * src_stride;
+    dst += 2 * dst_stride;
+  }
+}
+
+#define HIGHBD_FILTER_BLOCK_AVX2(w, dir, vert, taps, avg, is_avg) \
+  static void vpx_highbd_filter_block1d##w##_##dir##taps##_##avg##avx2( \
+      const uint16_t *src, ptrdiff_t src_stride, uint16_t *dst, \
+      ptrdiff_t dst_stride, unsigned int height, const int16_t *filter, \
+      int bd) { \
+    highbd_filter_block_avx2(src, src_stride, dst, dst_stride, height, \
+                             filter, bd, w, vert, taps, is_avg); \
+  }
+
+#define HIGHBD_FILTER_BLOCKS_AVX2(dir, vert, taps) \
+  HIGHBD_FILTER_BLOCK_AVX2(16, dir, vert, taps, , 0) \
+  HIGHBD_FILTER_BLOCK_AVX2(8, dir, vert, taps, , 0) \
+  HIGHBD_FILTER_BLOCK_AVX2(4, dir, vert, taps, , 0) \
+  HIGHBD_FILTER_BLOCK_AVX2(16, dir, vert, taps, avg_, 1) \
+  HIGHBD_FILTER_BLOCK_AVX2(8, dir, vert, taps, avg_, 1) \
+  HIGHBD_FILTER_BLOCK_AVX2(4, dir, vert, taps, avg_, 1)
+
+HIGHBD_FILTER_BLOCKS_AVX2(h, 0, 8)
+HIGHBD_FILTER_BLOCKS_AVX2(v, 1, 8)
+HIGHBD_FILTER_BLOCKS_AVX2(h, 0, 2)
+HIGHBD_FILTER_BLOCKS_AVX2(v, 1, 2)
+
+HIGH_FUN_CONV_1D(horiz, x_step_q4, filter_x, h, src, , avx2);
+HIGH_FUN_CONV_1D(vert, y_step_q4, filter_y, v, src - src_stride * 3, , avx2);
+HIGH_FUN_CONV_1D(avg_horiz, x_step_q4, filter_x, h, src, avg_, avx2);
+HIGH_FUN_CONV_1D(avg_vert, y_step_q4, filter_y, v, src - src_stride * 3, avg_,
+                 avx2);
+
+HIGH_FUN_CONV_2D(, avx2);
+HIGH_FUN_CONV_2D(avg_ , avx2);
+
+void vpx_highbd_convolve_copy_avx2(const uint8_t *src8, ptrdiff_t src_stride,
+                                   uint8_t *dst8, ptrdiff_t dst_stride,
+                                   const int16_t *filter_x, int filter_x_stride,
+                                   const int16_t *filter_y, int filter_y_stride,
+                                   int w, int h, int bd) {
+  const uint16_t *src = CONVERT_TO_SHORTPTR(src8);
+  uint16_t *dst = CONVERT_TO_SHORTPTR(dst8);
+  int r, c;
+  (void)filter_x;
+  (void)filter_x_stride;
+  (void)filter_y;
+  (void)filter_y_stride;
+  (void)bd;
+
+  for (r = 0; r < h; ++r) {
+    if (w >= 16) {
+      for (c = 0; c < w; c += 16)
+        _mm256_storeu_si256((__m256i *)(dst + c),
+                            _mm256_loadu_si256((const __m256i *)(src + c)));
+    } else if (w == 8) {
+      _mm_storeu_si128((__m128i *)dst, _mm_loadu_si128((const __m128i *)src));
+    } else {
+      _mm_storel_epi64((__m128i *)dst, _mm_loadl_epi64((const __m128i *)src));
+    }
+    src += src_stride;
+    dst += dst_stride;
+  }
+}
+
+void vpx_highbd_convolve_avg_avx2(const uint8_t *src8, ptrdiff_t src_stride,
+                                  uint8_t *dst8, ptrdiff_t dst_stride,
+                                  const int16_t *filter_x, int filter_x_stride,
+                                  const int16_t *filter_y, int filter_y_stride,
+                                  int w, int h, int bd) {
+  const uint16_t *src = CONVERT_TO_SHORTPTR(src8);
+  uint16_t *dst = CONVERT_TO_SHORTPTR(dst8);
+  int r, c;
+  (void)filter_x;
+  (void)filter_x_stride;
+  (void)filter_y;
+  (void)filter_y_stride;
+  (void)bd;
+
+  for (r = 0; r < h; ++r) {
+    if (w >= 16) {
+      for (c = 0; c < w; c += 16) {
+        const __m256i s = _mm256_loadu_si256((const __m256i *)(src + c));
+        const __m256i d = _mm256_loadu_si256((const __m256i *)(dst + c));
+        _mm256_storeu_si256((__m256i *)(dst + c), _mm256_avg_epu16(s, d));
+      }
+    } else if (w == 8) {
+      const __m128i s = _mm_loadu_si128((const __m128i *)src);
+      const __m128i d = _mm_loadu_si128((const __m128i *)dst);
+      _mm_storeu_si128((__m128i *)dst, _mm_avg_epu16(s, d));
+    } else {
+      const __m128i s = _mm_loadl_epi64((const __m128i *)src);
+      const __m128i d = _mm_loadl_epi64((const __m128i *)dst);
+      _mm_storel_epi64((__m128i *)dst, _mm_avg_epu16(s, d));
+    }
+    src += src_stride;
+    dst += dst_stride;
+  }
+}
@@ -0,0 +1,160 @@
+/*
+ *  Copyright (c) 2016 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+
+#include "./vpx_dsp_rtcd.h"
+#include "vpx_ports/mem.h"
+
+static INLINE int highbd_sum_avx2(const uint16_t *p, int n) {
+  const __m256i one = _mm256_set1_epi16(1);
+  __m256i sum = _mm256_madd_epi16(_mm256_loadu_si256((const __m256i *)p),
+                                  one);
+  __m128i s;
+
+  if (n == 32) {
+    sum = _mm256_add_epi32(sum, _mm256_madd_epi16(
+        _mm256_loadu_si256((const __m256i *)(p + 16)), one));
+  }
+
+  s = _mm_add_epi32(_mm256_castsi256_si128(sum),
+                    _mm256_extracti128_si256(sum, 1));
+  s = _mm_add_epi32(s, _mm_srli_si128(s, 8));
+  s = _mm_add_epi32(s, _mm_srli_si128(s, 4));
+  return _mm_cvtsi128_si32(s);
+}
+
+static INLINE void highbd_fill_avx2(uint16_t *dst, ptrdiff_t stride, int bs,
+                                    __m256i v) {
+  int r, c;
+
+  for (r = 0; r < bs; ++r) {
+    for (c = 0; c < bs; c += 16)
+      _mm256_storeu_si256((__m256i *)(dst + c), v);
+    dst += stride;
+  }
+}
+
+static INLINE void highbd_dc_predictor_avx2(uint16_t *dst, ptrdiff_t stride,
+                                            int bs, const uint16_t *above,
+                                            const uint16_t *left, int bd) {
+  const int sum = highbd_sum_avx2(above, bs) + highbd_sum_avx2(left, bs);
+  (void)bd;
+  highbd_fill_avx2(dst, stride, bs, _mm256_set1_epi16((sum + bs) / (2 * bs)));
+}
+
+static INLINE void highbd_dc_top_predictor_avx2(uint16_t *dst,
+                                                ptrdiff_t stride, int bs,
+                                                const uint16_t *above,
+                                                const uint16_t *left, int bd) {
+  const int sum = highbd_sum_avx2(above, bs);
+  (void)left;
+  (void)bd;
+  highbd_fill_avx2(dst, stride, bs, _mm256_set1_epi16((sum + bs / 2) / bs));
+}
+
+static INLINE void highbd_dc_left_predictor_avx2(uint16_t *dst,
+                                                 ptrdiff_t stride, int bs,
+                                                 const uint16_t *above,
+                                                 const uint16_t *left,
+                                                 int bd) {
+  const int sum = highbd_sum_avx2(left, bs);
+  (void)above;
+  (void)bd;
+  highbd_fill_avx2(dst, stride, bs, _mm256_set1_epi16((sum + bs / 2) / bs));
+}
+
+static INLINE void highbd_dc_128_predictor_avx2(uint16_t *dst,
+                                                ptrdiff_t stride, int bs,
+                                                const uint16_t *above,
+                                                const uint16_t *left, int bd) {
+  (void)above;
+  (void)left;
+  highbd_fill_avx2(dst, stride, bs, _mm256_set1_epi16(128 << (bd - 8)));
+}
+
+static INLINE void highbd_v_predictor_avx2(uint16_t *dst, ptrdiff_t stride,
+                                           int bs, const uint16_t *above,
+                                           const uint16_t *left, int bd) {
+  const __m256i a0 = _mm256_loadu_si256((const __m256i *)above);
+  const __m256i a1 = (bs == 32)
+      ? _mm256_loadu_si256((const __m256i *)(above + 16)) : a0;
+  int r;
+  (void)left;
+  (void)bd;
+
+  for (r = 0; r < bs; ++r) {
+    _mm256_storeu_si256((__m256i *)dst, a0);
+    if (bs == 32)
+      _mm256_storeu_si256((__m256i *)(dst + 16), a1);
+    dst += stride;
+  }
+}
+
+static INLINE void highbd_h_predictor_avx2(uint16_t *dst, ptrdiff_t stride,
+                                           int bs, const uint16_t *above,
+                                           const uint16_t *left, int bd) {
+  int r;
+  (void)above;
+  (void)bd;
+
+  for (r = 0; r < bs; ++r) {
+    const __m256i l = _mm256_set1_epi16(left[r]);
+    _mm256_storeu_si256((__m256i *)dst, l);
+    if (bs == 32)
+      _mm256_storeu_si256((__m256i *)(dst + 16), l);
+    dst += stride;
+  }
+}
+
+static INLINE void highbd_tm_predictor_avx2(uint16_t *dst, ptrdiff_t stride,
+                                            int bs, const uint16_t *above,
+                                            const uint16_t *left, int bd) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i max = _mm256_set1_epi16((1 << bd) - 1);
+  const __m256i top_left = _mm256_set1_epi16(above[-1]);
+  const __m256i d0 = _mm256_sub_epi16(
+      _mm256_loadu_si256((const __m256i *)above), top_left);
+  const __m256i d1 = (bs == 32) ? _mm256_sub_epi16(
+      _mm256_loadu_si256((const __m256i *)(above + 16)), top_left) : d0;
+  int r;
+
+  for (r = 0; r < bs; ++r) {
+    const __m256i l = _mm256_set1_epi16(left[r]);
+    const __m256i p0 = _mm256_add_epi16(l, d0);
+    _mm256_storeu_si256((__m256i *)dst,
+                        _mm256_min_epi16(_mm256_max_epi16(p0, zero), max));
+    if (bs == 32) {
+      const __m256i p1 = _mm256_add_epi16(l, d1);
+      _mm256_storeu_si256((__m256i *)(dst + 16),
+                          _mm256_min_epi16(_mm256_max_epi16(p1, zero), max));
+    }
+    dst += stride;
+  }
+}
+
+#define intra_pred_highbd_avx2(type, size) \
+  void vpx_highbd_##type##_predictor_##size##x##size##_avx2( \
+      uint16_t *dst, ptrdiff_t stride, const uint16_t *above, \
+      const uint16_t *left, int bd) { \
+    highbd_##type##_predictor_avx2(dst, stride, size, above, left, bd); \
+  }
+
+#define intra_pred_highbd_avx2_sizes(type) \
+  intra_pred_highbd_avx2(type, 16) \
+  intra_pred_highbd_avx2(type, 32)
+
+intra_pred_highbd_avx2_sizes(dc)
+intra_pred_highbd_avx2_sizes(dc_top)
+intra_pred_highbd_avx2_sizes(dc_left)
+intra_pred_highbd_avx2_sizes(dc_128)
+intra_pred_highbd_avx2_sizes(v)
+intra_pred_highbd_avx2_sizes(h)
+intra_pred_highbd_avx2_sizes(tm)
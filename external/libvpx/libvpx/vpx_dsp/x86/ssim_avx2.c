@@ -0,0 +1,78 @@
+/*
+ *  Copyright (c) 2016 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+
+#include "./vpx_dsp_rtcd.h"
+#include "vpx_ports/mem.h"
+
+static INLINE __m256i ssim_strip_sums_avx2(__m256i lo, __m256i hi) {
+  const __m256 a = _mm256_castsi256_ps(lo);
+  const __m256 b = _mm256_castsi256_ps(hi);
+  return _mm256_add_epi32(
+      _mm256_castps_si256(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0))),
+      _mm256_castps_si256(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1))));
+}
+
+void vpx_ssim_parms_4x8_row_avx2(const uint8_t *s, int sp, const uint8_t *r,
+                                 int rp, int count, uint32_t *sum_s,
+                                 uint32_t *sum_r, uint32_t *sum_sq_s,
+                                 uint32_t *sum_sq_r, uint32_t *sum_sxr) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i one = _mm256_set1_epi16(1);
+  int i, k;
+
+  for (k = 0; k + 8 <= count; k += 8) {
+    __m256i s_lo = zero, s_hi = zero, r_lo = zero, r_hi = zero;
+    __m256i ss_lo = zero, ss_hi = zero, rr_lo = zero, rr_hi = zero;
+    __m256i sr_lo = zero, sr_hi = zero;
+
+    for (i = 0; i < 8; ++i) {
+      const __m256i s8 =
+          _mm256_loadu_si256((const __m256i *)(s + i * sp + 4 * k));
+      const __m256i r8 =
+          _mm256_loadu_si256((const __m256i *)(r + i * rp + 4 * k));
+      const __m256i sl = _mm256_unpacklo_epi8(s8, zero);
+      const __m256i sh = _mm256_unpackhi_epi8(s8, zero);
+      const __m256i rl = _mm256_unpacklo_epi8(r8, zero);
+      const __m256i rh = _mm256_unpackhi_epi8(r8, zero);
+
+      s_lo = _mm256_add_epi16(s_lo, sl);
+      s_hi = _mm256_add_epi16(s_hi, sh);
+      r_lo = _mm256_add_epi16(r_lo, rl);
+      r_hi = _mm256_add_epi16(r_hi, rh);
+      ss_lo = _mm256_add_epi32(ss_lo, _mm256_madd_epi16(sl, sl));
+      ss_hi = _mm256_add_epi32(ss_hi, _mm256_madd_epi16(sh, sh));
+      rr_lo = _mm256_add_epi32(rr_lo, _mm256_madd_epi16(rl, rl));
+      rr_hi = _mm256_add_epi32(rr_hi, _mm256_madd_epi16(rh, rh));
+      sr_lo = _mm256_add_epi32(sr_lo, _mm256_madd_epi16(sl, rl));
+      sr_hi = _mm256_add_epi32(sr_hi, _mm256_madd_epi16(sh, rh));
+    }
+
+    _mm256_storeu_si256((__m256i *)(sum_s + k),
+                        ssim_strip_sums_avx2(_mm256_madd_epi16(s_lo, one),
+                                             _mm256_madd_epi16(s_hi, one)));
+    _mm256_storeu_si256((__m256i *)(sum_r + k),
+                        ssim_strip_sums_avx2(_mm256_madd_epi16(r_lo, one),
+                                             _mm256_madd_epi16(r_hi, one)));
+    _mm256_storeu_si256((__m256i *)(sum_sq_s + k),
+                        ssim_strip_sums_avx2(ss_lo, ss_hi));
+    _mm256_storeu_si256((__m256i *)(sum_sq_r + k),
+                        ssim_strip_sums_avx2(rr_lo, rr_hi));
+    _mm256_storeu_si256((__m256i *)(sum_sxr + k),
+                        ssim_strip_sums_avx2(sr_lo, sr_hi));
+  }
+
+  if (k < count) {
+    vpx_ssim_parms_4x8_row_sse2(s + 4 * k, sp, r + 4 * k, rp, count - k,
+                                sum_s + k, sum_r + k, sum_sq_s + k,
+                                sum_sq_r + k, sum_sxr + k);
+  }
+}
@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2016 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <emmintrin.h>
+
+#include "./vpx_dsp_rtcd.h"
+#include "vpx_ports/mem.h"
+
+static INLINE __m128i ssim_strip_sums(__m128i lo, __m128i hi) {
+  const __m128 a = _mm_castsi128_ps(lo);
+  const __m128 b = _mm_castsi128_ps(hi);
+  return _mm_add_epi32(
+      _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0))),
+      _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1))));
+}
+
+void vpx_ssim_parms_4x8_row_sse2(const uint8_t *s, int sp, const uint8_t *r,
+                                 int rp, int count, uint32_t *sum_s,
+                                 uint32_t *sum_r, uint32_t *sum_sq_s,
+                                 uint32_t *sum_sq_r, uint32_t *sum_sxr) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i one = _mm_set1_epi16(1);
+  int i, k;
+
+  for (k = 0; k + 4 <= count; k += 4) {
+    __m128i s_lo = zero, s_hi = zero, r_lo = zero, r_hi = zero;
+    __m128i ss_lo = zero, ss_hi = zero, rr_lo = zero, rr_hi = zero;
+    __m128i sr_lo = zero, sr_hi = zero;
+
+    for (i = 0; i < 8; ++i) {
+      const __m128i s8 =
+          _mm_loadu_si128((const __m128i *)(s + i * sp + 4 * k));
+      const __m128i r8 =
+          _mm_loadu_si128((const __m128i *)(r + i * rp + 4 * k));
+      const __m128i sl = _mm_unpacklo_epi8(s8, zero);
+      const __m128i sh = _mm_unpackhi_epi8(s8, zero);
+      const __m128i rl = _mm_unpacklo_epi8(r8, zero);
+      const __m128i rh = _mm_unpackhi_epi8(r8, zero);
+
+      s_lo = _mm_add_epi16(s_lo, sl);
+      s_hi = _mm_add_epi16(s_hi, sh);
+      r_lo = _mm_add_epi16(r_lo, rl);
+      r_hi = _mm_add_epi16(r_hi, rh);
+      ss_lo = _mm_add_epi32(ss_lo, _mm_madd_epi16(sl, sl));
+      ss_hi = _mm_add_epi32(ss_hi, _mm_madd_epi16(sh, sh));
+      rr_lo = _mm_add_epi32(rr_lo, _mm_madd_epi16(rl, rl));
+      rr_hi = _mm_add_epi32(rr_hi, _mm_madd_epi16(rh, rh));
+      sr_lo = _mm_add_epi32(sr_lo, _mm_madd_epi16(sl, rl));
+      sr_hi = _mm_add_epi32(sr_hi, _mm_madd_epi16(sh, rh));
+    }
+
+    _mm_storeu_si128((__m128i *)(sum_s + k),
+                     ssim_strip_sums(_mm_madd_epi16(s_lo, one),
+                                     _mm_madd_epi16(s_hi, one)));
+    _mm_storeu_si128((__m128i *)(sum_r + k),
+                     ssim_strip_sums(_mm_madd_epi16(r_lo, one),
+                                     _mm_madd_epi16(r_hi, one)));
+    _mm_storeu_si128((__m128i *)(sum_sq_s + k), ssim_strip_sums(ss_lo, ss_hi));
+    _mm_storeu_si128((__m128i *)(sum_sq_r + k), ssim_strip_sums(rr_lo, rr_hi));
+    _mm_storeu_si128((__m128i *)(sum_sxr + k), ssim_strip_sums(sr_lo, sr_hi));
+  }
+
+  if (k < count) {
+    vpx_ssim_parms_4x8_row_c(s + 4 * k, sp, r + 4 * k, rp, count - k,
+                             sum_s + k, sum_r + k, sum_sq_s + k,
+                             sum_sq_r + k, sum_sxr + k);
+  }
+}
@@ -234,6 +234,25 @@ x86_readtsc(void) {
 #endif
 }
 
+static INLINE uint64_t
+x86_readtsc64(void) {
+#if defined(__GNUC__) && __GNUC__
+  uint32_t hi, lo;
+  __asm__ __volatile__("rdtsc\n\t":"=a"(lo), "=d"(hi));
+  return ((uint64_t)hi << 32) | lo;
+#elif defined(__SUNPRO_C) || defined(__SUNPRO_CC)
+  uint32_t hi, lo;
+  asm volatile("rdtsc\n\t":"=a"(lo), "=d"(hi));
+  return ((uint64_t)hi << 32) | lo;
+#else
+#if ARCH_X86_64
+  return (uint64_t)__rdtsc();
+#else
+  __asm  rdtsc;
+#endif
+#endif
+}
+
 
 #if defined(__GNUC__) && __GNUC__
 #define x86_pause_hint()\
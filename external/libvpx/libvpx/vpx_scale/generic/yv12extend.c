@@ -213,7 +213,7 @@ void memcpy_short_addr(uint8_t *dst8, const uint8_t *src8, int num) {
 #endif  
 #endif  
 
-void vp8_yv12_copy_frame_c(const YV12_BUFFER_CONFIG *src_ybc,
+void vpx_yv12_copy_frame_c(const YV12_BUFFER_CONFIG *src_ybc,
                            YV12_BUFFER_CONFIG *dst_ybc) {
   int row;
   const uint8_t *src = src_ybc->y_buffer;
@@ -251,7 +251,6 @@ void vp8_yv12_copy_frame_c(const YV12_BUFFER_CONFIG *src_ybc,
       dst += dst_ybc->uv_stride;
     }
 
-    vp8_yv12_extend_frame_borders_c(dst_ybc);
     return;
   } else {
     assert(!(dst_ybc->flags & YV12_FLAG_HIGHBITDEPTH));
@@ -281,7 +280,11 @@ void vp8_yv12_copy_frame_c(const YV12_BUFFER_CONFIG *src_ybc,
     src += src_ybc->uv_stride;
     dst += dst_ybc->uv_stride;
   }
+}
 
+void vp8_yv12_copy_frame_c(const YV12_BUFFER_CONFIG *src_ybc,
+                           YV12_BUFFER_CONFIG *dst_ybc) {
+  vpx_yv12_copy_frame_c(src_ybc, dst_ybc);
   vp8_yv12_extend_frame_borders_c(dst_ybc);
 }
 
@@ -0,0 +1,205 @@
+/*
+ *  Copyright (c) 2016 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vpx/vpx_integer.h"
+#include "./tools_common.h"
+#include "./vpxchunk.h"
+
+#define CHUNK_SAMPLE_STEP 4
+#define SCENE_CUT_HISTORY 8
+#define SCENE_CUT_RATIO 3.0
+#define SCENE_CUT_MIN_DIFF 8.0
+
+struct chunk_analyzer {
+  int bit_depth;
+  int w;
+  int h;
+  uint16_t *cur;
+  uint16_t *prev;
+  double *intra;
+  double *inter;
+  int frames;
+  int alloc;
+};
+
+struct chunk_analyzer *init_chunk_analyzer(int bit_depth) {
+  struct chunk_analyzer *ca = calloc(1, sizeof(*ca));
+
+  if (!ca)
+    fatal("Failed to allocate chunk analyzer");
+  ca->bit_depth = bit_depth > 8 ? bit_depth : 8;
+  return ca;
+}
+
+void destroy_chunk_analyzer(struct chunk_analyzer *ca) {
+  if (!ca)
+    return;
+  free(ca->cur);
+  free(ca->prev);
+  free(ca->intra);
+  free(ca->inter);
+  free(ca);
+}
+
+static void sample_luma(struct chunk_analyzer *ca, const vpx_image_t *img) {
+  const unsigned char *const src = img->planes[VPX_PLANE_Y];
+  const int stride = img->stride[VPX_PLANE_Y];
+  int r, c;
+
+  for (r = 0; r < ca->h; ++r) {
+    const unsigned char *const row = src + r * CHUNK_SAMPLE_STEP * stride;
+    uint16_t *const dst = ca->cur + r * ca->w;
+    if (img->fmt & VPX_IMG_FMT_HIGHBITDEPTH) {
+      const uint16_t *const row16 = (const uint16_t *)row;
+      for (c = 0; c < ca->w; ++c)
+        dst[c] = row16[c * CHUNK_SAMPLE_STEP];
+    } else {
+      for (c = 0; c < ca->w; ++c)
+        dst[c] = row[c * CHUNK_SAMPLE_STEP];
+    }
+  }
+}
+
+void update_chunk_analyzer(struct chunk_analyzer *ca, const vpx_image_t *img) {
+  const double scale = 1.0 / (1 << (ca->bit_depth - 8));
+  uint64_t intra_sum = 0, inter_sum = 0;
+  int r, c;
+
+  if (!ca->cur) {
+    ca->w = (img->d_w + CHUNK_SAMPLE_STEP - 1) / CHUNK_SAMPLE_STEP;
+    ca->h = (img->d_h + CHUNK_SAMPLE_STEP - 1) / CHUNK_SAMPLE_STEP;
+    ca->cur = malloc(ca->w * ca->h * sizeof(*ca->cur));
+    ca->prev = malloc(ca->w * ca->h * sizeof(*ca->prev));
+    if (!ca->cur || !ca->prev)
+      fatal("Failed to allocate chunk analyzer buffers");
+  }
+
+  if (ca->frames == ca->alloc) {
+    const int alloc = ca->alloc ? ca->alloc * 2 : 256;
+    double *const intra = realloc(ca->intra, alloc * sizeof(*intra));
+    double *const inter = intra ? realloc(ca->inter, alloc * sizeof(*inter))
+                                : NULL;
+    if (!intra || !inter)
+      fatal("Failed to grow chunk analyzer");
+    ca->intra = intra;
+    ca->inter = inter;
+    ca->alloc = alloc;
+  }
+
+  sample_luma(ca, img);
+
+  for (r = 0; r < ca->h; ++r) {
+    const uint16_t *const cur = ca->cur + r * ca->w;
+    const uint16_t *const prev = ca->prev + r * ca->w;
+    for (c = 0; c < ca->w; ++c) {
+      if (c > 0)
+        intra_sum += abs(cur[c] - cur[c - 1]);
+      if (r > 0)
+        intra_sum += abs(cur[c] - cur[c - ca->w]);
+      inter_sum += abs(cur[c] - prev[c]);
+    }
+  }
+
+  ca->intra[ca->frames] = scale * intra_sum / (ca->w * ca->h);
+  ca->inter[ca->frames] = ca->frames
+                              ? scale * inter_sum / (ca->w * ca->h)
+                              : ca->intra[ca->frames];
+  ca->frames++;
+
+  {
+    uint16_t *const tmp = ca->prev;
+    ca->prev = ca->cur;
+    ca->cur = tmp;
+  }
+}
+
+int chunk_analyzer_frames(const struct chunk_analyzer *ca) {
+  return ca->frames;
+}
+
+static int is_scene_cut(const struct chunk_analyzer *ca, int frame) {
+  const int first = frame > SCENE_CUT_HISTORY ? frame - SCENE_CUT_HISTORY : 1;
+  double avg = 0.0;
+  int i;
+
+  if (frame < 2)
+    return 0;
+
+  for (i = first; i < frame; ++i)
+    avg += ca->inter[i];
+  avg /= frame - first;
+
+  return ca->inter[frame] > SCENE_CUT_MIN_DIFF &&
+         ca->inter[frame] > SCENE_CUT_RATIO * avg;
+}
+
+static double frame_error(const struct chunk_analyzer *ca,
+                          const struct chunk_info *chunk, int frame) {
+  return 1.0 + (frame == chunk->start ? ca->intra[frame] : ca->inter[frame]);
+}
+
+int plan_chunks(const struct chunk_analyzer *ca, int min_frames,
+                int max_frames, double vbr_bias, struct chunk_info **chunks) {
+  struct chunk_info *list;
+  double avg_error = 0.0;
+  int count = 0;
+  int start = 0;
+  int i, j;
+
+  *chunks = NULL;
+  if (!ca->frames)
+    return 0;
+
+  if (min_frames < 1)
+    min_frames = 1;
+  if (max_frames < min_frames)
+    max_frames = min_frames;
+
+  list = malloc(ca->frames * sizeof(*list));
+  if (!list)
+    fatal("Failed to allocate chunk list");
+
+  for (i = 1; i < ca->frames; ++i) {
+    const int len = i - start;
+    if ((len >= min_frames && is_scene_cut(ca, i)) || len >= max_frames) {
+      list[count].start = start;
+      list[count].frames = len;
+      count++;
+      start = i;
+    }
+  }
+
+  if (count > 0 && ca->frames - start < min_frames) {
+    list[count - 1].frames += ca->frames - start;
+  } else {
+    list[count].start = start;
+    list[count].frames = ca->frames - start;
+    count++;
+  }
+
+  for (i = 0; i < count; ++i)
+    for (j = list[i].start; j < list[i].start + list[i].frames; ++j)
+      avg_error += frame_error(ca, &list[i], j);
+  avg_error /= ca->frames;
+
+  for (i = 0; i < count; ++i) {
+    list[i].weight = 0.0;
+    for (j = list[i].start; j < list[i].start + list[i].frames; ++j)
+      list[i].weight += avg_error *
+          pow(frame_error(ca, &list[i], j) / avg_error, vbr_bias);
+  }
+
+  *chunks = list;
+  return count;
+}
@@ -0,0 +1,43 @@
+/*
+ *  Copyright (c) 2016 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VPXCHUNK_H_
+#define VPXCHUNK_H_
+
+#include "vpx/vpx_image.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct chunk_info {
+  int start;
+  int frames;
+  double weight;
+};
+
+struct chunk_analyzer;
+
+struct chunk_analyzer *init_chunk_analyzer(int bit_depth);
+
+void destroy_chunk_analyzer(struct chunk_analyzer *ca);
+
+void update_chunk_analyzer(struct chunk_analyzer *ca, const vpx_image_t *img);
+
+int chunk_analyzer_frames(const struct chunk_analyzer *ca);
+
+int plan_chunks(const struct chunk_analyzer *ca, int min_frames,
+                int max_frames, double vbr_bias, struct chunk_info **chunks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -17,6 +17,17 @@
 
 #include "./vpx_config.h"
 
+#if CONFIG_OS_SUPPORT && !defined(_WIN32)
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#define HAVE_DIRECT_IO 1
+#define WRITE_IOV_COUNT 256
+#else
+#define HAVE_DIRECT_IO 0
+#endif
+
 #if CONFIG_LIBYUV
 #include "third_party/libyuv/include/libyuv/scale.h"
 #endif
@@ -87,8 +98,20 @@ static const arg_def_t continuearg = ARG_DEF(
     "k", "keep-going", 0, "(debug) Continue decoding after error");
 static const arg_def_t fb_arg = ARG_DEF(
     NULL, "frame-buffers", 1, "Number of frame buffers to use");
+#if HAVE_DIRECT_IO
+static const arg_def_t mmapfbarg = ARG_DEF(
+    NULL, "mmap-frame-buffers", 0, "Allocate external frame buffers with mmap");
+#endif
 static const arg_def_t md5arg = ARG_DEF(
     NULL, "md5", 0, "Compute the MD5 sum of the decoded frame");
+static const arg_def_t stagetimingarg = ARG_DEF(
+    NULL, "stage-timing", 0, "Show per-stage decode timing summary");
+#if CONFIG_WEBM_IO
+static const arg_def_t seekarg = ARG_DEF(
+    NULL, "seek", 1, "Start at the key frame before this time in ms (WebM)");
+static const arg_def_t webmindexarg = ARG_DEF(
+    NULL, "webm-index", 1, "Load and update a WebM seek index file");
+#endif
 #if CONFIG_VP9_HIGHBITDEPTH
 static const arg_def_t outbitdeptharg = ARG_DEF(
     NULL, "output-bit-depth", 1, "Output bit-depth for decoded frames");
@@ -98,7 +121,13 @@ static const arg_def_t *all_args[] = {
   &codecarg, &use_yv12, &use_i420, &flipuvarg, &rawvideo, &noblitarg,
   &progressarg, &limitarg, &skiparg, &postprocarg, &summaryarg, &outputfile,
   &threadsarg, &frameparallelarg, &verbosearg, &scalearg, &fb_arg,
-  &md5arg, &error_concealment, &continuearg,
+  &md5arg, &error_concealment, &continuearg, &stagetimingarg,
+#if HAVE_DIRECT_IO
+  &mmapfbarg,
+#endif
+#if CONFIG_WEBM_IO
+  &seekarg, &webmindexarg,
+#endif
 #if CONFIG_VP9_HIGHBITDEPTH
   &outbitdeptharg,
 #endif
@@ -290,6 +319,36 @@ static void update_image_md5(const vpx_image_t *img, const int planes[3],
   }
 }
 
+#if HAVE_DIRECT_IO
+static void write_iov(int fd, struct iovec *iov, int count) {
+  while (count > 0) {
+    ssize_t n = writev(fd, iov, count);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      fatal("Failed to write output frame");
+    }
+    while (count > 0 && (size_t)n >= iov->iov_len) {
+      n -= iov->iov_len;
+      ++iov;
+      --count;
+    }
+    if (count > 0) {
+      iov->iov_base = (char *)iov->iov_base + n;
+      iov->iov_len -= n;
+    }
+  }
+}
+
+static int is_direct_io_file(FILE *file) {
+  struct stat st;
+  const int fd = fileno(file);
+  if (fd < 0 || fstat(fd, &st) != 0)
+    return 0;
+  return S_ISREG(st.st_mode) || S_ISFIFO(st.st_mode) || S_ISCHR(st.st_mode);
+}
+#endif
+
 static void write_image_file(const vpx_image_t *img, const int planes[3],
                              FILE *file) {
   int i, y;
@@ -298,19 +357,45 @@ static void write_image_file(const vpx_image_t *img, const int planes[3],
 #else
   const int bytes_per_sample = 1;
 #endif
+#if HAVE_DIRECT_IO
+  struct iovec iov[WRITE_IOV_COUNT];
+  int count = 0;
+  const int direct_io = is_direct_io_file(file);
+
+  if (direct_io)
+    fflush(file);
+#endif
 
   for (i = 0; i < 3; ++i) {
     const int plane = planes[i];
-    const unsigned char *buf = img->planes[plane];
+    unsigned char *buf = img->planes[plane];
     const int stride = img->stride[plane];
     const int w = vpx_img_plane_width(img, plane);
     const int h = vpx_img_plane_height(img, plane);
 
     for (y = 0; y < h; ++y) {
+#if HAVE_DIRECT_IO
+      if (direct_io) {
+        iov[count].iov_base = buf;
+        iov[count].iov_len = w * bytes_per_sample;
+        if (++count == WRITE_IOV_COUNT) {
+          write_iov(fileno(file), iov, count);
+          count = 0;
+        }
+      } else {
+        fwrite(buf, bytes_per_sample, w, file);
+      }
+#else
       fwrite(buf, bytes_per_sample, w, file);
+#endif
       buf += stride;
     }
   }
+
+#if HAVE_DIRECT_IO
+  if (direct_io)
+    write_iov(fileno(file), iov, count);
+#endif
 }
 
 static int file_is_raw(struct VpxInputContext *input) {
@@ -360,8 +445,39 @@ struct ExternalFrameBuffer {
 struct ExternalFrameBufferList {
   int num_external_frame_buffers;
   struct ExternalFrameBuffer *ext_fb;
+  int use_mmap;
 };
 
+static void free_ext_fb(const struct ExternalFrameBufferList *ext_fb_list,
+                        struct ExternalFrameBuffer *ext_fb) {
+#if HAVE_DIRECT_IO
+  if (ext_fb_list->use_mmap) {
+    if (ext_fb->data)
+      munmap(ext_fb->data, ext_fb->size);
+    ext_fb->data = NULL;
+    return;
+  }
+#else
+  (void)ext_fb_list;
+#endif
+  free(ext_fb->data);
+  ext_fb->data = NULL;
+}
+
+static uint8_t *alloc_ext_fb(const struct ExternalFrameBufferList *ext_fb_list,
+                             size_t size) {
+#if HAVE_DIRECT_IO
+  if (ext_fb_list->use_mmap) {
+    void *const data = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return data == MAP_FAILED ? NULL : (uint8_t *)data;
+  }
+#else
+  (void)ext_fb_list;
+#endif
+  return (uint8_t *)calloc(size, sizeof(uint8_t));
+}
+
 static int get_vp9_frame_buffer(void *cb_priv, size_t min_size,
                                 vpx_codec_frame_buffer_t *fb) {
   int i;
@@ -380,8 +496,8 @@ static int get_vp9_frame_buffer(void *cb_priv, size_t min_size,
     return -1;
 
   if (ext_fb_list->ext_fb[i].size < min_size) {
-    free(ext_fb_list->ext_fb[i].data);
-    ext_fb_list->ext_fb[i].data = (uint8_t *)calloc(min_size, sizeof(uint8_t));
+    free_ext_fb(ext_fb_list, &ext_fb_list->ext_fb[i]);
+    ext_fb_list->ext_fb[i].data = alloc_ext_fb(ext_fb_list, min_size);
     if (!ext_fb_list->ext_fb[i].data)
       return -1;
 
@@ -541,11 +657,17 @@ static int main_loop(int argc, const char **argv_) {
   int                    do_md5 = 0, progress = 0, frame_parallel = 0;
   int                    stop_after = 0, postproc = 0, summary = 0, quiet = 1;
   int                    arg_skip = 0;
+#if CONFIG_WEBM_IO
+  unsigned int           seek_ms = 0;
+  const char            *webm_index_file = NULL;
+#endif
   int                    ec_enabled = 0;
   int                    keep_going = 0;
   const VpxInterface *interface = NULL;
   const VpxInterface *fourcc_interface = NULL;
   uint64_t dx_time = 0;
+  int stage_timing = 0;
+  vpx_stage_timing_t stage_totals = {{0}, 0};
   struct arg               arg;
   char                   **argv, **argi, **argj;
 
@@ -573,7 +695,7 @@ static int main_loop(int argc, const char **argv_) {
 #endif
   int                     frame_avail, got_data, flush_decoder = 0;
   int                     num_external_frame_buffers = 0;
-  struct ExternalFrameBufferList ext_fb_list = {0, NULL};
+  struct ExternalFrameBufferList ext_fb_list = {0, NULL, 0};
 
   const char *outfile_pattern = NULL;
   char outfile_name[PATH_MAX] = {0};
@@ -648,8 +770,20 @@ static int main_loop(int argc, const char **argv_) {
       do_scale = 1;
     else if (arg_match(&arg, &fb_arg, argi))
       num_external_frame_buffers = arg_parse_uint(&arg);
+#if HAVE_DIRECT_IO
+    else if (arg_match(&arg, &mmapfbarg, argi))
+      ext_fb_list.use_mmap = 1;
+#endif
     else if (arg_match(&arg, &continuearg, argi))
       keep_going = 1;
+    else if (arg_match(&arg, &stagetimingarg, argi))
+      stage_timing = 1;
+#if CONFIG_WEBM_IO
+    else if (arg_match(&arg, &seekarg, argi))
+      seek_ms = arg_parse_uint(&arg);
+    else if (arg_match(&arg, &webmindexarg, argi))
+      webm_index_file = arg.val;
+#endif
 #if CONFIG_VP9_HIGHBITDEPTH
     else if (arg_match(&arg, &outbitdeptharg, argi)) {
       output_bit_depth = arg_parse_uint(&arg);
@@ -848,6 +982,26 @@ static int main_loop(int argc, const char **argv_) {
 #endif
 
 
+  if (stage_timing &&
+      vpx_codec_control(&decoder, VP9_SET_STAGE_TIMING, 1)) {
+    warn("Stage timing is not supported: %s", vpx_codec_error(&decoder));
+    stage_timing = 0;
+  }
+
+#if CONFIG_WEBM_IO
+  if (vpx_input_ctx.file_type == FILE_TYPE_WEBM) {
+    if (webm_index_file)
+      webm_load_index(input.webm_ctx, webm_index_file);
+    if (seek_ms &&
+        webm_seek(input.webm_ctx, (uint64_t)seek_ms * 1000000)) {
+      fprintf(stderr, "Failed to seek to %u ms.\n", seek_ms);
+      return EXIT_FAILURE;
+    }
+  } else if (seek_ms || webm_index_file) {
+    warn("--seek and --webm-index only apply to WebM input");
+  }
+#endif
+
   if (arg_skip)
     fprintf(stderr, "Skipping first %d frames.\n", arg_skip);
   while (arg_skip) {
@@ -856,6 +1010,10 @@ static int main_loop(int argc, const char **argv_) {
     arg_skip--;
   }
 
+  if (ext_fb_list.use_mmap && !num_external_frame_buffers)
+    num_external_frame_buffers =
+        VP9_MAXIMUM_REF_BUFFERS + VPX_MAXIMUM_WORK_BUFFERS;
+
   if (num_external_frame_buffers > 0) {
     ext_fb_list.num_external_frame_buffers = num_external_frame_buffers;
     ext_fb_list.ext_fb = (struct ExternalFrameBuffer *)calloc(
@@ -1089,6 +1247,10 @@ static int main_loop(int argc, const char **argv_) {
     fprintf(stderr, "\n");
   }
 
+  if (stage_timing &&
+      !vpx_codec_control(&decoder, VP9_GET_STAGE_TIMING, &stage_totals))
+    print_stage_timing(stderr, &stage_totals);
+
   if (frames_corrupted)
     fprintf(stderr, "WARNING: %d frames corrupted.\n", frames_corrupted);
 
@@ -1110,8 +1272,12 @@ fail:
   }
 
 #if CONFIG_WEBM_IO
-  if (input.vpx_input_ctx->file_type == FILE_TYPE_WEBM)
+  if (input.vpx_input_ctx->file_type == FILE_TYPE_WEBM) {
+    if (webm_index_file &&
+        webm_save_index(input.webm_ctx, webm_index_file))
+      warn("Failed to write WebM seek index '%s'", webm_index_file);
     webm_free(input.webm_ctx);
+  }
 #endif
 
   if (input.vpx_input_ctx->file_type != FILE_TYPE_WEBM)
@@ -1123,7 +1289,7 @@ fail:
 #endif
 
   for (i = 0; i < ext_fb_list.num_external_frame_buffers; ++i) {
-    free(ext_fb_list.ext_fb[i].data);
+    free_ext_fb(&ext_fb_list, &ext_fb_list.ext_fb[i]);
   }
   free(ext_fb_list.ext_fb);
 
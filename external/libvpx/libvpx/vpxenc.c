@@ -42,7 +42,11 @@
 #include "vpx/vpx_integer.h"
 #include "vpx_ports/mem_ops.h"
 #include "vpx_ports/vpx_timer.h"
+#if CONFIG_MULTITHREAD
+#include "vpx_util/vpx_thread.h"
+#endif
 #include "./rate_hist.h"
+#include "./vpxchunk.h"
 #include "./vpxstats.h"
 #include "./warnings.h"
 #if CONFIG_WEBM_IO
@@ -199,6 +203,11 @@ static const arg_def_t disable_warnings = ARG_DEF(
 static const arg_def_t disable_warning_prompt = ARG_DEF(
     "y", "disable-warning-prompt", 0,
     "Display warnings, but do not prompt user to continue.");
+static const arg_def_t chunk_threads = ARG_DEF(
+    NULL, "chunk-threads", 1,
+    "Encode scene-cut chunks of a 2-pass encode in parallel (n threads)");
+static const arg_def_t stage_timing = ARG_DEF(
+    NULL, "stage-timing", 0, "Show per-stage encode timing summary (VP9)");
 
 #if CONFIG_VP9_HIGHBITDEPTH
 static const arg_def_t test16bitinternalarg = ARG_DEF(
@@ -211,6 +220,7 @@ static const arg_def_t *main_args[] = {
   &deadline, &best_dl, &good_dl, &rt_dl,
   &quietarg, &verbosearg, &psnrarg, &use_webm, &use_ivf, &out_part, &q_hist_n,
   &rate_hist_n, &disable_warnings, &disable_warning_prompt, &recontest,
+  &chunk_threads, &stage_timing,
   NULL
 };
 
@@ -827,6 +837,7 @@ struct stream_state {
   struct vpx_image         *img;
   vpx_codec_ctx_t           decoder;
   int                       mismatch_seen;
+  vpx_stage_timing_t        stage_timing;
 };
 
 
@@ -927,6 +938,10 @@ static void parse_global_config(struct VpxEncoderConfig *global, char **argv) {
       global->disable_warnings = 1;
     else if (arg_match(&arg, &disable_warning_prompt, argi))
       global->disable_warning_prompt = 1;
+    else if (arg_match(&arg, &chunk_threads, argi))
+      global->chunk_threads = arg_parse_uint(&arg);
+    else if (arg_match(&arg, &stage_timing, argi))
+      global->stage_timing = 1;
     else
       argj++;
   }
@@ -1539,6 +1554,11 @@ static void initialize_encoder(struct stream_state *stream,
     ctx_exit_on_error(&stream->encoder, "Failed to control codec");
   }
 
+  if (global->stage_timing) {
+    vpx_codec_control(&stream->encoder, VP9_SET_STAGE_TIMING, 1);
+    ctx_exit_on_error(&stream->encoder, "Failed to enable stage timing");
+  }
+
 #if CONFIG_DECODERS
   if (global->test_decode != TEST_DECODE_OFF) {
     const VpxInterface *decoder = get_vpx_decoder_by_name(global->codec->name);
@@ -1548,6 +1568,13 @@ static void initialize_encoder(struct stream_state *stream,
 }
 
 
+static void collect_stage_timing(struct stream_state *stream) {
+  vpx_stage_timing_t timing;
+  if (!vpx_codec_control(&stream->encoder, VP9_GET_STAGE_TIMING, &timing))
+    accumulate_stage_timing(&stream->stage_timing, &timing);
+}
+
+
 static void encode_frame(struct stream_state *stream,
                          struct VpxEncoderConfig *global,
                          struct vpx_image *img,
@@ -1883,6 +1910,469 @@ static void print_time(const char *label, int64_t etl) {
 }
 
 
+struct chunk_packet {
+  vpx_codec_pts_t pts;
+  unsigned long duration;
+  vpx_codec_frame_flags_t flags;
+  size_t sz;
+  void *buf;
+};
+
+struct chunk_job {
+  struct chunk_info info;
+  unsigned int target_bitrate;
+  struct stream_state stream;
+  struct chunk_packet *pkts;
+  int pkt_cnt;
+  int pkt_alloc;
+  int done;
+};
+
+struct chunk_encoder {
+  struct stream_state *stream;
+  struct VpxEncoderConfig *global;
+  const struct VpxInputContext *input;
+  const int64_t *frame_pos;
+  int use_16bit_internal;
+  int input_shift;
+  struct chunk_job *jobs;
+  int job_cnt;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  int next_job;
+#endif
+};
+
+
+static int get_chunk_cx_data(struct chunk_job *job,
+                             struct VpxEncoderConfig *global) {
+  struct stream_state *const stream = &job->stream;
+  const vpx_codec_cx_pkt_t *pkt;
+  vpx_codec_iter_t iter = NULL;
+  int got_data = 0;
+
+  while ((pkt = vpx_codec_get_cx_data(&stream->encoder, &iter))) {
+    switch (pkt->kind) {
+      case VPX_CODEC_CX_FRAME_PKT: {
+        struct chunk_packet *p;
+
+        if (job->pkt_cnt == job->pkt_alloc) {
+          const int alloc = job->pkt_alloc ? job->pkt_alloc * 2 : 64;
+          struct chunk_packet *const pkts =
+              realloc(job->pkts, alloc * sizeof(*pkts));
+          if (!pkts)
+            fatal("Failed to grow chunk packet list");
+          job->pkts = pkts;
+          job->pkt_alloc = alloc;
+        }
+        p = &job->pkts[job->pkt_cnt++];
+        p->pts = pkt->data.frame.pts;
+        p->duration = pkt->data.frame.duration;
+        p->flags = pkt->data.frame.flags;
+        p->sz = pkt->data.frame.sz;
+        p->buf = malloc(p->sz);
+        if (!p->buf)
+          fatal("Failed to allocate chunk packet");
+        memcpy(p->buf, pkt->data.frame.buf, p->sz);
+
+        stream->frames_out++;
+        stream->nbytes += pkt->data.frame.sz;
+        got_data = 1;
+        break;
+      }
+      case VPX_CODEC_STATS_PKT:
+        stats_write(&stream->stats,
+                    pkt->data.twopass_stats.buf,
+                    pkt->data.twopass_stats.sz);
+        break;
+      case VPX_CODEC_PSNR_PKT:
+        if (global->show_psnr &&
+            stream->config.cfg.g_pass != VPX_RC_FIRST_PASS) {
+          int i;
+
+          stream->psnr_sse_total += pkt->data.psnr.sse[0];
+          stream->psnr_samples_total += pkt->data.psnr.samples[0];
+          for (i = 0; i < 4; i++)
+            stream->psnr_totals[i] += pkt->data.psnr.psnr[i];
+          stream->psnr_count++;
+        }
+        break;
+      default:
+        break;
+    }
+  }
+
+  return got_data;
+}
+
+
+static int64_t input_frame_pos(const struct VpxInputContext *input) {
+  int64_t pos = ftello(input->file);
+
+  if (input->file_type == FILE_TYPE_RAW)
+    pos -= input->detect.buf_read - input->detect.position;
+  return pos;
+}
+
+
+static void encode_chunk_pass(struct chunk_encoder *ce,
+                              struct chunk_job *job, int pass) {
+  struct VpxEncoderConfig *const global = ce->global;
+  struct stream_state *const stream = &job->stream;
+  const int first = global->skip_frames + job->info.start;
+  const int last = first + job->info.frames;
+  struct VpxInputContext input = *ce->input;
+  vpx_image_t raw;
+#if CONFIG_VP9_HIGHBITDEPTH
+  vpx_image_t raw_shift;
+  int allocated_raw_shift = 0;
+#endif
+  int frames_in = 0;
+  int frame_avail = 1, got_data = 1;
+
+  open_input_file(&input);
+  if (input.file_type == FILE_TYPE_Y4M)
+    memset(&raw, 0, sizeof(raw));
+  else
+    vpx_img_alloc(&raw, input.fmt, input.width, input.height, 32);
+
+  if (first > 0 && !fseeko(input.file, ce->frame_pos[first], SEEK_SET)) {
+    input.detect.position = input.detect.buf_read;
+    frames_in = first;
+  }
+  while (frames_in < first && read_frame(&input, &raw))
+    frames_in++;
+
+  if (pass == 0) {
+    stream->config.cfg.g_pass = VPX_RC_FIRST_PASS;
+    if (!stats_open_mem(&stream->stats, 0))
+      fatal("Failed to open statistics store");
+  } else {
+    stream->config.cfg.g_pass = VPX_RC_LAST_PASS;
+    if (!stats_open_mem(&stream->stats, 1))
+      fatal("Failed to open statistics store");
+    stream->config.cfg.rc_twopass_stats_in = stats_get(&stream->stats);
+    stream->config.cfg.rc_target_bitrate = job->target_bitrate;
+  }
+
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&ce->mutex);
+  initialize_encoder(stream, global);
+  pthread_mutex_unlock(&ce->mutex);
+#else
+  initialize_encoder(stream, global);
+#endif
+
+  while (frame_avail || got_data) {
+    vpx_image_t *img = &raw;
+
+    frame_avail = frames_in < last && read_frame(&input, &raw);
+    if (frame_avail)
+      frames_in++;
+
+#if CONFIG_VP9_HIGHBITDEPTH
+    if (frame_avail && (ce->input_shift ||
+        (ce->use_16bit_internal && input.bit_depth == 8))) {
+      if (!allocated_raw_shift) {
+        vpx_img_alloc(&raw_shift, raw.fmt | VPX_IMG_FMT_HIGHBITDEPTH,
+                      input.width, input.height, 32);
+        allocated_raw_shift = 1;
+      }
+      vpx_img_upshift(&raw_shift, &raw, ce->input_shift);
+      img = &raw_shift;
+    }
+#endif
+
+    encode_frame(stream, global, frame_avail ? img : NULL, frames_in);
+
+    update_quantizer_histogram(stream);
+    got_data = get_chunk_cx_data(job, global);
+  }
+
+  if (global->stage_timing)
+    collect_stage_timing(stream);
+  vpx_codec_destroy(&stream->encoder);
+  if (pass)
+    stats_close(&stream->stats, 1);
+
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (allocated_raw_shift)
+    vpx_img_free(&raw_shift);
+#endif
+  vpx_img_free(&raw);
+  close_input_file(&input);
+}
+
+
+static void encode_chunk(struct chunk_encoder *ce, struct chunk_job *job) {
+  struct stream_state *const stream = &job->stream;
+
+  *stream = *ce->stream;
+  stream->next = NULL;
+  stream->file = NULL;
+  stream->rate_hist = NULL;
+  stream->img = NULL;
+  stream->psnr_sse_total = 0;
+  stream->psnr_samples_total = 0;
+  memset(stream->psnr_totals, 0, sizeof(stream->psnr_totals));
+  stream->psnr_count = 0;
+  memset(stream->counts, 0, sizeof(stream->counts));
+  memset(&stream->stats, 0, sizeof(stream->stats));
+  memset(&stream->stage_timing, 0, sizeof(stream->stage_timing));
+
+  encode_chunk_pass(ce, job, 0);
+  stream->frames_out = 0;
+  stream->nbytes = 0;
+  encode_chunk_pass(ce, job, 1);
+
+  if (stream->img)
+    vpx_img_free(stream->img);
+}
+
+
+#if CONFIG_MULTITHREAD
+static THREADFN chunk_worker(void *arg) {
+  struct chunk_encoder *const ce = (struct chunk_encoder *)arg;
+
+  for (;;) {
+    struct chunk_job *job = NULL;
+
+    pthread_mutex_lock(&ce->mutex);
+    if (ce->next_job < ce->job_cnt)
+      job = &ce->jobs[ce->next_job++];
+    pthread_mutex_unlock(&ce->mutex);
+    if (!job)
+      break;
+
+    encode_chunk(ce, job);
+
+    pthread_mutex_lock(&ce->mutex);
+    job->done = 1;
+    pthread_cond_signal(&ce->cond);
+    pthread_mutex_unlock(&ce->mutex);
+  }
+
+  return THREAD_RETURN(NULL);
+}
+#endif
+
+
+static void write_chunk(struct stream_state *stream, struct chunk_job *job) {
+  const struct vpx_codec_enc_cfg *cfg = &stream->config.cfg;
+  int i;
+
+  for (i = 0; i < job->pkt_cnt; i++) {
+    struct chunk_packet *const p = &job->pkts[i];
+    vpx_codec_cx_pkt_t pkt;
+
+    memset(&pkt, 0, sizeof(pkt));
+    pkt.kind = VPX_CODEC_CX_FRAME_PKT;
+    pkt.data.frame.buf = p->buf;
+    pkt.data.frame.sz = p->sz;
+    pkt.data.frame.pts = p->pts;
+    pkt.data.frame.duration = p->duration;
+    pkt.data.frame.flags = p->flags;
+    pkt.data.frame.partition_id = -1;
+
+    stream->frames_out++;
+    update_rate_histogram(stream->rate_hist, cfg, &pkt);
+#if CONFIG_WEBM_IO
+    if (stream->config.write_webm) {
+      write_webm_block(&stream->ebml, cfg, &pkt);
+    }
+#endif
+    if (!stream->config.write_webm) {
+      ivf_write_frame_header(stream->file, p->pts, p->sz);
+      (void) fwrite(p->buf, 1, p->sz, stream->file);
+    }
+    stream->nbytes += p->sz;
+    free(p->buf);
+  }
+  free(job->pkts);
+  job->pkts = NULL;
+
+  for (i = 0; i < 64; i++)
+    stream->counts[i] += job->stream.counts[i];
+  stream->psnr_sse_total += job->stream.psnr_sse_total;
+  stream->psnr_samples_total += job->stream.psnr_samples_total;
+  for (i = 0; i < 4; i++)
+    stream->psnr_totals[i] += job->stream.psnr_totals[i];
+  stream->psnr_count += job->stream.psnr_count;
+  accumulate_stage_timing(&stream->stage_timing, &job->stream.stage_timing);
+}
+
+
+static void set_chunk_bitrates(struct chunk_encoder *ce,
+                               const struct chunk_info *chunks,
+                               int total_frames) {
+  const struct vpx_codec_enc_cfg *cfg = &ce->stream->config.cfg;
+  const double min_rate =
+      (double)cfg->rc_target_bitrate * cfg->rc_2pass_vbr_minsection_pct / 100;
+  const double max_rate =
+      (double)cfg->rc_target_bitrate * cfg->rc_2pass_vbr_maxsection_pct / 100;
+  double total_weight = 0.0;
+  int i;
+
+  for (i = 0; i < ce->job_cnt; i++)
+    total_weight += chunks[i].weight;
+
+  for (i = 0; i < ce->job_cnt; i++) {
+    double rate = cfg->rc_target_bitrate;
+
+    if (total_weight > 0.0)
+      rate *= chunks[i].weight * total_frames /
+              (total_weight * chunks[i].frames);
+    if (rate < min_rate)
+      rate = min_rate;
+    if (max_rate > 0.0 && rate > max_rate)
+      rate = max_rate;
+    ce->jobs[i].target_bitrate = rate < 1.0 ? 1 : (unsigned int)(rate + 0.5);
+  }
+}
+
+
+static void encode_chunks(struct stream_state *stream,
+                          struct VpxEncoderConfig *global,
+                          struct VpxInputContext *input,
+                          int use_16bit_internal, int input_shift) {
+  const struct vpx_codec_enc_cfg *cfg = &stream->config.cfg;
+  struct chunk_analyzer *ca = init_chunk_analyzer(input->bit_depth);
+  struct chunk_info *chunks;
+  struct chunk_encoder ce;
+  struct vpx_usec_timer timer;
+  vpx_image_t raw;
+  int64_t *frame_pos = NULL;
+  int frame_pos_alloc = 0;
+  int frames_in = 0, seen_frames;
+  int min_frames, threads, i;
+
+  if (input->file_type == FILE_TYPE_Y4M)
+    memset(&raw, 0, sizeof(raw));
+  else
+    vpx_img_alloc(&raw, input->fmt, input->width, input->height, 32);
+
+  for (;;) {
+    if (frames_in == frame_pos_alloc) {
+      const int alloc = frame_pos_alloc ? frame_pos_alloc * 2 : 256;
+      int64_t *const pos = realloc(frame_pos, alloc * sizeof(*pos));
+      if (!pos)
+        fatal("Failed to grow frame offset list");
+      frame_pos = pos;
+      frame_pos_alloc = alloc;
+    }
+    frame_pos[frames_in] = input_frame_pos(input);
+
+    if ((global->limit && frames_in >= global->limit) ||
+        !read_frame(input, &raw))
+      break;
+    if (++frames_in > global->skip_frames)
+      update_chunk_analyzer(ca, &raw);
+  }
+  vpx_img_free(&raw);
+
+  seen_frames = chunk_analyzer_frames(ca);
+  min_frames = (int)cfg->kf_max_dist / 4;
+  if (min_frames < (int)cfg->kf_min_dist)
+    min_frames = (int)cfg->kf_min_dist;
+
+  memset(&ce, 0, sizeof(ce));
+  ce.stream = stream;
+  ce.global = global;
+  ce.input = input;
+  ce.frame_pos = frame_pos;
+  ce.use_16bit_internal = use_16bit_internal;
+  ce.input_shift = input_shift;
+  ce.job_cnt = plan_chunks(ca, min_frames, (int)cfg->kf_max_dist,
+                           cfg->rc_2pass_vbr_bias_pct / 100.0, &chunks);
+  destroy_chunk_analyzer(ca);
+
+  ce.jobs = calloc(ce.job_cnt ? ce.job_cnt : 1, sizeof(*ce.jobs));
+  if (!ce.jobs)
+    fatal("Failed to allocate chunk jobs");
+  for (i = 0; i < ce.job_cnt; i++)
+    ce.jobs[i].info = chunks[i];
+  set_chunk_bitrates(&ce, chunks, seen_frames);
+  free(chunks);
+
+  threads = global->chunk_threads < ce.job_cnt ? global->chunk_threads
+                                                : ce.job_cnt;
+  if (global->verbose) {
+    fprintf(stderr, "Encoding %d frames in %d chunks with %d threads\n",
+            seen_frames, ce.job_cnt, threads);
+    for (i = 0; i < ce.job_cnt; i++)
+      fprintf(stderr, "  chunk %d: frames %d-%d at %u kbps\n", i,
+              ce.jobs[i].info.start,
+              ce.jobs[i].info.start + ce.jobs[i].info.frames - 1,
+              ce.jobs[i].target_bitrate);
+  }
+
+  stream->frames_out = 0;
+  stream->nbytes = 0;
+
+  vpx_usec_timer_start(&timer);
+#if CONFIG_MULTITHREAD
+  if (threads > 1) {
+    pthread_t *const workers = malloc(threads * sizeof(*workers));
+
+    if (!workers)
+      fatal("Failed to allocate chunk workers");
+    pthread_mutex_init(&ce.mutex, NULL);
+    pthread_cond_init(&ce.cond, NULL);
+    for (i = 0; i < threads; i++)
+      if (pthread_create(&workers[i], NULL, chunk_worker, &ce))
+        fatal("Failed to create chunk worker");
+
+    for (i = 0; i < ce.job_cnt; i++) {
+      pthread_mutex_lock(&ce.mutex);
+      while (!ce.jobs[i].done)
+        pthread_cond_wait(&ce.cond, &ce.mutex);
+      pthread_mutex_unlock(&ce.mutex);
+      write_chunk(stream, &ce.jobs[i]);
+      if (!global->quiet)
+        fprintf(stderr, "\rPass 2/2 chunk %d/%d frame %4d/%-4d %7"PRId64"B"
+                "\033[K", i + 1, ce.job_cnt, seen_frames, stream->frames_out,
+                (int64_t)stream->nbytes);
+    }
+
+    for (i = 0; i < threads; i++)
+      pthread_join(workers[i], NULL);
+    pthread_cond_destroy(&ce.cond);
+    pthread_mutex_destroy(&ce.mutex);
+    free(workers);
+  } else
+#endif
+  {
+    for (i = 0; i < ce.job_cnt; i++) {
+      encode_chunk(&ce, &ce.jobs[i]);
+      write_chunk(stream, &ce.jobs[i]);
+      if (!global->quiet)
+        fprintf(stderr, "\rPass 2/2 chunk %d/%d frame %4d/%-4d %7"PRId64"B"
+                "\033[K", i + 1, ce.job_cnt, seen_frames, stream->frames_out,
+                (int64_t)stream->nbytes);
+    }
+  }
+  vpx_usec_timer_mark(&timer);
+  stream->cx_time = vpx_usec_timer_elapsed(&timer);
+  free(ce.jobs);
+  free(frame_pos);
+
+  if (!global->quiet) {
+    fprintf(stderr,
+        "\rPass 2/2 frame %4d/%-4d %7"PRId64"B %7"PRId64"b/f %7"PRId64"b/s"
+        " %7"PRId64" %s (%.2f fps)\033[K\n",
+        frames_in, stream->frames_out, (int64_t)stream->nbytes,
+        seen_frames ? (int64_t)(stream->nbytes * 8 / seen_frames) : 0,
+        seen_frames ? (int64_t)stream->nbytes * 8 *
+            (int64_t)global->framerate.num / global->framerate.den /
+            seen_frames : 0,
+        stream->cx_time > 9999999 ? stream->cx_time / 1000 : stream->cx_time,
+        stream->cx_time > 9999999 ? "ms" : "us",
+        usec_to_fps(stream->cx_time, seen_frames));
+  }
+}
+
+
 int main(int argc, const char **argv_) {
   int pass;
   vpx_image_t raw;
@@ -1954,12 +2444,35 @@ int main(int argc, const char **argv_) {
   FOREACH_STREAM(check_encoder_config(global.disable_warning_prompt,
                                       &global, &stream->config.cfg););
 
+  if (global.stage_timing && global.codec->fourcc != VP9_FOURCC) {
+    warn("--stage-timing is only supported by the VP9 encoder");
+    global.stage_timing = 0;
+  }
+
+  if (global.chunk_threads) {
+    if (global.passes != 2 || global.pass)
+      die("Error: --chunk-threads requires --passes=2 without --pass\n");
+    if (stream_cnt > 1)
+      die("Error: --chunk-threads supports a single output stream\n");
+    if (global.out_part || global.test_decode != TEST_DECODE_OFF)
+      die("Error: --chunk-threads can't be combined with "
+          "--output-partitions or --test-decode\n");
+    if (streams->config.stats_fn)
+      die("Error: --chunk-threads keeps first pass stats in memory, "
+          "--fpf is not supported\n");
+    if (streams->config.cfg.kf_mode == VPX_KF_DISABLED)
+      die("Error: --chunk-threads requires key frames\n");
+  }
+
   
   input.filename = argv[0];
 
   if (!input.filename)
     usage_exit();
 
+  if (global.chunk_threads && !strcmp(input.filename, "-"))
+    die("Error: --chunk-threads can't read from stdin\n");
+
   
   if (global.codec->fourcc == VP9_FOURCC)
     input.only_i420 = 0;
@@ -2042,11 +2555,6 @@ int main(int argc, const char **argv_) {
                                              &global.framerate));
     }
 
-    FOREACH_STREAM(setup_pass(stream, &global, pass));
-    FOREACH_STREAM(open_output_file(stream, &global,
-                                    &input.pixel_aspect_ratio));
-    FOREACH_STREAM(initialize_encoder(stream, &global));
-
 #if CONFIG_VP9_HIGHBITDEPTH
     if (strcmp(global.codec->name, "vp9") == 0 ||
         strcmp(global.codec->name, "vp10") == 0) {
@@ -2067,6 +2575,30 @@ int main(int argc, const char **argv_) {
     }
 #endif
 
+    if (global.chunk_threads) {
+      streams->config.cfg.g_pass = VPX_RC_LAST_PASS;
+      open_output_file(streams, &global, &input.pixel_aspect_ratio);
+#if CONFIG_VP9_HIGHBITDEPTH
+      encode_chunks(streams, &global, &input, use_16bit_internal, input_shift);
+#else
+      encode_chunks(streams, &global, &input, 0, 0);
+#endif
+      if (global.show_psnr) {
+        if (global.codec->fourcc == VP9_FOURCC)
+          show_psnr(streams, (1 << streams->config.cfg.g_input_bit_depth) - 1);
+        else
+          show_psnr(streams, 255.0);
+      }
+      close_input_file(&input);
+      close_output_file(streams, global.codec->fourcc);
+      break;
+    }
+
+    FOREACH_STREAM(setup_pass(stream, &global, pass));
+    FOREACH_STREAM(open_output_file(stream, &global,
+                                    &input.pixel_aspect_ratio));
+    FOREACH_STREAM(initialize_encoder(stream, &global));
+
     frame_avail = 1;
     got_data = 0;
 
@@ -2215,6 +2747,8 @@ int main(int argc, const char **argv_) {
       }
     }
 
+    if (global.stage_timing)
+      FOREACH_STREAM(collect_stage_timing(stream));
     FOREACH_STREAM(vpx_codec_destroy(&stream->encoder));
 
     if (global.test_decode != TEST_DECODE_OFF) {
@@ -2248,6 +2782,14 @@ int main(int argc, const char **argv_) {
                                        global.show_rate_hist_buckets));
   FOREACH_STREAM(destroy_rate_histogram(stream->rate_hist));
 
+  if (global.stage_timing) {
+    FOREACH_STREAM({
+      if (stream_cnt > 1)
+        fprintf(stderr, "Stream %d:\n", stream->index);
+      print_stage_timing(stderr, &stream->stage_timing);
+    });
+  }
+
 #if CONFIG_INTERNAL_STATS
   if (!(global.pass == 1 && global.passes == 2))
     FOREACH_STREAM({
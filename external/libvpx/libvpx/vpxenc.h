@@ -54,6 +54,8 @@ struct VpxEncoderConfig {
   int disable_warnings;
   int disable_warning_prompt;
   int experimental_bitstream;
+  int chunk_threads;
+  int stage_timing;
 };
 
 #ifdef __cplusplus
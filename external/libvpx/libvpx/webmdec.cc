@@ -10,14 +10,36 @@
 
 #include "./webmdec.h"
 
+#include <algorithm>
 #include <cstring>
 #include <cstdio>
+#include <vector>
 
 #include "third_party/libwebm/mkvparser.hpp"
 #include "third_party/libwebm/mkvreader.hpp"
 
 namespace {
 
+const long kMaxResidentClusters = 4;
+const char kIndexMagic[8] = { 'V', 'P', 'X', 'W', 'I', 'D', 'X', '1' };
+const int kIndexEntrySize = 16;
+
+struct SeekEntry {
+  int64_t time_ns;
+  int64_t pos;
+};
+
+bool operator<(int64_t time_ns, const SeekEntry &entry) {
+  return time_ns < entry.time_ns;
+}
+
+struct SeekIndex {
+  SeekIndex() : cues_loaded(false), dirty(false) {}
+  std::vector<SeekEntry> entries;
+  bool cues_loaded;
+  bool dirty;
+};
+
 void reset(struct WebmInputContext *const webm_ctx) {
   if (webm_ctx->reader != NULL) {
     mkvparser::MkvReader *const reader =
@@ -32,6 +54,7 @@ void reset(struct WebmInputContext *const webm_ctx) {
   if (webm_ctx->buffer != NULL) {
     delete[] webm_ctx->buffer;
   }
+  delete reinterpret_cast<SeekIndex*>(webm_ctx->seek_index);
   webm_ctx->reader = NULL;
   webm_ctx->segment = NULL;
   webm_ctx->buffer = NULL;
@@ -42,6 +65,8 @@ void reset(struct WebmInputContext *const webm_ctx) {
   webm_ctx->video_track_index = 0;
   webm_ctx->timestamp_ns = 0;
   webm_ctx->is_key_frame = false;
+  webm_ctx->seek_to_key_frame = 0;
+  webm_ctx->seek_index = NULL;
 }
 
 void get_first_cluster(struct WebmInputContext *const webm_ctx) {
@@ -51,6 +76,115 @@ void get_first_cluster(struct WebmInputContext *const webm_ctx) {
   webm_ctx->cluster = cluster;
 }
 
+SeekIndex *get_seek_index(struct WebmInputContext *const webm_ctx) {
+  if (webm_ctx->seek_index == NULL)
+    webm_ctx->seek_index = new SeekIndex;
+  return reinterpret_cast<SeekIndex*>(webm_ctx->seek_index);
+}
+
+void add_index_entry(SeekIndex *const index, int64_t time_ns, int64_t pos) {
+  if (!index->entries.empty() && time_ns <= index->entries.back().time_ns)
+    return;
+  const SeekEntry entry = { time_ns, pos };
+  index->entries.push_back(entry);
+  index->dirty = true;
+}
+
+void load_cues(struct WebmInputContext *const webm_ctx) {
+  SeekIndex *const index = get_seek_index(webm_ctx);
+  if (index->cues_loaded)
+    return;
+  index->cues_loaded = true;
+
+  mkvparser::Segment *const segment =
+      reinterpret_cast<mkvparser::Segment*>(webm_ctx->segment);
+  const mkvparser::SeekHead *const seek_head = segment->GetSeekHead();
+  if (segment->GetCues() == NULL && seek_head != NULL) {
+    for (int i = 0; i < seek_head->GetCount(); ++i) {
+      const mkvparser::SeekHead::Entry *const entry = seek_head->GetEntry(i);
+      if (entry->id == 0x0C53BB6B) {
+        long long pos;
+        long len;
+        segment->ParseCues(entry->pos, pos, len);
+        break;
+      }
+    }
+  }
+
+  const mkvparser::Cues *const cues = segment->GetCues();
+  const mkvparser::Track *const track =
+      segment->GetTracks()->GetTrackByNumber(webm_ctx->video_track_index);
+  if (cues == NULL || track == NULL)
+    return;
+
+  while (!cues->DoneParsing())
+    cues->LoadCuePoint();
+
+  std::vector<SeekEntry> entries;
+  for (const mkvparser::CuePoint *cue = cues->GetFirst(); cue != NULL;
+       cue = cues->GetNext(cue)) {
+    const mkvparser::CuePoint::TrackPosition *const tp = cue->Find(track);
+    if (tp == NULL)
+      continue;
+    const SeekEntry entry = { cue->GetTime(segment), tp->m_pos };
+    if (entries.empty() || entry.time_ns > entries.back().time_ns)
+      entries.push_back(entry);
+  }
+
+  if (entries.size() > index->entries.size()) {
+    index->entries.swap(entries);
+    index->dirty = true;
+  }
+}
+
+const mkvparser::Cluster *get_next_cluster(
+    mkvparser::Segment *const segment,
+    const mkvparser::Cluster *const cluster) {
+  for (;;) {
+    const mkvparser::Cluster *const next = segment->GetNext(cluster);
+    if (next == NULL || !next->EOS())
+      return next;
+    if (segment->LoadCluster() != 0)
+      return next;
+  }
+}
+
+const mkvparser::Block *get_first_video_block(
+    const mkvparser::Cluster *const cluster, int video_track_index) {
+  const mkvparser::BlockEntry *block_entry = NULL;
+  if (cluster->GetFirst(block_entry))
+    return NULL;
+  while (block_entry != NULL && !block_entry->EOS()) {
+    const mkvparser::Block *const block = block_entry->GetBlock();
+    if (block->GetTrackNumber() == video_track_index)
+      return block;
+    if (cluster->GetNext(block_entry, block_entry))
+      return NULL;
+  }
+  return NULL;
+}
+
+int64_t get_file_length(struct WebmInputContext *const webm_ctx) {
+  mkvparser::MkvReader *const reader =
+      reinterpret_cast<mkvparser::MkvReader*>(webm_ctx->reader);
+  long long total, avail;
+  if (reader->Length(&total, &avail))
+    return -1;
+  return total;
+}
+
+void put_le64(uint8_t *buf, uint64_t value) {
+  for (int i = 0; i < 8; ++i)
+    buf[i] = static_cast<uint8_t>(value >> (8 * i));
+}
+
+uint64_t get_le64(const uint8_t *buf) {
+  uint64_t value = 0;
+  for (int i = 7; i >= 0; --i)
+    value = (value << 8) | buf[i];
+  return value;
+}
+
 void rewind_and_reset(struct WebmInputContext *const webm_ctx,
                       struct VpxInputContext *const vpx_ctx) {
   rewind(vpx_ctx->file);
@@ -78,10 +212,11 @@ int file_is_webm(struct WebmInputContext *webm_ctx,
     return 0;
   }
   webm_ctx->segment = segment;
-  if (segment->Load() < 0) {
+  if (segment->ParseHeaders() != 0 || segment->LoadCluster() < 0) {
     rewind_and_reset(webm_ctx, vpx_ctx);
     return 0;
   }
+  segment->SetMaxResidentClusters(kMaxResidentClusters);
 
   const mkvparser::Tracks *const tracks = segment->GetTracks();
   const mkvparser::VideoTrack* video_track = NULL;
@@ -138,14 +273,16 @@ int webm_read_frame(struct WebmInputContext *webm_ctx,
   const mkvparser::BlockEntry *block_entry =
       reinterpret_cast<const mkvparser::BlockEntry*>(webm_ctx->block_entry);
   bool block_entry_eos = false;
+  bool first_in_cluster = false;
   do {
     long status = 0;
     bool get_new_block = false;
     if (block_entry == NULL && !block_entry_eos) {
       status = cluster->GetFirst(block_entry);
       get_new_block = true;
+      first_in_cluster = true;
     } else if (block_entry_eos || block_entry->EOS()) {
-      cluster = segment->GetNext(cluster);
+      cluster = get_next_cluster(segment, cluster);
       if (cluster == NULL || cluster->EOS()) {
         *bytes_in_buffer = 0;
         webm_ctx->reached_eos = 1;
@@ -154,9 +291,14 @@ int webm_read_frame(struct WebmInputContext *webm_ctx,
       status = cluster->GetFirst(block_entry);
       block_entry_eos = false;
       get_new_block = true;
+      first_in_cluster = true;
     } else if (block == NULL ||
                webm_ctx->block_frame_index == block->GetFrameCount() ||
-               block->GetTrackNumber() != webm_ctx->video_track_index) {
+               block->GetTrackNumber() != webm_ctx->video_track_index ||
+               (webm_ctx->seek_to_key_frame && !block->IsKey())) {
+      if (block != NULL &&
+          block->GetTrackNumber() == webm_ctx->video_track_index)
+        first_in_cluster = false;
       status = cluster->GetNext(block_entry, block_entry);
       if (block_entry == NULL || block_entry->EOS()) {
         block_entry_eos = true;
@@ -172,11 +314,19 @@ int webm_read_frame(struct WebmInputContext *webm_ctx,
       webm_ctx->block_frame_index = 0;
     }
   } while (block->GetTrackNumber() != webm_ctx->video_track_index ||
+           (webm_ctx->seek_to_key_frame && !block->IsKey()) ||
            block_entry_eos);
 
   webm_ctx->cluster = cluster;
   webm_ctx->block_entry = block_entry;
   webm_ctx->block = block;
+  webm_ctx->seek_to_key_frame = 0;
+
+  if (first_in_cluster && webm_ctx->block_frame_index == 0 &&
+      block->IsKey()) {
+    add_index_entry(get_seek_index(webm_ctx), block->GetTime(cluster),
+                    cluster->GetPosition());
+  }
 
   const mkvparser::Block::Frame& frame =
       block->GetFrame(webm_ctx->block_frame_index);
@@ -226,6 +376,116 @@ int webm_guess_framerate(struct WebmInputContext *webm_ctx,
   return 0;
 }
 
+int webm_seek(struct WebmInputContext *webm_ctx, uint64_t timestamp_ns) {
+  mkvparser::Segment *const segment =
+      reinterpret_cast<mkvparser::Segment*>(webm_ctx->segment);
+  SeekIndex *const index = get_seek_index(webm_ctx);
+  const int64_t target = static_cast<int64_t>(timestamp_ns);
+
+  load_cues(webm_ctx);
+
+  const std::vector<SeekEntry>::const_iterator it =
+      std::upper_bound(index->entries.begin(), index->entries.end(), target);
+  const mkvparser::Cluster *cluster;
+  if (it == index->entries.begin()) {
+    cluster = segment->GetFirst();
+  } else {
+    cluster = segment->FindOrPreloadCluster((it - 1)->pos);
+  }
+  if (cluster == NULL || cluster->EOS())
+    return -1;
+
+  if (it == index->entries.end()) {
+    const mkvparser::Cluster *next = cluster;
+    for (;;) {
+      next = get_next_cluster(segment, next);
+      if (next == NULL || next->EOS() || next->GetTime() > target)
+        break;
+      const mkvparser::Block *const block =
+          get_first_video_block(next, webm_ctx->video_track_index);
+      if (block != NULL && block->IsKey()) {
+        if (block->GetTime(next) > target)
+          break;
+        add_index_entry(index, block->GetTime(next), next->GetPosition());
+        cluster = next;
+      }
+    }
+  }
+
+  webm_ctx->cluster = cluster;
+  webm_ctx->block_entry = NULL;
+  webm_ctx->block = NULL;
+  webm_ctx->block_frame_index = 0;
+  webm_ctx->timestamp_ns = 0;
+  webm_ctx->reached_eos = 0;
+  webm_ctx->seek_to_key_frame = 1;
+  return 0;
+}
+
+int webm_load_index(struct WebmInputContext *webm_ctx, const char *path) {
+  FILE *const file = fopen(path, "rb");
+  if (file == NULL)
+    return -1;
+
+  uint8_t header[sizeof(kIndexMagic) + 16];
+  std::vector<SeekEntry> entries;
+  bool ok = fread(header, sizeof(header), 1, file) == 1 &&
+            !memcmp(header, kIndexMagic, sizeof(kIndexMagic)) &&
+            static_cast<int64_t>(get_le64(header + 8)) ==
+                get_file_length(webm_ctx);
+  if (ok) {
+    const uint64_t count = get_le64(header + 16);
+    uint8_t buf[kIndexEntrySize];
+    for (uint64_t i = 0; ok && i < count; ++i) {
+      ok = fread(buf, sizeof(buf), 1, file) == 1;
+      const SeekEntry entry = {
+        static_cast<int64_t>(get_le64(buf)),
+        static_cast<int64_t>(get_le64(buf + 8))
+      };
+      ok = ok && entry.pos >= 0 &&
+           (entries.empty() || entry.time_ns > entries.back().time_ns);
+      if (ok)
+        entries.push_back(entry);
+    }
+  }
+  fclose(file);
+  if (!ok)
+    return -1;
+
+  SeekIndex *const index = get_seek_index(webm_ctx);
+  index->entries.swap(entries);
+  index->cues_loaded = true;
+  index->dirty = false;
+  return 0;
+}
+
+int webm_save_index(struct WebmInputContext *webm_ctx, const char *path) {
+  SeekIndex *const index = get_seek_index(webm_ctx);
+  load_cues(webm_ctx);
+  if (!index->dirty)
+    return 0;
+
+  FILE *const file = fopen(path, "wb");
+  if (file == NULL)
+    return -1;
+
+  uint8_t header[sizeof(kIndexMagic) + 16];
+  memcpy(header, kIndexMagic, sizeof(kIndexMagic));
+  put_le64(header + 8, get_file_length(webm_ctx));
+  put_le64(header + 16, index->entries.size());
+  bool ok = fwrite(header, sizeof(header), 1, file) == 1;
+  for (size_t i = 0; ok && i < index->entries.size(); ++i) {
+    uint8_t buf[kIndexEntrySize];
+    put_le64(buf, index->entries[i].time_ns);
+    put_le64(buf + 8, index->entries[i].pos);
+    ok = fwrite(buf, sizeof(buf), 1, file) == 1;
+  }
+  ok = !fclose(file) && ok;
+  if (ok)
+    index->dirty = false;
+  return ok ? 0 : -1;
+}
+
 void webm_free(struct WebmInputContext *webm_ctx) {
   reset(webm_ctx);
 }
@@ -30,6 +30,8 @@ struct WebmInputContext {
   uint64_t timestamp_ns;
   int is_key_frame;
   int reached_eos;
+  int seek_to_key_frame;
+  void *seek_index;
 };
 
 int file_is_webm(struct WebmInputContext *webm_ctx,
@@ -43,6 +45,12 @@ int webm_read_frame(struct WebmInputContext *webm_ctx,
 int webm_guess_framerate(struct WebmInputContext *webm_ctx,
                          struct VpxInputContext *vpx_ctx);
 
+int webm_seek(struct WebmInputContext *webm_ctx, uint64_t timestamp_ns);
+
+int webm_load_index(struct WebmInputContext *webm_ctx, const char *path);
+
+int webm_save_index(struct WebmInputContext *webm_ctx, const char *path);
+
 void webm_free(struct WebmInputContext *webm_ctx);
 
 #ifdef __cplusplus
@@ -130,6 +130,7 @@ vg_local_src_files := \
 	VEX/priv/host_generic_simd128.c \
 	VEX/priv/host_generic_simd256.c \
 	VEX/priv/host_generic_reg_alloc2.c \
+	VEX/priv/host_generic_reg_alloc3.c \
 	VEX/priv/host_x86_defs.c \
 	VEX/priv/host_x86_isel.c \
 	VEX/priv/host_amd64_defs.c \
@@ -189,6 +190,7 @@ vg_local_src_files := \
 	coregrind/m_tooliface.c \
 	coregrind/m_trampoline.S \
 	coregrind/m_translate.c \
+	coregrind/m_transcache.c \
 	coregrind/m_transtab.c \
 	coregrind/m_vki.c \
 	coregrind/m_vkiscnums.c \
@@ -204,6 +206,7 @@ vg_local_src_files := \
 	coregrind/m_debuginfo/misc.c \
 	coregrind/m_debuginfo/d3basics.c \
 	coregrind/m_debuginfo/debuginfo.c \
+	coregrind/m_debuginfo/lazy.c \
 	coregrind/m_debuginfo/readdwarf.c \
 	coregrind/m_debuginfo/readdwarf3.c \
 	coregrind/m_debuginfo/readelf.c \
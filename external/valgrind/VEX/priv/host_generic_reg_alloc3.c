@@ -0,0 +1,943 @@
+
+/*---------------------------------------------------------------*/
+/*--- begin                                 host_reg_alloc3.c ---*/
+/*---------------------------------------------------------------*/
+
+/*
+   This file is part of Valgrind, a dynamic binary instrumentation
+   framework.
+
+   Copyright (C) 2004-2013 OpenWorks LLP
+      info@open-works.net
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2 of the
+   License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301, USA.
+
+   The GNU General Public License is contained in the file COPYING.
+
+   Neither the names of the U.S. Department of Energy nor the
+   University of California nor the names of its contributors may be
+   used to endorse or promote products derived from this software
+   without prior written permission.
+*/
+
+#include "libvex_basictypes.h"
+#include "libvex.h"
+
+#include "main_util.h"
+#include "host_generic_regs.h"
+
+/* Set to 1 for lots of debugging output. */
+#define DEBUG_REGALLOC 0
+
+
+/* This is the same linear-scan-with-spilling algorithm as
+   host_generic_reg_alloc2.c, and produces much the same code, but
+   avoids the parts of that one whose cost grows with the product of
+   the block size and something else.  That matters for the large,
+   heavily instrumented blocks Memcheck produces, which can have
+   thousands of vregs.  The differences are:
+
+   * Vregs are sorted by the end of their live range (a counting sort,
+     since the ends are instruction numbers), so that freeing the
+     rregs of vregs which have just died is a cursor walk rather than
+     a scan of all rregs at each instruction.  The rreg live ranges
+     are sorted the same way.
+
+   * Free and bound rregs are kept as bitsets, as are the rregs of
+     each class, so that finding candidates is a few logical ops.
+
+   * Each vreg has a precomputed, ordered list of the instructions
+     mentioning it, with a cursor that only moves forwards.  Finding
+     the next use of a spill candidate is then amortised constant
+     time, instead of a scan of the rest of the block.
+
+   * When a free rreg has to be chosen among those involved in hard
+     live ranges, take the one whose next hard live range starts
+     last, rather than simply the highest-numbered.  When choosing a
+     vreg to spill, among those whose next use is equally far away,
+     prefer one whose rreg already equals its spill slot, since then
+     no store is needed.
+*/
+
+
+/* Records information on virtual register live ranges.  Computed once
+   and remains unchanged after that. */
+typedef
+   struct {
+      /* Becomes live for the first time after this insn ... */
+      Short live_after;
+      /* Becomes dead for the last time before this insn ... */
+      Short dead_before;
+      /* The "home" spill slot, if needed.  Never changes. */
+      Short spill_offset;
+      /* What kind of register this is. */
+      HRegClass reg_class;
+      /* The instructions mentioning it are
+         mentions[mentions_first .. mentions_first + n_mentions - 1],
+         in increasing order.  next_mention is a cursor into that
+         which only ever moves forwards. */
+      Int mentions_first;
+      Int n_mentions;
+      Int next_mention;
+   }
+   VRegLR;
+
+
+/* Records information on real-register live ranges.  Computed once
+   and remains unchanged after that. */
+typedef
+   struct {
+      HReg rreg;
+      /* Becomes live after this insn ... */
+      Short live_after;
+      /* Becomes dead before this insn ... */
+      Short dead_before;
+   }
+   RRegLR;
+
+
+/* The running state of each allocatable rreg. */
+typedef
+   struct {
+      /* What's it's current disposition?  Mirrored in the free and
+         bound bitsets below. */
+      enum { Free,     /* available for use */
+             Unavail,  /* in a real-reg live range */
+             Bound     /* in use (holding value of some vreg) */
+           }
+           disp;
+      /* Indicates when the rreg has the same value as the spill slot
+         for the associated vreg.  Is safely left at False, and becomes
+         True after a spill store or reload for this rreg. */
+      Bool eq_spill_slot;
+      /* Start of the next hard live range for this rreg which has
+         not yet started, or NO_HLR if none. */
+      Short next_hlr;
+      /* If .disp == Bound, what vreg is it bound to? */
+      HReg vreg;
+   }
+   RRegState;
+
+#define INVALID_RREG_NO ((Short)(-1))
+#define NO_HLR          ((Short)0x7FFF)
+
+#define IS_VALID_VREGNO(_zz) ((_zz) >= 0 && (_zz) < n_vregs)
+#define IS_VALID_RREGNO(_zz) ((_zz) >= 0 && (_zz) < n_rregs)
+
+
+static inline UInt ULong__minIndex ( ULong w64 ) {
+   return __builtin_ctzll(w64);
+}
+
+
+/* Check that this vreg has been assigned a sane spill offset. */
+inline
+static void sanity_check_spill_offset ( VRegLR* vreg )
+{
+   switch (vreg->reg_class) {
+      case HRcVec128: case HRcFlt64:
+         vassert(0 == ((UShort)vreg->spill_offset % 16)); break;
+      default:
+         vassert(0 == ((UShort)vreg->spill_offset % 8)); break;
+   }
+}
+
+
+/* Sort |n| items by |key|, which lies in 0 .. max_key inclusive, by
+   counting.  Writes the resulting order, as indices into the original
+   array, to |order|.  The sort is stable. */
+static void countingSort ( /*OUT*/Int* order, const Short* key, Int n,
+                           Int max_key )
+{
+   Int* count = LibVEX_Alloc_inline((max_key + 2) * sizeof(Int));
+   for (Int i = 0; i < max_key + 2; i++)
+      count[i] = 0;
+   for (Int i = 0; i < n; i++) {
+      vassert(key[i] >= 0 && key[i] <= max_key);
+      count[key[i] + 1]++;
+   }
+   for (Int i = 1; i < max_key + 2; i++)
+      count[i] += count[i-1];
+   for (Int i = 0; i < n; i++)
+      order[count[key[i]]++] = i;
+}
+
+
+/* The number of the next instruction after |from| to mention the
+   vreg described by |lr|, or |num_instrs| if there isn't one. */
+static inline Int nextMention ( VRegLR* lr, const Short* mentions,
+                                Int from, Int num_instrs )
+{
+   Int end = lr->mentions_first + lr->n_mentions;
+   while (lr->next_mention < end && mentions[lr->next_mention] < from)
+      lr->next_mention++;
+   return lr->next_mention < end ? mentions[lr->next_mention] : num_instrs;
+}
+
+
+/* A target-independent register allocator, with the same interface
+   and results as doRegisterAllocation but faster for large blocks.
+   See comments at the top of this file. */
+HInstrArray* doRegisterAllocation_v3 (
+
+   /* Incoming virtual-registerised code. */
+   HInstrArray* instrs_in,
+
+   /* The real-register universe to use. */
+   const RRegUniverse* univ,
+
+   /* Return True iff the given insn is a reg-reg move, in which
+      case also return the src and dst regs. */
+   Bool (*isMove) ( const HInstr*, HReg*, HReg* ),
+
+   /* Get info about register usage in this insn. */
+   void (*getRegUsage) ( HRegUsage*, const HInstr*, Bool ),
+
+   /* Apply a reg-reg mapping to an insn. */
+   void (*mapRegs) ( HRegRemap*, HInstr*, Bool ),
+
+   /* Return insn(s) to spill/restore a real reg to a spill slot
+      offset.  And optionally a function to do direct reloads. */
+   void    (*genSpill)  ( HInstr**, HInstr**, HReg, Int, Bool ),
+   void    (*genReload) ( HInstr**, HInstr**, HReg, Int, Bool ),
+   HInstr* (*directReload) ( HInstr*, HReg, Short ),
+   Int     guest_sizeB,
+
+   /* For debug printing only. */
+   void (*ppInstr) ( const HInstr*, Bool ),
+   void (*ppReg) ( HReg ),
+
+   /* 32/64bit mode */
+   Bool mode64
+)
+{
+#  define N_SPILL64S  (LibVEX_N_SPILL_BYTES / 8)
+
+   const Int n_instrs = instrs_in->arr_used;
+
+   /* Info on vregs, and the vreg numbers in order of .dead_before. */
+   Int     n_vregs;
+   VRegLR* vreg_lrs;      /* [0 .. n_vregs-1] */
+   Int*    vregs_by_db;   /* [0 .. n_vregs-1] */
+   Int     vregs_by_db_next;
+
+   /* For each instruction in turn, the vregs it mentions; indexed via
+      VRegLR.mentions_first. */
+   Short*  mentions;
+
+   /* Real-reg live ranges, in order of .live_after and of
+      .dead_before, with cursors.  For each entry in the first,
+      the index of the next entry for the same rreg, or -1. */
+   RRegLR* rreg_lrs_la;
+   RRegLR* rreg_lrs_db;
+   Int*    rreg_lrs_la_next_same;
+   Int     rreg_lrs_used;
+   Int     rreg_lrs_la_next;
+   Int     rreg_lrs_db_next;
+
+   HRegUsage* reg_usage_arr; /* [0 .. n_instrs-1] */
+
+   /* Running state of the core allocation algorithm. */
+   RRegState* rreg_state;  /* [0 .. n_rregs-1] */
+   Int        n_rregs;
+   Short*     vreg_state;  /* [0 .. n_vregs-1] */
+
+   /* The same, as bitsets over rreg numbers, and the rregs of each
+      class. */
+   ULong free_rregs;
+   ULong bound_rregs;
+   ULong class_rregs[HRcVec128 + 1];
+   /* The rregs involved in any hard live range. */
+   ULong hlr_rregs;
+
+   HRegRemap    remap;
+   HInstrArray* instrs_out;
+
+   vassert(0 == (guest_sizeB % LibVEX_GUEST_STATE_ALIGN));
+   vassert(0 == (LibVEX_N_SPILL_BYTES % LibVEX_GUEST_STATE_ALIGN));
+   vassert(0 == (N_SPILL64S % 2));
+   vassert(N_RREGUNIVERSE_REGS == 64);
+
+   /* As for the v2 allocator. */
+   vassert(n_instrs <= 15000);
+
+#  define INVALID_INSTRNO (-2)
+
+#  define EMIT_INSTR(_instr)                  \
+      do {                                    \
+        HInstr* _tmp = (_instr);              \
+        if (DEBUG_REGALLOC) {                 \
+           vex_printf("**  ");                \
+           (*ppInstr)(_tmp, mode64);          \
+           vex_printf("\n\n");                \
+        }                                     \
+        addHInstr ( instrs_out, _tmp );       \
+      } while (0)
+
+#  define SET_FREE(_k)                                  \
+      do {                                              \
+         rreg_state[_k].disp          = Free;           \
+         rreg_state[_k].vreg          = INVALID_HREG;   \
+         rreg_state[_k].eq_spill_slot = False;          \
+         free_rregs  |=  (1ULL << (_k));                \
+         bound_rregs &= ~(1ULL << (_k));                \
+      } while (0)
+
+#  define SET_BOUND(_k, _vreg)                          \
+      do {                                              \
+         rreg_state[_k].disp = Bound;                   \
+         rreg_state[_k].vreg = (_vreg);                 \
+         free_rregs  &= ~(1ULL << (_k));                \
+         bound_rregs |=  (1ULL << (_k));                \
+      } while (0)
+
+#  define SET_UNAVAIL(_k)                               \
+      do {                                              \
+         rreg_state[_k].disp          = Unavail;        \
+         rreg_state[_k].vreg          = INVALID_HREG;   \
+         rreg_state[_k].eq_spill_slot = False;          \
+         free_rregs  &= ~(1ULL << (_k));                \
+         bound_rregs &= ~(1ULL << (_k));                \
+      } while (0)
+
+#  define EMIT_SPILL_OR_RELOAD(_gen, _k, _offset)               \
+      do {                                                      \
+         HInstr* _i1 = NULL;                                    \
+         HInstr* _i2 = NULL;                                    \
+         (*_gen)( &_i1, &_i2, univ->regs[_k], (_offset), mode64 ); \
+         vassert(_i1 || _i2); /* can't both be NULL */          \
+         if (_i1)                                               \
+            EMIT_INSTR(_i1);                                    \
+         if (_i2)                                               \
+            EMIT_INSTR(_i2);                                    \
+      } while (0)
+
+   /* --------- Stage 0: set up output array --------- */
+   /* --------- and allocate/initialise running state. --------- */
+
+   instrs_out = newHInstrArray();
+
+   n_rregs = univ->allocable;
+   n_vregs = instrs_in->n_vregs;
+
+   /* If this is not so, vreg_state entries will overflow. */
+   vassert(n_vregs < 32767);
+   vassert(n_rregs > 0 && n_rregs <= 64);
+
+   rreg_state = LibVEX_Alloc_inline(n_rregs * sizeof(RRegState));
+   vreg_state = LibVEX_Alloc_inline((n_vregs + 1) * sizeof(Short));
+
+   free_rregs  = 0;
+   bound_rregs = 0;
+   hlr_rregs   = 0;
+   for (Int c = 0; c <= HRcVec128; c++)
+      class_rregs[c] = 0;
+   for (Int j = 0; j < n_rregs; j++) {
+      SET_FREE(j);
+      rreg_state[j].next_hlr = NO_HLR;
+      class_rregs[hregClass(univ->regs[j])] |= 1ULL << j;
+   }
+
+   for (Int j = 0; j < n_vregs; j++)
+      vreg_state[j] = INVALID_RREG_NO;
+
+   /* --------- Stage 1: compute vreg live ranges. --------- */
+   /* --------- Stage 2: compute rreg live ranges. --------- */
+
+   vreg_lrs = LibVEX_Alloc_inline(sizeof(VRegLR) * (n_vregs + 1));
+   for (Int j = 0; j < n_vregs; j++) {
+      vreg_lrs[j].live_after     = INVALID_INSTRNO;
+      vreg_lrs[j].dead_before    = INVALID_INSTRNO;
+      vreg_lrs[j].spill_offset   = 0;
+      vreg_lrs[j].reg_class      = HRcINVALID;
+      vreg_lrs[j].n_mentions     = 0;
+   }
+
+   reg_usage_arr = LibVEX_Alloc_inline(sizeof(HRegUsage) * (n_instrs + 1));
+
+   Int  rreg_lrs_size = 4;
+   Int* rreg_live_after  = LibVEX_Alloc_inline(n_rregs * sizeof(Int));
+   Int* rreg_dead_before = LibVEX_Alloc_inline(n_rregs * sizeof(Int));
+   RRegLR* rreg_lrs = LibVEX_Alloc_inline(rreg_lrs_size * sizeof(RRegLR));
+   rreg_lrs_used = 0;
+
+   for (Int j = 0; j < n_rregs; j++)
+      rreg_live_after[j] = rreg_dead_before[j] = INVALID_INSTRNO;
+
+#  define ADD_RREG_LR(_j, _la, _db)                                     \
+      do {                                                              \
+         if (rreg_lrs_used == rreg_lrs_size) {                          \
+            RRegLR* _arr2                                               \
+               = LibVEX_Alloc_inline(2 * rreg_lrs_size * sizeof(RRegLR)); \
+            for (Int _q = 0; _q < rreg_lrs_used; _q++)                  \
+               _arr2[_q] = rreg_lrs[_q];                                \
+            rreg_lrs = _arr2;                                           \
+            rreg_lrs_size *= 2;                                         \
+         }                                                              \
+         rreg_lrs[rreg_lrs_used].rreg        = univ->regs[_j];          \
+         rreg_lrs[rreg_lrs_used].live_after  = toShort(_la);            \
+         rreg_lrs[rreg_lrs_used].dead_before = toShort(_db);            \
+         rreg_lrs_used++;                                               \
+      } while (0)
+
+   Int n_mentions = 0;
+
+   for (Int ii = 0; ii < n_instrs; ii++) {
+
+      (*getRegUsage)( &reg_usage_arr[ii], instrs_in->arr[ii], mode64 );
+
+      /* for each virtual reg mentioned in the insn ... */
+      for (Int j = 0; j < reg_usage_arr[ii].n_vRegs; j++) {
+
+         HReg vreg = reg_usage_arr[ii].vRegs[j];
+         vassert(hregIsVirtual(vreg));
+
+         Int k = hregIndex(vreg);
+         if (k < 0 || k >= n_vregs) {
+            vex_printf("\n");
+            (*ppInstr)(instrs_in->arr[ii], mode64);
+            vex_printf("\n");
+            vex_printf("vreg %d, n_vregs %d\n", k, n_vregs);
+            vpanic("doRegisterAllocation_v3: out-of-range vreg");
+         }
+
+         if (vreg_lrs[k].reg_class == HRcINVALID) {
+            vreg_lrs[k].reg_class = hregClass(vreg);
+         } else {
+            vassert(vreg_lrs[k].reg_class == hregClass(vreg));
+         }
+
+         switch (reg_usage_arr[ii].vMode[j]) {
+            case HRmWrite:
+               if (vreg_lrs[k].live_after == INVALID_INSTRNO)
+                  vreg_lrs[k].live_after = toShort(ii);
+               break;
+            case HRmRead:
+            case HRmModify:
+               if (vreg_lrs[k].live_after == INVALID_INSTRNO) {
+                  vex_printf("\n\nOFFENDING VREG = %d\n", k);
+                  vpanic("doRegisterAllocation_v3: "
+                         "first event for vreg is Read or Modify");
+               }
+               break;
+            default:
+               vpanic("doRegisterAllocation_v3(1)");
+         }
+         vreg_lrs[k].dead_before = toShort(ii + 1);
+         vreg_lrs[k].n_mentions++;
+         n_mentions++;
+      }
+
+      /* for each allocator-available real reg mentioned in the insn ... */
+      const ULong rRead    = reg_usage_arr[ii].rRead;
+      const ULong rWritten = reg_usage_arr[ii].rWritten;
+      ULong rMentioned     = rRead | rWritten;
+      if (n_rregs < 64)
+         rMentioned &= (1ULL << n_rregs) - 1;
+
+      while (rMentioned != 0) {
+         const UInt  j     = ULong__minIndex(rMentioned);
+         const ULong jMask = 1ULL << j;
+         rMentioned &= ~jMask;
+
+         const Bool isR = (rRead    & jMask) != 0;
+         const Bool isW = (rWritten & jMask) != 0;
+
+         if (isW && !isR) {
+            if (rreg_live_after[j] != INVALID_INSTRNO)
+               ADD_RREG_LR(j, rreg_live_after[j], rreg_dead_before[j]);
+            rreg_live_after[j] = ii;
+         } else if (rreg_live_after[j] == INVALID_INSTRNO) {
+            vex_printf("\nOFFENDING RREG = ");
+            (*ppReg)(univ->regs[j]);
+            vex_printf("\n");
+            vex_printf("\nOFFENDING instr = ");
+            (*ppInstr)(instrs_in->arr[ii], mode64);
+            vex_printf("\n");
+            vpanic("doRegisterAllocation_v3: "
+                   "first event for rreg is Read or Modify");
+         }
+         rreg_dead_before[j] = ii+1;
+      }
+   }
+
+   /* Finish up any rreg live ranges left over. */
+   for (Int j = 0; j < n_rregs; j++) {
+      if (rreg_live_after[j] != INVALID_INSTRNO)
+         ADD_RREG_LR(j, rreg_live_after[j], rreg_dead_before[j]);
+   }
+
+#  undef ADD_RREG_LR
+
+   /* Now that we know how many there are, lay out the list of
+      instructions mentioning each vreg. */
+   mentions = LibVEX_Alloc_inline((n_mentions + 1) * sizeof(Short));
+   {
+      Int first = 0;
+      for (Int j = 0; j < n_vregs; j++) {
+         vreg_lrs[j].mentions_first = first;
+         vreg_lrs[j].next_mention   = first;
+         first += vreg_lrs[j].n_mentions;
+      }
+      vassert(first == n_mentions);
+      for (Int ii = 0; ii < n_instrs; ii++) {
+         for (Int j = 0; j < reg_usage_arr[ii].n_vRegs; j++) {
+            VRegLR* lr = &vreg_lrs[hregIndex(reg_usage_arr[ii].vRegs[j])];
+            mentions[lr->next_mention++] = toShort(ii);
+         }
+      }
+      for (Int j = 0; j < n_vregs; j++)
+         vreg_lrs[j].next_mention = vreg_lrs[j].mentions_first;
+   }
+
+   /* Order the vregs by .dead_before.  Unused vregs have
+      .dead_before == INVALID_INSTRNO and so are made to come first,
+      where they are skipped. */
+   vregs_by_db = LibVEX_Alloc_inline((n_vregs + 1) * sizeof(Int));
+   {
+      Short* key = LibVEX_Alloc_inline((n_vregs + 1) * sizeof(Short));
+      for (Int j = 0; j < n_vregs; j++)
+         key[j] = vreg_lrs[j].dead_before == INVALID_INSTRNO
+                     ? 0 : vreg_lrs[j].dead_before;
+      countingSort(vregs_by_db, key, n_vregs, n_instrs);
+   }
+   vregs_by_db_next = 0;
+
+   /* Order the rreg live ranges both ways, and link together those for
+      the same rreg. */
+   rreg_lrs_la = LibVEX_Alloc_inline((rreg_lrs_used + 1) * sizeof(RRegLR));
+   rreg_lrs_db = LibVEX_Alloc_inline((rreg_lrs_used + 1) * sizeof(RRegLR));
+   rreg_lrs_la_next_same
+      = LibVEX_Alloc_inline((rreg_lrs_used + 1) * sizeof(Int));
+   {
+      Int*   order = LibVEX_Alloc_inline((rreg_lrs_used + 1) * sizeof(Int));
+      Short* key   = LibVEX_Alloc_inline((rreg_lrs_used + 1) * sizeof(Short));
+      Int    last[N_RREGUNIVERSE_REGS];
+
+      for (Int j = 0; j < rreg_lrs_used; j++)
+         key[j] = rreg_lrs[j].live_after;
+      countingSort(order, key, rreg_lrs_used, n_instrs);
+      for (Int j = 0; j < rreg_lrs_used; j++)
+         rreg_lrs_la[j] = rreg_lrs[order[j]];
+
+      for (Int j = 0; j < rreg_lrs_used; j++)
+         key[j] = rreg_lrs[j].dead_before;
+      countingSort(order, key, rreg_lrs_used, n_instrs);
+      for (Int j = 0; j < rreg_lrs_used; j++)
+         rreg_lrs_db[j] = rreg_lrs[order[j]];
+
+      for (Int j = 0; j < n_rregs; j++)
+         last[j] = -1;
+      for (Int j = rreg_lrs_used - 1; j >= 0; j--) {
+         UInt ix = hregIndex(rreg_lrs_la[j].rreg);
+         vassert(ix < n_rregs);
+         rreg_lrs_la_next_same[j] = last[ix];
+         last[ix] = j;
+      }
+      for (Int j = 0; j < n_rregs; j++) {
+         if (last[j] >= 0) {
+            rreg_state[j].next_hlr = rreg_lrs_la[last[j]].live_after;
+            hlr_rregs |= 1ULL << j;
+         }
+      }
+   }
+   rreg_lrs_la_next = 0;
+   rreg_lrs_db_next = 0;
+
+   if (DEBUG_REGALLOC) {
+      for (Int j = 0; j < n_vregs; j++) {
+         vex_printf("vreg %d:  la = %d,  db = %d\n",
+                    j, vreg_lrs[j].live_after, vreg_lrs[j].dead_before );
+      }
+      vex_printf("RRegLRs by LA:\n");
+      for (Int j = 0; j < rreg_lrs_used; j++) {
+         vex_printf("  ");
+         (*ppReg)(rreg_lrs_la[j].rreg);
+         vex_printf("      la = %d,  db = %d\n",
+                    rreg_lrs_la[j].live_after, rreg_lrs_la[j].dead_before );
+      }
+   }
+
+   /* --------- Stage 3: allocate spill slots. --------- */
+
+   /* Exactly as in host_generic_reg_alloc2.c; see comments there. */
+   {
+      Short ss_busy_until_before[N_SPILL64S];
+      for (Int s = 0; s < N_SPILL64S; s++)
+         ss_busy_until_before[s] = 0;
+
+      for (Int j = 0; j < n_vregs; j++) {
+
+         if (vreg_lrs[j].live_after == INVALID_INSTRNO) {
+            vassert(vreg_lrs[j].reg_class == HRcINVALID);
+            continue;
+         }
+
+         Int ss_no = -1;
+         switch (vreg_lrs[j].reg_class) {
+
+            case HRcVec128: case HRcFlt64:
+               for (ss_no = 0; ss_no < N_SPILL64S-1; ss_no += 2)
+                  if (ss_busy_until_before[ss_no+0] <= vreg_lrs[j].live_after
+                      && ss_busy_until_before[ss_no+1]
+                         <= vreg_lrs[j].live_after)
+                     break;
+               if (ss_no >= N_SPILL64S-1) {
+                  vpanic("LibVEX_N_SPILL_BYTES is too low.  "
+                         "Increase and recompile.");
+               }
+               ss_busy_until_before[ss_no+0] = vreg_lrs[j].dead_before;
+               ss_busy_until_before[ss_no+1] = vreg_lrs[j].dead_before;
+               break;
+
+            default:
+               for (ss_no = 0; ss_no < N_SPILL64S; ss_no++)
+                  if (ss_busy_until_before[ss_no] <= vreg_lrs[j].live_after)
+                     break;
+               if (ss_no == N_SPILL64S) {
+                  vpanic("LibVEX_N_SPILL_BYTES is too low.  "
+                         "Increase and recompile.");
+               }
+               ss_busy_until_before[ss_no] = vreg_lrs[j].dead_before;
+               break;
+         }
+
+         vreg_lrs[j].spill_offset = toShort(guest_sizeB * 3 + ss_no * 8);
+         sanity_check_spill_offset( &vreg_lrs[j] );
+      }
+   }
+
+   /* --------- Stage 5: process instructions --------- */
+
+   for (Int ii = 0; ii < n_instrs; ii++) {
+
+      if (DEBUG_REGALLOC) {
+         vex_printf("\n====----====---- Insn %d ----====----====\n", ii);
+         vex_printf("---- ");
+         (*ppInstr)(instrs_in->arr[ii], mode64);
+         vex_printf("\n\n");
+      }
+
+      /* ------------ Sanity checks ------------ */
+
+      /* Only every 13 instructions, and just before the last one, as
+         in the v2 allocator.  They check the running state against
+         itself rather than against the live range tables, so they
+         cost O(n_rregs) each time. */
+      if (ii == n_instrs-1 || (ii > 0 && (ii % 13) == 0)) {
+         ULong free_chk = 0, bound_chk = 0;
+         for (Int j = 0; j < n_rregs; j++) {
+            switch (rreg_state[j].disp) {
+               case Free:
+                  free_chk |= 1ULL << j;
+                  vassert(!rreg_state[j].eq_spill_slot);
+                  break;
+               case Unavail:
+                  vassert(!rreg_state[j].eq_spill_slot);
+                  break;
+               case Bound: {
+                  bound_chk |= 1ULL << j;
+                  vassert(hregIsVirtual(rreg_state[j].vreg));
+                  vassert(hregClass(univ->regs[j])
+                          == hregClass(rreg_state[j].vreg));
+                  Int k = hregIndex(rreg_state[j].vreg);
+                  vassert(IS_VALID_VREGNO(k));
+                  vassert(vreg_state[k] == j);
+                  break;
+               }
+               default:
+                  vassert(0);
+            }
+         }
+         vassert(free_chk == free_rregs);
+         vassert(bound_chk == bound_rregs);
+      }
+
+      /* ------------ Coalescing ------------ */
+
+      /* If doing a reg-reg move between two vregs, and the src's live
+         range ends here and the dst's live range starts here, bind
+         the dst to the src's rreg, and that's all. */
+      HReg vregS = INVALID_HREG;
+      HReg vregD = INVALID_HREG;
+      if ( (*isMove)( instrs_in->arr[ii], &vregS, &vregD )
+           && hregIsVirtual(vregS) && hregIsVirtual(vregD) ) {
+         vassert(hregClass(vregS) == hregClass(vregD));
+         Int k = hregIndex(vregS);
+         Int m = hregIndex(vregD);
+         vassert(IS_VALID_VREGNO(k));
+         vassert(IS_VALID_VREGNO(m));
+         Int n = vreg_state[k];
+         if (vreg_lrs[k].dead_before == ii + 1
+             && vreg_lrs[m].live_after == ii
+             && n != INVALID_RREG_NO) {
+            vassert(IS_VALID_RREGNO(n));
+            if (DEBUG_REGALLOC) {
+               vex_printf("COALESCE ");
+               (*ppReg)(vregS);
+               vex_printf(" -> ");
+               (*ppReg)(vregD);
+               vex_printf("\n\n");
+            }
+            rreg_state[n].vreg = vregD;
+            vreg_state[m] = toShort(n);
+            vreg_state[k] = INVALID_RREG_NO;
+            /* Different vreg, so different spill slot. */
+            rreg_state[n].eq_spill_slot = False;
+            continue;
+         }
+      }
+
+      /* ------ Free up rregs bound to dead vregs ------ */
+
+      while (vregs_by_db_next < n_vregs) {
+         Int v = vregs_by_db[vregs_by_db_next];
+         if (vreg_lrs[v].dead_before > ii)
+            break;
+         vregs_by_db_next++;
+         Int k = vreg_state[v];
+         if (k == INVALID_RREG_NO)
+            continue;
+         vassert(IS_VALID_RREGNO(k));
+         vassert(rreg_state[k].disp == Bound);
+         vreg_state[v] = INVALID_RREG_NO;
+         SET_FREE(k);
+         if (DEBUG_REGALLOC) {
+            vex_printf("free up ");
+            (*ppReg)(univ->regs[k]);
+            vex_printf("\n");
+         }
+      }
+
+      /* ------ Pre-instruction actions for fixed rreg uses ------ */
+
+      /* Rregs entering a hard live range after this insn must be
+         freed up, spilling any vreg they hold which is still live. */
+      while (rreg_lrs_la_next < rreg_lrs_used
+             && rreg_lrs_la[rreg_lrs_la_next].live_after <= ii) {
+         vassert(ii == rreg_lrs_la[rreg_lrs_la_next].live_after);
+         Int k = hregIndex(rreg_lrs_la[rreg_lrs_la_next].rreg);
+         vassert(IS_VALID_RREGNO(k));
+         if (DEBUG_REGALLOC) {
+            vex_printf("need to free up rreg: ");
+            (*ppReg)(univ->regs[k]);
+            vex_printf("\n\n");
+         }
+         if (rreg_state[k].disp == Bound) {
+            Int m = hregIndex(rreg_state[k].vreg);
+            vassert(IS_VALID_VREGNO(m));
+            vreg_state[m] = INVALID_RREG_NO;
+            if (vreg_lrs[m].dead_before > ii
+                && !rreg_state[k].eq_spill_slot) {
+               vassert(vreg_lrs[m].reg_class != HRcINVALID);
+               EMIT_SPILL_OR_RELOAD(genSpill, k, vreg_lrs[m].spill_offset);
+            }
+         }
+         SET_UNAVAIL(k);
+
+         Int next = rreg_lrs_la_next_same[rreg_lrs_la_next];
+         rreg_state[k].next_hlr
+            = next >= 0 ? rreg_lrs_la[next].live_after : NO_HLR;
+
+         rreg_lrs_la_next++;
+      }
+
+      /* ------ Deal with the current instruction. ------ */
+
+      initHRegRemap(&remap);
+
+      /* ------------ BEGIN directReload optimisation ----------- */
+
+      /* As in the v2 allocator. */
+      if (directReload && reg_usage_arr[ii].n_vRegs <= 2) {
+         HReg  cand     = INVALID_HREG;
+         Int   nreads   = 0;
+         Short spilloff = 0;
+
+         for (Int j = 0; j < reg_usage_arr[ii].n_vRegs; j++) {
+            HReg vreg = reg_usage_arr[ii].vRegs[j];
+            vassert(hregIsVirtual(vreg));
+            if (reg_usage_arr[ii].vMode[j] == HRmRead) {
+               nreads++;
+               Int m = hregIndex(vreg);
+               vassert(IS_VALID_VREGNO(m));
+               Int k = vreg_state[m];
+               if (!IS_VALID_RREGNO(k)) {
+                  vassert(vreg_lrs[m].dead_before >= ii+1);
+                  if (vreg_lrs[m].dead_before == ii+1
+                      && hregIsInvalid(cand)) {
+                     spilloff = vreg_lrs[m].spill_offset;
+                     cand = vreg;
+                  }
+               }
+            }
+         }
+
+         if (nreads == 1 && ! hregIsInvalid(cand)) {
+            if (reg_usage_arr[ii].n_vRegs == 2)
+               vassert(! sameHReg(reg_usage_arr[ii].vRegs[0],
+                                  reg_usage_arr[ii].vRegs[1]));
+            HInstr* reloaded
+               = directReload ( instrs_in->arr[ii], cand, spilloff );
+            if (reloaded) {
+               instrs_in->arr[ii] = reloaded;
+               (*getRegUsage)( &reg_usage_arr[ii], instrs_in->arr[ii],
+                               mode64 );
+            }
+         }
+      }
+
+      /* ------------ END directReload optimisation ------------ */
+
+      /* The rregs holding vregs this insn mentions, which must not
+         be spilled to make room for the others. */
+      ULong in_use = 0;
+      for (Int j = 0; j < reg_usage_arr[ii].n_vRegs; j++) {
+         Int n = vreg_state[hregIndex(reg_usage_arr[ii].vRegs[j])];
+         if (n != INVALID_RREG_NO)
+            in_use |= 1ULL << n;
+      }
+
+      /* for each virtual reg mentioned in the insn ... */
+      for (Int j = 0; j < reg_usage_arr[ii].n_vRegs; j++) {
+
+         HReg     vreg = reg_usage_arr[ii].vRegs[j];
+         HRegMode mode = reg_usage_arr[ii].vMode[j];
+         vassert(hregIsVirtual(vreg));
+
+         Int m = hregIndex(vreg);
+         vassert(IS_VALID_VREGNO(m));
+         Int n = vreg_state[m];
+         if (IS_VALID_RREGNO(n)) {
+            vassert(rreg_state[n].disp == Bound);
+            addToHRegRemap(&remap, vreg, univ->regs[n]);
+            if (mode != HRmRead)
+               rreg_state[n].eq_spill_slot = False;
+            continue;
+         }
+         vassert(n == INVALID_RREG_NO);
+
+         const ULong of_class = class_rregs[hregClass(vreg)];
+         Int k = -1;
+
+         ULong cands = free_rregs & of_class;
+         if (cands != 0) {
+            /* Prefer an rreg which is never needed for a hard live
+               range.  Failing that, the one whose next hard live range
+               starts last, and so is least likely to need spilling
+               around it. */
+            if ((cands & ~hlr_rregs) != 0) {
+               k = ULong__minIndex(cands & ~hlr_rregs);
+            } else {
+               while (cands != 0) {
+                  Int c = ULong__minIndex(cands);
+                  cands &= cands - 1;
+                  if (k < 0 || rreg_state[c].next_hlr >= rreg_state[k].next_hlr)
+                     k = c;
+               }
+            }
+            vassert(IS_VALID_RREGNO(k));
+         } else {
+            /* Spill the bound rreg whose vreg is next mentioned
+               furthest ahead, preferring, on a tie, one which
+               doesn't need a spill store. */
+            Int furthest = -1;
+            cands = bound_rregs & of_class & ~in_use;
+            while (cands != 0) {
+               Int c = ULong__minIndex(cands);
+               cands &= cands - 1;
+               Int v = hregIndex(rreg_state[c].vreg);
+               vassert(IS_VALID_VREGNO(v));
+               Int nm = nextMention(&vreg_lrs[v], mentions, ii+1, n_instrs);
+               if (nm > furthest
+                   || (nm == furthest && rreg_state[c].eq_spill_slot
+                       && !rreg_state[k].eq_spill_slot)) {
+                  furthest = nm;
+                  k = c;
+               }
+            }
+
+            if (k == -1) {
+               vex_printf("reg_alloc: can't find a register in class: ");
+               ppHRegClass(hregClass(vreg));
+               vex_printf("\n");
+               vpanic("reg_alloc: can't create a free register.");
+            }
+
+            vassert(rreg_state[k].disp == Bound);
+            vassert(! sameHReg(rreg_state[k].vreg, vreg));
+            Int sp = hregIndex(rreg_state[k].vreg);
+            vassert(IS_VALID_VREGNO(sp));
+            vassert(vreg_lrs[sp].dead_before > ii);
+            vassert(vreg_lrs[sp].reg_class != HRcINVALID);
+            if (!rreg_state[k].eq_spill_slot)
+               EMIT_SPILL_OR_RELOAD(genSpill, k, vreg_lrs[sp].spill_offset);
+            vreg_state[sp] = INVALID_RREG_NO;
+         }
+
+         SET_BOUND(k, vreg);
+         vreg_state[m] = toShort(k);
+         in_use |= 1ULL << k;
+         addToHRegRemap(&remap, vreg, univ->regs[k]);
+
+         /* The first event for a vreg is always a write, so anything
+            else means it has a value which must be reloaded. */
+         if (mode != HRmWrite) {
+            vassert(vreg_lrs[m].reg_class != HRcINVALID);
+            EMIT_SPILL_OR_RELOAD(genReload, k, vreg_lrs[m].spill_offset);
+            rreg_state[k].eq_spill_slot = mode == HRmRead;
+         } else {
+            rreg_state[k].eq_spill_slot = False;
+         }
+
+      } /* iterate over virtual registers in this instruction. */
+
+      /* NOTE, DESTRUCTIVELY MODIFIES instrs_in->arr[ii]. */
+      (*mapRegs)( &remap, instrs_in->arr[ii], mode64 );
+      EMIT_INSTR( instrs_in->arr[ii] );
+
+      /* ------ Post-instruction actions for fixed rreg uses ------ */
+
+      while (rreg_lrs_db_next < rreg_lrs_used
+             && rreg_lrs_db[rreg_lrs_db_next].dead_before <= ii+1) {
+         vassert(ii+1 == rreg_lrs_db[rreg_lrs_db_next].dead_before);
+         Int k = hregIndex(rreg_lrs_db[rreg_lrs_db_next].rreg);
+         vassert(IS_VALID_RREGNO(k));
+         vassert(rreg_state[k].disp == Unavail);
+         SET_FREE(k);
+         rreg_lrs_db_next++;
+      }
+
+   } /* iterate over insns */
+
+   vassert(rreg_lrs_la_next == rreg_lrs_used);
+   vassert(rreg_lrs_db_next == rreg_lrs_used);
+
+   return instrs_out;
+
+#  undef INVALID_INSTRNO
+#  undef EMIT_INSTR
+#  undef SET_FREE
+#  undef SET_BOUND
+#  undef SET_UNAVAIL
+#  undef EMIT_SPILL_OR_RELOAD
+#  undef N_SPILL64S
+}
+
+
+/*---------------------------------------------------------------*/
+/*---                                       host_reg_alloc3.c ---*/
+/*---------------------------------------------------------------*/
@@ -93,8 +93,9 @@ typedef  struct { UInt u32; }  HReg;
    available on any specific host.  For example on x86, the available
    classes are: Int32, Flt64, Vec128 only.
 
-   IMPORTANT NOTE: host_generic_reg_alloc2.c needs how much space is
-   needed to spill each class of register.  It allocates the following
+   IMPORTANT NOTE: host_generic_reg_alloc2.c and
+   host_generic_reg_alloc3.c need to know how much space is needed to
+   spill each class of register.  It allocates the following
    amount of space:
 
       HRcInt32     64 bits
@@ -106,7 +107,8 @@ typedef  struct { UInt u32; }  HReg;
       HRcVec128    128 bits
 
    If you add another regclass, you must remember to update
-   host_generic_reg_alloc2.c accordingly.  
+   host_generic_reg_alloc2.c and host_generic_reg_alloc3.c
+   accordingly.  
 
    When adding entries to enum HRegClass, do not use any value > 14 or < 1.
 */
@@ -478,6 +480,24 @@ HInstrArray* doRegisterAllocation (
    Bool mode64
 );
 
+/* The same, but faster for large blocks.  Selected by
+   VexControl.regalloc_version == 3. */
+extern
+HInstrArray* doRegisterAllocation_v3 (
+   HInstrArray* instrs_in,
+   const RRegUniverse* univ,
+   Bool (*isMove) (const HInstr*, HReg*, HReg*),
+   void (*getRegUsage) (HRegUsage*, const HInstr*, Bool),
+   void (*mapRegs) (HRegRemap*, HInstr*, Bool),
+   void    (*genSpill) (  HInstr**, HInstr**, HReg, Int, Bool ),
+   void    (*genReload) ( HInstr**, HInstr**, HReg, Int, Bool ),
+   HInstr* (*directReload) ( HInstr*, HReg, Short ),
+   Int     guest_sizeB,
+   void (*ppInstr) ( const HInstr*, Bool ),
+   void (*ppReg) ( HReg ),
+   Bool mode64
+);
+
 
 #endif /* ndef __VEX_HOST_GENERIC_REGS_H */
 
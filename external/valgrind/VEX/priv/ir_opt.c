@@ -98,7 +98,7 @@
    Transformation order
    ~~~~~~~~~~~~~~~~~~~~
 
-   There are three levels of optimisation, controlled by
+   There are four levels of optimisation, controlled by
    vex_control.iropt_level.  Define first:
 
    "Cheap transformations" are the following sequence:
@@ -139,6 +139,16 @@
         - Unrolled a loop, and block contains GetI or PutI:
           Do: * Expensive transformations
               * Cheap transformations
+
+   Level 3: as level 2, followed by up to three rounds of
+      * Cheap transformations.
+      * CSE
+   stopping early once CSE has nothing to do, and then dead code
+   removal.  This is for superblocks which the client knows to be
+   hot, and which it has typically had made with more chasing and
+   unrolling than usual, so that Gets and Puts of the same guest
+   state from what were separate blocks only line up after the
+   first round.
 */
 
 /* Implementation notes, 29 Dec 04.
@@ -6674,6 +6684,18 @@ IRSB* do_iropt_BB(
 
    }
 
+   if (vex_control.iropt_level > 2) {
+      Int  i;
+      Bool cses = True;
+      for (i = 0; i < 3 && cses; i++) {
+         bb = cheap_transformations( bb, specHelper,
+                                     preciseMemExnsFn, pxControl );
+         cses = do_cse_BB( bb, False/*!allowLoadsToBeCSEd*/ );
+      }
+      if (cses)
+         do_deadcode_BB( bb );
+   }
+
    return bb;
 }
 
@@ -197,6 +197,24 @@ void LibVEX_default_VexControl ( /*OUT*/ VexControl* vcon )
    vcon->guest_max_insns                = 60;
    vcon->guest_chase_thresh             = 10;
    vcon->guest_chase_cond               = False;
+   vcon->regalloc_version               = 2;
+}
+
+
+static void check_VexControl ( const VexControl* vcon )
+{
+   vassert(vcon->iropt_verbosity >= 0);
+   vassert(vcon->iropt_level >= 0);
+   vassert(vcon->iropt_level <= 3);
+   vassert(vcon->iropt_unroll_thresh >= 0);
+   vassert(vcon->iropt_unroll_thresh <= 400);
+   vassert(vcon->guest_max_insns >= 1);
+   vassert(vcon->guest_max_insns <= 100);
+   vassert(vcon->guest_chase_thresh >= 0);
+   vassert(vcon->guest_chase_thresh < vcon->guest_max_insns);
+   vassert(vcon->guest_chase_cond == True 
+           || vcon->guest_chase_cond == False);
+   vassert(vcon->regalloc_version == 2 || vcon->regalloc_version == 3);
 }
 
 
@@ -225,17 +243,7 @@ void LibVEX_Init (
    vassert(log_bytes);
    vassert(debuglevel >= 0);
 
-   vassert(vcon->iropt_verbosity >= 0);
-   vassert(vcon->iropt_level >= 0);
-   vassert(vcon->iropt_level <= 2);
-   vassert(vcon->iropt_unroll_thresh >= 0);
-   vassert(vcon->iropt_unroll_thresh <= 400);
-   vassert(vcon->guest_max_insns >= 1);
-   vassert(vcon->guest_max_insns <= 100);
-   vassert(vcon->guest_chase_thresh >= 0);
-   vassert(vcon->guest_chase_thresh < vcon->guest_max_insns);
-   vassert(vcon->guest_chase_cond == True 
-           || vcon->guest_chase_cond == False);
+   check_VexControl(vcon);
 
    /* Check that Vex has been built with sizes of basic types as
       stated in priv/libvex_basictypes.h.  Failure of any of these is
@@ -305,6 +313,16 @@ void LibVEX_Init (
 }
 
 
+/* Exported to library client. */
+
+void LibVEX_Update_Control ( const VexControl* vcon )
+{
+   vassert(vex_initdone);
+   check_VexControl(vcon);
+   vex_control = *vcon;
+}
+
+
 /* --------- Make a translation. --------- */
 /* KLUDGE: S390 need to know the hwcaps of the host when generating
    code. But that info is not passed to emit_S390Instr. Only mode64 is
@@ -1035,11 +1053,18 @@ VexTranslateResult LibVEX_Translate ( VexTranslateArgs* vta )
    }
 
    /* Register allocate. */
-   rcode = doRegisterAllocation ( vcode, rRegUniv,
-                                  isMove, getRegUsage, mapRegs, 
-                                  genSpill, genReload, directReload, 
-                                  guest_sizeB,
-                                  ppInstr, ppReg, mode64 );
+   if (vex_control.regalloc_version == 3)
+      rcode = doRegisterAllocation_v3 ( vcode, rRegUniv,
+                                        isMove, getRegUsage, mapRegs,
+                                        genSpill, genReload, directReload,
+                                        guest_sizeB,
+                                        ppInstr, ppReg, mode64 );
+   else
+      rcode = doRegisterAllocation ( vcode, rRegUniv,
+                                     isMove, getRegUsage, mapRegs, 
+                                     genSpill, genReload, directReload, 
+                                     guest_sizeB,
+                                     ppInstr, ppReg, mode64 );
 
    vexAllocSanityCheck();
 
@@ -430,7 +430,9 @@ typedef
       /* Controls verbosity of iropt.  0 = no output. */
       Int iropt_verbosity;
       /* Control aggressiveness of iropt.  0 = no opt, 1 = simple
-         opts, 2 (default) = max optimisation. */
+         opts, 2 (default) = usual optimisation, 3 = as 2 but keep
+         cleaning up until nothing more is found.  3 is meant for
+         blocks known to be hot. */
       Int iropt_level;
       /* Controls when registers are updated in guest state.  Note
          that this is the default value.  The VEX client can override
@@ -457,6 +459,9 @@ typedef
       /* EXPERIMENTAL: chase across conditional branches?  Not all
          front ends honour this.  Default: NO. */
       Bool guest_chase_cond;
+      /* Which register allocator to use: 2 (default) = the original
+         one, 3 = one that is faster for large blocks. */
+      Int regalloc_version;
    }
    VexControl;
 
@@ -566,6 +571,11 @@ extern void LibVEX_Init (
    const VexControl* vcon
 );
 
+/* Change the settings given to LibVEX_Init.  They apply to all
+   translations made from now on. */
+
+extern void LibVEX_Update_Control ( const VexControl* vcon );
+
 
 /*-------------------------------------------------------*/
 /*--- Make a translation                              ---*/
@@ -134,6 +134,17 @@ Bool VG_(str_clo_cache_opt)(const HChar *arg,
       return False;
 }
 
+Bool VG_(str_clo_ML_cache_opt)(const HChar *arg, cache_t* clo_MLc)
+{
+   const HChar* tmp_str;
+
+   if VG_STR_CLO(arg, "--ML", tmp_str) {
+      parse_cache_opt(clo_MLc, arg, tmp_str);
+      return True;
+   } else
+      return False;
+}
+
 static void umsg_cache_img(const HChar* desc, cache_t* c)
 {
    VG_(umsg)("  %s: %'d B, %d-way, %d B lines\n", desc,
@@ -52,6 +52,11 @@ Bool VG_(str_clo_cache_opt)(const HChar *arg,
                             cache_t* clo_D1c,
                             cache_t* clo_LLc);
 
+// Like VG_(str_clo_cache_opt), but for the optional mid-level cache
+// configured by --ML=<size>,<assoc>,<line_size>.  Only Cachegrind
+// simulates a mid-level cache; Callgrind doesn't accept --ML.
+Bool VG_(str_clo_ML_cache_opt)(const HChar *arg, cache_t* clo_MLc);
+
 // Checks the correctness of the auto-detected caches.
 // If a cache has been configured by command line options, it
 // replaces the equivalent auto-detected cache.
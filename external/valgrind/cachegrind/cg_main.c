@@ -77,7 +77,8 @@ typedef
    struct {
       ULong a;  /* total # memory accesses of this kind */
       ULong m1; /* misses in the first level cache */
-      ULong mL; /* misses in the second level cache */
+      ULong m2; /* misses in the mid-level cache (only with --ML) */
+      ULong mL; /* misses in the last level cache */
    }
    CacheCC;
 
@@ -147,11 +148,39 @@ struct _InstrInfo {
    LineCC* parent;         // parent line-CC
 };
 
+// A batch of cache events, handed to log_batch_cache_access() by a single
+// helper call.  Data addresses are passed through cg_batch_ea[].
+typedef
+   enum {
+      BEv_IrNoX,          // as Ev_IrNoX
+      BEv_IrNoXSameLine,  // IrNoX on the same I1 line as the event before
+      BEv_IrGen,          // as Ev_IrGen
+      BEv_Dr,             // data read or modify, address in cg_batch_ea[slot]
+      BEv_Dw              // data write, address in cg_batch_ea[slot]
+   }
+   BatchEvKind;
+
+typedef struct {
+   UChar      kind;        // BatchEvKind
+   UChar      szB;         // data size, for BEv_Dr and BEv_Dw
+   UShort     slot;        // index in cg_batch_ea, for BEv_Dr and BEv_Dw
+   InstrInfo* inode;
+}
+BatchEv;
+
+typedef struct _CacheBatch CacheBatch;
+struct _CacheBatch {
+   CacheBatch* next;       // next batch of the same SB
+   Int         n_evs;
+   BatchEv     evs[0];
+};
+
 typedef struct _SB_info SB_info;
 struct _SB_info {
-   Addr      SB_addr;      // key;  MUST BE FIRST
-   Int       n_instrs;
-   InstrInfo instrs[0];
+   Addr        SB_addr;    // key;  MUST BE FIRST
+   Int         n_instrs;
+   CacheBatch* batches;    // freed along with the SB_info
+   InstrInfo   instrs[0];
 };
 
 static OSet* instrInfoTable;
@@ -267,12 +296,15 @@ static LineCC* get_lineCC(Addr origAddr)
       lineCC->loc.line = loc.line;
       lineCC->Ir.a     = 0;
       lineCC->Ir.m1    = 0;
+      lineCC->Ir.m2    = 0;
       lineCC->Ir.mL    = 0;
       lineCC->Dr.a     = 0;
       lineCC->Dr.m1    = 0;
+      lineCC->Dr.m2    = 0;
       lineCC->Dr.mL    = 0;
       lineCC->Dw.a     = 0;
       lineCC->Dw.m1    = 0;
+      lineCC->Dw.m2    = 0;
       lineCC->Dw.mL    = 0;
       lineCC->Bc.b     = 0;
       lineCC->Bc.mp    = 0;
@@ -332,7 +364,8 @@ void log_1IrGen_0D_cache_access(InstrInfo* n)
    //VG_(printf)("1IrGen_0D :  CCaddr=0x%010lx,  iaddr=0x%010lx,  isize=%lu\n",
    //             n, n->instr_addr, n->instr_len);
    cachesim_I1_doref_Gen(n->instr_addr, n->instr_len,
-			 &n->parent->Ir.m1, &n->parent->Ir.mL);
+			 &n->parent->Ir.m1, &n->parent->Ir.m2,
+			 &n->parent->Ir.mL);
    n->parent->Ir.a++;
 }
 
@@ -342,73 +375,9 @@ void log_1IrNoX_0D_cache_access(InstrInfo* n)
    //VG_(printf)("1IrNoX_0D :  CCaddr=0x%010lx,  iaddr=0x%010lx,  isize=%lu\n",
    //             n, n->instr_addr, n->instr_len);
    cachesim_I1_doref_NoX(n->instr_addr, n->instr_len,
-			 &n->parent->Ir.m1, &n->parent->Ir.mL);
-   n->parent->Ir.a++;
-}
-
-static VG_REGPARM(2)
-void log_2IrNoX_0D_cache_access(InstrInfo* n, InstrInfo* n2)
-{
-   //VG_(printf)("2IrNoX_0D : CC1addr=0x%010lx, i1addr=0x%010lx, i1size=%lu\n"
-   //            "            CC2addr=0x%010lx, i2addr=0x%010lx, i2size=%lu\n",
-   //            n,  n->instr_addr,  n->instr_len,
-   //            n2, n2->instr_addr, n2->instr_len);
-   cachesim_I1_doref_NoX(n->instr_addr, n->instr_len,
-			 &n->parent->Ir.m1, &n->parent->Ir.mL);
-   n->parent->Ir.a++;
-   cachesim_I1_doref_NoX(n2->instr_addr, n2->instr_len,
-			 &n2->parent->Ir.m1, &n2->parent->Ir.mL);
-   n2->parent->Ir.a++;
-}
-
-static VG_REGPARM(3)
-void log_3IrNoX_0D_cache_access(InstrInfo* n, InstrInfo* n2, InstrInfo* n3)
-{
-   //VG_(printf)("3IrNoX_0D : CC1addr=0x%010lx, i1addr=0x%010lx, i1size=%lu\n"
-   //            "            CC2addr=0x%010lx, i2addr=0x%010lx, i2size=%lu\n"
-   //            "            CC3addr=0x%010lx, i3addr=0x%010lx, i3size=%lu\n",
-   //            n,  n->instr_addr,  n->instr_len,
-   //            n2, n2->instr_addr, n2->instr_len,
-   //            n3, n3->instr_addr, n3->instr_len);
-   cachesim_I1_doref_NoX(n->instr_addr, n->instr_len,
-			 &n->parent->Ir.m1, &n->parent->Ir.mL);
-   n->parent->Ir.a++;
-   cachesim_I1_doref_NoX(n2->instr_addr, n2->instr_len,
-			 &n2->parent->Ir.m1, &n2->parent->Ir.mL);
-   n2->parent->Ir.a++;
-   cachesim_I1_doref_NoX(n3->instr_addr, n3->instr_len,
-			 &n3->parent->Ir.m1, &n3->parent->Ir.mL);
-   n3->parent->Ir.a++;
-}
-
-static VG_REGPARM(3)
-void log_1IrNoX_1Dr_cache_access(InstrInfo* n, Addr data_addr, Word data_size)
-{
-   //VG_(printf)("1IrNoX_1Dr:  CCaddr=0x%010lx,  iaddr=0x%010lx,  isize=%lu\n"
-   //            "                               daddr=0x%010lx,  dsize=%lu\n",
-   //            n, n->instr_addr, n->instr_len, data_addr, data_size);
-   cachesim_I1_doref_NoX(n->instr_addr, n->instr_len,
-			 &n->parent->Ir.m1, &n->parent->Ir.mL);
-   n->parent->Ir.a++;
-
-   cachesim_D1_doref(data_addr, data_size, 
-                     &n->parent->Dr.m1, &n->parent->Dr.mL);
-   n->parent->Dr.a++;
-}
-
-static VG_REGPARM(3)
-void log_1IrNoX_1Dw_cache_access(InstrInfo* n, Addr data_addr, Word data_size)
-{
-   //VG_(printf)("1IrNoX_1Dw:  CCaddr=0x%010lx,  iaddr=0x%010lx,  isize=%lu\n"
-   //            "                               daddr=0x%010lx,  dsize=%lu\n",
-   //            n, n->instr_addr, n->instr_len, data_addr, data_size);
-   cachesim_I1_doref_NoX(n->instr_addr, n->instr_len,
-			 &n->parent->Ir.m1, &n->parent->Ir.mL);
+			 &n->parent->Ir.m1, &n->parent->Ir.m2,
+			 &n->parent->Ir.mL);
    n->parent->Ir.a++;
-
-   cachesim_D1_doref(data_addr, data_size, 
-                     &n->parent->Dw.m1, &n->parent->Dw.mL);
-   n->parent->Dw.a++;
 }
 
 /* Note that addEvent_D_guarded assumes that log_0Ir_1Dr_cache_access
@@ -419,8 +388,9 @@ void log_0Ir_1Dr_cache_access(InstrInfo* n, Addr data_addr, Word data_size)
 {
    //VG_(printf)("0Ir_1Dr:  CCaddr=0x%010lx,  daddr=0x%010lx,  dsize=%lu\n",
    //            n, data_addr, data_size);
-   cachesim_D1_doref(data_addr, data_size, 
-                     &n->parent->Dr.m1, &n->parent->Dr.mL);
+   cachesim_D1_doref(data_addr, data_size, n->instr_addr,
+                     &n->parent->Dr.m1, &n->parent->Dr.m2,
+                     &n->parent->Dr.mL);
    n->parent->Dr.a++;
 }
 
@@ -430,11 +400,66 @@ void log_0Ir_1Dw_cache_access(InstrInfo* n, Addr data_addr, Word data_size)
 {
    //VG_(printf)("0Ir_1Dw:  CCaddr=0x%010lx,  daddr=0x%010lx,  dsize=%lu\n",
    //            n, data_addr, data_size);
-   cachesim_D1_doref(data_addr, data_size, 
-                     &n->parent->Dw.m1, &n->parent->Dw.mL);
+   cachesim_D1_doref(data_addr, data_size, n->instr_addr,
+                     &n->parent->Dw.m1, &n->parent->Dw.m2,
+                     &n->parent->Dw.mL);
    n->parent->Dw.a++;
 }
 
+/* Data addresses for the batch being processed by
+   log_batch_cache_access.  The generated code stores them here just
+   before the call.  Cachegrind does not run threads in parallel, so
+   one buffer will do.  Must have room for N_EVENTS addresses. */
+#define N_BATCH_EAS 16
+
+static Addr cg_batch_ea[N_BATCH_EAS];
+
+/* Simulates, in order, all the cache events of a group of
+   instructions.  This replaces one helper call per one to three
+   events; most groups are a whole superblock, or the part of it
+   before a side exit. */
+static VG_REGPARM(1)
+void log_batch_cache_access(CacheBatch* b)
+{
+   Int i;
+   for (i = 0; i < b->n_evs; i++) {
+      const BatchEv* ev = &b->evs[i];
+      InstrInfo*     n  = ev->inode;
+      switch (ev->kind) {
+         case BEv_IrNoXSameLine:
+            /* The previous access made this line MRU in I1. */
+            n->parent->Ir.a++;
+            break;
+         case BEv_IrNoX:
+            cachesim_I1_doref_NoX(n->instr_addr, n->instr_len,
+                                  &n->parent->Ir.m1, &n->parent->Ir.m2,
+                                  &n->parent->Ir.mL);
+            n->parent->Ir.a++;
+            break;
+         case BEv_IrGen:
+            cachesim_I1_doref_Gen(n->instr_addr, n->instr_len,
+                                  &n->parent->Ir.m1, &n->parent->Ir.m2,
+                                  &n->parent->Ir.mL);
+            n->parent->Ir.a++;
+            break;
+         case BEv_Dr:
+            cachesim_D1_doref(cg_batch_ea[ev->slot], ev->szB, n->instr_addr,
+                              &n->parent->Dr.m1, &n->parent->Dr.m2,
+                              &n->parent->Dr.mL);
+            n->parent->Dr.a++;
+            break;
+         case BEv_Dw:
+            cachesim_D1_doref(cg_batch_ea[ev->slot], ev->szB, n->instr_addr,
+                              &n->parent->Dw.m1, &n->parent->Dw.m2,
+                              &n->parent->Dw.mL);
+            n->parent->Dw.a++;
+            break;
+         default:
+            tl_assert(0);
+      }
+   }
+}
+
 /* For branches, we consult two different predictors, one which
    predicts taken/untaken for conditional branches, and the other
    which predicts the branch target address for indirect branches
@@ -570,6 +595,8 @@ static Int get_Event_dszB ( Event* ev ) {
    address temporaries. */
 #define N_EVENTS 16
 
+STATIC_ASSERT(N_EVENTS <= N_BATCH_EAS);
+
 
 /* A struct which holds all the running state during instrumentation.
    Mostly to avoid passing loads of parameters everywhere. */
@@ -624,6 +651,7 @@ SB_info* get_SB_info(IRSB* sbIn, Addr origAddr)
                                 sizeof(SB_info) + n_instrs*sizeof(InstrInfo)); 
    sbInfo->SB_addr  = origAddr;
    sbInfo->n_instrs = n_instrs;
+   sbInfo->batches  = NULL;
    VG_(OSetGen_Insert)( instrInfoTable, sbInfo );
 
    return sbInfo;
@@ -690,6 +718,101 @@ InstrInfo* setup_InstrInfo ( CgState* cgs, Addr instr_addr, UInt instr_len )
    empty.  Code is generated into cgs->bbOut, and this activity
    'consumes' slots in cgs->sbInfo. */
 
+static Bool is_cache_Event ( const Event* ev )
+{
+   switch (ev->tag) {
+      case Ev_IrNoX: case Ev_IrGen: case Ev_Dr: case Ev_Dw: case Ev_Dm:
+         return True;
+      default:
+         return False;
+   }
+}
+
+/* Generate code to simulate all the cache events in the queue with a
+   single call to log_batch_cache_access, and remove them from the
+   queue, leaving only the branch events. */
+static void flushEvents_batched ( CgState* cgs )
+{
+#  if defined(VG_BIGENDIAN)
+#    define END Iend_BE
+#  elif defined(VG_LITTLEENDIAN)
+#    define END Iend_LE
+#  else
+#    error "Unknown endianness"
+#  endif
+   Int         i, n_evs, n_left;
+   CacheBatch* b;
+   BatchEv*    bev;
+   IRDirty*    di;
+   Bool        prev_was_IrNoX = False;
+
+   n_evs = 0;
+   for (i = 0; i < cgs->events_used; i++)
+      if (is_cache_Event(&cgs->events[i]))
+         n_evs++;
+
+   b = VG_(malloc)("cg.main.feb.1",
+                   sizeof(CacheBatch) + n_evs * sizeof(BatchEv));
+   b->n_evs = n_evs;
+   b->next  = cgs->sbInfo->batches;
+   cgs->sbInfo->batches = b;
+
+   n_evs  = 0;
+   n_left = 0;
+   for (i = 0; i < cgs->events_used; i++) {
+      Event* ev = &cgs->events[i];
+      if (!is_cache_Event(ev)) {
+         cgs->events[n_left++] = *ev;
+         continue;
+      }
+      bev = &b->evs[n_evs];
+      bev->inode = ev->inode;
+      bev->szB   = 0;
+      bev->slot  = 0;
+      switch (ev->tag) {
+         case Ev_IrNoX:
+            /* An IrNoX straight after another one on the same line is
+               an I1 hit: nothing can have evicted the line between
+               them. */
+            if (prev_was_IrNoX
+                && (ev->inode->instr_addr >> I1.line_size_bits)
+                   == (b->evs[n_evs-1].inode->instr_addr >> I1.line_size_bits))
+               bev->kind = BEv_IrNoXSameLine;
+            else
+               bev->kind = BEv_IrNoX;
+            break;
+         case Ev_IrGen:
+            bev->kind = BEv_IrGen;
+            break;
+         case Ev_Dr:
+         case Ev_Dm:
+         case Ev_Dw:
+            bev->kind = ev->tag == Ev_Dw ? BEv_Dw : BEv_Dr;
+            bev->szB  = get_Event_dszB(ev);
+            bev->slot = n_evs;
+            addStmtToIRSB(
+               cgs->sbOut,
+               IRStmt_Store(END, mkIRExpr_HWord( (HWord)&cg_batch_ea[n_evs] ),
+                                 get_Event_dea(ev)) );
+            break;
+         default:
+            tl_assert(0);
+      }
+      prev_was_IrNoX = ev->tag == Ev_IrNoX;
+      n_evs++;
+   }
+   tl_assert(n_evs == b->n_evs);
+   tl_assert(n_evs <= N_BATCH_EAS);
+
+   di = unsafeIRDirty_0_N( 1, "log_batch_cache_access",
+                           VG_(fnptr_to_fnentry)( &log_batch_cache_access ),
+                           mkIRExprVec_1( mkIRExpr_HWord( (HWord)b ) ) );
+   addStmtToIRSB( cgs->sbOut, IRStmt_Dirty(di) );
+
+   cgs->events_used = n_left;
+#  undef END
+}
+
 static void flushEvents ( CgState* cgs )
 {
    Int        i, regparms;
@@ -702,6 +825,18 @@ static void flushEvents ( CgState* cgs )
    Event*     ev2;
    Event*     ev3;
 
+   /* With cache simulation, hand any group of two or more cache events
+      to the simulator in one go.  The branch predictors have state of
+      their own, so branch events can be dealt with after the batch. */
+   if (clo_cache_sim) {
+      Int n_cache_evs = 0;
+      for (i = 0; i < cgs->events_used; i++)
+         if (is_cache_Event(&cgs->events[i]))
+            n_cache_evs++;
+      if (n_cache_evs >= 2)
+         flushEvents_batched(cgs);
+   }
+
    i = 0;
    while (i < cgs->events_used) {
 
@@ -729,48 +864,14 @@ static void flushEvents ( CgState* cgs )
          i appropriately. */
       switch (ev->tag) {
          case Ev_IrNoX:
-            /* Merge an IrNoX with a following Dr/Dm. */
-            if (ev2 && (ev2->tag == Ev_Dr || ev2->tag == Ev_Dm)) {
-               /* Why is this true?  It's because we're merging an Ir
-                  with a following Dr or Dm.  The Ir derives from the
-                  instruction's IMark and the Dr/Dm from data
-                  references which follow it.  In short it holds
-                  because each insn starts with an IMark, hence an
-                  Ev_Ir, and so these Dr/Dm must pertain to the
-                  immediately preceding Ir.  Same applies to analogous
-                  assertions in the subsequent cases. */
-               tl_assert(ev2->inode == ev->inode);
-               helperName = "log_1IrNoX_1Dr_cache_access";
-               helperAddr = &log_1IrNoX_1Dr_cache_access;
-               argv = mkIRExprVec_3( i_node_expr,
-                                     get_Event_dea(ev2),
-                                     mkIRExpr_HWord( get_Event_dszB(ev2) ) );
-               regparms = 3;
-               i += 2;
-            }
-            /* Merge an IrNoX with a following Dw. */
-            else
-            if (ev2 && ev2->tag == Ev_Dw) {
-               tl_assert(ev2->inode == ev->inode);
-               helperName = "log_1IrNoX_1Dw_cache_access";
-               helperAddr = &log_1IrNoX_1Dw_cache_access;
-               argv = mkIRExprVec_3( i_node_expr,
-                                     get_Event_dea(ev2),
-                                     mkIRExpr_HWord( get_Event_dszB(ev2) ) );
-               regparms = 3;
-               i += 2;
-            }
+            /* With cache simulation, groups of events have been
+               batched above, so there is nothing to merge with. */
             /* Merge an IrNoX with two following IrNoX's. */
-            else
-            if (ev2 && ev3 && ev2->tag == Ev_IrNoX && ev3->tag == Ev_IrNoX)
+            if (!clo_cache_sim && ev2 && ev3
+                && ev2->tag == Ev_IrNoX && ev3->tag == Ev_IrNoX)
             {
-               if (clo_cache_sim) {
-                  helperName = "log_3IrNoX_0D_cache_access";
-                  helperAddr = &log_3IrNoX_0D_cache_access;
-               } else {
-                  helperName = "log_3Ir";
-                  helperAddr = &log_3Ir;
-               }
+               helperName = "log_3Ir";
+               helperAddr = &log_3Ir;
                argv = mkIRExprVec_3( i_node_expr, 
                                      mkIRExpr_HWord( (HWord)ev2->inode ), 
                                      mkIRExpr_HWord( (HWord)ev3->inode ) );
@@ -779,14 +880,9 @@ static void flushEvents ( CgState* cgs )
             }
             /* Merge an IrNoX with one following IrNoX. */
             else
-            if (ev2 && ev2->tag == Ev_IrNoX) {
-               if (clo_cache_sim) {
-                  helperName = "log_2IrNoX_0D_cache_access";
-                  helperAddr = &log_2IrNoX_0D_cache_access;
-               } else {
-                  helperName = "log_2Ir";
-                  helperAddr = &log_2Ir;
-               }
+            if (!clo_cache_sim && ev2 && ev2->tag == Ev_IrNoX) {
+               helperName = "log_2Ir";
+               helperAddr = &log_2Ir;
                argv = mkIRExprVec_2( i_node_expr,
                                      mkIRExpr_HWord( (HWord)ev2->inode ) );
                regparms = 2;
@@ -1357,6 +1453,11 @@ IRSB* cg_instrument ( VgCallbackClosure* closure,
 static cache_t clo_I1_cache = UNDEFINED_CACHE;
 static cache_t clo_D1_cache = UNDEFINED_CACHE;
 static cache_t clo_LL_cache = UNDEFINED_CACHE;
+static cache_t clo_ML_cache = UNDEFINED_CACHE;
+
+static CachePolicy clo_ML_policy = CachePolicyNINE;
+static CachePolicy clo_LL_policy = CachePolicyNINE;
+static Bool        clo_prefetch  = False;
 
 /*------------------------------------------------------------*/
 /*--- cg_fini() and related function                       ---*/
@@ -1406,6 +1507,8 @@ static void fprint_CC_table_and_calc_totals(void)
                      "desc: D1 cache:         %s\n"
                      "desc: LL cache:         %s\n",
                      I1.desc_line, D1.desc_line, LL.desc_line);
+   if (cachesim_ML)
+      VG_(fprintf)(fp, "desc: ML cache:         %s\n", ML.desc_line);
 
    // "cmd:" line
    VG_(fprintf)(fp, "cmd: %s", VG_(args_the_exename));
@@ -1413,8 +1516,14 @@ static void fprint_CC_table_and_calc_totals(void)
       HChar* arg = * (HChar**) VG_(indexXA)( VG_(args_for_client), i );
       VG_(fprintf)(fp, " %s", arg);
    }
-   // "events:" line
-   if (clo_cache_sim && clo_branch_sim) {
+   // "events:" line.  With a mid-level cache, its misses get their own
+   // columns between the L1 and LL ones.
+   if (clo_cache_sim && cachesim_ML) {
+      VG_(fprintf)(fp, "\nevents: Ir I1mr IMmr ILmr Dr D1mr DMmr DLmr "
+                                  "Dw D1mw DMmw DLmw%s\n",
+                       clo_branch_sim ? " Bc Bcm Bi Bim" : "");
+   }
+   else if (clo_cache_sim && clo_branch_sim) {
       VG_(fprintf)(fp, "\nevents: Ir I1mr ILmr Dr D1mr DLmr Dw D1mw DLmw "
                                   "Bc Bcm Bi Bim\n");
    }
@@ -1455,7 +1564,24 @@ static void fprint_CC_table_and_calc_totals(void)
       }
 
       // Print the LineCC
-      if (clo_cache_sim && clo_branch_sim) {
+      if (clo_cache_sim && cachesim_ML) {
+         VG_(fprintf)(fp,  "%u %llu %llu %llu %llu"
+                             " %llu %llu %llu %llu"
+                             " %llu %llu %llu %llu",
+                            lineCC->loc.line,
+                            lineCC->Ir.a, lineCC->Ir.m1, lineCC->Ir.m2,
+                            lineCC->Ir.mL,
+                            lineCC->Dr.a, lineCC->Dr.m1, lineCC->Dr.m2,
+                            lineCC->Dr.mL,
+                            lineCC->Dw.a, lineCC->Dw.m1, lineCC->Dw.m2,
+                            lineCC->Dw.mL);
+         if (clo_branch_sim)
+            VG_(fprintf)(fp, " %llu %llu %llu %llu",
+                             lineCC->Bc.b, lineCC->Bc.mp,
+                             lineCC->Bi.b, lineCC->Bi.mp);
+         VG_(fprintf)(fp, "\n");
+      }
+      else if (clo_cache_sim && clo_branch_sim) {
          VG_(fprintf)(fp,  "%u %llu %llu %llu"
                              " %llu %llu %llu"
                              " %llu %llu %llu"
@@ -1493,12 +1619,15 @@ static void fprint_CC_table_and_calc_totals(void)
       // Update summary stats
       Ir_total.a  += lineCC->Ir.a;
       Ir_total.m1 += lineCC->Ir.m1;
+      Ir_total.m2 += lineCC->Ir.m2;
       Ir_total.mL += lineCC->Ir.mL;
       Dr_total.a  += lineCC->Dr.a;
       Dr_total.m1 += lineCC->Dr.m1;
+      Dr_total.m2 += lineCC->Dr.m2;
       Dr_total.mL += lineCC->Dr.mL;
       Dw_total.a  += lineCC->Dw.a;
       Dw_total.m1 += lineCC->Dw.m1;
+      Dw_total.m2 += lineCC->Dw.m2;
       Dw_total.mL += lineCC->Dw.mL;
       Bc_total.b  += lineCC->Bc.b;
       Bc_total.mp += lineCC->Bc.mp;
@@ -1510,7 +1639,21 @@ static void fprint_CC_table_and_calc_totals(void)
 
    // Summary stats must come after rest of table, since we calculate them
    // during traversal.  */
-   if (clo_cache_sim && clo_branch_sim) {
+   if (clo_cache_sim && cachesim_ML) {
+      VG_(fprintf)(fp,  "summary:"
+                        " %llu %llu %llu %llu"
+                        " %llu %llu %llu %llu"
+                        " %llu %llu %llu %llu",
+                        Ir_total.a, Ir_total.m1, Ir_total.m2, Ir_total.mL,
+                        Dr_total.a, Dr_total.m1, Dr_total.m2, Dr_total.mL,
+                        Dw_total.a, Dw_total.m1, Dw_total.m2, Dw_total.mL);
+      if (clo_branch_sim)
+         VG_(fprintf)(fp, " %llu %llu %llu %llu",
+                          Bc_total.b, Bc_total.mp,
+                          Bi_total.b, Bi_total.mp);
+      VG_(fprintf)(fp, "\n");
+   }
+   else if (clo_cache_sim && clo_branch_sim) {
       VG_(fprintf)(fp,  "summary:"
                         " %llu %llu %llu"
                         " %llu %llu %llu"
@@ -1593,11 +1736,16 @@ static void cg_fini(Int exitcode)
       miss numbers */
    if (clo_cache_sim) {
       VG_(umsg)(fmt, "I1  misses:   ", Ir_total.m1);
+      if (cachesim_ML)
+         VG_(umsg)(fmt, "MLi misses:   ", Ir_total.m2);
       VG_(umsg)(fmt, "LLi misses:   ", Ir_total.mL);
 
       if (0 == Ir_total.a) Ir_total.a = 1;
       VG_(umsg)("I1  miss rate: %*.2f%%\n", l1,
                 Ir_total.m1 * 100.0 / Ir_total.a);
+      if (cachesim_ML)
+         VG_(umsg)("MLi miss rate: %*.2f%%\n", l1,
+                   Ir_total.m2 * 100.0 / Ir_total.a);
       VG_(umsg)("LLi miss rate: %*.2f%%\n", l1,
                 Ir_total.mL * 100.0 / Ir_total.a);
       VG_(umsg)("\n");
@@ -1606,6 +1754,7 @@ static void cg_fini(Int exitcode)
        * determine the width of columns 2 & 3. */
       D_total.a  = Dr_total.a  + Dw_total.a;
       D_total.m1 = Dr_total.m1 + Dw_total.m1;
+      D_total.m2 = Dr_total.m2 + Dw_total.m2;
       D_total.mL = Dr_total.mL + Dw_total.mL;
 
       /* Make format string, getting width right for numbers */
@@ -1616,6 +1765,9 @@ static void cg_fini(Int exitcode)
                      D_total.a, Dr_total.a, Dw_total.a);
       VG_(umsg)(fmt, "D1  misses:   ",
                      D_total.m1, Dr_total.m1, Dw_total.m1);
+      if (cachesim_ML)
+         VG_(umsg)(fmt, "MLd misses:   ",
+                        D_total.m2, Dr_total.m2, Dw_total.m2);
       VG_(umsg)(fmt, "LLd misses:   ",
                      D_total.mL, Dr_total.mL, Dw_total.mL);
 
@@ -1626,17 +1778,44 @@ static void cg_fini(Int exitcode)
                 l1, D_total.m1  * 100.0 / D_total.a,
                 l2, Dr_total.m1 * 100.0 / Dr_total.a,
                 l3, Dw_total.m1 * 100.0 / Dw_total.a);
+      if (cachesim_ML)
+         VG_(umsg)("MLd miss rate: %*.1f%% (%*.1f%%     + %*.1f%%  )\n",
+                   l1, D_total.m2  * 100.0 / D_total.a,
+                   l2, Dr_total.m2 * 100.0 / Dr_total.a,
+                   l3, Dw_total.m2 * 100.0 / Dw_total.a);
       VG_(umsg)("LLd miss rate: %*.1f%% (%*.1f%%     + %*.1f%%  )\n",
                 l1, D_total.mL  * 100.0 / D_total.a,
                 l2, Dr_total.mL * 100.0 / Dr_total.a,
                 l3, Dw_total.mL * 100.0 / Dw_total.a);
       VG_(umsg)("\n");
 
-      /* LL overall results */
+      /* ML overall results: the ML is referenced on every L1 miss, and
+         the LL on every ML miss. */
 
       LL_total   = Dr_total.m1 + Dw_total.m1 + Ir_total.m1;
       LL_total_r = Dr_total.m1 + Ir_total.m1;
       LL_total_w = Dw_total.m1;
+      if (cachesim_ML) {
+         VG_(umsg)(fmt, "ML refs:      ",
+                        LL_total, LL_total_r, LL_total_w);
+         VG_(umsg)(fmt, "ML misses:    ",
+                        D_total.m2 + Ir_total.m2,
+                        Dr_total.m2 + Ir_total.m2, Dw_total.m2);
+         VG_(umsg)("ML miss rate:  %*.1f%% (%*.1f%%     + %*.1f%%  )\n",
+                   l1, (D_total.m2 + Ir_total.m2) * 100.0
+                          / (Ir_total.a + D_total.a),
+                   l2, (Dr_total.m2 + Ir_total.m2) * 100.0
+                          / (Ir_total.a + Dr_total.a),
+                   l3, Dw_total.m2 * 100.0 / Dw_total.a);
+         VG_(umsg)("\n");
+
+         LL_total   = Dr_total.m2 + Dw_total.m2 + Ir_total.m2;
+         LL_total_r = Dr_total.m2 + Ir_total.m2;
+         LL_total_w = Dw_total.m2;
+      }
+
+      /* LL overall results */
+
       VG_(umsg)(fmt, "LL refs:      ",
                      LL_total, LL_total_r, LL_total_w);
 
@@ -1650,6 +1829,12 @@ static void cg_fini(Int exitcode)
                 l1, LL_total_m  * 100.0 / (Ir_total.a + D_total.a),
                 l2, LL_total_mr * 100.0 / (Ir_total.a + Dr_total.a),
                 l3, LL_total_mw * 100.0 / Dw_total.a);
+
+      if (cachesim_prefetch) {
+         VG_(sprintf)(fmt, "%%s %%,%dllu\n", l1);
+         VG_(umsg)("\n");
+         VG_(umsg)(fmt, "Prefetches:   ", cachesim_n_prefetches);
+      }
    }
 
    /* If branch profiling is enabled, show branch overall results. */
@@ -1731,6 +1916,11 @@ void cg_discard_superblock_info ( Addr orig_addr64, VexGuestExtents vge )
    // use orig_addr, not the first instruction address in vge.
    sbInfo = VG_(OSetGen_Remove)(instrInfoTable, &orig_addr);
    tl_assert(NULL != sbInfo);
+   while (sbInfo->batches) {
+      CacheBatch* b = sbInfo->batches;
+      sbInfo->batches = b->next;
+      VG_(free)(b);
+   }
    VG_(OSetGen_FreeNode)(instrInfoTable, sbInfo);
 }
 
@@ -1738,13 +1928,31 @@ void cg_discard_superblock_info ( Addr orig_addr64, VexGuestExtents vge )
 /*--- Command line processing                                      ---*/
 /*--------------------------------------------------------------------*/
 
+static void parse_cache_policy(const HChar* arg, const HChar* val,
+                               CachePolicy* policy)
+{
+   if      (VG_STREQ(val, "nine"))      *policy = CachePolicyNINE;
+   else if (VG_STREQ(val, "inclusive")) *policy = CachePolicyInclusive;
+   else if (VG_STREQ(val, "exclusive")) *policy = CachePolicyExclusive;
+   else VG_(fmsg_bad_option)(arg,
+           "Expected one of 'nine', 'inclusive' or 'exclusive'\n");
+}
+
 static Bool cg_process_cmd_line_option(const HChar* arg)
 {
+   const HChar* tmp_str;
+
    if (VG_(str_clo_cache_opt)(arg,
                               &clo_I1_cache,
                               &clo_D1_cache,
                               &clo_LL_cache)) {}
 
+   else if (VG_(str_clo_ML_cache_opt)(arg, &clo_ML_cache)) {}
+   else if VG_STR_CLO( arg, "--ML-policy", tmp_str)
+      parse_cache_policy(arg, tmp_str, &clo_ML_policy);
+   else if VG_STR_CLO( arg, "--LL-policy", tmp_str)
+      parse_cache_policy(arg, tmp_str, &clo_LL_policy);
+   else if VG_BOOL_CLO(arg, "--prefetch",   clo_prefetch)   {}
    else if VG_STR_CLO( arg, "--cachegrind-out-file", clo_cachegrind_out_file) {}
    else if VG_BOOL_CLO(arg, "--cache-sim",  clo_cache_sim)  {}
    else if VG_BOOL_CLO(arg, "--branch-sim", clo_branch_sim) {}
@@ -1758,6 +1966,10 @@ static void cg_print_usage(void)
 {
    VG_(print_cache_clo_opts)();
    VG_(printf)(
+"    --ML=<size>,<assoc>,<line_size>  also simulate a mid-level cache\n"
+"    --ML-policy=nine|inclusive|exclusive  ML inclusion policy [nine]\n"
+"    --LL-policy=nine|inclusive|exclusive  LL inclusion policy [nine]\n"
+"    --prefetch=no|yes   [no]         simulate a stride prefetcher?\n"
 "    --cache-sim=yes|no  [yes]        collect cache stats?\n"
 "    --branch-sim=yes|no [no]         collect branch prediction stats?\n"
 "    --cachegrind-out-file=<file>     output file name [cachegrind.out.%%p]\n"
@@ -1831,6 +2043,9 @@ static void cg_post_clo_init(void)
    // cache lines at any cache level
    min_line_size = (I1c.line_size < D1c.line_size) ? I1c.line_size : D1c.line_size;
    min_line_size = (LLc.line_size < min_line_size) ? LLc.line_size : min_line_size;
+   if (clo_ML_cache.size > 0
+       && clo_ML_cache.line_size < min_line_size)
+      min_line_size = clo_ML_cache.line_size;
 
    Int largest_load_or_store_size
       = VG_(machine_get_size_of_largest_guest_register)();
@@ -1846,7 +2061,20 @@ static void cg_post_clo_init(void)
       VG_(exit)(1);
    }
 
-   cachesim_initcaches(I1c, D1c, LLc);
+   if (clo_ML_cache.size <= 0
+       && clo_ML_policy != CachePolicyNINE) {
+      VG_(fmsg_bad_option)("--ML-policy", "--ML-policy requires --ML=...\n");
+   }
+   if (VG_(clo_verbosity) > 1 && clo_ML_cache.size > 0) {
+      VG_(umsg)("Cache configuration used:\n");
+      VG_(umsg)("  ML: %'d B, %d-way, %d B lines\n", clo_ML_cache.size,
+                clo_ML_cache.assoc, clo_ML_cache.line_size);
+   }
+
+   cachesim_initcaches(I1c, D1c, LLc,
+                       clo_ML_cache.size <= 0
+                          ? NULL : &clo_ML_cache,
+                       clo_ML_policy, clo_LL_policy, clo_prefetch);
 }
 
 VG_DETERMINE_INTERFACE_VERSION(cg_pre_clo_init)
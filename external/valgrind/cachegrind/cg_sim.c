@@ -166,18 +166,285 @@ Bool cachesim_ref_is_miss(cache_t2* c, Addr a, UChar size)
 static cache_t2 LL;
 static cache_t2 I1;
 static cache_t2 D1;
+static cache_t2 ML;
+
+/*------------------------------------------------------------*/
+/*--- Extended hierarchy                                   ---*/
+/*------------------------------------------------------------*/
+
+/* By default the simulated hierarchy is I1/D1 backed by LL, each
+   level allocating on a miss and never invalidating anything in the
+   others (neither inclusive nor exclusive).  Optionally, a unified
+   mid-level cache (ML) can be put between L1 and LL, each of ML and
+   LL can be made inclusive or exclusive, and a stride prefetcher can
+   fill the first level below D1.  Any of those makes cachesim_ext
+   True and sends all references through cachesim_ext_ref(); the
+   plain two-level code further down is left untouched for speed.
+
+   An exclusive level only receives lines evicted from the level above
+   it, and gives a line up when the level above takes it.  An
+   inclusive level invalidates a line in all the levels above it when
+   it evicts it. */
+
+typedef
+   enum { CachePolicyNINE, CachePolicyInclusive, CachePolicyExclusive }
+   CachePolicy;
+
+static Bool cachesim_ext      = False;
+static Bool cachesim_ML       = False;
+static Bool cachesim_prefetch = False;
+
+/* The levels below L1, outermost last: ML (if simulated), then LL. */
+static cache_t2*   lower[2];
+static CachePolicy lower_policy[2];
+static Int         n_lower = 0;
+
+static ULong cachesim_n_prefetches = 0;
+
+/* As cachesim_setref_is_miss, but the set is computed from the block,
+   and on a miss the evicted block is returned in *victim (0 if the
+   way was empty). */
+static Bool cachesim_setref_evict(cache_t2* c, UWord block, UWord* victim)
+{
+   Int    i, j;
+   UWord* set = &(c->tags[(block & c->sets_min_1) * c->assoc]);
+
+   if (block == set[0])
+      return False;
+   for (i = 1; i < c->assoc; i++) {
+      if (block == set[i]) {
+         for (j = i; j > 0; j--)
+            set[j] = set[j - 1];
+         set[0] = block;
+         return False;
+      }
+   }
+   *victim = set[c->assoc - 1];
+   for (j = c->assoc - 1; j > 0; j--)
+      set[j] = set[j - 1];
+   set[0] = block;
+   return True;
+}
+
+/* Removes block from c, returning True if it was present. */
+static Bool cachesim_remove(cache_t2* c, UWord block)
+{
+   Int    i, j;
+   UWord* set = &(c->tags[(block & c->sets_min_1) * c->assoc]);
+
+   for (i = 0; i < c->assoc; i++) {
+      if (block == set[i]) {
+         for (j = i; j < c->assoc - 1; j++)
+            set[j] = set[j + 1];
+         set[c->assoc - 1] = 0;
+         return True;
+      }
+   }
+   return False;
+}
+
+static Bool cachesim_contains(cache_t2* c, UWord block)
+{
+   Int    i;
+   UWord* set = &(c->tags[(block & c->sets_min_1) * c->assoc]);
+
+   for (i = 0; i < c->assoc; i++)
+      if (block == set[i])
+         return True;
+   return False;
+}
+
+/* Removes the line of size szB at a from cache c, which may have
+   smaller lines. */
+static void cachesim_invalidate(cache_t2* c, Addr a, Int szB)
+{
+   Addr b;
+   for (b = a; b < a + szB; b += c->line_size)
+      cachesim_remove(c, b >> c->line_size_bits);
+}
+
+/* Lower level k has evicted the line at a.  If k is inclusive, the
+   line must go from every level above it. */
+static void lower_evicted(Int k, Addr a)
+{
+   Int j;
+   if (lower_policy[k] != CachePolicyInclusive)
+      return;
+   cachesim_invalidate(&I1, a, lower[k]->line_size);
+   cachesim_invalidate(&D1, a, lower[k]->line_size);
+   for (j = 0; j < k; j++)
+      cachesim_invalidate(lower[j], a, lower[k]->line_size);
+}
+
+static void lower_insert(Int k, Addr a);
+
+/* The line at a has been evicted from the level above lower level k.
+   Only an exclusive level takes it. */
+static void lower_victim(Int k, Addr a)
+{
+   if (k < n_lower && lower_policy[k] == CachePolicyExclusive)
+      lower_insert(k, a);
+}
+
+/* Installs the line at a in lower level k. */
+static void lower_insert(Int k, Addr a)
+{
+   cache_t2* c      = lower[k];
+   UWord     victim = 0;
 
-static void cachesim_initcaches(cache_t I1c, cache_t D1c, cache_t LLc)
+   if (cachesim_setref_evict(c, a >> c->line_size_bits, &victim)
+       && victim != 0) {
+      lower_evicted(k, victim << c->line_size_bits);
+      lower_victim(k + 1, victim << c->line_size_bits);
+   }
+}
+
+/* Lower level k is asked for the line at a after the level above it
+   missed; miss[k] is set if it misses too.  A prefetch brings the
+   line into lower level 0 without it being a demand reference. */
+static void lower_ref(Int k, Addr a, Bool* miss, Bool is_prefetch)
+{
+   cache_t2* c;
+   UWord     block, victim = 0;
+
+   if (k >= n_lower)
+      return;
+   c     = lower[k];
+   block = a >> c->line_size_bits;
+
+   if (lower_policy[k] == CachePolicyExclusive) {
+      if (is_prefetch && k == 0) {
+         if (cachesim_contains(c, block))
+            return;
+         lower_ref(k + 1, a, miss, is_prefetch);
+         lower_insert(k, a);
+         return;
+      }
+      /* A hit moves the line up, out of this level. */
+      if (cachesim_remove(c, block))
+         return;
+      miss[k] = True;
+      lower_ref(k + 1, a, miss, is_prefetch);
+      return;
+   }
+
+   if (!cachesim_setref_evict(c, block, &victim))
+      return;
+   miss[k] = True;
+   lower_ref(k + 1, a, miss, is_prefetch);
+   if (victim != 0) {
+      lower_evicted(k, victim << c->line_size_bits);
+      lower_victim(k + 1, victim << c->line_size_bits);
+   }
+}
+
+/* A reference-prediction-table stride prefetcher, trained on D1
+   misses.  Once the same instruction has missed twice in a row with
+   the same stride, the line PF_DISTANCE strides ahead is brought into
+   the level below D1. */
+#define PF_TABLE_SIZE 256
+#define PF_DISTANCE   4
+
+typedef
+   struct {
+      Addr pc;
+      Addr last;
+      Long stride;
+   }
+   PF_Entry;
+
+static PF_Entry pf_table[PF_TABLE_SIZE];
+
+static void prefetch_train(Addr pc, Addr a)
+{
+   PF_Entry* e = &pf_table[(pc ^ (pc >> 8)) % PF_TABLE_SIZE];
+   Bool      miss[2];
+   Long      stride;
+
+   if (e->pc != pc) {
+      e->pc     = pc;
+      e->last   = a;
+      e->stride = 0;
+      return;
+   }
+   stride  = (Long)(a - e->last);
+   e->last = a;
+   if (stride == 0 || stride != e->stride) {
+      e->stride = stride;
+      return;
+   }
+   cachesim_n_prefetches++;
+   lower_ref(0, a + PF_DISTANCE * stride, miss, True /*is_prefetch*/);
+}
+
+/* Simulates a reference to [a, a+size) through L1 cache l1 and the
+   levels below it.  As in the plain model, a reference touching two
+   lines counts as at most one miss per level.  pc is only used by the
+   prefetcher, for data references. */
+static void cachesim_ext_ref(cache_t2* l1, Addr a, UChar size,
+                             Bool is_data, Addr pc,
+                             ULong* m1, ULong* m2, ULong* mL)
+{
+   Bool  miss1   = False;
+   Bool  miss[2] = { False, False };
+   UWord block1  =  a         >> l1->line_size_bits;
+   UWord block2  = (a+size-1) >> l1->line_size_bits;
+   UWord b, victim;
+
+   for (b = block1; b <= block2; b++) {
+      victim = 0;
+      if (!cachesim_setref_evict(l1, b, &victim))
+         continue;
+      miss1 = True;
+      lower_ref(0, b << l1->line_size_bits, miss, False);
+      if (victim != 0)
+         lower_victim(0, victim << l1->line_size_bits);
+      if (is_data && cachesim_prefetch)
+         prefetch_train(pc, b << l1->line_size_bits);
+   }
+
+   if (miss1) {
+      (*m1)++;
+      if (cachesim_ML && miss[0])
+         (*m2)++;
+      if (miss[n_lower - 1])
+         (*mL)++;
+   }
+}
+
+static void cachesim_initcaches(cache_t I1c, cache_t D1c, cache_t LLc,
+                                cache_t* MLc, CachePolicy ML_policy,
+                                CachePolicy LL_policy, Bool prefetch)
 {
    cachesim_initcache(I1c, &I1);
    cachesim_initcache(D1c, &D1);
    cachesim_initcache(LLc, &LL);
+
+   n_lower = 0;
+   if (MLc) {
+      cachesim_initcache(*MLc, &ML);
+      cachesim_ML = True;
+      lower_policy[n_lower] = ML_policy;
+      lower[n_lower++] = &ML;
+   }
+   lower_policy[n_lower] = LL_policy;
+   lower[n_lower++] = &LL;
+
+   cachesim_prefetch = prefetch;
+   cachesim_ext = cachesim_ML || prefetch
+                  || ML_policy != CachePolicyNINE
+                  || LL_policy != CachePolicyNINE;
 }
 
 __attribute__((always_inline))
 static __inline__
-void cachesim_I1_doref_Gen(Addr a, UChar size, ULong* m1, ULong *mL)
+void cachesim_I1_doref_Gen(Addr a, UChar size,
+                           ULong* m1, ULong* m2, ULong *mL)
 {
+   if (UNLIKELY(cachesim_ext)) {
+      cachesim_ext_ref(&I1, a, size, False, 0, m1, m2, mL);
+      return;
+   }
    if (cachesim_ref_is_miss(&I1, a, size)) {
       (*m1)++;
       if (cachesim_ref_is_miss(&LL, a, size))
@@ -188,11 +455,16 @@ void cachesim_I1_doref_Gen(Addr a, UChar size, ULong* m1, ULong *mL)
 // common special case IrNoX
 __attribute__((always_inline))
 static __inline__
-void cachesim_I1_doref_NoX(Addr a, UChar size, ULong* m1, ULong *mL)
+void cachesim_I1_doref_NoX(Addr a, UChar size,
+                           ULong* m1, ULong* m2, ULong *mL)
 {
    UWord block  = a >> I1.line_size_bits;
    UInt  I1_set = block & I1.sets_min_1;
 
+   if (UNLIKELY(cachesim_ext)) {
+      cachesim_ext_ref(&I1, a, size, False, 0, m1, m2, mL);
+      return;
+   }
    // use block as tag
    if (cachesim_setref_is_miss(&I1, I1_set, block)) {
       UInt  LL_set = block & LL.sets_min_1;
@@ -205,8 +477,13 @@ void cachesim_I1_doref_NoX(Addr a, UChar size, ULong* m1, ULong *mL)
 
 __attribute__((always_inline))
 static __inline__
-void cachesim_D1_doref(Addr a, UChar size, ULong* m1, ULong *mL)
+void cachesim_D1_doref(Addr a, UChar size, Addr pc,
+                       ULong* m1, ULong* m2, ULong *mL)
 {
+   if (UNLIKELY(cachesim_ext)) {
+      cachesim_ext_ref(&D1, a, size, True, pc, m1, m2, mL);
+      return;
+   }
    if (cachesim_ref_is_miss(&D1, a, size)) {
       (*m1)++;
       if (cachesim_ref_is_miss(&LL, a, size))
@@ -0,0 +1,29 @@
+// Walks a 384 KB buffer one 64 B line at a time, four times, so that
+// the misses of walk() in the hierarchy.*.vgtest runs can be predicted.
+// With 32 KB D1 and 256 KB ML every D1 and ML reference to buf misses
+// on every pass.  A 256 KB LL misses every time as well when it is
+// inclusive, but only on the first pass when it is exclusive, since
+// ML and LL together hold the whole buffer.  With the prefetcher
+// nearly all of the ML misses go away.
+
+#define LINE    64
+#define N_LINES 6144
+#define PASSES  4
+
+static char buf[N_LINES * LINE];
+
+__attribute__((noinline))
+static int walk(void)
+{
+   int p, i, sum = 0;
+
+   for (p = 0; p < PASSES; p++)
+      for (i = 0; i < N_LINES; i++)
+         sum += buf[i * LINE];
+   return sum;
+}
+
+int main(void)
+{
+   return walk();
+}
@@ -533,6 +533,84 @@ void fprint_cost(VgFile *fp, const EventMapping* es, const ULong* cost)
 
 
 
+/* With --dump-format=binary, each "<positions> <costs>" line of the
+ * text format is written as a record
+ *
+ *   0x01 <position deltas> <n> <cost 1> ... <cost n> '\n'
+ *
+ * Position deltas are zig-zag encoded differences to the positions of
+ * the previous record, and <n> is the number of event values following,
+ * with trailing zero values dropped. Numbers use a variable length
+ * encoding: bytes with the top bit set carry 7 bits each, most
+ * significant first, and a final byte in 0x40..0x7f carries the lowest
+ * 6 bits. As neither '\n' nor '\0' can occur inside of a record, the
+ * file stays line oriented and records can be written via VG_(fprintf).
+ */
+#define BIN_RECORD_MARKER 0x01
+
+static HChar*  bin_buf = 0;
+static Int     bin_buf_size = 0;
+static AddrPos bin_last;
+
+static HChar* bin_put_num(HChar* b, ULong v)
+{
+    HChar tmp[10];
+    Int n = 0;
+
+    tmp[n++] = 0x40 | (v & 0x3f);
+    v >>= 6;
+    while(v) {
+	tmp[n++] = 0x80 | (v & 0x7f);
+	v >>= 7;
+    }
+    while(n>0) *b++ = tmp[--n];
+
+    return b;
+}
+
+static HChar* bin_put_delta(HChar* b, Long diff)
+{
+    return bin_put_num(b, ((ULong)diff << 1) ^ (ULong)(diff >> 63));
+}
+
+static
+void fprint_bin_record(VgFile *fp, const AddrPos* curr,
+		       const EventMapping* em, const ULong* cost)
+{
+    HChar* b;
+    Int i, n;
+
+    /* marker, 3 positions, count and events, 10 bytes max. each */
+    if (bin_buf_size < 1 + (4 + em->size) * 10 + 2) {
+	if (bin_buf) CLG_FREE(bin_buf);
+	bin_buf_size = 1 + (4 + em->size) * 10 + 2;
+	bin_buf = (HChar*) CLG_MALLOC("cl.dump.fbr.1", bin_buf_size);
+    }
+
+    b = bin_buf;
+    *b++ = BIN_RECORD_MARKER;
+    if (CLG_(clo).dump_instr)
+	b = bin_put_delta(b, (Long)(curr->addr - bin_last.addr));
+    if (CLG_(clo).dump_bb)
+	b = bin_put_delta(b, (Long)(curr->bb_addr - bin_last.bb_addr));
+    if (CLG_(clo).dump_line)
+	b = bin_put_delta(b, (Long)curr->line - (Long)bin_last.line);
+    bin_last.addr    = curr->addr;
+    bin_last.bb_addr = curr->bb_addr;
+    bin_last.line    = curr->line;
+
+    n = em->size;
+    while(n>0 && cost[em->entry[n-1].offset] == 0) n--;
+    b = bin_put_num(b, n);
+    for(i=0; i<n; i++)
+	b = bin_put_num(b, cost[em->entry[i].offset]);
+    *b++ = '\n';
+    *b = 0;
+
+    VG_(fprintf)(fp, "%s", bin_buf);
+}
+
+
 /* Write the cost of a source line; only that parts of the source
  * position are written that changed relative to last written position.
  * funcPos is the source position of the first line of actual function.
@@ -546,11 +624,14 @@ static void fprint_fcost(VgFile *fp, AddrCost* c, AddrPos* last)
     CLG_(print_cost)(-5, CLG_(sets).full, c->cost);
   }
     
-  fprint_pos(fp, &(c->p), last);
+  if (CLG_(clo).binary_dump)
+    fprint_bin_record(fp, &(c->p), CLG_(dumpmap), c->cost);
+  else {
+    fprint_pos(fp, &(c->p), last);
+    fprint_cost(fp, CLG_(dumpmap), c->cost);
+  }
   copy_apos( last, &(c->p) ); /* update last to current position */
 
-  fprint_cost(fp, CLG_(dumpmap), c->cost);
-
   /* add cost to total */
   CLG_(add_and_zero_cost)( CLG_(sets).full, dump_total_cost, c->cost );
 }
@@ -654,8 +735,12 @@ static void fprint_jcc(VgFile *fp, jCC* jcc, AddrPos* curr, AddrPos* last,
 
 	fprint_pos(fp, &target, last);
         VG_(fprintf)(fp, "\n");
-	fprint_pos(fp, curr, last);
-	fprint_cost(fp, CLG_(dumpmap), jcc->cost);
+	if (CLG_(clo).binary_dump)
+	    fprint_bin_record(fp, curr, CLG_(dumpmap), jcc->cost);
+	else {
+	    fprint_pos(fp, curr, last);
+	    fprint_cost(fp, CLG_(dumpmap), jcc->cost);
+	}
 
 	CLG_(init_cost)( CLG_(sets).full, jcc->cost );
 
@@ -1213,6 +1298,9 @@ static VgFile *new_dumpfile(int tid, const HChar* trigger)
     if (!appending)
 	reset_dump_array();
 
+    /* binary records of each part start from position zero */
+    init_apos(&bin_last, 0, 0, 0);
+
 
     if (!appending) {
 	/* version */
@@ -1226,6 +1314,9 @@ static VgFile *new_dumpfile(int tid, const HChar* trigger)
 
 	/* "cmd:" line */
 	VG_(fprintf)(fp, "cmd: %s", cmdbuf);
+
+	if (CLG_(clo).binary_dump)
+	    VG_(fprintf)(fp, "\nformat: binary");
     }
 
     VG_(fprintf)(fp, "\npart: %d\n", out_counter);
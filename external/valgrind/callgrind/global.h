@@ -81,6 +81,7 @@ struct _CommandLineOptions {
   Bool compress_strings;
   Bool compress_events;
   Bool compress_pos;
+  Bool binary_dump;      /* Write cost lines as varint records? */
   Bool mangle_names;
   Bool compress_mangled;
   Bool dump_line;
@@ -2006,6 +2006,16 @@ void CLG_(post_clo_init)(void)
        CLG_(clo).dump_line = True;
    }
 
+   if (CLG_(clo).binary_dump && !CLG_(clo).compress_strings) {
+       VG_(message)(Vg_UserMsg,
+                    "--dump-format=binary implies --compress-strings=yes\n");
+       CLG_(clo).compress_strings = True;
+   }
+   /* binary records carry their own position deltas; positions
+    * remaining in text lines (call/jump targets) are kept absolute */
+   if (CLG_(clo).binary_dump)
+       CLG_(clo).compress_pos = False;
+
    CLG_(init_dumps)();
 
    (*CLG_(cachesim).post_clo_init)();
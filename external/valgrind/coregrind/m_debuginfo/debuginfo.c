@@ -56,6 +56,7 @@
 #include "priv_tytypes.h"
 #include "priv_storage.h"
 #include "priv_readdwarf.h"
+#include "priv_lazy.h"
 #if defined(VGO_linux)
 # include "priv_readelf.h"
 # include "priv_readdwarf3.h"
@@ -216,6 +217,8 @@ static void free_DebugInfo ( DebugInfo* di )
    if (di->fsm.filename) ML_(dinfo_free)(di->fsm.filename);
    if (di->fsm.dbgname)  ML_(dinfo_free)(di->fsm.dbgname);
    if (di->soname)       ML_(dinfo_free)(di->soname);
+   if (di->buildid)      ML_(dinfo_free)(di->buildid);
+   if (di->deferred)     ML_(free_deferred)(di);
    if (di->loctab)       ML_(dinfo_free)(di->loctab);
    if (di->loctab_fndn_ix) ML_(dinfo_free)(di->loctab_fndn_ix);
    if (di->inltab)       ML_(dinfo_free)(di->inltab);
@@ -1577,6 +1580,8 @@ InlIPCursor* VG_(new_IIPC)(Addr eip)
 
    /* Search the DebugInfo for eip */
    search_all_loctabs ( eip, &di, &locno );
+   if (di != NULL && di->deferred)
+      ML_(lazy_load_d3) ( di );
    if (di == NULL || di->inltab_used == 0)
       return NULL; // No di (with inltab) containing eip.
 
@@ -1712,6 +1717,8 @@ static void search_all_loctabs ( Addr ptr, /*OUT*/DebugInfo** pdi,
           && di->text_size > 0
           && di->text_avma <= ptr 
           && ptr < di->text_avma + di->text_size) {
+         if (di->deferred)
+            ML_(lazy_load_lines_at) ( di, ptr );
          lno = ML_(search_one_loctab) ( di, ptr );
          if (lno == -1) goto not_found;
          *locno = lno;
@@ -3531,6 +3538,9 @@ Bool consider_vars_in_frame ( /*MOD*/XArray* /* of HChar */ dname1,
    }
    /* End of performance-enhancing hack. */
 
+   if (di->deferred)
+      ML_(lazy_load_d3) ( di );
+
    /* any var info at all? */
    if (!di->varinfo)
       return False;
@@ -3652,6 +3662,8 @@ Bool VG_(get_data_description)(
       /* text segment missing? unlikely, but handle it .. */
       if (!di->text_present || di->text_size == 0)
          continue;
+      if (di->deferred)
+         ML_(lazy_load_d3) ( di );
       /* any var info at all? */
       if (!di->varinfo)
          continue;
@@ -3978,6 +3990,9 @@ void* /* really, XArray* of StackBlock */
    }
    /* End of performance-enhancing hack. */
 
+   if (di->deferred)
+      ML_(lazy_load_d3) ( di );
+
    /* any var info at all? */
    if (!di->varinfo)
       return res; /* currently empty */
@@ -4071,6 +4086,9 @@ void* /* really, XArray* of GlobalBlock */
    gvars = VG_(newXA)( ML_(dinfo_zalloc), "di.debuginfo.dggbfd.1",
                        ML_(dinfo_free), sizeof(GlobalBlock) );
 
+   if (di->deferred)
+      ML_(lazy_load_d3) ( di );
+
    /* any var info at all? */
    if (!di->varinfo)
       return gvars;
@@ -4245,6 +4263,11 @@ const HChar* VG_(DebugInfo_get_filename)(const DebugInfo* di)
    return di->fsm.filename;
 }
 
+const HChar* VG_(DebugInfo_get_buildid)(const DebugInfo* di)
+{
+   return di->buildid;
+}
+
 PtrdiffT VG_(DebugInfo_get_text_bias)(const DebugInfo* di)
 {
    return di->text_present ? di->text_bias : 0;
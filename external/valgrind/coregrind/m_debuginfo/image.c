@@ -69,9 +69,14 @@ typedef
       Bool  is_local;
       // The fd for the local file, or sd for a remote server.
       Int   fd;
-      // The name.  In ML_(dinfo_zalloc)'d space.  Used only for printing
-      // error messages; hence it doesn't really matter what this contains.
+      // The name.  In ML_(dinfo_zalloc)'d space.  For local files this
+      // is the path the file was opened with, and is used to reopen it
+      // after ML_(img_suspend).  Otherwise only used for printing
+      // error messages.
       HChar* name;
+      // The modification time of a local file when first opened.  Used
+      // by ML_(img_resume) to check that the file hasn't changed.
+      ULong mtime;
       // The rest of these fields are only valid when using remote files
       // (that is, using a debuginfo server; hence when is_local==False)
       // Session ID allocated to us by the server.  Cannot be zero.
@@ -480,6 +485,7 @@ static void set_CEnt ( const DiImage* img, UInt entNo, DiOffT off )
 
    if (img->source.is_local) {
       // Simple: just read it
+      vg_assert(img->source.fd >= 0); /* not suspended */
       SysRes sr = VG_(pread)(img->source.fd, &ce->data[0], (Int)len, off);
       vg_assert(!sr_isError(sr));
    } else {
@@ -635,6 +641,7 @@ DiImage* ML_(img_from_local_file)(const HChar* fullpath)
    img->size            = size;
    img->ces_used        = 0;
    img->source.name     = ML_(dinfo_strdup)("di.image.ML_iflf.2", fullpath);
+   img->source.mtime    = stat_buf.mtime;
    /* img->ces is already zeroed out */
    vg_assert(img->source.fd >= 0);
 
@@ -762,7 +769,8 @@ void ML_(img_done)(DiImage* img)
    if (img->source.is_local) {
       /* Close the file; nothing else to do. */
       vg_assert(img->source.session_id == 0);
-      VG_(close)(img->source.fd);
+      if (img->source.fd >= 0)
+         VG_(close)(img->source.fd);
    } else {
       /* Close the socket.  The server can detect this and will scrub
          the connection when it happens, so there's no need to tell it
@@ -785,6 +793,51 @@ void ML_(img_done)(DiImage* img)
    ML_(dinfo_free)(img);
 }
 
+Bool ML_(img_is_local)(const DiImage* img)
+{
+   vg_assert(img);
+   return img->source.is_local;
+}
+
+void ML_(img_suspend)(DiImage* img)
+{
+   UInt i;
+   vg_assert(img);
+   vg_assert(img->source.is_local);
+   vg_assert(img->source.fd >= 0);
+   VG_(close)(img->source.fd);
+   img->source.fd = -1;
+   /* Keep the zeroth entry, so that get() can still assume ces[0] is
+      non-NULL, but give back the rest. */
+   vg_assert(img->ces_used >= 1);
+   for (i = 1; i < img->ces_used; i++) {
+      ML_(dinfo_free)(img->ces[i]);
+      img->ces[i] = NULL;
+   }
+   img->ces_used = 1;
+}
+
+Bool ML_(img_resume)(DiImage* img)
+{
+   SysRes         fd;
+   struct vg_stat stat_buf;
+
+   vg_assert(img);
+   vg_assert(img->source.is_local);
+   vg_assert(img->source.fd == -1);
+   fd = VG_(open)(img->source.name, VKI_O_RDONLY, 0);
+   if (sr_isError(fd))
+      return False;
+   if (VG_(fstat)(sr_Res(fd), &stat_buf) != 0
+       || stat_buf.size != img->size
+       || stat_buf.mtime != img->source.mtime) {
+      VG_(close)(sr_Res(fd));
+      return False;
+   }
+   img->source.fd = sr_Res(fd);
+   return True;
+}
+
 DiOffT ML_(img_size)(const DiImage* img)
 {
    vg_assert(img);
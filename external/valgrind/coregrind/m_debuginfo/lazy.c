@@ -0,0 +1,875 @@
+/* -*- mode: C; c-basic-offset: 3; -*- */
+
+/*--------------------------------------------------------------------*/
+/*--- Deferred and cached reading of DWARF info.           lazy.c ---*/
+/*--------------------------------------------------------------------*/
+
+/*
+   This file is part of Valgrind, a dynamic binary instrumentation
+   framework.
+
+   Copyright (C) 2000-2013 Julian Seward
+      jseward@acm.org
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2 of the
+   License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+   02111-1307, USA.
+
+   The GNU General Public License is contained in the file COPYING.
+*/
+
+#if defined(VGO_linux) || defined(VGO_darwin)
+
+#include "pub_core_basics.h"
+#include "pub_core_vki.h"
+#include "pub_core_debuginfo.h"
+#include "pub_core_libcbase.h"
+#include "pub_core_libcassert.h"
+#include "pub_core_libcfile.h"
+#include "pub_core_libcprint.h"
+#include "pub_core_libcproc.h"     /* VG_(getpid) */
+#include "pub_core_options.h"
+#include "pub_core_xarray.h"
+#include "pub_core_deduppoolalloc.h"
+#include "priv_misc.h"             /* dinfo_zalloc/free/strdup */
+#include "priv_image.h"
+#include "priv_d3basics.h"
+#include "priv_tytypes.h"
+#include "priv_storage.h"
+#include "priv_readdwarf.h"
+#include "priv_readdwarf3.h"
+#include "priv_lazy.h"             /* self */
+
+/* With --lazy-debuginfo=yes (the default), ML_(read_elf_debug_info)
+   doesn't read .debug_line, or the DIEs in .debug_info, when an object
+   is mapped.  Instead ML_(read_dwarf3_info) indexes .debug_aranges
+   and keeps the images the DWARF lives in, suspended so as not to tie
+   up file descriptors, for later.
+
+   The line table for a compilation unit is read the first time an
+   address in one of its ranges is looked up.  Units which
+   .debug_aranges doesn't mention at all are read straight away, since
+   there is no other way to know which addresses they cover; so for
+   objects without .debug_aranges this is the same as before.
+
+   The DIE reader (variables and inlined calls) doesn't lend itself to
+   running a unit at a time -- units refer to each other's types, and
+   its results are merged per object -- so it is run for the whole
+   object the first time variable or inline info is wanted for any
+   address in it.
+
+   With --debuginfo-cache-dir=<dir>, the line table (and, when
+   variable info isn't wanted, the inlined call table) of an object
+   with a build-id is written to <dir> after being read in full, and
+   later runs load it from there instead of reading any DWARF.  Files
+   are named by the build-id and the object's inode, size and mtime,
+   so that an object replaced or rebuilt without a new build-id is
+   not matched with a stale entry.  Objects without a build-id are
+   never cached. */
+
+
+/*------------------------------------------------------------*/
+/*--- The deferred state                                   ---*/
+/*------------------------------------------------------------*/
+
+typedef
+   struct {
+      ULong cu_off;    /* offset of the unit header in .debug_info */
+      Bool  loaded;    /* line info read yet? */
+   }
+   DiLazyUnit;
+
+typedef
+   struct {
+      Addr  aMin;
+      Addr  aMax;
+      Addr  aMaxSoFar; /* max of aMax over this and all earlier ranges */
+      UWord unit;      /* index in DiDeferred.units */
+   }
+   DiLazyRange;
+
+struct _DiDeferred {
+   /* The images the sections live in, all suspended between loads. */
+   DiImage*        imgs[3];
+   DiDwarfSections secs;
+   /* Units, in .debug_info order, and the ranges they cover, sorted
+      by aMin.  NULL once all line info has been read. */
+   XArray*         units;    /* of DiLazyUnit */
+   XArray*         ranges;   /* of DiLazyRange */
+   UWord           n_units_left;
+   /* Has the DIE reader still to be run? */
+   Bool            d3_pending;
+};
+
+static Bool resume_images ( DiDeferred* dd )
+{
+   Int i, j;
+   for (i = 0; i < 3; i++) {
+      if (dd->imgs[i] && !ML_(img_resume)(dd->imgs[i])) {
+         for (j = 0; j < i; j++)
+            if (dd->imgs[j])
+               ML_(img_suspend)(dd->imgs[j]);
+         return False;
+      }
+   }
+   return True;
+}
+
+static void suspend_images ( DiDeferred* dd )
+{
+   Int i;
+   for (i = 0; i < 3; i++)
+      if (dd->imgs[i])
+         ML_(img_suspend)(dd->imgs[i]);
+}
+
+void ML_(free_deferred) ( struct _DebugInfo* di )
+{
+   DiDeferred* dd = di->deferred;
+   Int i;
+   if (dd == NULL)
+      return;
+   for (i = 0; i < 3; i++)
+      if (dd->imgs[i])
+         ML_(img_done)(dd->imgs[i]);
+   if (dd->units)
+      VG_(deleteXA)(dd->units);
+   if (dd->ranges)
+      VG_(deleteXA)(dd->ranges);
+   ML_(dinfo_free)(dd);
+   di->deferred = NULL;
+}
+
+/* Drop the deferred state once nothing more can come of it, and
+   bring the tables back into canonical form after a load. */
+static void finish_load ( struct _DebugInfo* di )
+{
+   DiDeferred* dd = di->deferred;
+   if (dd->n_units_left == 0 && dd->units) {
+      VG_(deleteXA)(dd->units);
+      VG_(deleteXA)(dd->ranges);
+      dd->units  = NULL;
+      dd->ranges = NULL;
+   }
+   if (dd->n_units_left == 0 && !dd->d3_pending)
+      ML_(free_deferred)(di);
+   ML_(canonicaliseDeferredTables)(di);
+}
+
+/* The object has changed (or vanished) underneath us.  Forget
+   whatever is still deferred rather than read garbage. */
+static void give_up ( struct _DebugInfo* di )
+{
+   DiDeferred* dd = di->deferred;
+   ML_(symerr)(di, True, "object file changed since it was mapped; "
+                         "ignoring its remaining debug info");
+   dd->n_units_left = 0;
+   dd->d3_pending   = False;
+}
+
+static void load_unit ( struct _DebugInfo* di, DiLazyUnit* u )
+{
+   DiDeferred* dd = di->deferred;
+   vg_assert(!u->loaded);
+   ML_(read_debuginfo_dwarf3_unit)( di, dd->secs.info, dd->secs.abbv,
+                                    dd->secs.line, dd->secs.str,
+                                    dd->secs.str_alt, u->cu_off );
+   u->loaded = True;
+   vg_assert(dd->n_units_left > 0);
+   dd->n_units_left--;
+}
+
+void ML_(lazy_load_lines_at) ( struct _DebugInfo* di, Addr a )
+{
+   DiDeferred* dd = di->deferred;
+   Word lo, hi, mid, j, n;
+   Bool resumed = False;
+
+   vg_assert(dd);
+   if (dd->n_units_left == 0)
+      return;
+
+   /* Find the last range starting at or below a ... */
+   n  = VG_(sizeXA)(dd->ranges);
+   lo = 0;
+   hi = n - 1;
+   while (lo <= hi) {
+      mid = (lo + hi) / 2;
+      if (((DiLazyRange*)VG_(indexXA)(dd->ranges, mid))->aMin <= a)
+         lo = mid + 1;
+      else
+         hi = mid - 1;
+   }
+   /* ... and walk back over every range that might contain a. */
+   for (j = hi; j >= 0; j--) {
+      DiLazyRange* r = VG_(indexXA)(dd->ranges, j);
+      if (r->aMaxSoFar < a)
+         break;
+      if (r->aMax < a)
+         continue;
+      DiLazyUnit* u = VG_(indexXA)(dd->units, r->unit);
+      if (u->loaded)
+         continue;
+      if (!resumed) {
+         if (!resume_images(dd)) {
+            give_up(di);
+            break;
+         }
+         resumed = True;
+      }
+      load_unit(di, u);
+   }
+   if (resumed)
+      suspend_images(dd);
+   if (resumed || dd->n_units_left == 0)
+      finish_load(di);
+}
+
+static void read_d3 ( struct _DebugInfo* di, const DiDwarfSections* s )
+{
+   ML_(new_dwarf3_reader)( di, s->info,     s->types,
+                               s->abbv,     s->line,
+                               s->str,      s->ranges,
+                               s->loc,      s->info_alt,
+                               s->abbv_alt, s->line_alt,
+                               s->str_alt );
+}
+
+void ML_(lazy_load_d3) ( struct _DebugInfo* di )
+{
+   DiDeferred* dd = di->deferred;
+   vg_assert(dd);
+   if (!dd->d3_pending)
+      return;
+   if (!resume_images(dd)) {
+      give_up(di);
+   } else {
+      read_d3(di, &dd->secs);
+      dd->d3_pending = False;
+      suspend_images(dd);
+   }
+   finish_load(di);
+}
+
+
+/*------------------------------------------------------------*/
+/*--- The on-disk cache                                    ---*/
+/*------------------------------------------------------------*/
+
+/* File layout: a DCHeader, then n_fndn filename/dirname pairs (each
+   string as a UInt length and the bytes; a dirname length of
+   DC_NO_DIR means NULL), then n_loc DCLocs, then n_inl DCInls each
+   followed by the inlined function's name.  Addresses are relative to
+   text_debug_bias, so the file doesn't depend on where the object was
+   loaded.  Files are written to a temporary name and renamed into
+   place, so concurrent runs never see a partial file. */
+
+#define DC_MAGIC    "VGDICA01"
+#define DC_NO_DIR   0xFFFFFFFF
+#define DC_HAS_INL  1
+
+typedef
+   struct {
+      HChar magic[8];
+      UInt  flags;
+      UInt  sizeof_addr;
+      ULong n_fndn;
+      ULong n_loc;
+      ULong n_inl;
+   }
+   DCHeader;
+
+typedef
+   struct {
+      ULong offset;
+      UInt  fndn_ix;
+      UInt  lineno;
+      UInt  size;
+      UInt  pad;
+   }
+   DCLoc;
+
+typedef
+   struct {
+      ULong offset_lo;
+      ULong offset_hi;
+      UInt  fndn_ix;
+      UInt  lineno;
+      UInt  level;
+      UInt  pad;
+   }
+   DCInl;
+
+/* Small read/write-combining buffer, so that a file with millions of
+   entries doesn't cost millions of syscalls. */
+typedef
+   struct {
+      Int   fd;
+      Bool  failed;
+      UInt  used;
+      UInt  pos;
+      UChar buf[65536];
+   }
+   DCBuf;
+
+static void dc_flush ( DCBuf* b )
+{
+   UInt done = 0;
+   while (!b->failed && done < b->used) {
+      Int r = VG_(write)(b->fd, b->buf + done, b->used - done);
+      if (r <= 0)
+         b->failed = True;
+      else
+         done += r;
+   }
+   b->used = 0;
+}
+
+static void dc_put ( DCBuf* b, const void* p, UInt n )
+{
+   const UChar* s = p;
+   while (n > 0) {
+      UInt chunk = sizeof(b->buf) - b->used;
+      if (chunk > n)
+         chunk = n;
+      VG_(memcpy)(b->buf + b->used, s, chunk);
+      b->used += chunk;
+      s += chunk;
+      n -= chunk;
+      if (b->used == sizeof(b->buf))
+         dc_flush(b);
+   }
+}
+
+static void dc_put_str ( DCBuf* b, const HChar* str )
+{
+   UInt len = str ? VG_(strlen)(str) : DC_NO_DIR;
+   dc_put(b, &len, sizeof(len));
+   if (str)
+      dc_put(b, str, len);
+}
+
+static Bool dc_get ( DCBuf* b, void* p, UInt n )
+{
+   UChar* d = p;
+   while (n > 0) {
+      if (b->pos == b->used) {
+         Int r = b->failed ? -1 : VG_(read)(b->fd, b->buf, sizeof(b->buf));
+         if (r <= 0) {
+            b->failed = True;
+            return False;
+         }
+         b->used = r;
+         b->pos  = 0;
+      }
+      UInt chunk = b->used - b->pos;
+      if (chunk > n)
+         chunk = n;
+      VG_(memcpy)(d, b->buf + b->pos, chunk);
+      b->pos += chunk;
+      d += chunk;
+      n -= chunk;
+   }
+   return True;
+}
+
+/* Read a length-prefixed string into *str, growing it as needed.
+   Sets *is_null for a NULL dirname. */
+static Bool dc_get_str ( DCBuf* b, HChar** str, UInt* str_szB,
+                         /*OUT*/Bool* is_null )
+{
+   UInt len;
+   if (!dc_get(b, &len, sizeof(len)))
+      return False;
+   *is_null = len == DC_NO_DIR;
+   if (*is_null)
+      return True;
+   if (len > (1 << 20))
+      return False;
+   if (len + 1 > *str_szB) {
+      if (*str)
+         ML_(dinfo_free)(*str);
+      *str_szB = len + 1;
+      *str = ML_(dinfo_zalloc)("di.lazy.dgs.1", *str_szB);
+   }
+   if (!dc_get(b, *str, len))
+      return False;
+   (*str)[len] = 0;
+   return True;
+}
+
+/* The name 'di' is cached under, or NULL if it isn't to be cached:
+   the build-id, then the inode, size and mtime of the object. */
+static HChar* cache_key ( const struct _DebugInfo* di )
+{
+   struct vg_stat stat_buf;
+   HChar* key;
+
+   if (VG_(clo_debuginfo_cache_dir) == NULL || di->buildid == NULL)
+      return NULL;
+   if (di->fsm.filename == NULL
+       || sr_isError(VG_(stat)(di->fsm.filename, &stat_buf)))
+      return NULL;
+
+   key = ML_(dinfo_zalloc)("di.lazy.ck.1", VG_(strlen)(di->buildid) + 64);
+   VG_(sprintf)(key, "%s-%llx-%llx-%llx", di->buildid,
+                stat_buf.ino, (ULong)stat_buf.size, stat_buf.mtime);
+   return key;
+}
+
+static HChar* cache_filename ( const HChar* key, const HChar* suffix )
+{
+   const HChar* dir = VG_(clo_debuginfo_cache_dir);
+   HChar* name = ML_(dinfo_zalloc)("di.lazy.cf.1",
+                                   VG_(strlen)(dir) + VG_(strlen)(key)
+                                   + VG_(strlen)(suffix) + 8);
+   VG_(sprintf)(name, "%s/%s.vgdi%s", dir, key, suffix);
+   return name;
+}
+
+/* Does the cache have the inlined call table in it? */
+static Bool cache_with_inl ( void )
+{
+   return VG_(clo_read_inline_info) && !VG_(clo_read_var_info);
+}
+
+/* Try to load the cached tables for 'di'.  Returns True if the line
+   table was loaded, and sets *got_inl if the inline table was too.
+   On failure nothing has been added to 'di'. */
+static Bool load_cache ( struct _DebugInfo* di, const HChar* key,
+                         /*OUT*/Bool* got_inl )
+{
+   HChar*   name = cache_filename(key, "");
+   SysRes   sres = VG_(open)(name, VKI_O_RDONLY, 0);
+   DCHeader hdr;
+   DCBuf*   b;
+   UInt*    fndn_map = NULL;
+   HChar*   str1 = NULL;
+   HChar*   str2 = NULL;
+   UInt     str1_szB = 0, str2_szB = 0;
+   XArray*  fndns = NULL;   /* of HChar*, filename and dirname pairs */
+   XArray*  locs = NULL;     /* of DCLoc */
+   XArray*  inls = NULL;     /* of DCInl */
+   XArray*  fns = NULL;      /* of HChar*, one for each DCInl */
+   Bool     fndns_ok, locs_ok, inls_ok, want_inl;
+   Bool     ok = False;
+   ULong    i;
+
+   *got_inl = False;
+   ML_(dinfo_free)(name);
+   if (sr_isError(sres))
+      return False;
+
+   b = ML_(dinfo_zalloc)("di.lazy.lc.1", sizeof(DCBuf));
+   b->fd = sr_Res(sres);
+
+   if (!dc_get(b, &hdr, sizeof(hdr))
+       || VG_(memcmp)(hdr.magic, DC_MAGIC, sizeof(hdr.magic)) != 0
+       || hdr.sizeof_addr != sizeof(Addr)
+       || hdr.n_fndn > (1ULL << 31))
+      goto out;
+
+   /* Read everything before adding anything, so a truncated file
+      doesn't leave 'di' half filled in. */
+   fndn_map = ML_(dinfo_zalloc)("di.lazy.lc.2",
+                                (hdr.n_fndn + 1) * sizeof(UInt));
+   fndns = VG_(newXA)(ML_(dinfo_zalloc), "di.lazy.lc.3",
+                              ML_(dinfo_free), sizeof(HChar*));
+   for (i = 0; i < hdr.n_fndn; i++) {
+      Bool fn_null, dn_null;
+      HChar* copies[2];
+      if (!dc_get_str(b, &str1, &str1_szB, &fn_null) || fn_null
+          || !dc_get_str(b, &str2, &str2_szB, &dn_null))
+         break;
+      copies[0] = ML_(dinfo_strdup)("di.lazy.lc.4", str1);
+      copies[1] = dn_null ? NULL : ML_(dinfo_strdup)("di.lazy.lc.5", str2);
+      VG_(addToXA)(fndns, &copies[0]);
+      VG_(addToXA)(fndns, &copies[1]);
+   }
+   fndns_ok = i == hdr.n_fndn;
+
+   locs = VG_(newXA)(ML_(dinfo_zalloc), "di.lazy.lc.6",
+                     ML_(dinfo_free), sizeof(DCLoc));
+   for (i = 0; fndns_ok && i < hdr.n_loc; i++) {
+      DCLoc loc;
+      if (!dc_get(b, &loc, sizeof(loc)) || loc.fndn_ix > hdr.n_fndn)
+         break;
+      VG_(addToXA)(locs, &loc);
+   }
+   locs_ok = fndns_ok && i == hdr.n_loc;
+
+   want_inl = (hdr.flags & DC_HAS_INL) && cache_with_inl();
+   inls = VG_(newXA)(ML_(dinfo_zalloc), "di.lazy.lc.7",
+                     ML_(dinfo_free), sizeof(DCInl));
+   fns  = VG_(newXA)(ML_(dinfo_zalloc), "di.lazy.lc.8",
+                     ML_(dinfo_free), sizeof(HChar*));
+   for (i = 0; locs_ok && want_inl && i < hdr.n_inl; i++) {
+      DCInl inl;
+      Bool  fn_null;
+      HChar* copy;
+      if (!dc_get(b, &inl, sizeof(inl)) || inl.fndn_ix > hdr.n_fndn
+          || !dc_get_str(b, &str1, &str1_szB, &fn_null) || fn_null)
+         break;
+      copy = ML_(dinfo_strdup)("di.lazy.lc.9", str1);
+      VG_(addToXA)(inls, &inl);
+      VG_(addToXA)(fns, &copy);
+   }
+   inls_ok = locs_ok && want_inl && i == hdr.n_inl;
+
+   if (locs_ok) {
+      fndn_map[0] = 0;
+      for (i = 0; i < hdr.n_fndn; i++) {
+         HChar* fn = *(HChar**)VG_(indexXA)(fndns, 2*i);
+         HChar* dn = *(HChar**)VG_(indexXA)(fndns, 2*i + 1);
+         fndn_map[i + 1] = ML_(addFnDn)(di, fn, dn);
+      }
+      for (i = 0; i < hdr.n_loc; i++) {
+         DCLoc* loc = VG_(indexXA)(locs, i);
+         Addr   a   = di->text_debug_bias + (Addr)loc->offset;
+         ML_(addLineInfo)(di, fndn_map[loc->fndn_ix],
+                          a, a + loc->size, loc->lineno, (Int)i);
+      }
+      ok = True;
+   }
+   if (inls_ok) {
+      for (i = 0; i < hdr.n_inl; i++) {
+         DCInl* inl = VG_(indexXA)(inls, i);
+         HChar* fn  = *(HChar**)VG_(indexXA)(fns, i);
+         ML_(addInlInfo)(di, di->text_debug_bias + (Addr)inl->offset_lo,
+                         di->text_debug_bias + (Addr)inl->offset_hi,
+                         ML_(addStr)(di, fn, -1),
+                         fndn_map[inl->fndn_ix], inl->lineno,
+                         (UShort)inl->level);
+      }
+      *got_inl = True;
+   }
+
+  out:
+   VG_(close)(b->fd);
+   ML_(dinfo_free)(b);
+   if (fndns) {
+      for (i = 0; i < VG_(sizeXA)(fndns); i++) {
+         HChar* str = *(HChar**)VG_(indexXA)(fndns, i);
+         if (str)
+            ML_(dinfo_free)(str);
+      }
+      VG_(deleteXA)(fndns);
+   }
+   if (fns) {
+      for (i = 0; i < VG_(sizeXA)(fns); i++)
+         ML_(dinfo_free)(*(HChar**)VG_(indexXA)(fns, i));
+      VG_(deleteXA)(fns);
+   }
+   if (fndn_map) ML_(dinfo_free)(fndn_map);
+   if (str1)     ML_(dinfo_free)(str1);
+   if (str2)     ML_(dinfo_free)(str2);
+   if (locs)     VG_(deleteXA)(locs);
+   if (inls)     VG_(deleteXA)(inls);
+   if (ok) {
+      if (VG_(clo_verbosity) > 1)
+         VG_(message)(Vg_DebugMsg,
+                      "debuginfo cache: loaded %llu lines%s for %s\n",
+                      hdr.n_loc, *got_inl ? " and inline info" : "",
+                      di->fsm.filename);
+   }
+   return ok;
+}
+
+static void save_cache ( struct _DebugInfo* di, const HChar* key )
+{
+   HChar*   name = cache_filename(key, "");
+   HChar    suffix[32];
+   HChar*   tmpname;
+   SysRes   sres;
+   DCHeader hdr;
+   DCBuf*   b;
+   UWord    i;
+
+   VG_(sprintf)(suffix, ".%d.tmp", VG_(getpid)());
+   tmpname = cache_filename(key, suffix);
+   sres = VG_(open)(tmpname, VKI_O_CREAT|VKI_O_WRONLY|VKI_O_TRUNC,
+                    VKI_S_IRUSR|VKI_S_IWUSR|VKI_S_IRGRP|VKI_S_IROTH);
+   if (sr_isError(sres)) {
+      if (VG_(clo_verbosity) > 1)
+         VG_(message)(Vg_DebugMsg,
+                      "debuginfo cache: can't create %s\n", tmpname);
+      goto out;
+   }
+
+   b = ML_(dinfo_zalloc)("di.lazy.sc.1", sizeof(DCBuf));
+   b->fd = sr_Res(sres);
+
+   VG_(memset)(&hdr, 0, sizeof(hdr));
+   VG_(memcpy)(hdr.magic, DC_MAGIC, sizeof(hdr.magic));
+   hdr.flags       = cache_with_inl() ? DC_HAS_INL : 0;
+   hdr.sizeof_addr = sizeof(Addr);
+   hdr.n_fndn      = di->fndnpool ? VG_(sizeDedupPA)(di->fndnpool) : 0;
+   hdr.n_loc       = di->loctab_used;
+   hdr.n_inl       = cache_with_inl() ? di->inltab_used : 0;
+   dc_put(b, &hdr, sizeof(hdr));
+
+   for (i = 1; i <= hdr.n_fndn; i++) {
+      const FnDn* fndn = VG_(indexEltNumber)(di->fndnpool, i);
+      dc_put_str(b, fndn->filename);
+      dc_put_str(b, fndn->dirname);
+   }
+   for (i = 0; i < hdr.n_loc; i++) {
+      DCLoc loc;
+      loc.offset  = di->loctab[i].addr - di->text_debug_bias;
+      loc.fndn_ix = ML_(fndn_ix)(di, i);
+      loc.lineno  = di->loctab[i].lineno;
+      loc.size    = di->loctab[i].size;
+      loc.pad     = 0;
+      dc_put(b, &loc, sizeof(loc));
+   }
+   for (i = 0; i < hdr.n_inl; i++) {
+      DCInl inl;
+      inl.offset_lo = di->inltab[i].addr_lo - di->text_debug_bias;
+      inl.offset_hi = di->inltab[i].addr_hi - di->text_debug_bias;
+      inl.fndn_ix   = di->inltab[i].fndn_ix;
+      inl.lineno    = di->inltab[i].lineno;
+      inl.level     = di->inltab[i].level;
+      inl.pad       = 0;
+      dc_put(b, &inl, sizeof(inl));
+      dc_put_str(b, di->inltab[i].inlinedfn);
+   }
+   dc_flush(b);
+   VG_(close)(b->fd);
+
+   if (b->failed || VG_(rename)(tmpname, name) != 0) {
+      VG_(unlink)(tmpname);
+   } else {
+      if (VG_(clo_verbosity) > 1)
+         VG_(message)(Vg_DebugMsg,
+                      "debuginfo cache: saved %llu lines for %s\n",
+                      hdr.n_loc, di->fsm.filename);
+   }
+   ML_(dinfo_free)(b);
+
+  out:
+   ML_(dinfo_free)(tmpname);
+   ML_(dinfo_free)(name);
+}
+
+
+/*------------------------------------------------------------*/
+/*--- Top level                                            ---*/
+/*------------------------------------------------------------*/
+
+static Int cmp_DiLazyRange ( const void* va, const void* vb )
+{
+   const DiLazyRange* a = va;
+   const DiLazyRange* b = vb;
+   if (a->aMin < b->aMin) return -1;
+   if (a->aMin > b->aMin) return  1;
+   return 0;
+}
+
+static Word find_unit ( XArray* units, ULong cu_off )
+{
+   Word lo = 0, hi = VG_(sizeXA)(units) - 1;
+   while (lo <= hi) {
+      Word mid = (lo + hi) / 2;
+      ULong off = ((DiLazyUnit*)VG_(indexXA)(units, mid))->cu_off;
+      if (off < cu_off)      lo = mid + 1;
+      else if (off > cu_off) hi = mid - 1;
+      else return mid;
+   }
+   return -1;
+}
+
+/* If all of the sections in 'secs' live in local files among
+   mimg/dimg/aimg, fill in 'imgs' with the ones used and return True. */
+static Bool images_for ( const DiDwarfSections* secs,
+                         DiImage* mimg, DiImage* dimg, DiImage* aimg,
+                         /*OUT*/DiImage* imgs[3] )
+{
+   const DiSlice* all[] = {
+      &secs->info, &secs->types, &secs->abbv, &secs->line, &secs->str,
+      &secs->ranges, &secs->loc, &secs->aranges, &secs->info_alt,
+      &secs->abbv_alt, &secs->line_alt, &secs->str_alt
+   };
+   DiImage* cands[3] = { mimg, dimg, aimg };
+   UInt i, j;
+
+   imgs[0] = imgs[1] = imgs[2] = NULL;
+   for (i = 0; i < sizeof(all)/sizeof(all[0]); i++) {
+      if (!ML_(sli_is_valid)(*all[i]))
+         continue;
+      for (j = 0; j < 3; j++)
+         if (cands[j] && all[i]->img == cands[j])
+            break;
+      if (j == 3 || !ML_(img_is_local)(cands[j]))
+         return False;
+      imgs[j] = cands[j];
+   }
+   return True;
+}
+
+/* Set up deferred reading of whichever of the line and DIE info are
+   still needed.  Returns False if nothing turned out to need
+   deferring, in which case it has all been read. */
+static Bool defer ( struct _DebugInfo* di, const DiDwarfSections* secs,
+                    DiImage* imgs[3], Bool need_lines, Bool need_d3 )
+{
+   DiDeferred* dd;
+   XArray*     offs;
+   XArray*     cuRanges;
+   Bool*       indexed;
+   Word        i, n;
+
+   dd = ML_(dinfo_zalloc)("di.lazy.d.1", sizeof(DiDeferred));
+   dd->secs       = *secs;
+   dd->d3_pending = need_d3;
+   di->deferred   = dd;
+
+   if (need_lines) {
+      offs = VG_(newXA)(ML_(dinfo_zalloc), "di.lazy.d.2",
+                        ML_(dinfo_free), sizeof(ULong));
+      ML_(list_units_dwarf3)(di, secs->info, offs);
+      n = VG_(sizeXA)(offs);
+      dd->units = VG_(newXA)(ML_(dinfo_zalloc), "di.lazy.d.3",
+                             ML_(dinfo_free), sizeof(DiLazyUnit));
+      for (i = 0; i < n; i++) {
+         DiLazyUnit u;
+         u.cu_off = *(ULong*)VG_(indexXA)(offs, i);
+         u.loaded = False;
+         VG_(addToXA)(dd->units, &u);
+      }
+      VG_(deleteXA)(offs);
+      dd->n_units_left = n;
+
+      cuRanges = VG_(newXA)(ML_(dinfo_zalloc), "di.lazy.d.4",
+                            ML_(dinfo_free), sizeof(DiCuRange));
+      if (ML_(sli_is_valid)(secs->aranges)
+          && !ML_(read_aranges_dwarf3)(di, secs->aranges, cuRanges)) {
+         ML_(symerr)(di, False, "Malformed .debug_aranges; "
+                                "reading all line info now");
+         VG_(dropTailXA)(cuRanges, VG_(sizeXA)(cuRanges));
+      }
+
+      dd->ranges = VG_(newXA)(ML_(dinfo_zalloc), "di.lazy.d.5",
+                              ML_(dinfo_free), sizeof(DiLazyRange));
+      indexed = n > 0 ? ML_(dinfo_zalloc)("di.lazy.d.6", n * sizeof(Bool))
+                      : NULL;
+      for (i = 0; i < VG_(sizeXA)(cuRanges); i++) {
+         DiCuRange*  cr = VG_(indexXA)(cuRanges, i);
+         DiLazyRange r;
+         Word        u = find_unit(dd->units, cr->cu_off);
+         if (u < 0)
+            continue;
+         r.aMin = cr->aMin;
+         r.aMax = cr->aMax;
+         r.unit = u;
+         VG_(addToXA)(dd->ranges, &r);
+         indexed[u] = True;
+      }
+      VG_(deleteXA)(cuRanges);
+
+      VG_(setCmpFnXA)(dd->ranges, cmp_DiLazyRange);
+      VG_(sortXA)(dd->ranges);
+      Addr maxSoFar = 0;
+      for (i = 0; i < VG_(sizeXA)(dd->ranges); i++) {
+         DiLazyRange* r = VG_(indexXA)(dd->ranges, i);
+         if (r->aMax > maxSoFar)
+            maxSoFar = r->aMax;
+         r->aMaxSoFar = maxSoFar;
+      }
+
+      /* Units .debug_aranges doesn't know about have to be read now. */
+      for (i = 0; i < n; i++)
+         if (!indexed[i])
+            load_unit(di, VG_(indexXA)(dd->units, i));
+      if (indexed)
+         ML_(dinfo_free)(indexed);
+   }
+
+   if (dd->n_units_left == 0 && !dd->d3_pending) {
+      ML_(free_deferred)(di);
+      return False;
+   }
+   if (dd->n_units_left == 0 && dd->units) {
+      VG_(deleteXA)(dd->units);
+      VG_(deleteXA)(dd->ranges);
+      dd->units  = NULL;
+      dd->ranges = NULL;
+   }
+   for (i = 0; i < 3; i++)
+      dd->imgs[i] = imgs[i];
+   suspend_images(dd);
+   return True;
+}
+
+void ML_(read_dwarf3_info) ( struct _DebugInfo* di,
+                             const DiDwarfSections* secs,
+                             /*MOD*/DiImage** mimg,
+                             /*MOD*/DiImage** dimg,
+                             /*MOD*/DiImage** aimg )
+{
+   Bool     need_lines = True;
+   Bool     need_d3 = VG_(clo_read_var_info) || VG_(clo_read_inline_info);
+   DiImage* imgs[3];
+   HChar*   key;
+
+   vg_assert(di->deferred == NULL);
+
+   key = cache_key(di);
+   if (key) {
+      Bool got_inl;
+      if (load_cache(di, key, &got_inl)) {
+         need_lines = False;
+         if (got_inl)
+            need_d3 = False;
+         ML_(dinfo_free)(key);
+      } else {
+         /* Read everything now, so there is something to save. */
+         ML_(read_debuginfo_dwarf3)( di, secs->info, secs->types,
+                                     secs->abbv, secs->line,
+                                     secs->str, secs->str_alt );
+         if (need_d3)
+            read_d3(di, secs);
+         save_cache(di, key);
+         ML_(dinfo_free)(key);
+         return;
+      }
+   }
+
+   if (!need_lines && !need_d3)
+      return;
+
+   if (VG_(clo_lazy_debuginfo)
+       && !di->trace_symtab && !di->ddump_line
+       && images_for(secs, *mimg, *dimg, *aimg, imgs)) {
+      if (!defer(di, secs, imgs, need_lines, need_d3))
+         return;
+      /* The deferred state owns the images now. */
+      if (imgs[0]) *mimg = NULL;
+      if (imgs[1]) *dimg = NULL;
+      if (imgs[2]) *aimg = NULL;
+      return;
+   }
+
+   if (need_lines)
+      ML_(read_debuginfo_dwarf3)( di, secs->info, secs->types,
+                                  secs->abbv, secs->line,
+                                  secs->str, secs->str_alt );
+   if (need_d3)
+      read_d3(di, secs);
+}
+
+#endif // defined(VGO_linux) || defined(VGO_darwin)
+
+/*--------------------------------------------------------------------*/
+/*--- end                                                          ---*/
+/*--------------------------------------------------------------------*/
@@ -74,6 +74,20 @@ DiImage* ML_(img_from_di_server)(const HChar* filename,
 /* Destroy an existing image. */
 void ML_(img_done)(DiImage*);
 
+/* Is the image of a file in the local filesystem? */
+Bool ML_(img_is_local)(const DiImage* img);
+
+/* Close the file underlying a local image and drop most of its cache,
+   so that an image which may be needed again later doesn't tie up a
+   file descriptor.  No data may be read from it until
+   ML_(img_resume) has been called. */
+void ML_(img_suspend)(DiImage* img);
+
+/* Reopen the file of a suspended image.  Returns False, leaving the
+   image suspended, if that fails or if the file has changed since it
+   was first opened. */
+Bool ML_(img_resume)(DiImage* img);
+
 /* How big is the image? */
 DiOffT ML_(img_size)(const DiImage* img);
 
@@ -0,0 +1,78 @@
+
+/*--------------------------------------------------------------------*/
+/*--- Deferred and cached reading of DWARF info.      priv_lazy.h ---*/
+/*--------------------------------------------------------------------*/
+
+/*
+   This file is part of Valgrind, a dynamic binary instrumentation
+   framework.
+
+   Copyright (C) 2000-2013 Julian Seward
+      jseward@acm.org
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2 of the
+   License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+   02111-1307, USA.
+
+   The GNU General Public License is contained in the file COPYING.
+*/
+
+#ifndef __PRIV_LAZY_H
+#define __PRIV_LAZY_H
+
+#include "pub_core_basics.h"      // Addr
+#include "priv_image.h"           // DiSlice, DiImage
+
+struct _DebugInfo;
+
+/* Everything needed to read the rest later; private to lazy.c. */
+typedef  struct _DiDeferred  DiDeferred;
+
+/* The DWARF sections of an object that the line reader and the DIE
+   reader need.  Any of them may be DiSlice_INVALID, except that
+   ML_(read_dwarf3_info) requires .info, .abbv and .line. */
+typedef
+   struct {
+      DiSlice info, types, abbv, line, str, ranges, loc, aranges;
+      DiSlice info_alt, abbv_alt, line_alt, str_alt;
+   }
+   DiDwarfSections;
+
+/* Read, or arrange to read later, the line number info and (if wanted)
+   the variable and inline info described by 'secs'.  If reading is
+   deferred, this takes over whichever of *mimg, *dimg and *aimg the
+   sections live in, setting the caller's pointer to NULL; the caller
+   remains responsible for any it still holds. */
+extern void ML_(read_dwarf3_info) ( struct _DebugInfo* di,
+                                    const DiDwarfSections* secs,
+                                    /*MOD*/DiImage** mimg,
+                                    /*MOD*/DiImage** dimg,
+                                    /*MOD*/DiImage** aimg );
+
+/* Make sure that the line info for the compilation unit covering 'a',
+   if any, has been read.  Only call when di->deferred != NULL. */
+extern void ML_(lazy_load_lines_at) ( struct _DebugInfo* di, Addr a );
+
+/* Make sure that the variable and inline info for 'di' has been read.
+   Only call when di->deferred != NULL. */
+extern void ML_(lazy_load_d3) ( struct _DebugInfo* di );
+
+/* Release whatever is still deferred, as 'di' is being thrown away. */
+extern void ML_(free_deferred) ( struct _DebugInfo* di );
+
+#endif /* ndef __PRIV_LAZY_H */
+
+/*--------------------------------------------------------------------*/
+/*--- end                                                          ---*/
+/*--------------------------------------------------------------------*/
@@ -32,6 +32,7 @@
 #define __PRIV_READDWARF_H
 
 #include "pub_core_debuginfo.h"   // DebugInfo
+#include "pub_core_xarray.h"      // XArray
 #include "priv_image.h"           // DiSlice
 
 /*
@@ -54,6 +55,42 @@ void ML_(read_debuginfo_dwarf3)
           DiSlice escn_debug_str,       /* .debug_str */
           DiSlice escn_debug_str_alt ); /* .debug_str */
 
+/* Read the line number info of just one compilation unit, identified
+   by the offset of its header in .debug_info. */
+extern
+void ML_(read_debuginfo_dwarf3_unit)
+        ( DebugInfo* di,
+          DiSlice escn_debug_info,
+          DiSlice escn_debug_abbv,
+          DiSlice escn_debug_line,
+          DiSlice escn_debug_str,
+          DiSlice escn_debug_str_alt,
+          ULong   cu_off );
+
+/* Append the .debug_info offsets of all compilation unit headers to
+   'offs', an XArray of ULong. */
+extern
+void ML_(list_units_dwarf3) ( DebugInfo* di,
+                              DiSlice escn_debug_info,
+                              /*MOD*/XArray* offs );
+
+/* An address range covered by one compilation unit, as described by
+   .debug_aranges. */
+typedef
+   struct {
+      Addr  aMin;
+      Addr  aMax;     /* inclusive */
+      ULong cu_off;   /* offset of the unit's header in .debug_info */
+   }
+   DiCuRange;
+
+/* Append a DiCuRange to 'ranges' for each range in .debug_aranges.
+   Returns False if the section is malformed. */
+extern
+Bool ML_(read_aranges_dwarf3) ( DebugInfo* di,
+                                DiSlice escn_debug_aranges,
+                                /*MOD*/XArray* ranges );
+
 /* --------------------
    DWARF1 reader
    -------------------- */
@@ -636,6 +636,10 @@ struct _DebugInfo {
    /* The file's soname. */
    HChar* soname;
 
+   /* The build-id of the main image, as a hex string, or NULL if it
+      doesn't have one. */
+   HChar* buildid;
+
    /* Description of some important mapped segments.  The presence or
       absence of the mapping is denoted by the _present field, since
       in some obscure circumstances (to do with data/sdata/bss) it is
@@ -996,6 +1000,11 @@ struct _DebugInfo {
       This helps performance a lot during ML_(addLineInfo) etc., which can
       easily be invoked hundreds of thousands of times. */
    DebugInfoMapping* last_rx_map;
+
+   /* DWARF line, inline and variable info which has not been read
+      yet, because --lazy-debuginfo=yes.  NULL once everything has been
+      read (or there was nothing to defer).  See lazy.c. */
+   struct _DiDeferred* deferred;
 };
 
 /* --------------------- functions --------------------- */
@@ -1090,6 +1099,10 @@ extern void ML_(addVar)( struct _DebugInfo* di,
    this after finishing adding entries to these tables. */
 extern void ML_(canonicaliseTables) ( struct _DebugInfo* di );
 
+/* Re-canonicalise the line, inline and variable tables held by 'di',
+   after deferred debug info has been added to them. */
+extern void ML_(canonicaliseDeferredTables) ( struct _DebugInfo* di );
+
 /* Canonicalise the call-frame-info table held by 'di', in preparation
    for use. This is called by ML_(canonicaliseTables) but can also be
    called on it's own to sort just this table. */
@@ -1048,6 +1048,68 @@ void read_unitinfo_dwarf2( /*OUT*/UnitInfo* ui,
 ////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////
 
+/* Read the line number info for the compilation unit whose header
+   (the initial length field) is at block_img, and whose initial
+   length field is blklen_len bytes long. */
+static
+void read_unit_lines_dwarf3 ( struct _DebugInfo* di,
+                              DiCursor block_img,
+                              Int      blklen_len,
+                              DiSlice  escn_debug_info,
+                              DiSlice  escn_debug_abbv,
+                              DiSlice  escn_debug_line,
+                              DiSlice  escn_debug_str,
+                              DiSlice  escn_debug_str_alt )
+{
+   UnitInfo ui;
+   UShort   ver;
+
+   /* version should be 2 */
+   ver = ML_(cur_read_UShort)( ML_(cur_plus)(block_img, blklen_len) );
+   if ( ver != 2 && ver != 3 && ver != 4 ) {
+      ML_(symerr)( di, True,
+                   "Ignoring non-Dwarf2/3/4 block in .debug_info" );
+      return;
+   }
+   
+   /* Fill ui with offset in .debug_line and compdir */
+   if (0)
+      VG_(printf)(
+         "Reading UnitInfo at 0x%llx.....\n",
+         (ULong)ML_(cur_minus)( block_img,
+                                ML_(cur_from_sli)(escn_debug_info)) );
+   read_unitinfo_dwarf2( &ui, block_img, 
+                              ML_(cur_from_sli)(escn_debug_abbv),
+                              ML_(cur_from_sli)(escn_debug_str),
+                              ML_(cur_from_sli)(escn_debug_str_alt) );
+   if (0) {
+      HChar* str_name    = ML_(cur_read_strdup)(ui.name,    "di.rdd3.1");
+      HChar* str_compdir = ML_(cur_read_strdup)(ui.compdir, "di.rdd3.2");
+      VG_(printf)( "   => LINES=0x%llx    NAME=%s     DIR=%s\n", 
+                   ui.stmt_list, str_name, str_compdir );
+      ML_(dinfo_free)(str_name);
+      ML_(dinfo_free)(str_compdir);
+   }
+
+   /* Ignore blocks with no .debug_line associated block */
+   if ( ui.stmt_list == -1LL )
+      return;
+   
+   if (0) {
+      HChar* str_name = ML_(cur_read_strdup)(ui.name, "di.rdd3.3");
+      VG_(printf)("debug_line_sz %lld, ui.stmt_list %lld  %s\n",
+                  escn_debug_line.szB, ui.stmt_list, str_name );
+      ML_(dinfo_free)(str_name);
+   }
+
+   /* Read the .debug_line block for this compile unit */
+   read_dwarf2_lineblock(
+      di, &ui,
+      ML_(cur_plus)(ML_(cur_from_sli)(escn_debug_line), ui.stmt_list),
+      escn_debug_line.szB  - ui.stmt_list
+   );
+}
+
 /* Collect the debug info from DWARF3 debugging sections
  * of a given module.
  * 
@@ -1063,8 +1125,6 @@ void ML_(read_debuginfo_dwarf3)
           DiSlice escn_debug_str,       /* .debug_str */
           DiSlice escn_debug_str_alt )  /* .debug_str */
 {
-   UnitInfo ui;
-   UShort   ver;
    ULong    blklen;
    Bool     blklen_is_64;
 
@@ -1098,51 +1158,130 @@ void ML_(read_debuginfo_dwarf3)
          return;
       }
 
-      /* version should be 2 */
-      ver = ML_(cur_read_UShort)( ML_(cur_plus)(block_img, blklen_len) );
-      if ( ver != 2 && ver != 3 && ver != 4 ) {
-         ML_(symerr)( di, True,
-                      "Ignoring non-Dwarf2/3/4 block in .debug_info" );
-         continue;
-      }
-      
-      /* Fill ui with offset in .debug_line and compdir */
-      if (0)
-         VG_(printf)(
-            "Reading UnitInfo at 0x%llx.....\n",
-            (ULong)ML_(cur_minus)( block_img,
-                                   ML_(cur_from_sli)(escn_debug_info)) );
-      read_unitinfo_dwarf2( &ui, block_img, 
-                                 ML_(cur_from_sli)(escn_debug_abbv),
-                                 ML_(cur_from_sli)(escn_debug_str),
-                                 ML_(cur_from_sli)(escn_debug_str_alt) );
-      if (0) {
-         HChar* str_name    = ML_(cur_read_strdup)(ui.name,    "di.rdd3.1");
-         HChar* str_compdir = ML_(cur_read_strdup)(ui.compdir, "di.rdd3.2");
-         VG_(printf)( "   => LINES=0x%llx    NAME=%s     DIR=%s\n", 
-                      ui.stmt_list, str_name, str_compdir );
-         ML_(dinfo_free)(str_name);
-         ML_(dinfo_free)(str_compdir);
-      }
+      read_unit_lines_dwarf3( di, block_img, blklen_len,
+                              escn_debug_info, escn_debug_abbv,
+                              escn_debug_line, escn_debug_str,
+                              escn_debug_str_alt );
+   }
+}
 
-      /* Ignore blocks with no .debug_line associated block */
-      if ( ui.stmt_list == -1LL )
-         continue;
-      
-      if (0) {
-         HChar* str_name = ML_(cur_read_strdup)(ui.name, "di.rdd3.3");
-         VG_(printf)("debug_line_sz %lld, ui.stmt_list %lld  %s\n",
-                     escn_debug_line.szB, ui.stmt_list, str_name );
-         ML_(dinfo_free)(str_name);
-      }
+/* As ML_(read_debuginfo_dwarf3), but only for the compilation unit
+   whose header is at offset cu_off in .debug_info. */
+void ML_(read_debuginfo_dwarf3_unit)
+        ( struct _DebugInfo* di,
+          DiSlice escn_debug_info,
+          DiSlice escn_debug_abbv,
+          DiSlice escn_debug_line,
+          DiSlice escn_debug_str,
+          DiSlice escn_debug_str_alt,
+          ULong   cu_off )
+{
+   ULong blklen;
+   Bool  blklen_is_64;
+   Int   blklen_len;
+
+   if (cu_off + 4 > escn_debug_info.szB) {
+      ML_(symerr)( di, True,
+                   "Unit offset outside .debug_info; ignoring" );
+      return;
+   }
+   DiCursor block_img = ML_(cur_plus)( ML_(cur_from_sli)(escn_debug_info),
+                                       cu_off );
+   blklen     = read_initial_length_field( block_img, &blklen_is_64 );
+   blklen_len = blklen_is_64 ? 12 : 4;
+   if (cu_off + blklen + blklen_len > escn_debug_info.szB) {
+      ML_(symerr)( di, True,
+                   "Last block truncated in .debug_info; ignoring" );
+      return;
+   }
+   read_unit_lines_dwarf3( di, block_img, blklen_len,
+                           escn_debug_info, escn_debug_abbv,
+                           escn_debug_line, escn_debug_str,
+                           escn_debug_str_alt );
+}
+
+/* Append to 'offs' the .debug_info offset of every compilation unit
+   header, without looking inside the units. */
+void ML_(list_units_dwarf3) ( struct _DebugInfo* di,
+                              DiSlice escn_debug_info,
+                              /*MOD*/XArray* /* of ULong */ offs )
+{
+   ULong blklen;
+   Bool  blklen_is_64;
+   ULong off = 0;
+
+   while (off + 4 <= escn_debug_info.szB) {
+      DiCursor block_img
+         = ML_(cur_plus)( ML_(cur_from_sli)(escn_debug_info), off );
+      blklen = read_initial_length_field( block_img, &blklen_is_64 );
+      if (off + blklen + (blklen_is_64 ? 12 : 4) > escn_debug_info.szB)
+         break;
+      VG_(addToXA)( offs, &off );
+      off += blklen + (blklen_is_64 ? 12 : 4);
+   }
+}
 
-      /* Read the .debug_line block for this compile unit */
-      read_dwarf2_lineblock(
-         di, &ui,
-         ML_(cur_plus)(ML_(cur_from_sli)(escn_debug_line), ui.stmt_list),
-         escn_debug_line.szB  - ui.stmt_list
-      );
+/* Read .debug_aranges, appending one DiCuRange for each address range
+   it describes to 'ranges'.  Addresses are biased as for the line
+   table.  Returns False if the section is malformed, in which case
+   'ranges' may have been partially filled in and should not be
+   trusted. */
+Bool ML_(read_aranges_dwarf3) ( struct _DebugInfo* di,
+                                DiSlice escn_debug_aranges,
+                                /*MOD*/XArray* /* of DiCuRange */ ranges )
+{
+   ULong    blklen;
+   Bool     blklen_is_64;
+   DiCursor set_img = ML_(cur_from_sli)(escn_debug_aranges);
+   DiCursor end_img = ML_(cur_plus)(set_img, escn_debug_aranges.szB);
+
+   while (ML_(cur_cmpLT)(set_img, ML_(cur_plus)(end_img, -(DiOffT)4))) {
+      DiCursor p, set_end;
+      UShort   ver;
+      ULong    cu_off;
+      UChar    addr_size, seg_size;
+      DiOffT   hdr_len;
+
+      blklen  = read_initial_length_field( set_img, &blklen_is_64 );
+      p       = ML_(cur_plus)(set_img, blklen_is_64 ? 12 : 4);
+      set_end = ML_(cur_plus)(p, blklen);
+      if (ML_(cur_cmpGT)(set_end, end_img))
+         return False;
+
+      ver = ML_(cur_step_UShort)(&p);
+      if (ver != 2)
+         return False;
+      cu_off    = blklen_is_64 ? ML_(cur_step_ULong)(&p)
+                               : (ULong)ML_(cur_step_UInt)(&p);
+      addr_size = ML_(cur_step_UChar)(&p);
+      seg_size  = ML_(cur_step_UChar)(&p);
+      if ((addr_size != 4 && addr_size != 8) || seg_size != 0)
+         return False;
+
+      /* The tuples are aligned to twice the address size, relative
+         to the start of the set. */
+      hdr_len = ML_(cur_minus)(p, set_img);
+      hdr_len = (hdr_len + 2 * addr_size - 1) & ~(DiOffT)(2 * addr_size - 1);
+      p = ML_(cur_plus)(set_img, hdr_len);
+
+      while (ML_(cur_cmpLT)(ML_(cur_plus)(p, 2 * addr_size - 1), set_end)) {
+         ULong start = addr_size == 8 ? ML_(cur_step_ULong)(&p)
+                                      : (ULong)ML_(cur_step_UInt)(&p);
+         ULong len   = addr_size == 8 ? ML_(cur_step_ULong)(&p)
+                                      : (ULong)ML_(cur_step_UInt)(&p);
+         if (start == 0 && len == 0)
+            break;
+         if (len == 0)
+            continue;
+         DiCuRange r;
+         r.aMin   = di->text_debug_bias + (Addr)start;
+         r.aMax   = r.aMin + (Addr)len - 1;
+         r.cu_off = cu_off;
+         VG_(addToXA)( ranges, &r );
+      }
+      set_img = set_end;
    }
+   return True;
 }
 
 
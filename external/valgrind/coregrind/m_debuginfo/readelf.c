@@ -51,6 +51,7 @@
 #include "priv_readdwarf.h"        /* 'cos ELF contains DWARF */
 #include "priv_readdwarf3.h"
 #include "priv_readexidx.h"
+#include "priv_lazy.h"
 
 /* --- !!! --- EXTERNAL HEADERS start --- !!! --- */
 #include <elf.h>
@@ -2332,6 +2333,7 @@ Bool ML_(read_elf_debug_info) ( struct _DebugInfo* di )
       DiSlice debug_str_escn      = DiSlice_INVALID; // .debug_str    (dwarf2)
       DiSlice debug_ranges_escn   = DiSlice_INVALID; // .debug_ranges (dwarf2)
       DiSlice debug_loc_escn      = DiSlice_INVALID; // .debug_loc    (dwarf2)
+      DiSlice debug_aranges_escn  = DiSlice_INVALID; // .debug_aranges (dwarf2)
       DiSlice debug_frame_escn    = DiSlice_INVALID; // .debug_frame  (dwarf2)
       DiSlice debug_line_alt_escn = DiSlice_INVALID; // .debug_line   (alt)
       DiSlice debug_info_alt_escn = DiSlice_INVALID; // .debug_info   (alt)
@@ -2415,6 +2417,7 @@ Bool ML_(read_elf_debug_info) ( struct _DebugInfo* di )
          FIND(".debug_str",         debug_str_escn)
          FIND(".debug_ranges",      debug_ranges_escn)
          FIND(".debug_loc",         debug_loc_escn)
+         FIND(".debug_aranges",     debug_aranges_escn)
          FIND(".debug_frame",       debug_frame_escn)
 
          FIND(".debug",             dwarf1d_escn)
@@ -2482,10 +2485,12 @@ Bool ML_(read_elf_debug_info) ( struct _DebugInfo* di )
          }
       }
 
-      if (buildid) {
-         ML_(dinfo_free)(buildid);
-         buildid = NULL; /* paranoia */
-      }
+      /* Hang on to the build-id; m_transcache uses it to identify
+         the object's code across runs. */
+      if (di->buildid)
+         ML_(dinfo_free)(di->buildid);
+      di->buildid = buildid;
+      buildid = NULL; /* paranoia */
 
       /* As a last-ditch measure, try looking for in the
          --extra-debuginfo-path and/or on the --debuginfo-server, but
@@ -2701,6 +2706,7 @@ Bool ML_(read_elf_debug_info) ( struct _DebugInfo* di )
             FIND(need_dwarf2, ".debug_ranges", debug_ranges_escn)
 
             FIND(need_dwarf2, ".debug_loc",    debug_loc_escn)
+            FIND(need_dwarf2, ".debug_aranges", debug_aranges_escn)
             FIND(need_dwarf2, ".debug_frame",  debug_frame_escn)
 
             FIND(need_dwarf2, ".gnu_debugaltlink", debugaltlink_escn)
@@ -2891,29 +2897,25 @@ Bool ML_(read_elf_debug_info) ( struct _DebugInfo* di )
       if (ML_(sli_is_valid)(debug_info_escn) 
           && ML_(sli_is_valid)(debug_abbv_escn)
           && ML_(sli_is_valid)(debug_line_escn)) {
-         /* The old reader: line numbers and unwind info only */
-         ML_(read_debuginfo_dwarf3) ( di,
-                                      debug_info_escn,
-                                      debug_types_escn,
-                                      debug_abbv_escn,
-                                      debug_line_escn,
-                                      debug_str_escn,
-                                      debug_str_alt_escn );
-         /* The new reader: read the DIEs in .debug_info to acquire
-            information on variable types and locations or inline info.
-            But only if the tool asks for it, or the user requests it on
-            the command line. */
-         if (VG_(clo_read_var_info) /* the user or tool asked for it */
-             || VG_(clo_read_inline_info)) {
-            ML_(new_dwarf3_reader)(
-               di, debug_info_escn,     debug_types_escn,
-                   debug_abbv_escn,     debug_line_escn,
-                   debug_str_escn,      debug_ranges_escn,
-                   debug_loc_escn,      debug_info_alt_escn,
-                   debug_abbv_alt_escn, debug_line_alt_escn,
-                   debug_str_alt_escn
-            );
-         }
+         /* Line numbers, and (if the tool asks for it, or the user
+            requests it on the command line) variable type/location
+            and inline info.  These may be read now, taken from the
+            --debuginfo-cache-dir cache, or deferred until an address
+            in this object is first looked up; see lazy.c. */
+         DiDwarfSections secs;
+         secs.info     = debug_info_escn;
+         secs.types    = debug_types_escn;
+         secs.abbv     = debug_abbv_escn;
+         secs.line     = debug_line_escn;
+         secs.str      = debug_str_escn;
+         secs.ranges   = debug_ranges_escn;
+         secs.loc      = debug_loc_escn;
+         secs.aranges  = debug_aranges_escn;
+         secs.info_alt = debug_info_alt_escn;
+         secs.abbv_alt = debug_abbv_alt_escn;
+         secs.line_alt = debug_line_alt_escn;
+         secs.str_alt  = debug_str_alt_escn;
+         ML_(read_dwarf3_info)( di, &secs, &mimg, &dimg, &aimg );
       }
 
       /* TOPLEVEL */
@@ -2312,6 +2312,23 @@ void ML_(canonicaliseTables) ( struct _DebugInfo* di )
    if (di->cfsi_m_pool)
       VG_(freezeDedupPA) (di->cfsi_m_pool, ML_(dinfo_shrink_block));
    canonicaliseVarInfo ( di );
+   /* Deferred debug info will add more strings and filename/dirname
+      pairs later on, so the pools can't be frozen yet. */
+   if (di->deferred)
+      return;
+   if (di->strpool)
+      VG_(freezeDedupPA) (di->strpool, ML_(dinfo_shrink_block));
+   if (di->fndnpool)
+      VG_(freezeDedupPA) (di->fndnpool, ML_(dinfo_shrink_block));
+}
+
+void ML_(canonicaliseDeferredTables) ( struct _DebugInfo* di )
+{
+   canonicaliseLoctab ( di );
+   canonicaliseInltab ( di );
+   canonicaliseVarInfo ( di );
+   if (di->deferred)
+      return;
    if (di->strpool)
       VG_(freezeDedupPA) (di->strpool, ML_(dinfo_shrink_block));
    if (di->fndnpool)
@@ -74,10 +74,14 @@
 static Error* errors = NULL;
 
 /* The list of suppression directives, as read from the specified
-   suppressions file.  Note that the list gets rearranged as a result
-   of the searches done by is_suppressible_error(). */
+   suppressions file, most recently read first.  Searching is done
+   through the index built over this list by build_supp_index(), see
+   "Matching errors to suppressions" below. */
 static Supp* suppressions = NULL;
 
+/* Number of suppressions read so far.  Gives Supp.seq. */
+static UInt n_supps_loaded = 0;
+
 /* Running count of unsuppressed errors detected. */
 static UInt n_errs_found = 0;
 
@@ -96,6 +100,7 @@ static UInt n_supp_contexts = 0;
 
 /* forwards ... */
 static Supp* is_suppressible_error ( const Error* err );
+static void build_supp_index ( void );
 
 static ThreadId last_tid_printed = 1;
 
@@ -113,6 +118,15 @@ static UWord em_supplist_searches = 0;
    searching. */
 static UWord em_supplist_cmps = 0;
 
+/* Stats: time spent searching the suppression list, in
+   microseconds. */
+static ULong em_supplist_usecs = 0;
+
+/* Stats: fun/obj name lookups done for suppression matching, and how
+   many of them were answered by the IP name cache. */
+static UWord em_ipname_lookups = 0;
+static UWord em_ipname_hits = 0;
+
 /*------------------------------------------------------------*/
 /*--- Error type                                           ---*/
 /*------------------------------------------------------------*/
@@ -243,6 +257,11 @@ struct _Supp {
    SuppKind skind;   // What kind of suppression.  Must use the range (0..).
    HChar* string;    // String -- use is optional.  NULL by default.
    void* extra;      // Anything else -- use is optional.  NULL by default.
+
+   /* Search support, see build_supp_index(). */
+   struct _Supp* next_cand; // Next in the same index chain.
+   UInt  seq;       // Load order: later-read suppressions have larger seq.
+   ULong last_use;  // Value of supp_use_ctr when last matched, 0 if never.
 };
 
 SuppKind VG_(get_supp_kind) ( const Supp* su )
@@ -917,20 +936,39 @@ Bool VG_(unique_error) ( ThreadId tid, ErrorKind ekind, Addr a, const HChar* s,
 /*--- Exported fns                                         ---*/
 /*------------------------------------------------------------*/
 
+static Int cmp_Supp_by_last_use ( const void* v1, const void* v2 )
+{
+   const Supp* su1 = *(const Supp*const*)v1;
+   const Supp* su2 = *(const Supp*const*)v2;
+   if (su1->last_use > su2->last_use) return -1;
+   if (su1->last_use < su2->last_use) return 1;
+   return 0;
+}
+
 /* Show the used suppressions.  Returns False if no suppression
    got used. */
 static Bool show_used_suppressions ( void )
 {
    Supp  *su;
    Bool  any_supp;
+   Word  i;
 
    if (VG_(clo_xml))
       VG_(printf_xml)("<suppcounts>\n");
 
-   any_supp = False;
+   /* Show the used suppressions most recently used first. */
+   XArray* used = VG_(newXA)( VG_(malloc), "errormgr.sus.2", VG_(free),
+                              sizeof(Supp*) );
    for (su = suppressions; su != NULL; su = su->next) {
-      if (su->count <= 0)
-         continue;
+      if (su->count > 0)
+         VG_(addToXA)( used, &su );
+   }
+   VG_(setCmpFnXA)( used, cmp_Supp_by_last_use );
+   VG_(sortXA)( used );
+
+   any_supp = False;
+   for (i = 0; i < VG_(sizeXA)( used ); i++) {
+      su = *(Supp**)VG_(indexXA)( used, i );
       if (VG_(clo_xml)) {
          VG_(printf_xml)( "  <pair>\n"
                                  "    <count>%d</count>\n"
@@ -966,6 +1004,8 @@ static Bool show_used_suppressions ( void )
       any_supp = True;
    }
 
+   VG_(deleteXA)( used );
+
    if (VG_(clo_xml))
       VG_(printf_xml)("</suppcounts>\n");
 
@@ -1297,6 +1337,9 @@ static void load_one_suppressions_file ( Int clo_suppressions_i )
       Supp* supp;
       supp        = VG_(malloc)("errormgr.losf.1", sizeof(Supp));
       supp->count = 0;
+      supp->next_cand = NULL;
+      supp->seq       = 0;
+      supp->last_use  = 0;
 
       // Initialise temporary reading-in buffer.
       for (i = 0; i < VG_MAX_SUPP_CALLERS; i++) {
@@ -1441,6 +1484,7 @@ static void load_one_suppressions_file ( Int clo_suppressions_i )
          supp->callers[i] = tmp_callers[i];
       }
 
+      supp->seq  = n_supps_loaded++;
       supp->next = suppressions;
       suppressions = supp;
    }
@@ -1474,6 +1518,7 @@ void VG_(load_suppressions) ( void )
       }
       load_one_suppressions_file( i );
    }
+   build_supp_index();
 }
 
 
@@ -1634,6 +1679,71 @@ static HChar* grow_names(IPtoFunOrObjCompleter* ip2fo, SizeT needed)
    return ip2fo->names + ip2fo->names_free;
 }
 
+/* A cache of IP -> function and object names, shared by all searches,
+   so that frames common to many errors are only looked up once.  The
+   names are copied, since the debuginfo reader hands back transient
+   buffers.  Function names computed with inline info are not cached
+   here, as one IP then gives several names; expandInput computes
+   those itself.  The cache is flushed whenever debug info is loaded
+   or discarded, which VG_(CF_info_generation) tells us about. */
+#define N_IPNAME_CACHE 1021
+
+typedef
+   struct { Addr ip; HChar* fun; HChar* obj; }
+   IPNameCacheEnt;
+
+static IPNameCacheEnt ipname_cache[N_IPNAME_CACHE];
+static UInt ipname_cache_generation = 0;
+
+static void ipname_cache_flush ( void )
+{
+   UWord i;
+   for (i = 0; i < N_IPNAME_CACHE; i++) {
+      if (ipname_cache[i].fun) VG_(free)(ipname_cache[i].fun);
+      if (ipname_cache[i].obj) VG_(free)(ipname_cache[i].obj);
+   }
+   VG_(memset)(ipname_cache, 0, sizeof(ipname_cache));
+}
+
+/* Returns the function name (if needFun) or object name for ip, or
+   "???" if unknown. */
+static const HChar* ipname_cache_get ( Addr ip, Bool needFun )
+{
+   IPNameCacheEnt* ce;
+   HChar**         name;
+   const HChar*    caller;
+
+   em_ipname_lookups++;
+   if (ipname_cache_generation != VG_(CF_info_generation)()) {
+      ipname_cache_flush();
+      ipname_cache_generation = VG_(CF_info_generation)();
+   }
+
+   ce = &ipname_cache[ip % N_IPNAME_CACHE];
+   if (ce->ip != ip) {
+      if (ce->fun) VG_(free)(ce->fun);
+      if (ce->obj) VG_(free)(ce->obj);
+      ce->ip  = ip;
+      ce->fun = NULL;
+      ce->obj = NULL;
+   }
+   name = needFun ? &ce->fun : &ce->obj;
+   if (*name) {
+      em_ipname_hits++;
+      return *name;
+   }
+
+   if (needFun) {
+      if (!VG_(get_fnname_no_cxx_demangle)(ip, &caller, NULL))
+         caller = "???";
+   } else {
+      if (!VG_(get_objname)(ip, &caller))
+         caller = "???";
+   }
+   *name = VG_(strdup)("errormgr.ipnc.1", caller);
+   return *name;
+}
+
 /* foComplete returns the function name or object name for ixInput.
    If needFun, returns the function name for this input
    else returns the object name for this input.
@@ -1671,10 +1781,7 @@ static HChar* foComplete(IPtoFunOrObjCompleter* ip2fo,
          // up comparing "malloc" in the suppression against
          // "_vgrZU_libcZdsoZa_malloc" in the backtrace, and the
          // two of them need to be made to match.
-         if (!VG_(get_fnname_no_cxx_demangle)(ip2fo->ips[ixInput],
-                                              &caller,
-                                              NULL))
-            caller = "???";
+         caller = ipname_cache_get(ip2fo->ips[ixInput], True /*needFun*/);
       } else {
          /* Get the object name into 'caller_name', or "???"
             if unknown. */
@@ -1692,8 +1799,7 @@ static HChar* foComplete(IPtoFunOrObjCompleter* ip2fo,
             last_expand_pos_ips is the last offset in fun/obj where
             ips[pos_ips] has been expanded. */
 
-         if (!VG_(get_objname)(ip2fo->ips[pos_ips], &caller))
-            caller = "???";
+         caller = ipname_cache_get(ip2fo->ips[pos_ips], False /*needFun*/);
 
          // Have all inlined calls pointing at this object name
          for (i = last_expand_pos_ips - ip2fo->n_offsets_per_ip[pos_ips] + 1;
@@ -1909,14 +2015,103 @@ Bool supp_matches_error(const Supp* su, const Error* err)
 
 /////////////////////////////////////////////////////
 
+/* The suppression index.  Most suppressions start with a plain
+   "fun:" or "obj:" line, and then can only match an error whose
+   innermost frame has exactly that name.  Such suppressions are
+   chained in supp_fun_index or supp_obj_index, hashed by that name;
+   all others (first line "...", or containing wildcards) are chained
+   in supp_unindexed.  A search then only needs to look at the chains
+   for the innermost frame's names plus supp_unindexed, rather than at
+   every suppression.  Hash collisions only add candidates; matching
+   is always done in full.
+
+   Suppressions are tried in the order the old move-to-front list
+   gave: most recently matched first, then unmatched ones most
+   recently read first.  Each chain is kept in that order (by moving a
+   matched suppression to the front of its chain), and a search merges
+   the chains, so the suppression chosen for an error is the same as
+   with a single list. */
+#define N_SUPP_INDEX 1021
+
+static Supp* supp_fun_index[N_SUPP_INDEX];
+static Supp* supp_obj_index[N_SUPP_INDEX];
+static Supp* supp_unindexed = NULL;
+static UWord n_supp_fun_indexed = 0;
+static UWord n_supp_obj_indexed = 0;
+
+/* Incremented on each successful match, gives Supp.last_use. */
+static ULong supp_use_ctr = 0;
+
+static UWord supp_index_hash ( const HChar* name )
+{
+   UWord h = 5381;
+   while (*name)
+      h = (h << 5) + h + (UChar)*name++;
+   return h % N_SUPP_INDEX;
+}
+
+/* Does su1 come before su2 in search order? */
+static inline Bool supp_searched_before ( const Supp* su1, const Supp* su2 )
+{
+   if (su1->last_use != su2->last_use)
+      return su1->last_use > su2->last_use;
+   return su1->seq > su2->seq;
+}
+
+static void build_supp_index ( void )
+{
+   Supp*   su;
+   Supp*** tails;
+   Supp**  tail;
+   UWord   i;
+
+   tails = VG_(malloc)("errormgr.bsi.1",
+                       (2 * N_SUPP_INDEX + 1) * sizeof(Supp**));
+
+   for (i = 0; i < N_SUPP_INDEX; i++) {
+      supp_fun_index[i] = NULL;
+      supp_obj_index[i] = NULL;
+      tails[i] = &supp_fun_index[i];
+      tails[N_SUPP_INDEX + i] = &supp_obj_index[i];
+   }
+   supp_unindexed = NULL;
+   tails[2 * N_SUPP_INDEX] = &supp_unindexed;
+   n_supp_fun_indexed = n_supp_obj_indexed = 0;
+
+   /* 'suppressions' is in search order already, so appending keeps
+      each chain in search order too. */
+   for (su = suppressions; su != NULL; su = su->next) {
+      const SuppLoc* first = &su->callers[0];
+      if (first->ty == FunName && first->name_is_simple_str) {
+         i = supp_index_hash(first->name);
+         n_supp_fun_indexed++;
+      } else if (first->ty == ObjName && first->name_is_simple_str) {
+         i = N_SUPP_INDEX + supp_index_hash(first->name);
+         n_supp_obj_indexed++;
+      } else {
+         i = 2 * N_SUPP_INDEX;
+      }
+      tail = tails[i];
+      su->next_cand = NULL;
+      *tail = su;
+      tails[i] = &su->next_cand;
+   }
+   VG_(free)(tails);
+}
+
 /* Does an error context match a suppression?  ie is this a suppressible
    error?  If so, return a pointer to the Supp record, otherwise NULL.
    Tries to minimise the number of symbol searches since they are expensive.  
 */
 static Supp* is_suppressible_error ( const Error* err )
 {
-   Supp* su;
-   Supp* su_prev;
+   Supp*  su;
+   /* The chains to search: function index, object index, unindexed. */
+   Supp** heads[3];
+   Supp*  cur[3];
+   Supp*  prev[3];
+   Int    i, k;
+   ULong  start_us;
 
    IPtoFunOrObjCompleter ip2fo;
    /* Conceptually, ip2fo contains an array of function names and an array of
@@ -1935,6 +2130,7 @@ static Supp* is_suppressible_error ( const Error* err )
 
    /* stats gathering */
    em_supplist_searches++;
+   start_us = VG_(read_microsecond_timer)();
 
    /* Prepare the lazy input completer. */
    ip2fo.ips = VG_(get_ExeContext_StackTrace)(err->where);
@@ -1949,31 +2145,60 @@ static Supp* is_suppressible_error ( const Error* err )
    ip2fo.names_szB = 0;
    ip2fo.names_free = 0;
 
+   /* Find the candidate chains from the innermost frame's names. */
+   heads[0] = heads[1] = NULL;
+   heads[2] = &supp_unindexed;
+   if ((n_supp_fun_indexed > 0 || n_supp_obj_indexed > 0)
+       && haveInputInpC(&ip2fo, 0)) {
+      if (n_supp_fun_indexed > 0)
+         heads[0] = &supp_fun_index
+                       [supp_index_hash(foComplete(&ip2fo, 0, True))];
+      if (n_supp_obj_indexed > 0)
+         heads[1] = &supp_obj_index
+                       [supp_index_hash(foComplete(&ip2fo, 0, False))];
+   }
+   for (k = 0; k < 3; k++) {
+      cur[k]  = heads[k] ? *heads[k] : NULL;
+      prev[k] = NULL;
+   }
+
    /* See if the error context matches any suppression. */
    if (DEBUG_ERRORMGR || VG_(debugLog_getLevel)() >= 4)
      VG_(dmsg)("errormgr matching begin\n");
-   su_prev = NULL;
-   for (su = suppressions; su != NULL; su = su->next) {
+   while (True) {
+      /* Take the next candidate in search order from the chains. */
+      k = -1;
+      for (i = 0; i < 3; i++) {
+         if (cur[i] && (k == -1 || supp_searched_before(cur[i], cur[k])))
+            k = i;
+      }
+      if (k == -1)
+         break;
+      su = cur[k];
       em_supplist_cmps++;
       if (supp_matches_error(su, err) 
           && supp_matches_callers(&ip2fo, su)) {
          /* got a match.  */
          /* Inform the tool that err is suppressed by su. */
          (void)VG_TDICT_CALL(tool_update_extra_suppression_use, err, su);
-         /* Move this entry to the head of the list
+         /* Move this entry to the head of its chain
             in the hope of making future searches cheaper. */
-         if (su_prev) {
-            vg_assert(su_prev->next == su);
-            su_prev->next = su->next;
-            su->next = suppressions;
-            suppressions = su;
+         su->last_use = ++supp_use_ctr;
+         if (prev[k]) {
+            vg_assert(prev[k]->next_cand == su);
+            prev[k]->next_cand = su->next_cand;
+            su->next_cand = *heads[k];
+            *heads[k] = su;
          }
          clearIPtoFunOrObjCompleter(su, &ip2fo);
+         em_supplist_usecs += VG_(read_microsecond_timer)() - start_us;
          return su;
       }
-      su_prev = su;
+      prev[k] = su;
+      cur[k]  = su->next_cand;
    }
    clearIPtoFunOrObjCompleter(NULL, &ip2fo);
+   em_supplist_usecs += VG_(read_microsecond_timer)() - start_us;
    return NULL;      /* no matches */
 }
 
@@ -1985,6 +2210,16 @@ void VG_(print_errormgr_stats) ( void )
       " errormgr: %'lu supplist searches, %'lu comparisons during search\n",
       em_supplist_searches, em_supplist_cmps
    );
+   VG_(dmsg)(
+      " errormgr: %'u suppressions (%'lu fun-indexed, %'lu obj-indexed),"
+      " %'llu us matching\n",
+      n_supps_loaded, n_supp_fun_indexed, n_supp_obj_indexed,
+      em_supplist_usecs
+   );
+   VG_(dmsg)(
+      " errormgr: %'lu IP name lookups, %'lu cache hits\n",
+      em_ipname_lookups, em_ipname_hits
+   );
    VG_(dmsg)(
       " errormgr: %'lu errlist searches, %'lu comparisons during search\n",
       em_errlist_searches, em_errlist_cmps
@@ -42,6 +42,7 @@
 #include "pub_core_syscall.h"
 #include "pub_core_xarray.h"
 #include "pub_core_clientstate.h"
+#include "pub_core_aspacemgr.h"  // For VG_(am_mmap_anon_float_valgrind)
 
 #if defined(VGO_darwin)
 /* --- !!! --- EXTERNAL HEADERS start --- !!! --- */
@@ -634,9 +635,8 @@ Int VG_(fork) ( void )
    Timing stuff
    ------------------------------------------------------------------ */
 
-UInt VG_(read_millisecond_timer) ( void )
+ULong VG_(read_microsecond_timer) ( void )
 {
-   /* 'now' and 'base' are in microseconds */
    static ULong base = 0;
    ULong  now;
 
@@ -675,7 +675,12 @@ UInt VG_(read_millisecond_timer) ( void )
    if (base == 0)
       base = now;
 
-   return (now - base) / 1000;
+   return now - base;
+}
+
+UInt VG_(read_millisecond_timer) ( void )
+{
+   return VG_(read_microsecond_timer)() / 1000;
 }
 
 Int VG_(gettimeofday)(struct vki_timeval *tv, struct vki_timezone *tz)
@@ -693,6 +698,136 @@ Int VG_(gettimeofday)(struct vki_timeval *tv, struct vki_timezone *tz)
 }
 
 
+/* ---------------------------------------------------------------------
+   Host helper threads
+   ------------------------------------------------------------------ */
+
+/* Helper threads are raw clone()s sharing Valgrind's address space.
+   They are unknown to the scheduler and to m_signals, so they run
+   with every signal blocked and only for the duration of one
+   VG_(run_on_helper_threads) call.  The clone helpers live in
+   m_syswrap; only x86/amd64 Linux is supported for now. */
+
+#if defined(VGO_linux) && defined(VGA_amd64)
+extern Long do_syscall_clone_amd64_linux ( Word (*fn)(void *),
+                                           void* stack, Long flags,
+                                           void* arg, Long* child_tid,
+                                           Long* parent_tid,
+                                           vki_modify_ldt_t * );
+#  define HAVE_HELPER_THREADS 1
+#elif defined(VGO_linux) && defined(VGA_x86)
+extern Int do_syscall_clone_x86_linux ( Word (*fn)(void *),
+                                        void* stack, Int flags,
+                                        void* arg, Int* child_tid,
+                                        Int* parent_tid,
+                                        vki_modify_ldt_t * );
+#  define HAVE_HELPER_THREADS 1
+#endif
+
+#if defined(HAVE_HELPER_THREADS)
+
+#define HELPER_STACK_SZB (256 * 1024)
+
+typedef
+   struct {
+      void (*fn)(void*);
+      void* arg;
+      /* Set to the child's tid by the kernel before clone returns,
+         cleared (and futex-woken) when the child exits.  Not a Long
+         on amd64: the kernel only ever writes an int here. */
+      Int   tid;
+      Addr  stack;
+   }
+   HelperThread;
+
+static Word helper_thread_main ( void* v )
+{
+   HelperThread* ht = (HelperThread*)v;
+   ht->fn(ht->arg);
+   return 0;
+}
+
+#endif
+
+UInt VG_(run_on_helper_threads) ( UInt n_threads,
+                                  void (*fn)(void*), void* arg )
+{
+#  if defined(HAVE_HELPER_THREADS)
+   const UInt flags = VKI_CLONE_VM | VKI_CLONE_FS | VKI_CLONE_FILES
+                      | VKI_CLONE_SIGHAND | VKI_CLONE_THREAD
+                      | VKI_CLONE_SYSVSEM | VKI_CLONE_PARENT_SETTID
+                      | VKI_CLONE_CHILD_CLEARTID;
+   HelperThread* hts;
+   vki_sigset_t  all, saved;
+   UInt          i, n_started = 0;
+
+   if (n_threads > VG_MAX_HELPER_THREADS)
+      n_threads = VG_MAX_HELPER_THREADS;
+   if (n_threads <= 1) {
+      fn(arg);
+      return 1;
+   }
+
+   hts = VG_(malloc)("libcproc.roht.1", (n_threads-1) * sizeof(HelperThread));
+
+   /* The children inherit this mask, so they never take signals. */
+   VG_(sigfillset)(&all);
+   VG_(sigprocmask)(VKI_SIG_SETMASK, &all, &saved);
+
+   for (i = 0; i < n_threads-1; i++) {
+      HelperThread* ht = &hts[n_started];
+      SysRes sres = VG_(am_mmap_anon_float_valgrind)(HELPER_STACK_SZB);
+      Word   res;
+      if (sr_isError(sres))
+         break;
+      ht->fn    = fn;
+      ht->arg   = arg;
+      ht->tid   = 0;
+      ht->stack = sr_Res(sres);
+#     if defined(VGA_amd64)
+      res = do_syscall_clone_amd64_linux(
+               helper_thread_main, (void*)(ht->stack + HELPER_STACK_SZB),
+               flags, ht, (Long*)&ht->tid, (Long*)&ht->tid, NULL);
+#     else
+      res = do_syscall_clone_x86_linux(
+               helper_thread_main, (void*)(ht->stack + HELPER_STACK_SZB),
+               flags, ht, &ht->tid, &ht->tid, NULL);
+#     endif
+      if (res < 0) {
+         VG_(am_munmap_valgrind)(ht->stack, HELPER_STACK_SZB);
+         break;
+      }
+      n_started++;
+   }
+
+   fn(arg);
+
+   for (i = 0; i < n_started; i++) {
+      HelperThread* ht = &hts[i];
+      Int tid;
+      while ((tid = *(volatile Int*)&ht->tid) != 0)
+         VG_(do_syscall4)(__NR_futex, (UWord)&ht->tid, VKI_FUTEX_WAIT,
+                          tid, 0);
+      VG_(am_munmap_valgrind)(ht->stack, HELPER_STACK_SZB);
+   }
+
+   VG_(sigprocmask)(VKI_SIG_SETMASK, &saved, NULL);
+   VG_(free)(hts);
+   return n_started + 1;
+#  else
+   fn(arg);
+   return 1;
+#  endif
+}
+
+void VG_(helper_thread_yield) ( void )
+{
+#  if defined(HAVE_HELPER_THREADS)
+   VG_(do_syscall0)(__NR_sched_yield);
+#  endif
+}
+
+
 /* ---------------------------------------------------------------------
    atfork()
    ------------------------------------------------------------------ */
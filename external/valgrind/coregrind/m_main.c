@@ -62,6 +62,7 @@
 #include "pub_core_stacks.h"        // For VG_(register_stack)
 #include "pub_core_syswrap.h"
 #include "pub_core_tooliface.h"
+#include "pub_core_transcache.h"
 #include "pub_core_translate.h"     // For VG_(translate)
 #include "pub_core_trampoline.h"
 #include "pub_core_transtab.h"
@@ -163,6 +164,10 @@ static void usage_NORETURN ( Bool debug_help )
 "    --allow-mismatched-debuginfo=no|yes  [no]\n"
 "                              for the above two flags only, accept debuginfo\n"
 "                              objects that don't \"match\" the main object\n"
+"    --lazy-debuginfo=no|yes   read line, inline and variable info only when\n"
+"                              first needed [yes]\n"
+"    --debuginfo-cache-dir=<dir>  keep parsed line and inline info in <dir>,\n"
+"                              keyed by build-id, for later runs\n"
 "    --smc-check=none|stack|all|all-non-file [stack]\n"
 "                              checks for self-modifying code: none, only for\n"
 "                              code found in stacks, for all code, or for all\n"
@@ -184,6 +189,13 @@ static void usage_NORETURN ( Bool debug_help )
 "           lax-ioctls fuse-compatible enable-outer\n"
 "           no-inner-prefix no-nptl-pthread-stackcache none\n"
 "    --fair-sched=no|yes|try   schedule threads fairly on multicore systems [no]\n"
+"    --parallel-threads=no|yes run threads concurrently if the tool allows\n"
+"                              it (implies --vgdb=no) [no]\n"
+"    --translation-cache-dir=<dir>  reuse translations made by earlier runs,\n"
+"                              stored in <dir> (implies --vgdb=no) [none]\n"
+"    --tier-up-threshold=<number>  translate blocks again, with more\n"
+"                              optimisation, once they have run <number>\n"
+"                              times [0, meaning never]\n"
 "    --kernel-variant=variant1,variant2,...\n"
 "         handle non-standard kernel variants [none]\n"
 "         where variant is one of:\n"
@@ -195,6 +207,10 @@ static void usage_NORETURN ( Bool debug_help )
 "           more sectors may increase performance, but use more memory.\n"
 "    --avg-transtab-entry-size=<number> avg size in bytes of a translated\n"
 "           basic block [0, meaning use tool provided default]\n"
+"    --tt-fast-ways=<number>   associativity of the translation lookup\n"
+"           cache, 1 .. 8 [2]\n"
+"    --keep-hot-translations=no|yes  keep hot translations when their\n"
+"           sector of the translated code cache is recycled [yes]\n"
 "    --aspace-minaddr=0xPP     avoid mapping memory below 0xPP [guessed]\n"
 "    --valgrind-stacksize=<number> size of valgrind (host) thread's stack\n"
 "                               (in bytes) ["
@@ -252,11 +268,12 @@ static void usage_NORETURN ( Bool debug_help )
 "\n"
 "  Vex options for all Valgrind tools:\n"
 "    --vex-iropt-verbosity=<0..9>           [0]\n"
-"    --vex-iropt-level=<0..2>               [2]\n"
+"    --vex-iropt-level=<0..3>               [2]\n"
 "    --vex-iropt-unroll-thresh=<0..400>     [120]\n"
 "    --vex-guest-max-insns=<1..100>         [50]\n"
 "    --vex-guest-chase-thresh=<0..99>       [10]\n"
 "    --vex-guest-chase-cond=no|yes          [no]\n"
+"    --vex-regalloc-version=2|3             [2]\n"
 "    Precise exception control.  Possible values for 'mode' are as follows\n"
 "      and specify the minimum set of registers guaranteed to be correct\n"
 "      immediately prior to memory access instructions:\n"
@@ -667,6 +684,12 @@ void main_process_cmd_line_options ( /*OUT*/Bool* logging_to_fd,
             VG_(fmsg_bad_option)(arg,
                "Bad argument, should be 'yes', 'try' or 'no'\n");
       }
+      else if VG_BOOL_CLO(arg, "--parallel-threads",
+                            VG_(clo_parallel_threads)) {}
+      else if VG_STR_CLO (arg, "--translation-cache-dir",
+                            VG_(clo_translation_cache_dir)) {}
+      else if VG_BINT_CLO(arg, "--tier-up-threshold",
+                            VG_(clo_tier_up_threshold), 0, 1000000000) {}
       else if VG_BOOL_CLO(arg, "--trace-sched",      VG_(clo_trace_sched)) {}
       else if VG_BOOL_CLO(arg, "--trace-signals",    VG_(clo_trace_signals)) {}
       else if VG_BOOL_CLO(arg, "--trace-symtab",     VG_(clo_trace_symtab)) {}
@@ -698,6 +721,10 @@ void main_process_cmd_line_options ( /*OUT*/Bool* logging_to_fd,
       else if VG_BINT_CLO(arg, "--avg-transtab-entry-size",
                                VG_(clo_avg_transtab_entry_size),
                                50, 5000) {}
+      else if VG_BINT_CLO(arg, "--tt-fast-ways",
+                               VG_(clo_tt_fast_ways), 1, MAX_TT_FAST_WAYS) {}
+      else if VG_BOOL_CLO(arg, "--keep-hot-translations",
+                               VG_(clo_keep_hot_translations)) {}
       else if VG_BINT_CLO(arg, "--merge-recursive-frames",
                                VG_(clo_merge_recursive_frames), 0,
                                VG_DEEPEST_BACKTRACE) {}
@@ -728,7 +755,7 @@ void main_process_cmd_line_options ( /*OUT*/Bool* logging_to_fd,
       else if VG_BINT_CLO(arg, "--vex-iropt-verbosity",
                        VG_(clo_vex_control).iropt_verbosity, 0, 10) {}
       else if VG_BINT_CLO(arg, "--vex-iropt-level",
-                       VG_(clo_vex_control).iropt_level, 0, 2) {}
+                       VG_(clo_vex_control).iropt_level, 0, 3) {}
 
       else if VG_STRINDEX_CLO(arg, "--vex-iropt-register-updates",
                                    pxStrings, ix) {
@@ -762,6 +789,8 @@ void main_process_cmd_line_options ( /*OUT*/Bool* logging_to_fd,
                        VG_(clo_vex_control).guest_chase_thresh, 0, 99) {}
       else if VG_BOOL_CLO(arg, "--vex-guest-chase-cond",
                        VG_(clo_vex_control).guest_chase_cond) {}
+      else if VG_BINT_CLO(arg, "--vex-regalloc-version",
+                       VG_(clo_vex_control).regalloc_version, 2, 3) {}
 
       else if VG_INT_CLO(arg, "--log-fd", tmp_log_fd) {
          log_to = VgLogTo_Fd;
@@ -792,6 +821,12 @@ void main_process_cmd_line_options ( /*OUT*/Bool* logging_to_fd,
       else if VG_BOOL_CLO(arg, "--allow-mismatched-debuginfo",
                                VG_(clo_allow_mismatched_debuginfo)) {}
 
+      else if VG_BOOL_CLO(arg, "--lazy-debuginfo",
+                               VG_(clo_lazy_debuginfo)) {}
+
+      else if VG_STR_CLO(arg, "--debuginfo-cache-dir",
+                              VG_(clo_debuginfo_cache_dir)) {}
+
       else if VG_STR_CLO(arg, "--xml-user-comment",
                               VG_(clo_xml_user_comment)) {}
 
@@ -974,6 +1009,31 @@ void main_process_cmd_line_options ( /*OUT*/Bool* logging_to_fd,
       /*NOTREACHED*/
    }
 
+   /* Parallel execution relies on the dispatcher's tt_fast lookup
+      being safe against concurrent updates, which is only arranged
+      for the TSO (x86 and amd64) Linux dispatchers.  gdbserver needs
+      every thread to be stoppable at any instruction, so turn it off
+      rather than give the user something that half works. */
+   if (VG_(clo_parallel_threads)) {
+#     if !defined(VGP_x86_linux) && !defined(VGP_amd64_linux)
+      VG_(fmsg_bad_option)("--parallel-threads=yes",
+         "--parallel-threads=yes is only available on x86 and amd64 Linux.\n");
+#     endif
+      if (VG_(clo_vgdb) == Vg_VgdbFull)
+         VG_(fmsg_bad_option)("--parallel-threads=yes",
+            "--parallel-threads=yes cannot be used with --vgdb=full.\n");
+      VG_(clo_vgdb) = Vg_VgdbNo;
+   }
+
+   /* Cached translations are made without gdbserver's help, so they
+      can't honour breakpoints set later on. */
+   if (VG_(clo_translation_cache_dir)) {
+      if (VG_(clo_vgdb) == Vg_VgdbFull)
+         VG_(fmsg_bad_option)("--translation-cache-dir",
+            "--translation-cache-dir cannot be used with --vgdb=full.\n");
+      VG_(clo_vgdb) = Vg_VgdbNo;
+   }
+
    vg_assert( VG_(clo_gen_suppressions) >= 0 );
    vg_assert( VG_(clo_gen_suppressions) <= 2 );
 
@@ -2120,6 +2180,12 @@ Int valgrind_main ( Int argc, HChar **argv, HChar **envp )
          VG_(core_panic)(s);
       }
    }
+   if (VG_(clo_parallel_threads) && !VG_(needs).parallel_threads) {
+      VG_(fmsg_bad_option)("--parallel-threads=yes",
+         "%s cannot run threads in parallel with the options given.\n",
+         VG_(details).name);
+   }
+   VG_(transcache_init)();
 
    //--------------------------------------------------------------
    // Initialise translation table and translation cache
@@ -2626,6 +2692,9 @@ void shutdown_actions_NORETURN( ThreadId tid,
 
    VG_(sanity_check_general)( True /*include expensive checks*/ );
 
+   /* Save any new translations for the next run. */
+   VG_(transcache_flush)();
+
    if (VG_(clo_stats))
       VG_(print_all_stats)(VG_(clo_verbosity) >= 1, /* Memory stats */
                            False /* tool prints stats in the tool fini */);
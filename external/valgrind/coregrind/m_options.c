@@ -91,6 +91,8 @@ XArray *VG_(clo_fullpath_after); // array of strings
 const HChar* VG_(clo_extra_debuginfo_path) = NULL;
 const HChar* VG_(clo_debuginfo_server) = NULL;
 Bool   VG_(clo_allow_mismatched_debuginfo) = False;
+Bool   VG_(clo_lazy_debuginfo) = True;
+const HChar* VG_(clo_debuginfo_cache_dir) = NULL;
 UChar  VG_(clo_trace_flags)    = 0; // 00000000b
 Bool   VG_(clo_profyle_sbs)    = False;
 UChar  VG_(clo_profyle_flags)  = 0; // 00000000b
@@ -108,6 +110,9 @@ Bool   VG_(clo_debug_dump_frames) = False;
 Bool   VG_(clo_trace_redir)    = False;
 enum FairSchedType
        VG_(clo_fair_sched)     = disable_fair_sched;
+Bool   VG_(clo_parallel_threads) = False;
+const HChar* VG_(clo_translation_cache_dir) = NULL;
+UInt   VG_(clo_tier_up_threshold) = 0;
 Bool   VG_(clo_trace_sched)    = False;
 Bool   VG_(clo_profile_heap)   = False;
 Int    VG_(clo_core_redzone_size) = CORE_REDZONE_DEFAULT_SZB;
@@ -111,6 +111,17 @@
 /* If False, a fault is Valgrind-internal (ie, a bug) */
 Bool VG_(in_generated_code) = False;
 
+/* Number of threads currently running generated code without the
+   big lock (--parallel-threads=yes).  Only incremented by the lock
+   holder, so once the lock holder has seen it reach zero it stays
+   there until the lock is dropped. */
+static volatile Int n_parallel_runs = 0;
+
+/* Bumped each time VG_(wait_for_parallel_runs) returns, that is, each
+   time the lock holder may have patched or thrown away translations
+   behind the backs of threads that had left generated code. */
+static volatile UInt parallel_stop_gen = 0;
+
 /* 64-bit counter for the number of basic blocks done. */
 static ULong bbs_done = 0;
 
@@ -454,6 +465,65 @@ void VG_(vg_yield)(void)
 }
 
 
+/* --parallel-threads=yes: give up the lock for the duration of a run
+   of generated code.  The thread appears to the rest of the system as
+   if it were waiting for the lock, which is what it will be doing
+   when it next needs to interact with the core. */
+static void begin_parallel_run ( ThreadId tid )
+{
+   ThreadState *tst = VG_(get_ThreadState)(tid);
+
+   vg_assert(!tst->in_parallel_run);
+   vg_assert(VG_(in_generated_code));
+   VG_(in_generated_code) = False;
+
+   __sync_fetch_and_add(&n_parallel_runs, 1);
+   tst->in_parallel_run = True;
+   VG_(release_BigLock)(tid, VgTs_Yielding, "begin_parallel_run");
+}
+
+/* See pub_core_scheduler.h for description */
+void VG_(end_parallel_run) ( ThreadId tid )
+{
+   ThreadState *tst = VG_(get_ThreadState)(tid);
+
+   if (!tst->in_parallel_run)
+      return;
+
+   /* Stop counting ourselves before blocking on the lock, since its
+      holder may be waiting for us to leave generated code. */
+   __sync_fetch_and_sub(&n_parallel_runs, 1);
+   VG_(acquire_BigLock)(tid, "end_parallel_run");
+   tst->in_parallel_run = False;
+
+   vg_assert(!VG_(in_generated_code));
+   VG_(in_generated_code) = True;
+}
+
+/* See pub_core_scheduler.h for description */
+void VG_(wait_for_parallel_runs) ( void )
+{
+   ThreadId tid;
+
+   if (!VG_(clo_parallel_threads))
+      return;
+
+   while (n_parallel_runs > 0) {
+      /* Zeroing the event counter makes the thread bail out at the
+         next block boundary instead of at the end of its timeslice.
+         The store can be lost against the thread's own decrement,
+         so keep doing it until everybody has gone. */
+      for (tid = 1; tid < VG_N_THREADS; tid++) {
+         if (VG_(threads)[tid].in_parallel_run)
+            VG_(threads)[tid].arch.vex.host_EvC_COUNTER = 0;
+      }
+      VG_(do_syscall0)(__NR_sched_yield);
+   }
+   __sync_synchronize();
+   parallel_stop_gen++;
+}
+
+
 /* Set the standard set of blocked signals, used whenever we're not
    running a client syscall. */
 static void block_signals(void)
@@ -530,6 +600,7 @@ void mostly_clear_thread_record ( ThreadId tid )
    VG_(clear_out_queued_signals)(tid, &savedmask);
 
    VG_(threads)[tid].sched_jmpbuf_valid = False;
+   VG_(threads)[tid].in_parallel_run = False;
 }
 
 /*                                                                             
@@ -571,6 +642,10 @@ static void sched_fork_cleanup(ThreadId me)
       }
    }
 
+   /* Threads which were running in parallel in the parent don't
+      exist here. */
+   n_parallel_runs = 0;
+
    /* re-init and take the sema */
    deinit_BigLock();
    init_BigLock();
@@ -847,6 +922,7 @@ void run_thread_for_a_while ( /*OUT*/HWord* two_words,
    volatile ThreadState* tst            = NULL; /* stop gcc complaining */
    volatile Int          done_this_time = 0;
    volatile HWord        host_code_addr = 0;
+   volatile UInt         stop_gen       = 0;
 
    /* Paranoia */
    vg_assert(VG_(is_valid_tid)(tid));
@@ -858,9 +934,12 @@ void run_thread_for_a_while ( /*OUT*/HWord* two_words,
    do_pre_run_checks( tst );
    /* end Paranoia */
 
-   /* Futz with the XIndir stats counters. */
-   vg_assert(VG_(stats__n_xindirs_32) == 0);
-   vg_assert(VG_(stats__n_xindir_misses_32) == 0);
+   /* Futz with the XIndir stats counters.  Threads running in
+      parallel may bump them at any time. */
+   if (!VG_(clo_parallel_threads)) {
+      vg_assert(VG_(stats__n_xindirs_32) == 0);
+      vg_assert(VG_(stats__n_xindir_misses_32) == 0);
+   }
 
    /* Clear return area. */
    two_words[0] = two_words[1] = 0;
@@ -925,6 +1004,9 @@ void run_thread_for_a_while ( /*OUT*/HWord* two_words,
    vg_assert(VG_(in_generated_code) == False);
    VG_(in_generated_code) = True;
 
+   if (VG_(clo_parallel_threads))
+      begin_parallel_run(tid);
+
    SCHEDSETJMP(
       tid, 
       jumped, 
@@ -935,6 +1017,24 @@ void run_thread_for_a_while ( /*OUT*/HWord* two_words,
       )
    );
 
+   /* If we got here by longjmp, the signal handler has already taken
+      the lock back. */
+   stop_gen = parallel_stop_gen;
+   VG_(end_parallel_run)(tid);
+
+   /* A chain-me request is stale if the world was stopped between us
+      leaving generated code and getting the lock back: the block to
+      be patched may since have been patched, or thrown away and its
+      space reused.  Fall back to an ordinary lookup; the block will
+      ask again next time round. */
+   if (VG_(clo_parallel_threads)
+       && (two_words[0] == VG_TRC_CHAIN_ME_TO_SLOW_EP
+           || two_words[0] == VG_TRC_CHAIN_ME_TO_FAST_EP)
+       && stop_gen != parallel_stop_gen) {
+      two_words[0] = VG_TRC_INNER_FASTMISS;
+      two_words[1] = 0;
+   }
+
    vg_assert(VG_(in_generated_code) == True);
    VG_(in_generated_code) = False;
 
@@ -1618,6 +1718,10 @@ VgSchedReturnCode VG_(scheduler) ( ThreadId tid )
 
       } /* switch (trc) */
 
+      if (UNLIKELY(VG_(clo_tier_up_threshold) > 0)
+          && !VG_(is_exiting)(tid))
+         VG_(translate_hot_blocks)(tid, bbs_done);
+
       if (UNLIKELY(VG_(clo_profyle_sbs)) && VG_(clo_profyle_interval) > 0)
          maybe_show_sb_profile();
    }
@@ -2560,6 +2560,10 @@ void sync_signalhandler ( Int sigNo,
    ThreadId tid = VG_(lwpid_to_vgtid)(VG_(gettid)());
    Bool from_user;
 
+   /* A fault in generated code run under --parallel-threads=yes has
+      to be handled holding the lock, like everything else. */
+   VG_(end_parallel_run)(tid);
+
    if (0) 
       VG_(printf)("sync_sighandler(%d, %p, %p)\n", sigNo, info, uc);
 
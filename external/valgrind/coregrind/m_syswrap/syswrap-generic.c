@@ -39,6 +39,7 @@
 #include "pub_core_debuginfo.h"     // VG_(di_notify_*)
 #include "pub_core_aspacemgr.h"
 #include "pub_core_transtab.h"      // VG_(discard_translations)
+#include "pub_core_transcache.h"    // VG_(transcache_flush)
 #include "pub_core_xarray.h"
 #include "pub_core_clientstate.h"   // VG_(brk_base), VG_(brk_limit)
 #include "pub_core_debuglog.h"
@@ -2791,6 +2792,9 @@ PRE(sys_execve)
       VG_(gdbserver) (0);
    }
 
+   // Whatever we translated is lost once the exec succeeds.
+   VG_(transcache_flush)();
+
    /* Resistance is futile.  Nuke all other threads.  POSIX mandates
       this. (Really, nuke them all, since the new process will make
       its own new thread.) */
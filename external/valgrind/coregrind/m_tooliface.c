@@ -98,7 +98,9 @@ VgNeeds VG_(needs) = {
    .var_info	         = False,
    .malloc_replacement   = False,
    .xml_output           = False,
-   .final_IR_tidy_pass   = False
+   .final_IR_tidy_pass   = False,
+   .parallel_threads     = False,
+   .cacheable_translations = False
 };
 
 /* static */
@@ -218,6 +220,8 @@ Bool VG_(sanity_check_needs)(const HChar** failmsg)
 NEEDS(libc_freeres)
 NEEDS(core_errors)
 NEEDS(var_info)
+NEEDS(parallel_threads)
+NEEDS(cacheable_translations)
 
 void VG_(needs_superblock_discards)(
    void (*discard)(Addr, VexGuestExtents)
@@ -0,0 +1,671 @@
+
+/*--------------------------------------------------------------------*/
+/*--- The persistent translation cache.             m_transcache.c ---*/
+/*--------------------------------------------------------------------*/
+
+/*
+   This file is part of Valgrind, a dynamic binary instrumentation
+   framework.
+
+   Copyright (C) 2000-2013 Julian Seward
+      jseward@acm.org
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2 of the
+   License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+   02111-1307, USA.
+
+   The GNU General Public License is contained in the file COPYING.
+*/
+
+#include "pub_core_basics.h"
+#include "pub_core_vki.h"
+#include "pub_core_aspacemgr.h"
+#include "pub_core_clientstate.h"  // VG_(args_for_valgrind)
+#include "pub_core_debuginfo.h"
+#include "pub_core_hashtable.h"
+#include "pub_core_libcbase.h"
+#include "pub_core_libcassert.h"
+#include "pub_core_libcfile.h"
+#include "pub_core_libcprint.h"
+#include "pub_core_libcproc.h"     // VG_(getpid)
+#include "pub_core_machine.h"      // VG_(machine_get_VexArchInfo)
+#include "pub_core_mallocfree.h"
+#include "pub_core_options.h"
+#include "pub_core_tooliface.h"
+#include "pub_core_xarray.h"
+#include "pub_core_transcache.h"
+
+
+/*------------------------------------------------------------*/
+/*--- Overview                                             ---*/
+/*------------------------------------------------------------*/
+
+/* Translations made by VEX are a function of the guest bytes, the
+   guest addresses they came from, the command line, the host CPU and
+   the tool executable (whose helpers and dispatcher entry points are
+   called by absolute address).  The host code itself is position
+   independent -- it is built in a temporary buffer and memcpy'd into
+   the TC -- and is stored here before any chaining has been applied
+   to it.
+
+   So, for each ELF object that has a build-id, we keep one file per
+   (configuration, build-id, text bias):
+
+      <dir>/<fingerprint>-<build-id>-<bias>.vgtc
+
+   where the fingerprint covers everything listed above except the
+   guest code.  The bias has to be part of the key since guest
+   addresses end up as constants in the generated code; in practice
+   aspacem places objects at the same addresses from run to run, so
+   this costs little.  Within a file, translations are keyed by their
+   offset from the bias.
+
+   A stored translation is only reused if a checksum of its guest
+   bytes still matches, and m_translate additionally checks that it
+   would have made the same chasing and self-check decisions today.
+   Tools declare that their instrumentation is reproducible in this
+   way with VG_(needs_cacheable_translations); for anything else the
+   cache stays off.
+
+   Files are read lazily, the first time code from the object is
+   translated, and written back in one go at exit (or execve) via a
+   temporary file and rename, so concurrent runs never see a
+   partially written file; the last writer wins. */
+
+
+/*------------------------------------------------------------*/
+/*--- On-disk format                                       ---*/
+/*------------------------------------------------------------*/
+
+#define TC_MAGIC   "VGTCACHE"
+#define TC_VERSION 2
+
+typedef
+   struct {
+      UChar magic[8];
+      UInt  version;
+      UInt  n_recs;
+      ULong fingerprint;
+      ULong bias;
+   }
+   TCHeader;
+
+/* One of these, followed by code_len bytes of code padded to a
+   multiple of 8, per translation.  The checksum covers the record
+   (with the checksum field zero) and the code. */
+typedef
+   struct {
+      ULong  checksum;
+      ULong  offset;       /* entry point, relative to the bias */
+      ULong  guest_hash;
+      ULong  base[3];      /* extents, relative to the bias */
+      UInt   sc_bitset;
+      UInt   px;
+      UInt   n_guest_instrs;
+      UShort is_self_checking;
+      UShort n_used;
+      UShort len[3];
+      UShort code_len;
+   }
+   TCRecord;
+
+STATIC_ASSERT(sizeof(TCHeader) == 32);
+STATIC_ASSERT(sizeof(TCRecord) == 72);
+
+#define ROUNDUP8(_n) (((_n) + 7) & ~7)
+
+/* 60000: should agree with N_TMPBUF in m_translate.c and the
+   assertion in VG_(add_to_transtab). */
+#define TC_MAX_CODE_LEN 60000
+
+
+/*------------------------------------------------------------*/
+/*--- In-memory state                                      ---*/
+/*------------------------------------------------------------*/
+
+typedef
+   struct _TCNode {
+      struct _TCNode* next;
+      UWord           key;     /* == rec.offset */
+      TCRecord        rec;
+      UChar           code[0];
+   }
+   TCNode;
+
+typedef
+   struct {
+      HChar*       buildid;
+      PtrdiffT     bias;
+      VgHashTable* tab;        /* of TCNode */
+      Bool         dirty;
+   }
+   TCObject;
+
+static Bool     tc_enabled = False;
+static ULong    tc_fingerprint = 0;
+static XArray*  tc_objects = NULL;   /* of TCObject* */
+static TCObject* tc_last_obj = NULL;
+
+/* Stats. */
+static ULong n_tc_loaded  = 0;
+static ULong n_tc_hits    = 0;
+static ULong n_tc_misses  = 0;
+static ULong n_tc_stale   = 0;
+static ULong n_tc_corrupt = 0;
+static ULong n_tc_added   = 0;
+static ULong n_tc_written = 0;
+
+
+/*------------------------------------------------------------*/
+/*--- Hashing                                              ---*/
+/*------------------------------------------------------------*/
+
+#define FNV_INIT  0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
+static ULong fnv_bytes ( ULong h, const void* p, SizeT n )
+{
+   const UChar* b = p;
+   SizeT i;
+   for (i = 0; i < n; i++) {
+      h ^= b[i];
+      h *= FNV_PRIME;
+   }
+   return h;
+}
+
+static ULong guest_hash ( const VexGuestExtents* vge )
+{
+   ULong h = FNV_INIT;
+   UInt  i;
+   for (i = 0; i < vge->n_used; i++)
+      h = fnv_bytes(h, (const void*)vge->base[i], vge->len[i]);
+   return h;
+}
+
+static ULong record_checksum ( const TCRecord* rec, const UChar* code )
+{
+   TCRecord r = *rec;
+   r.checksum = 0;
+   return fnv_bytes(fnv_bytes(FNV_INIT, &r, sizeof(r)), code, rec->code_len);
+}
+
+/* Options which cannot change what gets generated, and so are left
+   out of the fingerprint.  This lets e.g. runs that log to different
+   files share a cache. */
+static const HChar* const fingerprint_ignored[] = {
+   "-q", "--quiet", "-v", "--verbose", "-d",
+   "--log-fd=", "--log-file=", "--log-socket=", "--xml-fd=",
+   "--xml-file=", "--xml-socket=", "--xml-user-comment=",
+   "--num-callers=", "--error-exitcode=", "--error-limit=",
+   "--suppressions=", "--gen-suppressions=", "--time-stamp=",
+   "--stats=", "--trace-children=", "--trace-children-skip=",
+   "--trace-children-skip-by-arg=", "--child-silent-after-fork=",
+   "--translation-cache-dir=",
+};
+
+static Bool is_fingerprint_ignored ( const HChar* arg )
+{
+   UInt i;
+   for (i = 0; i < sizeof(fingerprint_ignored)
+                   / sizeof(fingerprint_ignored[0]); i++) {
+      const HChar* pfx = fingerprint_ignored[i];
+      Int n = VG_(strlen)(pfx);
+      if (pfx[n-1] == '=' ? VG_(strncmp)(arg, pfx, n) == 0
+                          : VG_(strcmp)(arg, pfx) == 0)
+         return True;
+   }
+   return False;
+}
+
+static ULong compute_fingerprint ( void )
+{
+   ULong          h = FNV_INIT;
+   struct vg_stat st;
+   VexArch        arch;
+   VexArchInfo    archinfo;
+   Word           i;
+   Addr           here = (Addr)&compute_fingerprint;
+
+   h = fnv_bytes(h, VG_(details).name, VG_(strlen)(VG_(details).name) + 1);
+
+   /* The tool executable: any rebuild changes helper addresses. */
+   VG_(memset)(&st, 0, sizeof(st));
+   if (!sr_isError(VG_(stat)("/proc/self/exe", &st))) {
+      h = fnv_bytes(h, &st.dev,   sizeof(st.dev));
+      h = fnv_bytes(h, &st.ino,   sizeof(st.ino));
+      h = fnv_bytes(h, &st.size,  sizeof(st.size));
+      h = fnv_bytes(h, &st.mtime, sizeof(st.mtime));
+   }
+   h = fnv_bytes(h, &here, sizeof(here));
+
+   VG_(machine_get_VexArchInfo)(&arch, &archinfo);
+   h = fnv_bytes(h, &arch, sizeof(arch));
+   h = fnv_bytes(h, &archinfo.hwcaps, sizeof(archinfo.hwcaps));
+
+   for (i = 0; i < VG_(sizeXA)(VG_(args_for_valgrind)); i++) {
+      const HChar* arg = *(HChar**)VG_(indexXA)(VG_(args_for_valgrind), i);
+      if (is_fingerprint_ignored(arg))
+         continue;
+      h = fnv_bytes(h, arg, VG_(strlen)(arg) + 1);
+   }
+   return h;
+}
+
+
+/*------------------------------------------------------------*/
+/*--- Reading and writing cache files                      ---*/
+/*------------------------------------------------------------*/
+
+static HChar* object_filename ( const TCObject* obj, const HChar* suffix )
+{
+   const HChar* dir = VG_(clo_translation_cache_dir);
+   SizeT  len = VG_(strlen)(dir) + VG_(strlen)(obj->buildid)
+                + VG_(strlen)(suffix) + 64;
+   HChar* name = VG_(malloc)("transcache.ofn.1", len);
+   VG_(sprintf)(name, "%s/%016llx-%s-%lx.vgtc%s", dir, tc_fingerprint,
+                obj->buildid, (UWord)obj->bias, suffix);
+   return name;
+}
+
+static TCNode* new_node ( const TCRecord* rec, const UChar* code )
+{
+   TCNode* n = VG_(malloc)("transcache.nn.1",
+                           sizeof(TCNode) + ROUNDUP8(rec->code_len));
+   n->key = (UWord)rec->offset;
+   n->rec = *rec;
+   VG_(memcpy)(n->code, code, rec->code_len);
+   VG_(memset)(n->code + rec->code_len, 0,
+               ROUNDUP8(rec->code_len) - rec->code_len);
+   return n;
+}
+
+/* Read the whole of |fd| into a freshly allocated buffer.  Files
+   larger than 1GB are not worth the trouble. */
+static UChar* read_whole_file ( Int fd, /*OUT*/SizeT* szB )
+{
+   struct vg_stat st;
+   SizeT  done = 0;
+   UChar* buf;
+
+   if (VG_(fstat)(fd, &st) != 0 || st.size < (Long)sizeof(TCHeader)
+       || st.size > (1LL << 30))
+      return NULL;
+
+   buf = VG_(malloc)("transcache.rwf.1", st.size);
+   while (done < (SizeT)st.size) {
+      Int r = VG_(read)(fd, buf + done, (SizeT)st.size - done);
+      if (r <= 0) {
+         VG_(free)(buf);
+         return NULL;
+      }
+      done += r;
+   }
+   *szB = done;
+   return buf;
+}
+
+static void load_object ( TCObject* obj )
+{
+   HChar*    name = object_filename(obj, "");
+   SysRes    sres = VG_(open)(name, VKI_O_RDONLY, 0);
+   SizeT     szB = 0, off;
+   UChar*    buf;
+   TCHeader  hdr;
+   UInt      i;
+
+   VG_(free)(name);
+   if (sr_isError(sres))
+      return;
+   buf = read_whole_file(sr_Res(sres), &szB);
+   VG_(close)(sr_Res(sres));
+   if (buf == NULL)
+      return;
+
+   VG_(memcpy)(&hdr, buf, sizeof(hdr));
+   if (VG_(memcmp)(hdr.magic, TC_MAGIC, sizeof(hdr.magic)) != 0
+       || hdr.version != TC_VERSION
+       || hdr.fingerprint != tc_fingerprint
+       || hdr.bias != (ULong)obj->bias)
+      goto out;
+
+   off = sizeof(TCHeader);
+   for (i = 0; i < hdr.n_recs; i++) {
+      TCRecord rec;
+      if (off + sizeof(TCRecord) > szB)
+         break;
+      VG_(memcpy)(&rec, buf + off, sizeof(rec));
+      off += sizeof(TCRecord);
+      /* Give up on the rest of the file at the first bad record: its
+         code_len can't be trusted to find the next one. */
+      if (rec.n_used < 1 || rec.n_used > 3 || rec.code_len == 0
+          || rec.code_len >= TC_MAX_CODE_LEN || rec.n_guest_instrs >= 200
+          || off + ROUNDUP8(rec.code_len) > szB
+          || record_checksum(&rec, buf + off) != rec.checksum) {
+         n_tc_corrupt++;
+         break;
+      }
+      if (VG_(HT_lookup)(obj->tab, (UWord)rec.offset) == NULL) {
+         VG_(HT_add_node)(obj->tab, new_node(&rec, buf + off));
+         n_tc_loaded++;
+      }
+      off += ROUNDUP8(rec.code_len);
+   }
+
+   if (VG_(clo_verbosity) > 1)
+      VG_(message)(Vg_DebugMsg,
+                   "transcache: loaded %d translations for build-id %s\n",
+                   VG_(HT_count_nodes)(obj->tab), obj->buildid);
+  out:
+   VG_(free)(buf);
+}
+
+/* Small write-combining buffer so that saving a file with a few
+   thousand translations doesn't cost a few thousand syscalls. */
+typedef
+   struct {
+      Int   fd;
+      Bool  failed;
+      UInt  used;
+      UChar buf[65536];
+   }
+   TCWriter;
+
+static void writer_flush ( TCWriter* w )
+{
+   UInt done = 0;
+   while (!w->failed && done < w->used) {
+      Int r = VG_(write)(w->fd, w->buf + done, w->used - done);
+      if (r <= 0)
+         w->failed = True;
+      else
+         done += r;
+   }
+   w->used = 0;
+}
+
+static void writer_put ( TCWriter* w, const void* p, UInt n )
+{
+   const UChar* b = p;
+   while (n > 0) {
+      UInt chunk = sizeof(w->buf) - w->used;
+      if (chunk > n)
+         chunk = n;
+      VG_(memcpy)(w->buf + w->used, b, chunk);
+      w->used += chunk;
+      b += chunk;
+      n -= chunk;
+      if (w->used == sizeof(w->buf))
+         writer_flush(w);
+   }
+}
+
+static void save_object ( TCObject* obj )
+{
+   HChar*    name = object_filename(obj, "");
+   HChar*    tmpname;
+   HChar     suffix[32];
+   SysRes    sres;
+   TCHeader  hdr;
+   TCNode*   n;
+   TCWriter* w;
+
+   VG_(sprintf)(suffix, ".%d.tmp", VG_(getpid)());
+   tmpname = object_filename(obj, suffix);
+
+   sres = VG_(open)(tmpname, VKI_O_CREAT|VKI_O_WRONLY|VKI_O_TRUNC,
+                    VKI_S_IRUSR|VKI_S_IWUSR|VKI_S_IRGRP|VKI_S_IROTH);
+   if (sr_isError(sres)) {
+      if (VG_(clo_verbosity) > 1)
+         VG_(message)(Vg_DebugMsg,
+                      "transcache: can't create %s\n", tmpname);
+      goto out;
+   }
+
+   w = VG_(malloc)("transcache.so.1", sizeof(TCWriter));
+   w->fd     = sr_Res(sres);
+   w->failed = False;
+   w->used   = 0;
+
+   VG_(memset)(&hdr, 0, sizeof(hdr));
+   VG_(memcpy)(hdr.magic, TC_MAGIC, sizeof(hdr.magic));
+   hdr.version     = TC_VERSION;
+   hdr.n_recs      = VG_(HT_count_nodes)(obj->tab);
+   hdr.fingerprint = tc_fingerprint;
+   hdr.bias        = (ULong)obj->bias;
+   writer_put(w, &hdr, sizeof(hdr));
+
+   VG_(HT_ResetIter)(obj->tab);
+   while ((n = VG_(HT_Next)(obj->tab))) {
+      writer_put(w, &n->rec, sizeof(TCRecord));
+      writer_put(w, n->code, ROUNDUP8(n->rec.code_len));
+   }
+   writer_flush(w);
+   VG_(close)(w->fd);
+
+   if (w->failed || VG_(rename)(tmpname, name) != 0) {
+      VG_(unlink)(tmpname);
+   } else {
+      n_tc_written += hdr.n_recs;
+      obj->dirty = False;
+   }
+   VG_(free)(w);
+
+  out:
+   VG_(free)(tmpname);
+   VG_(free)(name);
+}
+
+
+/*------------------------------------------------------------*/
+/*--- Finding the object for a guest address               ---*/
+/*------------------------------------------------------------*/
+
+/* Find (creating and loading if needed) the object whose text
+   contains |a|.  Also returns the text range, so callers can check
+   that a translation doesn't stray outside it. */
+static TCObject* find_object ( Addr a, /*OUT*/Addr* text_lo,
+                                       /*OUT*/Addr* text_hi )
+{
+   DebugInfo*   di = VG_(find_DebugInfo)(a);
+   const HChar* buildid;
+   PtrdiffT     bias;
+   TCObject*    obj;
+   Word         i;
+
+   if (di == NULL)
+      return NULL;
+   buildid = VG_(DebugInfo_get_buildid)(di);
+   if (buildid == NULL)
+      return NULL;
+   bias     = VG_(DebugInfo_get_text_bias)(di);
+   *text_lo = VG_(DebugInfo_get_text_avma)(di);
+   *text_hi = *text_lo + VG_(DebugInfo_get_text_size)(di);
+
+   if (tc_last_obj && tc_last_obj->bias == bias
+       && VG_(strcmp)(tc_last_obj->buildid, buildid) == 0)
+      return tc_last_obj;
+
+   for (i = 0; i < VG_(sizeXA)(tc_objects); i++) {
+      obj = *(TCObject**)VG_(indexXA)(tc_objects, i);
+      if (obj->bias == bias && VG_(strcmp)(obj->buildid, buildid) == 0) {
+         tc_last_obj = obj;
+         return obj;
+      }
+   }
+
+   obj = VG_(malloc)("transcache.fo.1", sizeof(TCObject));
+   obj->buildid = VG_(strdup)("transcache.fo.2", buildid);
+   obj->bias    = bias;
+   obj->tab     = VG_(HT_construct)("transcache.fo.3");
+   obj->dirty   = False;
+   load_object(obj);
+   VG_(addToXA)(tc_objects, &obj);
+   tc_last_obj = obj;
+   return obj;
+}
+
+
+/*------------------------------------------------------------*/
+/*--- Top level                                            ---*/
+/*------------------------------------------------------------*/
+
+void VG_(transcache_init) ( void )
+{
+   const HChar*   dir = VG_(clo_translation_cache_dir);
+   struct vg_stat st;
+
+   if (dir == NULL || dir[0] == 0)
+      return;
+
+   if (!VG_(needs).cacheable_translations) {
+      if (VG_(clo_verbosity) > 0)
+         VG_(umsg)("Warning: %s can't use a translation cache with the "
+                   "options given; --translation-cache-dir ignored\n",
+                   VG_(details).name);
+      return;
+   }
+
+   if (sr_isError(VG_(stat)(dir, &st)) || !VKI_S_ISDIR(st.mode)) {
+      VG_(umsg)("Warning: translation cache directory '%s' does not "
+                "exist; --translation-cache-dir ignored\n", dir);
+      return;
+   }
+
+   tc_fingerprint = compute_fingerprint();
+   tc_objects     = VG_(newXA)(VG_(malloc), "transcache.init.1",
+                               VG_(free), sizeof(TCObject*));
+   tc_enabled     = True;
+}
+
+Bool VG_(transcache_enabled) ( void )
+{
+   return tc_enabled;
+}
+
+Bool VG_(transcache_lookup) ( Addr addr, /*OUT*/CachedTrans* ct )
+{
+   TCObject* obj;
+   TCNode*   n;
+   Addr      lo, hi;
+   UInt      i;
+
+   if (!tc_enabled)
+      return False;
+   obj = find_object(addr, &lo, &hi);
+   if (obj == NULL)
+      return False;
+   n = VG_(HT_lookup)(obj->tab, (UWord)(addr - obj->bias));
+   if (n == NULL) {
+      n_tc_misses++;
+      return False;
+   }
+
+   ct->vge.n_used = n->rec.n_used;
+   for (i = 0; i < n->rec.n_used; i++) {
+      ct->vge.base[i] = (Addr)n->rec.base[i] + obj->bias;
+      ct->vge.len[i]  = n->rec.len[i];
+      if (ct->vge.base[i] < lo || ct->vge.base[i] + ct->vge.len[i] > hi
+          || !VG_(am_is_valid_for_client)(ct->vge.base[i], ct->vge.len[i],
+                                          VKI_PROT_READ)) {
+         n_tc_stale++;
+         return False;
+      }
+   }
+   if (guest_hash(&ct->vge) != n->rec.guest_hash) {
+      n_tc_stale++;
+      return False;
+   }
+
+   ct->sc_bitset        = n->rec.sc_bitset;
+   ct->px               = n->rec.px;
+   ct->is_self_checking = n->rec.is_self_checking;
+   ct->n_guest_instrs   = n->rec.n_guest_instrs;
+   ct->code             = n->code;
+   ct->code_len         = n->rec.code_len;
+   n_tc_hits++;
+   return True;
+}
+
+void VG_(transcache_add) ( Addr addr, const CachedTrans* ct )
+{
+   TCObject* obj;
+   TCNode*   old;
+   TCRecord  rec;
+   Addr      lo, hi;
+   UInt      i;
+
+   if (!tc_enabled)
+      return;
+   vg_assert(ct->vge.n_used >= 1 && ct->vge.n_used <= 3);
+   vg_assert(ct->code_len > 0 && ct->code_len < TC_MAX_CODE_LEN);
+
+   obj = find_object(addr, &lo, &hi);
+   if (obj == NULL)
+      return;
+
+   VG_(memset)(&rec, 0, sizeof(rec));
+   for (i = 0; i < ct->vge.n_used; i++) {
+      if (ct->vge.base[i] < lo || ct->vge.base[i] + ct->vge.len[i] > hi)
+         return;
+      rec.base[i] = (ULong)(ct->vge.base[i] - obj->bias);
+      rec.len[i]  = ct->vge.len[i];
+   }
+   rec.offset           = (ULong)(addr - obj->bias);
+   rec.guest_hash       = guest_hash(&ct->vge);
+   rec.sc_bitset        = ct->sc_bitset;
+   rec.px               = ct->px;
+   rec.n_guest_instrs   = ct->n_guest_instrs;
+   rec.is_self_checking = ct->is_self_checking;
+   rec.n_used           = ct->vge.n_used;
+   rec.code_len         = ct->code_len;
+   rec.checksum         = record_checksum(&rec, ct->code);
+
+   old = VG_(HT_remove)(obj->tab, (UWord)rec.offset);
+   if (old)
+      VG_(free)(old);
+   VG_(HT_add_node)(obj->tab, new_node(&rec, ct->code));
+   obj->dirty = True;
+   n_tc_added++;
+}
+
+void VG_(transcache_flush) ( void )
+{
+   Word i;
+
+   if (!tc_enabled)
+      return;
+   for (i = 0; i < VG_(sizeXA)(tc_objects); i++) {
+      TCObject* obj = *(TCObject**)VG_(indexXA)(tc_objects, i);
+      if (obj->dirty)
+         save_object(obj);
+   }
+}
+
+void VG_(print_transcache_stats) ( void )
+{
+   if (!tc_enabled)
+      return;
+   VG_(message)(Vg_DebugMsg,
+      "transcache: %'llu loaded, %'llu hits, %'llu misses, %'llu stale, "
+      "%'llu corrupt\n",
+      n_tc_loaded, n_tc_hits, n_tc_misses, n_tc_stale, n_tc_corrupt);
+   VG_(message)(Vg_DebugMsg,
+      "transcache: %'llu added, %'llu written, %ld objects\n",
+      n_tc_added, n_tc_written, VG_(sizeXA)(tc_objects));
+}
+
+/*--------------------------------------------------------------------*/
+/*--- end                                                          ---*/
+/*--------------------------------------------------------------------*/
@@ -39,6 +39,7 @@
 #include "pub_core_libcbase.h"
 #include "pub_core_libcassert.h"
 #include "pub_core_libcprint.h"
+#include "pub_core_libcproc.h"   // VG_(read_microsecond_timer)
 #include "pub_core_options.h"
 
 #include "pub_core_debuginfo.h"  // VG_(get_fnname_w_offset)
@@ -49,6 +50,7 @@
 #include "pub_core_tooliface.h"  // VG_(tdict)
 
 #include "pub_core_translate.h"
+#include "pub_core_transcache.h"
 #include "pub_core_transtab.h"
 #include "pub_core_dispatch.h" // VG_(run_innerloop__dispatch_{un}profiled)
                                // VG_(run_a_noredir_translation__return_point)
@@ -59,6 +61,7 @@
 #include "pub_core_execontext.h"  // VG_(make_depth_1_ExeContext_from_Addr)
 
 #include "pub_core_gdbserver.h"   // VG_(instrument_for_gdbserver_if_needed)
+#include "pub_core_scheduler.h"   // VG_(wait_for_parallel_runs)
 
 #include "libvex_emnote.h"        // For PPC, EmWarn_PPC64_redir_underflow
 
@@ -75,6 +78,13 @@ static ULong n_PX_VexRegUpdUnwindregsAtMemAccess = 0;
 static ULong n_PX_VexRegUpdAllregsAtMemAccess    = 0;
 static ULong n_PX_VexRegUpdAllregsAtEachInsn     = 0;
 
+static ULong n_tier_ups         = 0;
+static ULong n_tier_ups_dropped = 0;
+
+/* Time spent in LibVEX_Translate, only measured with --stats=yes. */
+static ULong n_vex_translations = 0;
+static ULong vex_translate_us   = 0;
+
 void VG_(print_translation_stats) ( void )
 {
    UInt n_SP_updates = n_SP_updates_fast + n_SP_updates_generic_known
@@ -99,6 +109,18 @@ void VG_(print_translation_stats) ( void )
 
    VG_(message)(Vg_DebugMsg,
                 "translate: PX: SPonly %'llu,  UnwRegs %'llu,  AllRegs %'llu,  AllRegsAllInsns %'llu\n", n_PX_VexRegUpdSpAtMemAccess, n_PX_VexRegUpdUnwindregsAtMemAccess, n_PX_VexRegUpdAllregsAtMemAccess, n_PX_VexRegUpdAllregsAtEachInsn);
+
+   if (VG_(clo_tier_up_threshold) > 0)
+      VG_(message)(Vg_DebugMsg,
+                   "translate: tier-up: %'llu hot blocks retranslated, "
+                   "%'llu requests dropped\n",
+                   n_tier_ups, n_tier_ups_dropped);
+
+   VG_(message)(Vg_DebugMsg,
+                "translate: JIT: %'llu translations made in %'llu ms "
+                "(regalloc v%d)\n",
+                n_vex_translations, vex_translate_us / 1000,
+                VG_(clo_vex_control).regalloc_version);
 }
 
 /*------------------------------------------------------------*/
@@ -725,7 +747,7 @@ IRSB* vg_SP_update_pass ( void*             closureV,
 /* Vex dumps the final code in here.  Then we can copy it off
    wherever we like. */
 /* 60000: should agree with assertion in VG_(add_to_transtab) in
-   m_transtab.c. */
+   m_transtab.c, and with TC_MAX_CODE_LEN in m_transcache.c. */
 #define N_TMPBUF 60000
 static UChar tmpbuf[N_TMPBUF];
 
@@ -785,9 +807,9 @@ static Bool translations_allowable_from_seg ( NSegment const* seg, Addr addr )
    VexTranslateArgs::needs_self_check for more details about the
    return convention. */
 
-static UInt needs_self_check ( void* closureV,
-                               /*MAYBE_MOD*/VexRegisterUpdates* pxControl,
-                               const VexGuestExtents* vge )
+static UInt self_check_bitset ( void* closureV,
+                                /*MAYBE_MOD*/VexRegisterUpdates* pxControl,
+                                const VexGuestExtents* vge )
 {
    VgCallbackClosure* closure = (VgCallbackClosure*)closureV;
    UInt i, bitset;
@@ -909,6 +931,15 @@ static UInt needs_self_check ( void* closureV,
 
    }
 
+   return bitset;
+}
+
+static UInt needs_self_check ( void* closureV,
+                               /*MAYBE_MOD*/VexRegisterUpdates* pxControl,
+                               const VexGuestExtents* vge )
+{
+   UInt bitset = self_check_bitset(closureV, pxControl, vge);
+
    /* Update running PX stats, as it is difficult without these to
       check that the system is behaving as expected. */
    switch (*pxControl) {
@@ -1439,6 +1470,141 @@ static Bool const_True ( Addr guest_addr )
    return True;
 }
 
+/* --------------- tiered re-translation --------------- */
+
+/* With --tier-up-threshold=N, every normal translation starts by
+   counting its executions in tier_counts[], and when the count
+   reaches N, notes its address in tier_pending[].  Next time the
+   thread is back in the scheduler, VG_(translate_hot_blocks) makes
+   each noted block again, with VEX set to chase across conditional
+   branches as far as --vex-guest-max-insns allows, to unroll loops
+   more eagerly and to optimise at level 3.  The new translation
+   takes the place of the old one and doesn't count.
+
+   Blocks whose addresses hash alike share a counter.  That only
+   means some of them are made again a bit early. */
+
+#define N_TIER_COUNTS  65536   /* must be a power of 2 */
+#define N_TIER_PENDING 64
+
+static UInt tier_counts[N_TIER_COUNTS];
+
+/* Appended to by generated code, possibly in several threads at
+   once with --parallel-threads=yes; n_tier_pending can run past
+   N_TIER_PENDING. */
+static Addr tier_pending[N_TIER_PENDING];
+static volatile UInt n_tier_pending = 0;
+
+/* True while VG_(translate) is making a hot block. */
+static Bool translating_hot = False;
+
+static inline UInt tier_count_ix ( Addr addr )
+{
+   return (UInt)(addr ^ (addr >> 16)) & (N_TIER_COUNTS - 1);
+}
+
+/* Called from generated code when a block's count reaches the
+   threshold. */
+static void tier_up_noted ( Addr nraddr )
+{
+   UInt ix = __sync_fetch_and_add(&n_tier_pending, 1);
+   if (ix < N_TIER_PENDING) {
+      tier_pending[ix] = nraddr;
+   } else {
+      /* No room.  Start counting again, to ask another time. */
+      tier_counts[tier_count_ix(nraddr)] = 0;
+      n_tier_ups_dropped++;
+   }
+}
+
+/* Second instrumentation pass used instead of vg_SP_update_pass
+   when tiering is enabled: does that pass, if needed, then puts the
+   execution counting in front of the block.  Since it runs after the
+   tool's instrumentation, tools never see the counting. */
+static
+IRSB* vg_SP_update_and_tier_count_pass ( void*             closureV,
+                                         IRSB*             sb_in,
+                                         const VexGuestLayout*  layout,
+                                         const VexGuestExtents* vge,
+                                         const VexArchInfo*     vai,
+                                         IRType            gWordTy,
+                                         IRType            hWordTy )
+{
+   VgCallbackClosure* closure = (VgCallbackClosure*)closureV;
+   UInt*    ctr = &tier_counts[tier_count_ix(closure->nraddr)];
+   IRSB*    sb;
+   IRTemp   t_old, t_new, t_hot;
+   IRDirty* di;
+   Int      i;
+#  if defined(VG_BIGENDIAN)
+   const IREndness end = Iend_BE;
+#  else
+   const IREndness end = Iend_LE;
+#  endif
+
+   if (need_to_handle_SP_assignment())
+      sb_in = vg_SP_update_pass(closureV, sb_in, layout, vge, vai,
+                                gWordTy, hWordTy);
+
+   sb    = deepCopyIRSBExceptStmts(sb_in);
+   t_old = newIRTemp(sb->tyenv, Ity_I32);
+   t_new = newIRTemp(sb->tyenv, Ity_I32);
+   t_hot = newIRTemp(sb->tyenv, Ity_I1);
+
+   addStmtToIRSB(sb, IRStmt_WrTmp(t_old,
+                        IRExpr_Load(end, Ity_I32,
+                                    mkIRExpr_HWord((HWord)ctr))));
+   addStmtToIRSB(sb, IRStmt_WrTmp(t_new,
+                        IRExpr_Binop(Iop_Add32, IRExpr_RdTmp(t_old),
+                                     IRExpr_Const(IRConst_U32(1)))));
+   addStmtToIRSB(sb, IRStmt_Store(end, mkIRExpr_HWord((HWord)ctr),
+                                  IRExpr_RdTmp(t_new)));
+   addStmtToIRSB(sb, IRStmt_WrTmp(t_hot,
+                        IRExpr_Binop(Iop_CmpEQ32, IRExpr_RdTmp(t_new),
+                                     IRExpr_Const(IRConst_U32(
+                                        VG_(clo_tier_up_threshold))))));
+   di = unsafeIRDirty_0_N( 0/*regparms*/, "tier_up_noted",
+                           VG_(fnptr_to_fnentry)( &tier_up_noted ),
+                           mkIRExprVec_1( mkIRExpr_HWord(closure->nraddr) ) );
+   di->guard = IRExpr_RdTmp(t_hot);
+   addStmtToIRSB(sb, IRStmt_Dirty(di));
+
+   for (i = 0; i < sb_in->stmts_used; i++)
+      addStmtToIRSB(sb, sb_in->stmts[i]);
+   return sb;
+}
+
+void VG_(translate_hot_blocks) ( ThreadId tid, ULong bbs_done )
+{
+   UInt i, n;
+
+   if (LIKELY(n_tier_pending == 0))
+      return;
+
+   /* Nobody else may be adding to the list. */
+   VG_(wait_for_parallel_runs)();
+   n = n_tier_pending;
+   if (n > N_TIER_PENDING)
+      n = N_TIER_PENDING;
+
+   for (i = 0; i < n; i++) {
+      Addr addr = tier_pending[i];
+      tier_counts[tier_count_ix(addr)] = 0;
+      /* The hot block replaces the translation it was made from.
+         Throw that away first, so the tool has forgotten it before
+         it instruments the new one.  If it has gone already there's
+         no point, and perhaps the code isn't there any more either. */
+      if (!VG_(discard_translation_at)(addr))
+         continue;
+      translating_hot = True;
+      if (VG_(translate)(tid, addr, /*debug*/False, 0/*not verbose*/,
+                         bbs_done, True/*allow redirection*/))
+         n_tier_ups++;
+      translating_hot = False;
+   }
+   n_tier_pending = 0;
+}
+
 /* --------------- main translation function --------------- */
 
 /* Note: see comments at top of m_redir.c for the Big Picture on how
@@ -1457,6 +1623,66 @@ typedef
    }
    T_Kind;
 
+/* Try to satisfy a translation request from the persistent cache.
+   m_transcache has already checked the guest bytes.  But whether VEX
+   chased into the later extents, and which extents it self-checked,
+   also depended on the redirections and mappings in force at the
+   time, so make sure we would decide the same way now. */
+static Bool translate_from_cache ( ThreadId tid, Addr nraddr )
+{
+   CachedTrans        ct;
+   VgCallbackClosure  closure;
+   VexRegisterUpdates px;
+   UInt               i;
+
+   if (!VG_(transcache_lookup)( nraddr, &ct ))
+      return False;
+
+   closure.tid    = tid;
+   closure.nraddr = nraddr;
+   closure.readdr = nraddr;
+
+   for (i = 1; i < ct.vge.n_used; i++) {
+      if (!chase_into_ok( &closure, ct.vge.base[i] ))
+         return False;
+   }
+
+   px = VG_(clo_vex_control).iropt_register_updates_default;
+   if (self_check_bitset( &closure, &px, &ct.vge ) != ct.sc_bitset
+       || px != ct.px)
+      return False;
+
+   for (i = 0; i < ct.vge.n_used; i++) {
+      VG_(am_set_segment_hasT)( ct.vge.base[i] );
+   }
+
+   VG_(add_to_transtab)( &ct.vge, nraddr, (Addr)ct.code, ct.code_len,
+                         ct.is_self_checking, -1/*no profInc*/,
+                         ct.n_guest_instrs );
+   return True;
+}
+
+/* Offer a fresh translation, still in tmpbuf, to the persistent
+   cache, along with what is needed to revalidate it later. */
+static void save_to_cache ( VgCallbackClosure* closure,
+                            const VexGuestExtents* vge,
+                            Int code_len,
+                            const VexTranslateResult* tres )
+{
+   CachedTrans        ct;
+   VexRegisterUpdates px;
+
+   px = VG_(clo_vex_control).iropt_register_updates_default;
+   ct.vge              = *vge;
+   ct.sc_bitset        = self_check_bitset( closure, &px, vge );
+   ct.px               = px;
+   ct.is_self_checking = tres->n_sc_extents > 0;
+   ct.n_guest_instrs   = tres->n_guest_instrs;
+   ct.code             = &tmpbuf[0];
+   ct.code_len         = code_len;
+   VG_(transcache_add)( closure->nraddr, &ct );
+}
+
 /* Translate the basic block beginning at NRADDR, and add it to the
    translation cache & translation table.  Unless
    DEBUGGING_TRANSLATION is true, in which case the call is being done
@@ -1623,6 +1849,12 @@ Bool VG_(translate) ( ThreadId tid,
       verbosity = VG_(clo_trace_flags);
    }
 
+   /* Perhaps an earlier run already did the work. */
+   if (kind == T_Normal && !debugging_translation && verbosity == 0
+       && !translating_hot && VG_(transcache_enabled)()
+       && translate_from_cache( tid, nraddr ))
+      return True;
+
    /* Figure out which preamble-mangling callback to send. */
    preamble_fn = NULL;
    if (kind == T_Redir_Replace)
@@ -1717,7 +1949,11 @@ Bool VG_(translate) ( ThreadId tid,
      vta.instrument1     = g;
    }
    /* No need for type kludgery here. */
-   vta.instrument2       = need_to_handle_SP_assignment()
+   if (VG_(clo_tier_up_threshold) > 0 && !translating_hot
+       && kind != T_NoRedir)
+      vta.instrument2    = vg_SP_update_and_tier_count_pass;
+   else
+      vta.instrument2    = need_to_handle_SP_assignment()
                               ? vg_SP_update_pass
                               : NULL;
    vta.finaltidy         = VG_(needs).final_IR_tidy_pass
@@ -1757,8 +1993,33 @@ Bool VG_(translate) ( ThreadId tid,
    vta.disp_cp_xassisted
       = VG_(fnptr_to_fnentry)( &VG_(disp_cp_xassisted) );
 
+   /* A hot block gets more effort spent on it, within the limits
+      the user has set. */
+   if (translating_hot) {
+      VexControl hot = VG_(clo_vex_control);
+      if (hot.iropt_level == 2)
+         hot.iropt_level = 3;
+      if (hot.guest_chase_thresh > 0) {
+         hot.guest_chase_thresh = hot.guest_max_insns - 1;
+         hot.guest_chase_cond   = True;
+      }
+      if (hot.iropt_unroll_thresh > 0 && hot.iropt_unroll_thresh < 200)
+         hot.iropt_unroll_thresh *= 2;
+      LibVEX_Update_Control( &hot );
+   }
+
    /* Sheesh.  Finally, actually _do_ the translation! */
-   tres = LibVEX_Translate ( &vta );
+   if (UNLIKELY(VG_(clo_stats))) {
+      ULong start = VG_(read_microsecond_timer)();
+      tres = LibVEX_Translate ( &vta );
+      vex_translate_us += VG_(read_microsecond_timer)() - start;
+      n_vex_translations++;
+   } else {
+      tres = LibVEX_Translate ( &vta );
+   }
+
+   if (translating_hot)
+      LibVEX_Update_Control( &VG_(clo_vex_control) );
 
    vg_assert(tres.status == VexTransOK);
    vg_assert(tres.n_sc_extents >= 0 && tres.n_sc_extents <= 3);
@@ -1785,6 +2046,10 @@ Bool VG_(translate) ( ThreadId tid,
 
           // Note that we use nraddr (the non-redirected address), not
           // addr, which might have been changed by the redirection
+          if (kind == T_Normal && verbosity == 0 && !translating_hot
+              && tres.offs_profInc == -1 && VG_(transcache_enabled)())
+             save_to_cache( &closure, &vge, tmpbuf_used, &tres );
+
           VG_(add_to_transtab)( &vge,
                                 nraddr,
                                 (Addr)(&tmpbuf[0]), 
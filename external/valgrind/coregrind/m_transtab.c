@@ -44,6 +44,7 @@
 #include "pub_core_mallocfree.h" // VG_(out_of_memory_NORETURN)
 #include "pub_core_xarray.h"
 #include "pub_core_dispatch.h"   // For VG_(disp_cp*) addresses
+#include "pub_core_scheduler.h"  // VG_(wait_for_parallel_runs)
 
 
 #define DEBUG_TRANSTAB 0
@@ -63,6 +64,12 @@ static SECno n_sectors = 0;
    provided default. */
 UInt VG_(clo_avg_transtab_entry_size) = 0;
 
+/* Number of ways in the fast cache, the first being VG_(tt_fast). */
+UInt VG_(clo_tt_fast_ways) = 2;
+
+/* Carry hot translations over into recycled sectors? */
+Bool VG_(clo_keep_hot_translations) = True;
+
 /*------------------ CONSTANTS ------------------*/
 /* Number of entries in hash table of each sector.  This needs to be a prime
    number to work properly, it must be <= 65535 (so that a TTE index
@@ -174,6 +181,15 @@ typedef
          deletion, hence the Deleted state. */
       enum { InUse, Deleted, Empty } status;
 
+      /* Number of times this translation has been found by
+         VG_(search_transtab), that is, after a miss in the fast cache
+         or when a jump to it was about to be chained.  Translations
+         reached only through chained jumps or fast cache hits are
+         not counted again, so this is only a rough measure of
+         hotness; it decides what survives when the sector is
+         recycled. */
+      UInt n_hits;
+
       /* 64-bit aligned pointer to one or more 64-bit words containing
          the corresponding host code (must be in the same sector!)
          This is a pointer into the sector's tc (code) area. */
@@ -411,6 +427,18 @@ static SECno sector_search_order[MAX_N_SECTORS];
    assumption that no guest code actually has that address, hence a
    value 0x1 seems good.  m_translate gives the client a synthetic
    segfault if it tries to execute at this address.
+
+   With --parallel-threads=yes, other threads probe this table while
+   we update it.  Checking .guest again after reading .host is not
+   enough: between the two reads the entry may have been given to
+   another guest and then back to this one, with a different .host.
+   So every store of a .host is bracketed by increments of
+   VG_(tt_fast_gen), which is odd meanwhile.  The dispatcher reads
+   the generation, .guest and .host, then the generation again, and
+   takes the entry only if the generation was even and unchanged.  On
+   a TSO host that guarantees the .host it jumps to was stored with
+   the .guest it looked up.  Invalidating an entry only writes .guest
+   and doesn't need this.
 */
 /*
 typedef
@@ -423,6 +451,31 @@ typedef
 /*global*/ __attribute__((aligned(16)))
            FastCacheEntry VG_(tt_fast)[VG_TT_FAST_SIZE];
 
+/*global*/ volatile UInt VG_(tt_fast_gen) = 0;
+
+/* Brackets the stores that publish a new .host in VG_(tt_fast). */
+static inline void fast_cache_update_begin ( void )
+{
+   VG_(tt_fast_gen)++;
+   __asm__ __volatile__("" ::: "memory");
+}
+
+static inline void fast_cache_update_end ( void )
+{
+   __asm__ __volatile__("" ::: "memory");
+   VG_(tt_fast_gen)++;
+}
+
+/* The remaining VG_(clo_tt_fast_ways)-1 ways of the fast cache, in
+   sets of n_fast_xways entries, set cno being at [cno * n_fast_xways].
+   Within a set the most recently used entry comes first.  An entry
+   moves here when displaced from VG_(tt_fast)[cno], and back when a
+   miss in VG_(tt_fast) finds it here, so the dispatchers see the
+   effect of a set-associative cache while only ever probing the
+   first way.  Only accessed with the big lock held. */
+static FastCacheEntry* tt_fast_xways = NULL;
+static UInt            n_fast_xways  = 0;
+
 /* Make sure we're not used before initialisation. */
 static Bool init_done = False;
 
@@ -433,6 +486,9 @@ static Bool init_done = False;
 static ULong n_fast_flushes = 0;
 static ULong n_fast_updates = 0;
 
+/* Number of fast-cache misses satisfied from the other ways. */
+static ULong n_fast_xway_hits = 0;
+
 /* Number of full lookups done. */
 static ULong n_full_lookups = 0;
 static ULong n_lookup_probes = 0;
@@ -449,6 +505,19 @@ static ULong n_dump_count = 0;
 static ULong n_dump_osize = 0;
 static ULong n_sectors_recycled = 0;
 
+/* Number/osize of hot translations carried over into a recycled
+   sector instead of being dumped. */
+static ULong n_hot_kept_count = 0;
+static ULong n_hot_kept_osize = 0;
+
+/* Number of translations made of code whose translation had been
+   dumped earlier.  Counted with the help of dumped_entries, a
+   direct-mapped table of the entry addresses of recently dumped
+   translations, indexed like VG_(tt_fast), so this is a lower
+   bound. */
+static ULong n_retrans_count = 0;
+static Addr* dumped_entries = NULL;
+
 /* Number/osize of translations discarded due to requests to do so. */
 static ULong n_disc_count = 0;
 static ULong n_disc_osize = 0;
@@ -831,6 +900,13 @@ void VG_(tt_tc_do_chaining) ( void* from__patch_addr,
 
    TTEntry* from_tte = index_tte(from_sNo, from_tteNo);
 
+   HWord from_offs = (HWord)( (UChar*)from__patch_addr
+                              - (UChar*)from_tte->tcptr );
+   vg_assert(from_offs < 100000/* let's say */);
+
+   /* Nobody may be executing the code we are about to patch. */
+   VG_(wait_for_parallel_runs)();
+
    /* Get VEX to do the patching itself.  We have to hand it off
       since it is host-dependent. */
    VexInvalRange vir
@@ -855,9 +931,6 @@ void VG_(tt_tc_do_chaining) ( void* from__patch_addr,
    ie.from_sNo   = from_sNo;
    ie.from_tteNo = from_tteNo;
    ie.to_fastEP  = to_fastEP;
-   HWord from_offs = (HWord)( (UChar*)from__patch_addr
-                              - (UChar*)from_tte->tcptr );
-   vg_assert(from_offs < 100000/* let's say */);
    ie.from_offs  = (UInt)from_offs;
 
    /* This is the new to_ -> from_ backlink to add. */
@@ -1373,8 +1446,28 @@ static inline HTTno HASH_TT ( Addr key )
 static void setFastCacheEntry ( Addr key, ULong* tcptr )
 {
    UInt cno = (UInt)VG_TT_FAST_HASH(key);
-   VG_(tt_fast)[cno].guest = key;
-   VG_(tt_fast)[cno].host  = (Addr)tcptr;
+   volatile FastCacheEntry* fce = &VG_(tt_fast)[cno];
+   if (n_fast_xways > 0
+       && fce->guest != TRANSTAB_BOGUS_GUEST_ADDR && fce->guest != key) {
+      /* Move the current occupant to the front of the other ways,
+         pushing out the least recently used entry, or a stale copy
+         of key if there is one. */
+      FastCacheEntry* set = &tt_fast_xways[cno * n_fast_xways];
+      UInt w;
+      for (w = 0; w < n_fast_xways - 1; w++) {
+         if (set[w].guest == key)
+            break;
+      }
+      for (; w > 0; w--)
+         set[w] = set[w-1];
+      set[0].guest = fce->guest;
+      set[0].host  = fce->host;
+   }
+   fast_cache_update_begin();
+   fce->guest = TRANSTAB_BOGUS_GUEST_ADDR;
+   fce->host  = (Addr)tcptr;
+   fce->guest = key;
+   fast_cache_update_end();
    n_fast_updates++;
    /* This shouldn't fail.  It should be assured by m_translate
       which should reject any attempt to make translation of code
@@ -1382,7 +1475,47 @@ static void setFastCacheEntry ( Addr key, ULong* tcptr )
    vg_assert(VG_(tt_fast)[cno].guest != TRANSTAB_BOGUS_GUEST_ADDR);
 }
 
-/* Invalidate the fast cache VG_(tt_fast). */
+/* Look for key in the ways of the fast cache other than
+   VG_(tt_fast).  If found, swap it with the VG_(tt_fast) entry and
+   return its host address in *res_hcode. */
+static Bool lookupFastCacheXWays ( Addr key, /*OUT*/Addr* res_hcode )
+{
+   UInt cno = (UInt)VG_TT_FAST_HASH(key);
+   FastCacheEntry* set = &tt_fast_xways[cno * n_fast_xways];
+   volatile FastCacheEntry* fce = &VG_(tt_fast)[cno];
+   FastCacheEntry hit;
+   UInt w;
+
+   for (w = 0; w < n_fast_xways; w++) {
+      if (set[w].guest == key)
+         break;
+   }
+   if (w == n_fast_xways)
+      return False;
+
+   hit = set[w];
+   if (fce->guest != TRANSTAB_BOGUS_GUEST_ADDR) {
+      for (; w > 0; w--)
+         set[w] = set[w-1];
+      set[0].guest = fce->guest;
+      set[0].host  = fce->host;
+   } else {
+      for (; w < n_fast_xways - 1; w++)
+         set[w] = set[w+1];
+      set[w].guest = TRANSTAB_BOGUS_GUEST_ADDR;
+   }
+   /* Same as setFastCacheEntry. */
+   fast_cache_update_begin();
+   fce->guest = TRANSTAB_BOGUS_GUEST_ADDR;
+   fce->host  = hit.host;
+   fce->guest = hit.guest;
+   fast_cache_update_end();
+   n_fast_xway_hits++;
+   *res_hcode = hit.host;
+   return True;
+}
+
+/* Invalidate the fast cache VG_(tt_fast), and its other ways. */
 static void invalidateFastCache ( void )
 {
    UInt j;
@@ -1397,9 +1530,27 @@ static void invalidateFastCache ( void )
    }
 
    vg_assert(j == VG_TT_FAST_SIZE);
+   for (j = 0; j < VG_TT_FAST_SIZE * n_fast_xways; j++)
+      tt_fast_xways[j].guest = TRANSTAB_BOGUS_GUEST_ADDR;
    n_fast_flushes++;
 }
 
+/* Invalidate only the fast cache entries for key.  They can only be
+   in key's own set. */
+static void invalidateFastCacheEntry ( Addr key )
+{
+   UInt cno = (UInt)VG_TT_FAST_HASH(key);
+   FastCacheEntry* set = &tt_fast_xways[cno * n_fast_xways];
+   UInt w;
+
+   if (VG_(tt_fast)[cno].guest == key)
+      VG_(tt_fast)[cno].guest = TRANSTAB_BOGUS_GUEST_ADDR;
+   for (w = 0; w < n_fast_xways; w++) {
+      if (set[w].guest == key)
+         set[w].guest = TRANSTAB_BOGUS_GUEST_ADDR;
+   }
+}
+
 
 static TTEno get_empty_tt_slot(SECno sNo)
 {
@@ -1419,11 +1570,178 @@ static void add_in_empty_tt_list (SECno sNo, TTEno tteno)
    sectors[sNo].empty_tt_list = tteno;
 }
 
+/* forward */
+static TTEno add_to_sector ( SECno y, const VexGuestExtents* vge,
+                             Addr entry, const UChar* code, UInt code_len,
+                             Int offs_profInc, UShort weight );
+
+/* When a sector is recycled, translations with at least this score
+   (n_hits plus the number of jumps chained to them) are candidates
+   for being kept, hottest first, until they would take up more than
+   HOT_TT_MAX_PERCENT of the emptied sector's tt or tc. */
+#define HOT_TT_MIN_SCORE   3
+#define HOT_TT_MAX_PERCENT 25
+
+typedef
+   struct {
+      TTEno tteNo;
+      UInt  score;
+      UInt  szQ;
+   }
+   HotCand;
+
+static Int cmp_HotCand_by_score ( const void* v1, const void* v2 )
+{
+   const HotCand* c1 = v1;
+   const HotCand* c2 = v2;
+   if (c1->score > c2->score) return -1;
+   if (c1->score < c2->score) return 1;
+   return 0;
+}
+
+/* A translation saved from a sector being recycled, to be put back
+   once the sector has been emptied. */
+typedef
+   struct {
+      VexGuestExtents vge;
+      Addr   entry;
+      UShort weight;
+      UInt   n_hits;
+      UInt   code_offs;  // in the saved code buffer
+      UInt   code_len;
+   }
+   HotTrans;
+
+/* Undo the chaining of all jumps out of the specified block, and
+   forget about them.  After this its code is the same as when it was
+   first made, and so can be moved elsewhere. */
+static void unchain_out_edges ( VexArch arch_host, VexEndness endness_host,
+                                SECno here_sNo, TTEno here_tteNo )
+{
+   UWord    i, j, n, m;
+   Int      evCheckSzB = LibVEX_evCheckSzB(arch_host);
+   TTEntry* here_tte   = index_tte(here_sNo, here_tteNo);
+   vg_assert(here_tte->status == InUse);
+
+   n = OutEdgeArr__size(&here_tte->out_edges);
+   for (i = 0; i < n; i++) {
+      OutEdge* oe = OutEdgeArr__index(&here_tte->out_edges, i);
+      TTEntry* to_tte = index_tte(oe->to_sNo, oe->to_tteNo);
+      m = InEdgeArr__size(&to_tte->in_edges);
+      vg_assert(m > 0);
+      for (j = 0; j < m; j++) {
+         InEdge* ie = InEdgeArr__index(&to_tte->in_edges, j);
+         if (ie->from_sNo == here_sNo && ie->from_tteNo == here_tteNo
+             && ie->from_offs == oe->from_offs)
+           break;
+      }
+      vg_assert(j < m); // "ie must be findable"
+      UChar* to_slow_EP = (UChar*)to_tte->tcptr;
+      UChar* to_fast_EP = to_slow_EP + evCheckSzB;
+      unchain_one(arch_host, endness_host,
+                  InEdgeArr__index(&to_tte->in_edges, j),
+                  to_fast_EP, to_slow_EP);
+      InEdgeArr__deleteIndex(&to_tte->in_edges, j);
+   }
+   OutEdgeArr__makeEmpty(&here_tte->out_edges);
+}
+
+/* Sector sno is about to be recycled.  Choose the translations in it
+   worth keeping, and save an unchained copy of each in *hot (an
+   XArray of HotTrans, in host code order) and *hot_code.  Returns
+   an array saying which tt entries were chosen, or NULL if none
+   were. */
+static UChar* save_hot_translations ( VexArch arch_host,
+                                      VexEndness endness_host,
+                                      SECno sno,
+                                      /*OUT*/XArray** hot,
+                                      /*OUT*/UChar** hot_code )
+{
+   Sector*  sec = &sectors[sno];
+   Word     n_hx = VG_(sizeXA)(sec->host_extents);
+   HotCand* cands;
+   UChar*   keep;
+   Word     i, n_cands;
+   UInt     n_keep, keepQ, maxQ, maxN;
+
+   *hot = NULL;
+   *hot_code = NULL;
+   if (n_hx == 0)
+      return NULL;
+
+   /* host_extents may also describe deleted translations, whose
+      tt slot might since have been reused; hence the tcptr check. */
+   cands = ttaux_malloc("transtab.save_hot_translations.1",
+                        n_hx * sizeof(HotCand));
+   n_cands = 0;
+   for (i = 0; i < n_hx; i++) {
+      HostExtent* hx  = VG_(indexXA)(sec->host_extents, i);
+      TTEntry*    tte = &sec->tt[hx->tteNo];
+      if (tte->status != InUse || (UChar*)tte->tcptr != hx->start)
+         continue;
+      UInt score = tte->n_hits + (UInt)InEdgeArr__size(&tte->in_edges);
+      if (score < HOT_TT_MIN_SCORE)
+         continue;
+      cands[n_cands].tteNo = hx->tteNo;
+      cands[n_cands].score = score;
+      cands[n_cands].szQ   = (hx->len + 7) >> 3;
+      n_cands++;
+   }
+   if (n_cands == 0) {
+      ttaux_free(cands);
+      return NULL;
+   }
+
+   VG_(ssort)(cands, n_cands, sizeof(HotCand), cmp_HotCand_by_score);
+   keep = ttaux_malloc("transtab.save_hot_translations.2",
+                       N_TTES_PER_SECTOR);
+   VG_(memset)(keep, 0, N_TTES_PER_SECTOR);
+   maxQ = (tc_sector_szQ / 100) * HOT_TT_MAX_PERCENT;
+   maxN = (N_TTES_PER_SECTOR / 100) * HOT_TT_MAX_PERCENT;
+   n_keep = keepQ = 0;
+   for (i = 0; i < n_cands && n_keep < maxN; i++) {
+      if (keepQ + cands[i].szQ > maxQ)
+         continue;
+      keep[cands[i].tteNo] = 1;
+      keepQ += cands[i].szQ;
+      n_keep++;
+   }
+   ttaux_free(cands);
+
+   /* Save them, in the order they are in the tc, so that they stay
+      in the same order once put back. */
+   *hot = VG_(newXA)(ttaux_malloc, "transtab.save_hot_translations.3",
+                     ttaux_free, sizeof(HotTrans));
+   *hot_code = ttaux_malloc("transtab.save_hot_translations.4", 8 * keepQ);
+   keepQ = 0;
+   for (i = 0; i < n_hx; i++) {
+      HostExtent* hx  = VG_(indexXA)(sec->host_extents, i);
+      TTEntry*    tte = &sec->tt[hx->tteNo];
+      HotTrans    ht;
+      if (!keep[hx->tteNo] || (UChar*)tte->tcptr != hx->start)
+         continue;
+      unchain_out_edges(arch_host, endness_host, sno, hx->tteNo);
+      ht.vge       = tte->vge;
+      ht.entry     = tte->entry;
+      ht.weight    = tte->usage.prof.weight;
+      ht.n_hits    = tte->n_hits;
+      ht.code_offs = 8 * keepQ;
+      ht.code_len  = hx->len;
+      VG_(memcpy)(*hot_code + ht.code_offs, hx->start, hx->len);
+      keepQ += (hx->len + 7) >> 3;
+      VG_(addToXA)(*hot, &ht);
+   }
+   vg_assert(VG_(sizeXA)(*hot) == n_keep);
+   return keep;
+}
+
 static void initialiseSector ( SECno sno )
 {
    UInt i;
    SysRes  sres;
    Sector* sec;
+   XArray* hot      = NULL;
+   UChar*  hot_code = NULL;
    vg_assert(isValidSector(sno));
 
    { Bool sane = sanity_check_sector_search_order();
@@ -1504,6 +1822,7 @@ static void initialiseSector ( SECno sno )
       /* Sector has been used before.  Dump the old contents. */
       if (VG_(clo_stats) || VG_(debugLog_getLevel)() >= 1)
          VG_(dmsg)("transtab: " "recycle  sector %d\n", sno);
+      VG_(wait_for_parallel_runs)();
       n_sectors_recycled++;
 
       vg_assert(sec->tt != NULL);
@@ -1516,6 +1835,23 @@ static void initialiseSector ( SECno sno )
       VG_(machine_get_VexArchInfo)( &arch_host, &archinfo_host );
       VexEndness endness_host = archinfo_host.endness;
 
+      /* Hot translations are saved and put back once the sector is
+         empty.  They are not dumped, so the tool is not told about
+         them.  That can't be done when profiling, as the code refers
+         to the profile counter in its old tt entry. */
+      UChar* keep = NULL;
+      if (VG_(clo_keep_hot_translations) && !VG_(clo_profyle_sbs)) {
+         keep = save_hot_translations(arch_host, endness_host, sno,
+                                      &hot, &hot_code);
+         if (keep != NULL)
+            n_dump_count -= VG_(sizeXA)(hot);
+      }
+      if (dumped_entries == NULL) {
+         dumped_entries = ttaux_malloc("transtab.dumped_entries",
+                                       VG_TT_FAST_SIZE * sizeof(Addr));
+         VG_(memset)(dumped_entries, 0, VG_TT_FAST_SIZE * sizeof(Addr));
+      }
+
       /* Visit each just-about-to-be-abandoned translation. */
       if (DEBUG_TRANSTAB) VG_(printf)("QQQ unlink-entire-sector: %d START\n",
                                       sno);
@@ -1524,12 +1860,16 @@ static void initialiseSector ( SECno sno )
          if (sec->tt[ei].status == InUse) {
             vg_assert(sec->tt[ei].n_tte2ec >= 1);
             vg_assert(sec->tt[ei].n_tte2ec <= 3);
-            n_dump_osize += vge_osize(&sec->tt[ei].vge);
-            /* Tell the tool too. */
-            if (VG_(needs).superblock_discards) {
-               VG_TDICT_CALL( tool_discard_superblock_info,
-                              sec->tt[ei].entry,
-                              sec->tt[ei].vge );
+            if (keep == NULL || !keep[ei]) {
+               n_dump_osize += vge_osize(&sec->tt[ei].vge);
+               dumped_entries[VG_TT_FAST_HASH(sec->tt[ei].entry)]
+                  = sec->tt[ei].entry;
+               /* Tell the tool too. */
+               if (VG_(needs).superblock_discards) {
+                  VG_TDICT_CALL( tool_discard_superblock_info,
+                                 sec->tt[ei].entry,
+                                 sec->tt[ei].vge );
+               }
             }
             unchain_in_preparation_for_deletion(arch_host,
                                                 endness_host, sno, ei);
@@ -1542,6 +1882,8 @@ static void initialiseSector ( SECno sno )
       }
       for (HTTno hi = 0; hi < N_HTTES_PER_SECTOR; hi++)
          sec->htt[hi] = HTT_EMPTY;
+      if (keep != NULL)
+         ttaux_free(keep);
 
       if (DEBUG_TRANSTAB) VG_(printf)("QQQ unlink-entire-sector: %d END\n",
                                       sno);
@@ -1583,89 +1925,47 @@ static void initialiseSector ( SECno sno )
 
    invalidateFastCache();
 
+   /* Put back whatever hot translations were saved. */
+   if (hot != NULL) {
+      Word n_hot = VG_(sizeXA)(hot);
+      for (Word h = 0; h < n_hot; h++) {
+         HotTrans* ht = VG_(indexXA)(hot, h);
+         TTEno tteNo = add_to_sector(sno, &ht->vge, ht->entry,
+                                     hot_code + ht->code_offs, ht->code_len,
+                                     -1, ht->weight);
+         /* Make it earn its place again next time round. */
+         sec->tt[tteNo].n_hits = ht->n_hits / 2;
+         n_hot_kept_count++;
+         n_hot_kept_osize += vge_osize(&ht->vge);
+      }
+      if (VG_(clo_stats) || VG_(debugLog_getLevel)() >= 1)
+         VG_(dmsg)("transtab: " "kept     %ld hot translations "
+                   "in sector %d\n", n_hot, sno);
+      VG_(deleteXA)(hot);
+      ttaux_free(hot_code);
+   }
+
    { Bool sane = sanity_check_sector_search_order();
      vg_assert(sane);
    }
 }
 
-/* Add a translation of vge to TT/TC.  The translation is temporarily
-   in code[0 .. code_len-1].
-
-   pre: youngest_sector points to a valid (although possibly full)
-   sector.
-*/
-void VG_(add_to_transtab)( const VexGuestExtents* vge,
-                           Addr             entry,
-                           Addr             code,
-                           UInt             code_len,
-                           Bool             is_self_checking,
-                           Int              offs_profInc,
-                           UInt             n_guest_instrs )
+/* Put a translation of vge into sector y, which must have room for
+   it.  The translation is temporarily in code[0 .. code_len-1]. */
+static TTEno add_to_sector ( SECno y,
+                             const VexGuestExtents* vge,
+                             Addr         entry,
+                             const UChar* code,
+                             UInt         code_len,
+                             Int          offs_profInc,
+                             UShort       weight )
 {
-   Int    tcAvailQ, reqdQ, y;
+   Int    tcAvailQ, reqdQ;
    ULong  *tcptr, *tcptr2;
-   UChar* srcP;
    UChar* dstP;
 
-   vg_assert(init_done);
-   vg_assert(vge->n_used >= 1 && vge->n_used <= 3);
-
-   /* 60000: should agree with N_TMPBUF in m_translate.c. */
-   vg_assert(code_len > 0 && code_len < 60000);
-
-   /* Generally stay sane */
-   vg_assert(n_guest_instrs < 200); /* it can be zero, tho */
-
-   if (DEBUG_TRANSTAB)
-      VG_(printf)("add_to_transtab(entry = 0x%lx, len = %u) ...\n",
-                  entry, code_len);
-
-   n_in_count++;
-   n_in_tsize += code_len;
-   n_in_osize += vge_osize(vge);
-   if (is_self_checking)
-      n_in_sc_count++;
-
-   y = youngest_sector;
-   vg_assert(isValidSector(y));
-
-   if (sectors[y].tc == NULL)
-      initialiseSector(y);
-
-   /* Try putting the translation in this sector. */
    reqdQ = (code_len + 7) >> 3;
 
-   /* Will it fit in tc? */
-   tcAvailQ = ((ULong*)(&sectors[y].tc[tc_sector_szQ]))
-              - ((ULong*)(sectors[y].tc_next));
-   vg_assert(tcAvailQ >= 0);
-   vg_assert(tcAvailQ <= tc_sector_szQ);
-
-   if (tcAvailQ < reqdQ 
-       || sectors[y].tt_n_inuse >= N_TTES_PER_SECTOR) {
-      /* No.  So move on to the next sector.  Either it's never been
-         used before, in which case it will get its tt/tc allocated
-         now, or it has been used before, in which case it is set to be
-         empty, hence throwing out the oldest sector. */
-      vg_assert(tc_sector_szQ > 0);
-      Int tt_loading_pct = (100 * sectors[y].tt_n_inuse) 
-                           / N_HTTES_PER_SECTOR;
-      Int tc_loading_pct = (100 * (tc_sector_szQ - tcAvailQ)) 
-                           / tc_sector_szQ;
-      if (VG_(clo_stats) || VG_(debugLog_getLevel)() >= 1) {
-         VG_(dmsg)("transtab: "
-                   "declare  sector %d full "
-                   "(TT loading %2d%%, TC loading %2d%%, avg tce size %d)\n",
-                   y, tt_loading_pct, tc_loading_pct,
-                   8 * (tc_sector_szQ - tcAvailQ)/sectors[y].tt_n_inuse);
-      }
-      youngest_sector++;
-      if (youngest_sector >= n_sectors)
-         youngest_sector = 0;
-      y = youngest_sector;
-      initialiseSector(y);
-   }
-
    /* Be sure ... */
    tcAvailQ = ((ULong*)(&sectors[y].tc[tc_sector_szQ]))
               - ((ULong*)(sectors[y].tc_next));
@@ -1681,8 +1981,7 @@ void VG_(add_to_transtab)( const VexGuestExtents* vge,
    vg_assert(tcptr <= &sectors[y].tc[tc_sector_szQ]);
 
    dstP = (UChar*)tcptr;
-   srcP = (UChar*)code;
-   VG_(memcpy)(dstP, srcP, code_len);
+   VG_(memcpy)(dstP, code, code_len);
    sectors[y].tc_next += reqdQ;
    sectors[y].tt_n_inuse++;
 
@@ -1698,8 +1997,7 @@ void VG_(add_to_transtab)( const VexGuestExtents* vge,
    sectors[y].tt[tteix].status = InUse;
    sectors[y].tt[tteix].tcptr  = tcptr;
    sectors[y].tt[tteix].usage.prof.count  = 0;
-   sectors[y].tt[tteix].usage.prof.weight = 
-      n_guest_instrs == 0 ? 1 : n_guest_instrs;
+   sectors[y].tt[tteix].usage.prof.weight = weight;
    sectors[y].tt[tteix].vge    = *vge;
    sectors[y].tt[tteix].entry  = entry;
 
@@ -1758,6 +2056,93 @@ void VG_(add_to_transtab)( const VexGuestExtents* vge,
 
    /* Note the eclass numbers for this translation. */
    upd_eclasses_after_add( &sectors[y], tteix );
+   return tteix;
+}
+
+/* Add a translation of vge to TT/TC.  The translation is temporarily
+   in code[0 .. code_len-1].
+
+   pre: youngest_sector points to a valid (although possibly full)
+   sector.
+*/
+void VG_(add_to_transtab)( const VexGuestExtents* vge,
+                           Addr             entry,
+                           Addr             code,
+                           UInt             code_len,
+                           Bool             is_self_checking,
+                           Int              offs_profInc,
+                           UInt             n_guest_instrs )
+{
+   Int    tcAvailQ, reqdQ, y;
+
+   vg_assert(init_done);
+   vg_assert(vge->n_used >= 1 && vge->n_used <= 3);
+
+   /* 60000: should agree with N_TMPBUF in m_translate.c. */
+   vg_assert(code_len > 0 && code_len < 60000);
+
+   /* Generally stay sane */
+   vg_assert(n_guest_instrs < 200); /* it can be zero, tho */
+
+   if (DEBUG_TRANSTAB)
+      VG_(printf)("add_to_transtab(entry = 0x%lx, len = %u) ...\n",
+                  entry, code_len);
+
+   n_in_count++;
+   n_in_tsize += code_len;
+   n_in_osize += vge_osize(vge);
+   if (is_self_checking)
+      n_in_sc_count++;
+   if (dumped_entries != NULL) {
+      UInt dno = (UInt)VG_TT_FAST_HASH(entry);
+      if (dumped_entries[dno] == entry) {
+         n_retrans_count++;
+         dumped_entries[dno] = 0;
+      }
+   }
+
+   y = youngest_sector;
+   vg_assert(isValidSector(y));
+
+   if (sectors[y].tc == NULL)
+      initialiseSector(y);
+
+   /* Try putting the translation in this sector. */
+   reqdQ = (code_len + 7) >> 3;
+
+   /* Will it fit in tc? */
+   tcAvailQ = ((ULong*)(&sectors[y].tc[tc_sector_szQ]))
+              - ((ULong*)(sectors[y].tc_next));
+   vg_assert(tcAvailQ >= 0);
+   vg_assert(tcAvailQ <= tc_sector_szQ);
+
+   if (tcAvailQ < reqdQ 
+       || sectors[y].tt_n_inuse >= N_TTES_PER_SECTOR) {
+      /* No.  So move on to the next sector.  Either it's never been
+         used before, in which case it will get its tt/tc allocated
+         now, or it has been used before, in which case it is set to be
+         empty, hence throwing out the oldest sector. */
+      vg_assert(tc_sector_szQ > 0);
+      Int tt_loading_pct = (100 * sectors[y].tt_n_inuse) 
+                           / N_HTTES_PER_SECTOR;
+      Int tc_loading_pct = (100 * (tc_sector_szQ - tcAvailQ)) 
+                           / tc_sector_szQ;
+      if (VG_(clo_stats) || VG_(debugLog_getLevel)() >= 1) {
+         VG_(dmsg)("transtab: "
+                   "declare  sector %d full "
+                   "(TT loading %2d%%, TC loading %2d%%, avg tce size %d)\n",
+                   y, tt_loading_pct, tc_loading_pct,
+                   8 * (tc_sector_szQ - tcAvailQ)/sectors[y].tt_n_inuse);
+      }
+      youngest_sector++;
+      if (youngest_sector >= n_sectors)
+         youngest_sector = 0;
+      y = youngest_sector;
+      initialiseSector(y);
+   }
+
+   add_to_sector( y, vge, entry, (const UChar*)code, code_len,
+                  offs_profInc, n_guest_instrs == 0 ? 1 : n_guest_instrs );
 }
 
 
@@ -1776,6 +2161,20 @@ Bool VG_(search_transtab) ( /*OUT*/Addr*  res_hcode,
    TTEno tti;
 
    vg_assert(init_done);
+
+   /* A miss in VG_(tt_fast) may still hit in one of its other ways.
+      Those don't record where the translation lives, so this only
+      helps callers who just want the host address. */
+   if (upd_cache && n_fast_xways > 0
+       && res_sNo == NULL && res_tteNo == NULL) {
+      Addr hcode;
+      if (lookupFastCacheXWays(guest_addr, &hcode)) {
+         if (res_hcode)
+            *res_hcode = hcode;
+         return True;
+      }
+   }
+
    /* Find the initial probe point just once.  It will be the same in
       all sectors and avoids multiple expensive % operations. */
    n_full_lookups++;
@@ -1797,6 +2196,8 @@ Bool VG_(search_transtab) ( /*OUT*/Addr*  res_hcode,
          if (tti < N_TTES_PER_SECTOR
              && sectors[sno].tt[tti].entry == guest_addr) {
             /* found it */
+            if (sectors[sno].tt[tti].n_hits < 0x7FFFFFFF)
+               sectors[sno].tt[tti].n_hits++;
             if (upd_cache)
                setFastCacheEntry( 
                   guest_addr, sectors[sno].tt[tti].tcptr );
@@ -1887,6 +2288,8 @@ static void delete_tte ( /*MOD*/Sector* sec, SECno secNo, TTEno tteno,
    vg_assert(tteno >= 0 && tteno < N_TTES_PER_SECTOR);
    tte = &sec->tt[tteno];
    vg_assert(tte->status == InUse);
+
+   VG_(wait_for_parallel_runs)();
    vg_assert(tte->n_tte2ec >= 1 && tte->n_tte2ec <= 3);
 
    /* Unchain .. */
@@ -2128,6 +2531,27 @@ void VG_(discard_translations) ( Addr guest_start, ULong range,
    }
 }
 
+
+Bool VG_(discard_translation_at) ( Addr entry )
+{
+   SECno sno;
+   TTEno tteNo;
+
+   vg_assert(init_done);
+   if (!VG_(search_transtab)(NULL, &sno, &tteNo, entry, False/*upd_cache*/))
+      return False;
+
+   VexArch     arch_host = VexArch_INVALID;
+   VexArchInfo archinfo_host;
+   VG_(bzero_inline)(&archinfo_host, sizeof(archinfo_host));
+   VG_(machine_get_VexArchInfo)( &arch_host, &archinfo_host );
+   VexEndness endness_host = archinfo_host.endness;
+
+   delete_tte(&sectors[sno], sno, tteNo, arch_host, endness_host);
+   invalidateFastCacheEntry(entry);
+   return True;
+}
+
 /* Whether or not tools may discard translations. */
 Bool  VG_(ok_to_discard_translations) = False;
 
@@ -2243,6 +2667,7 @@ void VG_(add_to_unredir_transtab)( const VexGuestExtents* vge,
 
    if (i >= N_UNREDIR_TT || code_szQ > (N_UNREDIR_TCQ - unredir_tc_used)) {
       /* It's full; dump everything we currently have */
+      VG_(wait_for_parallel_runs)();
       init_unredir_tt_tc();
       i = 0;
    }
@@ -2365,6 +2790,13 @@ void VG_(init_tt_tc) ( void )
       sector_search_order[i] = INV_SNO;
 
    /* Initialise the fast cache. */
+   vg_assert(VG_(clo_tt_fast_ways) >= 1
+             && VG_(clo_tt_fast_ways) <= MAX_TT_FAST_WAYS);
+   n_fast_xways = VG_(clo_tt_fast_ways) - 1;
+   if (n_fast_xways > 0)
+      tt_fast_xways = ttaux_malloc("transtab.init_tt_tc(tt_fast_xways)",
+                                   VG_TT_FAST_SIZE * n_fast_xways
+                                   * sizeof(FastCacheEntry));
    invalidateFastCache();
 
    /* and the unredir tt/tc */
@@ -2424,6 +2856,9 @@ void VG_(print_tt_tc_stats) ( void )
    VG_(message)(Vg_DebugMsg,
       "    tt/tc: %'llu fast-cache updates, %'llu flushes\n",
       n_fast_updates, n_fast_flushes );
+   VG_(message)(Vg_DebugMsg,
+      "    tt/tc: %u-way fast-cache, %'llu misses found in other ways\n",
+      VG_(clo_tt_fast_ways), n_fast_xway_hits );
 
    VG_(message)(Vg_DebugMsg,
                 " transtab: new        %'lld "
@@ -2437,6 +2872,10 @@ void VG_(print_tt_tc_stats) ( void )
                 " transtab: dumped     %'llu (%'llu -> ?" "?) "
                 "(sectors recycled %'llu)\n",
                 n_dump_count, n_dump_osize, n_sectors_recycled );
+   VG_(message)(Vg_DebugMsg,
+                " transtab: kept hot   %'llu (%'llu -> ?" "?) "
+                "(retranslated after dump >= %'llu)\n",
+                n_hot_kept_count, n_hot_kept_osize, n_retrans_count );
    VG_(message)(Vg_DebugMsg,
                 " transtab: discarded  %'llu (%'llu -> ?" "?)\n",
                 n_disc_count, n_disc_osize );
@@ -205,6 +205,10 @@ void VG_(DebugInfo_syms_getidx)  ( const DebugInfo *di,
                                    /*OUT*/const HChar***  sec_names,
                                    /*OUT*/Bool*     isText,
                                    /*OUT*/Bool*     isIFunc );
+/* The build-id of the object, as a lowercase hex string, or NULL if
+   it doesn't have one (or isn't ELF). */
+const HChar* VG_(DebugInfo_get_buildid) ( const DebugInfo *di );
+
 /* ppc64-linux only: find the TOC pointer (R2 value) that should be in
    force at the entry point address of the function containing
    guest_code_addr.  Returns 0 if not known. */
@@ -75,6 +75,9 @@ extern void    VG_(env_unsetenv) ( HChar **env, const HChar *varname );
 extern void    VG_(env_remove_valgrind_env_stuff) ( HChar** env ); 
 extern HChar **VG_(env_clone)    ( HChar **env_clone );
 
+// As VG_(read_millisecond_timer), but in microseconds.
+extern ULong VG_(read_microsecond_timer) ( void );
+
 // misc
 extern Int  VG_(getgroups)( Int size, UInt* list );
 extern Int  VG_(ptrace)( Int request, Int pid, void *addr, void *data );
@@ -155,6 +155,14 @@ extern const HChar* VG_(clo_debuginfo_server);
    _debuginfo_server. */
 extern Bool VG_(clo_allow_mismatched_debuginfo);
 
+/* Read DWARF line, inline and variable info only when it is first
+   needed, rather than when an object is mapped?  default: YES */
+extern Bool VG_(clo_lazy_debuginfo);
+
+/* Directory in which to keep parsed line (and inline) info, keyed by
+   build-id, for later runs.  NULL means don't. */
+extern const HChar* VG_(clo_debuginfo_cache_dir);
+
 /* DEBUG: print generated code?  default: 00000000 ( == NO ) */
 extern UChar VG_(clo_trace_flags);
 
@@ -196,6 +204,12 @@ extern Bool  VG_(clo_trace_redir);
 /* Enable fair scheduling on multicore systems? default: NO */
 enum FairSchedType { disable_fair_sched, enable_fair_sched, try_fair_sched };
 extern enum FairSchedType VG_(clo_fair_sched);
+/* Directory in which to keep translations across runs, or NULL for
+   none.  default: NULL */
+extern const HChar* VG_(clo_translation_cache_dir);
+/* Make a block again with more optimisation once it has run this many
+   times, or never if 0.  default: 0 */
+extern UInt  VG_(clo_tier_up_threshold);
 /* DEBUG: print thread scheduling events?  default: NO */
 extern Bool  VG_(clo_trace_sched);
 /* DEBUG: do heap profiling?  default: NO */
@@ -113,6 +113,20 @@ extern void VG_(print_scheduler_stats) ( void );
 /* If False, a fault is Valgrind-internal (ie, a bug) */
 extern Bool VG_(in_generated_code);
 
+/* With --parallel-threads=yes, a thread gives up the big lock while
+   it runs generated code, and takes it back when it leaves.  This
+   does the taking back; the sync signal handler calls it so that a
+   fault in generated code is dealt with holding the lock.  Does
+   nothing if tid is not currently running unlocked. */
+extern void VG_(end_parallel_run) ( ThreadId tid );
+
+/* Called with the big lock held.  Waits until no other thread is
+   running generated code, so that the caller can patch, discard or
+   overwrite translations.  Threads cannot re-enter generated code
+   until the caller drops the lock.  Cheap when nothing is running
+   in parallel. */
+extern void VG_(wait_for_parallel_runs) ( void );
+
 /* Sanity checks which may be done at any time.  The scheduler decides when. */
 extern void VG_(sanity_check_general) ( Bool force_expensive );
 
@@ -349,6 +349,12 @@ typedef struct {
    Bool               sched_jmpbuf_valid;
    VG_MINIMAL_JMP_BUF(sched_jmpbuf);
 
+   /* True while the thread runs generated code without holding the
+      big lock (--parallel-threads=yes).  Written only by the thread
+      itself; read by the lock holder when it needs to stop the
+      world. */
+   volatile Bool      in_parallel_run;
+
    /* This thread's name. NULL, if no name. */
    HChar *thread_name;
 }
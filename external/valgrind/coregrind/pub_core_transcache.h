@@ -0,0 +1,85 @@
+
+/*--------------------------------------------------------------------*/
+/*--- The persistent translation cache.      pub_core_transcache.h ---*/
+/*--------------------------------------------------------------------*/
+
+/*
+   This file is part of Valgrind, a dynamic binary instrumentation
+   framework.
+
+   Copyright (C) 2000-2013 Julian Seward
+      jseward@acm.org
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2 of the
+   License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+   02111-1307, USA.
+
+   The GNU General Public License is contained in the file COPYING.
+*/
+
+#ifndef __PUB_CORE_TRANSCACHE_H
+#define __PUB_CORE_TRANSCACHE_H
+
+//--------------------------------------------------------------------
+// PURPOSE: This module keeps translations of code from ELF objects
+// with a build-id in files under --translation-cache-dir, so that
+// later runs of the same tool, with the same options, on the same
+// objects can skip VEX entirely for code they have seen before.
+//--------------------------------------------------------------------
+
+#include "pub_core_basics.h"
+#include "libvex.h"                   // VexGuestExtents
+
+/* A translation as stored in the cache.  Everything m_translate
+   needs to validate it and hand it to VG_(add_to_transtab). */
+typedef
+   struct {
+      VexGuestExtents vge;
+      UInt            sc_bitset;   /* needs_self_check result */
+      UInt            px;          /* VexRegisterUpdates in force */
+      Bool            is_self_checking;
+      UInt            n_guest_instrs;
+      const UChar*    code;
+      UInt            code_len;
+   }
+   CachedTrans;
+
+/* Called once, after the tool's post_clo_init.  Turns the cache off
+   if the tool can't use it. */
+extern void VG_(transcache_init) ( void );
+
+/* Is the cache in use at all? */
+extern Bool VG_(transcache_enabled) ( void );
+
+/* Look for a stored translation starting at 'addr' whose guest bytes
+   are unchanged.  On success *ct is filled in; ct->code remains valid
+   until the next call to VG_(transcache_add). */
+extern Bool VG_(transcache_lookup) ( Addr addr, /*OUT*/CachedTrans* ct );
+
+/* Offer a freshly made translation starting at 'addr' for storing.
+   It is silently ignored unless all of it comes from the text of a
+   single object with a build-id. */
+extern void VG_(transcache_add) ( Addr addr, const CachedTrans* ct );
+
+/* Write out everything added since the last flush.  Called at exit
+   and before execve. */
+extern void VG_(transcache_flush) ( void );
+
+extern void VG_(print_transcache_stats) ( void );
+
+#endif   // __PUB_CORE_TRANSCACHE_H
+
+/*--------------------------------------------------------------------*/
+/*--- end                                                          ---*/
+/*--------------------------------------------------------------------*/
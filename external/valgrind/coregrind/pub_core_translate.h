@@ -46,6 +46,10 @@ Bool VG_(translate) ( ThreadId tid,
                       ULong    bbs_done,
                       Bool     allow_redirection );
 
+/* Make again, with more optimisation, the blocks which have been
+   found to be hot since the last call.  See --tier-up-threshold. */
+extern void VG_(translate_hot_blocks) ( ThreadId tid, ULong bbs_done );
+
 extern void VG_(print_translation_stats) ( void );
 
 #endif   // __PUB_CORE_TRANSLATE_H
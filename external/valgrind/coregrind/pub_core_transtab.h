@@ -53,11 +53,27 @@ typedef
 extern __attribute__((aligned(16)))
        FastCacheEntry VG_(tt_fast) [VG_TT_FAST_SIZE];
 
+/* Odd while an entry of VG_(tt_fast) is being given a new .host, and
+   advanced again when that is done; see m_transtab.c. */
+extern volatile UInt VG_(tt_fast_gen);
+
 #define TRANSTAB_BOGUS_GUEST_ADDR ((Addr)1)
 
 
-/* Initialises the TC, using VG_(clo_num_transtab_sectors)
-   and VG_(clo_avg_transtab_entry_size).
+/* VG_(tt_fast) is the first way of a set-associative cache; the
+   dispatchers only ever look there.  The other ways are private to
+   m_transtab and are consulted on a miss before doing a full lookup.
+   VG_(clo_tt_fast_ways) must be >= 1 and <= MAX_TT_FAST_WAYS. */
+#define MAX_TT_FAST_WAYS 8
+extern UInt VG_(clo_tt_fast_ways);
+
+/* If True, translations that appear to be hot are carried over into
+   a sector when it is recycled, rather than thrown away with the
+   rest of its contents. */
+extern Bool VG_(clo_keep_hot_translations);
+
+/* Initialises the TC, using VG_(clo_num_transtab_sectors),
+   VG_(clo_avg_transtab_entry_size) and VG_(clo_tt_fast_ways).
    VG_(clo_num_transtab_sectors) must be >= MIN_N_SECTORS
    and <= MAX_N_SECTORS. */
 extern void VG_(init_tt_tc)       ( void );
@@ -113,6 +129,12 @@ extern Bool VG_(search_transtab) ( /*OUT*/Addr*  res_hcode,
 extern void VG_(discard_translations) ( Addr  start, ULong range,
                                         const HChar* who );
 
+/* Delete the translation whose entry point is 'entry', if any, as
+   a better one is about to take its place.  Unlike
+   VG_(discard_translations), other translations of the same code are
+   left alone. */
+extern Bool VG_(discard_translation_at) ( Addr entry );
+
 extern void VG_(print_tt_tc_stats) ( void );
 
 extern UInt VG_(get_bbs_translated) ( void );
@@ -31,8 +31,10 @@
 #ifndef __PUB_CORE_TRANSTAB_ASM_H
 #define __PUB_CORE_TRANSTAB_ASM_H
 
-/* Constants for the fast translation lookup cache.  It is a direct
-   mapped cache, with 2^VG_TT_FAST_BITS entries.
+/* Constants for the fast translation lookup cache.  As far as the
+   dispatchers are concerned it is a direct mapped cache, with
+   2^VG_TT_FAST_BITS entries.  m_transtab keeps further ways of each
+   set (see VG_(clo_tt_fast_ways)) that are only probed from C.
 
    On x86/amd64, the cache index is computed as
    'address[VG_TT_FAST_BITS-1 : 0]'.
@@ -64,7 +64,7 @@ static ULong g_max_bytes_live  = 0; // the max residency point
 
 
 //------------------------------------------------------------//
-//--- an Interval Tree of live blocks                      ---//
+//--- a page-granular index of live blocks                 ---//
 //------------------------------------------------------------//
 
 /* Tracks information about live blocks. */
@@ -83,22 +83,209 @@ typedef
    }
    Block;
 
-/* May not contain zero-sized blocks.  May not contain
-   overlapping blocks. */
-static WordFM* interval_tree = NULL;  /* WordFM* Block* void */
+/* Every memory access not close to SP has to be mapped to the live
+   block containing it, if any, so this lookup must be fast, and in
+   particular must be fast at saying "no block here", which is the
+   answer for all accesses to static data, mmap'd memory, other
+   threads' stacks, etc.
 
-/* Here's the comparison function.  Since the tree is required
-to contain non-zero sized, non-overlapping blocks, it's good
-enough to consider any overlap as a match. */
-static Word interval_tree_Cmp ( UWord k1, UWord k2 )
+   So blocks are indexed by page:  an open-addressing hash table maps
+   each page number to a sorted array of the blocks overlapping that
+   page.  A lookup is one hash probe (usually) and a binary search of
+   a small contiguous array.  A block overlapping several pages is
+   listed in each of them, except that blocks bigger than BIG_BLOCK_SZB
+   are kept in a separate sorted array instead, so that huge
+   allocations don't bloat the table.
+
+   Blocks may not be zero-sized and may not overlap. */
+
+#define PAGE_BITS      12
+#define BIG_BLOCK_SZB  (64 << PAGE_BITS)
+
+typedef
+   struct {
+      Addr   payload;  /* == bk->payload, kept here for the search */
+      Block* bk;
+   }
+   BlockRef;
+
+typedef
+   struct {
+      UWord     page;      /* page number; 0 means the slot is free */
+      UInt      n_refs;
+      UInt      max_refs;
+      BlockRef* refs;      /* [0 .. n_refs-1], sorted by payload */
+   }
+   PageEntry;
+
+static PageEntry* page_table      = NULL;
+static UInt       page_table_bits = 0;  /* page_table has 2^bits slots */
+static UWord      page_table_used = 0;
+
+static BlockRef*  big_blocks      = NULL;
+static UInt       n_big_blocks    = 0;
+static UInt       max_big_blocks  = 0;
+
+static UWord stats__n_page_table_resizes = 0;
+
+static inline UWord page_hash ( UWord page )
 {
-   Block* b1 = (Block*)k1;
-   Block* b2 = (Block*)k2;
-   tl_assert(b1->req_szB > 0);
-   tl_assert(b2->req_szB > 0);
-   if (b1->payload + b1->req_szB <= b2->payload) return -1;
-   if (b2->payload + b2->req_szB <= b1->payload) return  1;
-   return 0;
+   /* Fibonacci hashing: the top bits of the product are well mixed. */
+#  if VG_WORDSIZE == 8
+   return (page * 0x9E3779B97F4A7C15ULL) >> (64 - page_table_bits);
+#  else
+   return (page * 0x9E3779B9U) >> (32 - page_table_bits);
+#  endif
+}
+
+static PageEntry* find_PageEntry ( UWord page )
+{
+   UWord mask = ((UWord)1 << page_table_bits) - 1;
+   UWord i    = page_hash(page);
+   while (True) {
+      PageEntry* pe = &page_table[i];
+      if (LIKELY(pe->page == page))
+         return pe;
+      if (pe->page == 0)
+         return NULL;
+      i = (i + 1) & mask;
+   }
+}
+
+static void resize_page_table ( UInt new_bits )
+{
+   PageEntry* old_table = page_table;
+   UWord      old_size  = old_table ? (UWord)1 << page_table_bits : 0;
+   UWord      i, mask;
+
+   page_table_bits = new_bits;
+   page_table = VG_(calloc)("dh.main.rpt.1",
+                            (UWord)1 << new_bits, sizeof(PageEntry));
+   mask = ((UWord)1 << new_bits) - 1;
+   for (i = 0; i < old_size; i++) {
+      UWord j;
+      if (old_table[i].page == 0)
+         continue;
+      j = page_hash(old_table[i].page);
+      while (page_table[j].page != 0)
+         j = (j + 1) & mask;
+      page_table[j] = old_table[i];
+   }
+   if (old_table)
+      VG_(free)(old_table);
+   stats__n_page_table_resizes++;
+}
+
+static PageEntry* find_or_add_PageEntry ( UWord page )
+{
+   UWord mask, i;
+   PageEntry* pe = find_PageEntry(page);
+   if (pe)
+      return pe;
+
+   // Keep the load factor at or below 1/2.
+   if (2 * (page_table_used + 1) > ((UWord)1 << page_table_bits))
+      resize_page_table(page_table_bits + 1);
+
+   mask = ((UWord)1 << page_table_bits) - 1;
+   i = page_hash(page);
+   while (page_table[i].page != 0)
+      i = (i + 1) & mask;
+   pe = &page_table[i];
+   pe->page     = page;
+   pe->n_refs   = 0;
+   pe->max_refs = 0;
+   pe->refs     = NULL;
+   page_table_used++;
+   return pe;
+}
+
+// Removes an empty entry, shifting back any later entries of its probe
+// sequence that would otherwise become unreachable.
+static void remove_PageEntry ( PageEntry* pe )
+{
+   UWord mask = ((UWord)1 << page_table_bits) - 1;
+   UWord i    = pe - page_table;
+   UWord j    = i;
+
+   tl_assert(pe->n_refs == 0);
+   if (pe->refs)
+      VG_(free)(pe->refs);
+   while (True) {
+      UWord k;
+      j = (j + 1) & mask;
+      if (page_table[j].page == 0)
+         break;
+      k = page_hash(page_table[j].page);
+      // Move entry j back to i, unless its home slot k lies
+      // cyclically in (i, j].
+      if ( (i <= j) ? (i < k && k <= j) : (i < k || k <= j) )
+         continue;
+      page_table[i] = page_table[j];
+      i = j;
+   }
+   page_table[i].page     = 0;
+   page_table[i].n_refs   = 0;
+   page_table[i].max_refs = 0;
+   page_table[i].refs     = NULL;
+   page_table_used--;
+}
+
+// Returns the index of the first of refs[0 .. n-1] whose payload is > a.
+static inline UInt refs_upper_bound ( const BlockRef* refs, UInt n, Addr a )
+{
+   UInt lo = 0, hi = n;
+   while (lo < hi) {
+      UInt mid = lo + (hi - lo) / 2;
+      if (refs[mid].payload <= a)
+         lo = mid + 1;
+      else
+         hi = mid;
+   }
+   return lo;
+}
+
+static void insert_BlockRef ( BlockRef** refs, UInt* n_refs, UInt* max_refs,
+                              Block* bk )
+{
+   UInt i;
+   if (*n_refs == *max_refs) {
+      *max_refs = *max_refs == 0 ? 4 : 2 * *max_refs;
+      *refs = VG_(realloc)("dh.main.iBr.1", *refs,
+                           *max_refs * sizeof(BlockRef));
+   }
+   i = refs_upper_bound(*refs, *n_refs, bk->payload);
+   VG_(memmove)(&(*refs)[i+1], &(*refs)[i],
+                (*n_refs - i) * sizeof(BlockRef));
+   (*refs)[i].payload = bk->payload;
+   (*refs)[i].bk      = bk;
+   (*n_refs)++;
+}
+
+static void remove_BlockRef ( BlockRef* refs, UInt* n_refs, Block* bk )
+{
+   UInt i = refs_upper_bound(refs, *n_refs, bk->payload);
+   tl_assert(i > 0 && refs[i-1].bk == bk);
+   i--;
+   VG_(memmove)(&refs[i], &refs[i+1], (*n_refs - i - 1) * sizeof(BlockRef));
+   (*n_refs)--;
+}
+
+static void add_Block ( Block* bk )
+{
+   tl_assert(bk->req_szB > 0);
+   if (bk->req_szB > BIG_BLOCK_SZB) {
+      insert_BlockRef(&big_blocks, &n_big_blocks, &max_big_blocks, bk);
+   } else {
+      UWord page;
+      UWord first = bk->payload >> PAGE_BITS;
+      UWord last  = (bk->payload + bk->req_szB - 1) >> PAGE_BITS;
+      tl_assert(first > 0);  // page number 0 marks a free slot
+      for (page = first; page <= last; page++) {
+         PageEntry* pe = find_or_add_PageEntry(page);
+         insert_BlockRef(&pe->refs, &pe->n_refs, &pe->max_refs, bk);
+      }
+   }
 }
 
 // 2-entry cache for find_Block_containing
@@ -109,6 +296,27 @@ static UWord stats__n_fBc_cached = 0;
 static UWord stats__n_fBc_uncached = 0;
 static UWord stats__n_fBc_notfound = 0;
 
+// Remove a block from the index;  it must be present.
+static void remove_Block ( Block* bk )
+{
+   if (bk->req_szB > BIG_BLOCK_SZB) {
+      remove_BlockRef(big_blocks, &n_big_blocks, bk);
+   } else {
+      UWord page;
+      UWord first = bk->payload >> PAGE_BITS;
+      UWord last  = (bk->payload + bk->req_szB - 1) >> PAGE_BITS;
+      for (page = first; page <= last; page++) {
+         PageEntry* pe = find_PageEntry(page);
+         tl_assert(pe);
+         remove_BlockRef(pe->refs, &pe->n_refs, bk);
+         if (pe->n_refs == 0)
+            remove_PageEntry(pe);
+      }
+   }
+   if (fbc_cache0 == bk) fbc_cache0 = NULL;
+   if (fbc_cache1 == bk) fbc_cache1 = NULL;
+}
+
 static Block* find_Block_containing ( Addr a )
 {
    if (LIKELY(fbc_cache0
@@ -128,21 +336,31 @@ static Block* find_Block_containing ( Addr a )
       stats__n_fBc_cached++;
       return fbc_cache0;
    }
-   Block fake;
-   fake.payload = a;
-   fake.req_szB = 1;
-   UWord foundkey = 1;
-   UWord foundval = 1;
-   Bool found = VG_(lookupFM)( interval_tree,
-                               &foundkey, &foundval, (UWord)&fake );
-   if (!found) {
+
+   Block* res = NULL;
+   UInt   i;
+   PageEntry* pe = find_PageEntry(a >> PAGE_BITS);
+   if (pe) {
+      i = refs_upper_bound(pe->refs, pe->n_refs, a);
+      if (i > 0) {
+         Block* bk = pe->refs[i-1].bk;
+         if (a < bk->payload + bk->req_szB)
+            res = bk;
+      }
+   }
+   // Big blocks can share a page with small ones, so look there too.
+   if (!res && n_big_blocks > 0) {
+      i = refs_upper_bound(big_blocks, n_big_blocks, a);
+      if (i > 0) {
+         Block* bk = big_blocks[i-1].bk;
+         if (a < bk->payload + bk->req_szB)
+            res = bk;
+      }
+   }
+   if (!res) {
       stats__n_fBc_notfound++;
       return NULL;
    }
-   tl_assert(foundval == 0); // we don't store vals in the interval tree
-   tl_assert(foundkey != 1);
-   Block* res = (Block*)foundkey;
-   tl_assert(res != &fake);
    // put at the top position
    fbc_cache1 = fbc_cache0;
    fbc_cache0 = res;
@@ -150,17 +368,42 @@ static Block* find_Block_containing ( Addr a )
    return res;
 }
 
-// delete a block; asserts if not found.  (viz, 'a' must be
-// known to be present.)
-static void delete_Block_starting_at ( Addr a )
+static Int cmp_Blocks_by_payload ( const void* v1, const void* v2 )
 {
-   Block fake;
-   fake.payload = a;
-   fake.req_szB = 1;
-   Bool found = VG_(delFromFM)( interval_tree,
-                                NULL, NULL, (Addr)&fake );
-   tl_assert(found);
-   fbc_cache0 = fbc_cache1 = NULL;
+   const Block* b1 = *(const Block* const *)v1;
+   const Block* b2 = *(const Block* const *)v2;
+   if (b1->payload < b2->payload) return -1;
+   if (b1->payload > b2->payload) return  1;
+   return 0;
+}
+
+// Returns all the live blocks, in address order, in a VG_(malloc)'d array.
+static Block** get_all_Blocks ( /*OUT*/UWord* n_blocks )
+{
+   UWord   i, n = 0, max = n_big_blocks;
+   UWord   size = page_table ? (UWord)1 << page_table_bits : 0;
+   Block** blocks;
+
+   for (i = 0; i < size; i++)
+      max += page_table[i].n_refs;
+   blocks = VG_(malloc)("dh.main.gaB.1", (max + 1) * sizeof(Block*));
+
+   // A block spanning several pages is listed in each of them;  take it
+   // from the first.
+   for (i = 0; i < size; i++) {
+      PageEntry* pe = &page_table[i];
+      UInt j;
+      for (j = 0; j < pe->n_refs; j++) {
+         if ((pe->refs[j].payload >> PAGE_BITS) == pe->page)
+            blocks[n++] = pe->refs[j].bk;
+      }
+   }
+   for (i = 0; i < n_big_blocks; i++)
+      blocks[n++] = big_blocks[i].bk;
+
+   VG_(ssort)(blocks, n, sizeof(Block*), cmp_Blocks_by_payload);
+   *n_blocks = n;
+   return blocks;
 }
 
 
@@ -457,7 +700,7 @@ void* new_block ( ThreadId tid, void* p, SizeT req_szB, SizeT req_alignB,
    if ((SSizeT)req_szB < 0) return NULL;
 
    if (req_szB == 0)
-      req_szB = 1;  /* can't allow zero-sized blocks in the interval tree */
+      req_szB = 1;  /* can't allow zero-sized blocks in the block index */
 
    // Allocate and zero if necessary
    if (!p) {
@@ -488,9 +731,7 @@ void* new_block ( ThreadId tid, void* p, SizeT req_szB, SizeT req_alignB,
       VG_(memset)(bk->histoW, 0, req_szB * sizeof(UShort));
    }
 
-   Bool present = VG_(addToFM)( interval_tree, (UWord)bk, (UWord)0/*no val*/);
-   tl_assert(!present);
-   fbc_cache0 = fbc_cache1 = NULL;
+   add_Block(bk);
 
    intro_Block(bk);
 
@@ -525,7 +766,7 @@ void die_block ( void* p, Bool custom_free )
    retire_Block(bk, True/*because_freed*/);
 
    VG_(cli_free)( (void*)bk->payload );
-   delete_Block_starting_at( bk->payload );
+   remove_Block( bk );
    if (bk->histoW) {
       VG_(free)( bk->histoW );
       bk->histoW = NULL;
@@ -567,10 +808,13 @@ void* renew_block ( ThreadId tid, void* p_old, SizeT new_req_szB )
    // Actually do the allocation, if necessary.
    if (new_req_szB <= bk->req_szB) {
 
-      // New size is smaller or same; block not moved.
+      // New size is smaller or same; block not moved.  It may cover
+      // fewer pages now, though, so re-index it.
       apinfo_change_cur_bytes_live(bk->ap,
                                    (Long)new_req_szB - (Long)bk->req_szB);
+      remove_Block( bk );
       bk->req_szB = new_req_szB;
+      add_Block( bk );
       return p_old;
 
    } else {
@@ -588,10 +832,10 @@ void* renew_block ( ThreadId tid, void* p_old, SizeT new_req_szB )
       VG_(cli_free)(p_old);
 
       // Since the block has moved, we need to re-insert it into the
-      // interval tree at the new place.  Do this by removing
+      // block index at the new place.  Do this by removing
       // and re-adding it.
-      delete_Block_starting_at( (Addr)p_old );
-      // now 'bk' is no longer in the tree, but the Block itself
+      remove_Block( bk );
+      // now 'bk' is no longer in the index, but the Block itself
       // is still alive
 
       // Update the metadata.
@@ -601,10 +845,7 @@ void* renew_block ( ThreadId tid, void* p_old, SizeT new_req_szB )
       bk->req_szB = new_req_szB;
 
       // and re-add
-      Bool present
-         = VG_(addToFM)( interval_tree, (UWord)bk, (UWord)0/*no val*/); 
-      tl_assert(!present);
-      fbc_cache0 = fbc_cache1 = NULL;
+      add_Block( bk );
 
       return p_new;
    }
@@ -720,6 +961,40 @@ void dh_handle_read ( Addr addr, UWord szB )
 }
 
 
+// Memory accesses made by instructions are not passed to the handlers
+// above one at a time.  Instead, each superblock records the accesses it
+// makes in 'events' (one slot per load/store/etc, the address being 0 if
+// the access was filtered out as a stack access), and calls
+// dh_handle_events once, before each exit and at its end.  That replaces
+// a helper call per access with a couple of stores.
+#define N_EVENTS 64
+
+typedef
+   struct {
+      Addr  addr;         /* 0 if the access is to be ignored */
+      UWord szB_isWrite;  /* (szB << 1) | isWrite */
+   }
+   Event;
+
+static Event events[N_EVENTS];
+
+static VG_REGPARM(1)
+void dh_handle_events ( UWord n_events )
+{
+   UWord i;
+   for (i = 0; i < n_events; i++) {
+      Addr  addr = events[i].addr;
+      UWord szB  = events[i].szB_isWrite >> 1;
+      if (addr == 0)
+         continue;
+      if (events[i].szB_isWrite & 1)
+         dh_handle_write(addr, szB);
+      else
+         dh_handle_read(addr, szB);
+   }
+}
+
+
 // Handle reads and writes by syscalls (read == kernel
 // reads user space, write == kernel writes user space).
 // Assumes no such read or write spans a heap block
@@ -795,39 +1070,37 @@ void add_counter_update(IRSB* sbOut, Int n)
    addStmtToIRSB( sbOut, st3 );
 }
 
+// Emits a call to dh_handle_events for the events recorded so far in
+// this superblock, if any.
+static
+void flushEvents(IRSB* sbOut, Int* n_events)
+{
+   IRDirty* di;
+
+   if (*n_events == 0)
+      return;
+   di = unsafeIRDirty_0_N( 1/*regparms*/,
+                           "dh_handle_events",
+                           VG_(fnptr_to_fnentry)( &dh_handle_events ),
+                           mkIRExprVec_1( mkIRExpr_HWord(*n_events) ) );
+   addStmtToIRSB( sbOut, IRStmt_Dirty(di) );
+   *n_events = 0;
+}
+
 static
 void addMemEvent(IRSB* sbOut, Bool isWrite, Int szB, IRExpr* addr,
-                 Int goff_sp)
+                 Int goff_sp, Int* n_events)
 {
    IRType   tyAddr   = Ity_INVALID;
-   const HChar* hName= NULL;
-   void*    hAddr    = NULL;
-   IRExpr** argv     = NULL;
-   IRDirty* di       = NULL;
+   Event*   ev       = NULL;
 
    const Int THRESH = 4096 * 4; // somewhat arbitrary
    const Int rz_szB = VG_STACK_REDZONE_SZB;
 
    tyAddr = typeOfIRExpr( sbOut->tyenv, addr );
    tl_assert(tyAddr == Ity_I32 || tyAddr == Ity_I64);
-
-   if (isWrite) {
-      hName = "dh_handle_write";
-      hAddr = &dh_handle_write;
-   } else {
-      hName = "dh_handle_read";
-      hAddr = &dh_handle_read;
-   }
-
-   argv = mkIRExprVec_2( addr, mkIRExpr_HWord(szB) );
-
-   /* Add the helper. */
-   tl_assert(hName);
-   tl_assert(hAddr);
-   tl_assert(argv);
-   di = unsafeIRDirty_0_N( 2/*regparms*/,
-                           hName, VG_(fnptr_to_fnentry)( hAddr ),
-                           argv );
+   tl_assert(*n_events < N_EVENTS);
+   ev = &events[*n_events];
 
    /* Generate the guard condition: "(addr - (SP - RZ)) >u N", for
       some arbitrary N.  If that fails then addr is in the range (SP -
@@ -863,9 +1136,29 @@ void addMemEvent(IRSB* sbOut, Bool isWrite, Int szB, IRExpr* addr,
                 ? binop(Iop_CmpLT32U, mkU32(THRESH), mkexpr(diff))
                 : binop(Iop_CmpLT64U, mkU64(THRESH), mkexpr(diff)))
    );
-   di->guard = mkexpr(guard);
 
-   addStmtToIRSB( sbOut, IRStmt_Dirty(di) );
+   /* Record the event:  ev->addr = guard ? addr : 0, and its size and
+      kind. */
+   IRTemp ev_addr = newIRTemp(sbOut->tyenv, tyAddr);
+   addStmtToIRSB(
+      sbOut,
+      assign(ev_addr,
+             IRExpr_ITE(mkexpr(guard), addr,
+                        tyAddr == Ity_I32 ? mkU32(0) : mkU64(0)))
+   );
+   addStmtToIRSB(
+      sbOut,
+      IRStmt_Store(END, mkIRExpr_HWord( (HWord)&ev->addr ), mkexpr(ev_addr))
+   );
+   addStmtToIRSB(
+      sbOut,
+      IRStmt_Store(END, mkIRExpr_HWord( (HWord)&ev->szB_isWrite ),
+                   mkIRExpr_HWord( ((HWord)szB << 1) | (isWrite ? 1 : 0) ))
+   );
+
+   (*n_events)++;
+   if (*n_events == N_EVENTS)
+      flushEvents(sbOut, n_events);
 }
 
 static
@@ -876,7 +1169,7 @@ IRSB* dh_instrument ( VgCallbackClosure* closure,
                       const VexArchInfo* archinfo_host,
                       IRType gWordTy, IRType hWordTy )
 {
-   Int   i, n = 0;
+   Int   i, n = 0, n_events = 0;
    IRSB* sbOut;
    IRTypeEnv* tyenv = sbIn->tyenv;
 
@@ -886,6 +1179,7 @@ IRSB* dh_instrument ( VgCallbackClosure* closure,
    // - just before any Ist_Exit statements;
    // - just before the IRSB's end.
    // In the former case, we zero 'n' and then continue instrumenting.
+   // Pending memory events are flushed at the same places.
    
    sbOut = deepCopyIRSBExceptStmts(sbIn);
 
@@ -909,6 +1203,7 @@ IRSB* dh_instrument ( VgCallbackClosure* closure,
          }
 
          case Ist_Exit: {
+            flushEvents(sbOut, &n_events);
             if (n > 0) {
                // Add an increment before the Exit statement, then reset 'n'.
                add_counter_update(sbOut, n);
@@ -925,7 +1220,7 @@ IRSB* dh_instrument ( VgCallbackClosure* closure,
                // that's not interesting.
                addMemEvent( sbOut, False/*!isWrite*/,
                             sizeofIRType(data->Iex.Load.ty),
-                            aexpr, goff_sp );
+                            aexpr, goff_sp, &n_events );
             }
             break;
          }
@@ -935,7 +1230,7 @@ IRSB* dh_instrument ( VgCallbackClosure* closure,
             IRExpr* aexpr = st->Ist.Store.addr;
             addMemEvent( sbOut, True/*isWrite*/, 
                          sizeofIRType(typeOfIRExpr(tyenv, data)),
-                         aexpr, goff_sp );
+                         aexpr, goff_sp, &n_events );
             break;
          }
 
@@ -953,10 +1248,10 @@ IRSB* dh_instrument ( VgCallbackClosure* closure,
                // than two cache lines in the simulation.
                if (d->mFx == Ifx_Read || d->mFx == Ifx_Modify)
                   addMemEvent( sbOut, False/*!isWrite*/,
-                               dataSize, d->mAddr, goff_sp );
+                               dataSize, d->mAddr, goff_sp, &n_events );
                if (d->mFx == Ifx_Write || d->mFx == Ifx_Modify)
                   addMemEvent( sbOut, True/*isWrite*/,
-                               dataSize, d->mAddr, goff_sp );
+                               dataSize, d->mAddr, goff_sp, &n_events );
             } else {
                tl_assert(d->mAddr == NULL);
                tl_assert(d->mSize == 0);
@@ -978,9 +1273,9 @@ IRSB* dh_instrument ( VgCallbackClosure* closure,
             if (cas->dataHi != NULL)
                dataSize *= 2; /* since it's a doubleword-CAS */
             addMemEvent( sbOut, False/*!isWrite*/,
-                         dataSize, cas->addr, goff_sp );
+                         dataSize, cas->addr, goff_sp, &n_events );
             addMemEvent( sbOut, True/*isWrite*/,
-                         dataSize, cas->addr, goff_sp );
+                         dataSize, cas->addr, goff_sp, &n_events );
             break;
          }
 
@@ -991,13 +1286,13 @@ IRSB* dh_instrument ( VgCallbackClosure* closure,
                dataTy = typeOfIRTemp(tyenv, st->Ist.LLSC.result);
                addMemEvent( sbOut, False/*!isWrite*/,
                             sizeofIRType(dataTy),
-                            st->Ist.LLSC.addr, goff_sp );
+                            st->Ist.LLSC.addr, goff_sp, &n_events );
             } else {
                /* SC */
                dataTy = typeOfIRExpr(tyenv, st->Ist.LLSC.storedata);
                addMemEvent( sbOut, True/*isWrite*/,
                             sizeofIRType(dataTy),
-                            st->Ist.LLSC.addr, goff_sp );
+                            st->Ist.LLSC.addr, goff_sp, &n_events );
             }
             break;
          }
@@ -1009,6 +1304,7 @@ IRSB* dh_instrument ( VgCallbackClosure* closure,
       addStmtToIRSB( sbOut, st );
    }
 
+   flushEvents(sbOut, &n_events);
    if (n > 0) {
       // Add an increment before the SB end.
       add_counter_update(sbOut, n);
@@ -1272,15 +1568,15 @@ static void dh_fini(Int exit_status)
    // access ratios which are too low (zero, in the worst case)
    // for such blocks, since the accesses that do get made will
    // (if we skip this step) not get folded into the AP summaries.
-   UWord keyW, valW;
-   VG_(initIterFM)( interval_tree );
-   while (VG_(nextIterFM)( interval_tree, &keyW, &valW )) {
-      Block* bk = (Block*)keyW;
-      tl_assert(valW == 0);
-      tl_assert(bk);
-      retire_Block(bk, False/*!because_freed*/);
+   // (The blocks are retired in address order, since the histogram
+   // state of an AP depends on the order its blocks retire in.)
+   UWord   i, n_blocks;
+   Block** blocks = get_all_Blocks( &n_blocks );
+   for (i = 0; i < n_blocks; i++) {
+      tl_assert(blocks[i]);
+      retire_Block(blocks[i], False/*!because_freed*/);
    }
-   VG_(doneIterFM)( interval_tree );
+   VG_(free)( blocks );
 
    // show results
    VG_(umsg)("======== SUMMARY STATISTICS ========\n");
@@ -1329,6 +1625,9 @@ static void dh_fini(Int exit_status)
                 stats__n_fBc_cached,
                 stats__n_fBc_uncached);
       VG_(dmsg)("          notfound: %'lu\n", stats__n_fBc_notfound);
+      VG_(dmsg)(" dhat: page table: %'lu pages, %'lu resizes,"
+                " %'u big blocks\n",
+                page_table_used, stats__n_page_table_resizes, n_big_blocks);
       VG_(dmsg)("\n");
    }
 }
@@ -1380,14 +1679,11 @@ static void dh_pre_clo_init(void)
    //VG_(track_pre_mem_read_asciiz) ( check_mem_is_defined_asciiz );
    VG_(track_post_mem_write)      ( dh_handle_noninsn_write );
 
-   tl_assert(!interval_tree);
+   tl_assert(!page_table);
    tl_assert(!fbc_cache0);
    tl_assert(!fbc_cache1);
 
-   interval_tree = VG_(newFM)( VG_(malloc),
-                               "dh.main.interval_tree.1",
-                               VG_(free),
-                               interval_tree_Cmp );
+   resize_page_table( 10 );
 
    apinfo = VG_(newFM)( VG_(malloc),
                         "dh.main.apinfo.1",
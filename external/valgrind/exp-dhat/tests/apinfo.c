@@ -0,0 +1,67 @@
+#include <stdlib.h>
+
+// Exercises the APInfo counts for blocks that DHAT indexes in different
+// ways: blocks bigger than BIG_BLOCK_SZB (256KB), blocks spanning several
+// pages, and blocks shrunk in place by realloc.  Each block is allocated
+// at its own line so that it gets its own alloc point.
+
+static void write_every ( volatile char* p, size_t n, size_t step )
+{
+   size_t i;
+   for (i = 0; i < n; i += step)
+      p[i] = 1;
+}
+
+static int read_every ( volatile char* p, size_t n, size_t step )
+{
+   size_t i;
+   int sum = 0;
+   for (i = 0; i < n; i += step)
+      sum += p[i];
+   return sum;
+}
+
+int main ( void )
+{
+   volatile char *big, *big2, *s;
+   volatile char* multi[4];
+   int i, sum = 0;
+
+   // A big block: 74 bytes written, 1 byte read.
+   big = malloc(300000);
+   write_every(big, 300000, 4096);
+   sum += big[300000-1];
+   free((void*)big);
+
+   // A big block shrunk below BIG_BLOCK_SZB: 69 bytes written, 25 read.
+   // The read past the new end must not be attributed to the block.
+   big2 = malloc(280000);
+   write_every(big2, 280000, 4096);
+   big2 = realloc((void*)big2, 100000);
+   sum += read_every(big2, 100000, 4096);
+   sum += big2[200000];
+   free((void*)big2);
+
+   // Four multi-page blocks live at once: 194 bytes written and 97 read
+   // in each.
+   for (i = 0; i < 4; i++) {
+      multi[i] = malloc(3*4096 + 100);
+      write_every(multi[i], 3*4096 + 100, 64);
+   }
+   for (i = 0; i < 4; i++) {
+      sum += read_every(multi[i], 3*4096 + 100, 128);
+      free((void*)multi[i]);
+   }
+
+   // A multi-page block shrunk in place: 200 bytes written, 50 read.
+   // Again the read past the new end must not count.
+   s = malloc(20000);
+   write_every(s, 20000, 100);
+   s = realloc((void*)s, 5000);
+   sum += read_every(s, 5000, 100);
+   sum += s[10000];
+   free((void*)s);
+
+   (void)sum;
+   return 0;
+}
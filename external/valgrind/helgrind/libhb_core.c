@@ -2757,6 +2757,17 @@ static void VtsID__invalidate_caches ( void ); /* fwds */
    - .vts->id == this entry number
    - no specific value for .rc (even 0 is OK)
    - this entry is not on freelist, so u.freelink == VtsID_INVALID
+
+   .epoch_of records which thread, if any, has had this VTS as its
+   write clock (Thr.viW).  A thread's write clock only ever moves
+   forwards (by ticks and joins), and its read clock is always at
+   least its write clock, so if .epoch_of == T then this VTS is <=
+   both of T's current clocks, and that can be concluded without
+   looking at the VTS at all.  This is the same observation that
+   FastTrack's epochs are based on; it is what makes accesses to
+   thread-exclusive data cheap in msmcread/msmcwrite.  VtsTE_NO_EPOCH
+   means no thread has claimed the VTS; VtsTE_SHARED_EPOCH means more
+   than one has, so no conclusion can be drawn.
 */
 typedef
    struct {
@@ -2768,9 +2779,22 @@ typedef
       } u; 
       /* u.freelink only used when vts == NULL,
          u.remap only used when vts != NULL, during pruning. */
+      UInt  epoch_of; /* ThrID, VtsTE_NO_EPOCH or VtsTE_SHARED_EPOCH */
    }
    VtsTE;
 
+/* ThrID 0 is never valid, and ThrIDs never exceed ThrID_MAX_VALID. */
+#define VtsTE_NO_EPOCH      0
+#define VtsTE_SHARED_EPOCH  0xFFFFFFFF
+
+/* Combine two claims about the same VTS value. */
+static inline UInt VtsTE__merge_epochs ( UInt e1, UInt e2 )
+{
+   if (e1 == VtsTE_NO_EPOCH) return e2;
+   if (e2 == VtsTE_NO_EPOCH || e1 == e2) return e1;
+   return VtsTE_SHARED_EPOCH;
+}
+
 /* The VTS table. */
 static XArray* /* of VtsTE */ vts_tab = NULL;
 
@@ -2830,6 +2854,7 @@ static VtsID get_new_VtsID ( void )
    te.vts = NULL;
    te.rc = 0;
    te.u.freelink = VtsID_INVALID;
+   te.epoch_of = VtsTE_NO_EPOCH;
    ii = (VtsID)VG_(addToXA)( vts_tab, &te );
    return ii;
 }
@@ -2883,6 +2908,7 @@ static VtsID vts_tab__find__or__clone_and_add ( VTS* cand )
       ie->vts = in_tab;
       ie->rc = 0;
       ie->u.freelink = VtsID_INVALID;
+      ie->epoch_of = VtsTE_NO_EPOCH;
       in_tab->id = ii;
       return ii;
    }
@@ -3123,6 +3149,10 @@ static void vts_tab__do_GC ( Bool show_stats )
       tl_assert(old_vts->id == i);
       tl_assert(old_vts->ts != NULL);
 
+      /* Pruning removes the same threads from every VTS, so it
+         preserves the ordering that .epoch_of summarises. */
+      UInt old_epoch_of = old_te->epoch_of;
+
       /* It is in use. Make a pruned version. */
       nBeforePruning++;
       nSTSsBefore += old_vts->usedTS;
@@ -3165,6 +3195,9 @@ static void vts_tab__do_GC ( Bool show_stats )
          VTS__delete(new_vts);
          new_vts = identical_version;
          tl_assert(new_vts->id != VtsID_INVALID);
+         VtsTE* id_te = VG_(indexXA)( new_tab, new_vts->id );
+         id_te->epoch_of = VtsTE__merge_epochs( id_te->epoch_of,
+                                                old_epoch_of );
       } else {
          tl_assert(valW == 12345);
          tl_assert(identical_version == NULL);
@@ -3175,6 +3208,7 @@ static void vts_tab__do_GC ( Bool show_stats )
          new_te.vts      = new_vts;
          new_te.rc       = 0;
          new_te.u.freelink = VtsID_INVALID;
+         new_te.epoch_of = old_epoch_of;
          Word j = VG_(addToXA)( new_tab, &new_te );
          tl_assert(j <= i);
          tl_assert(j == new_VtsID_ctr - 1);
@@ -3487,6 +3521,21 @@ static inline VtsID VtsID__join2 ( VtsID vi1, VtsID vi2 ) {
    return LIKELY(vi1 == vi2)  ? vi1  : VtsID__join2_WRK(vi1, vi2);
 }
 
+/* Record that vi has just become thr's write clock.  See comments on
+   VtsTE.epoch_of. */
+static void VtsID__note_epoch ( VtsID vi, Thr* thr ) {
+   VtsTE* te = VG_(indexXA)( vts_tab, vi );
+   tl_assert(te->vts);
+   te->epoch_of = VtsTE__merge_epochs( te->epoch_of, thr->thrid );
+}
+
+/* Is vi a VTS that thr has previously had as its write clock?  If so,
+   vi <= thr->viW <= thr->viR. */
+static inline Bool VtsID__is_epoch_of ( VtsID vi, Thr* thr ) {
+   const VtsTE* te = VG_(indexXA)( vts_tab, vi );
+   return te->epoch_of == thr->thrid;
+}
+
 /* create a singleton VTS, namely [thr:1] */
 static VtsID VtsID__mk_Singleton ( Thr* thr, ULong tym ) {
    temp_max_sized_VTS->usedTS = 0;
@@ -4927,8 +4976,10 @@ static void do_RCEC_GC ( void )
 
 static ULong stats__msmcread         = 0;
 static ULong stats__msmcread_change  = 0;
+static ULong stats__msmcread_epoch   = 0;
 static ULong stats__msmcwrite        = 0;
 static ULong stats__msmcwrite_change = 0;
+static ULong stats__msmcwrite_epoch  = 0;
 
 /* Some notes on the H1 history mechanism:
 
@@ -5119,7 +5170,19 @@ static inline SVal msmcread ( SVal svOld,
       VtsID tviW  = acc_thr->viW;
       VtsID rmini = SVal__unC_Rmin(svOld);
       VtsID wmini = SVal__unC_Wmin(svOld);
-      Bool  leq   = VtsID__cmpLEQ(rmini,tviR);
+      Bool  leq;
+      /* Epoch fast path: if both constraints are clocks this thread
+         has itself held, the access is ordered after them and the new
+         Wmin is just tviW, so no VTS needs to be looked at.  This is
+         the common case for data that is not shared between
+         threads. */
+      if ((rmini == tviR || VtsID__is_epoch_of(rmini, acc_thr))
+          && (wmini == tviW || VtsID__is_epoch_of(wmini, acc_thr))) {
+         stats__msmcread_epoch++;
+         svNew = SVal__mkC( rmini, tviW );
+         goto out;
+      }
+      leq = VtsID__cmpLEQ(rmini,tviR);
       if (LIKELY(leq)) {
          /* no race */
          /* Note: RWLOCK subtlety: use tviW, not tviR */
@@ -5182,7 +5245,14 @@ static inline SVal msmcwrite ( SVal svOld,
    if (LIKELY(SVal__isC(svOld))) {
       VtsID tviW  = acc_thr->viW;
       VtsID wmini = SVal__unC_Wmin(svOld);
-      Bool  leq   = VtsID__cmpLEQ(wmini,tviW);
+      Bool  leq;
+      /* Epoch fast path; see msmcread. */
+      if (wmini == tviW || VtsID__is_epoch_of(wmini, acc_thr)) {
+         stats__msmcwrite_epoch++;
+         svNew = SVal__mkC( tviW, tviW );
+         goto out;
+      }
+      leq = VtsID__cmpLEQ_WRK(wmini,tviW);
       if (LIKELY(leq)) {
          /* no race */
          svNew = SVal__mkC( tviW, tviW );
@@ -6271,6 +6341,7 @@ Thr* libhb_init (
    thr->viW = vi;
    VtsID__rcinc(thr->viR);
    VtsID__rcinc(thr->viW);
+   VtsID__note_epoch(thr->viW, thr);
 
    show_thread_state("  root", thr);
    return thr;
@@ -6290,6 +6361,7 @@ Thr* libhb_create ( Thr* parent )
    Filter__clear(child->filter, "libhb_create(child)");
    VtsID__rcinc(child->viR);
    VtsID__rcinc(child->viW);
+   VtsID__note_epoch(child->viW, child);
    /* We need to do note_local_Kw_n_stack_for( child ), but it's too
       early for that - it may not have a valid TId yet.  So, let
       libhb_Thr_resumes pick it up the first time the thread runs. */
@@ -6305,6 +6377,7 @@ Thr* libhb_create ( Thr* parent )
    Filter__clear(parent->filter, "libhb_create(parent)");
    VtsID__rcinc(parent->viR);
    VtsID__rcinc(parent->viW);
+   VtsID__note_epoch(parent->viW, parent);
    note_local_Kw_n_stack_for( parent );
 
    show_thread_state(" child", child);
@@ -6397,6 +6470,9 @@ void libhb_shutdown ( Bool show_stats )
                   stats__msmcread, stats__msmcread_change);
       VG_(printf)("   libhb: %'13llu msmcwrite (%'llu dragovers)\n",
                   stats__msmcwrite, stats__msmcwrite_change);
+      VG_(printf)("   libhb: %'13llu msmcread  epoch fast path,"
+                  " %'llu msmcwrite epoch fast path\n",
+                  stats__msmcread_epoch, stats__msmcwrite_epoch);
       VG_(printf)("   libhb: %'13llu cmpLEQ queries (%'llu misses)\n",
                   stats__cmpLEQ_queries, stats__cmpLEQ_misses);
       VG_(printf)("   libhb: %'13llu join2  queries (%'llu misses)\n",
@@ -6653,6 +6729,7 @@ void libhb_so_send ( Thr* thr, SO* so, Bool strong_send )
    }
    VtsID__rcinc(thr->viR);
    VtsID__rcinc(thr->viW);
+   VtsID__note_epoch(thr->viW, thr);
 
    if (strong_send)
       show_thread_state("s-send", thr);
@@ -6691,6 +6768,7 @@ void libhb_so_recv ( Thr* thr, SO* so, Bool strong_recv )
          VtsID__rcdec(thr->viW);
          thr->viW = VtsID__join2( thr->viW, so->viW );
          VtsID__rcinc(thr->viW);
+         VtsID__note_epoch(thr->viW, thr);
 
          /* See comment just above, re r10589. */
          //VtsID__rcdec(thr->viW);
@@ -91,6 +91,27 @@ extern Int VG_(getegid) ( void );
 extern UInt VG_(read_millisecond_timer) ( void );
 extern Int  VG_(gettimeofday)(struct vki_timeval *tv, struct vki_timezone *tz);
 
+/* ---------------------------------------------------------------------
+   Host helper threads
+   ------------------------------------------------------------------ */
+
+#define VG_MAX_HELPER_THREADS 64
+
+// Calls fn(arg) on the calling thread and, concurrently, on up to
+// n_threads-1 short-lived host threads sharing Valgrind's address
+// space, and returns once all of the calls have returned.  Returns how
+// many calls were made, which is 1 on platforms without helper thread
+// support or if no helper could be started, so fn must share out its
+// work dynamically.  The helpers are invisible to the scheduler and run
+// with all signals blocked: fn must not allocate, print, take faults or
+// query the address space manager on them, and must synchronise its
+// own data with atomic operations.
+extern UInt VG_(run_on_helper_threads) ( UInt n_threads,
+                                         void (*fn)(void*), void* arg );
+
+// Gives up the CPU; for use in fn's wait loops.
+extern void VG_(helper_thread_yield) ( void );
+
 /* ---------------------------------------------------------------------
    atfork
    ------------------------------------------------------------------ */
@@ -229,6 +229,12 @@ extern Int   VG_(clo_backtrace_size);
 /* Continue stack traces below main()?  Default: NO */
 extern Bool VG_(clo_show_below_main);
 
+/* Let threads run generated code concurrently, without holding the
+   big lock?  Only accepted for tools which declare
+   VG_(needs_parallel_threads).  Tool-visible so that instrumentation
+   helpers can choose atomic updates.  Default: NO */
+extern Bool VG_(clo_parallel_threads);
+
 
 /* Used to expand file names.  "option_name" is the option name, eg.
    "--log-file".  'format' is what follows, eg. "cachegrind.out.%p".  In
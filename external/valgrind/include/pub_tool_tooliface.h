@@ -494,6 +494,25 @@ extern void VG_(needs_xml_output) ( void );
    function here. */
 extern void VG_(needs_final_IR_tidy_pass) ( IRSB*(*final_tidy)(IRSB*) );
 
+/* Can the tool cope with several threads running generated code at
+   the same time, when the user asks for --parallel-threads=yes?  Only
+   generated code runs concurrently; every callback from the core is
+   still made with the big lock held.  Instrumentation helpers,
+   however, may then run concurrently with each other and with the
+   tool's other code, so they must not touch unsynchronised shared
+   state, allocate memory, or print.  May be called from
+   post_clo_init, so a tool can opt in for some option settings only. */
+extern void VG_(needs_parallel_threads) ( void );
+
+/* Is the tool's instrumentation of a superblock determined entirely
+   by the guest code, its address and the command line?  In
+   particular it must not embed pointers to dynamically allocated
+   data, or anything else that differs from run to run, in the IR, and
+   must not rely on seeing every translation being made.  If so, the
+   core may reuse translations stored by an earlier run when given
+   --translation-cache-dir.  May be called from post_clo_init. */
+extern void VG_(needs_cacheable_translations) ( void );
+
 
 /* ------------------------------------------------------------------ */
 /* Core events to track */
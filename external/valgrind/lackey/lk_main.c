@@ -243,49 +243,59 @@ static ULong n_Jccs_untaken  = 0;
 static ULong n_IJccs         = 0;
 static ULong n_IJccs_untaken = 0;
 
+/* Under --parallel-threads=yes the helpers below run concurrently in
+   several threads, so the counts have to be updated atomically. */
+#define INC(_counter)                                \
+   do {                                              \
+      if (VG_(clo_parallel_threads))                 \
+         __sync_fetch_and_add(&(_counter), 1);       \
+      else                                           \
+         (_counter)++;                               \
+   } while (0)
+
 static void add_one_func_call(void)
 {
-   n_func_calls++;
+   INC(n_func_calls);
 }
 
 static void add_one_SB_entered(void)
 {
-   n_SBs_entered++;
+   INC(n_SBs_entered);
 }
 
 static void add_one_SB_completed(void)
 {
-   n_SBs_completed++;
+   INC(n_SBs_completed);
 }
 
 static void add_one_IRStmt(void)
 {
-   n_IRStmts++;
+   INC(n_IRStmts);
 }
 
 static void add_one_guest_instr(void)
 {
-   n_guest_instrs++;
+   INC(n_guest_instrs);
 }
 
 static void add_one_Jcc(void)
 {
-   n_Jccs++;
+   INC(n_Jccs);
 }
 
 static void add_one_Jcc_untaken(void)
 {
-   n_Jccs_untaken++;
+   INC(n_Jccs_untaken);
 }
 
 static void add_one_inverted_Jcc(void)
 {
-   n_IJccs++;
+   INC(n_IJccs);
 }
 
 static void add_one_inverted_Jcc_untaken(void)
 {
-   n_IJccs_untaken++;
+   INC(n_IJccs_untaken);
 }
 
 /*------------------------------------------------------------*/
@@ -647,6 +657,14 @@ static void lk_post_clo_init(void)
          for (tyIx = 0; tyIx < N_TYPES; tyIx++)
             detailCounts[op][tyIx] = 0;
    }
+
+   /* The counting helpers are thread-safe; the tracing ones print,
+      and the detailed counts are not worth making atomic. */
+   if (!clo_detailed_counts && !clo_trace_mem && !clo_trace_sbs)
+      VG_(needs_parallel_threads)();
+
+   /* Instrumentation refers only to static data and helpers. */
+   VG_(needs_cacheable_translations)();
 }
 
 static
@@ -69,10 +69,9 @@
 //   [Introduction of --time-unit=i as the default slowed things down by
 //   roughly 0--20%.]
 //
-// - get_XCon accounts for about 9% of konqueror startup time.  Try
-//   keeping XPt children sorted by 'ip' and use binary search in get_XCon.
-//   Requires factoring out binary search code from various places into a
-//   VG_(bsearch) function.  
+// - get_XCon used to account for about 9% of konqueror startup time, due
+//   to the linear search of XPt children.  XPts with many children now
+//   keep an index sorted by 'ip' (see find_child_xpt).
 //
 // Todo -- low priority:
 // - In each XPt, record both bytes and the number of allocations, and
@@ -399,6 +398,7 @@ static double clo_peak_inaccuracy = 1.0;  // percentage
 static Int    clo_time_unit       = TimeI;
 static Int    clo_detailed_freq   = 10;
 static Int    clo_max_snapshots   = 100;
+static Bool   clo_stream_snapshots = False;
 static const HChar* clo_massif_out_file = "massif.out.%p";
 
 static XArray* args_for_massif;
@@ -443,6 +443,8 @@ static Bool ms_process_cmd_line_option(const HChar* arg)
 
    else if VG_BINT_CLO(arg, "--max-snapshots",  clo_max_snapshots, 10, 1000) {}
 
+   else if VG_BOOL_CLO(arg, "--stream-snapshots", clo_stream_snapshots) {}
+
    else if VG_STR_CLO(arg, "--massif-out-file", clo_massif_out_file) {}
 
    else
@@ -468,6 +470,8 @@ static void ms_print_usage(void)
 "                              or heap bytes alloc'd/dealloc'd [i]\n"
 "    --detailed-freq=<N>       every Nth snapshot should be detailed [10]\n"
 "    --max-snapshots=<N>       maximum number of snapshots recorded [100]\n"
+"    --stream-snapshots=no|yes write snapshots to the output file as they\n"
+"                              are taken, rather than at exit [no]\n"
 "    --massif-out-file=<file>  output file name [massif.out.%%p]\n"
    );
 }
@@ -543,8 +547,25 @@ struct _XPt {
    UInt  n_children;       // number of children
    UInt  max_children;     // capacity of children array
    XPt** children;         // pointers to children XPts
+   // Once there are more than XPT_INDEX_MIN children, the same pointers
+   // sorted by 'ip', for find_child_xpt.  (We can't just sort 'children',
+   // because the order of children in the output depends on it.)
+   XPt** sorted_children;
+
+   // The last SXPt duplicated from this XPt (see dup_XTree).  It can be
+   // reused as long as nothing below this XPt has changed since
+   // (ie. 'changed' <= 'sxpt_made') and the significance threshold is
+   // within [sxpt_lo_szB, sxpt_hi_szB], the range of thresholds that
+   // would give the same SXTree.
+   ULong changed;
+   ULong sxpt_made;
+   SizeT sxpt_lo_szB;
+   SizeT sxpt_hi_szB;
+   struct _SXPt* sxpt;
 };
 
+#define XPT_INDEX_MIN   8
+
 typedef
    enum {
       SigSXPt,
@@ -556,6 +577,7 @@ typedef struct _SXPt SXPt;
 struct _SXPt {
    SXPtTag tag;
    SizeT szB;              // memory size for the node, be it Sig or Insig
+   UInt  n_refs;           // SXTrees share unchanged subtrees
    union {
       // An SXPt representing a single significant code location.  Much like
       // an XPt, minus the fields that aren't necessary.
@@ -579,6 +601,10 @@ struct _SXPt {
 // parent node to all top-XPts.
 static XPt* alloc_xpt;
 
+// Incremented on every change to the XTree, and used to stamp
+// XPt.changed and XPt.sxpt_made.
+static ULong xtree_clock = 1;
+
 static XPt* new_XPt(Addr ip, XPt* parent)
 {
    // XPts are never freed, so we can use VG_(perm_malloc) to allocate them.
@@ -595,6 +621,13 @@ static XPt* new_XPt(Addr ip, XPt* parent)
    xpt->n_children   = 0;
    xpt->max_children = 0;
    xpt->children     = NULL;
+   xpt->sorted_children = NULL;
+
+   xpt->changed      = xtree_clock;
+   xpt->sxpt_made    = 0;
+   xpt->sxpt_lo_szB  = 0;
+   xpt->sxpt_hi_szB  = 0;
+   xpt->sxpt         = NULL;
 
    // Update statistics
    n_xpts++;
@@ -602,8 +635,54 @@ static XPt* new_XPt(Addr ip, XPt* parent)
    return xpt;
 }
 
+// Returns the position in xpt->sorted_children where a child with the
+// given ip is, or would be inserted.
+static UInt sorted_child_pos(XPt* xpt, Addr ip)
+{
+   UInt lo = 0, hi = xpt->n_children;
+   while (lo < hi) {
+      UInt mid = lo + (hi - lo) / 2;
+      if (xpt->sorted_children[mid]->ip < ip)
+         lo = mid + 1;
+      else
+         hi = mid;
+   }
+   return lo;
+}
+
+static Int XPt_cmp_ip(const void* n1, const void* n2)
+{
+   const XPt* xpt1 = *(const XPt *const *)n1;
+   const XPt* xpt2 = *(const XPt *const *)n2;
+   return ( xpt1->ip < xpt2->ip ? -1
+          : xpt1->ip > xpt2->ip ?  1
+          :                        0);
+}
+
+// Looks for a child of xpt with the given ip.  Most XPts have only a few
+// children, which we search linearly;  big ones (eg. alloc_xpt, which has
+// a child per allocation point) use the sorted index.
+static XPt* find_child_xpt(XPt* xpt, Addr ip)
+{
+   UInt i;
+
+   if (xpt->sorted_children) {
+      i = sorted_child_pos(xpt, ip);
+      if (i < xpt->n_children && xpt->sorted_children[i]->ip == ip)
+         return xpt->sorted_children[i];
+      return NULL;
+   }
+   for (i = 0; i < xpt->n_children; i++) {
+      if (ip == xpt->children[i]->ip)
+         return xpt->children[i];
+   }
+   return NULL;
+}
+
 static void add_child_xpt(XPt* parent, XPt* child)
 {
+   XPt* xpt;
+
    // Expand 'children' if necessary.
    tl_assert(parent->n_children <= parent->max_children);
    if (parent->n_children == parent->max_children) {
@@ -617,12 +696,39 @@ static void add_child_xpt(XPt* parent, XPt* child)
          parent->children = VG_(realloc)( "ms.main.acx.2",
                                           parent->children,
                                           parent->max_children * sizeof(XPt*) );
+         if (parent->sorted_children)
+            parent->sorted_children =
+               VG_(realloc)( "ms.main.acx.3", parent->sorted_children,
+                             parent->max_children * sizeof(XPt*) );
          n_xpt_later_expansions++;
       }
    }
 
-   // Insert new child XPt in parent's children list.
+   // Insert new child XPt in parent's children list, and in the index, if
+   // there is one or it's time to build it.
+   if (parent->sorted_children) {
+      UInt pos = sorted_child_pos(parent, child->ip);
+      VG_(memmove)( &parent->sorted_children[pos+1],
+                    &parent->sorted_children[pos],
+                    (parent->n_children - pos) * sizeof(XPt*) );
+      parent->sorted_children[pos] = child;
+   }
    parent->children[ parent->n_children++ ] = child;
+   if (!parent->sorted_children && parent->n_children > XPT_INDEX_MIN) {
+      parent->sorted_children =
+         VG_(malloc)( "ms.main.acx.4", parent->max_children * sizeof(XPt*) );
+      VG_(memcpy)( parent->sorted_children, parent->children,
+                   parent->n_children * sizeof(XPt*) );
+      VG_(ssort)( parent->sorted_children, parent->n_children, sizeof(XPt*),
+                  XPt_cmp_ip );
+   }
+
+   // The new child changes the SXTree of all its ancestors, even though it
+   // has no size yet:  it will at least be counted as an insignificant
+   // child.
+   xtree_clock++;
+   for (xpt = parent; xpt != NULL; xpt = xpt->parent)
+      xpt->changed = xtree_clock;
 }
 
 // Reverse comparison for a reverse sort -- biggest to smallest.
@@ -639,11 +745,20 @@ static Int SXPt_revcmp_szB(const void* n1, const void* n2)
 //--- XTree Operations                                     ---//
 //------------------------------------------------------------//
 
+static void free_SXTree(SXPt* sxpt);
+
 // Duplicates an XTree as an SXTree.
+//
+// Consecutive detailed snapshots usually differ in only a few places, so
+// SXTrees share subtrees:  each XPt remembers the SXPt last duplicated from
+// it, and if neither the XPt's subtree nor the significance of any part of
+// it has changed, that SXPt is reused (with its reference count bumped)
+// instead of being duplicated again.
 static SXPt* dup_XTree(XPt* xpt, SizeT total_szB)
 {
    Int  i, n_sig_children, n_insig_children, n_child_sxpts;
    SizeT sig_child_threshold_szB;
+   SizeT lo_szB, hi_szB;
    SXPt* sxpt;
 
    // Number of XPt children  Action for SXPT
@@ -667,11 +782,29 @@ static SXPt* dup_XTree(XPt* xpt, SizeT total_szB)
       sig_child_threshold_szB = (SizeT)((total_szB * clo_threshold) / 100);
    }
 
+   // Can we reuse the SXPt from last time?
+   if (xpt->sxpt != NULL && xpt->changed <= xpt->sxpt_made
+       && xpt->sxpt_lo_szB <= sig_child_threshold_szB
+       && sig_child_threshold_szB <= xpt->sxpt_hi_szB)
+   {
+      xpt->sxpt->n_refs++;
+      return xpt->sxpt;
+   }
+
    // How many children are significant?  And do we need an aggregate SXPt?
+   // Also work out the range of thresholds that would give the same
+   // children:  above the biggest insignificant child, and no bigger than
+   // the smallest significant one.
    n_sig_children = 0;
+   lo_szB = 0;
+   hi_szB = ~(SizeT)0;
    for (i = 0; i < xpt->n_children; i++) {
-      if (xpt->children[i]->szB >= sig_child_threshold_szB) {
+      SizeT child_szB = xpt->children[i]->szB;
+      if (child_szB >= sig_child_threshold_szB) {
          n_sig_children++;
+         if (child_szB < hi_szB) hi_szB = child_szB;
+      } else {
+         if (child_szB + 1 > lo_szB) lo_szB = child_szB + 1;
       }
    }
    n_insig_children = xpt->n_children - n_sig_children;
@@ -682,6 +815,7 @@ static SXPt* dup_XTree(XPt* xpt, SizeT total_szB)
    n_sxpt_allocs++;
    sxpt->tag            = SigSXPt;
    sxpt->szB            = xpt->szB;
+   sxpt->n_refs         = 1;
    sxpt->Sig.ip         = xpt->ip;
    sxpt->Sig.n_children = n_child_sxpts;
 
@@ -696,9 +830,13 @@ static SXPt* dup_XTree(XPt* xpt, SizeT total_szB)
       // insig_children_szB doesn't necessarily equal xpt->szB.)
       j = 0;
       for (i = 0; i < xpt->n_children; i++) {
-         if (xpt->children[i]->szB >= sig_child_threshold_szB) {
-            sxpt->Sig.children[j++] = dup_XTree(xpt->children[i], total_szB);
-            sig_children_szB   += xpt->children[i]->szB;
+         XPt* child = xpt->children[i];
+         if (child->szB >= sig_child_threshold_szB) {
+            sxpt->Sig.children[j++] = dup_XTree(child, total_szB);
+            sig_children_szB   += child->szB;
+            // The child's subtree must stay the same, too.
+            if (child->sxpt_lo_szB > lo_szB) lo_szB = child->sxpt_lo_szB;
+            if (child->sxpt_hi_szB < hi_szB) hi_szB = child->sxpt_hi_szB;
          } else {
             insig_children_szB += xpt->children[i]->szB;
          }
@@ -713,6 +851,7 @@ static SXPt* dup_XTree(XPt* xpt, SizeT total_szB)
          n_sxpt_allocs++;
          insig_sxpt->tag = InsigSXPt;
          insig_sxpt->szB = insig_children_szB;
+         insig_sxpt->n_refs = 1;
          insig_sxpt->Insig.n_xpts = n_insig_children;
          sxpt->Sig.children[n_sig_children] = insig_sxpt;
       }
@@ -720,13 +859,27 @@ static SXPt* dup_XTree(XPt* xpt, SizeT total_szB)
       sxpt->Sig.children = NULL;
    }
 
+   // Remember it for next time.  The XPt holds its own reference.
+   if (xpt->sxpt != NULL)
+      free_SXTree(xpt->sxpt);
+   sxpt->n_refs++;
+   xpt->sxpt        = sxpt;
+   xpt->sxpt_made   = xtree_clock;
+   xpt->sxpt_lo_szB = lo_szB;
+   xpt->sxpt_hi_szB = hi_szB;
+
    return sxpt;
 }
 
+// Drops a reference to an SXTree, freeing it once there are none left.
 static void free_SXTree(SXPt* sxpt)
 {
    Int  i;
    tl_assert(sxpt != NULL);
+   tl_assert(sxpt->n_refs > 0);
+
+   if (--sxpt->n_refs > 0)
+      return;
 
    switch (sxpt->tag) {
     case SigSXPt:
@@ -907,26 +1060,16 @@ static XPt* get_XCon( ThreadId tid, Bool exclude_first_entry )
    // Now do the search/insertion of the XCon.
    for (i = 0; i < n_ips; i++) {
       Addr ip = ips[i];
-      Int ch;
       // Look for IP in xpt's children.
-      // Linear search, ugh -- about 10% of time for konqueror startup tried
-      // caching last result, only hit about 4% for konqueror.
       // Nb:  this search hits about 98% of the time for konqueror
-      for (ch = 0; True; ch++) {
-         if (ch == xpt->n_children) {
-            // IP not found in the children.
-            // Create and add new child XPt, then stop.
-            XPt* new_child_xpt = new_XPt(ip, xpt);
-            add_child_xpt(xpt, new_child_xpt);
-            xpt = new_child_xpt;
-            break;
-
-         } else if (ip == xpt->children[ch]->ip) {
-            // Found the IP in the children, stop.
-            xpt = xpt->children[ch];
-            break;
-         }
+      XPt* child_xpt = find_child_xpt(xpt, ip);
+      if (child_xpt == NULL) {
+         // IP not found in the children.
+         // Create and add new child XPt.
+         child_xpt = new_XPt(ip, xpt);
+         add_child_xpt(xpt, child_xpt);
       }
+      xpt = child_xpt;
    }
 
    // [Note: several comments refer to this comment.  Do not delete it
@@ -979,13 +1122,16 @@ static void update_XCon(XPt* xpt, SSizeT space_delta)
    if (0 == space_delta)
       return;
 
+   xtree_clock++;
    while (xpt != alloc_xpt) {
       if (space_delta < 0) tl_assert(xpt->szB >= -space_delta);
       xpt->szB += space_delta;
+      xpt->changed = xtree_clock;
       xpt = xpt->parent;
    }
    if (space_delta < 0) tl_assert(alloc_xpt->szB >= -space_delta);
    alloc_xpt->szB += space_delta;
+   alloc_xpt->changed = xtree_clock;
 }
 
 
@@ -1333,6 +1479,8 @@ take_snapshot(Snapshot* snapshot, SnapshotKind kind, Time my_time,
 }
 
 
+static void stream_snapshot(Snapshot* snapshot);
+
 // Take a snapshot, if it's time, or if we've hit a peak.
 static void
 maybe_take_snapshot(SnapshotKind kind, const HChar* what)
@@ -1347,6 +1495,7 @@ maybe_take_snapshot(SnapshotKind kind, const HChar* what)
    static Time earliest_possible_time_of_next_snapshot = 0;
    static Int  n_snapshots_since_last_detailed         = 0;
    static Int  n_skipped_snapshots_since_last_snapshot = 0;
+   static Int  n_streamed_snapshots                    = 0;
 
    Snapshot* snapshot;
    Bool      is_detailed;
@@ -1426,10 +1575,29 @@ maybe_take_snapshot(SnapshotKind kind, const HChar* what)
    VERB_snapshot(2, what, next_snapshot_i);
    n_skipped_snapshots_since_last_snapshot = 0;
 
-   // Cull the entries, if our snapshot table is full.
-   next_snapshot_i++;
-   if (clo_max_snapshots == next_snapshot_i) {
-      min_time_interval = cull_snapshots();
+   if (clo_stream_snapshots) {
+      // Write the snapshot out and forget it;  the table never fills.  But
+      // we still space the snapshots out as the program runs longer, the
+      // way culling does:  a culled table holds about half of
+      // --max-snapshots snapshots, evenly spread over the run so far.
+      stream_snapshot(snapshot);
+      delete_snapshot(snapshot);
+      n_streamed_snapshots++;
+      if (n_streamed_snapshots >= clo_max_snapshots &&
+          0 == n_streamed_snapshots % (clo_max_snapshots/2))
+      {
+         Time interval = my_time / (clo_max_snapshots/2);
+         if (interval > min_time_interval)
+            min_time_interval = interval;
+         VERB(2, "New time interval = %lld\n", min_time_interval);
+      }
+
+   } else {
+      // Cull the entries, if our snapshot table is full.
+      next_snapshot_i++;
+      if (clo_max_snapshots == next_snapshot_i) {
+         min_time_interval = cull_snapshots();
+      }
    }
 
    // Work out the earliest time when the next snapshot can happen.
@@ -2109,8 +2277,9 @@ static void pp_snapshot_SXPt(VgFile *fp, SXPt* sxpt, Int depth,
                              HChar* depth_str, Int depth_str_len,
                              SizeT snapshot_heap_szB, SizeT snapshot_total_szB)
 {
-   Int   i, j, n_insig_children_sxpts;
+   Int   i, j, n_children, n_insig_children_sxpts;
    SXPt* child = NULL;
+   SXPt** children;
 
    // Used for printing function names.  Is made static to keep it out
    // of the stack frame -- this function is recursive.  Obviously this
@@ -2119,6 +2288,10 @@ static void pp_snapshot_SXPt(VgFile *fp, SXPt* sxpt, Int depth,
 
    switch (sxpt->tag) {
     case SigSXPt:
+      // Nb: SXPts can be shared between snapshots, so we must not modify
+      // them here.
+      n_children = sxpt->Sig.n_children;
+
       // Print the SXPt itself.
       if (0 == depth) {
          if (clo_heap) {
@@ -2140,7 +2313,7 @@ static void pp_snapshot_SXPt(VgFile *fp, SXPt* sxpt, Int depth,
          if ( ! VG_(clo_show_below_main) ) {
             Vg_FnNameKind kind = VG_(get_fnname_kind_from_IP)(sxpt->Sig.ip);
             if (Vg_FnNameMain == kind || Vg_FnNameBelowMain == kind) {
-               sxpt->Sig.n_children = 0;
+               n_children = 0;
             }
          }
 
@@ -2149,7 +2322,7 @@ static void pp_snapshot_SXPt(VgFile *fp, SXPt* sxpt, Int depth,
       }
       
       // Do the non-ip_desc part first...
-      FP("%sn%d: %lu ", depth_str, sxpt->Sig.n_children, sxpt->szB);
+      FP("%sn%d: %lu ", depth_str, n_children, sxpt->szB);
 
       // For ip_descs beginning with "0xABCD...:" addresses, we first
       // measure the length of the "0xabcd: " address at the start of the
@@ -2184,14 +2357,19 @@ static void pp_snapshot_SXPt(VgFile *fp, SXPt* sxpt, Int depth,
       // two reasons.  First, if we do it during dup_XTree, it can get
       // expensive (eg. 15% of execution time for konqueror
       // startup/shutdown).  Second, this way we get the Insig SXPt (if one
-      // is present) in its sorted position, not at the end.
-      VG_(ssort)(sxpt->Sig.children, sxpt->Sig.n_children, sizeof(SXPt*),
-                 SXPt_revcmp_szB);
+      // is present) in its sorted position, not at the end.  We sort a
+      // copy, because the children array may be shared.
+      children = NULL;
+      if (n_children > 0) {
+         children = VG_(malloc)("ms.main.pps.1", n_children * sizeof(SXPt*));
+         VG_(memcpy)(children, sxpt->Sig.children, n_children * sizeof(SXPt*));
+         VG_(ssort)(children, n_children, sizeof(SXPt*), SXPt_revcmp_szB);
+      }
 
       // Print the SXPt's children.  They should already be in sorted order.
       n_insig_children_sxpts = 0;
-      for (i = 0; i < sxpt->Sig.n_children; i++) {
-         child = sxpt->Sig.children[i];
+      for (i = 0; i < n_children; i++) {
+         child = children[i];
 
          if (InsigSXPt == child->tag)
             n_insig_children_sxpts++;
@@ -2203,6 +2381,9 @@ static void pp_snapshot_SXPt(VgFile *fp, SXPt* sxpt, Int depth,
             snapshot_heap_szB, snapshot_total_szB);
       }
 
+      if (children)
+         VG_(free)(children);
+
       // Unindent.
       depth_str[depth+0] = '\0';
       depth_str[depth+1] = '\0';
@@ -2223,17 +2404,21 @@ static void pp_snapshot_SXPt(VgFile *fp, SXPt* sxpt, Int depth,
    }
 }
 
-static void pp_snapshot(VgFile *fp, Snapshot* snapshot, Int snapshot_n)
+// Returns the number of bytes written before the value of 'heap_tree='.
+static UInt pp_snapshot(VgFile *fp, Snapshot* snapshot, Int snapshot_n)
 {
+   UInt n = 0;
+
    sanity_check_snapshot(snapshot);
 
-   FP("#-----------\n");
-   FP("snapshot=%d\n", snapshot_n);
-   FP("#-----------\n");
-   FP("time=%lld\n",            snapshot->time);
-   FP("mem_heap_B=%lu\n",       snapshot->heap_szB);
-   FP("mem_heap_extra_B=%lu\n", snapshot->heap_extra_szB);
-   FP("mem_stacks_B=%lu\n",     snapshot->stacks_szB);
+   n += FP("#-----------\n");
+   n += FP("snapshot=%d\n", snapshot_n);
+   n += FP("#-----------\n");
+   n += FP("time=%lld\n",            snapshot->time);
+   n += FP("mem_heap_B=%lu\n",       snapshot->heap_szB);
+   n += FP("mem_heap_extra_B=%lu\n", snapshot->heap_extra_szB);
+   n += FP("mem_stacks_B=%lu\n",     snapshot->stacks_szB);
+   n += VG_(strlen)("heap_tree=");
 
    if (is_detailed_snapshot(snapshot)) {
       // Detailed snapshot -- print heap tree.
@@ -2254,24 +2439,12 @@ static void pp_snapshot(VgFile *fp, Snapshot* snapshot, Int snapshot_n)
    } else {
       FP("heap_tree=empty\n");
    }
+   return n;
 }
 
-static void write_snapshots_to_file(const HChar* massif_out_file, 
-                                    Snapshot snapshots_array[], 
-                                    Int nr_elements)
+static void pp_header(VgFile *fp)
 {
    Int i;
-   VgFile *fp;
-
-   fp = VG_(fopen)(massif_out_file, VKI_O_CREAT|VKI_O_TRUNC|VKI_O_WRONLY,
-                                    VKI_S_IRUSR|VKI_S_IWUSR);
-   if (fp == NULL) {
-      // If the file can't be opened for whatever reason (conflict
-      // between multiple cachegrinded processes?), give up now.
-      VG_(umsg)("error: can't open output file '%s'\n", massif_out_file );
-      VG_(umsg)("       ... so profiling results will be missing.\n");
-      return;
-   }
 
    // Print massif-specific options that were used.
    // XXX: is it worth having a "desc:" line?  Could just call it "options:"
@@ -2295,6 +2468,26 @@ static void write_snapshots_to_file(const HChar* massif_out_file,
    FP("\n");
 
    FP("time_unit: %s\n", TimeUnit_to_string(clo_time_unit));
+}
+
+static void write_snapshots_to_file(const HChar* massif_out_file, 
+                                    Snapshot snapshots_array[], 
+                                    Int nr_elements)
+{
+   Int i;
+   VgFile *fp;
+
+   fp = VG_(fopen)(massif_out_file, VKI_O_CREAT|VKI_O_TRUNC|VKI_O_WRONLY,
+                                    VKI_S_IRUSR|VKI_S_IWUSR);
+   if (fp == NULL) {
+      // If the file can't be opened for whatever reason (conflict
+      // between multiple cachegrinded processes?), give up now.
+      VG_(umsg)("error: can't open output file '%s'\n", massif_out_file );
+      VG_(umsg)("       ... so profiling results will be missing.\n");
+      return;
+   }
+
+   pp_header(fp);
 
    for (i = 0; i < nr_elements; i++) {
       Snapshot* snapshot = & snapshots_array[i];
@@ -2316,6 +2509,111 @@ static void write_snapshots_array_to_file(void)
    VG_(free)(massif_out_file);
 }
 
+// With --stream-snapshots=yes, each snapshot is appended to the output file
+// as soon as it is taken, so memory use doesn't depend on --max-snapshots
+// and the profile can be looked at while the program is still running.
+// The file is closed after each snapshot, so nothing is left buffered if
+// the program forks.  As in write_snapshots_array_to_file, the name is
+// expanded as late as possible, and again in a forked child, which starts
+// a file of its own.
+//
+// A peak snapshot may be overtaken by a later one, so peak snapshots are
+// written as 'heap_tree=detailed' and only the last one is marked, at exit,
+// by overwriting its "detailed" with "peak\n###" -- the same length, the
+// extra line being a comment.
+static HChar* stream_file            = NULL;
+static Int    stream_pid             = 0;
+static Int    stream_snapshot_n      = 0;
+static Bool   stream_failed          = False;
+static Off64T stream_szB             = 0;   // size of stream_file so far
+static Off64T stream_peak_off        = -1;  // "detailed" of the last peak
+
+static void stream_update_size(void)
+{
+   struct vg_stat st;
+   if (sr_isError(VG_(stat)(stream_file, &st)))
+      stream_failed = True;
+   else
+      stream_szB = st.size;
+}
+
+static void stream_snapshot(Snapshot* snapshot)
+{
+   VgFile *fp;
+   Bool is_new = False;
+   Bool is_peak = Peak == snapshot->kind;
+   UInt off;
+
+   if (stream_file == NULL || VG_(getpid)() != stream_pid) {
+      if (stream_file)
+         VG_(free)(stream_file);
+      stream_file =
+         VG_(expand_file_name)("--massif-out-file", clo_massif_out_file);
+      stream_pid        = VG_(getpid)();
+      stream_snapshot_n = 0;
+      stream_failed     = False;
+      stream_szB        = 0;
+      stream_peak_off   = -1;
+      is_new            = True;
+   }
+   if (stream_failed)
+      return;
+
+   fp = VG_(fopen)(stream_file,
+                   is_new ? VKI_O_CREAT|VKI_O_TRUNC|VKI_O_WRONLY
+                          : VKI_O_WRONLY|VKI_O_APPEND,
+                   VKI_S_IRUSR|VKI_S_IWUSR);
+   if (fp == NULL) {
+      VG_(umsg)("error: can't open output file '%s'\n", stream_file );
+      VG_(umsg)("       ... so profiling results will be missing.\n");
+      stream_failed = True;
+      return;
+   }
+
+   if (is_new) {
+      pp_header(fp);
+      VG_(fclose) (fp);
+      stream_update_size();
+      fp = VG_(fopen)(stream_file, VKI_O_WRONLY|VKI_O_APPEND, 0);
+      if (fp == NULL)
+         stream_failed = True;
+      if (stream_failed)
+         return;
+   }
+   if (is_peak)
+      snapshot->kind = Normal;
+   off = pp_snapshot(fp, snapshot, stream_snapshot_n++);
+   if (is_peak) {
+      snapshot->kind  = Peak;
+      stream_peak_off = stream_szB + off;
+   }
+   VG_(fclose) (fp);
+   stream_update_size();
+}
+
+// Mark the last peak snapshot of this process's stream file as the peak.
+static void stream_mark_peak(void)
+{
+   HChar  buf[8];
+   SysRes sres;
+   Int    fd;
+
+   if (stream_file == NULL || stream_failed || stream_peak_off < 0
+       || VG_(getpid)() != stream_pid)
+      return;
+
+   sres = VG_(open)(stream_file, VKI_O_RDWR, 0);
+   if (sr_isError(sres))
+      return;
+   fd = sr_Res(sres);
+   if (VG_(lseek)(fd, stream_peak_off, VKI_SEEK_SET) == stream_peak_off
+       && VG_(read)(fd, buf, 8) == 8
+       && VG_(memcmp)(buf, "detailed", 8) == 0
+       && VG_(lseek)(fd, stream_peak_off, VKI_SEEK_SET) == stream_peak_off)
+      VG_(write)(fd, "peak\n###", 8);
+   VG_(close)(fd);
+}
+
 static void handle_snapshot_monitor_command (const HChar *filename,
                                              Bool detailed)
 {
@@ -2345,6 +2643,12 @@ static void handle_all_snapshots_monitor_command (const HChar *filename)
          ("error: cannot take snapshot before execution has started\n");
       return;
    }
+   if (clo_stream_snapshots) {
+      VG_(gdb_printf)
+         ("error: snapshots are not kept with --stream-snapshots=yes;\n"
+          "       they are already in the output file\n");
+      return;
+   }
 
    write_snapshots_to_file ((filename == NULL) ? 
                             "massif.vgdb.out" : filename,
@@ -2429,8 +2733,12 @@ static void ms_print_stats (void)
 
 static void ms_fini(Int exit_status)
 {
-   // Output.
-   write_snapshots_array_to_file();
+   // Output.  (When streaming, it has all been written already, bar
+   // marking the peak.)
+   if (clo_stream_snapshots)
+      stream_mark_peak();
+   else
+      write_snapshots_array_to_file();
 
    // Stats
    tl_assert(n_xpts > 0);  // always have alloc_xpt
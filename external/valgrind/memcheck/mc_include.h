@@ -142,6 +142,7 @@ void MC_(copy_address_range_state) ( Addr src, Addr dst, SizeT len );
 void MC_(print_malloc_stats) ( void );
 /* nr of free operations done */
 SizeT MC_(get_cmalloc_n_frees) ( void );
+SizeT MC_(get_cmalloc_n_chunk_changes) ( void );
 
 void* MC_(malloc)               ( ThreadId tid, SizeT n );
 void* MC_(__builtin_new)        ( ThreadId tid, SizeT n );
@@ -375,6 +376,10 @@ extern HChar * MC_(snprintf_delta) (HChar * buf, Int size,
 
 Bool MC_(is_valid_aligned_word)     ( Addr a );
 Bool MC_(is_within_valid_secondary) ( Addr a );
+// Thread-safe (and allocation-free) versions, for use by the helper
+// threads of a parallel leak search.
+Bool MC_(is_valid_aligned_word_nocache)     ( Addr a );
+Bool MC_(is_within_valid_secondary_nocache) ( Addr a );
 
 // Prints as user msg a description of the given loss record.
 void MC_(pp_LossRecord)(UInt n_this_record, UInt n_total_records,
@@ -493,6 +498,10 @@ extern LeakCheckMode MC_(clo_leak_check);
 /* How closely should we compare ExeContexts in leak records? default: 2 */
 extern VgRes MC_(clo_leak_resolution);
 
+/* How many host threads mark reachable blocks during a leak search?
+   default: 1 */
+extern UInt MC_(clo_leak_check_threads);
+
 /* In leak check, show loss records if their R2S(reachedness) is set.
    Default : R2S(Possible) | R2S(Unreached). */
 extern UInt MC_(clo_show_leak_kinds);
@@ -617,6 +626,10 @@ VG_REGPARM(0) void MC_(helperc_value_check1_fail_no_o) ( void );
 VG_REGPARM(0) void MC_(helperc_value_check0_fail_no_o) ( void );
 
 /* V-bits load/store helpers */
+VG_REGPARM(1) void MC_(helperc_STOREV256le) ( Addr, ULong, ULong,
+                                                    ULong, ULong );
+VG_REGPARM(1) void MC_(helperc_STOREV128be) ( Addr, ULong, ULong );
+VG_REGPARM(1) void MC_(helperc_STOREV128le) ( Addr, ULong, ULong );
 VG_REGPARM(1) void MC_(helperc_STOREV64be) ( Addr, ULong );
 VG_REGPARM(1) void MC_(helperc_STOREV64le) ( Addr, ULong );
 VG_REGPARM(2) void MC_(helperc_STOREV32be) ( Addr, UWord );
@@ -38,6 +38,7 @@
 #include "pub_tool_libcassert.h"
 #include "pub_tool_libcprint.h"
 #include "pub_tool_libcsignal.h"
+#include "pub_tool_libcproc.h"     // VG_(run_on_helper_threads)
 #include "pub_tool_machine.h"
 #include "pub_tool_mallocfree.h"
 #include "pub_tool_options.h"
@@ -203,6 +204,11 @@
 // - We group blocks by their ExeContexts and categorisation, and print them
 //   if --leak-check=full.  We also print summary numbers.
 //
+// With --leak-check-threads=N (N > 1), the first marking phase (root set
+// and mark stack, up to "we know for every block if it's reachable") is
+// shared out between N host threads; see lc_par_mark.  The clique phase
+// and everything after it stay serial.
+//
 // A note on "cliques":
 // - A directly lost block is one with no pointers to it.  An indirectly
 //   lost block is one that is pointed to by a directly or indirectly lost
@@ -454,6 +460,11 @@ static MC_Chunk** lc_chunks;
 // How many chunks we're dealing with.
 static Int        lc_n_chunks;
 static SizeT lc_chunks_n_frees_marker;
+// Similarly, MC_(get_cmalloc_n_chunk_changes) when lc_chunks was built.
+// While it is unchanged, every block in lc_chunks is still live with the
+// same address and size, so the next search only has to merge in the
+// blocks allocated since (see get_sorted_chunks).
+static SizeT lc_chunks_n_changes_marker;
 // This has the same number of entries as lc_chunks, and each entry
 // in lc_chunks corresponds with the entry here (ie. lc_chunks[i] and
 // lc_extras[i] describe the same block).
@@ -516,6 +527,227 @@ static SizeT MC_(bytes_heuristically_reachable)[N_LEAK_CHECK_HEURISTICS]
 static SizeT MC_(blocks_heuristically_reachable)[N_LEAK_CHECK_HEURISTICS]
                                                 = {0,0,0,0};
 
+// Returns the chunks to check, sorted by address, and frees the array
+// from the previous leak search.  If no block has been freed, moved or
+// resized since then, which is typical of a program calling
+// VALGRIND_DO_ADDED_LEAK_CHECK while building up its heap, the previous
+// array is still sorted and valid: only the blocks allocated since need
+// sorting, and are then merged in.
+// (The previous search's reachability results can't be reused the same
+// way: the client may have overwritten pointers without freeing.)
+static MC_Chunk**
+get_sorted_chunks(Int* pn_chunks)
+{
+   Int        n_chunks, n_new, n_merged, i, j, k;
+   MC_Chunk** chunks = find_active_chunks(&n_chunks);
+   MC_Chunk** merged;
+
+   if (lc_chunks == NULL
+       || lc_chunks_n_changes_marker != MC_(get_cmalloc_n_chunk_changes)()
+       || n_chunks < lc_n_chunks) {
+      if (lc_chunks)
+         VG_(free)(lc_chunks);
+      lc_chunks = NULL;
+      // Sort the array so blocks are in ascending order in memory.
+      VG_(ssort)(chunks, n_chunks, sizeof(VgHashNode*), compare_MC_Chunks);
+      *pn_chunks = n_chunks;
+      return chunks;
+   }
+
+   // Move the chunks which are not in lc_chunks to the front.
+   n_new = 0;
+   for (i = 0; i < n_chunks; i++) {
+      MC_Chunk* ch = chunks[i];
+      Int ch_no = find_chunk_for(ch->data, lc_chunks, lc_n_chunks);
+      if (ch_no == -1 || lc_chunks[ch_no] != ch)
+         chunks[n_new++] = ch;
+   }
+
+   // If some block of lc_chunks is not active any more (a malloc block
+   // which now holds a mempool chunk, see find_active_chunks), start
+   // afresh.
+   if (n_chunks - n_new != lc_n_chunks) {
+      VG_(free)(lc_chunks);
+      lc_chunks = NULL;
+      VG_(ssort)(chunks, n_chunks, sizeof(VgHashNode*), compare_MC_Chunks);
+      *pn_chunks = n_chunks;
+      return chunks;
+   }
+
+   if (VG_(clo_verbosity) > 2 && !VG_(clo_xml))
+      VG_(umsg)("Reusing sorted list of %'d blocks, merging %'d new ones\n",
+                lc_n_chunks, n_new);
+
+   VG_(ssort)(chunks, n_new, sizeof(VgHashNode*), compare_MC_Chunks);
+   merged = VG_(malloc)( "mc.gsc.1",
+                         (lc_n_chunks + n_new) * sizeof(MC_Chunk*) );
+   i = j = n_merged = 0;
+   while (i < lc_n_chunks || j < n_new) {
+      if (j == n_new
+          || (i < lc_n_chunks && lc_chunks[i]->data <= chunks[j]->data)) {
+         merged[n_merged++] = lc_chunks[i++];
+      } else {
+         // The binary search above only finds one of several blocks
+         // starting at the same address (eg. zero-sized ones), so drop
+         // any such block which is in lc_chunks after all.
+         for (k = n_merged - 1;
+              k >= 0 && merged[k]->data == chunks[j]->data; k--) {
+            if (merged[k] == chunks[j])
+               break;
+         }
+         if (k < 0 || merged[k]->data != chunks[j]->data)
+            merged[n_merged++] = chunks[j];
+         j++;
+      }
+   }
+
+   VG_(free)(chunks);
+   VG_(free)(lc_chunks);
+   lc_chunks = NULL;
+   *pn_chunks = n_merged;
+   return merged;
+}
+
+// True while the helper threads of a parallel leak search are running
+// (see lc_par_mark).  aspacemgr and the auxmap cache behind
+// MC_(is_valid_aligned_word) are not thread-safe, so the functions
+// below then use lc_segs and the _nocache shadow lookups instead.
+static Bool lc_par;
+
+// A copy of the client segments, sorted by address, taken before the
+// helper threads are started.
+typedef
+   struct {
+      Addr    start;
+      Addr    end;
+      SegKind kind;
+      Bool    hasR;
+      Bool    hasW;
+      Bool    hasT;
+   }
+   LC_Seg;
+
+static LC_Seg* lc_segs;
+static Int     lc_n_segs;
+
+static void lc_take_segs_snapshot(void)
+{
+   Int   i;
+   Int   n_seg_starts;
+   Addr* seg_starts = VG_(get_segment_starts)( SkFileC | SkAnonC | SkShmC,
+                                               &n_seg_starts );
+
+   tl_assert(seg_starts && n_seg_starts > 0);
+   lc_segs = VG_(malloc)( "mc.ltss.1", n_seg_starts * sizeof(LC_Seg) );
+   for (i = 0; i < n_seg_starts; i++) {
+      NSegment const* seg = VG_(am_find_nsegment)( seg_starts[i] );
+      tl_assert(seg);
+      lc_segs[i].start = seg->start;
+      lc_segs[i].end   = seg->end;
+      lc_segs[i].kind  = seg->kind;
+      lc_segs[i].hasR  = seg->hasR;
+      lc_segs[i].hasW  = seg->hasW;
+      lc_segs[i].hasT  = seg->hasT;
+   }
+   lc_n_segs = n_seg_starts;
+   VG_(free)(seg_starts);
+}
+
+static const LC_Seg* lc_find_seg_in_snapshot(Addr a)
+{
+   Int lo = 0;
+   Int hi = lc_n_segs - 1;
+   while (lo <= hi) {
+      Int mid = (lo + hi) / 2;
+      if (a < lc_segs[mid].start)
+         hi = mid - 1;
+      else if (a > lc_segs[mid].end)
+         lo = mid + 1;
+      else
+         return &lc_segs[mid];
+   }
+   return NULL;
+}
+
+// Pages which fault although the snapshot says they are readable, e.g.
+// a file mapping beyond the end of its file, or a page mprotect-ed
+// behind aspacemgr's back.  A helper thread has no fault catcher, so
+// lc_probe_segs finds these before the helpers start, and the helpers
+// do not read them.  Sorted by address.
+static Addr* lc_bad_pages;
+static Int   lc_n_bad_pages;
+static Int   lc_bad_pages_size;
+
+static void lc_add_bad_page(Addr page)
+{
+   if (lc_n_bad_pages == lc_bad_pages_size) {
+      lc_bad_pages_size = lc_bad_pages_size == 0 ? 16 : 2 * lc_bad_pages_size;
+      lc_bad_pages = VG_(realloc)( "mc.labp.1", lc_bad_pages,
+                                   lc_bad_pages_size * sizeof(Addr) );
+   }
+   lc_bad_pages[lc_n_bad_pages++] = page;
+}
+
+static Bool lc_is_bad_page(Addr a)
+{
+   const Addr page = VG_PGROUNDDN(a);
+   Int lo = 0;
+   Int hi = lc_n_bad_pages - 1;
+   while (lo <= hi) {
+      Int mid = (lo + hi) / 2;
+      if (page < lc_bad_pages[mid])
+         hi = mid - 1;
+      else if (page > lc_bad_pages[mid])
+         lo = mid + 1;
+      else
+         return True;
+   }
+   return False;
+}
+
+// Describes the client segment containing a.  Returns False if a is not
+// in a client segment.
+static Bool lc_find_seg(Addr a, LC_Seg* res)
+{
+   if (lc_par) {
+      const LC_Seg* seg = lc_find_seg_in_snapshot(a);
+      if (seg == NULL)
+         return False;
+      *res = *seg;
+   } else {
+      NSegment const* seg = VG_(am_find_nsegment)(a);
+      if (seg == NULL
+          || !(seg->kind == SkFileC || seg->kind == SkAnonC
+               || seg->kind == SkShmC))
+         return False;
+      res->start = seg->start;
+      res->end   = seg->end;
+      res->kind  = seg->kind;
+      res->hasR  = seg->hasR;
+      res->hasW  = seg->hasW;
+      res->hasT  = seg->hasT;
+   }
+   return True;
+}
+
+// VG_(am_is_valid_for_client)(a, len, VKI_PROT_READ), for a range which
+// does not cross a page boundary.
+static Bool lc_is_readable_for_client(Addr a, SizeT len)
+{
+   if (lc_par) {
+      const LC_Seg* seg = lc_find_seg_in_snapshot(a);
+      return seg != NULL && seg->hasR && a + len - 1 <= seg->end;
+   }
+   return VG_(am_is_valid_for_client)(a, len, VKI_PROT_READ);
+}
+
+static Bool lc_is_valid_aligned_word(Addr a)
+{
+   if (lc_par)
+      return MC_(is_valid_aligned_word_nocache)(a) && !lc_is_bad_page(a);
+   return MC_(is_valid_aligned_word)(a);
+}
+
 // Determines if a pointer is to a chunk.  Returns the chunk number et al
 // via call-by-reference.
 static Bool
@@ -529,7 +761,7 @@ lc_is_a_chunk_ptr(Addr ptr, Int* pch_no, MC_Chunk** pch, LC_Extra** pex)
    // as ptr might be random data pointing anywhere. On 64 bit
    // platforms, getting va bits for random data can be quite costly
    // due to the secondary map.
-   if (!VG_(am_is_valid_for_client)(ptr, 1, VKI_PROT_READ)) {
+   if (!lc_is_readable_for_client(ptr, 1)) {
       return False;
    } else {
       ch_no = find_chunk_for(ptr, lc_chunks, lc_n_chunks);
@@ -625,45 +857,45 @@ static Bool aligned_ptr_above_page0_is_vtable_addr(Addr ptr)
    // pointers.
 #define VTABLE_MAX_CHECK 20 
 
-   NSegment const *seg;
+   LC_Seg seg;
    UInt nr_fn_ptrs = 0;
    Addr scan;
    Addr scan_max;
 
    // First verify ptr points inside a client mapped file section.
    // ??? is a vtable always in a file mapped readable section ?
-   seg = VG_(am_find_nsegment) (ptr);
-   if (seg == NULL
-       || seg->kind != SkFileC
-       || !seg->hasR)
+   if (!lc_find_seg (ptr, &seg)
+       || seg.kind != SkFileC
+       || !seg.hasR)
       return False;
 
    // Check potential function pointers, up to a maximum of VTABLE_MAX_CHECK.
    scan_max = ptr + VTABLE_MAX_CHECK*sizeof(Addr);
    // If ptr is near the end of seg, avoid scan_max exceeding the end of seg:
-   if (scan_max > seg->end - sizeof(Addr))
-      scan_max = seg->end - sizeof(Addr);
+   if (scan_max > seg.end - sizeof(Addr))
+      scan_max = seg.end - sizeof(Addr);
    for (scan = ptr; scan <= scan_max; scan+=sizeof(Addr)) {
-      Addr pot_fn = *((Addr *)scan);
+      Addr pot_fn;
+      if (lc_par && lc_is_bad_page(scan))
+         return False;
+      pot_fn = *((Addr *)scan);
       if (pot_fn == 0)
          continue; // NULL fn pointer. Seems it can happen in vtable.
-      seg = VG_(am_find_nsegment) (pot_fn);
 #if defined(VGA_ppc64be)
       // ppc64BE uses a thunk table (function descriptors), so we have one
       // more level of indirection to follow.
-      if (seg == NULL
-          || seg->kind != SkFileC
-          || !seg->hasR
-          || !seg->hasW)
+      if (!lc_find_seg (pot_fn, &seg)
+          || seg.kind != SkFileC
+          || !seg.hasR
+          || !seg.hasW)
          return False; // ptr to nowhere, or not a ptr to thunks.
       pot_fn = *((Addr *)pot_fn);
       if (pot_fn == 0)
          continue; // NULL fn pointer. Seems it can happen in vtable.
-      seg = VG_(am_find_nsegment) (pot_fn);
 #endif
-      if (seg == NULL
-          || seg->kind != SkFileC
-          || !seg->hasT)
+      if (!lc_find_seg (pot_fn, &seg)
+          || seg.kind != SkFileC
+          || !seg.hasT)
          return False; // ptr to nowhere, or not a fn ptr.
       nr_fn_ptrs++;
       if (nr_fn_ptrs == 2)
@@ -677,10 +909,10 @@ static Bool aligned_ptr_above_page0_is_vtable_addr(Addr ptr)
 static Bool is_valid_aligned_ULong ( Addr a )
 {
    if (sizeof(Word) == 8)
-      return MC_(is_valid_aligned_word)(a);
+      return lc_is_valid_aligned_word(a);
 
-   return MC_(is_valid_aligned_word)(a)
-      && MC_(is_valid_aligned_word)(a + 4);
+   return lc_is_valid_aligned_word(a)
+      && lc_is_valid_aligned_word(a + 4);
 }
 
 // If ch is heuristically reachable via an heuristic member of heur_set,
@@ -704,10 +936,10 @@ static LeakCheckHeuristic heuristic_reachedness (Addr ptr,
       // not for refcount, as refcount size might be smaller than
       // a SizeT, giving a uninitialised hole in the first 3 SizeT.
       if ( ptr == ch->data + 3 * sizeof(SizeT)
-           && MC_(is_valid_aligned_word)(ch->data + sizeof(SizeT))) {
+           && lc_is_valid_aligned_word(ch->data + sizeof(SizeT))) {
          const SizeT capacity = *((SizeT*)(ch->data + sizeof(SizeT)));
          if (3 * sizeof(SizeT) + capacity + 1 == ch->szB
-            && MC_(is_valid_aligned_word)(ch->data)) {
+            && lc_is_valid_aligned_word(ch->data)) {
             const SizeT length = *((SizeT*)ch->data);
             if (length <= capacity) {
                // ??? could check there is no null byte from ptr to ptr+length-1
@@ -757,7 +989,7 @@ static LeakCheckHeuristic heuristic_reachedness (Addr ptr,
       // because a chunk "word-sized" is allocated to store the (0) nr
       // of elements.
       if ( ptr == ch->data + sizeof(SizeT)
-           && MC_(is_valid_aligned_word)(ch->data)) {
+           && lc_is_valid_aligned_word(ch->data)) {
          const SizeT nr_elts = *((SizeT*)ch->data);
          if (nr_elts > 0 && (ch->szB - sizeof(SizeT)) % nr_elts == 0) {
             // ??? could check that ch->allockind is MC_AllocNewVec ???
@@ -770,7 +1002,7 @@ static LeakCheckHeuristic heuristic_reachedness (Addr ptr,
       // Detect inner pointer used for multiple inheritance.
       // Assumption is that the vtable pointers are before the object.
       if (VG_IS_WORD_ALIGNED(ptr)
-          && MC_(is_valid_aligned_word)(ptr)) {
+          && lc_is_valid_aligned_word(ptr)) {
          Addr first_addr;
          Addr inner_addr;
 
@@ -785,7 +1017,7 @@ static LeakCheckHeuristic heuristic_reachedness (Addr ptr,
          inner_addr = *((Addr*)ptr);
          if (VG_IS_WORD_ALIGNED(inner_addr) 
              && inner_addr >= (Addr)VKI_PAGE_SIZE
-             && MC_(is_valid_aligned_word)(ch->data)) {
+             && lc_is_valid_aligned_word(ch->data)) {
             first_addr = *((Addr*)ch->data);
             if (VG_IS_WORD_ALIGNED(first_addr)
                 && first_addr >= (Addr)VKI_PAGE_SIZE
@@ -1133,6 +1365,318 @@ static void lc_process_markstack(Int clique)
    }
 }
 
+
+/*------------------------------------------------------------*/
+/*--- Parallel marking.                                    ---*/
+/*------------------------------------------------------------*/
+
+// The first marking phase (clique == -1) can be shared out between
+// several host threads, see VG_(run_on_helper_threads).  The root set is
+// cut into LC_PAR_ROOT_SZB pieces which the workers take in turn.  Each
+// worker pushes the blocks it reaches on its own mark stack, spilling
+// half of it to the shared lc_markstack when full and refilling from
+// there when empty.  The state, pending and heuristic fields of a block
+// are updated together with a compare-and-swap, so that, as in the
+// serial marker, a block is (re)pushed exactly once per state upgrade.
+// Only the order in which blocks are reached differs, which can change
+// which heuristic is recorded for a heuristically reachable block (that
+// already depends on the root set scanning order).
+//
+// The workers must not fault, so unlike lc_scan_memory they rely on
+// the segment snapshot to avoid unreadable pages.  The pages which fault
+// anyway are found beforehand by lc_probe_segs, under the fault catcher.
+
+#define LC_PAR_LOCAL_STACK  1024
+#define LC_PAR_STEAL        64
+#define LC_PAR_ROOT_SZB     (16 * SM_SIZE)
+
+typedef
+   struct {
+      Int   stack[LC_PAR_LOCAL_STACK];
+      Int   top;
+      SizeT scanned_szB;
+   }
+   LC_Worker;
+
+typedef
+   struct {
+      Addr  start;
+      SizeT szB;
+   }
+   LC_Range;
+
+static LC_Worker*   lc_workers;
+static LC_Range*    lc_par_roots;
+static Int          lc_par_n_roots;
+static volatile Int lc_par_next_root;
+static volatile Int lc_par_n_joined;  // Workers which have started.
+static volatile Int lc_par_busy;      // Workers not waiting for work.
+static volatile Int lc_par_lock;      // Protects lc_markstack[_top].
+
+// The state, pending and heuristic bit-fields of an LC_Extra share its
+// first UInt.
+static UInt lc_extra_bits(LC_Extra* ex)
+{
+   return *(volatile UInt*)ex;
+}
+
+static Bool lc_extra_cas_bits(LC_Extra* ex, UInt old, LC_Extra* nu)
+{
+   return __sync_bool_compare_and_swap((UInt*)ex, old, *(UInt*)nu);
+}
+
+static void lc_par_acquire(void)
+{
+   while (__sync_lock_test_and_set(&lc_par_lock, 1)) {
+      while (lc_par_lock)
+         ;
+   }
+}
+
+static void lc_par_release(void)
+{
+   __sync_lock_release(&lc_par_lock);
+}
+
+static Int lc_par_shared_top(void)
+{
+   return *(volatile Int*)&lc_markstack_top;
+}
+
+// Moves the older half of w's stack to the shared stack.
+static void lc_par_spill(LC_Worker* w)
+{
+   const Int n = LC_PAR_LOCAL_STACK / 2;
+   Int i;
+
+   lc_par_acquire();
+   tl_assert(lc_markstack_top + n < lc_n_chunks);
+   for (i = 0; i < n; i++)
+      lc_markstack[++lc_markstack_top] = w->stack[i];
+   lc_par_release();
+   for (i = n; i <= w->top; i++)
+      w->stack[i - n] = w->stack[i];
+   w->top -= n;
+}
+
+// Refills w's (empty) stack from the shared stack.
+static Bool lc_par_refill(LC_Worker* w)
+{
+   Int n = 0;
+
+   tl_assert(w->top == -1);
+   if (lc_par_shared_top() < 0)
+      return False;
+   lc_par_acquire();
+   while (n < LC_PAR_STEAL && lc_markstack_top >= 0) {
+      w->stack[n++] = lc_markstack[lc_markstack_top--];
+   }
+   lc_par_release();
+   w->top = n - 1;
+   return n > 0;
+}
+
+static void lc_par_push(LC_Worker* w, Int ch_no)
+{
+   if (w->top == LC_PAR_LOCAL_STACK - 1)
+      lc_par_spill(w);
+   w->stack[++w->top] = ch_no;
+}
+
+// Parallel version of lc_push_without_clique_if_a_chunk_ptr.
+static void
+lc_par_push_if_a_chunk_ptr(LC_Worker* w, Addr ptr, Bool is_prior_definite)
+{
+   Int ch_no;
+   MC_Chunk* ch;
+   LC_Extra* ex;
+   LeakCheckHeuristic heur = LchNone;
+   Bool heur_done = False;
+
+   if ( ! lc_is_a_chunk_ptr(ptr, &ch_no, &ch, &ex) )
+      return;
+
+   while (True) {
+      const UInt old = lc_extra_bits(ex);
+      LC_Extra nu;
+      Reachedness ch_via_ptr;
+      Bool push = False;
+
+      *(UInt*)&nu = old;
+      if (nu.state == Reachable) {
+         if (nu.heuristic && ptr == ch->data)
+            nu.heuristic = LchNone;
+         else
+            return;
+      } else {
+         if (ptr == ch->data)
+            ch_via_ptr = Reachable;
+         else if (detect_memory_leaks_last_heuristics) {
+            if (!heur_done) {
+               heur = heuristic_reachedness (ptr, ch, ex,
+                                             detect_memory_leaks_last_heuristics);
+               heur_done = True;
+            }
+            nu.heuristic = heur;
+            ch_via_ptr = heur ? Reachable : Possible;
+         } else
+            ch_via_ptr = Possible;
+
+         if (ch_via_ptr == Reachable && is_prior_definite) {
+            nu.state = Reachable;
+            push = True;
+         } else if (nu.state == Unreached) {
+            nu.state = Possible;
+            push = True;
+         }
+         if (push) {
+            push = !nu.pending;
+            nu.pending = True;
+         }
+      }
+
+      if (lc_extra_cas_bits(ex, old, &nu)) {
+         if (push)
+            lc_par_push(w, ch_no);
+         return;
+      }
+   }
+}
+
+// Leak check mode of lc_scan_memory, for a worker.
+static void
+lc_par_scan_memory(LC_Worker* w, Addr start, SizeT len, Bool is_prior_definite)
+{
+   Addr ptr = VG_ROUNDUP(start, sizeof(Addr));
+   const Addr end = VG_ROUNDDN(start+len, sizeof(Addr));
+
+   if ( ! MC_(is_within_valid_secondary_nocache)(ptr) ) {
+      ptr = VG_ROUNDUP(ptr+1, SM_SIZE);
+   } else if (!lc_is_readable_for_client(ptr, sizeof(Addr))
+              || lc_is_bad_page(ptr)) {
+      ptr = VG_PGROUNDUP(ptr+1);
+   }
+
+   while (ptr < end) {
+      if (UNLIKELY((ptr % SM_SIZE) == 0)) {
+         if (! MC_(is_within_valid_secondary_nocache)(ptr) ) {
+            ptr = VG_ROUNDUP(ptr+1, SM_SIZE);
+            continue;
+         }
+      }
+
+      if (UNLIKELY((ptr % VKI_PAGE_SIZE) == 0)) {
+         if (!lc_is_readable_for_client(ptr, sizeof(Addr))
+             || lc_is_bad_page(ptr)) {
+            ptr += VKI_PAGE_SIZE;
+            continue;
+         }
+      }
+
+      if ( MC_(is_valid_aligned_word_nocache)(ptr) ) {
+         w->scanned_szB += sizeof(Addr);
+         lc_par_push_if_a_chunk_ptr(w, *(Addr *)ptr, is_prior_definite);
+      }
+      ptr += sizeof(Addr);
+   }
+}
+
+// Reads a word of each page of the readable segments in lc_segs which
+// the workers might read, and records those that fault in lc_bad_pages.
+static void lc_probe_segs(void)
+{
+   volatile Int  i = 0;
+   volatile Addr page = 0;
+   vki_sigset_t  sigmask;
+
+   VG_(sigprocmask)(VKI_SIG_SETMASK, NULL, &sigmask);
+   VG_(set_fault_catcher)(scan_all_valid_memory_catcher);
+
+   if (VG_MINIMAL_SETJMP(memscan_jmpbuf) != 0) {
+      // As in lc_scan_memory, restore the signal mask.
+      VG_(sigprocmask)(VKI_SIG_SETMASK, &sigmask, NULL);
+      lc_add_bad_page(page);
+      lc_sig_skipped_szB += VKI_PAGE_SIZE;
+      page += VKI_PAGE_SIZE;
+   }
+   for (; i < lc_n_segs; i++) {
+      if (!lc_segs[i].hasR)
+         continue;
+      if (page < lc_segs[i].start)
+         page = lc_segs[i].start;
+      for (; page <= lc_segs[i].end; page += VKI_PAGE_SIZE) {
+         if (MC_(is_within_valid_secondary)(page))
+            (void) *(volatile Addr *)page;
+      }
+   }
+
+   VG_(sigprocmask)(VKI_SIG_SETMASK, &sigmask, NULL);
+   VG_(set_fault_catcher)(NULL);
+}
+
+static void lc_par_scan_chunk(LC_Worker* w, Int ch_no)
+{
+   LC_Extra* ex = &lc_extras[ch_no];
+   LC_Extra  nu;
+   UInt      old;
+
+   // Clear the pending bit before scanning, see lc_pop.
+   do {
+      old = lc_extra_bits(ex);
+      *(UInt*)&nu = old;
+      tl_assert(nu.pending);
+      nu.pending = False;
+   } while (!lc_extra_cas_bits(ex, old, &nu));
+
+   // See comment about 'is_prior_definite' at the top to understand this.
+   lc_par_scan_memory(w, lc_chunks[ch_no]->data, lc_chunks[ch_no]->szB,
+                      /*is_prior_definite*/ Possible != nu.state);
+}
+
+// Returns False once there is no work left anywhere.  A worker only
+// creates work while busy, so if no worker is busy and the shared stack
+// (checked in that order) is empty, all the work is done.
+static Bool lc_par_wait_for_work(LC_Worker* w)
+{
+   __sync_fetch_and_sub(&lc_par_busy, 1);
+   while (True) {
+      if (lc_par_shared_top() >= 0) {
+         __sync_fetch_and_add(&lc_par_busy, 1);
+         if (lc_par_refill(w))
+            return True;
+         __sync_fetch_and_sub(&lc_par_busy, 1);
+      }
+      if (lc_par_busy == 0 && lc_par_shared_top() < 0)
+         return False;
+      VG_(helper_thread_yield)();
+   }
+}
+
+static void lc_par_worker(void* unused)
+{
+   LC_Worker* w = &lc_workers[__sync_fetch_and_add(&lc_par_n_joined, 1)];
+
+   __sync_fetch_and_add(&lc_par_busy, 1);
+   while (True) {
+      Int r;
+
+      if (w->top >= 0) {
+         lc_par_scan_chunk(w, w->stack[w->top--]);
+         continue;
+      }
+      if (lc_par_refill(w))
+         continue;
+      r = __sync_fetch_and_add(&lc_par_next_root, 1);
+      if (r < lc_par_n_roots) {
+         lc_par_scan_memory(w, lc_par_roots[r].start, lc_par_roots[r].szB,
+                            /*is_prior_definite*/True);
+         continue;
+      }
+      if (!lc_par_wait_for_work(w))
+         return;
+   }
+}
+
 static Word cmp_LossRecordKey_LossRecord(const void* key, const void* elem)
 {
    const LossRecordKey* a = key;
@@ -1608,6 +2152,31 @@ Bool MC_(print_block_list) ( UInt loss_record_nr)
 // encountered.
 // Otherwise (searched != 0), scan the memory root set searching for ptr
 // pointing inside [searched, searched+szB[.
+// True if the client segment seg is part of the memory root set.
+static Bool is_root_segment(NSegment const* seg)
+{
+   tl_assert(seg->kind == SkFileC || seg->kind == SkAnonC ||
+             seg->kind == SkShmC);
+
+   if (!(seg->hasR && seg->hasW))                    return False;
+   if (seg->isCH)                                    return False;
+
+   // Don't poke around in device segments as this may cause
+   // hangs.  Include /dev/zero just in case someone allocated
+   // memory by explicitly mapping /dev/zero.
+   if (seg->kind == SkFileC 
+       && (VKI_S_ISCHR(seg->mode) || VKI_S_ISBLK(seg->mode))) {
+      const HChar* dev_name = VG_(am_get_filename)( seg );
+      if (dev_name && 0 == VG_(strcmp)(dev_name, "/dev/zero")) {
+         // Don't skip /dev/zero.
+      } else {
+         // Skip this device mapping.
+         return False;
+      }
+   }
+   return True;
+}
+
 static void scan_memory_root_set(Addr searched, SizeT szB)
 {
    Int   i;
@@ -1625,25 +2194,9 @@ static void scan_memory_root_set(Addr searched, SizeT szB)
       SizeT seg_size;
       NSegment const* seg = VG_(am_find_nsegment)( seg_starts[i] );
       tl_assert(seg);
-      tl_assert(seg->kind == SkFileC || seg->kind == SkAnonC ||
-                seg->kind == SkShmC);
-
-      if (!(seg->hasR && seg->hasW))                    continue;
-      if (seg->isCH)                                    continue;
-
-      // Don't poke around in device segments as this may cause
-      // hangs.  Include /dev/zero just in case someone allocated
-      // memory by explicitly mapping /dev/zero.
-      if (seg->kind == SkFileC 
-          && (VKI_S_ISCHR(seg->mode) || VKI_S_ISBLK(seg->mode))) {
-         const HChar* dev_name = VG_(am_get_filename)( seg );
-         if (dev_name && 0 == VG_(strcmp)(dev_name, "/dev/zero")) {
-            // Don't skip /dev/zero.
-         } else {
-            // Skip this device mapping.
-            continue;
-         }
-      }
+
+      if (!is_root_segment(seg))
+         continue;
 
       if (0)
          VG_(printf)("ACCEPT %2d  %#lx %#lx\n", i, seg->start, seg->end);
@@ -1663,6 +2216,99 @@ static void scan_memory_root_set(Addr searched, SizeT szB)
    VG_(free)(seg_starts);
 }
 
+// Does the work of scan_memory_root_set (in leak check mode), the GP
+// register scan and lc_process_markstack(-1) using n_threads threads.
+static void lc_par_mark(UInt n_threads)
+{
+   Int   i;
+   UInt  n_used;
+   Int   n_seg_starts;
+   Addr* seg_starts = VG_(get_segment_starts)( SkFileC | SkAnonC | SkShmC,
+                                               &n_seg_starts );
+
+   tl_assert(seg_starts && n_seg_starts > 0);
+
+   lc_scanned_szB = 0;
+   lc_sig_skipped_szB = 0;
+
+   // Cut the root set into pieces.
+   lc_par_n_roots = 0;
+   for (i = 0; i < n_seg_starts; i++) {
+      NSegment const* seg = VG_(am_find_nsegment)( seg_starts[i] );
+      tl_assert(seg);
+      if (is_root_segment(seg))
+         lc_par_n_roots += (seg->end - seg->start) / LC_PAR_ROOT_SZB + 1;
+   }
+   lc_par_roots = VG_(malloc)( "mc.lpm.1",
+                               lc_par_n_roots * sizeof(LC_Range) );
+   lc_par_n_roots = 0;
+   for (i = 0; i < n_seg_starts; i++) {
+      NSegment const* seg = VG_(am_find_nsegment)( seg_starts[i] );
+      Addr a;
+      if (!is_root_segment(seg))
+         continue;
+      if (VG_(clo_verbosity) > 2) {
+         VG_(message)(Vg_DebugMsg,
+                      "  Scanning root segment: %#lx..%#lx (%lu)\n",
+                      seg->start, seg->end, seg->end - seg->start + 1);
+      }
+      a = seg->start;
+      while (True) {
+         const SizeT left = seg->end - a + 1;
+         const SizeT szB  = left < LC_PAR_ROOT_SZB ? left : LC_PAR_ROOT_SZB;
+         lc_par_roots[lc_par_n_roots].start = a;
+         lc_par_roots[lc_par_n_roots].szB   = szB;
+         lc_par_n_roots++;
+         if (szB == left)
+            break;
+         a += szB;
+      }
+   }
+   VG_(free)(seg_starts);
+
+   // The registers are few enough to scan up front; the blocks they
+   // point to seed the shared stack.
+   VG_(apply_to_GP_regs)(lc_push_if_a_chunk_ptr_register);
+
+   lc_take_segs_snapshot();
+   lc_n_bad_pages = 0;
+   lc_probe_segs();
+   lc_workers = VG_(malloc)( "mc.lpm.2", n_threads * sizeof(LC_Worker) );
+   for (i = 0; i < n_threads; i++) {
+      lc_workers[i].top = -1;
+      lc_workers[i].scanned_szB = 0;
+   }
+   lc_par_next_root = 0;
+   lc_par_n_joined = 0;
+   lc_par_busy = 0;
+   lc_par_lock = 0;
+
+   lc_par = True;
+   n_used = VG_(run_on_helper_threads)(n_threads, lc_par_worker, NULL);
+   lc_par = False;
+
+   tl_assert(lc_markstack_top == -1);
+   tl_assert(lc_par_n_joined == n_used);
+   for (i = 0; i < n_used; i++) {
+      tl_assert(lc_workers[i].top == -1);
+      lc_scanned_szB += lc_workers[i].scanned_szB;
+   }
+   if (VG_(clo_verbosity) > 1 && !VG_(clo_xml))
+      VG_(umsg)("Marked reachable blocks using %u threads\n", n_used);
+
+   VG_(free)(lc_workers);
+   lc_workers = NULL;
+   VG_(free)(lc_par_roots);
+   lc_par_roots = NULL;
+   VG_(free)(lc_segs);
+   lc_segs = NULL;
+   if (lc_bad_pages != NULL) {
+      VG_(free)(lc_bad_pages);
+      lc_bad_pages = NULL;
+      lc_bad_pages_size = 0;
+   }
+}
+
 /*------------------------------------------------------------*/
 /*--- Top-level entry point.                               ---*/
 /*------------------------------------------------------------*/
@@ -1686,13 +2332,10 @@ void MC_(detect_memory_leaks) ( ThreadId tid, LeakCheckParams* lcp)
    MC_(detect_memory_leaks_last_delta_mode) = lcp->deltamode;
    detect_memory_leaks_last_heuristics = lcp->heuristics;
 
-   // Get the chunks, stop if there were none.
-   if (lc_chunks) {
-      VG_(free)(lc_chunks);
-      lc_chunks = NULL;
-   }
-   lc_chunks = find_active_chunks(&lc_n_chunks);
+   // Get the chunks, sorted, stop if there were none.
+   lc_chunks = get_sorted_chunks(&lc_n_chunks);
    lc_chunks_n_frees_marker = MC_(get_cmalloc_n_frees)();
+   lc_chunks_n_changes_marker = MC_(get_cmalloc_n_chunk_changes)();
    if (lc_n_chunks == 0) {
       tl_assert(lc_chunks == NULL);
       if (lr_table != NULL) {
@@ -1711,9 +2354,6 @@ void MC_(detect_memory_leaks) ( ThreadId tid, LeakCheckParams* lcp)
       return;
    }
 
-   // Sort the array so blocks are in ascending order in memory.
-   VG_(ssort)(lc_chunks, lc_n_chunks, sizeof(VgHashNode*), compare_MC_Chunks);
-
    // Sanity check -- make sure they're in order.
    for (i = 0; i < lc_n_chunks-1; i++) {
       tl_assert( lc_chunks[i]->data <= lc_chunks[i+1]->data);
@@ -1808,16 +2448,21 @@ void MC_(detect_memory_leaks) ( ThreadId tid, LeakCheckParams* lcp)
                  lc_n_chunks );
    }
 
-   // Scan the memory root-set, pushing onto the mark stack any blocks
-   // pointed to.
-   scan_memory_root_set(/*searched*/0, 0);
+   if (MC_(clo_leak_check_threads) > 1) {
+      // As below, using several threads.
+      lc_par_mark(MC_(clo_leak_check_threads));
+   } else {
+      // Scan the memory root-set, pushing onto the mark stack any blocks
+      // pointed to.
+      scan_memory_root_set(/*searched*/0, 0);
 
-   // Scan GP registers for chunk pointers.
-   VG_(apply_to_GP_regs)(lc_push_if_a_chunk_ptr_register);
+      // Scan GP registers for chunk pointers.
+      VG_(apply_to_GP_regs)(lc_push_if_a_chunk_ptr_register);
 
-   // Process the pushed blocks.  After this, every block that is reachable
-   // from the root-set has been traced.
-   lc_process_markstack(/*clique*/-1);
+      // Process the pushed blocks.  After this, every block that is
+      // reachable from the root-set has been traced.
+      lc_process_markstack(/*clique*/-1);
+   }
 
    if (VG_(clo_verbosity) > 1 && !VG_(clo_xml)) {
       VG_(umsg)("Checked %'lu bytes\n", lc_scanned_szB);
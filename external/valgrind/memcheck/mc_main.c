@@ -38,6 +38,7 @@
 #include "pub_tool_libcbase.h"
 #include "pub_tool_libcassert.h"
 #include "pub_tool_libcprint.h"
+#include "pub_tool_libcproc.h"     // For VG_MAX_HELPER_THREADS
 #include "pub_tool_machine.h"
 #include "pub_tool_mallocfree.h"
 #include "pub_tool_options.h"
@@ -250,10 +251,20 @@ static void ocache_sarp_Clear_Origins ( Addr, UWord ); /* fwds */
 #define VA_BITS16_UNDEFINED   0x5555   // 01_01_01_01b x 2
 #define VA_BITS16_DEFINED     0xaaaa   // 10_10_10_10b x 2
 
+// These represent 128 bits of memory.
+#define VA_BITS32_UNDEFINED   0x55555555        // 01_01_01_01b x 4
+#define VA_BITS32_DEFINED     0xaaaaaaaa        // 10_10_10_10b x 4
+
+// These represent 256 bits of memory.
+#define VA_BITS64_UNDEFINED   0x5555555555555555ULL  // 01_01_01_01b x 8
+#define VA_BITS64_DEFINED     0xaaaaaaaaaaaaaaaaULL  // 10_10_10_10b x 8
+
 
 #define SM_CHUNKS             16384
 #define SM_OFF(aaa)           (((aaa) & 0xffff) >> 2)
 #define SM_OFF_16(aaa)        (((aaa) & 0xffff) >> 3)
+#define SM_OFF_32(aaa)        (((aaa) & 0xffff) >> 4)
+#define SM_OFF_64(aaa)        (((aaa) & 0xffff) >> 5)
 
 // Paranoia:  it's critical for performance that the requested inlining
 // occurs.  So try extra hard.
@@ -4306,10 +4317,37 @@ void mc_LOADV_128_or_256 ( /*OUT*/ULong* res,
          return;
       }
 
-      /* Handle common cases quickly: a (and a+8 and a+16 etc.) is
-         suitably aligned, is mapped, and addressible. */
+      /* a is naturally aligned, so the whole access lies in one
+         secondary map, and its VA bits are a single naturally aligned
+         UInt (128 bits) or ULong (256 bits) in it.  Handle the
+         all-defined and all-undefined cases with one compare. */
+      sm = get_secmap_for_reading_low(a);
+      if (nBits == 128) {
+         UInt vabits32 = ((UInt*)(sm->vabits8))[SM_OFF_32(a)];
+         if (LIKELY(vabits32 == VA_BITS32_DEFINED)) {
+            res[0] = res[1] = V_BITS64_DEFINED;
+            return;
+         }
+         if (LIKELY(vabits32 == VA_BITS32_UNDEFINED)) {
+            res[0] = res[1] = V_BITS64_UNDEFINED;
+            return;
+         }
+      } else {
+         ULong vabits64 = ((ULong*)(sm->vabits8))[SM_OFF_64(a)];
+         if (LIKELY(vabits64 == VA_BITS64_DEFINED)) {
+            res[0] = res[1] = res[2] = res[3] = V_BITS64_DEFINED;
+            return;
+         }
+         if (LIKELY(vabits64 == VA_BITS64_UNDEFINED)) {
+            res[0] = res[1] = res[2] = res[3] = V_BITS64_UNDEFINED;
+            return;
+         }
+      }
+
+      /* Otherwise each 8-byte unit may still be all-defined or
+         all-undefined on its own. */
+      PROF_EVENT(203, "mc_LOADV_128_or_256-mixed");
       for (j = 0; j < nULongs; j++) {
-         sm       = get_secmap_for_reading_low(a + 8*j);
          sm_off16 = SM_OFF_16(a + 8*j);
          vabits16 = ((UShort*)(sm->vabits8))[sm_off16];
 
@@ -4465,6 +4503,96 @@ VG_REGPARM(1) void MC_(helperc_STOREV64le) ( Addr a, ULong vbits64 )
    mc_STOREV64(a, vbits64, False);
 }
 
+/* Stores of 128 and 256 bits.  vbits[0] is the least significant
+   64-bit lane.  These are only used on 64-bit hosts, where the lanes
+   can be passed as plain ULong args; 32-bit hosts still split wide
+   stores into STOREV64s at instrumentation time. */
+static INLINE
+void mc_STOREV_128_or_256 ( Addr a, const ULong* vbits, SizeT nBits,
+                            Bool isBigEndian )
+{
+   UWord j;
+   UWord nULongs = nBits / 64;
+
+   PROF_EVENT(213, "mc_STOREV_128_or_256");
+
+#ifdef PERF_FAST_STOREV
+   {
+      ULong   vbits64 = vbits[0];
+      SecMap* sm;
+      UShort* vabits16s;
+
+      for (j = 1; j < nULongs; j++)
+         if (vbits[j] != vbits64)
+            goto slow;
+      if (UNLIKELY( UNALIGNED_OR_HIGH(a,nBits) ))
+         goto slow;
+      if (vbits64 != V_BITS64_DEFINED && vbits64 != V_BITS64_UNDEFINED)
+         goto slow;
+
+      /* All lanes are fully defined, or all fully undefined, and the
+         access lies in a single secondary map.  As in mc_STOREV64,
+         only overwrite VA bits which are already fully defined or
+         fully undefined, since anything else needs the slow path
+         (noaccess errors, or the sec-V-bits table). */
+      sm        = get_secmap_for_reading_low(a);
+      vabits16s = (UShort*)&(sm->vabits8[SM_OFF(a)]);
+      if (nBits == 128) {
+         UInt want = vbits64 == V_BITS64_DEFINED ? VA_BITS32_DEFINED
+                                                 : VA_BITS32_UNDEFINED;
+         if (LIKELY(*(UInt*)vabits16s == want))
+            return;
+      } else {
+         ULong want = vbits64 == V_BITS64_DEFINED ? VA_BITS64_DEFINED
+                                                  : VA_BITS64_UNDEFINED;
+         if (LIKELY(*(ULong*)vabits16s == want))
+            return;
+      }
+      if (is_distinguished_sm(sm))
+         goto slow;
+      for (j = 0; j < nULongs; j++)
+         if (vabits16s[j] != (UShort)VA_BITS16_DEFINED
+             && vabits16s[j] != (UShort)VA_BITS16_UNDEFINED)
+            goto slow;
+      for (j = 0; j < nULongs; j++)
+         vabits16s[j] = vbits64 == V_BITS64_DEFINED
+                           ? (UShort)VA_BITS16_DEFINED
+                           : (UShort)VA_BITS16_UNDEFINED;
+      return;
+   }
+  slow:
+#endif
+   PROF_EVENT(214, "mc_STOREV_128_or_256-slow");
+   for (j = 0; j < nULongs; j++)
+      mc_STOREV64( a + 8 * (isBigEndian ? nULongs-1-j : j),
+                   vbits[j], isBigEndian );
+}
+
+VG_REGPARM(1) void MC_(helperc_STOREV256le) ( Addr a,
+                                              ULong vbits64_0,
+                                              ULong vbits64_1,
+                                              ULong vbits64_2,
+                                              ULong vbits64_3 )
+{
+   ULong vbits[4] = { vbits64_0, vbits64_1, vbits64_2, vbits64_3 };
+   mc_STOREV_128_or_256(a, vbits, 256, False);
+}
+
+VG_REGPARM(1) void MC_(helperc_STOREV128be) ( Addr a,
+                                              ULong vbits64_0,
+                                              ULong vbits64_1 )
+{
+   ULong vbits[2] = { vbits64_0, vbits64_1 };
+   mc_STOREV_128_or_256(a, vbits, 128, True);
+}
+VG_REGPARM(1) void MC_(helperc_STOREV128le) ( Addr a,
+                                              ULong vbits64_0,
+                                              ULong vbits64_1 )
+{
+   ULong vbits[2] = { vbits64_0, vbits64_1 };
+   mc_STOREV_128_or_256(a, vbits, 128, False);
+}
+
 
 /* ------------------------ Size = 4 ------------------------ */
 
@@ -5014,6 +5142,47 @@ Bool MC_(is_valid_aligned_word) ( Addr a )
 }
 
 
+/* Variants of the above two for the leak checker's helper threads,
+   which may run concurrently with each other.  They neither reorder
+   the auxmap L1 cache nor update its stats, and they don't create
+   auxmap entries: a 64k chunk with no entry reads as noaccess. */
+static INLINE SecMap* maybe_get_secmap_for_nocache ( Addr a )
+{
+   if (a <= MAX_PRIMARY_ADDRESS) {
+      return get_secmap_for_reading_low(a);
+   } else {
+      AuxMapEnt  key;
+      AuxMapEnt* res;
+      key.base = a & ~(Addr)0xFFFF;
+      key.sm   = 0;
+      res = VG_(OSetGen_Lookup)(auxmap_L2, &key);
+      return res ? res->sm : NULL;
+   }
+}
+
+Bool MC_(is_within_valid_secondary_nocache) ( Addr a )
+{
+   SecMap* sm = maybe_get_secmap_for_nocache ( a );
+   return sm != NULL && sm != &sm_distinguished[SM_DIST_NOACCESS];
+}
+
+Bool MC_(is_valid_aligned_word_nocache) ( Addr a )
+{
+   SecMap* sm = maybe_get_secmap_for_nocache ( a );
+   tl_assert(VG_IS_WORD_ALIGNED(a));
+   if (sm == NULL || sm->vabits8[SM_OFF(a)] != VA_BITS8_DEFINED)
+      return False;
+   if (sizeof(UWord) == 8) {
+      /* a+4 is in the same secmap, as a is 8-aligned. */
+      if (sm->vabits8[SM_OFF(a + 4)] != VA_BITS8_DEFINED)
+         return False;
+   }
+   if (UNLIKELY(MC_(in_ignored_range)(a)))
+      return False;
+   else
+      return True;
+}
+
 /*------------------------------------------------------------*/
 /*--- Initialisation                                       ---*/
 /*------------------------------------------------------------*/
@@ -5180,6 +5349,7 @@ Long          MC_(clo_freelist_vol)           = 20*1000*1000LL;
 Long          MC_(clo_freelist_big_blocks)    =  1*1000*1000LL;
 LeakCheckMode MC_(clo_leak_check)             = LC_Summary;
 VgRes         MC_(clo_leak_resolution)        = Vg_HighRes;
+UInt          MC_(clo_leak_check_threads)     = 1;
 UInt          MC_(clo_show_leak_kinds)        = R2S(Possible) | R2S(Unreached);
 UInt          MC_(clo_error_for_leak_kinds)   = R2S(Possible) | R2S(Unreached);
 UInt          MC_(clo_leak_check_heuristics)  = 0;
@@ -5288,6 +5458,9 @@ static Bool mc_process_cmd_line_options(const HChar* arg)
                             MC_(clo_leak_resolution), Vg_MedRes) {}
    else if VG_XACT_CLO(arg, "--leak-resolution=high",
                             MC_(clo_leak_resolution), Vg_HighRes) {}
+   else if VG_BINT_CLO(arg, "--leak-check-threads",
+                       MC_(clo_leak_check_threads),
+                       1, VG_MAX_HELPER_THREADS) {}
 
    else if VG_STR_CLO(arg, "--ignore-ranges", tmp_str) {
       Bool ok = parse_ignore_ranges(tmp_str);
@@ -5367,6 +5540,7 @@ static void mc_print_usage(void)
 "        improving leak search false positive [none]\n"
 "        where heur is one of:\n"
 "          stdstring length64 newarray multipleinheritance all none\n"
+"    --leak-check-threads=<number>    threads used to mark reachable blocks [1]\n"
 "    --show-reachable=yes             same as --show-leak-kinds=all\n"
 "    --show-reachable=no --show-possibly-lost=yes\n"
 "                                     same as --show-leak-kinds=definite,possible\n"
@@ -6582,6 +6756,10 @@ static void mc_post_clo_init ( void )
 #     endif
       VG_(track_new_mem_stack)     ( mc_new_mem_stack     );
       VG_(track_new_mem_stack_signal) ( mc_new_mem_w_tid_no_ECU );
+
+      /* Origin tracking bakes ExeContext numbers into the code; without
+         it, translations can be reused by later runs. */
+      VG_(needs_cacheable_translations) ();
    }
 
    // We assume that brk()/sbrk() does not initialise new memory.  Is this
@@ -6999,6 +7177,8 @@ static void mc_pre_clo_init(void)
    tl_assert(MASK(2) == 1UL);
    tl_assert(MASK(4) == 3UL);
    tl_assert(MASK(8) == 7UL);
+   tl_assert(MASK(16) == 15UL);
+   tl_assert(MASK(32) == 31UL);
 #  else
    tl_assert(VG_WORDSIZE == 8);
    tl_assert(sizeof(void*) == 8);
@@ -7010,6 +7190,8 @@ static void mc_pre_clo_init(void)
    tl_assert(MASK(2) == 0xFFFFFFF000000001ULL);
    tl_assert(MASK(4) == 0xFFFFFFF000000003ULL);
    tl_assert(MASK(8) == 0xFFFFFFF000000007ULL);
+   tl_assert(MASK(16) == 0xFFFFFFF00000000FULL);
+   tl_assert(MASK(32) == 0xFFFFFFF00000001FULL);
 #  endif
 }
 
@@ -54,6 +54,12 @@ static SizeT cmalloc_n_mallocs  = 0;
 static SizeT cmalloc_n_frees    = 0;
 static ULong cmalloc_bs_mallocd = 0;
 
+/* Number of times a tracked block was freed, moved or resized, by any
+   means (including mempool operations, which don't count as frees
+   above).  The leak checker compares it across searches to decide
+   whether it can reuse its sorted array of blocks. */
+static SizeT cmalloc_n_chunk_changes = 0;
+
 /* For debug printing to do with mempools: what stack trace
    depth to show. */
 #define MEMPOOL_DEBUG_STACKTRACE_DEPTH 16
@@ -431,6 +437,8 @@ void* MC_(calloc) ( ThreadId tid, SizeT nmemb, SizeT size1 )
 static
 void die_and_free_mem ( ThreadId tid, MC_Chunk* mc, SizeT rzB )
 {
+   cmalloc_n_chunk_changes++;
+
    /* Note: we do not free fill the custom allocs produced
       by MEMPOOL or by MALLOC/FREELIKE_BLOCK requests. */
    if (MC_(clo_free_fill) != -1 && MC_AllocCustom != mc->allockind ) {
@@ -650,6 +658,7 @@ void MC_(handle_resizeInPlace)(ThreadId tid, Addr p,
    if (oldSizeB == newSizeB)
       return;
 
+   cmalloc_n_chunk_changes++;
    mc->szB = newSizeB;
    if (newSizeB < oldSizeB) {
       MC_(make_mem_noaccess)( p + newSizeB, oldSizeB - newSizeB + rzB );
@@ -729,6 +738,7 @@ void MC_(destroy_mempool)(Addr pool)
       return;
    }
    check_mempool_sane(mp);
+   cmalloc_n_chunk_changes++;
 
    // Clean up the chunks, one by one
    VG_(HT_ResetIter)(mp->chunks);
@@ -995,6 +1005,7 @@ void MC_(mempool_trim)(Addr pool, Addr addr, SizeT szB)
            MC_(make_mem_noaccess)( hi, max - hi );
          }
 
+         cmalloc_n_chunk_changes++;
          mc->data = lo;
          mc->szB = (UInt) (hi - lo);
          VG_(HT_add_node)( mp->chunks, mc );        
@@ -1055,6 +1066,7 @@ void MC_(mempool_change)(Addr pool, Addr addrA, Addr addrB, SizeT szB)
       return;
    }
 
+   cmalloc_n_chunk_changes++;
    mc->data = addrB;
    mc->szB  = szB;
    VG_(HT_add_node)( mp->chunks, mc );
@@ -1112,6 +1124,11 @@ SizeT MC_(get_cmalloc_n_frees) ( void )
    return cmalloc_n_frees;
 }
 
+SizeT MC_(get_cmalloc_n_chunk_changes) ( void )
+{
+   return cmalloc_n_chunk_changes;
+}
+
 
 /*--------------------------------------------------------------------*/
 /*--- end                                                          ---*/
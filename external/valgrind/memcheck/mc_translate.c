@@ -5111,7 +5111,56 @@ void do_shadow_Store ( MCEnv* mce,
       }
    }
 
-   if (UNLIKELY(ty == Ity_V256)) {
+   if (tyAddr == Ity_I64
+       && (ty == Ity_V128 || (ty == Ity_V256 && end == Iend_LE))) {
+
+      /* V128 and V256 on 64-bit hosts: hand all the 64-bit lanes to a
+         single helper, which can then update the shadow memory for
+         the whole vector at once in the common cases.  The lanes are
+         passed least significant first. */
+      IRDirty *di;
+      IRAtom  *addrAct;
+      IRAtom  *lane[4];
+
+      if (bias == 0) {
+         addrAct = addr;
+      } else {
+         addrAct = assignNew('V', mce, tyAddr, binop(mkAdd, addr, mkU64(bias)));
+      }
+
+      if (ty == Ity_V256) {
+         lane[0] = assignNew('V', mce, Ity_I64, unop(Iop_V256to64_0, vdata));
+         lane[1] = assignNew('V', mce, Ity_I64, unop(Iop_V256to64_1, vdata));
+         lane[2] = assignNew('V', mce, Ity_I64, unop(Iop_V256to64_2, vdata));
+         lane[3] = assignNew('V', mce, Ity_I64, unop(Iop_V256to64_3, vdata));
+         di = unsafeIRDirty_0_N(
+                 1/*regparms*/,
+                 "MC_(helperc_STOREV256le)",
+                 VG_(fnptr_to_fnentry)( &MC_(helperc_STOREV256le) ),
+                 mkIRExprVec_5( addrAct, lane[0], lane[1], lane[2], lane[3] )
+              );
+      } else {
+         lane[0] = assignNew('V', mce, Ity_I64, unop(Iop_V128to64, vdata));
+         lane[1] = assignNew('V', mce, Ity_I64, unop(Iop_V128HIto64, vdata));
+         if (end == Iend_LE) {
+            helper = &MC_(helperc_STOREV128le);
+            hname  = "MC_(helperc_STOREV128le)";
+         } else {
+            helper = &MC_(helperc_STOREV128be);
+            hname  = "MC_(helperc_STOREV128be)";
+         }
+         di = unsafeIRDirty_0_N(
+                 1/*regparms*/,
+                 hname, VG_(fnptr_to_fnentry)( helper ),
+                 mkIRExprVec_3( addrAct, lane[0], lane[1] )
+              );
+      }
+      if (guard) di->guard = guard;
+      setHelperAnns( mce, di );
+      stmt( 'V', mce, IRStmt_Dirty(di) );
+
+   }
+   else if (UNLIKELY(ty == Ity_V256)) {
 
       /* V256-bit case -- phrased in terms of 64 bit units (Qs), with
          Q3 being the most significant lane. */
@@ -0,0 +1,24 @@
+/* An error whose stack trace needs line info, for testing
+   --debuginfo-cache-dir.  Built twice, as debuginfo-cache-a and
+   debuginfo-cache-b, with the same build-id but with the lines
+   numbered from LINE_BASE, so that the two differ only in their
+   .debug_line. */
+#include <stdlib.h>
+
+#line LINE_BASE
+static volatile int n_set;
+
+__attribute__((noinline))
+void count_if_set(const int* p)
+{
+   if (*p)
+      n_set++;
+}
+
+int main(void)
+{
+   int* p = malloc(sizeof(int));
+   count_if_set(p);
+   free(p);
+   return 0;
+}
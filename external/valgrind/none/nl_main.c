@@ -65,7 +65,11 @@ static void nl_pre_clo_init(void)
                                  nl_instrument,
                                  nl_fini);
 
-   /* No needs, no core events to track */
+   /* Nothing is instrumented, so threads can safely run in parallel */
+   VG_(needs_parallel_threads)  ();
+   VG_(needs_cacheable_translations) ();
+
+   /* No other needs, no core events to track */
 }
 
 VG_DETERMINE_INTERFACE_VERSION(nl_pre_clo_init)
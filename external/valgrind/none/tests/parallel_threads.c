@@ -0,0 +1,52 @@
+/* Several threads making indirect calls to many small functions at
+   once, so that with --parallel-threads=yes the dispatchers probe
+   the fast translation cache while other threads are filling it. */
+#include <pthread.h>
+#include <stdio.h>
+
+#define NTHREADS 4
+#define NITERS   200000
+
+typedef unsigned int (*fn_t)(unsigned int);
+
+#define F(n) \
+   static unsigned int f##n(unsigned int x) { return x * (2 * n + 1) + n; }
+#define F8(n) F(n##0) F(n##1) F(n##2) F(n##3) F(n##4) F(n##5) F(n##6) F(n##7)
+F8(1) F8(2) F8(3) F8(4) F8(5) F8(6) F8(7) F8(8)
+
+#define P8(n) f##n##0, f##n##1, f##n##2, f##n##3, \
+              f##n##4, f##n##5, f##n##6, f##n##7,
+static fn_t fns[] = { P8(1) P8(2) P8(3) P8(4) P8(5) P8(6) P8(7) P8(8) };
+
+#define NFNS (sizeof(fns) / sizeof(fns[0]))
+
+static unsigned int sums[NTHREADS];
+
+static void* worker(void* v)
+{
+   unsigned int id = (unsigned int)(unsigned long)v;
+   unsigned int seed = id + 1;
+   unsigned int sum = 0;
+   int i;
+
+   for (i = 0; i < NITERS; i++) {
+      seed = seed * 1103515245 + 12345;
+      sum = fns[(seed >> 16) % NFNS](sum);
+   }
+   sums[id] = sum;
+   return NULL;
+}
+
+int main(void)
+{
+   pthread_t th[NTHREADS];
+   unsigned long i;
+
+   for (i = 0; i < NTHREADS; i++)
+      pthread_create(&th[i], NULL, worker, (void*)i);
+   for (i = 0; i < NTHREADS; i++)
+      pthread_join(th[i], NULL);
+   for (i = 0; i < NTHREADS; i++)
+      printf("thread %lu: %08x\n", i, sums[i]);
+   return 0;
+}
@@ -0,0 +1,47 @@
+/* Hot loops of a few shapes, so that --tier-up-threshold gets to
+   translate them again, chasing across branches and optimising
+   harder.  The results must not change. */
+#include <stdio.h>
+
+#define N 1000
+
+static int data[N];
+
+static unsigned int collatz_steps(unsigned int n)
+{
+   unsigned int steps = 0;
+   while (n != 1) {
+      n = (n & 1) ? 3 * n + 1 : n / 2;
+      steps++;
+   }
+   return steps;
+}
+
+int main(void)
+{
+   unsigned int steps = 0;
+   long long sum = 0;
+   double x = 0.0;
+   int i, j;
+
+   for (i = 1; i < 20000; i++)
+      steps += collatz_steps(i);
+   printf("collatz: %u\n", steps);
+
+   for (i = 0; i < N; i++)
+      data[i] = (i * 7919) % 1009 - 500;
+   for (j = 0; j < 100; j++) {
+      for (i = 0; i < N; i++) {
+         if (data[i] < 0)
+            sum -= data[i] * j;
+         else
+            sum += data[i] ^ j;
+      }
+   }
+   printf("sum: %lld\n", sum);
+
+   for (i = 0; i < 100000; i++)
+      x = x * 0.999 + (i % 17) * 0.5;
+   printf("x: %.6f\n", x);
+   return 0;
+}
@@ -0,0 +1,16 @@
+#include <stdio.h>
+
+static unsigned int mix ( unsigned int h, unsigned int x )
+{
+   return (h ^ x) * 16777619u;
+}
+
+int main ( void )
+{
+   unsigned int h = 2166136261u;
+   int i;
+   for (i = 0; i < 100000; i++)
+      h = mix(h, i);
+   printf("%08x\n", h);
+   return 0;
+}
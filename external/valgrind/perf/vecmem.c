@@ -0,0 +1,72 @@
+// This artificial program does a lot of naturally aligned 128-bit loads
+// and stores, the way vectorised memcpy, memset and numeric kernels do.
+// It is a stress test for Memcheck's handling of wide V-bit loads and
+// stores (LOADV128/STOREV128 and friends).
+//
+// Each pass copies a block of fully defined data, then one of fully
+// undefined data (fresh malloc'd memory), then sums the defined block,
+// so that all of the common wide shadow-memory cases are exercised.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define N_VECS  (64 * 1024)     // 1 MB per block
+#define REPS    100
+
+typedef long long V __attribute__((vector_size(16)));
+
+__attribute__((noinline))
+static void vcopy(V* dst, const V* src, int n)
+{
+   int i;
+   for (i = 0; i < n; i += 4) {
+      V a = src[i], b = src[i+1], c = src[i+2], d = src[i+3];
+      dst[i] = a; dst[i+1] = b; dst[i+2] = c; dst[i+3] = d;
+   }
+}
+
+__attribute__((noinline))
+static V vsum(const V* src, int n)
+{
+   int i;
+   V acc = src[0];
+   for (i = 1; i < n; i++)
+      acc += src[i];
+   return acc;
+}
+
+int main(void)
+{
+   int i, r;
+   V*  def   = malloc(N_VECS * sizeof(V));
+   V*  undef = malloc(N_VECS * sizeof(V));
+   V*  dst   = malloc(N_VECS * sizeof(V));
+   V   acc;
+   long long res[2];
+
+   // malloc only guarantees 16-byte alignment on 64-bit platforms.
+   if (((unsigned long)def | (unsigned long)undef | (unsigned long)dst) & 15) {
+      fprintf(stderr, "vecmem: buffers not 16-byte aligned\n");
+      return 1;
+   }
+
+   for (i = 0; i < N_VECS; i++) {
+      V v = { i, -i };
+      def[i] = v;
+   }
+   memset(&acc, 0, sizeof(acc));
+
+   for (r = 0; r < REPS; r++) {
+      vcopy(dst, def,   N_VECS);
+      acc += vsum(dst, N_VECS);
+      vcopy(dst, undef, N_VECS);
+   }
+   vcopy(dst, def, N_VECS);
+   acc += vsum(dst, N_VECS);
+
+   memcpy(res, &acc, sizeof(res));
+   printf("%lld %lld\n", res[0], res[1]);
+   free(def); free(undef); free(dst);
+   return 0;
+}